@@ -4,17 +4,35 @@
 // Keegan Kochis
 // Created: 2020/9/30
 // Entry point to the application created with the Juniper engine
+// Usage: Game [--schedule-graphs] [--trace] [--texture <file.ktx2>]...
 //======================================================================
 
 #include <cstdlib>
 
 #include <iostream>
 #include <stdexcept>
+#include <string>
 
 #include "Game.h"
 
-int main() {
+int main(int argc, char* argv[]) {
     Game game;
+    for (int i = 1; i < argc; i++) {
+        const std::string argument = argv[i];
+        if (argument == "--schedule-graphs") {
+            game.mWriteScheduleGraphs = true;
+        }
+        else if (argument == "--trace") {
+            game.mWriteTrace = true;
+        }
+        else if (argument == "--texture" && i + 1 < argc) {
+            game.mStreamedTexturePaths.push_back(argv[++i]);
+        }
+        else {
+            std::cerr << "Usage: Game [--schedule-graphs] [--trace] [--texture <file.ktx2>]...\n";
+            return EXIT_FAILURE;
+        }
+    }
     
     try {
         game.run();
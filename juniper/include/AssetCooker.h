@@ -0,0 +1,130 @@
+//======================================================================
+// AssetCooker.h
+//
+// Keegan Kochis
+// Created: 2026/10/18
+// The declaration of the AssetCooker class.
+// Turns source assets into the runtime formats in an output directory.
+// A glTF file becomes one scene file and a mesh file per primitive, the
+// primitives imported, optimized, simplified into levels of detail and
+// cooked in parallel on the job system. Every output is recorded in a manifest with the content hash
+// of what it was cooked from, so cooking again only redoes the outputs
+// whose inputs, or the importer and formats, changed since. A whole
+// source directory is cooked through a cook graph, one step per asset
+// and one packing every output, so an asset whose files, tool and
+// outputs are as the cook database recorded them isn't even opened.
+//======================================================================
+
+#ifndef ASSET_COOKER_H
+#define ASSET_COOKER_H
+
+#include <cstdint>
+
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include "CookDatabase.h"
+#include "CookGraph.h"
+#include "JobSystem.h"
+#include "Mesh.h"
+
+class AssetCooker {
+public:
+    static constexpr const char* MANIFEST_NAME = "cook_manifest.txt";
+    // Part of every output's hash, bumped when the cook steps change what they write
+    static constexpr uint32_t COOK_VERSION = 2;
+    // Source textures named <name>_normal.tga are cooked as normal maps
+    static constexpr const char* NORMAL_MAP_SUFFIX = "_normal";
+
+
+    struct Stats_t {
+        uint32_t outputs = 0;
+        uint32_t cookedOutputs = 0;
+        uint32_t skippedOutputs = 0;    // Unchanged since they were last cooked
+        uint64_t bytesWritten = 0;
+        // Of the cooked meshes, transformed vertices simulated before and after optimizing
+        uint64_t triangles = 0;
+        uint64_t vertices = 0;
+        uint64_t transformedBefore = 0;
+        uint64_t transformedAfter = 0;
+        // Coarser levels of the cooked meshes and their triangles
+        uint32_t lods = 0;
+        uint64_t lodTriangles = 0;
+        // Largest quantization errors of the cooked meshes, relative to their extent
+        float maxPositionError = 0.0f;
+        float maxNormalDegrees = 0.0f;
+        uint32_t textures = 0;
+        double importMs = 0.0;          // Parsing the source and mapping its buffers
+        double meshMs = 0.0;            // Hashing, importing and cooking the primitives
+        double sceneMs = 0.0;
+        double textureMs = 0.0;
+    }; typedef Stats_t Stats;
+
+
+    AssetCooker();
+
+    // Creates the output directory and reads its manifest and cook database. Without a job
+    // system everything is cooked on the calling thread.
+    void init(JobSystem* pJobSystem, const std::string& outputDirectory);
+    // Off, every output is cooked whatever the manifest and the cook database say
+    void set_incremental(bool incremental);
+    // Of the cooked meshes, float by default
+    void set_vertex_format(VertexFormat vertexFormat) { mVertexFormat = vertexFormat; }
+    // Where cook_directory() packs the outputs, nothing is packed while it's empty
+    void set_pack_path(const std::string& packPath) { mPackPath = packPath; }
+
+    // Writes <name>.jscene and a <name>_<primitive>.jmesh per triangle primitive, then the
+    // manifest. Stats are for the last cook.
+    void cook_gltf(const std::string& path);
+    // BC7 <name>.ktx2 files from TGA images, or BC5 for normal maps
+    void cook_texture(const std::string& path);
+
+    // Cooks every .gltf, .glb and .tga file under the directory that changed since it was
+    // last cooked, the assets in parallel, then packs the outputs if they changed. Outputs
+    // of assets no longer there are deleted. Throws the first failure once the other
+    // assets are cooked.
+    void cook_directory(const std::string& sourceDirectory);
+    // After a watcher reported changed paths under the directory last cooked, only checks
+    // the assets reading them. Cooks the whole directory again when assets were added or
+    // removed.
+    void cook_changes(const std::vector<std::string>& changedPaths);
+    // Of the last directory cook
+    const CookGraph& get_graph() const { return mGraph; }
+
+    const Stats& get_stats() const { return mStats; }
+    void print_stats(std::ostream& out) const;
+
+private:
+    JobSystem* mpJobSystem = nullptr;
+    std::string mOutputDirectory;
+    bool mIncremental = true;
+    VertexFormat mVertexFormat = VERTEX_FORMAT_FLOAT;
+    std::string mPackPath;
+    // Output file name to the hash of what it was cooked from
+    std::unordered_map<std::string, uint64_t> mManifest;
+    bool mManifestChanged = false;
+    // Guards the manifest and the stats while assets cook in parallel
+    mutable std::mutex mMutex;
+    Stats mStats;
+    CookDatabase mDatabase;
+    CookGraph mGraph;
+    std::string mSourceDirectory;
+    // Assets in the graph
+    std::unordered_set<std::string> mSources;
+
+    void cook_gltf_files(const std::string& path, std::vector<std::string>* pInputs, std::vector<std::string>* pOutputs);
+    void cook_texture_file(const std::string& path, std::vector<std::string>* pOutputs);
+    void pack_outputs(const std::vector<std::string>& outputs);
+    void build_graph();
+    void add_stats(const Stats& stats);
+    bool is_up_to_date(const std::string& name, uint64_t hash) const;
+    void read_manifest();
+    void write_manifest();
+    static bool is_source(const std::string& path);
+};
+
+#endif // ASSET_COOKER_H
@@ -0,0 +1,187 @@
+//======================================================================
+// AsyncReader.h
+//
+// Keegan Kochis
+// Created: 2026/10/19
+// The declaration of the AsyncReader class.
+// Reads byte ranges of files into caller owned memory without blocking
+// the thread that asks for them. On Linux the reads are batched through
+// an io_uring: one I/O thread keeps the ring full, and a single system
+// call both submits the new reads and waits for finished ones. On other
+// platforms, or when the kernel refuses a ring, a pool of reader
+// threads issues blocking preads instead. Queued reads are issued in
+// priority order and can be canceled until they are issued. Completion
+// callbacks run on the job system, or on the I/O thread without one.
+//======================================================================
+
+#ifndef ASYNC_READER_H
+#define ASYNC_READER_H
+
+#include <cstdint>
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "JobSystem.h"
+#include "ResourcePool.h"
+
+enum ReadBackend_t {
+    READ_BACKEND_URING = 0,
+    READ_BACKEND_THREADS
+}; typedef ReadBackend_t ReadBackend;
+
+
+enum ReadPriority_t {
+    READ_PRIORITY_HIGH = 0,
+    READ_PRIORITY_NORMAL,
+    READ_PRIORITY_LOW,
+    READ_PRIORITY_COUNT
+}; typedef ReadPriority_t ReadPriority;
+
+
+enum ReadStatus_t {
+    READ_STATUS_DONE = 0,
+    READ_STATUS_FAILED,
+    READ_STATUS_CANCELED
+}; typedef ReadStatus_t ReadStatus;
+
+
+struct ReadFileTag {};
+typedef Handle<ReadFileTag> ReadFileHandle;
+
+struct ReadTag {};
+typedef Handle<ReadTag> ReadHandle;
+
+class AsyncReader {
+public:
+    // Reads from files opened with O_DIRECT need their offset, size and destination on this
+    static constexpr uint64_t DIRECT_ALIGNMENT = 4096;
+
+    // Called once per read with the bytes that arrived
+    typedef std::function<void(ReadStatus status, uint64_t bytes)> Callback;
+
+
+    struct Stats_t {
+        uint64_t requests = 0;
+        uint64_t completed = 0;
+        uint64_t canceled = 0;
+        uint64_t failed = 0;
+        uint64_t bytesRead = 0;
+        uint64_t issued = 0;            // Reads handed to the kernel, a short read issues the rest again
+        uint64_t systemCalls = 0;       // io_uring_enter calls, or preads with the thread pool
+        uint32_t maxInFlight = 0;
+    }; typedef Stats_t Stats;
+
+
+    AsyncReader();
+    ~AsyncReader();
+    AsyncReader(const AsyncReader&) = delete;
+    AsyncReader& operator=(const AsyncReader&) = delete;
+
+    // The queue depth bounds the reads in flight, the thread count applies to the thread pool.
+    // Falls back to the thread pool when the io_uring can't be set up, get_backend() tells.
+    void init(ReadBackend backend, uint32_t queueDepth, uint32_t threadCount, JobSystem* pJobSystem);
+    // Cancels the queued reads and waits for the issued ones, then closes every file
+    void clean_up();
+    ReadBackend get_backend() const { return mBackend; }
+
+    // Opens with O_DIRECT when asked and the file system supports it, is_direct() tells
+    ReadFileHandle open_file(const std::string& path, bool direct);
+    // The file must have no reads left
+    void close_file(ReadFileHandle file);
+    bool is_direct(ReadFileHandle file) const;
+    uint64_t get_file_size(ReadFileHandle file) const;
+
+    // Reads the range into pDestination, which has to stay valid until the callback ran. A
+    // range past the end of the file stops there. Thread safe.
+    ReadHandle read(ReadFileHandle file, uint64_t offset, uint64_t bytes, void* pDestination, ReadPriority priority,
+                    Callback callback);
+    // The callback of a read that wasn't issued yet runs with READ_STATUS_CANCELED. Returns
+    // false once the read was issued or has finished. Thread safe.
+    bool cancel(ReadHandle handle);
+    // Returns once nothing is queued or in flight and every callback ran
+    void wait_idle();
+
+    Stats get_stats() const;
+    void print_stats(std::ostream& out) const;
+
+private:
+    struct OpenFile_t {
+        int fd;
+        uint64_t size;
+        bool direct;
+    }; typedef OpenFile_t OpenFile;
+
+    struct ReadRequest_t {
+        int fd;
+        uint64_t fileSize;
+        uint64_t offset;
+        uint64_t bytes;                 // Rounded up to the alignment for direct files
+        uint64_t done;
+        uint8_t* pDestination;
+        Callback callback;
+        bool issued;
+    }; typedef ReadRequest_t ReadRequest;
+
+    // What an I/O thread needs to issue the rest of a read without holding the lock
+    struct IssuedRead_t {
+        ReadHandle handle;
+        int fd;
+        uint64_t offset;
+        uint64_t bytes;
+        uint8_t* pDestination;
+    }; typedef IssuedRead_t IssuedRead;
+
+    // The mapped rings, defined where io_uring exists
+    struct Uring_t;
+
+    typedef ResourcePool<ReadFileTag, OpenFile> FilePool;
+    typedef ResourcePool<ReadTag, ReadRequest> RequestPool;
+
+    ReadBackend mBackend = READ_BACKEND_THREADS;
+    uint32_t mQueueDepth = 0;
+    JobSystem* mpJobSystem = nullptr;
+    JobSystem::JobCounter mCallbacks;
+
+    mutable std::mutex mMutex;
+    std::condition_variable mRequestAvailable;
+    std::condition_variable mIdle;
+    FilePool mFiles;
+    RequestPool mRequests;
+    // Handles of canceled reads stay behind and are skipped
+    std::deque<ReadHandle> mQueues[READ_PRIORITY_COUNT];
+    uint32_t mInFlight = 0;
+    uint32_t mOutstanding = 0;      // Reads whose callback hasn't been dispatched yet
+    bool mStopping = false;
+    Stats mStats;
+
+    std::vector<std::thread> mThreads;
+    std::unique_ptr<Uring_t> mpUring;
+    int mWakeFd = -1;
+    std::atomic<bool> mWakePending{false};
+
+    // Cancels what is queued and joins the I/O threads once the issued reads finished
+    void stop_threads();
+    bool setup_uring(uint32_t entries);
+    void destroy_uring();
+    void uring_main();
+    void reader_main();
+    void wake();
+
+    // Pops the highest priority queued read, expects the lock to be held
+    bool take_next(IssuedRead* pRead);
+    // Accounts for a finished system call. Returns true with the rest of the read in pNext
+    // if it has to be issued again, otherwise dispatches the callback.
+    bool finish_read(const IssuedRead& read, int64_t result, IssuedRead* pNext);
+    void dispatch(Callback& callback, ReadStatus status, uint64_t bytes);
+};
+
+#endif // ASYNC_READER_H
@@ -0,0 +1,34 @@
+//======================================================================
+// BlockCompress.h
+//
+// Keegan Kochis
+// Created: 2026/10/18
+// Encoders of RGBA8 texture levels into BC1, BC3, BC5 and BC7 blocks.
+// Each 4x4 block fits its endpoints along the principal axis of its
+// texels, picks the indices by projecting the texels onto the quantized
+// endpoints and refits the endpoints to those indices once by least
+// squares. BC7 is written in mode 6 only, one RGBA subset with 4 bit
+// indices, which is fast and holds up on most content. The per-block
+// statistics and projections run on the scalar, SSE or AVX2 level and
+// rows of blocks are spread over the job system.
+//======================================================================
+
+#ifndef BLOCK_COMPRESS_H
+#define BLOCK_COMPRESS_H
+
+#include <cstdint>
+
+#include "JobSystem.h"
+#include "Texture.h"
+
+// Writes get_texture_level_bytes(format, width, height) bytes of blocks, row by row. Blocks
+// past the edge of levels that aren't a multiple of 4 repeat the last row and column.
+// Without a job system everything runs on the calling thread. RGBA8 is copied as it is.
+void compress_texture(SimdLevel level, TextureFormat format, const TextureData& image, JobSystem* pJobSystem,
+                      uint8_t* pBlocks);
+
+// Decodes blocks back into texels, for measuring the encoders. BC5 leaves blue at zero and
+// alpha opaque. Only BC7 mode 6 is decoded, other BC7 modes throw.
+TextureData decompress_texture(TextureFormat format, const uint8_t* pBlocks, uint32_t width, uint32_t height);
+
+#endif // BLOCK_COMPRESS_H
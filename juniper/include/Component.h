@@ -0,0 +1,64 @@
+//======================================================================
+// Component.h
+//
+// Keegan Kochis
+// Created: 2026/10/18
+// Component type ids and masks for the entity world.
+// Every component type gets a small id on first use, archetypes and
+// queries are bit masks over those ids. Components are plain data,
+// they are moved between chunks with memcpy and never constructed or
+// destroyed.
+//======================================================================
+
+#ifndef COMPONENT_H
+#define COMPONENT_H
+
+#include <cstdint>
+
+#include <type_traits>
+#include <typeinfo>
+
+#include "ResourcePool.h"
+
+struct EntityTag {};
+
+typedef Handle<EntityTag> Entity;
+
+static const uint32_t MAX_COMPONENTS = 64;
+
+typedef uint64_t ComponentMask;
+
+struct ComponentInfo_t {
+    uint32_t size;
+    uint32_t alignment;
+    const char* name;               // Demangled where possible, for stats and debugging only
+}; typedef ComponentInfo_t ComponentInfo;
+
+
+// Thread safe, called once per type by component_id
+uint32_t register_component(uint32_t size, uint32_t alignment, const char* name);
+const ComponentInfo& get_component_info(uint32_t id);
+uint32_t get_component_count();
+
+template <typename T>
+struct ComponentId {
+    static_assert(std::is_trivially_copyable<T>::value, "Components must be trivially copyable!");
+
+    static uint32_t get() {
+        static const uint32_t id = register_component(sizeof(T), alignof(T), typeid(T).name());
+        return id;
+    }
+};
+
+// const T shares the id of T, the qualifier only marks read access
+template <typename T>
+uint32_t component_id() {
+    return ComponentId<typename std::remove_cv<T>::type>::get();
+}
+
+template <typename... Components>
+ComponentMask component_mask() {
+    return (ComponentMask(0) | ... | (ComponentMask(1) << component_id<Components>()));
+}
+
+#endif // COMPONENT_H
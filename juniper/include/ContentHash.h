@@ -0,0 +1,27 @@
+//======================================================================
+// ContentHash.h
+//
+// Keegan Kochis
+// Created: 2026/10/18
+// 64 bit hashes of content for deciding what needs recooking. Not
+// cryptographic, just fast and well mixed enough that different inputs
+// practically never collide.
+//======================================================================
+
+#ifndef CONTENT_HASH_H
+#define CONTENT_HASH_H
+
+#include <cstddef>
+#include <cstdint>
+
+#include <string>
+
+uint64_t hash_bytes(const void* pData, size_t bytes, uint64_t seed);
+uint64_t hash_string(const std::string& text, uint64_t seed);
+// Order dependent, hash_combine(a, b) != hash_combine(b, a)
+uint64_t hash_combine(uint64_t hash, uint64_t value);
+
+// 16 lowercase hex digits, for manifests and file names
+std::string hash_to_string(uint64_t hash);
+
+#endif // CONTENT_HASH_H
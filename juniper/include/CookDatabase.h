@@ -0,0 +1,97 @@
+//======================================================================
+// CookDatabase.h
+//
+// Keegan Kochis
+// Created: 2026/10/19
+// The declaration of the CookDatabase class.
+// What every cook step last read and wrote. A step's record holds the
+// tool that ran it and its version, and each input and output file with
+// its size, modification time and content hash. Checking a file only
+// takes a stat while its size and time are as recorded, it's hashed
+// again only when they differ, so a file that was just touched or
+// rewritten with the same content doesn't count as changed. The
+// database is one text file in the output directory, rewritten whole
+// when it changed.
+//======================================================================
+
+#ifndef COOK_DATABASE_H
+#define COOK_DATABASE_H
+
+#include <cstdint>
+
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// A file as a cook step last saw it
+struct CookedFile_t {
+    std::string path;
+    uint64_t bytes;
+    int64_t modifiedNs;
+    uint64_t hash;
+}; typedef CookedFile_t CookedFile;
+
+
+struct CookRecord_t {
+    std::string tool;
+    // Of the tool, the formats it writes and its settings, any change recooks the step
+    uint64_t toolVersion;
+    // Of the input paths the step was given, so adding or dropping one recooks it
+    uint64_t inputListHash;
+    // The given inputs followed by the ones the tool found while cooking
+    std::vector<CookedFile> inputs;
+    std::vector<CookedFile> outputs;
+}; typedef CookRecord_t CookRecord;
+
+
+// The state of a file at the time it's checked
+enum FileCheck_t {
+    FILE_CHECK_UNCHANGED = 0,
+    FILE_CHECK_TOUCHED,             // New size or time, same content, the record was updated
+    FILE_CHECK_CHANGED,
+    FILE_CHECK_MISSING
+}; typedef FileCheck_t FileCheck;
+
+
+class CookDatabase {
+public:
+    static constexpr const char* FILE_NAME = "cook_database.txt";
+    static constexpr uint32_t VERSION = 1;
+
+
+    CookDatabase();
+
+    // Reads the records, a missing file or one of another version starts out empty
+    void open(const std::string& path);
+    // Writes every record if any was changed since the last save
+    void save();
+
+    const std::string& get_path() const { return mPath; }
+    uint32_t get_record_count() const { return static_cast<uint32_t>(mRecords.size()); }
+    // Null if the step has no record. Records stay where they are when others are added or
+    // removed, so steps can check their own records on many threads at once.
+    CookRecord* find(const std::string& step);
+    void set(const std::string& step, CookRecord record);
+    void remove(const std::string& step);
+    // Names of every recorded step
+    std::vector<std::string> get_steps() const;
+    // For changes made through find()
+    void mark_changed() { mChanged = true; }
+
+    // Fills in the size and time, false if the file doesn't exist
+    static bool stat_file(const std::string& path, CookedFile* pFile);
+    // Stats and hashes the file, throws if it doesn't exist
+    static CookedFile hash_file(const std::string& path);
+    // Compares the file to the record, updating the record if it was only touched
+    static FileCheck check_file(CookedFile& file);
+    // For inputs hashed right before a cook. A file read so soon after it was written could
+    // be written again without a new time, so its time is dropped if it's that recent.
+    static void forget_racy_time(CookedFile& file);
+
+private:
+    std::string mPath;
+    std::unordered_map<std::string, CookRecord> mRecords;
+    bool mChanged = false;
+};
+
+#endif // COOK_DATABASE_H
@@ -0,0 +1,148 @@
+//======================================================================
+// CookGraph.h
+//
+// Keegan Kochis
+// Created: 2026/10/19
+// The declaration of the CookGraph class.
+// The cook steps of a project and what they depend on. A step reads
+// its own inputs and every output of the steps it depends on, and runs
+// on the job system once they all finished, the same way the system
+// scheduler runs its DAG. Before running, a step is checked against its
+// record in the cook database and skipped if the tool, its inputs and
+// its outputs are all as recorded. Outputs are compared by content, so
+// a step recooked into the same bytes leaves the steps after it alone.
+// Given the files a watcher saw change, only the steps reading them
+// and the ones after those are checked at all.
+//======================================================================
+
+#ifndef COOK_GRAPH_H
+#define COOK_GRAPH_H
+
+#include <cstdint>
+
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <ostream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "CookDatabase.h"
+#include "JobSystem.h"
+
+typedef uint32_t CookStepId;
+
+class CookGraph {
+public:
+    // What a step's cook read besides the inputs it was given, and every file it wrote
+    struct CookResult_t {
+        std::vector<std::string> inputs;
+        std::vector<std::string> outputs;
+    }; typedef CookResult_t CookResult;
+
+
+    // Called with the step's inputs followed by the outputs of the steps it depends on.
+    // Throws if the cook failed.
+    typedef std::function<void(const std::vector<std::string>&, CookResult*)> CookFunction;
+
+
+    struct Stats_t {
+        uint32_t steps = 0;
+        uint32_t checkedSteps = 0;      // Compared to their records, the rest weren't affected
+        uint32_t cookedSteps = 0;
+        uint32_t failedSteps = 0;       // Including the ones after a failed step
+        uint32_t removedSteps = 0;      // Recorded but no longer in the graph
+        uint64_t filesChecked = 0;
+        uint64_t filesChanged = 0;      // Checked files whose size or time changed, touched ones included
+        double checkMs = 0.0;           // Summed over the threads
+        double cookMs = 0.0;            // Summed over the threads
+        double runMs = 0.0;
+    }; typedef Stats_t Stats;
+
+
+    CookGraph();
+
+    // Without a job system the steps run one after another on the calling thread
+    void init(JobSystem* pJobSystem, CookDatabase* pDatabase);
+    void clean_up();
+    // Off, every step is cooked whatever its record says
+    void set_incremental(bool incremental) { mIncremental = incremental; }
+
+    // Step names key the records and must be unique. A step can only depend on steps added
+    // before it, which keeps the graph acyclic.
+    CookStepId add_step(const std::string& name, const std::string& tool, uint64_t toolVersion,
+                        const std::vector<std::string>& inputs, const std::vector<CookStepId>& dependencies,
+                        CookFunction cook);
+    uint32_t get_step_count() const { return static_cast<uint32_t>(mSteps.size()); }
+    const std::string& get_step_name(CookStepId step) const { return mSteps[step]->name; }
+    // The outputs of the step's last successful cook
+    std::vector<std::string> get_outputs(CookStepId step) const;
+
+    // Checks every step and cooks the ones out of date, then drops the records of steps
+    // that are gone along with their outputs and saves the database. Throws the first
+    // failure once everything else ran, the failed steps stay out of date.
+    void run();
+    // The same for a watcher's changed paths, but only checks the steps that read one of
+    // them, the ones that never cooked and the ones after a step that cooked. Paths are
+    // compared as they were given and recorded.
+    void run_changed(const std::vector<std::string>& changedPaths);
+
+    const Stats& get_stats() const { return mStats; }
+    void print_stats(std::ostream& out) const;
+
+private:
+    enum StepState_t {
+        STEP_STATE_UNAFFECTED = 0,
+        STEP_STATE_UP_TO_DATE,
+        STEP_STATE_COOKED,
+        STEP_STATE_FAILED
+    }; typedef StepState_t StepState;
+
+    struct Step_t {
+        std::string name;
+        std::string tool;
+        uint64_t toolVersion;
+        std::vector<std::string> inputs;
+        std::vector<CookStepId> dependencies;
+        std::vector<CookStepId> successors;
+        CookFunction cook;
+
+        // Per run
+        bool mustCheck = false;
+        StepState state = STEP_STATE_UNAFFECTED;
+        std::atomic<uint32_t> remainingDependencies{0};
+        CookRecord* pRecord = nullptr;  // Into the database, null if never cooked
+        CookRecord cookedRecord;        // Moved into the database after the run
+        std::string error;
+    }; typedef Step_t Step;
+
+    JobSystem* mpJobSystem = nullptr;
+    CookDatabase* mpDatabase = nullptr;
+    bool mIncremental = true;
+    std::vector<std::unique_ptr<Step>> mSteps;
+    std::unordered_map<std::string, CookStepId> mStepIds;
+    // Steps without dependencies, where every run starts
+    std::vector<CookStepId> mRoots;
+    // Path to the steps that read it, as recorded or given
+    std::unordered_map<std::string, std::vector<CookStepId>> mReaders;
+    bool mReadersBuilt = false;
+    std::atomic<uint64_t> mFilesChecked{0};
+    std::atomic<uint64_t> mFilesChanged{0};
+    std::atomic<bool> mRecordsTouched{false};
+    std::atomic<uint64_t> mCheckNs{0};
+    std::atomic<uint64_t> mCookNs{0};
+    Stats mStats;
+
+    void run_steps(bool checkAll);
+    void commit();
+    void check(CookStepId step, JobSystem::JobCounter* pCounter);
+    void finish(CookStepId step, JobSystem::JobCounter* pCounter);
+    bool is_up_to_date(Step& step, const std::vector<std::string>& inputs);
+    void cook(Step& step, const std::vector<std::string>& inputs);
+    void add_reader(const std::string& path, CookStepId step);
+    void remove_stale_records();
+    static uint64_t hash_input_list(const std::vector<std::string>& inputs);
+};
+
+#endif // COOK_GRAPH_H
@@ -0,0 +1,89 @@
+//======================================================================
+// DeletionQueue.h
+//
+// Keegan Kochis
+// Created: 2026/10/18
+// The declaration of the DeletionQueue class.
+// Vulkan objects are handed to the queue together with the timeline
+// values of the work that last used them, and are only destroyed once
+// the GPU has passed those values. Nothing has to idle the device to
+// get rid of a resource mid-run.
+//======================================================================
+
+#ifndef DELETION_QUEUE_H
+#define DELETION_QUEUE_H
+
+#include <cstdint>
+
+#include <vector>
+
+#define GLFW_INCLUDE_VULKAN
+#include <GLFW/glfw3.h>
+
+#include "TimelineSync.h"
+
+class DeletionQueue {
+public:
+    enum ResourceType_t {
+        RESOURCE_BUFFER = 0,
+        RESOURCE_IMAGE,
+        RESOURCE_IMAGE_VIEW,
+        RESOURCE_SAMPLER,
+        RESOURCE_DEVICE_MEMORY,
+        RESOURCE_PIPELINE,
+        RESOURCE_PIPELINE_LAYOUT,
+        RESOURCE_DESCRIPTOR_POOL,
+        RESOURCE_FRAMEBUFFER,
+        RESOURCE_SWAPCHAIN,
+        RESOURCE_TYPE_COUNT
+    }; typedef ResourceType_t ResourceType;
+
+
+    // Timeline value per queue that has to be reached before the resource may go
+    struct RetirePoint_t {
+        uint64_t values[TimelineSync::QUEUE_COUNT] = {};
+    }; typedef RetirePoint_t RetirePoint;
+
+
+    DeletionQueue();
+
+    void init(VkDevice device, TimelineSync* pTimelineSync);
+    // Destroys everything still queued without checking the timelines. The caller
+    // must have waited for the device first.
+    void clean_up();
+
+    // Everything submitted on any queue so far, the safe choice when the last user is unknown
+    RetirePoint retire_point_now() const;
+    static RetirePoint retire_point(TimelineSync::QueueType queue, uint64_t value);
+
+    template <typename T>
+    void enqueue(ResourceType type, T handle) { enqueue(type, handle, retire_point_now()); }
+    template <typename T>
+    void enqueue(ResourceType type, T handle, const RetirePoint& retirePoint) {
+        push(type, (uint64_t) handle, retirePoint);
+    }
+
+    // Destroy every resource whose work has completed. Call once per frame.
+    uint32_t collect();
+
+    size_t pending_count() const { return mPending.size(); }
+    uint64_t destroyed_count() const { return mDestroyedCount; }
+
+private:
+    struct PendingDeletion_t {
+        ResourceType type;
+        uint64_t handle;
+        RetirePoint retirePoint;
+    }; typedef PendingDeletion_t PendingDeletion;
+
+    VkDevice mDevice = VK_NULL_HANDLE;
+    TimelineSync* mpTimelineSync = nullptr;
+    std::vector<PendingDeletion> mPending;
+    uint64_t mDestroyedCount = 0;
+
+    void push(ResourceType type, uint64_t handle, const RetirePoint& retirePoint);
+    bool is_retired(const RetirePoint& retirePoint);
+    void destroy(const PendingDeletion& deletion);
+};
+
+#endif // DELETION_QUEUE_H
@@ -0,0 +1,75 @@
+//======================================================================
+// DepthPyramid.h
+//
+// Keegan Kochis
+// Created: 2026/10/18
+// The declaration of the DepthPyramid class.
+// A hierarchical-Z pyramid built from the depth buffer by a chain of
+// compute downsamples. Every texel holds the farthest depth of the
+// screen region it covers, so a bounding volume whose nearest depth is
+// behind it is fully occluded.
+//======================================================================
+
+#ifndef DEPTH_PYRAMID_H
+#define DEPTH_PYRAMID_H
+
+#include <cstdint>
+
+#include <vector>
+
+#define GLFW_INCLUDE_VULKAN
+#include <GLFW/glfw3.h>
+
+#include "DeletionQueue.h"
+#include "DescriptorAllocator.h"
+#include "GpuResources.h"
+
+class DepthPyramid {
+public:
+    struct PushConstants_t {
+        int32_t sourceWidth;
+        int32_t sourceHeight;
+        int32_t destinationWidth;
+        int32_t destinationHeight;
+    }; typedef PushConstants_t PushConstants;
+
+
+    DepthPyramid();
+
+    // The depth image must be created with sampled usage
+    void init(VkDevice device, GpuResources* pGpuResources, DeletionQueue* pDeletionQueue,
+              DescriptorAllocator* pDescriptorAllocator, ImageHandle depthImage, VkExtent2D depthExtent);
+    void clean_up();
+
+    // Move the pyramid into the general layout the first time it is used
+    void ensure_layout(VkCommandBuffer commandBuffer);
+    // The depth image must be in VK_IMAGE_LAYOUT_DEPTH_STENCIL_READ_ONLY_OPTIMAL with its
+    // writes made visible to compute shaders
+    void build(VkCommandBuffer commandBuffer);
+
+    VkImageView get_view() const { return mpGpuResources->get_image_view(mPyramid); }
+    VkSampler get_sampler() const { return mpGpuResources->get_sampler(mSampler); }
+    VkExtent2D get_extent() const { return mExtent; }
+    uint32_t get_level_count() const { return mLevelCount; }
+
+private:
+    VkDevice mDevice = VK_NULL_HANDLE;
+    GpuResources* mpGpuResources = nullptr;
+    DeletionQueue* mpDeletionQueue = nullptr;
+    DescriptorAllocator* mpDescriptorAllocator = nullptr;
+
+    ImageHandle mDepthImage;
+    VkExtent2D mDepthExtent{};
+    ImageHandle mPyramid;
+    VkExtent2D mExtent{};
+    uint32_t mLevelCount = 0;
+    std::vector<VkImageView> mLevelViews;
+    SamplerHandle mSampler;
+    bool mLayoutInitialized = false;
+
+    VkDescriptorSetLayout mSetLayout = VK_NULL_HANDLE;
+    VkPipelineLayout mPipelineLayout = VK_NULL_HANDLE;
+    PipelineHandle mPipeline;
+};
+
+#endif // DEPTH_PYRAMID_H
@@ -0,0 +1,114 @@
+//======================================================================
+// DescriptorAllocator.h
+//
+// Keegan Kochis
+// Created: 2026/10/18
+// The declaration of the DescriptorAllocator class.
+// Hands out descriptor sets from growable chains of descriptor pools.
+// Transient sets live in per-frame pools which are reset as a whole
+// once the frame retires. Set layouts and immutable sets are cached.
+//======================================================================
+
+#ifndef DESCRIPTOR_ALLOCATOR_H
+#define DESCRIPTOR_ALLOCATOR_H
+
+#include <cstddef>
+#include <cstdint>
+
+#include <ostream>
+#include <unordered_map>
+#include <vector>
+
+#define GLFW_INCLUDE_VULKAN
+#include <GLFW/glfw3.h>
+
+class DescriptorAllocator {
+public:
+    // One resource bound into an immutable descriptor set. Only the info
+    // struct matching the descriptor type is read.
+    struct DescriptorWrite_t {
+        uint32_t binding = 0;
+        VkDescriptorType type = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
+        VkDescriptorBufferInfo bufferInfo{};
+        VkDescriptorImageInfo imageInfo{};
+    }; typedef DescriptorWrite_t DescriptorWrite;
+
+
+    struct Stats_t {
+        uint64_t transientSetsAllocated = 0;   // Since the allocator was created
+        uint64_t immutableSetsAllocated = 0;   // Cache misses in get_immutable_set
+        uint64_t immutableSetCacheHits = 0;
+        uint64_t layoutsCreated = 0;
+        uint64_t layoutCacheHits = 0;
+        uint64_t poolsCreated = 0;             // Pool growth, never shrinks
+        uint64_t poolResets = 0;
+        uint64_t poolExhaustions = 0;          // VK_ERROR_OUT_OF_POOL_MEMORY / FRAGMENTED_POOL retries
+        uint32_t transientSetsThisFrame = 0;
+        uint32_t poolsInUse = 0;
+        uint32_t poolsFree = 0;
+    }; typedef Stats_t Stats;
+
+
+    DescriptorAllocator();
+
+    void init(VkDevice device, uint32_t framesInFlight);
+    void clean_up();
+
+    // Call once the GPU has finished the previous use of frameIndex.
+    // Every transient set handed out for that frame becomes invalid.
+    void begin_frame(uint32_t frameIndex);
+
+    VkDescriptorSetLayout get_layout(const std::vector<VkDescriptorSetLayoutBinding>& bindings);
+    VkDescriptorSet allocate_transient(VkDescriptorSetLayout layout);
+    VkDescriptorSet get_immutable_set(VkDescriptorSetLayout layout, const std::vector<DescriptorWrite>& writes);
+    // Drop every cached immutable set, e.g. after the resources they point at were destroyed
+    void release_immutable_sets();
+
+    const Stats& get_stats() const { return mStats; }
+    void print_stats(std::ostream& out) const;
+
+private:
+    struct PoolChain_t {
+        std::vector<VkDescriptorPool> usedPools;
+        VkDescriptorPool currentPool = VK_NULL_HANDLE;
+    }; typedef PoolChain_t PoolChain;
+
+    struct LayoutKey_t {
+        std::vector<VkDescriptorSetLayoutBinding> bindings;
+        size_t hash = 0;
+        bool operator==(const LayoutKey_t& other) const;
+    }; typedef LayoutKey_t LayoutKey;
+
+    struct SetKey_t {
+        VkDescriptorSetLayout layout = VK_NULL_HANDLE;
+        std::vector<DescriptorWrite> writes;
+        size_t hash = 0;
+        bool operator==(const SetKey_t& other) const;
+    }; typedef SetKey_t SetKey;
+
+    struct KeyHasher_t {
+        size_t operator()(const LayoutKey& key) const { return key.hash; }
+        size_t operator()(const SetKey& key) const { return key.hash; }
+    }; typedef KeyHasher_t KeyHasher;
+
+    // Pool growth: each new pool holds twice as many sets as the previous one up to the max
+    static const uint32_t INITIAL_SETS_PER_POOL = 64;
+    static const uint32_t MAX_SETS_PER_POOL = 4096;
+
+    VkDevice mDevice = VK_NULL_HANDLE;
+    uint32_t mCurrentFrame = 0;
+    uint32_t mNextPoolSize = INITIAL_SETS_PER_POOL;
+    std::vector<PoolChain> mFramePools;
+    PoolChain mImmutablePools;
+    std::vector<VkDescriptorPool> mFreePools;
+    std::unordered_map<LayoutKey, VkDescriptorSetLayout, KeyHasher> mLayoutCache;
+    std::unordered_map<SetKey, VkDescriptorSet, KeyHasher> mImmutableSetCache;
+    Stats mStats;
+
+    VkDescriptorPool grab_pool();
+    VkDescriptorPool create_pool(uint32_t maxSets);
+    VkDescriptorSet allocate_from_chain(PoolChain& chain, VkDescriptorSetLayout layout);
+    void reset_chain(PoolChain& chain);
+};
+
+#endif // DESCRIPTOR_ALLOCATOR_H
@@ -0,0 +1,115 @@
+//======================================================================
+// DeviceFeatures.h
+//
+// Keegan Kochis
+// Created: 2026/10/18
+// The declaration of the DeviceFeatures class.
+// Negotiates the Vulkan API version, core features and a curated list
+// of performance extensions with the physical device, and sorts the
+// result into a capability tier the renderer can branch on.
+//======================================================================
+
+#ifndef DEVICE_FEATURES_H
+#define DEVICE_FEATURES_H
+
+#include <cstdint>
+
+#include <ostream>
+#include <string>
+#include <vector>
+
+#define GLFW_INCLUDE_VULKAN
+#include <GLFW/glfw3.h>
+
+class DeviceFeatures {
+public:
+    enum CapabilityTier_t {
+        // Draws recorded on the CPU, no meshlet renderer
+        CAPABILITY_TIER_LEGACY = 0,
+        // Multi draw indirect with a non-zero firstInstance, culling and draws built on the GPU
+        CAPABILITY_TIER_GPU_DRIVEN = 1,
+        // GPU driven plus drawIndirectCount, the draw counts are read on the GPU too
+        CAPABILITY_TIER_INDIRECT_COUNT = 2
+    }; typedef CapabilityTier_t CapabilityTier;
+
+
+    struct Capabilities_t {
+        uint32_t apiVersion = VK_API_VERSION_1_0;
+        CapabilityTier tier = CAPABILITY_TIER_LEGACY;
+
+        // Core 1.0 features
+        bool multiDrawIndirect = false;
+        bool drawIndirectFirstInstance = false;
+        bool samplerAnisotropy = false;
+        bool textureCompressionBC = false;
+        bool shaderInt16 = false;
+
+        // Core 1.2 or the matching extension
+        bool timelineSemaphore = false;
+        bool drawIndirectCount = false;
+        bool bufferDeviceAddress = false;
+        bool descriptorIndexing = false;
+        bool samplerFilterMinmax = false;
+        bool hostQueryReset = false;
+        bool shaderDrawParameters = false;
+        bool storageBuffer16BitAccess = false;
+
+        // Core 1.3 or the matching extension
+        bool dynamicRendering = false;
+        bool synchronization2 = false;
+
+        // Extensions only
+        bool memoryBudget = false;
+        bool meshShader = false;
+
+        bool has_tier(CapabilityTier minimum) const { return tier >= minimum; }
+    }; typedef Capabilities_t Capabilities;
+
+
+    DeviceFeatures();
+
+    // Highest instance version both the loader and these headers know about
+    static uint32_t query_instance_version();
+
+    void negotiate(VkInstance instance, VkPhysicalDevice device, uint32_t instanceVersion,
+                   const std::vector<const char*>& requiredExtensions);
+    // Points the create info at the negotiated feature chain and extension list.
+    // The pointers stay valid for the lifetime of this object.
+    void populate_device_create_info(VkDeviceCreateInfo& createInfo);
+
+    const Capabilities& get_capabilities() const { return mCapabilities; }
+    bool has_tier(CapabilityTier tier) const { return mCapabilities.has_tier(tier); }
+    void print(std::ostream& out) const;
+
+    static const char* tier_name(CapabilityTier tier);
+
+private:
+    Capabilities mCapabilities;
+    std::vector<std::string> mExtensionNames;
+    std::vector<const char*> mEnabledExtensions;
+    bool mUseFeatures2 = false;
+
+    VkPhysicalDeviceFeatures2 mFeatures2{};
+    VkPhysicalDeviceVulkan11Features mVulkan11Features{};
+    VkPhysicalDeviceVulkan12Features mVulkan12Features{};
+#ifdef VK_API_VERSION_1_3
+    VkPhysicalDeviceVulkan13Features mVulkan13Features{};
+#endif
+    // Used instead of the VulkanXXFeatures structs on 1.1 devices
+    VkPhysicalDeviceTimelineSemaphoreFeatures mTimelineSemaphoreFeatures{};
+    VkPhysicalDeviceBufferDeviceAddressFeatures mBufferDeviceAddressFeatures{};
+    VkPhysicalDeviceShaderDrawParametersFeatures mShaderDrawParametersFeatures{};
+#ifdef VK_KHR_dynamic_rendering
+    VkPhysicalDeviceDynamicRenderingFeaturesKHR mDynamicRenderingFeatures{};
+#endif
+#ifdef VK_KHR_synchronization2
+    VkPhysicalDeviceSynchronization2FeaturesKHR mSynchronization2Features{};
+#endif
+    VkPhysicalDeviceMeshShaderFeaturesNV mMeshShaderFeatures{};
+
+    bool enable_extension(const std::vector<VkExtensionProperties>& available, const char* name);
+    void build_feature_chain();
+    void choose_tier();
+};
+
+#endif // DEVICE_FEATURES_H
@@ -0,0 +1,81 @@
+//======================================================================
+// EntityCommandBuffer.h
+//
+// Keegan Kochis
+// Created: 2026/10/18
+// The declaration of the EntityCommandBuffer class.
+// Records structural changes, creating and destroying entities and
+// adding and removing components, so they can be made while a query
+// iterates or from several threads, one buffer per thread. Recording
+// never touches the world, the changes are applied in order by
+// playback once iteration is done.
+//======================================================================
+
+#ifndef ENTITY_COMMAND_BUFFER_H
+#define ENTITY_COMMAND_BUFFER_H
+
+#include <cstdint>
+#include <cstring>
+
+#include <vector>
+
+#include "Component.h"
+#include "EntityWorld.h"
+
+class EntityCommandBuffer {
+public:
+    // Entity created by this buffer, only meaningful to the same buffer until playback
+    struct PendingEntity_t {
+        uint32_t index;
+    }; typedef PendingEntity_t PendingEntity;
+
+
+    PendingEntity create_entity();
+    void destroy_entity(Entity entity);
+
+    template <typename T>
+    void add_component(Entity entity, const T& value) {
+        record(COMMAND_ADD, entity.value(), false, component_id<T>(), &value, sizeof(T));
+    }
+
+    template <typename T>
+    void add_component(PendingEntity entity, const T& value) {
+        record(COMMAND_ADD, entity.index, true, component_id<T>(), &value, sizeof(T));
+    }
+
+    template <typename T>
+    void remove_component(Entity entity) {
+        record(COMMAND_REMOVE, entity.value(), false, component_id<T>(), nullptr, 0);
+    }
+
+    // Commands on entities that died in the meantime are skipped. Returns the created
+    // entities in the order of create_entity and clears the buffer.
+    std::vector<Entity> playback(EntityWorld& world);
+
+    bool empty() const { return mCommands.empty(); }
+    void clear();
+
+private:
+    enum CommandType_t {
+        COMMAND_CREATE = 0,
+        COMMAND_DESTROY,
+        COMMAND_ADD,
+        COMMAND_REMOVE
+    }; typedef CommandType_t CommandType;
+
+    struct Command_t {
+        CommandType type;
+        uint32_t target;            // Entity value, or pending index when pending is set
+        bool pending;
+        uint32_t componentId;
+        uint32_t dataOffset;        // Component value in mData for COMMAND_ADD
+    }; typedef Command_t Command;
+
+    std::vector<Command> mCommands;
+    std::vector<uint8_t> mData;
+    uint32_t mPendingCount = 0;
+
+    void record(CommandType type, uint32_t target, bool pending, uint32_t componentId, const void* pData, uint32_t size);
+};
+
+#endif // ENTITY_COMMAND_BUFFER_H
@@ -0,0 +1,229 @@
+//======================================================================
+// EntityWorld.h
+//
+// Keegan Kochis
+// Created: 2026/10/18
+// The declaration of the EntityWorld class.
+// Entities with the same set of components share an archetype, whose
+// entities live in fixed size chunks with one packed column per
+// component. Queries cache the archetypes they match and iterate the
+// columns chunk by chunk. Adding or removing components moves the
+// entity to another archetype, which must not happen while a query is
+// iterating, record it in an EntityCommandBuffer instead.
+// Queries may iterate from several threads at once, e.g. over disjoint
+// chunk lists from get_chunks. Everything else is single threaded.
+//======================================================================
+
+#ifndef ENTITY_WORLD_H
+#define ENTITY_WORLD_H
+
+#include <cstdint>
+#include <cstring>
+
+#include <atomic>
+#include <ostream>
+#include <stdexcept>
+#include <unordered_map>
+#include <vector>
+
+#include "Component.h"
+
+typedef uint32_t QueryId;
+
+class EntityWorld {
+public:
+    static constexpr uint32_t CHUNK_SIZE = 16 * 1024;
+    static constexpr uint32_t CHUNK_ALIGNMENT = 64;
+
+
+    // One chunk a query matches, valid until the next structural change
+    struct QueryChunk_t {
+        uint32_t archetype;
+        uint32_t chunk;
+        uint32_t count;
+    }; typedef QueryChunk_t QueryChunk;
+
+
+    struct Stats_t {
+        uint32_t entities = 0;
+        uint32_t archetypes = 0;
+        uint32_t chunks = 0;
+        uint32_t queries = 0;
+        uint64_t structuralChanges = 0;     // Entities created, destroyed or moved between archetypes
+    }; typedef Stats_t Stats;
+
+
+    EntityWorld();
+    ~EntityWorld();
+    EntityWorld(const EntityWorld&) = delete;
+    EntityWorld& operator=(const EntityWorld&) = delete;
+
+    void clean_up();
+
+    // The entity goes straight into the archetype of the given components
+    template <typename... Components>
+    Entity create_entity(const Components&... components) {
+        Entity entity = create_entity_with(component_mask<Components...>());
+        (std::memcpy(get_component_data(entity, component_id<Components>()), &components, sizeof(Components)), ...);
+        return entity;
+    }
+
+    void destroy_entity(Entity entity);
+    bool is_alive(Entity entity) const;
+
+    // Overwrites the value if the entity already has the component
+    template <typename T>
+    void add_component(Entity entity, const T& value) {
+        add_component_data(entity, component_id<T>(), &value);
+    }
+
+    template <typename T>
+    void remove_component(Entity entity) {
+        remove_component_data(entity, component_id<T>());
+    }
+
+    template <typename T>
+    bool has_component(Entity entity) const {
+        return (get_mask(entity) & component_mask<T>()) != 0;
+    }
+
+    // nullptr if the entity doesn't have the component. Valid until the next structural change.
+    template <typename T>
+    T* get_component(Entity entity) {
+        return static_cast<T*>(get_component_data(entity, component_id<T>()));
+    }
+
+    // Type erased versions used by EntityCommandBuffer playback
+    void add_component_data(Entity entity, uint32_t componentId, const void* pData);
+    void remove_component_data(Entity entity, uint32_t componentId);
+    void* get_component_data(Entity entity, uint32_t componentId);
+    ComponentMask get_mask(Entity entity) const;
+
+    // Matches the archetypes with every component of all and none of none
+    QueryId create_query(ComponentMask all, ComponentMask none);
+
+    template <typename... Components>
+    QueryId create_query() {
+        return create_query(component_mask<Components...>(), 0);
+    }
+
+    // function(uint32_t count, const Entity* pEntities, Components*... pColumns) per non-empty chunk
+    template <typename... Components, typename Function>
+    void for_each_chunk(QueryId queryId, Function function) {
+        const Query& query = mQueries[queryId];
+        check_query_access(query, component_mask<Components...>());
+
+        IterationScope scope(mIterationDepth);
+        for (uint32_t archetypeIndex : query.archetypes) {
+            Archetype& archetype = mArchetypes[archetypeIndex];
+            for (Chunk& chunk : archetype.chunks) {
+                function(chunk.count, reinterpret_cast<const Entity*>(chunk.pData), column<Components>(archetype, chunk)...);
+            }
+        }
+    }
+
+    // Same as above over a range of the chunks from get_chunks of the same query
+    template <typename... Components, typename Function>
+    void for_each_chunk(QueryId queryId, const QueryChunk* pChunks, uint32_t chunkCount, Function function) {
+        check_query_access(mQueries[queryId], component_mask<Components...>());
+
+        IterationScope scope(mIterationDepth);
+        for (uint32_t i = 0; i < chunkCount; i++) {
+            Archetype& archetype = mArchetypes[pChunks[i].archetype];
+            Chunk& chunk = archetype.chunks[pChunks[i].chunk];
+            function(chunk.count, reinterpret_cast<const Entity*>(chunk.pData), column<Components>(archetype, chunk)...);
+        }
+    }
+
+    // function(Entity entity, Components&... components) per entity
+    template <typename... Components, typename Function>
+    void for_each(QueryId queryId, Function function) {
+        for_each_chunk<Components...>(queryId, [&function](uint32_t count, const Entity* pEntities, Components*... pColumns) {
+            for (uint32_t i = 0; i < count; i++) {
+                function(pEntities[i], pColumns[i]...);
+            }
+        });
+    }
+
+    uint32_t get_entity_count() const { return mEntityCount; }
+    // Number of entities the query currently matches
+    uint32_t count(QueryId queryId) const;
+    // The query's non-empty chunks in iteration order, for splitting it across threads
+    void get_chunks(QueryId queryId, std::vector<QueryChunk>& chunks) const;
+    ComponentMask get_query_mask(QueryId queryId) const { return mQueries[queryId].all; }
+
+    Stats get_stats() const;
+    void print_stats(std::ostream& out) const;
+
+private:
+    static constexpr uint32_t INVALID_INDEX = UINT32_MAX;
+
+    struct Chunk_t {
+        // Entities column first, then one column per component of the archetype
+        uint8_t* pData;
+        uint32_t count;
+    }; typedef Chunk_t Chunk;
+
+    struct Archetype_t {
+        ComponentMask mask;
+        std::vector<uint32_t> components;           // Component ids, ascending
+        std::vector<uint32_t> sizes;
+        std::vector<uint32_t> offsets;              // Column offsets within a chunk
+        uint8_t columns[MAX_COMPONENTS];            // Component id to column, 0xFF if absent
+        uint32_t addEdges[MAX_COMPONENTS];          // Archetype with the component added, cached on first use
+        uint32_t removeEdges[MAX_COMPONENTS];
+        uint32_t capacity;                          // Entities per chunk
+        uint32_t entityCount;
+        std::vector<Chunk> chunks;                  // Every chunk but the last is full
+    }; typedef Archetype_t Archetype;
+
+    struct EntityRecord_t {
+        uint32_t generation = 1;
+        uint32_t archetype = INVALID_INDEX;
+        uint32_t chunk = 0;
+        uint32_t row = 0;
+    }; typedef EntityRecord_t EntityRecord;
+
+    struct Query_t {
+        ComponentMask all;
+        ComponentMask none;
+        std::vector<uint32_t> archetypes;
+    }; typedef Query_t Query;
+
+    // Counts nested iterations, also when the function throws
+    struct IterationScope {
+        std::atomic<uint32_t>& depth;
+        explicit IterationScope(std::atomic<uint32_t>& iterationDepth) : depth(iterationDepth) { depth++; }
+        ~IterationScope() { depth--; }
+    };
+
+    std::vector<Archetype> mArchetypes;
+    std::unordered_map<ComponentMask, uint32_t> mArchetypeLookup;
+    std::vector<EntityRecord> mEntities;
+    std::vector<uint32_t> mFreeEntities;
+    std::vector<Query> mQueries;
+    // Released chunks are kept for reuse, they are all the same size
+    std::vector<uint8_t*> mFreeChunks;
+    uint32_t mChunkCount = 0;
+    uint32_t mEntityCount = 0;
+    uint64_t mStructuralChanges = 0;
+    std::atomic<uint32_t> mIterationDepth{0};
+
+    template <typename T>
+    static T* column(Archetype& archetype, Chunk& chunk) {
+        const uint8_t column = archetype.columns[component_id<T>()];
+        return reinterpret_cast<T*>(chunk.pData + archetype.offsets[column]);
+    }
+
+    Entity create_entity_with(ComponentMask mask);
+    const EntityRecord& checked_record(Entity entity) const;
+    void check_structural_change() const;
+    void check_query_access(const Query& query, ComponentMask accessed) const;
+
+    uint32_t find_archetype(ComponentMask mask);
+    void allocate_row(uint32_t archetypeIndex, uint32_t& chunkIndex, uint32_t& row);
+    void remove_row(uint32_t archetypeIndex, uint32_t chunkIndex, uint32_t row);
+    void move_entity(Entity entity, uint32_t targetArchetype);
+};
+
+#endif // ENTITY_WORLD_H
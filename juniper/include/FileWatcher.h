@@ -0,0 +1,89 @@
+//======================================================================
+// FileWatcher.h
+//
+// Keegan Kochis
+// Created: 2026/10/19
+// The declaration of the FileWatcher class.
+// Reports the files that changed under a directory, so a cook daemon
+// only has to look at what was edited. On Linux every directory of the
+// tree gets an inotify watch and the kernel queues the changes as they
+// happen. On other platforms, or when the kernel is out of watches, the
+// tree is scanned at an interval and compared with the last scan. A
+// burst of changes is gathered until the tree went quiet, so a file
+// saved in several writes is reported once.
+//======================================================================
+
+#ifndef FILE_WATCHER_H
+#define FILE_WATCHER_H
+
+#include <cstdint>
+
+#include <ostream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+enum WatchBackend_t {
+    WATCH_BACKEND_INOTIFY = 0,
+    WATCH_BACKEND_POLLING
+}; typedef WatchBackend_t WatchBackend;
+
+
+class FileWatcher {
+public:
+    // Quiet time after the last change before the changes are reported
+    static constexpr uint32_t SETTLE_MS = 50;
+    static constexpr uint32_t POLL_INTERVAL_MS = 250;
+
+
+    struct Stats_t {
+        uint32_t watches = 0;           // Directories with an inotify watch
+        uint64_t events = 0;            // Read from inotify, or differences found by scans
+        uint64_t scans = 0;
+        uint32_t overflows = 0;
+    }; typedef Stats_t Stats;
+
+
+    FileWatcher();
+    ~FileWatcher();
+    FileWatcher(const FileWatcher&) = delete;
+    FileWatcher& operator=(const FileWatcher&) = delete;
+
+    // Watches the directory and everything under it. Falls back to polling when inotify
+    // can't watch the whole tree, get_backend() tells.
+    void init(WatchBackend backend, const std::string& directory);
+    void clean_up();
+    WatchBackend get_backend() const { return mBackend; }
+
+    // Waits up to the timeout for a change, then until nothing changed for SETTLE_MS, and
+    // adds the files written, created, removed or moved in or out to the paths, sorted
+    // without duplicates. Directories moved out are reported as the directory. Paths start
+    // with the directory as it was given. Returns false if the kernel dropped changes,
+    // after which everything under the directory has to be checked.
+    bool wait_for_changes(uint32_t timeoutMs, std::vector<std::string>* pPaths);
+
+    const Stats& get_stats() const { return mStats; }
+    void print_stats(std::ostream& out) const;
+
+private:
+    struct FileState_t {
+        uint64_t bytes;
+        int64_t modifiedNs;
+    }; typedef FileState_t FileState;
+
+    WatchBackend mBackend = WATCH_BACKEND_POLLING;
+    std::string mDirectory;
+    int mFd = -1;
+    // Watch descriptor to the directory it watches
+    std::unordered_map<int, std::string> mWatchedDirectories;
+    // Polling only, every file under the directory at the last scan
+    std::unordered_map<std::string, FileState> mFiles;
+    Stats mStats;
+
+    bool watch_tree(const std::string& directory, std::vector<std::string>* pFiles);
+    bool read_events(uint32_t timeoutMs, std::vector<std::string>* pPaths, bool* pLost);
+    bool poll_changes(uint32_t timeoutMs, std::vector<std::string>* pPaths);
+    std::unordered_map<std::string, FileState> scan() const;
+};
+
+#endif // FILE_WATCHER_H
@@ -0,0 +1,99 @@
+//======================================================================
+// FixedTimestep.h
+//
+// Keegan Kochis
+// Created: 2026/10/18
+// The declaration of the FixedTimestep class.
+// Runs the simulation in steps of a fixed length, however long the
+// frames take. Inline, each frame adds its duration to an accumulator
+// and runs the steps that fit. Threaded, a simulation thread steps on
+// its own clock. Either way the renderer blends the last two states by
+// get_alpha. When the simulation falls behind, by a long frame or a
+// step costing more than its length, the steps past maxStepsPerFrame
+// are dropped so the next frame doesn't fall further behind.
+//======================================================================
+
+#ifndef FIXED_TIMESTEP_H
+#define FIXED_TIMESTEP_H
+
+#include <cstdint>
+
+#include <atomic>
+#include <functional>
+#include <mutex>
+#include <ostream>
+#include <thread>
+
+class FixedTimestep {
+public:
+    struct Settings_t {
+        double stepSeconds;
+        uint32_t maxStepsPerFrame;
+        // Longer frames, e.g. after a breakpoint or window drag, count as this long
+        double maxFrameSeconds;
+        bool threaded;
+    }; typedef Settings_t Settings;
+
+
+    struct Stats_t {
+        uint64_t steps = 0;
+        uint64_t droppedSteps = 0;
+        uint64_t clampedFrames = 0;
+        uint32_t lastFrameSteps = 0;
+        double simulationTime = 0.0;
+    }; typedef Stats_t Stats;
+
+
+    // function(double time, float deltaTime) advances the simulation by one step
+    typedef std::function<void(double, float)> StepFunction;
+
+
+    FixedTimestep();
+    ~FixedTimestep();
+    FixedTimestep(const FixedTimestep&) = delete;
+    FixedTimestep& operator=(const FixedTimestep&) = delete;
+
+    // Threaded, the simulation thread starts stepping right away
+    void init(const Settings& settings, StepFunction step);
+    void clean_up();
+
+    // Inline, runs the steps due since the last call. Does nothing when threaded.
+    void advance();
+
+    // Held by every step, hold it while reading the simulation state
+    std::mutex& get_state_mutex() { return mStateMutex; }
+    // How far past the last step the present is, in steps from 0 to 1. Call with the state
+    // mutex held, so no step lands between reading the alpha and the state.
+    float get_alpha() const;
+
+    bool is_threaded() const { return mSettings.threaded; }
+    Stats get_stats() const;
+    void print_stats(std::ostream& out) const;
+
+private:
+    Settings mSettings = {};
+    StepFunction mStep;
+    std::mutex mStateMutex;
+
+    // Inline
+    double mLastFrameSeconds = 0.0;
+    double mAccumulator = 0.0;
+
+    // Threaded
+    std::thread mThread;
+    std::atomic<bool> mStopping{false};
+    // Clock time the current state belongs to, written with the state mutex held
+    double mStateSeconds = 0.0;
+
+    std::atomic<uint64_t> mSteps{0};
+    std::atomic<uint64_t> mDroppedSteps{0};
+    std::atomic<uint64_t> mClampedFrames{0};
+    std::atomic<uint32_t> mLastFrameSteps{0};
+    std::atomic<double> mSimulationTime{0.0};
+
+    void run_step(double stateSeconds);
+    void thread_main();
+    static double now_seconds();
+};
+
+#endif // FIXED_TIMESTEP_H
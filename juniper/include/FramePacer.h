@@ -0,0 +1,91 @@
+//======================================================================
+// FramePacer.h
+//
+// Keegan Kochis
+// Created: 2026/10/18
+// The declaration of the FramePacer class.
+// Holds the main loop to a target frame rate when presentation doesn't,
+// e.g. with MAILBOX, which would otherwise render as fast as it can.
+// OS sleeps overshoot by a varying amount, so the pacer sleeps in short
+// quanta while the remaining time exceeds its estimate of the overshoot
+// and spins for the rest. Frame deadlines advance by the frame interval
+// rather than from when the wait returned, so an early or late frame
+// doesn't shift all the following ones. Frame interval statistics are
+// exported to the profiler as counters.
+//======================================================================
+
+#ifndef FRAME_PACER_H
+#define FRAME_PACER_H
+
+#include <cstdint>
+
+#include <ostream>
+#include <vector>
+
+#include "Profiler.h"
+
+// What the present mode is chosen for, and whether the pacer has to cap the frame rate
+enum PresentPolicy_t {
+    PRESENT_POLICY_VSYNC = 0,       // FIFO, presentation paces the loop
+    PRESENT_POLICY_LOW_LATENCY,     // MAILBOX when available, paced to the target frame rate
+    PRESENT_POLICY_UNCAPPED         // MAILBOX or IMMEDIATE when available, never paced
+}; typedef PresentPolicy_t PresentPolicy;
+
+
+class FramePacer {
+public:
+    static constexpr double SLEEP_QUANTUM_SECONDS = 0.001;
+    // Frame intervals kept for the statistics, the counters are exported once per window
+    static constexpr uint32_t INTERVAL_HISTORY = 240;
+
+
+    struct Stats_t {
+        double targetMs = 0.0;
+        double meanMs = 0.0;
+        double jitterMs = 0.0;          // Standard deviation of the frame interval
+        double minMs = 0.0;
+        double maxMs = 0.0;
+        double p99Ms = 0.0;
+        double sleepOvershootMs = 0.0;  // Current estimate, the spin covers it
+        uint64_t frames = 0;
+        uint64_t missedDeadlines = 0;
+    }; typedef Stats_t Stats;
+
+
+    FramePacer();
+
+    void init(Profiler* pProfiler);
+    // 0 turns pacing off, frame intervals are still measured
+    void set_target_rate(double framesPerSecond);
+    double get_target_rate() const { return mTargetRate; }
+
+    // Once per frame, returns at the next frame deadline
+    void wait();
+
+    Stats get_stats() const;
+    void print_stats(std::ostream& out) const;
+
+private:
+    Profiler* mpProfiler = nullptr;
+    double mTargetRate = 0.0;
+    double mDeadlineSeconds = 0.0;
+    double mLastReturnSeconds = 0.0;
+
+    // Running mean and variance of one sleep quantum's actual duration
+    double mSleepMean = SLEEP_QUANTUM_SECONDS;
+    double mSleepVariance = 0.0;
+    uint64_t mSleepCount = 1;
+    double mSleepEstimate = SLEEP_QUANTUM_SECONDS;
+
+    std::vector<double> mIntervals;
+    uint32_t mNextInterval = 0;
+    uint64_t mFrames = 0;
+    uint64_t mMissedDeadlines = 0;
+
+    void sleep_until(double deadlineSeconds);
+    void record_interval(double seconds);
+    void export_counters() const;
+    static double now_seconds();
+};
+
+#endif // FRAME_PACER_H
@@ -10,11 +10,32 @@
 #define GAME_H
 
 #include <optional>
+#include <string>
 #include <vector>
 
 #define GLFW_INCLUDE_VULKAN
 #include <GLFW/glfw3.h>
 
+#include "DeletionQueue.h"
+#include "DepthPyramid.h"
+#include "DescriptorAllocator.h"
+#include "DeviceFeatures.h"
+#include "EntityWorld.h"
+#include "FixedTimestep.h"
+#include "FramePacer.h"
+#include "GpuResources.h"
+#include "InstancedRenderer.h"
+#include "JobSystem.h"
+#include "MeshletRenderer.h"
+#include "Profiler.h"
+#include "SceneComponents.h"
+#include "StagingRing.h"
+#include "SystemScheduler.h"
+#include "TextureStreamer.h"
+#include "TimelineSync.h"
+#include "TransformHierarchy.h"
+#include "TransformKernels.h"
+
 #define DEBUG
 
 #ifdef DEBUG
@@ -29,12 +50,38 @@ public:
     int mWindowWidth = 800;
     int mWindowHeight = 600;
     
+    static const uint32_t MAX_FRAMES_IN_FLIGHT = 2;
+    // Number of cubes in the demo scene
+    uint32_t mDemoInstanceCount = 100000;
+    // Number of meshlet spheres in the demo scene
+    uint32_t mDemoMeshletObjectCount = 1024;
+    // Length of a simulation step, independent of the frame rate
+    double mSimulationStepSeconds = 1.0 / 60.0;
+    // Step the simulation on its own thread instead of at the start of each frame
+    bool mThreadedSimulation = false;
+    // Picks the present mode and whether the frame pacer caps the frame rate
+    PresentPolicy mPresentPolicy = PRESENT_POLICY_LOW_LATENCY;
+    // Frame rate the pacer holds when presentation doesn't, 0 follows the monitor
+    double mTargetFrameRate = 0.0;
+    // Write the system schedules as Graphviz files to the working directory at startup
+    bool mWriteScheduleGraphs = false;
+    // Capture a few frames once the scene settled and write them to juniper_trace.json
+    bool mWriteTrace = false;
+    // Cooked KTX2 textures streamed at the resolution of the screen, within the budget
+    std::vector<std::string> mStreamedTexturePaths;
+    uint64_t mTextureBudgetBytes = 256ull << 20;
+    
     
     struct QueueFamilyIndices_t {
         bool foundGraphicsFamily = false;
         bool foundPresentFamily = false;
+        bool foundComputeFamily = false;
+        bool foundTransferFamily = false;
         uint32_t graphicsFamily;
         uint32_t presentFamily;
+        // Dedicated families when the device has them, otherwise the graphics family
+        uint32_t computeFamily;
+        uint32_t transferFamily;
         bool is_complete() {
             return foundGraphicsFamily && foundPresentFamily;
         }
@@ -59,17 +106,73 @@ private:
     
     GLFWwindow* mpWindow;
     VkInstance mVulkanInstance;
+    uint32_t mInstanceApiVersion = VK_API_VERSION_1_0;
     VkDebugUtilsMessengerEXT mVulkanDebugMessenger;
     VkPhysicalDevice mPhysicalDevice = VK_NULL_HANDLE;
     VkDevice mDevice;
+    DeviceFeatures mDeviceFeatures;
     VkQueue mGraphicsQueue;
     VkSurfaceKHR mWindowSurface;
     VkQueue mPresentQueue;
+    VkQueue mComputeQueue;
+    VkQueue mTransferQueue;
+    TimelineSync mTimelineSync;
+    DeletionQueue mDeletionQueue;
+    GpuResources mGpuResources;
+    StagingRing mStagingRing;
+    TextureStreamer mTextureStreamer;
+    std::vector<StreamedTextureHandle> mStreamedTextures;
     VkSwapchainKHR mSwapchain;
-    std::vector<VkImage> mSwapchainImages;
+    // Swapchain images and their views live in mGpuResources
+    std::vector<ImageHandle> mSwapchainImages;
     VkFormat mSwapchainImageFormat;
     VkExtent2D mSwapchainExtent;
-    std::vector<VkImageView> mSwapchainImageViews;
+    DescriptorAllocator mDescriptorAllocator;
+    ImageHandle mDepthImage;
+    VkFormat mDepthFormat;
+    VkRenderPass mRenderPass;
+    VkRenderPass mLateRenderPass;
+    PipelineHandle mInstancedPipeline;
+    PipelineHandle mMeshletPipeline;
+    std::vector<VkFramebuffer> mSwapchainFramebuffers;
+    std::vector<VkCommandPool> mCommandPools;
+    std::vector<VkCommandBuffer> mCommandBuffers;
+    std::vector<VkSemaphore> mImageAvailableSemaphores;
+    // Indexed by swapchain image, presentation may hold on to it past the frame slot
+    std::vector<VkSemaphore> mRenderFinishedSemaphores;
+    // Graphics timeline value that retires each frame slot
+    std::vector<uint64_t> mFrameTimelineValues;
+    uint32_t mCurrentFrame = 0;
+    uint64_t mFrameCount = 0;
+    InstancedRenderer mInstancedRenderer;
+    DepthPyramid mDepthPyramid;
+    MeshletRenderer mMeshletRenderer;
+    MeshHandle mCubeMesh;
+    MeshHandle mLodSphereMesh;
+    MaterialHandle mCubeMaterial;
+    MeshletMeshHandle mSphereMesh;
+    EntityWorld mWorld;
+    JobSystem mJobSystem;
+    Profiler mProfiler;
+    FixedTimestep mTimestep;
+    FramePacer mFramePacer;
+    // Runs every simulation step
+    SystemScheduler mSimulationScheduler;
+    // Runs every frame
+    SystemScheduler mScheduler;
+    TransformHierarchy mHierarchy;
+    TransformNode mSphereFieldNode;
+    // Simulation state of the sphere field, the frame blends the two
+    float mSphereFieldAngle = 0.0f;
+    float mPreviousSphereFieldAngle = 0.0f;
+    // Blend between the previous and current simulation state for this frame
+    float mInterpolationAlpha = 0.0f;
+    double mSceneTime = 0.0;
+    QueryId mInstancedQuery = 0;
+    QueryId mMeshletQuery = 0;
+    // Transforms of the instanced entities, composed into world matrices by the batch kernels
+    TransformSoA mCubeTransforms;
+    std::vector<glm::mat4> mCubeMatrices;
     
     std::vector<const char*> mValidationLayers = { "VK_LAYER_KHRONOS_validation" };
     const bool mEnableValidationLayers = DEBUG_ON;
@@ -85,6 +188,7 @@ private:
     SwapChainSupportDetails query_swap_chain_support(VkPhysicalDevice device);
     VkSurfaceFormatKHR choose_swap_surface_format(const std::vector<VkSurfaceFormatKHR>& availableFormats);
     VkPresentModeKHR choose_swap_present_mode(const std::vector<VkPresentModeKHR>& availablePresentModes);
+    double get_target_frame_rate();
     VkExtent2D choose_swap_extent(const VkSurfaceCapabilitiesKHR& capabilities);
     void create_swap_chain();
     void pick_physical_device();
@@ -93,9 +197,30 @@ private:
     bool check_device_extension_support(VkPhysicalDevice device);
     void create_logical_device();
     void create_image_views();
+    void create_timeline_sync();
+    void create_gpu_resources();
+    void create_texture_streamer();
+    void create_descriptor_allocator();
+    void create_instanced_renderer();
+    void create_meshlet_renderer();
+    VkFormat find_depth_format();
+    void create_depth_resources();
+    void create_depth_pyramid();
+    void create_render_pass();
+    void create_graphics_pipeline();
+    PipelineHandle create_scene_pipeline(const char* shaderName, VkShaderStageFlagBits stage, VkPipelineLayout layout,
+                                         VertexFormat vertexFormat);
+    void create_framebuffers();
+    void create_command_pools();
+    void create_sync_objects();
+    void create_scene();
+    void create_systems();
+    void update_scene();
+    void draw_frame();
     void main_loop();
     void clean_up();
     
+    
     static VKAPI_ATTR VkBool32 VKAPI_CALL
     vulkan_debug_callback(VkDebugUtilsMessageSeverityFlagBitsEXT messgaeSeverity,
                           VkDebugUtilsMessageTypeFlagsEXT messageType,
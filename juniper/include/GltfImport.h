@@ -0,0 +1,98 @@
+//======================================================================
+// GltfImport.h
+//
+// Keegan Kochis
+// Created: 2026/10/18
+// The declaration of the GltfImporter class.
+// Reads glTF 2.0 files, .gltf with external or embedded buffers and
+// binary .glb, for the offline cooker. Opening parses the document and
+// maps the buffers. After that the primitives can be hashed and
+// imported from any number of threads at once, each straight out of
+// the mapped buffers. Points and lines primitives are skipped, strips
+// and fans become lists. Only the default scene's nodes are imported.
+//======================================================================
+
+#ifndef GLTF_IMPORT_H
+#define GLTF_IMPORT_H
+
+#include <cstdint>
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "Json.h"
+#include "MappedFile.h"
+#include "Mesh.h"
+#include "SceneFile.h"
+
+class GltfImporter {
+public:
+    // Bumped whenever the importer's output changes for the same input, so the cooker redoes
+    // everything imported before
+    static constexpr uint32_t VERSION = 1;
+
+
+    GltfImporter();
+    ~GltfImporter();
+    GltfImporter(const GltfImporter&) = delete;
+    GltfImporter& operator=(const GltfImporter&) = delete;
+
+    // Throws if the file is malformed or needs an extension the importer lacks
+    void open(const std::string& path);
+    void close();
+
+    // The external buffer files, which are read besides the file itself
+    std::vector<std::string> get_buffer_paths() const;
+
+    // Triangle primitives of every mesh in mesh order
+    uint32_t get_primitive_count() const { return static_cast<uint32_t>(mPrimitives.size()); }
+    // Covers everything the primitive's mesh is imported from, reading no more than that
+    uint64_t hash_primitive(uint32_t index) const;
+    MeshData import_primitive(uint32_t index) const;
+
+    // Covers the document and the skin and animation data
+    uint64_t hash_scene() const;
+    // Primitive i refers to meshFiles[i]
+    SceneData import_scene(const std::vector<std::string>& meshFiles) const;
+
+private:
+    // Where an accessor's elements are, pData is null for accessors without a buffer view,
+    // whose elements are all zero
+    struct Accessor_t {
+        const uint8_t* pData;
+        uint32_t count;
+        uint32_t componentType;
+        uint32_t componentCount;
+        uint32_t elementBytes;
+        uint32_t stride;
+        bool normalized;
+    }; typedef Accessor_t Accessor;
+
+    struct Primitive_t {
+        uint32_t mesh;
+        uint32_t primitive;
+    }; typedef Primitive_t Primitive;
+
+    std::string mPath;
+    std::string mDirectory;
+    JsonValue mDocument;
+    uint64_t mDocumentHash = 0;
+    MappedFile mFile;
+    std::vector<std::unique_ptr<MappedFile>> mBufferFiles;
+    std::vector<std::vector<uint8_t>> mDecodedBuffers;
+    std::vector<const uint8_t*> mBuffers;
+    std::vector<uint64_t> mBufferBytes;
+    std::vector<Primitive> mPrimitives;
+
+    void load_buffers(const uint8_t* pBinaryChunk, uint64_t binaryChunkBytes);
+    Accessor get_accessor(uint32_t index) const;
+    uint64_t hash_accessor(uint32_t index, uint64_t hash) const;
+    // Converts normalized integers to floats, returns componentCount floats per element
+    std::vector<float> read_floats(const Accessor& accessor) const;
+    std::vector<uint32_t> read_indices(const Accessor& accessor) const;
+    uint32_t add_texture(SceneData& scene, const JsonValue& textureInfo) const;
+    void fail(const std::string& reason) const;
+};
+
+#endif // GLTF_IMPORT_H
@@ -0,0 +1,100 @@
+//======================================================================
+// GpuResources.h
+//
+// Keegan Kochis
+// Created: 2026/10/18
+// The declaration of the GpuResources class.
+// Owns the Vulkan buffers, images, samplers and pipelines of the engine
+// in handle indexed pools. Everything outside refers to resources by
+// 32 bit handle, which is cheap to store in per-draw data.
+//======================================================================
+
+#ifndef GPU_RESOURCES_H
+#define GPU_RESOURCES_H
+
+#include <cstdint>
+
+#define GLFW_INCLUDE_VULKAN
+#include <GLFW/glfw3.h>
+
+#include "DeletionQueue.h"
+#include "ResourcePool.h"
+
+struct BufferTag {};
+struct ImageTag {};
+struct SamplerTag {};
+struct PipelineTag {};
+
+typedef Handle<BufferTag> BufferHandle;
+typedef Handle<ImageTag> ImageHandle;
+typedef Handle<SamplerTag> SamplerHandle;
+typedef Handle<PipelineTag> PipelineHandle;
+
+class GpuResources {
+public:
+    // Column order of each pool, used with ResourcePool::get and ResourcePool::column
+    enum BufferColumn_t { BUFFER_BUFFER = 0, BUFFER_MEMORY, BUFFER_SIZE, BUFFER_USAGE, BUFFER_MAPPED };
+    enum ImageColumn_t { IMAGE_IMAGE = 0, IMAGE_VIEW, IMAGE_MEMORY, IMAGE_FORMAT, IMAGE_EXTENT, IMAGE_OWNED };
+    enum SamplerColumn_t { SAMPLER_SAMPLER = 0 };
+    enum PipelineColumn_t { PIPELINE_PIPELINE = 0, PIPELINE_LAYOUT, PIPELINE_BIND_POINT, PIPELINE_OWNS_LAYOUT };
+
+    // BUFFER_MAPPED is the persistent mapping of host visible buffers, null otherwise
+    typedef ResourcePool<BufferTag, VkBuffer, VkDeviceMemory, VkDeviceSize, VkBufferUsageFlags, void*> BufferPool;
+    // IMAGE_OWNED is 0 for images owned elsewhere, e.g. by the swapchain, whose VkImage is never destroyed here
+    typedef ResourcePool<ImageTag, VkImage, VkImageView, VkDeviceMemory, VkFormat, VkExtent3D, uint8_t> ImagePool;
+    typedef ResourcePool<SamplerTag, VkSampler> SamplerPool;
+    // PIPELINE_OWNS_LAYOUT is 0 when the layout is shared with other pipelines and destroyed by its creator
+    typedef ResourcePool<PipelineTag, VkPipeline, VkPipelineLayout, VkPipelineBindPoint, uint8_t> PipelinePool;
+
+    GpuResources();
+
+    void init(VkPhysicalDevice physicalDevice, VkDevice device, DeletionQueue* pDeletionQueue);
+    // Hands every remaining resource to the deletion queue
+    void clean_up();
+
+    // Host visible buffers are mapped for their whole lifetime
+    BufferHandle create_buffer(VkDeviceSize size, VkBufferUsageFlags usage, VkMemoryPropertyFlags properties);
+    // The image's view covers every mip level
+    ImageHandle create_image(VkExtent3D extent, VkFormat format, VkImageUsageFlags usage, VkImageAspectFlags aspect,
+                             uint32_t mipLevels);
+
+    BufferHandle add_buffer(VkBuffer buffer, VkDeviceMemory memory, VkDeviceSize size, VkBufferUsageFlags usage, void* pMapped);
+    ImageHandle add_image(VkImage image, VkImageView view, VkDeviceMemory memory, VkFormat format, VkExtent3D extent, bool owned);
+    SamplerHandle add_sampler(VkSampler sampler);
+    PipelineHandle add_pipeline(VkPipeline pipeline, VkPipelineLayout layout, VkPipelineBindPoint bindPoint, bool ownsLayout);
+
+    // Destruction is deferred until the GPU has retired all work submitted so far
+    void destroy_buffer(BufferHandle handle);
+    void destroy_image(ImageHandle handle);
+    void destroy_sampler(SamplerHandle handle);
+    void destroy_pipeline(PipelineHandle handle);
+
+    VkBuffer get_buffer(BufferHandle handle) const { return mBuffers.get<BUFFER_BUFFER>(handle); }
+    VkDeviceSize get_buffer_size(BufferHandle handle) const { return mBuffers.get<BUFFER_SIZE>(handle); }
+    void* get_mapped(BufferHandle handle) const { return mBuffers.get<BUFFER_MAPPED>(handle); }
+    VkImage get_image(ImageHandle handle) const { return mImages.get<IMAGE_IMAGE>(handle); }
+    VkImageView get_image_view(ImageHandle handle) const { return mImages.get<IMAGE_VIEW>(handle); }
+    VkSampler get_sampler(SamplerHandle handle) const { return mSamplers.get<SAMPLER_SAMPLER>(handle); }
+    VkPipeline get_pipeline(PipelineHandle handle) const { return mPipelines.get<PIPELINE_PIPELINE>(handle); }
+    VkPipelineLayout get_pipeline_layout(PipelineHandle handle) const { return mPipelines.get<PIPELINE_LAYOUT>(handle); }
+
+    BufferPool& buffers() { return mBuffers; }
+    ImagePool& images() { return mImages; }
+    SamplerPool& samplers() { return mSamplers; }
+    PipelinePool& pipelines() { return mPipelines; }
+
+private:
+    VkPhysicalDevice mPhysicalDevice = VK_NULL_HANDLE;
+    VkDevice mDevice = VK_NULL_HANDLE;
+    VkPhysicalDeviceMemoryProperties mMemoryProperties{};
+    DeletionQueue* mpDeletionQueue = nullptr;
+    BufferPool mBuffers;
+    ImagePool mImages;
+    SamplerPool mSamplers;
+    PipelinePool mPipelines;
+
+    uint32_t find_memory_type(uint32_t typeFilter, VkMemoryPropertyFlags properties);
+    VkDeviceMemory allocate_memory(const VkMemoryRequirements& requirements, VkMemoryPropertyFlags properties);
+};
+
+#endif // GPU_RESOURCES_H
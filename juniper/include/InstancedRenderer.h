@@ -0,0 +1,310 @@
+//======================================================================
+// InstancedRenderer.h
+//
+// Keegan Kochis
+// Created: 2026/10/18
+// The declaration of the InstancedRenderer class.
+// Objects submitted during a frame are grouped into batches by material
+// and mesh. Every mesh lives in one shared vertex and index buffer so a
+// whole material can be drawn from an array of indexed indirect
+// commands. On GPU driven devices a compute pass frustum culls every
+// object, compacts the survivors per batch and writes those commands,
+// otherwise the CPU culls and draws each batch directly.
+// With a depth pyramid the GPU driven path also culls occluded objects
+// in two phases. The early phase draws what was visible last frame, the
+// pyramid is built from that depth and the late phase tests everything
+// against it, drawing only the objects that just became visible.
+// Meshes may have coarser levels of detail. Each object draws the
+// coarsest level whose error projects under a pixel threshold, picked
+// next to culling on the GPU or in the CPU path's batch kernels.
+//======================================================================
+
+#ifndef INSTANCED_RENDERER_H
+#define INSTANCED_RENDERER_H
+
+#include <cstdint>
+
+#include <ostream>
+#include <unordered_map>
+#include <vector>
+
+#define GLFW_INCLUDE_VULKAN
+#include <GLFW/glfw3.h>
+
+#define GLM_FORCE_RADIANS
+#define GLM_FORCE_DEPTH_ZERO_TO_ONE
+#include <glm/mat4x4.hpp>
+#include <glm/vec2.hpp>
+#include <glm/vec4.hpp>
+
+#include "DepthPyramid.h"
+#include "DescriptorAllocator.h"
+#include "DeviceFeatures.h"
+#include "GpuResources.h"
+#include "Mesh.h"
+#include "TransformKernels.h"
+
+struct MeshTag {};
+struct MaterialTag {};
+
+typedef Handle<MeshTag> MeshHandle;
+typedef Handle<MaterialTag> MaterialHandle;
+
+class InstancedRenderer {
+public:
+    // Must match culling.glsl
+    static constexpr uint32_t MAX_LOD_COUNT = 8;
+    // A coarser level is only picked once its error is this fraction under the threshold, so
+    // objects around a switching distance don't alternate between levels
+    static constexpr float LOD_HYSTERESIS = 0.25f;
+
+
+    enum CullPhase_t {
+        CULL_PHASE_EARLY = 0,
+        CULL_PHASE_LATE,
+        CULL_PHASE_COUNT
+    }; typedef CullPhase_t CullPhase;
+
+
+    // std430 layout of one submitted object
+    struct ObjectData_t {
+        glm::mat4 transform;
+        uint32_t batchIndex;
+        uint32_t padding[3];
+    }; typedef ObjectData_t ObjectData;
+
+
+    // std430 layout of one batch as read by the culling shaders. Every level of detail of a
+    // batch's mesh has its own entry, the levels are consecutive and objects point at level 0.
+    struct BatchData_t {
+        glm::vec4 boundingSphere;       // Mesh space center and radius
+        uint32_t indexCount;
+        uint32_t firstIndex;
+        int32_t vertexOffset;
+        uint32_t firstInstance;         // Start of the batch's range of visible instances
+        uint32_t drawSlot;              // Command slot when every batch gets a command
+        uint32_t materialSlot;          // Index of the material's draw count
+        uint32_t materialFirstDraw;     // First command slot of the material
+        uint32_t lodCount;
+        float lodError;                 // Relative to the bounding sphere's radius
+        uint32_t padding[3];
+    }; typedef BatchData_t BatchData;
+
+
+    struct PushConstants_t {
+        glm::mat4 viewProjection;
+    }; typedef PushConstants_t PushConstants;
+
+
+    // std140 layout of the culling passes' uniform buffer
+    struct CullUniforms_t {
+        glm::mat4 viewProjection;
+        glm::vec4 frustumPlanes[6];     // Normal in xyz, distance in w, pointing inwards
+        glm::vec4 depthPlane;           // The w row of the view projection
+        glm::vec2 pyramidSize;
+        uint32_t objectCount;
+        uint32_t batchCount;
+        uint32_t useDrawCount;
+        uint32_t occlusionCulling;
+        float lodProjectionScale;       // Zero always draws level 0
+        float lodThreshold;             // In pixels
+    }; typedef CullUniforms_t CullUniforms;
+
+
+    // Counters written by the culling passes
+    struct CullCounters_t {
+        uint32_t frustumCulled;
+        uint32_t occlusionCulled;
+        uint32_t drawnEarly;
+        uint32_t drawnLate;
+        uint32_t lodDrawn[MAX_LOD_COUNT];
+    }; typedef CullCounters_t CullCounters;
+
+
+    struct Stats_t {
+        bool gpuDriven = false;
+        SimdLevel simdLevel = SIMD_LEVEL_SCALAR;
+        uint32_t instances = 0;
+        uint32_t visibleInstances = 0;
+        // Read back from the GPU driven path once the frame retired, so a few frames old
+        uint32_t frustumCulled = 0;
+        uint32_t occlusionCulled = 0;
+        uint32_t drawnEarly = 0;
+        uint32_t drawnLate = 0;
+        uint32_t lodDrawn[MAX_LOD_COUNT] = {};     // Drawn instances per level of detail
+        uint32_t batches = 0;           // One per level of detail of each mesh and material
+        uint32_t drawCalls = 0;
+        uint32_t pipelineBinds = 0;
+        double prepareMs = 0.0;         // Batching, culling and writing the frame's buffers
+        double recordMs = 0.0;          // Recording the culling dispatches and draw commands
+    }; typedef Stats_t Stats;
+
+
+    InstancedRenderer();
+
+    void init(VkDevice device, const DeviceFeatures::Capabilities& capabilities, uint32_t framesInFlight,
+              GpuResources* pGpuResources, DescriptorAllocator* pDescriptorAllocator);
+    void clean_up();
+
+    // Vertex and index data are appended to the shared geometry buffers
+    MeshHandle add_mesh(const MeshData& meshData);
+    // Copies the streams straight into the geometry buffers, e.g. out of a mapped mesh file.
+    // Quantized meshes must be drawn with materials whose pipeline takes quantized vertices.
+    MeshHandle add_mesh(const MeshView& meshView);
+    // Levels of detail finest first, all sharing the vertices of the first, see get_lod_view
+    MeshHandle add_mesh(const std::vector<MeshView>& lods);
+    // Pipelines must be created with get_pipeline_layout()
+    MaterialHandle add_material(PipelineHandle pipeline);
+
+    VkDescriptorSetLayout get_descriptor_set_layout() const { return mDescriptorSetLayout; }
+    VkPipelineLayout get_pipeline_layout() const { return mPipelineLayout; }
+    bool is_gpu_driven() const { return mGpuDriven; }
+    bool uses_occlusion_culling() const { return mGpuDriven && mpDepthPyramid != nullptr; }
+
+    // Enables occlusion culling on the GPU driven path. The pyramid must be built between
+    // the early and the late phase.
+    void set_depth_pyramid(DepthPyramid* pDepthPyramid) { mpDepthPyramid = pDepthPyramid; }
+    // Objects draw the coarsest level whose error projects to at most maxPixelError pixels.
+    // projectionScale is the pixels per unit at a depth of one, the projection's [1][1] times
+    // half the viewport height. Zero, the default, always draws level 0.
+    void set_lod_selection(float projectionScale, float maxPixelError);
+
+    void begin_frame(uint32_t frameIndex);
+    void submit(MeshHandle mesh, MaterialHandle material, const glm::mat4& transform);
+    // Assign batch ranges and fill the frame's buffers, culling on the CPU path
+    void prepare(const glm::mat4& viewProjection);
+    // GPU driven path only, records a phase's culling passes. Must be outside of a render pass.
+    void dispatch_culling(VkCommandBuffer commandBuffer, CullPhase phase);
+    // The CPU path draws everything in the early phase
+    void record(VkCommandBuffer commandBuffer, CullPhase phase);
+
+    const Stats& get_stats() const { return mStats; }
+    void print_stats(std::ostream& out) const;
+
+    // Normalized planes pointing inwards, in left, right, bottom, top, near, far order
+    static void extract_frustum_planes(const glm::mat4& viewProjection, glm::vec4 planes[6]);
+
+private:
+    struct MeshLod_t {
+        uint32_t firstIndex;
+        uint32_t indexCount;
+        float error;                    // Relative to the bounding sphere's radius, so scale free
+    }; typedef MeshLod_t MeshLod;
+
+    struct Mesh_t {
+        MeshLod lods[MAX_LOD_COUNT];
+        uint32_t lodCount;
+        int32_t vertexOffset;
+        // In the space of the vertices as stored, the quantization grid for quantized meshes
+        glm::vec4 boundingSphere;
+        // Applied to the object transforms of quantized meshes, from the grid to mesh space
+        bool quantized;
+        glm::mat4 dequantization;
+    }; typedef Mesh_t Mesh;
+
+    struct Material_t {
+        PipelineHandle pipeline;
+    }; typedef Material_t Material;
+
+    // Objects are counted on a batch's level 0
+    struct Batch_t {
+        MeshHandle mesh;
+        MaterialHandle material;
+        uint32_t lod;
+        uint32_t lodCount;
+        float lodError;
+        uint32_t objectCount;
+        uint32_t visibleCount;
+        uint32_t firstInstance;
+    }; typedef Batch_t Batch;
+
+    // Consecutive batches in material order which are drawn with one indirect call
+    struct MaterialRange_t {
+        MaterialHandle material;
+        uint32_t firstDraw;
+        uint32_t drawCount;
+    }; typedef MaterialRange_t MaterialRange;
+
+    // Written by one phase's culling passes and read by its draws
+    struct PhaseBuffers_t {
+        BufferHandle visibleInstances;
+        BufferHandle batchCounts;
+        BufferHandle drawCommands;
+        BufferHandle drawCounts;
+    }; typedef PhaseBuffers_t PhaseBuffers;
+
+    // Host visible buffers are written by prepare, device local ones by the culling passes
+    struct FrameBuffers_t {
+        BufferHandle objects;
+        BufferHandle batches;
+        BufferHandle cullUniforms;
+        BufferHandle cullCounters;
+        PhaseBuffers phases[CULL_PHASE_COUNT];
+    }; typedef FrameBuffers_t FrameBuffers;
+
+    VkDevice mDevice = VK_NULL_HANDLE;
+    GpuResources* mpGpuResources = nullptr;
+    DescriptorAllocator* mpDescriptorAllocator = nullptr;
+    VkDescriptorSetLayout mDescriptorSetLayout = VK_NULL_HANDLE;
+    VkPipelineLayout mPipelineLayout = VK_NULL_HANDLE;
+
+    bool mGpuDriven = false;
+    bool mUseDrawCount = false;
+    PFN_vkCmdDrawIndexedIndirectCountKHR mCmdDrawIndexedIndirectCount = nullptr;
+    VkDescriptorSetLayout mCullSetLayout = VK_NULL_HANDLE;
+    VkPipelineLayout mCullPipelineLayout = VK_NULL_HANDLE;
+    PipelineHandle mCullPipeline;
+    PipelineHandle mCullLatePipeline;
+    PipelineHandle mBuildDrawsPipeline;
+    DepthPyramid* mpDepthPyramid = nullptr;
+    // One entry per object, whether it passed culling last frame in bit 0 and its level of
+    // detail above. Objects are identified by their submission index, so a stable submission
+    // order keeps the history meaningful.
+    BufferHandle mObjectVisibility;
+    bool mClearObjectVisibility = true;
+
+    ResourcePool<MeshTag, Mesh> mMeshes;
+    ResourcePool<MaterialTag, Material> mMaterials;
+    BufferHandle mVertexBuffer;
+    BufferHandle mIndexBuffer;
+    uint32_t mVertexBytes = 0;
+    uint32_t mIndexCount = 0;
+
+    uint32_t mCurrentFrame = 0;
+    std::vector<FrameBuffers> mFrames;
+
+    std::vector<ObjectData> mObjects;
+    std::vector<Batch> mBatches;
+    std::unordered_map<uint64_t, uint32_t> mBatchLookup;
+    uint64_t mLastBatchKey = 0;
+    uint32_t mLastBatch = 0;
+    std::vector<uint32_t> mBatchOrder;
+    std::vector<MaterialRange> mMaterialRanges;
+    std::vector<uint8_t> mVisibility;
+    // Bounds of every object for the CPU path's culling kernels
+    SimdLevel mSimdLevel = SIMD_LEVEL_SCALAR;
+    SphereSoA mLocalSpheres;
+    SphereSoA mWorldSpheres;
+    glm::mat4 mViewProjection = glm::mat4(1.0f);
+    glm::vec4 mFrustumPlanes[6];
+    // The CPU path's levels of detail per object, kept for the hysteresis
+    std::vector<uint8_t> mObjectLods;
+    std::vector<float> mProjectedRadii;
+    float mLodProjectionScale = 0.0f;
+    float mLodThreshold = 1.0f;
+    uint32_t mMaxLodCount = 1;
+
+    Stats mStats;
+
+    uint32_t find_batch(MeshHandle mesh, MaterialHandle material);
+    // Returns the instances of every range together
+    uint32_t assign_batch_ranges(bool compactRanges);
+    void cull_on_cpu();
+    // Returns true when the buffer was replaced, its contents are then undefined
+    bool ensure_buffer(BufferHandle& buffer, VkDeviceSize size, VkBufferUsageFlags usage, VkMemoryPropertyFlags properties);
+    void write_storage_descriptors(VkDescriptorSet descriptorSet, const BufferHandle* pBuffers, uint32_t count);
+    void append_geometry(BufferHandle& buffer, uint32_t usedBytes, const void* pData, uint32_t dataBytes, VkBufferUsageFlags usage);
+    void create_culling_pipelines();
+};
+
+#endif // INSTANCED_RENDERER_H
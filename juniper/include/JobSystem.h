@@ -0,0 +1,78 @@
+//======================================================================
+// JobSystem.h
+//
+// Keegan Kochis
+// Created: 2026/10/18
+// The declaration of the JobSystem class.
+// A fixed pool of worker threads pulling jobs from a shared queue.
+// Jobs are grouped by a JobCounter that is waited on, and the waiting
+// thread runs queued jobs itself instead of blocking, so jobs may wait
+// on jobs they submitted without starving the pool.
+//======================================================================
+
+#ifndef JOB_SYSTEM_H
+#define JOB_SYSTEM_H
+
+#include <cstdint>
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+class JobSystem {
+public:
+    typedef std::function<void()> Job;
+
+
+    // Number of submitted jobs that haven't finished yet
+    struct JobCounter_t {
+        std::atomic<uint32_t> pending{0};
+    }; typedef JobCounter_t JobCounter;
+
+
+    JobSystem();
+    ~JobSystem();
+    JobSystem(const JobSystem&) = delete;
+    JobSystem& operator=(const JobSystem&) = delete;
+
+    // A worker count of 0 uses one worker per hardware thread besides the calling one
+    void init(uint32_t workerCount);
+    // Waits for the queued jobs to finish
+    void clean_up();
+
+    void submit(JobCounter& counter, Job job);
+    // Runs queued jobs until the counter reaches zero
+    void wait(JobCounter& counter);
+
+    // Splits [0, count) into ranges of at most batchSize and calls function(begin, end) on
+    // each, the calling thread included. Returns once every range is done.
+    void parallel_for(uint32_t count, uint32_t batchSize, const std::function<void(uint32_t, uint32_t)>& function);
+
+    uint32_t get_worker_count() const { return static_cast<uint32_t>(mWorkers.size()); }
+    // Workers and the thread that called init, for per-thread data
+    uint32_t get_thread_count() const { return get_worker_count() + 1; }
+    // 0 on the thread that called init and any other non-worker thread, 1 to worker count on workers
+    static uint32_t get_thread_index();
+
+private:
+    struct QueuedJob_t {
+        Job job;
+        JobCounter* pCounter;
+    }; typedef QueuedJob_t QueuedJob;
+
+    std::vector<std::thread> mWorkers;
+    std::deque<QueuedJob> mQueue;
+    std::mutex mMutex;
+    std::condition_variable mJobAvailable;
+    bool mStopping = false;
+
+    void worker_main(uint32_t threadIndex);
+    bool try_run_one();
+    static void run(QueuedJob& queuedJob);
+};
+
+#endif // JOB_SYSTEM_H
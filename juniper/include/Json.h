@@ -0,0 +1,77 @@
+//======================================================================
+// Json.h
+//
+// Keegan Kochis
+// Created: 2026/10/18
+// The declaration of the JsonValue class.
+// A small JSON document model for the offline importers. Lookups of
+// missing members or elements return a null value instead of throwing,
+// so optional properties read as their fallback.
+//======================================================================
+
+#ifndef JSON_H
+#define JSON_H
+
+#include <cstddef>
+#include <cstdint>
+
+#include <string>
+#include <utility>
+#include <vector>
+
+class JsonValue {
+public:
+    enum Type_t {
+        TYPE_NULL = 0,
+        TYPE_BOOL,
+        TYPE_NUMBER,
+        TYPE_STRING,
+        TYPE_ARRAY,
+        TYPE_OBJECT
+    }; typedef Type_t Type;
+
+
+    typedef std::pair<std::string, JsonValue> Member;
+
+
+    JsonValue();
+
+    // Throws with the line of the first syntax error
+    static JsonValue parse(const char* pText, size_t length);
+
+    Type get_type() const { return mType; }
+    bool is_null() const { return mType == TYPE_NULL; }
+    bool is_number() const { return mType == TYPE_NUMBER; }
+    bool is_string() const { return mType == TYPE_STRING; }
+    bool is_array() const { return mType == TYPE_ARRAY; }
+    bool is_object() const { return mType == TYPE_OBJECT; }
+
+    // Members are looked up in order, the objects of the importers are small
+    const JsonValue& operator[](const char* pKey) const;
+    const JsonValue& operator[](uint32_t index) const;
+    // Literal indices would be ambiguous with the member lookup otherwise
+    const JsonValue& operator[](int index) const { return (*this)[static_cast<uint32_t>(index)]; }
+    bool has(const char* pKey) const { return !(*this)[pKey].is_null(); }
+    // Elements of an array or members of an object, 0 otherwise
+    size_t size() const;
+
+    bool as_bool(bool fallback) const { return mType == TYPE_BOOL ? mBool : fallback; }
+    double as_number(double fallback) const { return mType == TYPE_NUMBER ? mNumber : fallback; }
+    float as_float(float fallback) const { return mType == TYPE_NUMBER ? static_cast<float>(mNumber) : fallback; }
+    uint32_t as_uint(uint32_t fallback) const;
+    // Empty when the value isn't a string
+    const std::string& as_string() const { return mString; }
+    const std::vector<Member>& get_members() const { return mMembers; }
+
+private:
+    Type mType = TYPE_NULL;
+    bool mBool = false;
+    double mNumber = 0.0;
+    std::string mString;
+    std::vector<JsonValue> mElements;
+    std::vector<Member> mMembers;
+
+    friend class JsonParser;
+};
+
+#endif // JSON_H
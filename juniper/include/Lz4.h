@@ -0,0 +1,27 @@
+//======================================================================
+// Lz4.h
+//
+// Keegan Kochis
+// Created: 2026/10/19
+// Compression in the LZ4 block format, for data that is decompressed
+// far more often than it is compressed. The compressor is the greedy
+// single hash table search LZ4 uses by default, the decompressor checks
+// every length and offset against both buffers, so corrupt input fails
+// instead of reading or writing out of bounds. Offsets are 16 bits,
+// matches reach at most 64 KB back.
+//======================================================================
+
+#ifndef LZ4_H
+#define LZ4_H
+
+#include <cstddef>
+#include <cstdint>
+
+// Largest compressed size of any input of that many bytes
+size_t lz4_compress_bound(size_t bytes);
+// Returns the compressed bytes, or 0 if they wouldn't fit the capacity
+size_t lz4_compress(const uint8_t* pSource, size_t bytes, uint8_t* pDestination, size_t capacity);
+// Returns false unless the input decompresses to exactly decompressedBytes
+bool lz4_decompress(const uint8_t* pSource, size_t bytes, uint8_t* pDestination, size_t decompressedBytes);
+
+#endif // LZ4_H
@@ -0,0 +1,53 @@
+//======================================================================
+// MappedFile.h
+//
+// Keegan Kochis
+// Created: 2026/10/18
+// The declaration of the MappedFile class.
+// A read only memory mapping of a whole file. Reading through the
+// mapping copies straight out of the page cache, so there is no read
+// buffer to allocate or fill before the data can be used.
+//======================================================================
+
+#ifndef MAPPED_FILE_H
+#define MAPPED_FILE_H
+
+#include <cstddef>
+#include <cstdint>
+
+#include <string>
+
+// A byte range of a file, as listed in the section tables of the cooked formats
+struct FileRange_t {
+    uint64_t offset;
+    uint64_t bytes;
+}; typedef FileRange_t FileRange;
+
+
+class MappedFile {
+public:
+    MappedFile();
+    ~MappedFile();
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    // Maps the whole file, closing whatever was mapped before
+    void open(const std::string& path);
+    void close();
+
+    bool is_open() const { return mpData != nullptr; }
+    const uint8_t* get_data() const { return mpData; }
+    size_t get_size() const { return mSize; }
+    const std::string& get_path() const { return mPath; }
+
+    // Whether the range lies within the file and starts on the alignment
+    bool contains(const FileRange& range, uint64_t alignment) const;
+    const uint8_t* get_range(const FileRange& range) const { return mpData + range.offset; }
+
+private:
+    const uint8_t* mpData = nullptr;
+    size_t mSize = 0;
+    std::string mPath;
+};
+
+#endif // MAPPED_FILE_H
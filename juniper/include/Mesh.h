@@ -0,0 +1,103 @@
+//======================================================================
+// Mesh.h
+//
+// Keegan Kochis
+// Created: 2026/10/18
+// Vertex layouts and CPU side mesh data.
+//======================================================================
+
+#ifndef MESH_H
+#define MESH_H
+
+#include <array>
+#include <cstdint>
+#include <vector>
+
+#define GLFW_INCLUDE_VULKAN
+#include <GLFW/glfw3.h>
+
+#define GLM_FORCE_RADIANS
+#define GLM_FORCE_DEPTH_ZERO_TO_ONE
+#include <glm/vec3.hpp>
+#include <glm/vec4.hpp>
+
+enum VertexFormat_t {
+    VERTEX_FORMAT_FLOAT = 0,        // Vertex
+    VERTEX_FORMAT_QUANTIZED,        // QuantizedVertex
+    VERTEX_FORMAT_COUNT
+}; typedef VertexFormat_t VertexFormat;
+
+
+struct Vertex_t {
+    glm::vec3 position;
+    glm::vec3 normal;
+
+    static VkVertexInputBindingDescription get_binding_description();
+    static std::array<VkVertexInputAttributeDescription, 2> get_attribute_descriptions();
+}; typedef Vertex_t Vertex;
+
+
+// Half the size of a Vertex. The position is a point of a 16 bit grid over the mesh's
+// bounds, the same scale on every axis, so the dequantization is a translation and a
+// uniform scale that fold into the object's transform. The normal is octahedral encoded.
+struct QuantizedVertex_t {
+    uint16_t position[4];           // Unorm, the fourth is padding
+    int16_t normal[2];              // Snorm
+
+    static VkVertexInputBindingDescription get_binding_description();
+    static std::array<VkVertexInputAttributeDescription, 2> get_attribute_descriptions();
+}; typedef QuantizedVertex_t QuantizedVertex;
+
+
+// A pipeline's vertex input state for a vertex format
+struct VertexInputDescription_t {
+    VkVertexInputBindingDescription binding;
+    std::array<VkVertexInputAttributeDescription, 2> attributes;
+}; typedef VertexInputDescription_t VertexInputDescription;
+
+
+VertexInputDescription get_vertex_input_description(VertexFormat format);
+uint32_t get_vertex_stride(VertexFormat format);
+
+
+// A mesh's streams without owning them, e.g. pointing into a mapped mesh file
+struct MeshView_t {
+    const void* pVertices;          // Of vertexFormat's vertex type
+    uint32_t vertexCount;
+    VertexFormat vertexFormat;
+    // Quantized positions are dequantized to xyz + w * position, float ones are (0, 0, 0, 1)
+    glm::vec4 dequantization;
+    const uint32_t* pIndices;
+    uint32_t indexCount;
+    glm::vec4 boundingSphere;       // Mesh space, also for quantized vertices
+    float lodError;                 // Mesh space deviation of the indices from level 0
+}; typedef MeshView_t MeshView;
+
+
+// A coarser level of detail, indexing a mesh's vertices
+struct MeshLodData_t {
+    std::vector<uint32_t> indices;
+    float error;
+}; typedef MeshLodData_t MeshLodData;
+
+
+struct MeshData_t {
+    std::vector<Vertex> vertices;
+    std::vector<uint32_t> indices;
+
+    // Center in xyz and radius in w, enclosing every vertex
+    glm::vec4 compute_bounding_sphere() const;
+    // Valid until the vertices or indices change
+    MeshView get_view() const;
+
+    // Unit cube centered on the origin with per-face normals
+    static MeshData_t make_cube();
+    // Sphere of diameter one centered on the origin with smooth normals
+    static MeshData_t make_sphere(uint32_t segments, uint32_t rings);
+}; typedef MeshData_t MeshData;
+
+
+// The view with the level's indices, valid as long as both are
+MeshView get_lod_view(const MeshView& view, const MeshLodData& lod);
+
+#endif // MESH_H
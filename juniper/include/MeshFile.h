@@ -0,0 +1,129 @@
+//======================================================================
+// MeshFile.h
+//
+// Keegan Kochis
+// Created: 2026/10/18
+// The declaration of the MeshFile class.
+// Cooked meshes in a binary container laid out exactly as the renderers
+// upload them. A fixed header with the bounds and a section table is
+// followed by the levels of detail, the vertices, every level's indices
+// and every level's meshlets, each section aligned for direct use. At
+// runtime the file is mapped and validated, then its streams are handed
+// to the renderers as views, so loading a mesh is one copy from the page
+// cache into the geometry buffers with no parsing or allocations. The
+// vertices are either Vertex or QuantizedVertex, chosen when cooking.
+// The format is little endian and versioned. Files of another version
+// are rejected rather than converted, recooking is cheap.
+//======================================================================
+
+#ifndef MESH_FILE_H
+#define MESH_FILE_H
+
+#include <cstdint>
+
+#include <string>
+#include <vector>
+
+#define GLM_FORCE_RADIANS
+#define GLM_FORCE_DEPTH_ZERO_TO_ONE
+#include <glm/vec4.hpp>
+
+#include "MappedFile.h"
+#include "Mesh.h"
+#include "Meshlet.h"
+
+enum MeshFileSection_t {
+    MESH_FILE_SECTION_LODS = 0,
+    MESH_FILE_SECTION_VERTICES,
+    MESH_FILE_SECTION_INDICES,
+    MESH_FILE_SECTION_MESHLETS,
+    MESH_FILE_SECTION_MESHLET_VERTICES,
+    MESH_FILE_SECTION_MESHLET_TRIANGLES,
+    MESH_FILE_SECTION_COUNT
+}; typedef MeshFileSection_t MeshFileSection;
+
+
+struct MeshFileHeader_t {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t vertexStride;          // Of the vertex format when cooked, a layout change needs a new version
+    uint32_t lodCount;
+    uint32_t vertexCount;
+    uint32_t indexCount;            // Every level's indices
+    uint32_t meshletCount;          // Every level's meshlets
+    uint32_t meshletVertexCount;
+    uint32_t meshletTriangleBytes;
+    uint32_t vertexFormat;          // VertexFormat
+    uint32_t padding[2];
+    glm::vec4 boundingSphere;       // Center in xyz and radius in w
+    glm::vec4 boundsMin;            // Bounding box corners in xyz
+    glm::vec4 boundsMax;
+    glm::vec4 dequantization;       // See MeshView
+    FileRange sections[MESH_FILE_SECTION_COUNT];     // Offsets are multiples of MeshFile::ALIGNMENT
+}; typedef MeshFileHeader_t MeshFileHeader;
+
+
+// One level of detail, all levels share the vertices. The meshlet offsets are relative to
+// the level's first meshlet vertex and triangle byte, so each level's ranges form a
+// complete MeshletView.
+struct MeshFileLod_t {
+    uint32_t firstIndex;
+    uint32_t indexCount;
+    uint32_t firstMeshlet;
+    uint32_t meshletCount;
+    uint32_t firstMeshletVertex;
+    uint32_t meshletVertexCount;
+    uint32_t firstMeshletTriangle;  // In bytes, a multiple of four
+    uint32_t meshletTriangleBytes;
+    float error;                    // Mesh space deviation from level 0
+    uint32_t padding[3];
+}; typedef MeshFileLod_t MeshFileLod;
+
+
+class MeshFile {
+public:
+    static constexpr uint32_t MAGIC = 0x48534D4A;   // "JMSH"
+    static constexpr uint32_t VERSION = 2;
+    // Covers the widest SIMD loads and a cache line, the mapping itself is page aligned
+    static constexpr uint64_t ALIGNMENT = 64;
+
+
+    MeshFile();
+    ~MeshFile();
+    MeshFile(const MeshFile&) = delete;
+    MeshFile& operator=(const MeshFile&) = delete;
+
+    // Maps and validates the file, throws if it's malformed or of another version
+    void open(const std::string& path);
+    void close();
+
+    bool is_open() const { return mpHeader != nullptr; }
+    const MeshFileHeader& get_header() const { return *mpHeader; }
+    uint32_t get_lod_count() const { return mpHeader->lodCount; }
+    const MeshFileLod& get_lod(uint32_t lod) const { return mpLods[lod]; }
+    size_t get_file_bytes() const { return mFile.get_size(); }
+
+    // Point into the mapping, valid until the file is closed
+    MeshView get_view(uint32_t lod) const;
+    MeshletView get_meshlet_view(uint32_t lod) const;
+
+    // Cooks the mesh as level 0 followed by the coarser levels, building each level's
+    // meshlets with the renderer's limits. The vertices are quantized for that format.
+    static void write(const std::string& path, const MeshData& mesh, const std::vector<MeshLodData>& coarserLods,
+                      VertexFormat vertexFormat);
+
+private:
+    MappedFile mFile;
+    const MeshFileHeader* mpHeader = nullptr;
+    const MeshFileLod* mpLods = nullptr;
+    const void* mpVertices = nullptr;
+    const uint32_t* mpIndices = nullptr;
+    const Meshlet* mpMeshlets = nullptr;
+    const uint32_t* mpMeshletVertices = nullptr;
+    const uint8_t* mpMeshletTriangles = nullptr;
+
+    void validate() const;
+    const void* get_section(MeshFileSection section) const;
+};
+
+#endif // MESH_FILE_H
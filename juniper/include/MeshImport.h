@@ -0,0 +1,22 @@
+//======================================================================
+// MeshImport.h
+//
+// Keegan Kochis
+// Created: 2026/10/18
+// Importers of source mesh formats for the offline cooker. Nothing at
+// runtime should parse these, they are cooked into mesh files first.
+//======================================================================
+
+#ifndef MESH_IMPORT_H
+#define MESH_IMPORT_H
+
+#include <string>
+
+#include "Mesh.h"
+
+// Wavefront OBJ positions, normals and polygons, the polygons are triangulated as fans.
+// Vertices are shared between faces using the same position and normal, meshes without
+// normals get smooth ones.
+MeshData import_obj(const std::string& path);
+
+#endif // MESH_IMPORT_H
@@ -0,0 +1,69 @@
+//======================================================================
+// MeshOptimize.h
+//
+// Keegan Kochis
+// Created: 2026/10/18
+// Offline reordering of meshes for the GPU. Triangles are ordered for
+// the post-transform vertex cache, then clusters of them are sorted to
+// draw outward facing parts first and cut overdraw, and finally the
+// vertices are laid out in the order the triangles fetch them. The
+// analyze functions measure each step so the cooker can report them.
+//======================================================================
+
+#ifndef MESH_OPTIMIZE_H
+#define MESH_OPTIMIZE_H
+
+#include <cstdint>
+
+#include <vector>
+
+#include "Mesh.h"
+
+// Post-transform cache the analysis and overdraw clustering model, a FIFO as on most GPUs
+static const uint32_t VERTEX_CACHE_SIZE = 16;
+// How much the cache efficiency of a cluster may degrade to split it into smaller clusters
+// for the overdraw sort
+static const float OVERDRAW_THRESHOLD = 1.05f;
+
+struct VertexCacheStats_t {
+    uint32_t transformedVertices;
+    float acmr;                     // Transformed vertices per triangle, 0.5 at best and 3 at worst
+    float atvr;                     // Transformed vertices per referenced vertex, 1 at best
+}; typedef VertexCacheStats_t VertexCacheStats;
+
+
+struct VertexFetchStats_t {
+    uint64_t bytesFetched;
+    float overfetch;                // Bytes fetched per byte of referenced vertices, 1 at best
+}; typedef VertexFetchStats_t VertexFetchStats;
+
+
+struct OverdrawStats_t {
+    uint64_t pixelsCovered;
+    uint64_t pixelsShaded;
+    float overdraw;                 // Shaded per covered pixel with early depth testing, 1 at best
+}; typedef OverdrawStats_t OverdrawStats;
+
+
+// Every triangle is transformed once per vertex missing the FIFO cache
+VertexCacheStats analyze_vertex_cache(const std::vector<uint32_t>& indices, uint32_t vertexCount, uint32_t cacheSize);
+// Vertices missing the post-transform cache are fetched through a small cache of 64 byte lines
+VertexFetchStats analyze_vertex_fetch(const std::vector<uint32_t>& indices, uint32_t vertexCount, uint32_t vertexBytes);
+// Rasterizes the front faces from the six axis directions in index order
+OverdrawStats analyze_overdraw(const std::vector<uint32_t>& indices, const std::vector<Vertex>& vertices);
+
+// Forsyth's greedy reordering, scoring vertices by their position in a simulated LRU cache
+// and how many of their triangles are left
+void optimize_vertex_cache(std::vector<uint32_t>& indices, uint32_t vertexCount);
+// Expects a cache optimized order. Splits it where the cache restarts and wherever a
+// cluster already reaches threshold times the ACMR of the whole, then sorts the clusters
+// by how far they face out from the mesh's center.
+void optimize_overdraw(std::vector<uint32_t>& indices, const std::vector<Vertex>& vertices, float threshold);
+// Orders the vertices by first use and drops unreferenced ones. Returns the new index of
+// every old vertex, UINT32_MAX for dropped ones, to remap other index buffers of the mesh.
+std::vector<uint32_t> optimize_vertex_fetch(MeshData& mesh);
+
+// All three in order
+void optimize_mesh(MeshData& mesh);
+
+#endif // MESH_OPTIMIZE_H
@@ -0,0 +1,54 @@
+//======================================================================
+// MeshQuantize.h
+//
+// Keegan Kochis
+// Created: 2026/10/18
+// Quantization of meshes into the QuantizedVertex format for cooking,
+// and the error it introduces. Dequantizing is the inverse the vertex
+// shaders apply, so the measured error is what ends up on screen.
+//======================================================================
+
+#ifndef MESH_QUANTIZE_H
+#define MESH_QUANTIZE_H
+
+#include <cstdint>
+
+#include <vector>
+
+#define GLM_FORCE_RADIANS
+#define GLM_FORCE_DEPTH_ZERO_TO_ONE
+#include <glm/vec3.hpp>
+#include <glm/vec4.hpp>
+
+#include "Mesh.h"
+
+struct QuantizedMeshData_t {
+    std::vector<QuantizedVertex> vertices;
+    std::vector<uint32_t> indices;
+    glm::vec4 dequantization;       // Offset in xyz and scale in w, see MeshView
+    glm::vec4 boundingSphere;       // Of the source mesh
+
+    // Valid until the vertices or indices change
+    MeshView get_view() const;
+}; typedef QuantizedMeshData_t QuantizedMeshData;
+
+
+struct QuantizationError_t {
+    float maxPositionError;         // Mesh units
+    float meanPositionError;
+    float relativePositionError;    // The maximum over the largest extent of the bounds
+    float maxNormalDegrees;
+    float meanNormalDegrees;
+}; typedef QuantizationError_t QuantizationError;
+
+
+// Places the grid over the bounds of the vertices
+glm::vec4 compute_dequantization(const std::vector<Vertex>& vertices);
+// Picks the neighbouring octahedral code that decodes closest to the normal
+QuantizedVertex quantize_vertex(const Vertex& vertex, const glm::vec4& dequantization);
+Vertex dequantize_vertex(const QuantizedVertex& vertex, const glm::vec4& dequantization);
+
+QuantizedMeshData quantize_mesh(const MeshData& mesh);
+QuantizationError measure_quantization_error(const MeshData& mesh, const QuantizedMeshData& quantized);
+
+#endif // MESH_QUANTIZE_H
@@ -0,0 +1,42 @@
+//======================================================================
+// MeshSimplify.h
+//
+// Keegan Kochis
+// Created: 2026/10/18
+// Offline simplification of meshes into levels of detail. Edges are
+// collapsed in order of their quadric error, moving one vertex onto
+// its neighbour, so a simplified level only has new indices and shares
+// the vertices of the mesh. Borders and seams between vertices at the
+// same position only collapse along themselves, keeping the outline
+// and the attribute splits intact.
+//======================================================================
+
+#ifndef MESH_SIMPLIFY_H
+#define MESH_SIMPLIFY_H
+
+#include <cstdint>
+
+#include <vector>
+
+#include "Mesh.h"
+
+// Including level 0
+static const uint32_t LOD_MAX_COUNT = 8;
+// Each level aims for this fraction of the previous level's triangles
+static const float LOD_REDUCTION = 0.5f;
+// Levels stop once they would reach this error relative to the mesh's bounding sphere radius,
+// or once they keep more than LOD_MIN_REDUCTION of the previous level's triangles
+static const float LOD_MAX_ERROR = 0.05f;
+static const float LOD_MIN_REDUCTION = 0.85f;
+
+// Collapses edges until at most targetIndexCount indices are left or the next collapse would
+// pass targetError, a distance in mesh units. The error reached is written to pError.
+std::vector<uint32_t> simplify_mesh(const std::vector<uint32_t>& indices, const std::vector<Vertex>& vertices,
+                                    uint32_t targetIndexCount, float targetError, float* pError);
+
+// Coarser levels of the mesh for MeshFile::write and the renderers, each simplified from the
+// previous one and vertex cache optimized. The errors add up, bounding the deviation from
+// level 0.
+std::vector<MeshLodData> generate_lods(const MeshData& mesh);
+
+#endif // MESH_SIMPLIFY_H
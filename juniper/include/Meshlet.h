@@ -0,0 +1,70 @@
+//======================================================================
+// Meshlet.h
+//
+// Keegan Kochis
+// Created: 2026/10/18
+// Meshlets, small clusters of a mesh's triangles with a bounded number
+// of vertices and triangles. Each one carries a bounding sphere for
+// frustum culling and a normal cone for backface culling, so whole
+// clusters can be rejected before any of their vertices are shaded.
+//======================================================================
+
+#ifndef MESHLET_H
+#define MESHLET_H
+
+#include <cstdint>
+
+#include <vector>
+
+#define GLM_FORCE_RADIANS
+#define GLM_FORCE_DEPTH_ZERO_TO_ONE
+#include <glm/vec3.hpp>
+#include <glm/vec4.hpp>
+
+#include "Mesh.h"
+
+// Limits of the meshlets built for the renderer. 124 triangles keep the packed triangle
+// bytes of a full meshlet a multiple of four.
+static const uint32_t MESHLET_MAX_VERTICES = 64;
+static const uint32_t MESHLET_MAX_TRIANGLES = 124;
+
+struct Meshlet_t {
+    glm::vec4 boundingSphere;       // Mesh space center and radius
+    // Mesh space axis in xyz and the cutoff in w. The meshlet faces away from every camera
+    // for which dot(center - camera, axis) >= cutoff * length(center - camera) + radius.
+    // A cutoff of one never culls.
+    glm::vec4 cone;
+    uint32_t vertexOffset;          // First entry in MeshletData::vertices
+    uint32_t triangleOffset;        // First byte in MeshletData::triangles, a multiple of four
+    uint32_t vertexCount;
+    uint32_t triangleCount;
+}; typedef Meshlet_t Meshlet;
+
+
+// A mesh's meshlets without owning them, the offsets in the meshlets are relative to the
+// start of pVertices and pTriangles
+struct MeshletView_t {
+    const Meshlet* pMeshlets;
+    uint32_t meshletCount;
+    const uint32_t* pVertices;
+    uint32_t vertexCount;
+    const uint8_t* pTriangles;
+    uint32_t triangleBytes;
+}; typedef MeshletView_t MeshletView;
+
+
+struct MeshletData_t {
+    std::vector<Meshlet> meshlets;
+    // Indices into the mesh's vertices, referenced by the local indices below
+    std::vector<uint32_t> vertices;
+    // Three local vertex indices per triangle, each meshlet's range padded to four bytes
+    std::vector<uint8_t> triangles;
+
+    MeshletView get_view() const;
+
+    // Splits the mesh in index order, so the triangles should already be ordered for
+    // locality. Every meshlet is cut at maxVertices or maxTriangles, whichever comes first.
+    static MeshletData_t build(const MeshData& mesh, uint32_t maxVertices, uint32_t maxTriangles);
+}; typedef MeshletData_t MeshletData;
+
+#endif // MESHLET_H
@@ -0,0 +1,191 @@
+//======================================================================
+// MeshletRenderer.h
+//
+// Keegan Kochis
+// Created: 2026/10/18
+// The declaration of the MeshletRenderer class.
+// Draws dense meshes split into meshlets. A compute pass frustum and
+// backface culls every meshlet of every submitted object and compacts
+// the survivors into a visible cluster list. With mesh shaders one mesh
+// workgroup draws each visible cluster, otherwise every cluster gets an
+// indexed indirect command into a per-meshlet index buffer.
+//======================================================================
+
+#ifndef MESHLET_RENDERER_H
+#define MESHLET_RENDERER_H
+
+#include <cstdint>
+
+#include <ostream>
+#include <vector>
+
+#define GLFW_INCLUDE_VULKAN
+#include <GLFW/glfw3.h>
+
+#define GLM_FORCE_RADIANS
+#define GLM_FORCE_DEPTH_ZERO_TO_ONE
+#include <glm/mat4x4.hpp>
+#include <glm/vec3.hpp>
+#include <glm/vec4.hpp>
+
+#include "DescriptorAllocator.h"
+#include "DeviceFeatures.h"
+#include "GpuResources.h"
+#include "Mesh.h"
+#include "Meshlet.h"
+
+struct MeshletMeshTag {};
+
+typedef Handle<MeshletMeshTag> MeshletMeshHandle;
+
+class MeshletRenderer {
+public:
+    // std430 layout of one meshlet as read by the culling and mesh shaders
+    struct MeshletGpuData_t {
+        glm::vec4 boundingSphere;
+        glm::vec4 cone;
+        uint32_t vertexOffset;          // First entry in the meshlet vertex buffer
+        uint32_t triangleOffset;        // First word in the meshlet triangle buffer
+        uint32_t vertexCount;
+        uint32_t triangleCount;
+        uint32_t firstIndex;            // First index of the meshlet's triangles in the index buffer
+        uint32_t padding[3];
+    }; typedef MeshletGpuData_t MeshletGpuData;
+
+
+    // std430 layout of one submitted object
+    struct ObjectData_t {
+        glm::mat4 transform;
+        glm::vec4 boundingSphere;       // Mesh space bounds of the whole mesh
+        uint32_t firstMeshlet;
+        uint32_t meshletCount;
+        int32_t vertexOffset;           // Added to the meshlet's vertex indices
+        uint32_t padding;
+    }; typedef ObjectData_t ObjectData;
+
+
+    // Counters written by the culling pass. drawCount doubles as the indirect draw count.
+    struct ClusterCounters_t {
+        uint32_t drawCount;
+        uint32_t frustumCulled;
+        uint32_t backfaceCulled;
+        uint32_t padding;
+    }; typedef ClusterCounters_t ClusterCounters;
+
+
+    struct CullPushConstants_t {
+        glm::vec4 frustumPlanes[6];
+        glm::vec3 cameraPosition;
+        uint32_t objectCount;
+        uint32_t useMeshShaders;
+        uint32_t taskCommandCount;
+    }; typedef CullPushConstants_t CullPushConstants;
+
+
+    struct PushConstants_t {
+        glm::mat4 viewProjection;
+    }; typedef PushConstants_t PushConstants;
+
+
+    struct Stats_t {
+        bool meshShaders = false;
+        uint32_t objects = 0;
+        uint32_t meshlets = 0;
+        // Read back once the frame retired, so a few frames old
+        uint32_t visibleMeshlets = 0;
+        uint32_t frustumCulled = 0;
+        uint32_t backfaceCulled = 0;
+        double prepareMs = 0.0;
+    }; typedef Stats_t Stats;
+
+
+    MeshletRenderer();
+
+    // Needs multi draw indirect with a non-zero firstInstance, see is_supported
+    void init(VkDevice device, const DeviceFeatures::Capabilities& capabilities, uint32_t framesInFlight,
+              GpuResources* pGpuResources, DescriptorAllocator* pDescriptorAllocator);
+    void clean_up();
+
+    MeshletMeshHandle add_mesh(const MeshData& meshData, const MeshletData& meshletData);
+    // The streams are copied straight into the geometry buffers, only the meshlet records
+    // are rewritten on the way. The meshlet bounds and shaders expect float vertices.
+    MeshletMeshHandle add_mesh(const MeshView& meshView, const MeshletView& meshletView);
+
+    bool is_supported() const { return mSupported; }
+    bool uses_mesh_shaders() const { return mMeshShaders; }
+    // Pipelines take the mesh shader stage with uses_mesh_shaders and the vertex stage otherwise
+    VkPipelineLayout get_pipeline_layout() const { return mPipelineLayout; }
+    void set_pipeline(PipelineHandle pipeline) { mPipeline = pipeline; }
+
+    void begin_frame(uint32_t frameIndex);
+    void submit(MeshletMeshHandle mesh, const glm::mat4& transform);
+    void prepare(const glm::mat4& viewProjection, const glm::vec3& cameraPosition);
+    // Must be outside of a render pass
+    void dispatch_culling(VkCommandBuffer commandBuffer);
+    void record(VkCommandBuffer commandBuffer);
+
+    const Stats& get_stats() const { return mStats; }
+    void print_stats(std::ostream& out) const;
+
+private:
+    struct Mesh_t {
+        uint32_t firstMeshlet;
+        uint32_t meshletCount;
+        int32_t vertexOffset;
+        glm::vec4 boundingSphere;
+    }; typedef Mesh_t Mesh;
+
+    struct FrameBuffers_t {
+        BufferHandle objects;
+        BufferHandle visibleClusters;
+        BufferHandle drawCommands;
+        BufferHandle taskCommands;
+        BufferHandle counters;
+    }; typedef FrameBuffers_t FrameBuffers;
+
+    VkDevice mDevice = VK_NULL_HANDLE;
+    GpuResources* mpGpuResources = nullptr;
+    DescriptorAllocator* mpDescriptorAllocator = nullptr;
+    bool mSupported = false;
+    bool mMeshShaders = false;
+    bool mUseDrawCount = false;
+    PFN_vkCmdDrawIndexedIndirectCountKHR mCmdDrawIndexedIndirectCount = nullptr;
+    PFN_vkCmdDrawMeshTasksIndirectNV mCmdDrawMeshTasksIndirect = nullptr;
+
+    VkDescriptorSetLayout mDescriptorSetLayout = VK_NULL_HANDLE;
+    VkPipelineLayout mPipelineLayout = VK_NULL_HANDLE;
+    PipelineHandle mPipeline;
+    VkDescriptorSetLayout mCullSetLayout = VK_NULL_HANDLE;
+    VkPipelineLayout mCullPipelineLayout = VK_NULL_HANDLE;
+    PipelineHandle mCullPipeline;
+    PipelineHandle mBuildTasksPipeline;
+
+    ResourcePool<MeshletMeshTag, Mesh> mMeshes;
+    BufferHandle mVertexBuffer;
+    BufferHandle mIndexBuffer;
+    BufferHandle mMeshletBuffer;
+    BufferHandle mMeshletVertexBuffer;
+    BufferHandle mMeshletTriangleBuffer;
+    uint32_t mVertexCount = 0;
+    uint32_t mIndexCount = 0;
+    uint32_t mMeshletCount = 0;
+    uint32_t mMeshletVertexCount = 0;
+    uint32_t mMeshletTriangleWords = 0;
+
+    uint32_t mCurrentFrame = 0;
+    std::vector<FrameBuffers> mFrames;
+    std::vector<ObjectData> mObjects;
+    // Upper bound of the visible clusters, the meshlets of every submitted object
+    uint32_t mClusterCapacity = 0;
+    CullPushConstants mCullPushConstants{};
+    glm::mat4 mViewProjection = glm::mat4(1.0f);
+
+    Stats mStats;
+
+    void ensure_buffer(BufferHandle& buffer, VkDeviceSize size, VkBufferUsageFlags usage, VkMemoryPropertyFlags properties);
+    void append_geometry(BufferHandle& buffer, uint32_t usedBytes, const void* pData, uint32_t dataBytes, VkBufferUsageFlags usage);
+    void write_storage_descriptors(VkDescriptorSet descriptorSet, const std::vector<BufferHandle>& buffers);
+    void create_culling_pipelines();
+};
+
+#endif // MESHLET_RENDERER_H
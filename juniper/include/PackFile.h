@@ -0,0 +1,136 @@
+//======================================================================
+// PackFile.h
+//
+// Keegan Kochis
+// Created: 2026/10/19
+// The declaration of the PackFile class.
+// Many files packed into one archive, so loading them takes one open
+// and one mapping instead of an open and a stat per file. A fixed
+// header is followed by the entries sorted by the hash of their path,
+// the chunk table, the paths and then the data. An entry is either
+// stored as it is, aligned so it can be used straight from the mapping,
+// or LZ4 compressed in chunks of CHUNK_SIZE bytes that decompress
+// independently of each other, so one entry can be decompressed on
+// many threads and a part of it without the rest. The format is little
+// endian and versioned like the other cooked formats.
+//======================================================================
+
+#ifndef PACK_FILE_H
+#define PACK_FILE_H
+
+#include <cstdint>
+
+#include <string>
+#include <vector>
+
+#include "JobSystem.h"
+#include "MappedFile.h"
+
+enum PackCompression_t {
+    PACK_COMPRESSION_NONE = 0,
+    PACK_COMPRESSION_LZ4,
+    PACK_COMPRESSION_COUNT
+}; typedef PackCompression_t PackCompression;
+
+
+enum PackFileSection_t {
+    PACK_FILE_SECTION_ENTRIES = 0,
+    PACK_FILE_SECTION_CHUNKS,
+    PACK_FILE_SECTION_PATHS,
+    PACK_FILE_SECTION_COUNT
+}; typedef PackFileSection_t PackFileSection;
+
+
+struct PackFileHeader_t {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t entryCount;
+    uint32_t chunkCount;
+    uint32_t chunkSize;             // Uncompressed bytes of every chunk but an entry's last
+    uint32_t padding[3];
+    FileRange sections[PACK_FILE_SECTION_COUNT];
+}; typedef PackFileHeader_t PackFileHeader;
+
+
+struct PackFileEntry_t {
+    uint64_t pathHash;              // PackFile::hash_path of the path, the sort key
+    uint64_t bytes;                 // Uncompressed
+    uint64_t offset;                // Of the data when stored as it is, a multiple of PackFile::ALIGNMENT
+    uint32_t firstChunk;            // Compressed entries only
+    uint32_t chunkCount;
+    uint32_t pathOffset;            // Into the paths, null terminated
+    uint32_t compression;           // PackCompression
+}; typedef PackFileEntry_t PackFileEntry;
+
+
+// A chunk that didn't get smaller is stored as it is, with as many bytes as it decompresses to
+struct PackFileChunk_t {
+    uint64_t offset;
+    uint32_t storedBytes;
+    uint32_t padding;
+}; typedef PackFileChunk_t PackFileChunk;
+
+
+// A file to pack, read from the source path and found under the pack path
+struct PackInput_t {
+    std::string packPath;
+    std::string sourcePath;
+}; typedef PackInput_t PackInput;
+
+
+class PackFile {
+public:
+    static constexpr uint32_t MAGIC = 0x4B41504A;   // "JPAK"
+    static constexpr uint32_t VERSION = 1;
+    // Matches the cooked formats, whose sections have to stay aligned within the mapping
+    static constexpr uint64_t ALIGNMENT = 64;
+    static constexpr uint32_t CHUNK_SIZE = 64 * 1024;
+    static constexpr uint32_t INVALID_ENTRY = UINT32_MAX;
+
+
+    PackFile();
+    PackFile(const PackFile&) = delete;
+    PackFile& operator=(const PackFile&) = delete;
+
+    // Maps and validates the archive, throws if it's malformed or of another version
+    void open(const std::string& path);
+    void close();
+
+    bool is_open() const { return mpHeader != nullptr; }
+    const std::string& get_path() const { return mFile.get_path(); }
+    size_t get_file_bytes() const { return mFile.get_size(); }
+    uint32_t get_entry_count() const { return mpHeader->entryCount; }
+    const PackFileEntry& get_entry(uint32_t entry) const { return mpEntries[entry]; }
+    const char* get_entry_path(uint32_t entry) const { return mpPaths + mpEntries[entry].pathOffset; }
+
+    // Binary search of the sorted hashes, INVALID_ENTRY if the path isn't packed
+    uint32_t find(const std::string& path) const;
+    // Points into the mapping for entries stored as they are, null for compressed ones
+    const uint8_t* get_mapped(uint32_t entry) const;
+    // Decompresses one chunk to its place in pDestination, which holds the whole entry.
+    // Returns false if the chunk is corrupt, so it can run as a job.
+    bool read_chunk(uint32_t entry, uint32_t chunk, uint8_t* pDestination) const;
+    // The whole entry, the chunks spread over the job system when there is one. Throws if
+    // a chunk is corrupt.
+    void read(uint32_t entry, uint8_t* pDestination, JobSystem* pJobSystem) const;
+
+    // Lowercase forward slashes without a leading "./" or "/", what paths are hashed and stored as
+    static std::string normalize_path(const std::string& path);
+    static uint64_t hash_path(const std::string& normalizedPath);
+
+    // Compresses the inputs in parallel on the job system when there is one. Compressed
+    // entries that save less than an eighth are stored as they are.
+    static void write(const std::string& path, const std::vector<PackInput>& inputs, PackCompression compression,
+                      JobSystem* pJobSystem);
+
+private:
+    MappedFile mFile;
+    const PackFileHeader* mpHeader = nullptr;
+    const PackFileEntry* mpEntries = nullptr;
+    const PackFileChunk* mpChunks = nullptr;
+    const char* mpPaths = nullptr;
+
+    void validate() const;
+};
+
+#endif // PACK_FILE_H
@@ -0,0 +1,60 @@
+//======================================================================
+// Profiler.h
+//
+// Keegan Kochis
+// Created: 2026/10/18
+// The declaration of the Profiler class.
+// Collects timed events per thread while a capture is running and
+// writes them in the Chrome trace event format, which chrome://tracing
+// and Perfetto show as a timeline. Named counters keep their latest
+// value and are printed with the other stats.
+//======================================================================
+
+#ifndef PROFILER_H
+#define PROFILER_H
+
+#include <cstdint>
+
+#include <atomic>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <utility>
+#include <vector>
+
+class Profiler {
+public:
+    struct Event_t {
+        std::string name;
+        uint32_t threadIndex;
+        uint64_t startNs;
+        uint64_t endNs;
+    }; typedef Event_t Event;
+
+
+    Profiler();
+
+    // Events recorded outside of a capture are dropped
+    void begin_capture();
+    void end_capture();
+    bool is_capturing() const { return mCapturing.load(std::memory_order_relaxed); }
+
+    // Thread safe
+    void record(const char* name, uint32_t threadIndex, uint64_t startNs, uint64_t endNs);
+    void set_counter(const char* name, double value);
+
+    // The events of the last capture
+    void write_chrome_trace(std::ostream& out) const;
+    void print_counters(std::ostream& out) const;
+
+    // Steady clock, the time base of every event
+    static uint64_t now_ns();
+
+private:
+    std::atomic<bool> mCapturing{false};
+    mutable std::mutex mMutex;
+    std::vector<Event> mEvents;
+    std::vector<std::pair<std::string, double>> mCounters;
+};
+
+#endif // PROFILER_H
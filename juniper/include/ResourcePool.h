@@ -0,0 +1,180 @@
+//======================================================================
+// ResourcePool.h
+//
+// Keegan Kochis
+// Created: 2026/10/18
+// Typed generational handles and a dense structure-of-arrays pool
+// they index into.
+// A handle is 32 bits: a 20 bit slot index and a 12 bit generation.
+// The slot maps to a position in the dense columns, which stay packed
+// (swap-remove) so iterating a column touches only live entries.
+// Lookups validate the generation unless NDEBUG is defined, so a
+// handle to a destroyed resource is caught instead of aliasing a new one.
+//======================================================================
+
+#ifndef RESOURCE_POOL_H
+#define RESOURCE_POOL_H
+
+#include <cstddef>
+#include <cstdint>
+
+#include <stdexcept>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+template <typename Tag>
+class Handle {
+public:
+    static constexpr uint32_t INDEX_BITS = 20;
+    static constexpr uint32_t GENERATION_BITS = 12;
+    static constexpr uint32_t INDEX_MASK = (1u << INDEX_BITS) - 1;
+    static constexpr uint32_t GENERATION_MASK = (1u << GENERATION_BITS) - 1;
+    static constexpr uint32_t MAX_INDEX = INDEX_MASK;
+
+    Handle() : mValue(0) {}
+    Handle(uint32_t index, uint32_t generation)
+        : mValue((generation & GENERATION_MASK) << INDEX_BITS | (index & INDEX_MASK)) {}
+
+    // Rebuild a handle from value(), e.g. after packing it into a sort key
+    static Handle from_value(uint32_t value) {
+        Handle handle;
+        handle.mValue = value;
+        return handle;
+    }
+
+    uint32_t index() const { return mValue & INDEX_MASK; }
+    uint32_t generation() const { return mValue >> INDEX_BITS; }
+    uint32_t value() const { return mValue; }
+    // Generations start at 1, so the all zero handle never refers to anything
+    bool is_null() const { return mValue == 0; }
+
+    bool operator==(const Handle& other) const { return mValue == other.mValue; }
+    bool operator!=(const Handle& other) const { return mValue != other.mValue; }
+
+private:
+    uint32_t mValue;
+};
+
+
+template <typename Tag, typename... Columns>
+class ResourcePool {
+public:
+    typedef Handle<Tag> HandleType;
+
+    template <size_t Column>
+    using ColumnType = typename std::tuple_element<Column, std::tuple<Columns...>>::type;
+
+    HandleType add(Columns... values) {
+        uint32_t index;
+        if (!mFreeSlots.empty()) {
+            index = mFreeSlots.back();
+            mFreeSlots.pop_back();
+        }
+        else {
+            if (mSlots.size() > HandleType::MAX_INDEX) {
+                throw std::runtime_error("Resource pool is full!");
+            }
+            index = static_cast<uint32_t>(mSlots.size());
+            mSlots.push_back(Slot());
+        }
+
+        Slot& slot = mSlots[index];
+        slot.denseIndex = static_cast<uint32_t>(mDenseHandles.size());
+
+        HandleType handle(index, slot.generation);
+        mDenseHandles.push_back(handle);
+        push_columns(std::index_sequence_for<Columns...>(), std::move(values)...);
+        return handle;
+    }
+
+    // Swap-remove from the dense columns and retire the slot's generation
+    void remove(HandleType handle) {
+        const uint32_t denseIndex = checked_dense_index(handle);
+        const uint32_t lastIndex = static_cast<uint32_t>(mDenseHandles.size() - 1);
+
+        if (denseIndex != lastIndex) {
+            mDenseHandles[denseIndex] = mDenseHandles[lastIndex];
+            mSlots[mDenseHandles[denseIndex].index()].denseIndex = denseIndex;
+            move_columns(std::index_sequence_for<Columns...>(), denseIndex, lastIndex);
+        }
+        mDenseHandles.pop_back();
+        pop_columns(std::index_sequence_for<Columns...>());
+
+        Slot& slot = mSlots[handle.index()];
+        slot.generation = (slot.generation + 1) & HandleType::GENERATION_MASK;
+        if (slot.generation == 0) {
+            slot.generation = 1;
+        }
+        slot.denseIndex = INVALID_DENSE_INDEX;
+        mFreeSlots.push_back(handle.index());
+    }
+
+    bool contains(HandleType handle) const {
+        if (handle.is_null() || handle.index() >= mSlots.size()) {
+            return false;
+        }
+        const Slot& slot = mSlots[handle.index()];
+        return slot.generation == handle.generation() && slot.denseIndex != INVALID_DENSE_INDEX;
+    }
+
+    template <size_t Column>
+    ColumnType<Column>& get(HandleType handle) {
+        return std::get<Column>(mColumns)[checked_dense_index(handle)];
+    }
+
+    template <size_t Column>
+    const ColumnType<Column>& get(HandleType handle) const {
+        return std::get<Column>(mColumns)[checked_dense_index(handle)];
+    }
+
+    // Packed column for iteration, entry i belongs to handle_at(i)
+    template <size_t Column>
+    std::vector<ColumnType<Column>>& column() { return std::get<Column>(mColumns); }
+
+    template <size_t Column>
+    const std::vector<ColumnType<Column>>& column() const { return std::get<Column>(mColumns); }
+
+    HandleType handle_at(size_t denseIndex) const { return mDenseHandles[denseIndex]; }
+    size_t size() const { return mDenseHandles.size(); }
+    bool empty() const { return mDenseHandles.empty(); }
+
+private:
+    static constexpr uint32_t INVALID_DENSE_INDEX = UINT32_MAX;
+
+    struct Slot {
+        uint32_t generation = 1;
+        uint32_t denseIndex = INVALID_DENSE_INDEX;
+    };
+
+    std::vector<Slot> mSlots;
+    std::vector<uint32_t> mFreeSlots;
+    std::vector<HandleType> mDenseHandles;
+    std::tuple<std::vector<Columns>...> mColumns;
+
+    uint32_t checked_dense_index(HandleType handle) const {
+#ifndef NDEBUG
+        if (!contains(handle)) {
+            throw std::runtime_error("Stale or invalid resource handle!");
+        }
+#endif
+        return mSlots[handle.index()].denseIndex;
+    }
+
+    template <size_t... Is>
+    void push_columns(std::index_sequence<Is...>, Columns&&... values) {
+        (std::get<Is>(mColumns).push_back(std::move(values)), ...);
+    }
+
+    template <size_t... Is>
+    void move_columns(std::index_sequence<Is...>, uint32_t to, uint32_t from) {
+        ((std::get<Is>(mColumns)[to] = std::move(std::get<Is>(mColumns)[from])), ...);
+    }
+
+    template <size_t... Is>
+    void pop_columns(std::index_sequence<Is...>) {
+        (std::get<Is>(mColumns).pop_back(), ...);
+    }
+};
+
+#endif // RESOURCE_POOL_H
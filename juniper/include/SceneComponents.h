@@ -0,0 +1,66 @@
+//======================================================================
+// SceneComponents.h
+//
+// Keegan Kochis
+// Created: 2026/10/18
+// Components of the entities in the game's scene.
+//======================================================================
+
+#ifndef SCENE_COMPONENTS_H
+#define SCENE_COMPONENTS_H
+
+#define GLM_FORCE_RADIANS
+#define GLM_FORCE_DEPTH_ZERO_TO_ONE
+#include <glm/vec3.hpp>
+#include <glm/gtc/quaternion.hpp>
+
+#include "InstancedRenderer.h"
+#include "MeshletRenderer.h"
+#include "ResourcePool.h"
+
+struct TransformNodeTag {};
+
+// Node in the TransformHierarchy
+typedef Handle<TransformNodeTag> TransformNode;
+
+
+struct Transform_t {
+    glm::vec3 position;
+    glm::quat rotation;
+    glm::vec3 scale;
+}; typedef Transform_t Transform;
+
+
+// The Transform as of the previous simulation step, frames blend between the two
+struct PreviousTransform_t {
+    Transform value;
+}; typedef PreviousTransform_t PreviousTransform;
+
+
+// Sets the rotation to phase + speed * time radians about the axis
+struct Spin_t {
+    glm::vec3 axis;
+    float speed;
+    float phase;
+}; typedef Spin_t Spin;
+
+
+// Drawn by the instanced renderer
+struct InstancedMesh_t {
+    MeshHandle mesh;
+    MaterialHandle material;
+}; typedef InstancedMesh_t InstancedMesh;
+
+
+// Drawn by the meshlet renderer
+struct MeshletMesh_t {
+    MeshletMeshHandle mesh;
+}; typedef MeshletMesh_t MeshletMesh;
+
+
+// Placed by a transform hierarchy node instead of its own Transform
+struct SceneNode_t {
+    TransformNode node;
+}; typedef SceneNode_t SceneNode;
+
+#endif // SCENE_COMPONENTS_H
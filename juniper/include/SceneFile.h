@@ -0,0 +1,229 @@
+//======================================================================
+// SceneFile.h
+//
+// Keegan Kochis
+// Created: 2026/10/18
+// The declaration of the SceneFile class.
+// Cooked scenes: the node hierarchy, meshes as lists of primitives each
+// cooked into its own mesh file, materials, skins and animations. Like
+// mesh files, scene files are a header with a section table followed by
+// aligned flat arrays, mapped and validated at runtime and then read in
+// place. Nodes are stored breadth first, so every parent comes before
+// its children and the nodes can be created in file order. Names and
+// paths live in a string table, matrices and keyframes in a float table,
+// and the records refer to both by offset.
+//======================================================================
+
+#ifndef SCENE_FILE_H
+#define SCENE_FILE_H
+
+#include <cstdint>
+
+#include <string>
+#include <vector>
+
+#define GLM_FORCE_RADIANS
+#define GLM_FORCE_DEPTH_ZERO_TO_ONE
+#include <glm/vec4.hpp>
+
+#include "MappedFile.h"
+
+enum SceneFileSection_t {
+    SCENE_FILE_SECTION_NODES = 0,
+    SCENE_FILE_SECTION_MESHES,
+    SCENE_FILE_SECTION_PRIMITIVES,
+    SCENE_FILE_SECTION_MATERIALS,
+    SCENE_FILE_SECTION_SKINS,
+    SCENE_FILE_SECTION_JOINTS,
+    SCENE_FILE_SECTION_ANIMATIONS,
+    SCENE_FILE_SECTION_CHANNELS,
+    SCENE_FILE_SECTION_FLOATS,
+    SCENE_FILE_SECTION_STRINGS,
+    SCENE_FILE_SECTION_COUNT
+}; typedef SceneFileSection_t SceneFileSection;
+
+
+enum AlphaMode_t {
+    ALPHA_MODE_OPAQUE = 0,
+    ALPHA_MODE_MASK,
+    ALPHA_MODE_BLEND
+}; typedef AlphaMode_t AlphaMode;
+
+
+enum AnimationPath_t {
+    ANIMATION_PATH_TRANSLATION = 0,
+    ANIMATION_PATH_ROTATION,
+    ANIMATION_PATH_SCALE,
+    ANIMATION_PATH_WEIGHTS
+}; typedef AnimationPath_t AnimationPath;
+
+
+enum AnimationInterpolation_t {
+    ANIMATION_INTERPOLATION_LINEAR = 0,
+    ANIMATION_INTERPOLATION_STEP,
+    // Each key holds an in tangent, the value and an out tangent
+    ANIMATION_INTERPOLATION_CUBIC_SPLINE
+}; typedef AnimationInterpolation_t AnimationInterpolation;
+
+
+struct SceneFileHeader_t {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t nodeCount;
+    uint32_t meshCount;
+    uint32_t primitiveCount;
+    uint32_t materialCount;
+    uint32_t skinCount;
+    uint32_t jointCount;
+    uint32_t animationCount;
+    uint32_t channelCount;
+    uint32_t floatCount;
+    uint32_t stringBytes;
+    FileRange sections[SCENE_FILE_SECTION_COUNT];
+}; typedef SceneFileHeader_t SceneFileHeader;
+
+
+// The references are indices into the other tables, SceneFile::INVALID_INDEX when unset
+struct SceneFileNode_t {
+    uint32_t parent;
+    uint32_t mesh;
+    uint32_t skin;
+    uint32_t name;                  // String offset
+    glm::vec4 translation;          // xyz
+    glm::vec4 rotation;             // Quaternion in x, y, z, w order
+    glm::vec4 scale;                // xyz
+}; typedef SceneFileNode_t SceneFileNode;
+
+
+struct SceneFileMesh_t {
+    uint32_t firstPrimitive;
+    uint32_t primitiveCount;
+    uint32_t name;
+    uint32_t padding;
+}; typedef SceneFileMesh_t SceneFileMesh;
+
+
+struct SceneFilePrimitive_t {
+    uint32_t material;
+    uint32_t meshFile;              // String offset of the mesh file's path, relative to the scene file
+    uint32_t padding[2];
+}; typedef SceneFilePrimitive_t SceneFilePrimitive;
+
+
+// Metallic roughness materials. The textures are string offsets of the source images'
+// paths until textures are cooked.
+struct SceneFileMaterial_t {
+    glm::vec4 baseColorFactor;
+    glm::vec4 emissiveFactor;       // xyz
+    float metallicFactor;
+    float roughnessFactor;
+    float alphaCutoff;
+    uint32_t alphaMode;             // AlphaMode
+    uint32_t doubleSided;
+    uint32_t baseColorTexture;
+    uint32_t metallicRoughnessTexture;
+    uint32_t normalTexture;
+    uint32_t occlusionTexture;
+    uint32_t emissiveTexture;
+    uint32_t name;
+    uint32_t padding;
+}; typedef SceneFileMaterial_t SceneFileMaterial;
+
+
+struct SceneFileSkin_t {
+    uint32_t firstJoint;            // Into the joint table, which holds node indices
+    uint32_t jointCount;
+    uint32_t inverseBindMatrices;   // Float offset of one column major matrix per joint, unset for identity
+    uint32_t skeleton;              // Common root node
+    uint32_t name;
+    uint32_t padding[3];
+}; typedef SceneFileSkin_t SceneFileSkin;
+
+
+struct SceneFileAnimation_t {
+    uint32_t firstChannel;
+    uint32_t channelCount;
+    float duration;                 // Seconds, the last key of any channel
+    uint32_t name;
+}; typedef SceneFileAnimation_t SceneFileAnimation;
+
+
+struct SceneFileChannel_t {
+    uint32_t node;
+    uint32_t path;                  // AnimationPath
+    uint32_t interpolation;         // AnimationInterpolation
+    uint32_t keyCount;
+    uint32_t times;                 // Float offset of keyCount ascending times in seconds
+    uint32_t values;                // Float offset of the values, three per key for cubic splines
+    uint32_t componentCount;        // Floats per value
+    uint32_t padding;
+}; typedef SceneFileChannel_t SceneFileChannel;
+
+
+// A scene being cooked, with the same tables as the file
+struct SceneData_t {
+    std::vector<SceneFileNode> nodes;
+    std::vector<SceneFileMesh> meshes;
+    std::vector<SceneFilePrimitive> primitives;
+    std::vector<SceneFileMaterial> materials;
+    std::vector<SceneFileSkin> skins;
+    std::vector<uint32_t> joints;
+    std::vector<SceneFileAnimation> animations;
+    std::vector<SceneFileChannel> channels;
+    std::vector<float> floats;
+    std::string strings;
+
+    // Returns the string's offset. Offset 0 is the empty string.
+    uint32_t add_string(const std::string& text);
+    // Returns the offset of the first float added
+    uint32_t add_floats(const float* pValues, size_t count);
+}; typedef SceneData_t SceneData;
+
+
+class SceneFile {
+public:
+    static constexpr uint32_t MAGIC = 0x4E43534A;   // "JSCN"
+    static constexpr uint32_t VERSION = 1;
+    static constexpr uint64_t ALIGNMENT = 64;
+    static constexpr uint32_t INVALID_INDEX = UINT32_MAX;
+
+
+    SceneFile();
+    ~SceneFile();
+    SceneFile(const SceneFile&) = delete;
+    SceneFile& operator=(const SceneFile&) = delete;
+
+    // Maps and validates the file, throws if it's malformed or of another version
+    void open(const std::string& path);
+    void close();
+
+    bool is_open() const { return mpHeader != nullptr; }
+    const SceneFileHeader& get_header() const { return *mpHeader; }
+    size_t get_file_bytes() const { return mFile.get_size(); }
+
+    const SceneFileNode& get_node(uint32_t index) const { return get_table<SceneFileNode>(SCENE_FILE_SECTION_NODES)[index]; }
+    const SceneFileMesh& get_mesh(uint32_t index) const { return get_table<SceneFileMesh>(SCENE_FILE_SECTION_MESHES)[index]; }
+    const SceneFilePrimitive& get_primitive(uint32_t index) const { return get_table<SceneFilePrimitive>(SCENE_FILE_SECTION_PRIMITIVES)[index]; }
+    const SceneFileMaterial& get_material(uint32_t index) const { return get_table<SceneFileMaterial>(SCENE_FILE_SECTION_MATERIALS)[index]; }
+    const SceneFileSkin& get_skin(uint32_t index) const { return get_table<SceneFileSkin>(SCENE_FILE_SECTION_SKINS)[index]; }
+    const uint32_t* get_joints(const SceneFileSkin& skin) const { return get_table<uint32_t>(SCENE_FILE_SECTION_JOINTS) + skin.firstJoint; }
+    const SceneFileAnimation& get_animation(uint32_t index) const { return get_table<SceneFileAnimation>(SCENE_FILE_SECTION_ANIMATIONS)[index]; }
+    const SceneFileChannel& get_channel(uint32_t index) const { return get_table<SceneFileChannel>(SCENE_FILE_SECTION_CHANNELS)[index]; }
+    const float* get_floats(uint32_t offset) const { return get_table<float>(SCENE_FILE_SECTION_FLOATS) + offset; }
+    const char* get_string(uint32_t offset) const { return get_table<char>(SCENE_FILE_SECTION_STRINGS) + offset; }
+
+    static void write(const std::string& path, const SceneData& scene);
+
+private:
+    MappedFile mFile;
+    const SceneFileHeader* mpHeader = nullptr;
+
+    void validate() const;
+
+    template<typename T>
+    const T* get_table(SceneFileSection section) const {
+        return reinterpret_cast<const T*>(mFile.get_range(mpHeader->sections[section]));
+    }
+};
+
+#endif // SCENE_FILE_H
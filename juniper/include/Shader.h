@@ -0,0 +1,25 @@
+//======================================================================
+// Shader.h
+//
+// Keegan Kochis
+// Created: 2026/10/18
+// Loading of the SPIR-V binaries the build compiles into
+// J_SHADER_OUTPUT_DIR.
+//======================================================================
+
+#ifndef SHADER_H
+#define SHADER_H
+
+#include <string>
+#include <vector>
+
+#define GLFW_INCLUDE_VULKAN
+#include <GLFW/glfw3.h>
+
+// Read a whole binary file
+std::vector<char> read_binary_file(const std::string& filename);
+
+// Create a shader module from a compiled shader, e.g. "instanced.vert.spv"
+VkShaderModule load_shader_module(VkDevice device, const std::string& name);
+
+#endif // SHADER_H
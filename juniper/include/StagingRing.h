@@ -0,0 +1,76 @@
+//======================================================================
+// StagingRing.h
+//
+// Keegan Kochis
+// Created: 2026/10/18
+// The declaration of the StagingRing class.
+// One persistently mapped host visible buffer used as a ring for
+// uploads. Data is copied into the ring and the copies out of it are
+// recorded by the caller. Once those are submitted, everything staged
+// since the last submission is tagged with the submission's timeline
+// value and its space is handed back when the GPU passes that value,
+// so staging never waits on the device or allocates per upload.
+//======================================================================
+
+#ifndef STAGING_RING_H
+#define STAGING_RING_H
+
+#include <cstdint>
+
+#include <deque>
+
+#define GLFW_INCLUDE_VULKAN
+#include <GLFW/glfw3.h>
+
+#include "GpuResources.h"
+#include "TimelineSync.h"
+
+class StagingRing {
+public:
+    // Where the staged bytes went, pData is null if the ring had no room
+    struct Allocation_t {
+        VkBuffer buffer = VK_NULL_HANDLE;
+        VkDeviceSize offset = 0;
+        void* pData = nullptr;
+    }; typedef Allocation_t Allocation;
+
+
+    StagingRing();
+
+    void init(GpuResources* pGpuResources, TimelineSync* pTimelineSync, VkDeviceSize size);
+    // The caller must have waited for the device first
+    void clean_up();
+
+    // Reserves bytes at a multiple of the alignment, without wrapping them around the end.
+    // Reclaims completed space first and fails rather than waiting when the ring is full.
+    // Throws if the request could never fit.
+    Allocation allocate(VkDeviceSize bytes, VkDeviceSize alignment);
+    // Tags everything allocated since the last call with the value of the submission that
+    // reads it
+    void submit(TimelineSync::QueueType queue, uint64_t value);
+    // Frees the space of submissions the GPU has completed
+    void reclaim();
+
+    VkDeviceSize get_size() const { return mSize; }
+    VkDeviceSize get_used() const { return mHead - mTail; }
+
+private:
+    struct Retirement_t {
+        TimelineSync::QueueType queue;
+        uint64_t value;
+        uint64_t end;               // Head position when the submission was made
+    }; typedef Retirement_t Retirement;
+
+    GpuResources* mpGpuResources = nullptr;
+    TimelineSync* mpTimelineSync = nullptr;
+    BufferHandle mBuffer;
+    uint8_t* mpMapped = nullptr;
+    VkDeviceSize mSize = 0;
+    // Positions grow without wrapping, the buffer offset is the position modulo the size
+    uint64_t mHead = 0;
+    uint64_t mTail = 0;
+    uint64_t mSubmitted = 0;
+    std::deque<Retirement> mRetirements;
+};
+
+#endif // STAGING_RING_H
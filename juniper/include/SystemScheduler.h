@@ -0,0 +1,172 @@
+//======================================================================
+// SystemScheduler.h
+//
+// Keegan Kochis
+// Created: 2026/10/18
+// The declaration of the SystemScheduler class.
+// Systems declare the components they read and write, const component
+// types are read and the rest written. Two systems conflict when one
+// writes a component the other accesses, and a conflicting system runs
+// after every earlier registered one it conflicts with. The resulting
+// DAG runs on the job system, with systems that iterate a query split
+// into chunk ranges. Structural changes go through the per-thread
+// command buffers, which are played back once every system finished.
+//======================================================================
+
+#ifndef SYSTEM_SCHEDULER_H
+#define SYSTEM_SCHEDULER_H
+
+#include <cstdint>
+
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <ostream>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#include "Component.h"
+#include "EntityCommandBuffer.h"
+#include "EntityWorld.h"
+#include "JobSystem.h"
+#include "Profiler.h"
+
+typedef uint32_t SystemId;
+
+class SystemScheduler {
+public:
+    // Aim for this many jobs per thread so uneven chunk costs even out
+    static constexpr uint32_t JOBS_PER_THREAD = 4;
+
+
+    struct SystemContext_t {
+        EntityWorld* pWorld;
+        // This thread's command buffer, played back after the run
+        EntityCommandBuffer* pCommands;
+        double time;
+        float deltaTime;
+        uint32_t threadIndex;
+        // Query order index of the chunk's first entity, chunk systems only
+        uint32_t firstEntity;
+    }; typedef SystemContext_t SystemContext;
+
+
+    struct SystemStats_t {
+        uint32_t jobs = 0;
+        uint32_t entities = 0;
+        double wallMs = 0.0;            // First job start to last job end
+        double cpuMs = 0.0;             // Summed over the jobs
+        double averageWallMs = 0.0;     // Exponential moving average over the runs
+    }; typedef SystemStats_t SystemStats;
+
+
+    SystemScheduler();
+
+    void init(EntityWorld* pWorld, JobSystem* pJobSystem, Profiler* pProfiler);
+    void clean_up();
+
+    // function(const SystemContext&, Entity, Components&...) for every matching entity
+    template <typename... Components, typename Function>
+    SystemId add_system(const char* name, Function function) {
+        return add_chunk_system<Components...>(name,
+            [function](const SystemContext& context, uint32_t count, const Entity* pEntities, Components*... pColumns) {
+                for (uint32_t i = 0; i < count; i++) {
+                    function(context, pEntities[i], pColumns[i]...);
+                }
+            });
+    }
+
+    // function(const SystemContext&, uint32_t count, const Entity*, Components*...) per chunk
+    template <typename... Components, typename Function>
+    SystemId add_chunk_system(const char* name, Function function) {
+        EntityWorld* pWorld = mpWorld;
+        const QueryId query = pWorld->create_query<Components...>();
+        ChunkFunction run = [pWorld, query, function](SystemContext& context, const EntityWorld::QueryChunk* pChunks,
+                                                      const uint32_t* pFirstEntities, uint32_t chunkCount) {
+            for (uint32_t i = 0; i < chunkCount; i++) {
+                context.firstEntity = pFirstEntities[i];
+                pWorld->for_each_chunk<Components...>(query, &pChunks[i], 1,
+                    [&context, &function](uint32_t count, const Entity* pEntities, Components*... pColumns) {
+                        function(context, count, pEntities, pColumns...);
+                    });
+            }
+        };
+        return add(name, read_mask<Components...>(), write_mask<Components...>(), {}, true, query, run);
+    }
+
+    // Runs once on a single thread. The masks cover the components it iterates itself,
+    // after orders it behind systems sharing other data with it.
+    SystemId add_task(const char* name, ComponentMask reads, ComponentMask writes, const std::vector<SystemId>& after,
+                      std::function<void(const SystemContext&)> function);
+
+    // Blocks until every system ran and the command buffers were played back
+    void run(double time, float deltaTime);
+
+    const SystemStats& get_stats(SystemId system) const { return mSystems[system]->stats; }
+    double get_run_ms() const { return mRunMs; }
+
+    // Systems by level with their access and predecessors
+    void print_schedule(std::ostream& out) const;
+    // The DAG in Graphviz dot format, one rank per level
+    void write_graphviz(std::ostream& out) const;
+    void print_stats(std::ostream& out) const;
+
+private:
+    typedef std::function<void(SystemContext&, const EntityWorld::QueryChunk*, const uint32_t*, uint32_t)> ChunkFunction;
+
+    struct System_t {
+        std::string name;
+        ComponentMask reads;
+        ComponentMask writes;
+        std::vector<SystemId> after;
+        bool iteratesQuery;
+        QueryId query;
+        ChunkFunction run;
+
+        // Built from the access masks whenever a system was added
+        std::vector<SystemId> predecessors;
+        std::vector<SystemId> successors;
+        uint32_t level;
+
+        // Per run
+        std::vector<EntityWorld::QueryChunk> chunks;
+        std::vector<uint32_t> firstEntities;
+        std::atomic<uint32_t> remainingPredecessors{0};
+        std::atomic<uint32_t> remainingJobs{0};
+        std::atomic<uint64_t> startNs{0};
+        std::atomic<uint64_t> endNs{0};
+        std::atomic<uint64_t> cpuNs{0};
+        SystemStats stats;
+    }; typedef System_t System;
+
+    EntityWorld* mpWorld = nullptr;
+    JobSystem* mpJobSystem = nullptr;
+    Profiler* mpProfiler = nullptr;
+    std::vector<std::unique_ptr<System>> mSystems;
+    std::vector<EntityCommandBuffer> mCommandBuffers;
+    bool mScheduleDirty = true;
+    double mTime = 0.0;
+    float mDeltaTime = 0.0f;
+    double mRunMs = 0.0;
+
+    template <typename... Components>
+    static ComponentMask write_mask() {
+        return (ComponentMask(0) | ... | (std::is_const<Components>::value ? ComponentMask(0) : component_mask<Components>()));
+    }
+
+    template <typename... Components>
+    static ComponentMask read_mask() {
+        return component_mask<Components...>() & ~write_mask<Components...>();
+    }
+
+    SystemId add(const char* name, ComponentMask reads, ComponentMask writes, const std::vector<SystemId>& after,
+                 bool iteratesQuery, QueryId query, ChunkFunction run);
+    void build_schedule();
+    void launch(SystemId system, JobSystem::JobCounter& counter);
+    void run_job(SystemId system, uint32_t firstChunk, uint32_t chunkCount);
+    void finish(SystemId system, JobSystem::JobCounter& counter);
+    static std::string mask_names(ComponentMask mask);
+};
+
+#endif // SYSTEM_SCHEDULER_H
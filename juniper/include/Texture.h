@@ -0,0 +1,73 @@
+//======================================================================
+// Texture.h
+//
+// Keegan Kochis
+// Created: 2026/10/18
+// Texture formats and the RGBA8 images the texture cooker works on.
+// Mip chains are filtered in linear float space, color textures are
+// converted from sRGB first so darker texels don't dominate, and normal
+// maps are renormalized on every level. The filter runs on the same
+// scalar, SSE and AVX2 levels as the transform kernels.
+//======================================================================
+
+#ifndef TEXTURE_H
+#define TEXTURE_H
+
+#include <cstdint>
+
+#include <vector>
+
+#define GLFW_INCLUDE_VULKAN
+#include <GLFW/glfw3.h>
+
+#include "TransformKernels.h"
+
+// Width and height of the blocks of the compressed formats
+static const uint32_t TEXTURE_BLOCK_SIZE = 4;
+
+enum TextureFormat_t {
+    TEXTURE_FORMAT_RGBA8 = 0,       // Uncompressed, 4 bytes per texel
+    TEXTURE_FORMAT_BC1,             // Opaque RGB, 8 bytes per block
+    TEXTURE_FORMAT_BC3,             // A BC4 alpha block followed by a BC1 color block, 16 bytes
+    TEXTURE_FORMAT_BC5,             // BC4 blocks of red and green, 16 bytes, for normal maps
+    TEXTURE_FORMAT_BC7,             // RGBA, 16 bytes per block, the best quality of the four
+    TEXTURE_FORMAT_COUNT
+}; typedef TextureFormat_t TextureFormat;
+
+
+// How the texels are filtered and which Vulkan format they are sampled as
+enum TextureUsage_t {
+    TEXTURE_USAGE_COLOR = 0,        // sRGB color with linear alpha
+    TEXTURE_USAGE_DATA,             // Linear values, e.g. roughness or masks
+    TEXTURE_USAGE_NORMAL,           // Tangent space normals packed into [0, 1]
+    TEXTURE_USAGE_COUNT
+}; typedef TextureUsage_t TextureUsage;
+
+
+struct TextureData_t {
+    uint32_t width = 0;
+    uint32_t height = 0;
+    std::vector<uint8_t> texels;    // RGBA8, rows from the top
+
+    static TextureData_t make_checker(uint32_t size, uint32_t squares);
+    // Hue across and brightness down with an alpha ramp, smooth content for the encoders
+    static TextureData_t make_gradient(uint32_t size);
+}; typedef TextureData_t TextureData;
+
+
+uint32_t get_texture_block_bytes(TextureFormat format);
+bool is_block_compressed(TextureFormat format);
+uint64_t get_texture_level_bytes(TextureFormat format, uint32_t width, uint32_t height);
+// Levels down to 1x1, level 0 included
+uint32_t get_texture_mip_count(uint32_t width, uint32_t height);
+VkFormat get_texture_vk_format(TextureFormat format, TextureUsage usage);
+const char* texture_format_name(TextureFormat format);
+
+// The whole chain, level 0 first and a copy of the image. Each level is filtered from the
+// previous level's float texels rather than its rounded ones.
+std::vector<TextureData> generate_mips(SimdLevel level, const TextureData& image, TextureUsage usage);
+
+// Peak signal to noise ratio in dB over the first channelCount channels, infinite when equal
+double compute_psnr(const TextureData& reference, const TextureData& image, uint32_t channelCount);
+
+#endif // TEXTURE_H
@@ -0,0 +1,111 @@
+//======================================================================
+// TextureFile.h
+//
+// Keegan Kochis
+// Created: 2026/10/18
+// The declaration of the TextureFile class.
+// Cooked textures in the KTX2 container, without supercompression, so
+// other tools can inspect them. The levels hold the blocks exactly as
+// the GPU samples them and are stored from the smallest level up, so
+// a whole chain is one contiguous range of the file. At runtime the
+// file is mapped and validated, and uploading it is one copy of that
+// range into the staging ring followed by a buffer to image copy per
+// level. Only the 2D formats the texture cooker writes are accepted.
+//======================================================================
+
+#ifndef TEXTURE_FILE_H
+#define TEXTURE_FILE_H
+
+#include <cstdint>
+
+#include <string>
+#include <vector>
+
+#define GLFW_INCLUDE_VULKAN
+#include <GLFW/glfw3.h>
+
+#include "MappedFile.h"
+#include "Texture.h"
+
+struct TextureFileHeader_t {
+    uint8_t identifier[12];
+    uint32_t vkFormat;
+    uint32_t typeSize;              // 1 for block compressed and 8 bit formats
+    uint32_t width;
+    uint32_t height;
+    uint32_t depth;                 // 0 for 2D textures
+    uint32_t layerCount;            // 0 when not an array
+    uint32_t faceCount;
+    uint32_t levelCount;
+    uint32_t supercompressionScheme;
+    uint32_t dfdByteOffset;         // Data format descriptor
+    uint32_t dfdByteLength;
+    uint32_t kvdByteOffset;         // Key/value data, unused
+    uint32_t kvdByteLength;
+    uint64_t sgdByteOffset;         // Supercompression global data, unused
+    uint64_t sgdByteLength;
+}; typedef TextureFileHeader_t TextureFileHeader;
+
+
+// Follows the header, level 0 first
+struct TextureFileLevel_t {
+    uint64_t byteOffset;
+    uint64_t byteLength;
+    uint64_t uncompressedByteLength;
+}; typedef TextureFileLevel_t TextureFileLevel;
+
+
+// One level's blocks, pointing into the mapping
+struct TextureLevelView_t {
+    const uint8_t* pData = nullptr;
+    uint64_t bytes = 0;
+    uint32_t width = 0;
+    uint32_t height = 0;
+}; typedef TextureLevelView_t TextureLevelView;
+
+
+class TextureFile {
+public:
+    static const uint8_t IDENTIFIER[12];
+
+
+    TextureFile();
+    ~TextureFile();
+    TextureFile(const TextureFile&) = delete;
+    TextureFile& operator=(const TextureFile&) = delete;
+
+    // Maps and validates the file, throws if it's malformed or of an unsupported format
+    void open(const std::string& path);
+    void close();
+
+    bool is_open() const { return mpHeader != nullptr; }
+    const TextureFileHeader& get_header() const { return *mpHeader; }
+    TextureFormat get_format() const { return mFormat; }
+    VkFormat get_vk_format() const { return static_cast<VkFormat>(mpHeader->vkFormat); }
+    uint32_t get_width() const { return mpHeader->width; }
+    uint32_t get_height() const { return mpHeader->height; }
+    uint32_t get_level_count() const { return mpHeader->levelCount; }
+    size_t get_file_bytes() const { return mFile.get_size(); }
+
+    // Points into the mapping, valid until the file is closed
+    TextureLevelView get_level(uint32_t level) const;
+    // From the smallest level's first byte to the end of level 0, levels keep their offsets
+    // relative to it and their alignment as long as the range is copied to a multiple of
+    // get_level_alignment()
+    FileRange get_data_range() const;
+    uint64_t get_level_alignment() const;
+
+    // Level 0 first, each level get_texture_level_bytes() of blocks for its size
+    static void write(const std::string& path, TextureFormat format, TextureUsage usage, uint32_t width, uint32_t height,
+                      const std::vector<std::vector<uint8_t>>& levels);
+
+private:
+    MappedFile mFile;
+    const TextureFileHeader* mpHeader = nullptr;
+    const TextureFileLevel* mpLevels = nullptr;
+    TextureFormat mFormat = TEXTURE_FORMAT_RGBA8;
+
+    void validate(TextureFormat* pFormat) const;
+};
+
+#endif // TEXTURE_FILE_H
@@ -0,0 +1,22 @@
+//======================================================================
+// TextureImport.h
+//
+// Keegan Kochis
+// Created: 2026/10/18
+// Importers of source image formats for the offline texture cooker.
+// Nothing at runtime should decode these, they are cooked into texture
+// files first.
+//======================================================================
+
+#ifndef TEXTURE_IMPORT_H
+#define TEXTURE_IMPORT_H
+
+#include <string>
+
+#include "Texture.h"
+
+// Truevision TGA, uncompressed or run length encoded, in 8 bit grayscale or 24 and 32 bit
+// color. Grayscale spreads to RGB and images without alpha are opaque.
+TextureData import_tga(const std::string& path);
+
+#endif // TEXTURE_IMPORT_H
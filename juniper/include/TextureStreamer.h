@@ -0,0 +1,142 @@
+//======================================================================
+// TextureStreamer.h
+//
+// Keegan Kochis
+// Created: 2026/10/19
+// The declaration of the TextureStreamer class.
+// Keeps the mip levels of cooked textures resident according to what
+// rendering asks for, within a VRAM budget. A texture starts with only
+// its small tail levels, the finer levels are streamed in once they
+// are requested, either from CPU estimates of the texture's size on
+// screen or from a GPU feedback buffer. When the requests don't fit the
+// budget the largest levels are dropped first, so every texture loses
+// resolution evenly, and levels no longer requested stay cached until
+// the space is needed. Changing a texture's levels builds a new image,
+// copies the levels it keeps on the GPU and uploads the new ones from
+// the mapped file through the staging ring. With VK_EXT_memory_budget
+// the budget also shrinks to what the driver reports as available.
+// The budget, resident and requested bytes are exported to the profiler
+// as counters after every update.
+//======================================================================
+
+#ifndef TEXTURE_STREAMER_H
+#define TEXTURE_STREAMER_H
+
+#include <cstdint>
+
+#include <memory>
+#include <ostream>
+#include <string>
+#include <vector>
+
+#define GLFW_INCLUDE_VULKAN
+#include <GLFW/glfw3.h>
+
+#include "DeviceFeatures.h"
+#include "GpuResources.h"
+#include "Profiler.h"
+#include "ResourcePool.h"
+#include "StagingRing.h"
+#include "TextureFile.h"
+
+struct StreamedTextureTag {};
+typedef Handle<StreamedTextureTag> StreamedTextureHandle;
+
+class TextureStreamer {
+public:
+    // Levels up to this size are loaded when the texture is added and never evicted
+    static constexpr uint32_t TAIL_SIZE = 64;
+    // Frames a texture keeps its last request after rendering stopped asking
+    static constexpr uint64_t REQUEST_FRAMES = 60;
+    // Upload bytes per update, spreads large uploads over frames
+    static constexpr uint64_t MAX_UPLOAD_BYTES = 32ull << 20;
+
+
+    struct Stats_t {
+        uint64_t budgetBytes = 0;       // In effect for the last update
+        uint64_t residentBytes = 0;
+        uint64_t requestedBytes = 0;    // What the requested levels would take
+        uint64_t uploadedBytes = 0;     // Since init
+        uint64_t evictedBytes = 0;      // Since init
+        uint32_t textureCount = 0;
+        uint32_t budgetLimited = 0;     // Textures kept coarser than requested by the budget
+        uint32_t rebuilds = 0;          // Images rebuilt in the last update
+        bool deviceBudget = false;      // Whether VK_EXT_memory_budget lowered the budget
+    }; typedef Stats_t Stats;
+
+
+    TextureStreamer();
+
+    void init(VkInstance instance, VkPhysicalDevice physicalDevice, const DeviceFeatures::Capabilities& capabilities,
+              GpuResources* pGpuResources, StagingRing* pStagingRing, uint64_t budgetBytes, Profiler* pProfiler);
+    void clean_up();
+
+    // Maps the file, its tail levels are uploaded on the next update
+    StreamedTextureHandle add_texture(const std::string& path);
+    void remove_texture(StreamedTextureHandle handle);
+    void set_budget(uint64_t budgetBytes) { mBudgetBytes = budgetBytes; }
+
+    // The finest level rendering needs this frame, the finest of all requests wins
+    void request_level(StreamedTextureHandle handle, uint32_t level);
+    // The level whose texels are about pixel sized for a texture covering screenPixels pixels
+    // along its wider side, the CPU estimate for request_level
+    uint32_t estimate_level(StreamedTextureHandle handle, float screenPixels) const;
+    // Levels read back from a GPU feedback buffer, one uint per get_feedback_slot(), written by
+    // shaders with atomicMin and cleared to 0xFFFFFFFF between frames. Only pass the buffer
+    // once the frame that wrote it has retired.
+    void apply_feedback(const uint32_t* pLevels, uint32_t count);
+    uint32_t get_feedback_slot(StreamedTextureHandle handle) const { return handle.index(); }
+
+    // Moves every texture toward its requested levels within the budget, recording the copies
+    // into the command buffer. Call once per frame. The commands read the staging ring, so the
+    // caller hands their submission to StagingRing::submit. Replaced images are destroyed on
+    // the next update, after the copies out of them were submitted.
+    void update(VkCommandBuffer commandBuffer);
+
+    // Null until the tail levels are uploaded. Changes when levels stream, so descriptors have
+    // to be looked up again after each update.
+    ImageHandle get_image(StreamedTextureHandle handle) const;
+    // Finest resident level, the level count when nothing is resident yet
+    uint32_t get_resident_level(StreamedTextureHandle handle) const;
+
+    const Stats& get_stats() const { return mStats; }
+    void print_stats(std::ostream& out) const;
+
+private:
+    struct StreamedTexture_t {
+        std::unique_ptr<TextureFile> pFile;
+        ImageHandle image;
+        // Bytes of the levels from the index on down to 1x1, one more entry that is zero
+        std::vector<uint64_t> chainBytes;
+        uint32_t levelCount = 0;
+        uint32_t tailLevel = 0;         // Finest level that is always resident
+        uint32_t residentLevel = 0;
+        uint32_t requestedLevel = UINT32_MAX;
+        uint32_t wantedLevel = 0;
+        uint32_t targetLevel = 0;
+        uint64_t lastRequestFrame = 0;
+    }; typedef StreamedTexture_t StreamedTexture;
+
+    typedef ResourcePool<StreamedTextureTag, StreamedTexture> TexturePool;
+
+    VkPhysicalDevice mPhysicalDevice = VK_NULL_HANDLE;
+    GpuResources* mpGpuResources = nullptr;
+    StagingRing* mpStagingRing = nullptr;
+    Profiler* mpProfiler = nullptr;
+    bool mTextureCompressionBC = false;
+    PFN_vkGetPhysicalDeviceMemoryProperties2 mpGetMemoryProperties2 = nullptr;
+    uint64_t mBudgetBytes = 0;
+    uint64_t mFrame = 0;
+    TexturePool mTextures;
+    std::vector<ImageHandle> mRetiredImages;
+    Stats mStats;
+
+    uint64_t query_budget();
+    void export_counters() const;
+    void plan_levels(uint64_t budgetBytes);
+    // Builds an image with the levels from finestLevel on, returns false if the staging ring
+    // had no room for the new levels
+    bool rebuild(StreamedTexture& texture, uint32_t finestLevel, VkCommandBuffer commandBuffer);
+};
+
+#endif // TEXTURE_STREAMER_H
@@ -0,0 +1,31 @@
+//======================================================================
+// TextureUpload.h
+//
+// Keegan Kochis
+// Created: 2026/10/18
+// Uploads of cooked texture files. The file's whole level chain is
+// copied from the mapping into the staging ring in one memcpy and each
+// level is copied into the image from its place in the ring, so the
+// blocks reach the GPU exactly as they were cooked.
+//======================================================================
+
+#ifndef TEXTURE_UPLOAD_H
+#define TEXTURE_UPLOAD_H
+
+#define GLFW_INCLUDE_VULKAN
+#include <GLFW/glfw3.h>
+
+#include "DeviceFeatures.h"
+#include "GpuResources.h"
+#include "StagingRing.h"
+#include "TextureFile.h"
+
+// Creates a sampled image with every level of the file and records the copies into it,
+// leaving it in the shader read only layout for fragment and compute shaders. The commands
+// read the staging ring, so the caller passes their submission to StagingRing::submit.
+// Returns a null handle when the ring has no room yet, the caller retries once earlier
+// uploads have retired. Throws if the device can't sample block compressed formats.
+ImageHandle upload_texture(GpuResources* pGpuResources, StagingRing* pStagingRing, VkCommandBuffer commandBuffer,
+                           const DeviceFeatures::Capabilities& capabilities, const TextureFile& file);
+
+#endif // TEXTURE_UPLOAD_H
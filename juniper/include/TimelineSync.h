@@ -0,0 +1,108 @@
+//======================================================================
+// TimelineSync.h
+//
+// Keegan Kochis
+// Created: 2026/10/18
+// The declaration of the TimelineSync class.
+// Every queue owns a monotonically increasing timeline. A submission
+// signals the next value on its queue's timeline and may wait on values
+// of other queues, which is how transfer -> compute -> graphics work is
+// chained. The CPU polls or waits on values to know when work retired.
+// Devices without timeline semaphores fall back to one fence per
+// submission behind the same interface.
+//======================================================================
+
+#ifndef TIMELINE_SYNC_H
+#define TIMELINE_SYNC_H
+
+#include <cstdint>
+
+#include <deque>
+#include <vector>
+
+#define GLFW_INCLUDE_VULKAN
+#include <GLFW/glfw3.h>
+
+#include "DeviceFeatures.h"
+
+class TimelineSync {
+public:
+    enum QueueType_t {
+        QUEUE_GRAPHICS = 0,
+        QUEUE_COMPUTE,
+        QUEUE_TRANSFER,
+        QUEUE_COUNT
+    }; typedef QueueType_t QueueType;
+
+
+    // GPU side wait for another queue to reach a value before the given stages run
+    struct Wait_t {
+        QueueType queue = QUEUE_GRAPHICS;
+        uint64_t value = 0;
+        VkPipelineStageFlags stages = VK_PIPELINE_STAGE_ALL_COMMANDS_BIT;
+    }; typedef Wait_t Wait;
+
+
+    struct Submission_t {
+        std::vector<VkCommandBuffer> commandBuffers;
+        std::vector<Wait> waits;
+        // Binary semaphores, e.g. swapchain image acquire and present
+        std::vector<VkSemaphore> binaryWaitSemaphores;
+        std::vector<VkPipelineStageFlags> binaryWaitStages;
+        std::vector<VkSemaphore> binarySignalSemaphores;
+    }; typedef Submission_t Submission;
+
+
+    TimelineSync();
+
+    void init(VkDevice device, const DeviceFeatures::Capabilities& capabilities,
+              VkQueue graphicsQueue, VkQueue computeQueue, VkQueue transferQueue);
+    void clean_up();
+
+    // Submit and return the value the queue's timeline reaches once the work completes
+    uint64_t submit(QueueType queue, const Submission& submission);
+
+    // Value of the last submission made to the queue
+    uint64_t last_submitted(QueueType queue) const { return mTimelines[queue].lastSubmitted; }
+    // Highest value known to be complete, refreshed from the GPU
+    uint64_t poll(QueueType queue);
+    bool is_complete(QueueType queue, uint64_t value);
+    // Blocks until the value is reached, throws if it can't be
+    void wait(QueueType queue, uint64_t value);
+    // Returns false if the value wasn't reached within the timeout
+    bool wait_for(QueueType queue, uint64_t value, uint64_t timeoutNs);
+    // Wait for everything submitted so far on every queue
+    void wait_all();
+
+    bool uses_timeline_semaphores() const { return mUseTimelineSemaphores; }
+
+private:
+    struct PendingFence_t {
+        uint64_t value;
+        VkFence fence;
+    }; typedef PendingFence_t PendingFence;
+
+    struct Timeline_t {
+        VkQueue queue = VK_NULL_HANDLE;
+        VkSemaphore semaphore = VK_NULL_HANDLE;
+        uint64_t lastSubmitted = 0;
+        uint64_t lastCompleted = 0;
+        // Fence fallback only, ordered by value
+        std::deque<PendingFence> pendingFences;
+    }; typedef Timeline_t Timeline;
+
+    VkDevice mDevice = VK_NULL_HANDLE;
+    bool mUseTimelineSemaphores = false;
+    Timeline mTimelines[QUEUE_COUNT];
+    std::vector<VkFence> mFreeFences;
+
+    PFN_vkGetSemaphoreCounterValue mpGetSemaphoreCounterValue = nullptr;
+    PFN_vkWaitSemaphores mpWaitSemaphores = nullptr;
+
+    uint64_t submit_timeline(Timeline& timeline, const Submission& submission);
+    uint64_t submit_fence(Timeline& timeline, const Submission& submission);
+    VkFence grab_fence();
+    void retire_fences(Timeline& timeline);
+};
+
+#endif // TIMELINE_SYNC_H
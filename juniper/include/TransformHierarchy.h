@@ -0,0 +1,116 @@
+//======================================================================
+// TransformHierarchy.h
+//
+// Keegan Kochis
+// Created: 2026/10/18
+// The declaration of the TransformHierarchy class.
+// Parent/child transforms stored breadth first: nodes are sorted by
+// depth, and the children of a node are contiguous in the next level,
+// so every column is walked front to back and a parent's world matrix
+// is always computed before its children read it. Changing a local
+// transform queues the node in its level's dirty list, and an update
+// only visits the dirty nodes and their subtrees, level by level, each
+// level split across the job system. Creating, destroying or
+// reparenting nodes re-sorts the nodes on the next update, which then
+// recomputes every world matrix.
+//======================================================================
+
+#ifndef TRANSFORM_HIERARCHY_H
+#define TRANSFORM_HIERARCHY_H
+
+#include <cstdint>
+
+#include <ostream>
+#include <vector>
+
+#define GLM_FORCE_RADIANS
+#define GLM_FORCE_DEPTH_ZERO_TO_ONE
+#include <glm/mat4x4.hpp>
+#include <glm/vec3.hpp>
+#include <glm/gtc/quaternion.hpp>
+
+#include "JobSystem.h"
+#include "ResourcePool.h"
+#include "SceneComponents.h"
+
+class TransformHierarchy {
+public:
+    // Levels with fewer dirty nodes than two batches are updated on the calling thread
+    static constexpr uint32_t PARALLEL_BATCH_SIZE = 1024;
+    // Levels with more than this fraction of dirty nodes are updated whole, as are the ones below
+    static constexpr uint32_t WHOLE_LEVEL_FRACTION = 4;
+    static constexpr uint32_t INVALID_INDEX = UINT32_MAX;
+
+
+    struct Stats_t {
+        uint32_t nodes = 0;
+        uint32_t levels = 0;
+        uint32_t updatedNodes = 0;      // Last update
+        uint32_t parallelLevels = 0;    // Last update
+        uint64_t layoutRebuilds = 0;
+    }; typedef Stats_t Stats;
+
+
+    TransformHierarchy();
+
+    // Without a job system every level is updated on the calling thread
+    void init(JobSystem* pJobSystem);
+    void clean_up();
+
+    // A null parent makes a root
+    TransformNode create_node(TransformNode parent, const Transform& local);
+    // Destroys the node's whole subtree
+    void destroy_node(TransformNode node);
+    // Keeps the local transform, so the node moves with its new parent
+    void set_parent(TransformNode node, TransformNode parent);
+    void set_local(TransformNode node, const Transform& local);
+
+    bool contains(TransformNode node) const { return mNodes.contains(node); }
+    TransformNode get_parent(TransformNode node) const;
+    Transform get_local(TransformNode node) const;
+    // As of the last update
+    const glm::mat4& get_world(TransformNode node) const { return mWorld[mNodes.get<0>(node)]; }
+
+    // Recomputes the world matrices of the dirty nodes and their descendants
+    void update();
+
+    Stats get_stats() const;
+    void print_stats(std::ostream& out) const;
+
+private:
+    JobSystem* mpJobSystem = nullptr;
+    // Each node's position in the sorted columns
+    ResourcePool<TransformNodeTag, uint32_t> mNodes;
+
+    // Sorted columns, nodes created since the last layout rebuild are appended unsorted
+    // and destroyed ones keep a null handle until then
+    std::vector<TransformNode> mHandles;
+    std::vector<uint32_t> mParents;
+    std::vector<uint32_t> mFirstChildren;
+    std::vector<uint32_t> mChildCounts;
+    std::vector<uint32_t> mDepths;
+    std::vector<glm::vec3> mLocalPositions;
+    std::vector<glm::quat> mLocalRotations;
+    std::vector<glm::vec3> mLocalScales;
+    std::vector<glm::mat4> mWorld;
+    std::vector<uint8_t> mDirtyFlags;
+
+    // Level d spans [mLevelStarts[d], mLevelStarts[d + 1])
+    std::vector<uint32_t> mLevelStarts;
+    std::vector<std::vector<uint32_t>> mDirtyLevels;
+    bool mLayoutDirty = false;
+    bool mFullUpdate = false;
+    uint32_t mDeadCount = 0;
+
+    uint32_t mUpdatedNodes = 0;
+    uint32_t mParallelLevels = 0;
+    uint64_t mLayoutRebuilds = 0;
+
+    void rebuild_layout();
+    void update_nodes(const uint32_t* pIndices, uint32_t count);
+    void update_range(uint32_t begin, uint32_t end);
+    void update_node(uint32_t index);
+    void mark_dirty(uint32_t index);
+};
+
+#endif // TRANSFORM_HIERARCHY_H
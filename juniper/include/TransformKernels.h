@@ -0,0 +1,101 @@
+//======================================================================
+// TransformKernels.h
+//
+// Keegan Kochis
+// Created: 2026/10/18
+// Batch kernels for transforms and bounds in structure of arrays form.
+// Every kernel has a scalar version and, on x86, SSE and AVX2 versions
+// working on 4 and 8 objects at a time. The best level the CPU supports
+// is detected once, the level can also be forced to compare them.
+//======================================================================
+
+#ifndef TRANSFORM_KERNELS_H
+#define TRANSFORM_KERNELS_H
+
+#include <cstddef>
+#include <cstdint>
+
+#include <vector>
+
+#define GLM_FORCE_RADIANS
+#define GLM_FORCE_DEPTH_ZERO_TO_ONE
+#include <glm/mat4x4.hpp>
+#include <glm/vec4.hpp>
+
+enum SimdLevel_t {
+    SIMD_LEVEL_SCALAR = 0,
+    SIMD_LEVEL_SSE,
+    SIMD_LEVEL_AVX2
+}; typedef SimdLevel_t SimdLevel;
+
+
+// Translation, rotation and scale of each object, the rotation a unit quaternion
+struct TransformSoA_t {
+    std::vector<float> positionX;
+    std::vector<float> positionY;
+    std::vector<float> positionZ;
+    std::vector<float> rotationX;
+    std::vector<float> rotationY;
+    std::vector<float> rotationZ;
+    std::vector<float> rotationW;
+    std::vector<float> scaleX;
+    std::vector<float> scaleY;
+    std::vector<float> scaleZ;
+
+    void resize(size_t count);
+    size_t size() const { return positionX.size(); }
+}; typedef TransformSoA_t TransformSoA;
+
+
+struct SphereSoA_t {
+    std::vector<float> centerX;
+    std::vector<float> centerY;
+    std::vector<float> centerZ;
+    std::vector<float> radius;
+
+    void resize(size_t count);
+    size_t size() const { return centerX.size(); }
+}; typedef SphereSoA_t SphereSoA;
+
+
+struct AabbSoA_t {
+    std::vector<float> centerX;
+    std::vector<float> centerY;
+    std::vector<float> centerZ;
+    std::vector<float> extentX;     // Half size along each axis
+    std::vector<float> extentY;
+    std::vector<float> extentZ;
+
+    void resize(size_t count);
+    size_t size() const { return centerX.size(); }
+}; typedef AabbSoA_t AabbSoA;
+
+
+// Highest level both the build and the CPU support
+SimdLevel get_simd_level();
+const char* simd_level_name(SimdLevel level);
+
+// Matrices are read and written with a byte stride, so they can live inside larger structs.
+// Levels above get_simd_level() fall back to it.
+
+// World matrix = translation * rotation * scale
+void compose_matrices(SimdLevel level, const TransformSoA& transforms, glm::mat4* pMatrices, size_t matrixStride);
+// The radius is scaled by the largest axis scale of the matrix
+void transform_spheres(SimdLevel level, const glm::mat4* pMatrices, size_t matrixStride,
+                       const SphereSoA& local, SphereSoA& world);
+// The world box encloses the transformed local box
+void transform_aabbs(SimdLevel level, const glm::mat4* pMatrices, size_t matrixStride,
+                     const AabbSoA& local, AabbSoA& world);
+
+// Planes point inwards with normalized normals, see InstancedRenderer::extract_frustum_planes.
+// Writes 1 for visible and 0 for culled, and returns the visible count.
+uint32_t cull_spheres(SimdLevel level, const glm::vec4 planes[6], const SphereSoA& spheres, uint8_t* pVisibility);
+uint32_t cull_aabbs(SimdLevel level, const glm::vec4 planes[6], const AabbSoA& boxes, uint8_t* pVisibility);
+
+// Pixels each sphere's radius covers at its nearest depth, for screen space errors. depthPlane
+// is the w row of the view projection, projectionScale the pixels per unit at a depth of one.
+// Spheres reaching the camera plane get FLT_MAX.
+void project_sphere_radii(SimdLevel level, const glm::vec4& depthPlane, float projectionScale, const SphereSoA& spheres,
+                          float* pRadii);
+
+#endif // TRANSFORM_KERNELS_H
@@ -0,0 +1,83 @@
+//======================================================================
+// VirtualFileSystem.h
+//
+// Keegan Kochis
+// Created: 2026/10/19
+// The declaration of the VirtualFileSystem class.
+// One namespace over the mounted pack files. Mounting indexes every
+// entry by the hash of its path, so finding a file is one hash table
+// lookup whichever archive it lives in, and archives mounted later
+// shadow files of the same path in earlier ones, which is how patches
+// and mods replace content. Reads decompress on the job system, a batch
+// of files as one parallel loop over all their chunks.
+//======================================================================
+
+#ifndef VIRTUAL_FILE_SYSTEM_H
+#define VIRTUAL_FILE_SYSTEM_H
+
+#include <cstdint>
+
+#include <memory>
+#include <ostream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "JobSystem.h"
+#include "PackFile.h"
+
+class VirtualFileSystem {
+public:
+    // Where a path resolved to, valid until the archives change
+    struct FileLocation_t {
+        uint32_t archive;
+        uint32_t entry;
+    }; typedef FileLocation_t FileLocation;
+
+
+    struct Stats_t {
+        uint32_t archives = 0;
+        uint32_t files = 0;             // Reachable ones, shadowed files don't count
+        uint64_t archiveBytes = 0;
+        uint64_t filesRead = 0;
+        uint64_t bytesRead = 0;         // Uncompressed
+        uint64_t chunksDecompressed = 0;
+    }; typedef Stats_t Stats;
+
+
+    VirtualFileSystem();
+
+    // Without a job system everything is read on the calling thread
+    void init(JobSystem* pJobSystem);
+    void clean_up();
+
+    // Opens the archive and indexes its files over those of the archives mounted before
+    void mount(const std::string& packPath);
+
+    // False if no mounted archive has the path
+    bool find(const std::string& path, FileLocation* pLocation) const;
+    bool exists(const std::string& path) const;
+    uint64_t get_size(const FileLocation& location) const;
+    const char* get_path(const FileLocation& location) const;
+    // Points into the archive's mapping for files stored uncompressed, null otherwise
+    const uint8_t* get_mapped(const FileLocation& location) const;
+
+    void read(const FileLocation& location, uint8_t* pDestination);
+    // Throws if the path isn't found
+    std::vector<uint8_t> read_file(const std::string& path);
+    // Reads every file into its destination, each one's chunks are a job of their own, so
+    // many small files keep the threads as busy as one large one
+    void read_files(const std::vector<FileLocation>& locations, const std::vector<uint8_t*>& destinations);
+
+    const Stats& get_stats() const { return mStats; }
+    void print_stats(std::ostream& out) const;
+
+private:
+    JobSystem* mpJobSystem = nullptr;
+    std::vector<std::unique_ptr<PackFile>> mArchives;
+    // Path hash to the file that path currently resolves to
+    std::unordered_map<uint64_t, FileLocation> mLocations;
+    Stats mStats;
+};
+
+#endif // VIRTUAL_FILE_SYSTEM_H
@@ -0,0 +1,170 @@
+//======================================================================
+// cull_instances.glsl
+//
+// Keegan Kochis
+// Created: 2026/10/18
+// Object culling shared by both phases, one thread per object. The
+// early phase keeps frustum visible objects which were visible last
+// frame. The late phase, compiled with LATE_PHASE, also tests every
+// frustum visible object against the depth pyramid, stores the result
+// for the next frame and keeps the visible objects the early phase did
+// not draw. Survivors are appended to the range of their level of
+// detail's batch entry in the visible instance buffer. The early phase
+// selects the level and keeps it above the visibility bit of the object
+// for the next frame's hysteresis and for the late phase.
+//======================================================================
+
+#include "culling.glsl"
+
+#ifdef LATE_PHASE
+layout(set = 0, binding = 9) uniform sampler2D depthPyramid;
+
+// Projects the sphere's bounding box and compares its nearest depth with the farthest
+// depth of the pyramid texels covering it. Boxes crossing the near plane are visible.
+bool is_occluded(vec3 center, float radius) {
+    vec3 minimum = vec3(1.0);
+    vec3 maximum = vec3(-1.0);
+    for (int i = 0; i < 8; i++) {
+        vec3 corner = center + radius * vec3((i & 1) != 0 ? 1.0 : -1.0,
+                                             (i & 2) != 0 ? 1.0 : -1.0,
+                                             (i & 4) != 0 ? 1.0 : -1.0);
+        vec4 clip = uniforms.viewProjection * vec4(corner, 1.0);
+        if (clip.w <= 0.0) {
+            return false;
+        }
+
+        vec3 ndc = clip.xyz / clip.w;
+        minimum = i == 0 ? ndc : min(minimum, ndc);
+        maximum = i == 0 ? ndc : max(maximum, ndc);
+    }
+
+    vec2 uvMinimum = clamp(minimum.xy * 0.5 + 0.5, 0.0, 1.0);
+    vec2 uvMaximum = clamp(maximum.xy * 0.5 + 0.5, 0.0, 1.0);
+    vec2 size = (uvMaximum - uvMinimum) * uniforms.pyramidSize;
+
+    // The level where the box spans at most two texels per axis
+    float level = ceil(log2(max(max(size.x, size.y), 1.0)));
+    int lod = min(int(level), textureQueryLevels(depthPyramid) - 1);
+
+    ivec2 levelSize = textureSize(depthPyramid, lod);
+    ivec2 first = clamp(ivec2(uvMinimum * vec2(levelSize)), ivec2(0), levelSize - 1);
+    ivec2 last = clamp(ivec2(uvMaximum * vec2(levelSize)), ivec2(0), levelSize - 1);
+
+    float depth = max(max(texelFetch(depthPyramid, first, lod).r, texelFetch(depthPyramid, ivec2(last.x, first.y), lod).r),
+                      max(texelFetch(depthPyramid, ivec2(first.x, last.y), lod).r, texelFetch(depthPyramid, last, lod).r));
+
+    return minimum.z > depth;
+}
+#endif
+
+// Steps from the previous level towards the coarsest level within the threshold, the same
+// as select_lod in InstancedRenderer.cpp
+uint select_lod(uint batchIndex, uint lodCount, uint previous, float projectedRadius) {
+    uint lod = min(previous, lodCount - 1);
+    while (lod > 0 && batches[batchIndex + lod].lodError * projectedRadius > uniforms.lodThreshold) {
+        lod--;
+    }
+    while (lod + 1 < lodCount &&
+           batches[batchIndex + lod + 1].lodError * projectedRadius <= uniforms.lodThreshold * (1.0 - LOD_HYSTERESIS)) {
+        lod++;
+    }
+    return lod;
+}
+
+// Summed per workgroup so the counters see one atomic per group
+shared uint groupFrustumCulled;
+shared uint groupOcclusionCulled;
+shared uint groupDrawn;
+shared uint groupLodDrawn[MAX_LOD_COUNT];
+
+void main() {
+    if (gl_LocalInvocationIndex == 0) {
+        groupFrustumCulled = 0;
+        groupOcclusionCulled = 0;
+        groupDrawn = 0;
+        for (uint i = 0; i < MAX_LOD_COUNT; i++) {
+            groupLodDrawn[i] = 0;
+        }
+    }
+    barrier();
+
+    // No early return, every invocation has to reach the barriers
+    uint objectIndex = gl_GlobalInvocationID.x;
+    if (objectIndex < uniforms.objectCount) {
+        ObjectData object = objects[objectIndex];
+        BatchData batch = batches[object.batchIndex];
+
+        vec3 center = (object.transform * vec4(batch.boundingSphere.xyz, 1.0)).xyz;
+        float scale = max(length(object.transform[0].xyz), max(length(object.transform[1].xyz), length(object.transform[2].xyz)));
+        float radius = batch.boundingSphere.w * scale;
+
+        bool visible = true;
+        for (int i = 0; i < 6; i++) {
+            if (dot(uniforms.frustumPlanes[i].xyz, center) + uniforms.frustumPlanes[i].w < -radius) {
+                visible = false;
+            }
+        }
+
+        // Bit 0 is last frame's visibility, the bits above the level of detail
+        uint history = objectVisibility[objectIndex];
+        bool draw = visible;
+#ifdef LATE_PHASE
+        // Clamped, the stored level may be from a mesh with more levels than the current one
+        uint lod = min(history >> 1, batch.lodCount - 1);
+        if (visible) {
+            visible = !is_occluded(center, radius);
+            if (!visible) {
+                atomicAdd(groupOcclusionCulled, 1);
+            }
+        }
+        else {
+            atomicAdd(groupFrustumCulled, 1);
+        }
+        draw = visible && (history & 1) == 0;
+        objectVisibility[objectIndex] = (visible ? 1 : 0) | (lod << 1);
+#else
+        if (uniforms.occlusionCulling != 0) {
+            draw = visible && (history & 1) != 0;
+        }
+        else if (!visible) {
+            atomicAdd(groupFrustumCulled, 1);
+        }
+
+        uint lod = history >> 1;
+        if (visible) {
+            if (uniforms.lodProjectionScale > 0.0 && batch.lodCount > 1) {
+                // The w row of the view projection gives the sphere's nearest view depth
+                float depth = dot(uniforms.depthPlane.xyz, center) + uniforms.depthPlane.w - radius;
+                float projectedRadius = depth > 0.0 ? uniforms.lodProjectionScale * radius / depth : 3.402823e38;
+                lod = select_lod(object.batchIndex, batch.lodCount, lod, projectedRadius);
+            }
+            else {
+                lod = 0;
+            }
+            objectVisibility[objectIndex] = (history & 1) | (lod << 1);
+        }
+#endif
+
+        if (draw) {
+            uint batchIndex = object.batchIndex + lod;
+            uint slot = atomicAdd(batchCounts[batchIndex], 1);
+            visibleInstances[batches[batchIndex].firstInstance + slot] = objectIndex;
+            atomicAdd(groupDrawn, 1);
+            atomicAdd(groupLodDrawn[lod], 1);
+        }
+    }
+    barrier();
+
+    if (gl_LocalInvocationIndex == 0) {
+        atomicAdd(counters.frustumCulled, groupFrustumCulled);
+        atomicAdd(counters.occlusionCulled, groupOcclusionCulled);
+#ifdef LATE_PHASE
+        atomicAdd(counters.drawnLate, groupDrawn);
+#else
+        atomicAdd(counters.drawnEarly, groupDrawn);
+#endif
+        for (uint i = 0; i < MAX_LOD_COUNT; i++) {
+            atomicAdd(counters.lodDrawn[i], groupLodDrawn[i]);
+        }
+    }
+}
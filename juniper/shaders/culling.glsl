@@ -0,0 +1,64 @@
+//======================================================================
+// culling.glsl
+//
+// Keegan Kochis
+// Created: 2026/10/18
+// Bindings shared by the culling passes.
+//======================================================================
+
+#include "scene_data.glsl"
+
+layout(local_size_x = 64) in;
+
+// Match InstancedRenderer.h
+const uint MAX_LOD_COUNT = 8;
+const float LOD_HYSTERESIS = 0.25;
+
+layout(std430, set = 0, binding = 0) readonly buffer ObjectBuffer {
+    ObjectData objects[];
+};
+
+layout(std430, set = 0, binding = 1) readonly buffer BatchBuffer {
+    BatchData batches[];
+};
+
+layout(std430, set = 0, binding = 2) buffer BatchCountBuffer {
+    uint batchCounts[];
+};
+
+layout(std430, set = 0, binding = 3) writeonly buffer VisibleInstanceBuffer {
+    uint visibleInstances[];
+};
+
+layout(std430, set = 0, binding = 4) writeonly buffer DrawCommandBuffer {
+    DrawCommand drawCommands[];
+};
+
+layout(std430, set = 0, binding = 5) buffer DrawCountBuffer {
+    uint drawCounts[];
+};
+
+layout(std430, set = 0, binding = 6) buffer ObjectVisibilityBuffer {
+    uint objectVisibility[];
+};
+
+layout(std430, set = 0, binding = 7) buffer CullCounterBuffer {
+    uint frustumCulled;
+    uint occlusionCulled;
+    uint drawnEarly;
+    uint drawnLate;
+    uint lodDrawn[MAX_LOD_COUNT];
+} counters;
+
+layout(std140, set = 0, binding = 8) uniform CullUniforms {
+    mat4 viewProjection;
+    vec4 frustumPlanes[6];
+    vec4 depthPlane;
+    vec2 pyramidSize;
+    uint objectCount;
+    uint batchCount;
+    uint useDrawCount;
+    uint occlusionCulling;
+    float lodProjectionScale;
+    float lodThreshold;
+} uniforms;
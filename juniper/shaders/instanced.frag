@@ -0,0 +1,21 @@
+#version 450
+
+//======================================================================
+// instanced.frag
+//
+// Keegan Kochis
+// Created: 2026/10/18
+// Fragment shader of the instanced renderer, a single directional light.
+//======================================================================
+
+layout(location = 0) in vec3 fragNormal;
+
+layout(location = 0) out vec4 outColor;
+
+const vec3 lightDirection = normalize(vec3(0.4, 1.0, 0.3));
+const vec3 baseColor = vec3(0.45, 0.62, 0.38);
+
+void main() {
+    float diffuse = max(dot(normalize(fragNormal), lightDirection), 0.0);
+    outColor = vec4(baseColor * (0.2 + 0.8 * diffuse), 1.0);
+}
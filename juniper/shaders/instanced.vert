@@ -0,0 +1,38 @@
+#version 450
+#extension GL_GOOGLE_include_directive : require
+
+//======================================================================
+// instanced.vert
+//
+// Keegan Kochis
+// Created: 2026/10/18
+// Vertex shader of the instanced renderer. Each instance looks up its
+// object through the visible instance buffer written by culling.
+//======================================================================
+
+#include "scene_data.glsl"
+
+layout(location = 0) in vec3 inPosition;
+layout(location = 1) in vec3 inNormal;
+
+layout(std430, set = 0, binding = 0) readonly buffer ObjectBuffer {
+    ObjectData objects[];
+};
+
+layout(std430, set = 0, binding = 1) readonly buffer VisibleInstanceBuffer {
+    uint visibleInstances[];
+};
+
+layout(push_constant) uniform PushConstants {
+    mat4 viewProjection;
+} pushConstants;
+
+layout(location = 0) out vec3 fragNormal;
+
+void main() {
+    // gl_InstanceIndex already includes the firstInstance of the draw
+    mat4 model = objects[visibleInstances[gl_InstanceIndex]].transform;
+
+    gl_Position = pushConstants.viewProjection * model * vec4(inPosition, 1.0);
+    fragNormal = mat3(model) * inNormal;
+}
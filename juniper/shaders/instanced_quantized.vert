@@ -0,0 +1,49 @@
+#version 450
+#extension GL_GOOGLE_include_directive : require
+
+//======================================================================
+// instanced_quantized.vert
+//
+// Keegan Kochis
+// Created: 2026/10/18
+// Vertex shader of the instanced renderer for QuantizedVertex meshes.
+// The object transforms already include the dequantization, so the
+// unorm position is used as it is and only the normal is decoded.
+//======================================================================
+
+#include "scene_data.glsl"
+
+layout(location = 0) in vec4 inPosition;
+layout(location = 1) in vec2 inNormal;
+
+layout(std430, set = 0, binding = 0) readonly buffer ObjectBuffer {
+    ObjectData objects[];
+};
+
+layout(std430, set = 0, binding = 1) readonly buffer VisibleInstanceBuffer {
+    uint visibleInstances[];
+};
+
+layout(push_constant) uniform PushConstants {
+    mat4 viewProjection;
+} pushConstants;
+
+layout(location = 0) out vec3 fragNormal;
+
+// Unfolds the octahedron's lower hemisphere, the inverse of quantize_vertex
+vec3 decode_octahedral(vec2 code) {
+    vec3 normal = vec3(code, 1.0 - abs(code.x) - abs(code.y));
+    float fold = max(-normal.z, 0.0);
+    normal.x += normal.x >= 0.0 ? -fold : fold;
+    normal.y += normal.y >= 0.0 ? -fold : fold;
+    return normal;
+}
+
+void main() {
+    // gl_InstanceIndex already includes the firstInstance of the draw
+    mat4 model = objects[visibleInstances[gl_InstanceIndex]].transform;
+
+    gl_Position = pushConstants.viewProjection * model * vec4(inPosition.xyz, 1.0);
+    // Scaled by the dequantization, the fragment shader normalizes
+    fragNormal = mat3(model) * decode_octahedral(inNormal);
+}
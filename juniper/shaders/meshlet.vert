@@ -0,0 +1,33 @@
+#version 450
+#extension GL_GOOGLE_include_directive : require
+
+//======================================================================
+// meshlet.vert
+//
+// Keegan Kochis
+// Created: 2026/10/18
+// Vertex shader of the meshlet renderer without mesh shaders. Each
+// visible meshlet is its own draw whose firstInstance is the object.
+//======================================================================
+
+#include "meshlet_data.glsl"
+
+layout(location = 0) in vec3 inPosition;
+layout(location = 1) in vec3 inNormal;
+
+layout(std430, set = 0, binding = 0) readonly buffer ObjectBuffer {
+    MeshletObject objects[];
+};
+
+layout(push_constant) uniform PushConstants {
+    mat4 viewProjection;
+} pushConstants;
+
+layout(location = 0) out vec3 fragNormal;
+
+void main() {
+    mat4 model = objects[gl_InstanceIndex].transform;
+
+    gl_Position = pushConstants.viewProjection * model * vec4(inPosition, 1.0);
+    fragNormal = mat3(model) * inNormal;
+}
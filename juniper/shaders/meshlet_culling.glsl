@@ -0,0 +1,53 @@
+//======================================================================
+// meshlet_culling.glsl
+//
+// Keegan Kochis
+// Created: 2026/10/18
+// Bindings and push constants shared by the meshlet culling passes.
+//======================================================================
+
+#include "meshlet_data.glsl"
+#include "scene_data.glsl"
+
+layout(local_size_x = 64) in;
+
+layout(std430, set = 0, binding = 0) readonly buffer MeshletBuffer {
+    MeshletData meshlets[];
+};
+
+layout(std430, set = 0, binding = 1) readonly buffer ObjectBuffer {
+    MeshletObject objects[];
+};
+
+// Object and meshlet index of every visible cluster
+layout(std430, set = 0, binding = 2) writeonly buffer VisibleClusterBuffer {
+    uvec2 visibleClusters[];
+};
+
+layout(std430, set = 0, binding = 3) writeonly buffer DrawCommandBuffer {
+    DrawCommand drawCommands[];
+};
+
+layout(std430, set = 0, binding = 4) buffer CounterBuffer {
+    uint drawCount;
+    uint frustumCulled;
+    uint backfaceCulled;
+} counters;
+
+// Matches VkDrawMeshTasksIndirectCommandNV
+struct TaskCommand {
+    uint taskCount;
+    uint firstTask;
+};
+
+layout(std430, set = 0, binding = 5) writeonly buffer TaskCommandBuffer {
+    TaskCommand taskCommands[];
+};
+
+layout(push_constant) uniform CullPushConstants {
+    vec4 frustumPlanes[6];
+    vec3 cameraPosition;
+    uint objectCount;
+    uint useMeshShaders;
+    uint taskCommandCount;
+} pushConstants;
@@ -0,0 +1,29 @@
+//======================================================================
+// meshlet_data.glsl
+//
+// Keegan Kochis
+// Created: 2026/10/18
+// std430 layouts shared with MeshletRenderer.h.
+//======================================================================
+
+struct MeshletData {
+    vec4 boundingSphere;
+    vec4 cone;
+    uint vertexOffset;
+    uint triangleOffset;
+    uint vertexCount;
+    uint triangleCount;
+    uint firstIndex;
+    uint padding0;
+    uint padding1;
+    uint padding2;
+};
+
+struct MeshletObject {
+    mat4 transform;
+    vec4 boundingSphere;
+    uint firstMeshlet;
+    uint meshletCount;
+    int vertexOffset;
+    uint padding;
+};
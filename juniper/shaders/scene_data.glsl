@@ -0,0 +1,40 @@
+//======================================================================
+// scene_data.glsl
+//
+// Keegan Kochis
+// Created: 2026/10/18
+// std430 layouts shared with InstancedRenderer.h.
+//======================================================================
+
+struct ObjectData {
+    mat4 transform;
+    uint batchIndex;
+    uint padding0;
+    uint padding1;
+    uint padding2;
+};
+
+struct BatchData {
+    vec4 boundingSphere;
+    uint indexCount;
+    uint firstIndex;
+    int vertexOffset;
+    uint firstInstance;
+    uint drawSlot;
+    uint materialSlot;
+    uint materialFirstDraw;
+    uint lodCount;          // Of the mesh, the levels' entries follow level 0's
+    float lodError;         // Relative to the bounding sphere's radius
+    uint padding0;
+    uint padding1;
+    uint padding2;
+};
+
+// Matches VkDrawIndexedIndirectCommand
+struct DrawCommand {
+    uint indexCount;
+    uint instanceCount;
+    uint firstIndex;
+    int vertexOffset;
+    uint firstInstance;
+};
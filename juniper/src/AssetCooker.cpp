@@ -0,0 +1,515 @@
+//======================================================================
+// AssetCooker.cpp
+//
+// Keegan Kochis
+// Created: 2026/10/18
+// The definition of the AssetCooker class.
+//======================================================================
+
+#include "AssetCooker.h"
+#include "BlockCompress.h"
+#include "ContentHash.h"
+#include "GltfImport.h"
+#include "MeshFile.h"
+#include "MeshOptimize.h"
+#include "MeshQuantize.h"
+#include "MeshSimplify.h"
+#include "PackFile.h"
+#include "SceneFile.h"
+#include "Texture.h"
+#include "TextureFile.h"
+#include "TextureImport.h"
+#include "TransformKernels.h"
+
+#include <cctype>
+#include <cstdint>
+#include <cstdlib>
+
+#include <algorithm>
+#include <chrono>
+#include <exception>
+#include <filesystem>
+#include <fstream>
+#include <mutex>
+#include <ostream>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <unordered_map>
+#include <vector>
+
+static double elapsed_ms(std::chrono::high_resolution_clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - start).count();
+}
+
+// Lowercase, with the dot
+static std::string get_extension(const std::string& path) {
+    std::string extension = std::filesystem::path(path).extension().string();
+    std::transform(extension.begin(), extension.end(), extension.begin(),
+                   [](char c) { return static_cast<char>(std::tolower(static_cast<unsigned char>(c))); });
+    return extension;
+}
+
+AssetCooker::AssetCooker() {
+}
+
+//------------------------------------------------------------------------------------------
+//------------------------------------------------------------------------------------------
+void AssetCooker::init(JobSystem* pJobSystem, const std::string& outputDirectory) {
+    mpJobSystem = pJobSystem;
+    mOutputDirectory = outputDirectory;
+    std::filesystem::create_directories(mOutputDirectory);
+    read_manifest();
+    mDatabase.open(mOutputDirectory + "/" + CookDatabase::FILE_NAME);
+    mGraph.init(mpJobSystem, &mDatabase);
+    mGraph.set_incremental(mIncremental);
+}
+
+//------------------------------------------------------------------------------------------
+//------------------------------------------------------------------------------------------
+void AssetCooker::set_incremental(bool incremental) {
+    mIncremental = incremental;
+    mGraph.set_incremental(incremental);
+}
+
+//------------------------------------------------------------------------------------------
+//------------------------------------------------------------------------------------------
+void AssetCooker::cook_gltf(const std::string& path) {
+    mStats = Stats();
+    std::vector<std::string> inputs;
+    std::vector<std::string> outputs;
+    try {
+        cook_gltf_files(path, &inputs, &outputs);
+    }
+    catch (const std::exception&) {
+        write_manifest();
+        throw;
+    }
+    write_manifest();
+}
+
+//------------------------------------------------------------------------------------------
+//------------------------------------------------------------------------------------------
+void AssetCooker::cook_texture(const std::string& path) {
+    mStats = Stats();
+    std::vector<std::string> outputs;
+    cook_texture_file(path, &outputs);
+}
+
+//------------------------------------------------------------------------------------------
+//------------------------------------------------------------------------------------------
+void AssetCooker::cook_directory(const std::string& sourceDirectory) {
+    mStats = Stats();
+    mSourceDirectory = sourceDirectory;
+    while (mSourceDirectory.size() > 1 && mSourceDirectory.back() == '/') {
+        mSourceDirectory.pop_back();
+    }
+    build_graph();
+    try {
+        mGraph.run();
+    }
+    catch (const std::exception&) {
+        write_manifest();
+        throw;
+    }
+    write_manifest();
+}
+
+//------------------------------------------------------------------------------------------
+// A path of an asset that appeared or disappeared changes the graph. So does a directory
+// moved out with assets in it, which is reported as the directory alone.
+//------------------------------------------------------------------------------------------
+void AssetCooker::cook_changes(const std::vector<std::string>& changedPaths) {
+    if (mSourceDirectory.empty()) {
+        throw std::runtime_error("Failed to cook changes, no directory was cooked before!");
+    }
+
+    bool rescan = false;
+    for (const std::string& path : changedPaths) {
+        std::error_code error;
+        const bool exists = std::filesystem::is_regular_file(path, error);
+        if (is_source(path)) {
+            rescan = rescan || exists != (mSources.count(path) > 0);
+        }
+        else if (!exists && !rescan) {
+            const std::string prefix = path + "/";
+            rescan = std::any_of(mSources.begin(), mSources.end(), [&prefix](const std::string& source) {
+                return source.compare(0, prefix.size(), prefix) == 0;
+            });
+        }
+    }
+    if (rescan) {
+        cook_directory(mSourceDirectory);
+        return;
+    }
+
+    mStats = Stats();
+    try {
+        mGraph.run_changed(changedPaths);
+    }
+    catch (const std::exception&) {
+        write_manifest();
+        throw;
+    }
+    write_manifest();
+}
+
+//------------------------------------------------------------------------------------------
+// Each primitive is hashed from the mapped buffers first, only the changed ones are
+// imported and cooked. The format versions go into the hashes so a format change recooks
+// everything. Runs on many threads at once when whole directories cook, so the stats are
+// gathered locally and added up at the end.
+//------------------------------------------------------------------------------------------
+void AssetCooker::cook_gltf_files(const std::string& path, std::vector<std::string>* pInputs,
+                                  std::vector<std::string>* pOutputs) {
+    Stats stats;
+    auto start = std::chrono::high_resolution_clock::now();
+
+    GltfImporter importer;
+    importer.open(path);
+    const std::string name = std::filesystem::path(path).stem().string();
+    for (const std::string& bufferPath : importer.get_buffer_paths()) {
+        pInputs->push_back(std::filesystem::path(bufferPath).lexically_normal().string());
+    }
+    stats.importMs = elapsed_ms(start);
+
+    start = std::chrono::high_resolution_clock::now();
+    const uint32_t primitiveCount = importer.get_primitive_count();
+    std::vector<std::string> meshFiles(primitiveCount);
+    std::vector<uint64_t> hashes(primitiveCount);
+    std::vector<uint8_t> cooked(primitiveCount, 0);
+    std::vector<VertexCacheStats> cacheBefore(primitiveCount);
+    std::vector<VertexCacheStats> cacheAfter(primitiveCount);
+    std::vector<uint32_t> triangleCounts(primitiveCount);
+    std::vector<uint32_t> vertexCounts(primitiveCount);
+    std::vector<uint32_t> lodCounts(primitiveCount);
+    std::vector<uint32_t> lodTriangleCounts(primitiveCount);
+    std::vector<QuantizationError> quantizationErrors(primitiveCount, QuantizationError());
+    std::vector<std::string> errors(primitiveCount);
+
+    // Jobs can't throw across the job system, failures are collected and rethrown after
+    auto cook_primitives = [&](uint32_t begin, uint32_t end) {
+        for (uint32_t i = begin; i < end; i++) {
+            try {
+                meshFiles[i] = name + "_" + std::to_string(i) + ".jmesh";
+                hashes[i] = hash_combine(hash_combine(importer.hash_primitive(i), MeshFile::VERSION), COOK_VERSION);
+                hashes[i] = hash_combine(hashes[i], mVertexFormat);
+                if (is_up_to_date(meshFiles[i], hashes[i])) {
+                    continue;
+                }
+
+                MeshData mesh = importer.import_primitive(i);
+                cacheBefore[i] = analyze_vertex_cache(mesh.indices, static_cast<uint32_t>(mesh.vertices.size()), VERTEX_CACHE_SIZE);
+                optimize_mesh(mesh);
+                triangleCounts[i] = static_cast<uint32_t>(mesh.indices.size() / 3);
+                vertexCounts[i] = static_cast<uint32_t>(mesh.vertices.size());
+                cacheAfter[i] = analyze_vertex_cache(mesh.indices, vertexCounts[i], VERTEX_CACHE_SIZE);
+
+                const std::vector<MeshLodData> lods = generate_lods(mesh);
+                lodCounts[i] = static_cast<uint32_t>(lods.size());
+                lodTriangleCounts[i] = 0;
+                for (const MeshLodData& lod : lods) {
+                    lodTriangleCounts[i] += static_cast<uint32_t>(lod.indices.size() / 3);
+                }
+
+                if (mVertexFormat == VERTEX_FORMAT_QUANTIZED) {
+                    quantizationErrors[i] = measure_quantization_error(mesh, quantize_mesh(mesh));
+                }
+                MeshFile::write(mOutputDirectory + "/" + meshFiles[i], mesh, lods, mVertexFormat);
+                cooked[i] = 1;
+            }
+            catch (const std::exception& e) {
+                errors[i] = e.what();
+            }
+        }
+    };
+    if (mpJobSystem) {
+        mpJobSystem->parallel_for(primitiveCount, 1, cook_primitives);
+    }
+    else {
+        cook_primitives(0, primitiveCount);
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        for (uint32_t i = 0; i < primitiveCount; i++) {
+            if (errors[i].empty()) {
+                mManifest[meshFiles[i]] = hashes[i];
+                mManifestChanged = mManifestChanged || cooked[i];
+            }
+        }
+    }
+    for (uint32_t i = 0; i < primitiveCount; i++) {
+        if (!errors[i].empty()) {
+            continue;
+        }
+        pOutputs->push_back(mOutputDirectory + "/" + meshFiles[i]);
+        if (cooked[i]) {
+            stats.cookedOutputs++;
+            stats.bytesWritten += std::filesystem::file_size(mOutputDirectory + "/" + meshFiles[i]);
+            stats.triangles += triangleCounts[i];
+            stats.vertices += vertexCounts[i];
+            stats.lods += lodCounts[i];
+            stats.lodTriangles += lodTriangleCounts[i];
+            stats.transformedBefore += cacheBefore[i].transformedVertices;
+            stats.transformedAfter += cacheAfter[i].transformedVertices;
+            stats.maxPositionError = std::max(stats.maxPositionError, quantizationErrors[i].relativePositionError);
+            stats.maxNormalDegrees = std::max(stats.maxNormalDegrees, quantizationErrors[i].maxNormalDegrees);
+        }
+        else {
+            stats.skippedOutputs++;
+        }
+    }
+    stats.meshMs = elapsed_ms(start);
+    stats.outputs = primitiveCount;
+
+    auto failed = std::find_if(errors.begin(), errors.end(), [](const std::string& error) { return !error.empty(); });
+    if (failed != errors.end()) {
+        add_stats(stats);
+        throw std::runtime_error(*failed);
+    }
+
+    start = std::chrono::high_resolution_clock::now();
+    const std::string sceneFile = name + ".jscene";
+    const uint64_t sceneHash = hash_combine(hash_combine(importer.hash_scene(), SceneFile::VERSION), COOK_VERSION);
+    if (is_up_to_date(sceneFile, sceneHash)) {
+        stats.skippedOutputs++;
+    }
+    else {
+        SceneFile::write(mOutputDirectory + "/" + sceneFile, importer.import_scene(meshFiles));
+        {
+            std::lock_guard<std::mutex> lock(mMutex);
+            mManifest[sceneFile] = sceneHash;
+            mManifestChanged = true;
+        }
+        stats.cookedOutputs++;
+        stats.bytesWritten += std::filesystem::file_size(mOutputDirectory + "/" + sceneFile);
+    }
+    pOutputs->push_back(mOutputDirectory + "/" + sceneFile);
+    stats.sceneMs = elapsed_ms(start);
+    stats.outputs++;
+    add_stats(stats);
+}
+
+//------------------------------------------------------------------------------------------
+// The mip chain is filtered and every level block compressed on the job system
+//------------------------------------------------------------------------------------------
+void AssetCooker::cook_texture_file(const std::string& path, std::vector<std::string>* pOutputs) {
+    Stats stats;
+    auto start = std::chrono::high_resolution_clock::now();
+
+    const std::string name = std::filesystem::path(path).stem().string();
+    const std::string suffix = NORMAL_MAP_SUFFIX;
+    const bool normalMap = name.size() > suffix.size() && name.compare(name.size() - suffix.size(), suffix.size(), suffix) == 0;
+    const TextureFormat format = normalMap ? TEXTURE_FORMAT_BC5 : TEXTURE_FORMAT_BC7;
+    const TextureUsage usage = normalMap ? TEXTURE_USAGE_NORMAL : TEXTURE_USAGE_COLOR;
+
+    const SimdLevel simdLevel = get_simd_level();
+    const TextureData image = import_tga(path);
+    const std::vector<TextureData> mips = generate_mips(simdLevel, image, usage);
+    std::vector<std::vector<uint8_t>> levels(mips.size());
+    for (size_t i = 0; i < mips.size(); i++) {
+        levels[i].resize(get_texture_level_bytes(format, mips[i].width, mips[i].height));
+        compress_texture(simdLevel, format, mips[i], mpJobSystem, levels[i].data());
+    }
+
+    const std::string output = mOutputDirectory + "/" + name + ".ktx2";
+    TextureFile::write(output, format, usage, image.width, image.height, levels);
+    pOutputs->push_back(output);
+
+    stats.outputs = 1;
+    stats.cookedOutputs = 1;
+    stats.bytesWritten = std::filesystem::file_size(output);
+    stats.textures = 1;
+    stats.textureMs = elapsed_ms(start);
+    add_stats(stats);
+}
+
+//------------------------------------------------------------------------------------------
+// The outputs are packed under their file names
+//------------------------------------------------------------------------------------------
+void AssetCooker::pack_outputs(const std::vector<std::string>& outputs) {
+    std::vector<PackInput> inputs;
+    for (const std::string& output : outputs) {
+        inputs.push_back({ std::filesystem::path(output).filename().string(), output });
+    }
+    PackFile::write(mPackPath, inputs, PACK_COMPRESSION_LZ4, mpJobSystem);
+}
+
+//------------------------------------------------------------------------------------------
+// One step per asset and, when packing, one after all of them. The tool versions cover
+// the formats written and the settings, so changing either recooks the affected steps.
+//------------------------------------------------------------------------------------------
+void AssetCooker::build_graph() {
+    std::vector<std::string> sources;
+    std::error_code error;
+    std::filesystem::recursive_directory_iterator it(mSourceDirectory,
+                                                     std::filesystem::directory_options::skip_permission_denied, error);
+    if (error) {
+        throw std::runtime_error("Failed to cook directory " + mSourceDirectory + ", it can't be read!");
+    }
+    for (std::filesystem::recursive_directory_iterator end; !error && it != end; it.increment(error)) {
+        const std::string path = it->path().string();
+        if (is_source(path) && it->is_regular_file(error)) {
+            sources.push_back(path);
+        }
+    }
+    std::sort(sources.begin(), sources.end());
+
+    mGraph.clean_up();
+    mGraph.init(mpJobSystem, &mDatabase);
+    mSources.clear();
+
+    uint64_t gltfVersion = hash_combine(hash_combine(GltfImporter::VERSION, MeshFile::VERSION), SceneFile::VERSION);
+    gltfVersion = hash_combine(hash_combine(gltfVersion, COOK_VERSION), mVertexFormat);
+    // KTX2 is a fixed standard, so textures only go by the cook version
+    const uint64_t textureVersion = COOK_VERSION;
+
+    // Outputs are named after the asset alone, so two assets of the same name would write
+    // over each other
+    std::unordered_map<std::string, std::string> outputOwners;
+    std::vector<CookStepId> steps;
+    for (const std::string& source : sources) {
+        const std::filesystem::path sourcePath(source);
+        const bool texture = get_extension(source) == ".tga";
+        const std::string output = sourcePath.stem().string() + (texture ? ".ktx2" : ".jscene");
+        auto owner = outputOwners.emplace(output, source);
+        if (!owner.second) {
+            throw std::runtime_error("Failed to cook " + source + ", its outputs would overwrite those of " +
+                                     owner.first->second + "!");
+        }
+
+        const std::string name = source.substr(mSourceDirectory.size() + 1);
+        if (texture) {
+            steps.push_back(mGraph.add_step(name, "texture", textureVersion, { source }, {},
+                [this, source](const std::vector<std::string>&, CookGraph::CookResult* pResult) {
+                    cook_texture_file(source, &pResult->outputs);
+                }));
+        }
+        else {
+            steps.push_back(mGraph.add_step(name, "gltf", gltfVersion, { source }, {},
+                [this, source](const std::vector<std::string>&, CookGraph::CookResult* pResult) {
+                    cook_gltf_files(source, &pResult->inputs, &pResult->outputs);
+                }));
+        }
+        mSources.insert(source);
+    }
+
+    if (!mPackPath.empty()) {
+        mGraph.add_step(mPackPath, "pack", hash_combine(PackFile::VERSION, PACK_COMPRESSION_LZ4), {}, steps,
+            [this](const std::vector<std::string>& inputs, CookGraph::CookResult* pResult) {
+                pack_outputs(inputs);
+                pResult->outputs.push_back(mPackPath);
+            });
+    }
+}
+
+//------------------------------------------------------------------------------------------
+//------------------------------------------------------------------------------------------
+void AssetCooker::print_stats(std::ostream& out) const {
+    out << "Asset cooker stats:\n";
+    out << "\tOutputs: " << mStats.outputs << ", " << mStats.cookedOutputs << " cooked, " << mStats.skippedOutputs
+        << " unchanged\n";
+    out << "\tWritten: " << mStats.bytesWritten / 1024 << " KB\n";
+    if (mStats.triangles > 0) {
+        const double triangles = static_cast<double>(mStats.triangles);
+        const double vertices = static_cast<double>(mStats.vertices);
+        out << "\tVertex cache: ACMR " << mStats.transformedBefore / triangles << " -> " << mStats.transformedAfter / triangles
+            << ", ATVR " << mStats.transformedBefore / vertices << " -> " << mStats.transformedAfter / vertices << '\n';
+        out << "\tLevels of detail: " << mStats.lods << " below level 0, " << mStats.lodTriangles << " triangles on top of "
+            << mStats.triangles << '\n';
+    }
+    if (mVertexFormat == VERTEX_FORMAT_QUANTIZED && mStats.cookedOutputs > 0) {
+        out << "\tQuantization error: " << mStats.maxPositionError << " of the extent, " << mStats.maxNormalDegrees
+            << " degrees\n";
+    }
+    out << "\tImport: " << mStats.importMs << " ms\n";
+    out << "\tMeshes: " << mStats.meshMs << " ms on " << (mpJobSystem ? mpJobSystem->get_thread_count() : 1) << " threads\n";
+    out << "\tScene: " << mStats.sceneMs << " ms\n";
+    if (mStats.textures > 0) {
+        out << "\tTextures: " << mStats.textures << " in " << mStats.textureMs << " ms\n";
+    }
+}
+
+//------------------------------------------------------------------------------------------
+// Times add up over the assets, which may have cooked at the same time
+//------------------------------------------------------------------------------------------
+void AssetCooker::add_stats(const Stats& stats) {
+    std::lock_guard<std::mutex> lock(mMutex);
+    mStats.outputs += stats.outputs;
+    mStats.cookedOutputs += stats.cookedOutputs;
+    mStats.skippedOutputs += stats.skippedOutputs;
+    mStats.bytesWritten += stats.bytesWritten;
+    mStats.triangles += stats.triangles;
+    mStats.vertices += stats.vertices;
+    mStats.transformedBefore += stats.transformedBefore;
+    mStats.transformedAfter += stats.transformedAfter;
+    mStats.lods += stats.lods;
+    mStats.lodTriangles += stats.lodTriangles;
+    mStats.maxPositionError = std::max(mStats.maxPositionError, stats.maxPositionError);
+    mStats.maxNormalDegrees = std::max(mStats.maxNormalDegrees, stats.maxNormalDegrees);
+    mStats.textures += stats.textures;
+    mStats.importMs += stats.importMs;
+    mStats.meshMs += stats.meshMs;
+    mStats.sceneMs += stats.sceneMs;
+    mStats.textureMs += stats.textureMs;
+}
+
+//------------------------------------------------------------------------------------------
+// Called from the cooking jobs, other assets may be adding to the manifest meanwhile
+//------------------------------------------------------------------------------------------
+bool AssetCooker::is_up_to_date(const std::string& name, uint64_t hash) const {
+    if (!mIncremental) {
+        return false;
+    }
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        auto it = mManifest.find(name);
+        if (it == mManifest.end() || it->second != hash) {
+            return false;
+        }
+    }
+    return std::filesystem::exists(mOutputDirectory + "/" + name);
+}
+
+//------------------------------------------------------------------------------------------
+// One "<hash> <file name>" line per output. A missing or unreadable manifest just means
+// everything gets cooked.
+//------------------------------------------------------------------------------------------
+void AssetCooker::read_manifest() {
+    mManifest.clear();
+    mManifestChanged = false;
+    std::ifstream file(mOutputDirectory + "/" + MANIFEST_NAME);
+    std::string hash;
+    std::string name;
+    while (file >> hash >> name) {
+        mManifest[name] = std::strtoull(hash.c_str(), nullptr, 16);
+    }
+}
+
+//------------------------------------------------------------------------------------------
+// Only when an output was cooked since it was last written
+//------------------------------------------------------------------------------------------
+void AssetCooker::write_manifest() {
+    if (!mManifestChanged) {
+        return;
+    }
+    std::vector<std::string> names;
+    for (const auto& entry : mManifest) {
+        names.push_back(entry.first);
+    }
+    std::sort(names.begin(), names.end());
+
+    std::ofstream file(mOutputDirectory + "/" + MANIFEST_NAME, std::ios::trunc);
+    for (const std::string& name : names) {
+        file << hash_to_string(mManifest.at(name)) << ' ' << name << '\n';
+    }
+    mManifestChanged = false;
+}
+
+//------------------------------------------------------------------------------------------
+//------------------------------------------------------------------------------------------
+bool AssetCooker::is_source(const std::string& path) {
+    const std::string extension = get_extension(path);
+    return extension == ".gltf" || extension == ".glb" || extension == ".tga";
+}
@@ -0,0 +1,596 @@
+//======================================================================
+// AsyncReader.cpp
+//
+// Keegan Kochis
+// Created: 2026/10/19
+// The definition of the AsyncReader class.
+//======================================================================
+
+#include "AsyncReader.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#ifdef __linux__
+#include <linux/io_uring.h>
+#include <poll.h>
+#include <sys/eventfd.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#define J_IO_URING 1
+#endif
+
+#include <cstdint>
+#include <cstring>
+
+#include <algorithm>
+#include <stdexcept>
+#include <string>
+#include <utility>
+
+// A single submission reads at most this much, the rest is issued as a short read would be
+static const uint64_t MAX_READ_BYTES = 1ull << 30;
+
+#ifdef J_IO_URING
+// user_data of the poll on the wake eventfd, read handles are never all ones
+static const uint64_t WAKE_USER_DATA = UINT64_MAX;
+
+struct AsyncReader::Uring_t {
+    int fd = -1;
+    void* pSqRing = MAP_FAILED;
+    size_t sqRingBytes = 0;
+    void* pCqRing = MAP_FAILED;
+    size_t cqRingBytes = 0;
+    io_uring_sqe* pSqes = static_cast<io_uring_sqe*>(MAP_FAILED);
+    size_t sqeBytes = 0;
+
+    uint32_t* pSqHead = nullptr;
+    uint32_t* pSqTail = nullptr;
+    uint32_t sqMask = 0;
+    uint32_t* pSqArray = nullptr;
+    uint32_t* pCqHead = nullptr;
+    uint32_t* pCqTail = nullptr;
+    uint32_t cqMask = 0;
+    io_uring_cqe* pCqes = nullptr;
+    uint32_t sqTail = 0;            // Local tail, published once per batch
+
+    // The kernel reads the submission queue concurrently, so the tail is only published once
+    // the entries are written, with release ordering like liburing does
+    io_uring_sqe* next_sqe() {
+        const uint32_t index = sqTail & sqMask;
+        io_uring_sqe* pSqe = &pSqes[index];
+        memset(pSqe, 0, sizeof(io_uring_sqe));
+        pSqArray[index] = index;
+        sqTail++;
+        return pSqe;
+    }
+};
+#else
+struct AsyncReader::Uring_t {
+};
+#endif
+
+AsyncReader::AsyncReader() {
+}
+
+AsyncReader::~AsyncReader() {
+    clean_up();
+}
+
+//------------------------------------------------------------------------------------------
+//------------------------------------------------------------------------------------------
+void AsyncReader::init(ReadBackend backend, uint32_t queueDepth, uint32_t threadCount, JobSystem* pJobSystem) {
+    mQueueDepth = std::max(queueDepth, 1u);
+    mpJobSystem = pJobSystem;
+    mStopping = false;
+    mInFlight = 0;
+    mOutstanding = 0;
+    mStats = Stats();
+
+    mBackend = READ_BACKEND_THREADS;
+    if (backend == READ_BACKEND_URING && setup_uring(mQueueDepth + 1)) {
+        mBackend = READ_BACKEND_URING;
+        mThreads.emplace_back(&AsyncReader::uring_main, this);
+        return;
+    }
+
+    // Blocking reads only overlap across threads, so the pool is as deep as the queue allows
+    threadCount = std::min(std::max(threadCount, 1u), mQueueDepth);
+    for (uint32_t i = 0; i < threadCount; i++) {
+        mThreads.emplace_back(&AsyncReader::reader_main, this);
+    }
+}
+
+//------------------------------------------------------------------------------------------
+//------------------------------------------------------------------------------------------
+void AsyncReader::clean_up() {
+    if (!mThreads.empty()) {
+        stop_threads();
+    }
+    while (!mFiles.empty()) {
+        close_file(mFiles.handle_at(mFiles.size() - 1));
+    }
+}
+
+//------------------------------------------------------------------------------------------
+//------------------------------------------------------------------------------------------
+void AsyncReader::stop_threads() {
+    std::vector<ReadHandle> handles;
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        mStopping = true;
+        for (size_t i = 0; i < mRequests.size(); i++) {
+            handles.push_back(mRequests.handle_at(i));
+        }
+    }
+    for (ReadHandle handle : handles) {
+        cancel(handle);
+    }
+    wait_idle();
+
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        mRequestAvailable.notify_all();
+    }
+    wake();
+    for (std::thread& thread : mThreads) {
+        thread.join();
+    }
+    mThreads.clear();
+    destroy_uring();
+}
+
+//------------------------------------------------------------------------------------------
+// File systems without O_DIRECT support refuse the flag with EINVAL, those files are read
+// through the page cache instead
+//------------------------------------------------------------------------------------------
+ReadFileHandle AsyncReader::open_file(const std::string& path, bool direct) {
+    int fd = -1;
+#ifdef O_DIRECT
+    if (direct) {
+        fd = ::open(path.c_str(), O_RDONLY | O_DIRECT);
+        if (fd < 0 && errno != EINVAL) {
+            throw std::runtime_error("Failed to open file " + path + "!");
+        }
+    }
+#endif
+    direct = fd >= 0;
+    if (fd < 0) {
+        fd = ::open(path.c_str(), O_RDONLY);
+    }
+    if (fd < 0) {
+        throw std::runtime_error("Failed to open file " + path + "!");
+    }
+
+    struct stat status;
+    if (fstat(fd, &status) != 0) {
+        ::close(fd);
+        throw std::runtime_error("Failed to read the size of file " + path + "!");
+    }
+
+    std::lock_guard<std::mutex> lock(mMutex);
+    return mFiles.add({ fd, static_cast<uint64_t>(status.st_size), direct });
+}
+
+//------------------------------------------------------------------------------------------
+//------------------------------------------------------------------------------------------
+void AsyncReader::close_file(ReadFileHandle file) {
+    std::lock_guard<std::mutex> lock(mMutex);
+    ::close(mFiles.get<0>(file).fd);
+    mFiles.remove(file);
+}
+
+//------------------------------------------------------------------------------------------
+//------------------------------------------------------------------------------------------
+bool AsyncReader::is_direct(ReadFileHandle file) const {
+    std::lock_guard<std::mutex> lock(mMutex);
+    return mFiles.get<0>(file).direct;
+}
+
+//------------------------------------------------------------------------------------------
+//------------------------------------------------------------------------------------------
+uint64_t AsyncReader::get_file_size(ReadFileHandle file) const {
+    std::lock_guard<std::mutex> lock(mMutex);
+    return mFiles.get<0>(file).size;
+}
+
+//------------------------------------------------------------------------------------------
+// Ranges are clamped to the file size here, so reaching the end of the file is the same as
+// finishing the read. Direct reads keep an aligned length, the kernel refuses the read of
+// a file's unaligned tail and stops at the end of the file on its own.
+//------------------------------------------------------------------------------------------
+ReadHandle AsyncReader::read(ReadFileHandle file, uint64_t offset, uint64_t bytes, void* pDestination,
+                             ReadPriority priority, Callback callback) {
+    ReadHandle handle;
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        if (mStopping) {
+            throw std::runtime_error("Failed to queue read, the reader is shutting down!");
+        }
+        const OpenFile& openFile = mFiles.get<0>(file);
+        if (openFile.direct && (offset % DIRECT_ALIGNMENT != 0 || bytes % DIRECT_ALIGNMENT != 0 ||
+                                reinterpret_cast<uintptr_t>(pDestination) % DIRECT_ALIGNMENT != 0)) {
+            throw std::runtime_error("Failed to queue read, direct reads need " + std::to_string(DIRECT_ALIGNMENT) +
+                                     " byte alignment!");
+        }
+        uint64_t readBytes = offset < openFile.size ? openFile.size - offset : 0;
+        if (openFile.direct) {
+            readBytes = (readBytes + DIRECT_ALIGNMENT - 1) / DIRECT_ALIGNMENT * DIRECT_ALIGNMENT;
+        }
+        readBytes = std::min(bytes, readBytes);
+
+        handle = mRequests.add({ openFile.fd, openFile.size, offset, readBytes, 0, static_cast<uint8_t*>(pDestination),
+                                 std::move(callback), false });
+        mQueues[priority].push_back(handle);
+        mOutstanding++;
+        mStats.requests++;
+        mRequestAvailable.notify_one();
+    }
+    wake();
+    return handle;
+}
+
+//------------------------------------------------------------------------------------------
+//------------------------------------------------------------------------------------------
+bool AsyncReader::cancel(ReadHandle handle) {
+    Callback callback;
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        if (!mRequests.contains(handle) || mRequests.get<0>(handle).issued) {
+            return false;
+        }
+        callback = std::move(mRequests.get<0>(handle).callback);
+        mRequests.remove(handle);
+        mStats.canceled++;
+    }
+    dispatch(callback, READ_STATUS_CANCELED, 0);
+    return true;
+}
+
+//------------------------------------------------------------------------------------------
+//------------------------------------------------------------------------------------------
+void AsyncReader::wait_idle() {
+    {
+        std::unique_lock<std::mutex> lock(mMutex);
+        mIdle.wait(lock, [this]() { return mOutstanding == 0; });
+    }
+    if (mpJobSystem) {
+        mpJobSystem->wait(mCallbacks);
+    }
+}
+
+//------------------------------------------------------------------------------------------
+//------------------------------------------------------------------------------------------
+AsyncReader::Stats AsyncReader::get_stats() const {
+    std::lock_guard<std::mutex> lock(mMutex);
+    return mStats;
+}
+
+//------------------------------------------------------------------------------------------
+//------------------------------------------------------------------------------------------
+void AsyncReader::print_stats(std::ostream& out) const {
+    const Stats stats = get_stats();
+    out << "Async reader stats:\n";
+    out << "\tBackend: " << (mBackend == READ_BACKEND_URING ? "io_uring" : "thread pool") << '\n';
+    out << "\tRequests: " << stats.requests << '\n';
+    out << "\tCompleted: " << stats.completed << '\n';
+    out << "\tCanceled: " << stats.canceled << '\n';
+    out << "\tFailed: " << stats.failed << '\n';
+    out << "\tRead: " << stats.bytesRead / 1024 << " KB\n";
+    out << "\tReads per system call: " << (stats.systemCalls > 0 ? double(stats.issued) / stats.systemCalls : 0.0) << '\n';
+    out << "\tMax in flight: " << stats.maxInFlight << '\n';
+}
+
+//------------------------------------------------------------------------------------------
+// Maps the rings the way io_uring_queue_init does, without depending on liburing. The
+// eventfd wakes the I/O thread out of io_uring_enter when reads are queued.
+//------------------------------------------------------------------------------------------
+bool AsyncReader::setup_uring(uint32_t entries) {
+#ifdef J_IO_URING
+    io_uring_params params;
+    memset(&params, 0, sizeof(params));
+    const int fd = static_cast<int>(syscall(__NR_io_uring_setup, entries, &params));
+    if (fd < 0) {
+        return false;
+    }
+    mpUring = std::make_unique<Uring_t>();
+    Uring_t& uring = *mpUring;
+    uring.fd = fd;
+
+    uring.sqRingBytes = params.sq_off.array + params.sq_entries * sizeof(uint32_t);
+    uring.cqRingBytes = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+    if (params.features & IORING_FEAT_SINGLE_MMAP) {
+        uring.sqRingBytes = std::max(uring.sqRingBytes, uring.cqRingBytes);
+    }
+    uring.pSqRing = mmap(nullptr, uring.sqRingBytes, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd,
+                         IORING_OFF_SQ_RING);
+    if (uring.pSqRing == MAP_FAILED) {
+        destroy_uring();
+        return false;
+    }
+    if (params.features & IORING_FEAT_SINGLE_MMAP) {
+        uring.pCqRing = uring.pSqRing;
+    }
+    else {
+        uring.pCqRing = mmap(nullptr, uring.cqRingBytes, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd,
+                             IORING_OFF_CQ_RING);
+        if (uring.pCqRing == MAP_FAILED) {
+            destroy_uring();
+            return false;
+        }
+    }
+    uring.sqeBytes = params.sq_entries * sizeof(io_uring_sqe);
+    uring.pSqes = static_cast<io_uring_sqe*>(mmap(nullptr, uring.sqeBytes, PROT_READ | PROT_WRITE,
+                                                  MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_SQES));
+    if (uring.pSqes == MAP_FAILED) {
+        destroy_uring();
+        return false;
+    }
+
+    uint8_t* pSqRing = static_cast<uint8_t*>(uring.pSqRing);
+    uint8_t* pCqRing = static_cast<uint8_t*>(uring.pCqRing);
+    uring.pSqHead = reinterpret_cast<uint32_t*>(pSqRing + params.sq_off.head);
+    uring.pSqTail = reinterpret_cast<uint32_t*>(pSqRing + params.sq_off.tail);
+    uring.sqMask = *reinterpret_cast<uint32_t*>(pSqRing + params.sq_off.ring_mask);
+    uring.pSqArray = reinterpret_cast<uint32_t*>(pSqRing + params.sq_off.array);
+    uring.pCqHead = reinterpret_cast<uint32_t*>(pCqRing + params.cq_off.head);
+    uring.pCqTail = reinterpret_cast<uint32_t*>(pCqRing + params.cq_off.tail);
+    uring.cqMask = *reinterpret_cast<uint32_t*>(pCqRing + params.cq_off.ring_mask);
+    uring.pCqes = reinterpret_cast<io_uring_cqe*>(pCqRing + params.cq_off.cqes);
+    uring.sqTail = *uring.pSqTail;
+
+    mWakeFd = eventfd(0, EFD_CLOEXEC);
+    if (mWakeFd < 0) {
+        destroy_uring();
+        return false;
+    }
+    mWakePending.store(false);
+    return true;
+#else
+    (void)entries;
+    return false;
+#endif
+}
+
+//------------------------------------------------------------------------------------------
+//------------------------------------------------------------------------------------------
+void AsyncReader::destroy_uring() {
+#ifdef J_IO_URING
+    if (mpUring) {
+        Uring_t& uring = *mpUring;
+        if (uring.pSqes != MAP_FAILED) {
+            munmap(uring.pSqes, uring.sqeBytes);
+        }
+        if (uring.pCqRing != MAP_FAILED && uring.pCqRing != uring.pSqRing) {
+            munmap(uring.pCqRing, uring.cqRingBytes);
+        }
+        if (uring.pSqRing != MAP_FAILED) {
+            munmap(uring.pSqRing, uring.sqRingBytes);
+        }
+        ::close(uring.fd);
+        mpUring.reset();
+    }
+    if (mWakeFd >= 0) {
+        ::close(mWakeFd);
+        mWakeFd = -1;
+    }
+#endif
+}
+
+//------------------------------------------------------------------------------------------
+// Each pass fills the submission queue up to the queue depth, then one io_uring_enter
+// submits the batch and sleeps until something completes. A poll on the eventfd is always
+// in flight, so queuing a read or shutting down ends the sleep.
+//------------------------------------------------------------------------------------------
+void AsyncReader::uring_main() {
+#ifdef J_IO_URING
+    Uring_t& uring = *mpUring;
+    std::vector<IssuedRead> retries;
+    bool armWake = true;
+
+    while (true) {
+        uint32_t queued = 0;
+        if (armWake) {
+            io_uring_sqe* pSqe = uring.next_sqe();
+            pSqe->opcode = IORING_OP_POLL_ADD;
+            pSqe->fd = mWakeFd;
+            pSqe->poll_events = POLLIN;
+            pSqe->user_data = WAKE_USER_DATA;
+            armWake = false;
+            queued++;
+        }
+
+        std::vector<IssuedRead> reads = std::move(retries);
+        retries.clear();
+        {
+            std::lock_guard<std::mutex> lock(mMutex);
+            if (mStopping && mInFlight == 0) {
+                break;
+            }
+            IssuedRead read;
+            while (mInFlight < mQueueDepth && take_next(&read)) {
+                reads.push_back(read);
+            }
+            mStats.systemCalls++;
+        }
+        for (const IssuedRead& read : reads) {
+            io_uring_sqe* pSqe = uring.next_sqe();
+            pSqe->opcode = IORING_OP_READ;
+            pSqe->fd = read.fd;
+            pSqe->off = read.offset;
+            pSqe->addr = reinterpret_cast<uint64_t>(read.pDestination);
+            pSqe->len = static_cast<uint32_t>(std::min(read.bytes, MAX_READ_BYTES));
+            pSqe->user_data = read.handle.value();
+            queued++;
+        }
+        __atomic_store_n(uring.pSqTail, uring.sqTail, __ATOMIC_RELEASE);
+
+        const int result = static_cast<int>(syscall(__NR_io_uring_enter, uring.fd, queued, 1,
+                                                    IORING_ENTER_GETEVENTS, nullptr, 0));
+        if (result < 0 && errno != EINTR) {
+            throw std::runtime_error("Failed to submit reads to the io_uring!");
+        }
+
+        uint32_t head = *uring.pCqHead;
+        const uint32_t tail = __atomic_load_n(uring.pCqTail, __ATOMIC_ACQUIRE);
+        for (; head != tail; head++) {
+            const io_uring_cqe cqe = uring.pCqes[head & uring.cqMask];
+            if (cqe.user_data == WAKE_USER_DATA) {
+                mWakePending.store(false);
+                uint64_t value;
+                ssize_t drained = ::read(mWakeFd, &value, sizeof(value));
+                (void)drained;
+                armWake = true;
+                continue;
+            }
+
+            IssuedRead read;
+            read.handle = ReadHandle::from_value(static_cast<uint32_t>(cqe.user_data));
+            {
+                std::lock_guard<std::mutex> lock(mMutex);
+                const ReadRequest& request = mRequests.get<0>(read.handle);
+                read.fd = request.fd;
+                read.offset = request.offset + request.done;
+                read.bytes = request.bytes - request.done;
+                read.pDestination = request.pDestination + request.done;
+            }
+            IssuedRead next;
+            if (finish_read(read, cqe.res, &next)) {
+                retries.push_back(next);
+            }
+        }
+        __atomic_store_n(uring.pCqHead, head, __ATOMIC_RELEASE);
+    }
+#endif
+}
+
+//------------------------------------------------------------------------------------------
+//------------------------------------------------------------------------------------------
+void AsyncReader::reader_main() {
+    while (true) {
+        IssuedRead read;
+        {
+            std::unique_lock<std::mutex> lock(mMutex);
+            mRequestAvailable.wait(lock, [this, &read]() { return mStopping || take_next(&read); });
+            if (read.handle.is_null()) {
+                return;
+            }
+        }
+
+        while (true) {
+            const ssize_t result = pread(read.fd, read.pDestination, std::min(read.bytes, MAX_READ_BYTES),
+                                         static_cast<off_t>(read.offset));
+            {
+                std::lock_guard<std::mutex> lock(mMutex);
+                mStats.systemCalls++;
+            }
+            IssuedRead next;
+            if (!finish_read(read, result < 0 ? -errno : result, &next)) {
+                break;
+            }
+            read = next;
+        }
+    }
+}
+
+//------------------------------------------------------------------------------------------
+// Only the first read queued while the I/O thread is busy writes the eventfd, the rest
+// are picked up by the same wake
+//------------------------------------------------------------------------------------------
+void AsyncReader::wake() {
+    if (mWakeFd < 0 || mWakePending.exchange(true)) {
+        return;
+    }
+    const uint64_t value = 1;
+    ssize_t written = ::write(mWakeFd, &value, sizeof(value));
+    (void)written;
+}
+
+//------------------------------------------------------------------------------------------
+//------------------------------------------------------------------------------------------
+bool AsyncReader::take_next(IssuedRead* pRead) {
+    for (std::deque<ReadHandle>& queue : mQueues) {
+        while (!queue.empty()) {
+            const ReadHandle handle = queue.front();
+            queue.pop_front();
+            if (!mRequests.contains(handle)) {
+                continue;
+            }
+            ReadRequest& request = mRequests.get<0>(handle);
+            request.issued = true;
+            *pRead = { handle, request.fd, request.offset, request.bytes, request.pDestination };
+            mInFlight++;
+            mStats.issued++;
+            mStats.maxInFlight = std::max(mStats.maxInFlight, mInFlight);
+            return true;
+        }
+    }
+    return false;
+}
+
+//------------------------------------------------------------------------------------------
+// Interrupted reads are issued again as they were, short ones for the bytes still missing.
+// A read of zero bytes means the file ended early, and a short read reaching the end of the
+// file is the tail of a direct read, both finish the read. Only the bytes inside the file
+// are reported.
+//------------------------------------------------------------------------------------------
+bool AsyncReader::finish_read(const IssuedRead& read, int64_t result, IssuedRead* pNext) {
+    Callback callback;
+    ReadStatus status;
+    uint64_t bytes;
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        if (result == -EINTR || result == -EAGAIN) {
+            *pNext = read;
+            mStats.issued++;
+            return true;
+        }
+        ReadRequest& request = mRequests.get<0>(read.handle);
+        if (result > 0) {
+            request.done += static_cast<uint64_t>(result);
+            mStats.bytesRead += static_cast<uint64_t>(result);
+            if (request.done < request.bytes && request.offset + request.done < request.fileSize) {
+                *pNext = { read.handle, request.fd, request.offset + request.done, request.bytes - request.done,
+                           request.pDestination + request.done };
+                mStats.issued++;
+                return true;
+            }
+        }
+        status = result < 0 ? READ_STATUS_FAILED : READ_STATUS_DONE;
+        bytes = request.offset < request.fileSize ? std::min(request.done, request.fileSize - request.offset) : 0;
+        callback = std::move(request.callback);
+        mRequests.remove(read.handle);
+        mInFlight--;
+        if (status == READ_STATUS_DONE) {
+            mStats.completed++;
+        }
+        else {
+            mStats.failed++;
+        }
+    }
+    dispatch(callback, status, bytes);
+    return false;
+}
+
+//------------------------------------------------------------------------------------------
+// A read only stops counting as outstanding once its callback is queued, so wait_idle()
+// can't return between the two
+//------------------------------------------------------------------------------------------
+void AsyncReader::dispatch(Callback& callback, ReadStatus status, uint64_t bytes) {
+    if (callback) {
+        if (mpJobSystem) {
+            mpJobSystem->submit(mCallbacks, [callback, status, bytes]() { callback(status, bytes); });
+        }
+        else {
+            callback(status, bytes);
+        }
+    }
+
+    std::lock_guard<std::mutex> lock(mMutex);
+    mOutstanding--;
+    if (mOutstanding == 0) {
+        mIdle.notify_all();
+    }
+}
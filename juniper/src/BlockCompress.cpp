@@ -0,0 +1,1005 @@
+//======================================================================
+// BlockCompress.cpp
+//
+// Keegan Kochis
+// Created: 2026/10/18
+// Block compression of texture levels. A block's texels are loaded as
+// four channels of 16 floats, so the SSE kernels work on 4 texels and
+// the AVX2 kernels on 8 texels of one channel per register. Endpoint
+// fitting and bit packing are scalar, they only touch a few values.
+//======================================================================
+
+#include "BlockCompress.h"
+
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+
+#include <algorithm>
+#include <stdexcept>
+#include <string>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__SSE2__) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define J_SIMD_X86 1
+#include <immintrin.h>
+#else
+#define J_SIMD_X86 0
+#endif
+
+// The AVX2 kernels are built regardless of the compiler flags and only picked when the CPU has them
+#if defined(__GNUC__) || defined(__clang__)
+#define J_TARGET_AVX2 __attribute__((target("avx2,fma")))
+#else
+#define J_TARGET_AVX2
+#endif
+
+static const uint32_t BLOCK_TEXELS = TEXTURE_BLOCK_SIZE * TEXTURE_BLOCK_SIZE;
+// Rows of blocks per job
+static const uint32_t ROWS_PER_JOB = 4;
+// Interpolation weights of 4 bit BC7 indices, in 64ths
+static const uint32_t BC7_WEIGHTS[16] = { 0, 4, 9, 13, 17, 21, 26, 30, 34, 38, 43, 47, 51, 55, 60, 64 };
+// The same as fractions, and the weights of BC1's four colors
+static const float BC7_STEP_WEIGHTS[16] = {
+    0.0f, 4.0f / 64, 9.0f / 64, 13.0f / 64, 17.0f / 64, 21.0f / 64, 26.0f / 64, 30.0f / 64,
+    34.0f / 64, 38.0f / 64, 43.0f / 64, 47.0f / 64, 51.0f / 64, 55.0f / 64, 60.0f / 64, 1.0f
+};
+static const float BC1_STEP_WEIGHTS[4] = { 0.0f, 1.0f / 3.0f, 2.0f / 3.0f, 1.0f };
+// From the position along the endpoints to the index encoding it
+static const uint8_t BC1_INDEX_OF_STEP[4] = { 0, 2, 3, 1 };
+static const uint8_t BC4_INDEX_OF_STEP[8] = { 0, 2, 3, 4, 5, 6, 7, 1 };
+
+// One block's texels by channel, values in [0, 255]
+struct Block_t {
+    alignas(32) float channels[4][BLOCK_TEXELS];
+}; typedef Block_t Block;
+
+// The vectorized parts of the encoders, picked once per level
+struct BlockKernels_t {
+    // Covariance in the order 00, 01, 02, 03, 11, 12, 13, 22, 23, 33
+    void (*statistics)(const Block& block, float* pMean, float* pCovariance);
+    // Range of dot(texel - origin, axis) over the block
+    void (*extent)(const Block& block, const float* pOrigin, const float* pAxis, float* pMin, float* pMax);
+    // Rounds dot(texel - origin, axis) and clamps it to [0, steps]
+    void (*project)(const Block& block, const float* pOrigin, const float* pAxis, float steps, uint8_t* pSteps);
+    // Squared error of the first channelCount channels against the endpoints blended by each
+    // texel's weight
+    float (*error)(const Block& block, uint32_t channelCount, const float* pEndpoint0, const float* pEndpoint1,
+                   const float* pTexelWeights);
+    // Least squares sums with the weights b and a = 1 - b: aa, ab, bb, then a * texel and
+    // b * texel for each channel
+    void (*refit_sums)(const Block& block, const float* pTexelWeights, float* pSums);
+}; typedef BlockKernels_t BlockKernels;
+
+// Packs fields from the lowest bit up
+struct BitWriter_t {
+    uint64_t words[2] = { 0, 0 };
+    uint32_t position = 0;
+
+    void write(uint32_t value, uint32_t bits) {
+        const uint64_t field = value & ((1ull << bits) - 1);
+        const uint32_t shift = position % 64;
+        words[position / 64] |= field << shift;
+        if (shift + bits > 64) {
+            words[position / 64 + 1] |= field >> (64 - shift);
+        }
+        position += bits;
+    }
+}; typedef BitWriter_t BitWriter;
+
+//------------------------------------------------------------------------------------------
+//------------------------------------------------------------------------------------------
+static uint32_t read_bits(const uint64_t* pWords, uint32_t position, uint32_t bits) {
+    uint32_t value = 0;
+    for (uint32_t i = 0; i < bits; i++, position++) {
+        value |= static_cast<uint32_t>((pWords[position / 64] >> (position % 64)) & 1) << i;
+    }
+    return value;
+}
+
+//------------------------------------------------------------------------------------------
+// Scalar kernels
+//------------------------------------------------------------------------------------------
+static void block_statistics_scalar(const Block& block, float* pMean, float* pCovariance) {
+    for (uint32_t c = 0; c < 4; c++) {
+        float sum = 0.0f;
+        for (uint32_t i = 0; i < BLOCK_TEXELS; i++) {
+            sum += block.channels[c][i];
+        }
+        pMean[c] = sum / BLOCK_TEXELS;
+    }
+
+    uint32_t entry = 0;
+    for (uint32_t a = 0; a < 4; a++) {
+        for (uint32_t b = a; b < 4; b++) {
+            float sum = 0.0f;
+            for (uint32_t i = 0; i < BLOCK_TEXELS; i++) {
+                sum += (block.channels[a][i] - pMean[a]) * (block.channels[b][i] - pMean[b]);
+            }
+            pCovariance[entry++] = sum;
+        }
+    }
+}
+
+//------------------------------------------------------------------------------------------
+//------------------------------------------------------------------------------------------
+static float project_texel(const Block& block, uint32_t i, const float* pOrigin, const float* pAxis) {
+    return (block.channels[0][i] - pOrigin[0]) * pAxis[0] + (block.channels[1][i] - pOrigin[1]) * pAxis[1] +
+           (block.channels[2][i] - pOrigin[2]) * pAxis[2] + (block.channels[3][i] - pOrigin[3]) * pAxis[3];
+}
+
+//------------------------------------------------------------------------------------------
+//------------------------------------------------------------------------------------------
+static void block_extent_scalar(const Block& block, const float* pOrigin, const float* pAxis, float* pMin, float* pMax) {
+    *pMin = *pMax = project_texel(block, 0, pOrigin, pAxis);
+    for (uint32_t i = 1; i < BLOCK_TEXELS; i++) {
+        const float t = project_texel(block, i, pOrigin, pAxis);
+        *pMin = std::min(*pMin, t);
+        *pMax = std::max(*pMax, t);
+    }
+}
+
+//------------------------------------------------------------------------------------------
+//------------------------------------------------------------------------------------------
+static void block_project_scalar(const Block& block, const float* pOrigin, const float* pAxis, float steps, uint8_t* pSteps) {
+    for (uint32_t i = 0; i < BLOCK_TEXELS; i++) {
+        const float t = std::min(std::max(project_texel(block, i, pOrigin, pAxis), 0.0f), steps);
+        pSteps[i] = static_cast<uint8_t>(std::nearbyint(t));
+    }
+}
+
+//------------------------------------------------------------------------------------------
+//------------------------------------------------------------------------------------------
+static float block_error_scalar(const Block& block, uint32_t channelCount, const float* pEndpoint0, const float* pEndpoint1,
+                                const float* pTexelWeights) {
+    float error = 0.0f;
+    for (uint32_t c = 0; c < channelCount; c++) {
+        const float delta = pEndpoint1[c] - pEndpoint0[c];
+        for (uint32_t i = 0; i < BLOCK_TEXELS; i++) {
+            const float difference = block.channels[c][i] - (pEndpoint0[c] + delta * pTexelWeights[i]);
+            error += difference * difference;
+        }
+    }
+    return error;
+}
+
+//------------------------------------------------------------------------------------------
+//------------------------------------------------------------------------------------------
+static void block_refit_sums_scalar(const Block& block, const float* pTexelWeights, float* pSums) {
+    memset(pSums, 0, 11 * sizeof(float));
+    for (uint32_t i = 0; i < BLOCK_TEXELS; i++) {
+        const float b = pTexelWeights[i];
+        const float a = 1.0f - b;
+        pSums[0] += a * a;
+        pSums[1] += a * b;
+        pSums[2] += b * b;
+        for (uint32_t c = 0; c < 4; c++) {
+            pSums[3 + c] += a * block.channels[c][i];
+            pSums[7 + c] += b * block.channels[c][i];
+        }
+    }
+}
+
+#if J_SIMD_X86
+//------------------------------------------------------------------------------------------
+// SSE kernels, 4 texels at a time
+//------------------------------------------------------------------------------------------
+static inline float horizontal_sum_sse(__m128 value) {
+    __m128 shuffled = _mm_shuffle_ps(value, value, _MM_SHUFFLE(2, 3, 0, 1));
+    __m128 sums = _mm_add_ps(value, shuffled);
+    shuffled = _mm_movehl_ps(shuffled, sums);
+    return _mm_cvtss_f32(_mm_add_ss(sums, shuffled));
+}
+
+//------------------------------------------------------------------------------------------
+//------------------------------------------------------------------------------------------
+static inline __m128 project_sse(const Block& block, uint32_t first, const __m128* pOrigin, const __m128* pAxis) {
+    __m128 t = _mm_mul_ps(_mm_sub_ps(_mm_load_ps(&block.channels[0][first]), pOrigin[0]), pAxis[0]);
+    for (uint32_t c = 1; c < 4; c++) {
+        t = _mm_add_ps(t, _mm_mul_ps(_mm_sub_ps(_mm_load_ps(&block.channels[c][first]), pOrigin[c]), pAxis[c]));
+    }
+    return t;
+}
+
+//------------------------------------------------------------------------------------------
+//------------------------------------------------------------------------------------------
+static void block_statistics_sse(const Block& block, float* pMean, float* pCovariance) {
+    __m128 mean[4];
+    for (uint32_t c = 0; c < 4; c++) {
+        __m128 sum = _mm_load_ps(&block.channels[c][0]);
+        for (uint32_t i = 4; i < BLOCK_TEXELS; i += 4) {
+            sum = _mm_add_ps(sum, _mm_load_ps(&block.channels[c][i]));
+        }
+        pMean[c] = horizontal_sum_sse(sum) / BLOCK_TEXELS;
+        mean[c] = _mm_set1_ps(pMean[c]);
+    }
+
+    __m128 sums[10];
+    for (uint32_t entry = 0; entry < 10; entry++) {
+        sums[entry] = _mm_setzero_ps();
+    }
+    for (uint32_t i = 0; i < BLOCK_TEXELS; i += 4) {
+        __m128 centered[4];
+        for (uint32_t c = 0; c < 4; c++) {
+            centered[c] = _mm_sub_ps(_mm_load_ps(&block.channels[c][i]), mean[c]);
+        }
+        uint32_t entry = 0;
+        for (uint32_t a = 0; a < 4; a++) {
+            for (uint32_t b = a; b < 4; b++) {
+                sums[entry] = _mm_add_ps(sums[entry], _mm_mul_ps(centered[a], centered[b]));
+                entry++;
+            }
+        }
+    }
+    for (uint32_t entry = 0; entry < 10; entry++) {
+        pCovariance[entry] = horizontal_sum_sse(sums[entry]);
+    }
+}
+
+//------------------------------------------------------------------------------------------
+//------------------------------------------------------------------------------------------
+static void block_extent_sse(const Block& block, const float* pOrigin, const float* pAxis, float* pMin, float* pMax) {
+    __m128 origin[4];
+    __m128 axis[4];
+    for (uint32_t c = 0; c < 4; c++) {
+        origin[c] = _mm_set1_ps(pOrigin[c]);
+        axis[c] = _mm_set1_ps(pAxis[c]);
+    }
+
+    __m128 minimum = project_sse(block, 0, origin, axis);
+    __m128 maximum = minimum;
+    for (uint32_t i = 4; i < BLOCK_TEXELS; i += 4) {
+        const __m128 t = project_sse(block, i, origin, axis);
+        minimum = _mm_min_ps(minimum, t);
+        maximum = _mm_max_ps(maximum, t);
+    }
+    minimum = _mm_min_ps(minimum, _mm_shuffle_ps(minimum, minimum, _MM_SHUFFLE(2, 3, 0, 1)));
+    minimum = _mm_min_ps(minimum, _mm_movehl_ps(minimum, minimum));
+    maximum = _mm_max_ps(maximum, _mm_shuffle_ps(maximum, maximum, _MM_SHUFFLE(2, 3, 0, 1)));
+    maximum = _mm_max_ps(maximum, _mm_movehl_ps(maximum, maximum));
+    *pMin = _mm_cvtss_f32(minimum);
+    *pMax = _mm_cvtss_f32(maximum);
+}
+
+//------------------------------------------------------------------------------------------
+//------------------------------------------------------------------------------------------
+static void block_project_sse(const Block& block, const float* pOrigin, const float* pAxis, float steps, uint8_t* pSteps) {
+    __m128 origin[4];
+    __m128 axis[4];
+    for (uint32_t c = 0; c < 4; c++) {
+        origin[c] = _mm_set1_ps(pOrigin[c]);
+        axis[c] = _mm_set1_ps(pAxis[c]);
+    }
+
+    const __m128 zero = _mm_setzero_ps();
+    const __m128 last = _mm_set1_ps(steps);
+    for (uint32_t i = 0; i < BLOCK_TEXELS; i += 4) {
+        const __m128 t = _mm_min_ps(_mm_max_ps(project_sse(block, i, origin, axis), zero), last);
+        // Round to nearest, then narrow to bytes
+        const __m128i words = _mm_packs_epi32(_mm_cvtps_epi32(t), _mm_setzero_si128());
+        const int32_t bytes = _mm_cvtsi128_si32(_mm_packus_epi16(words, words));
+        memcpy(pSteps + i, &bytes, sizeof(bytes));
+    }
+}
+
+//------------------------------------------------------------------------------------------
+//------------------------------------------------------------------------------------------
+static float block_error_sse(const Block& block, uint32_t channelCount, const float* pEndpoint0, const float* pEndpoint1,
+                             const float* pTexelWeights) {
+    __m128 sum = _mm_setzero_ps();
+    for (uint32_t c = 0; c < channelCount; c++) {
+        const __m128 endpoint0 = _mm_set1_ps(pEndpoint0[c]);
+        const __m128 delta = _mm_set1_ps(pEndpoint1[c] - pEndpoint0[c]);
+        for (uint32_t i = 0; i < BLOCK_TEXELS; i += 4) {
+            const __m128 blended = _mm_add_ps(endpoint0, _mm_mul_ps(delta, _mm_load_ps(pTexelWeights + i)));
+            const __m128 difference = _mm_sub_ps(_mm_load_ps(&block.channels[c][i]), blended);
+            sum = _mm_add_ps(sum, _mm_mul_ps(difference, difference));
+        }
+    }
+    return horizontal_sum_sse(sum);
+}
+
+//------------------------------------------------------------------------------------------
+//------------------------------------------------------------------------------------------
+static void block_refit_sums_sse(const Block& block, const float* pTexelWeights, float* pSums) {
+    const __m128 one = _mm_set1_ps(1.0f);
+    __m128 sums[11];
+    for (uint32_t j = 0; j < 11; j++) {
+        sums[j] = _mm_setzero_ps();
+    }
+    for (uint32_t i = 0; i < BLOCK_TEXELS; i += 4) {
+        const __m128 b = _mm_load_ps(pTexelWeights + i);
+        const __m128 a = _mm_sub_ps(one, b);
+        sums[0] = _mm_add_ps(sums[0], _mm_mul_ps(a, a));
+        sums[1] = _mm_add_ps(sums[1], _mm_mul_ps(a, b));
+        sums[2] = _mm_add_ps(sums[2], _mm_mul_ps(b, b));
+        for (uint32_t c = 0; c < 4; c++) {
+            const __m128 texels = _mm_load_ps(&block.channels[c][i]);
+            sums[3 + c] = _mm_add_ps(sums[3 + c], _mm_mul_ps(a, texels));
+            sums[7 + c] = _mm_add_ps(sums[7 + c], _mm_mul_ps(b, texels));
+        }
+    }
+    for (uint32_t j = 0; j < 11; j++) {
+        pSums[j] = horizontal_sum_sse(sums[j]);
+    }
+}
+
+//------------------------------------------------------------------------------------------
+// AVX2 kernels, 8 texels at a time
+//------------------------------------------------------------------------------------------
+J_TARGET_AVX2 static inline float horizontal_sum_avx2(__m256 value) {
+    return horizontal_sum_sse(_mm_add_ps(_mm256_castps256_ps128(value), _mm256_extractf128_ps(value, 1)));
+}
+
+//------------------------------------------------------------------------------------------
+//------------------------------------------------------------------------------------------
+J_TARGET_AVX2 static inline __m256 project_avx2(const Block& block, uint32_t first, const __m256* pOrigin, const __m256* pAxis) {
+    __m256 t = _mm256_mul_ps(_mm256_sub_ps(_mm256_load_ps(&block.channels[0][first]), pOrigin[0]), pAxis[0]);
+    for (uint32_t c = 1; c < 4; c++) {
+        t = _mm256_fmadd_ps(_mm256_sub_ps(_mm256_load_ps(&block.channels[c][first]), pOrigin[c]), pAxis[c], t);
+    }
+    return t;
+}
+
+//------------------------------------------------------------------------------------------
+//------------------------------------------------------------------------------------------
+J_TARGET_AVX2 static void block_statistics_avx2(const Block& block, float* pMean, float* pCovariance) {
+    __m256 centered[2][4];
+    for (uint32_t c = 0; c < 4; c++) {
+        const __m256 first = _mm256_load_ps(&block.channels[c][0]);
+        const __m256 second = _mm256_load_ps(&block.channels[c][8]);
+        pMean[c] = horizontal_sum_avx2(_mm256_add_ps(first, second)) / BLOCK_TEXELS;
+        const __m256 mean = _mm256_set1_ps(pMean[c]);
+        centered[0][c] = _mm256_sub_ps(first, mean);
+        centered[1][c] = _mm256_sub_ps(second, mean);
+    }
+
+    uint32_t entry = 0;
+    for (uint32_t a = 0; a < 4; a++) {
+        for (uint32_t b = a; b < 4; b++) {
+            const __m256 sum = _mm256_fmadd_ps(centered[0][a], centered[0][b], _mm256_mul_ps(centered[1][a], centered[1][b]));
+            pCovariance[entry++] = horizontal_sum_avx2(sum);
+        }
+    }
+}
+
+//------------------------------------------------------------------------------------------
+//------------------------------------------------------------------------------------------
+J_TARGET_AVX2 static void block_extent_avx2(const Block& block, const float* pOrigin, const float* pAxis, float* pMin, float* pMax) {
+    __m256 origin[4];
+    __m256 axis[4];
+    for (uint32_t c = 0; c < 4; c++) {
+        origin[c] = _mm256_set1_ps(pOrigin[c]);
+        axis[c] = _mm256_set1_ps(pAxis[c]);
+    }
+
+    const __m256 first = project_avx2(block, 0, origin, axis);
+    const __m256 second = project_avx2(block, 8, origin, axis);
+    const __m256 minimum8 = _mm256_min_ps(first, second);
+    const __m256 maximum8 = _mm256_max_ps(first, second);
+    __m128 minimum = _mm_min_ps(_mm256_castps256_ps128(minimum8), _mm256_extractf128_ps(minimum8, 1));
+    __m128 maximum = _mm_max_ps(_mm256_castps256_ps128(maximum8), _mm256_extractf128_ps(maximum8, 1));
+    minimum = _mm_min_ps(minimum, _mm_shuffle_ps(minimum, minimum, _MM_SHUFFLE(2, 3, 0, 1)));
+    minimum = _mm_min_ps(minimum, _mm_movehl_ps(minimum, minimum));
+    maximum = _mm_max_ps(maximum, _mm_shuffle_ps(maximum, maximum, _MM_SHUFFLE(2, 3, 0, 1)));
+    maximum = _mm_max_ps(maximum, _mm_movehl_ps(maximum, maximum));
+    *pMin = _mm_cvtss_f32(minimum);
+    *pMax = _mm_cvtss_f32(maximum);
+}
+
+//------------------------------------------------------------------------------------------
+//------------------------------------------------------------------------------------------
+J_TARGET_AVX2 static void block_project_avx2(const Block& block, const float* pOrigin, const float* pAxis, float steps,
+                                             uint8_t* pSteps) {
+    __m256 origin[4];
+    __m256 axis[4];
+    for (uint32_t c = 0; c < 4; c++) {
+        origin[c] = _mm256_set1_ps(pOrigin[c]);
+        axis[c] = _mm256_set1_ps(pAxis[c]);
+    }
+
+    const __m256 zero = _mm256_setzero_ps();
+    const __m256 last = _mm256_set1_ps(steps);
+    for (uint32_t i = 0; i < BLOCK_TEXELS; i += 8) {
+        const __m256 t = _mm256_min_ps(_mm256_max_ps(project_avx2(block, i, origin, axis), zero), last);
+        // The packs work within 128 bit lanes, leaving texels 0-3 and 4-7 in the low bytes of each
+        const __m256i words = _mm256_packs_epi32(_mm256_cvtps_epi32(t), _mm256_setzero_si256());
+        const __m256i bytes = _mm256_packus_epi16(words, words);
+        const int32_t low = _mm_cvtsi128_si32(_mm256_castsi256_si128(bytes));
+        const int32_t high = _mm_cvtsi128_si32(_mm256_extracti128_si256(bytes, 1));
+        memcpy(pSteps + i, &low, sizeof(low));
+        memcpy(pSteps + i + 4, &high, sizeof(high));
+    }
+}
+
+//------------------------------------------------------------------------------------------
+//------------------------------------------------------------------------------------------
+J_TARGET_AVX2 static float block_error_avx2(const Block& block, uint32_t channelCount, const float* pEndpoint0,
+                                            const float* pEndpoint1, const float* pTexelWeights) {
+    const __m256 weights[2] = { _mm256_load_ps(pTexelWeights), _mm256_load_ps(pTexelWeights + 8) };
+    __m256 sum = _mm256_setzero_ps();
+    for (uint32_t c = 0; c < channelCount; c++) {
+        const __m256 endpoint0 = _mm256_set1_ps(pEndpoint0[c]);
+        const __m256 delta = _mm256_set1_ps(pEndpoint1[c] - pEndpoint0[c]);
+        for (uint32_t half = 0; half < 2; half++) {
+            const __m256 blended = _mm256_fmadd_ps(delta, weights[half], endpoint0);
+            const __m256 difference = _mm256_sub_ps(_mm256_load_ps(&block.channels[c][half * 8]), blended);
+            sum = _mm256_fmadd_ps(difference, difference, sum);
+        }
+    }
+    return horizontal_sum_avx2(sum);
+}
+
+//------------------------------------------------------------------------------------------
+//------------------------------------------------------------------------------------------
+J_TARGET_AVX2 static void block_refit_sums_avx2(const Block& block, const float* pTexelWeights, float* pSums) {
+    const __m256 b[2] = { _mm256_load_ps(pTexelWeights), _mm256_load_ps(pTexelWeights + 8) };
+    const __m256 a[2] = { _mm256_sub_ps(_mm256_set1_ps(1.0f), b[0]), _mm256_sub_ps(_mm256_set1_ps(1.0f), b[1]) };
+    pSums[0] = horizontal_sum_avx2(_mm256_fmadd_ps(a[0], a[0], _mm256_mul_ps(a[1], a[1])));
+    pSums[1] = horizontal_sum_avx2(_mm256_fmadd_ps(a[0], b[0], _mm256_mul_ps(a[1], b[1])));
+    pSums[2] = horizontal_sum_avx2(_mm256_fmadd_ps(b[0], b[0], _mm256_mul_ps(b[1], b[1])));
+    for (uint32_t c = 0; c < 4; c++) {
+        const __m256 first = _mm256_load_ps(&block.channels[c][0]);
+        const __m256 second = _mm256_load_ps(&block.channels[c][8]);
+        pSums[3 + c] = horizontal_sum_avx2(_mm256_fmadd_ps(a[0], first, _mm256_mul_ps(a[1], second)));
+        pSums[7 + c] = horizontal_sum_avx2(_mm256_fmadd_ps(b[0], first, _mm256_mul_ps(b[1], second)));
+    }
+}
+#endif
+
+//------------------------------------------------------------------------------------------
+//------------------------------------------------------------------------------------------
+static BlockKernels get_block_kernels(SimdLevel level) {
+    if (level > get_simd_level()) {
+        level = get_simd_level();
+    }
+
+    BlockKernels kernels = { block_statistics_scalar, block_extent_scalar, block_project_scalar, block_error_scalar,
+                             block_refit_sums_scalar };
+#if J_SIMD_X86
+    if (level == SIMD_LEVEL_AVX2) {
+        kernels = { block_statistics_avx2, block_extent_avx2, block_project_avx2, block_error_avx2, block_refit_sums_avx2 };
+    }
+    else if (level == SIMD_LEVEL_SSE) {
+        kernels = { block_statistics_sse, block_extent_sse, block_project_sse, block_error_sse, block_refit_sums_sse };
+    }
+#endif
+    return kernels;
+}
+
+//------------------------------------------------------------------------------------------
+// Texels past the right and bottom edge repeat the last column and row
+//------------------------------------------------------------------------------------------
+static void load_block(const TextureData& image, uint32_t blockX, uint32_t blockY, Block& block) {
+    for (uint32_t y = 0; y < TEXTURE_BLOCK_SIZE; y++) {
+        const uint32_t sourceY = std::min(blockY * TEXTURE_BLOCK_SIZE + y, image.height - 1);
+        for (uint32_t x = 0; x < TEXTURE_BLOCK_SIZE; x++) {
+            const uint32_t sourceX = std::min(blockX * TEXTURE_BLOCK_SIZE + x, image.width - 1);
+            const uint8_t* pTexel = &image.texels[(static_cast<size_t>(sourceY) * image.width + sourceX) * 4];
+            for (uint32_t c = 0; c < 4; c++) {
+                block.channels[c][y * TEXTURE_BLOCK_SIZE + x] = pTexel[c];
+            }
+        }
+    }
+}
+
+//------------------------------------------------------------------------------------------
+// Power iteration on the covariance of the first channelCount channels, starting from the
+// column of the largest variance. A zero axis means the block is one color.
+//------------------------------------------------------------------------------------------
+static void find_principal_axis(const float* pCovariance, uint32_t channelCount, float* pAxis) {
+    float matrix[4][4] = {};
+    uint32_t entry = 0;
+    for (uint32_t a = 0; a < 4; a++) {
+        for (uint32_t b = a; b < 4; b++) {
+            const float value = (a < channelCount && b < channelCount) ? pCovariance[entry] : 0.0f;
+            matrix[a][b] = value;
+            matrix[b][a] = value;
+            entry++;
+        }
+    }
+
+    uint32_t largest = 0;
+    for (uint32_t c = 1; c < channelCount; c++) {
+        largest = matrix[c][c] > matrix[largest][largest] ? c : largest;
+    }
+    float axis[4] = { matrix[0][largest], matrix[1][largest], matrix[2][largest], matrix[3][largest] };
+    for (uint32_t iteration = 0; iteration < 8; iteration++) {
+        float next[4];
+        float scale = 0.0f;
+        for (uint32_t a = 0; a < 4; a++) {
+            next[a] = matrix[a][0] * axis[0] + matrix[a][1] * axis[1] + matrix[a][2] * axis[2] + matrix[a][3] * axis[3];
+            scale = std::max(scale, std::abs(next[a]));
+        }
+        if (scale <= 0.0f) {
+            break;
+        }
+        for (uint32_t a = 0; a < 4; a++) {
+            axis[a] = next[a] / scale;
+        }
+    }
+
+    const float length = std::sqrt(axis[0] * axis[0] + axis[1] * axis[1] + axis[2] * axis[2] + axis[3] * axis[3]);
+    for (uint32_t c = 0; c < 4; c++) {
+        pAxis[c] = length > 1e-6f ? axis[c] / length : 0.0f;
+    }
+}
+
+//------------------------------------------------------------------------------------------
+// Endpoints spanning the block's texels along their principal axis
+//------------------------------------------------------------------------------------------
+static void fit_endpoints(const BlockKernels& kernels, const Block& block, uint32_t channelCount, float* pEndpoint0,
+                          float* pEndpoint1) {
+    float mean[4];
+    float covariance[10];
+    float axis[4];
+    kernels.statistics(block, mean, covariance);
+    find_principal_axis(covariance, channelCount, axis);
+
+    float minimum = 0.0f;
+    float maximum = 0.0f;
+    kernels.extent(block, mean, axis, &minimum, &maximum);
+    for (uint32_t c = 0; c < 4; c++) {
+        pEndpoint0[c] = std::min(std::max(mean[c] + axis[c] * minimum, 0.0f), 255.0f);
+        pEndpoint1[c] = std::min(std::max(mean[c] + axis[c] * maximum, 0.0f), 255.0f);
+    }
+}
+
+//------------------------------------------------------------------------------------------
+// Projects the texels onto the segment between two quantized endpoints, steps + 1 positions
+//------------------------------------------------------------------------------------------
+static void project_onto_endpoints(const BlockKernels& kernels, const Block& block, uint32_t channelCount,
+                                   const float* pEndpoint0, const float* pEndpoint1, uint32_t steps, uint8_t* pSteps) {
+    float axis[4] = {};
+    float lengthSquared = 0.0f;
+    for (uint32_t c = 0; c < channelCount; c++) {
+        axis[c] = pEndpoint1[c] - pEndpoint0[c];
+        lengthSquared += axis[c] * axis[c];
+    }
+    if (lengthSquared == 0.0f) {
+        memset(pSteps, 0, BLOCK_TEXELS);
+        return;
+    }
+    for (uint32_t c = 0; c < channelCount; c++) {
+        axis[c] *= steps / lengthSquared;
+    }
+    kernels.project(block, pEndpoint0, axis, static_cast<float>(steps), pSteps);
+}
+
+//------------------------------------------------------------------------------------------
+// Squared error of the texels against the endpoints blended by pWeights[step]
+//------------------------------------------------------------------------------------------
+static float measure_error(const BlockKernels& kernels, const Block& block, uint32_t channelCount, const float* pEndpoint0,
+                           const float* pEndpoint1, const uint8_t* pSteps, const float* pWeights) {
+    alignas(32) float texelWeights[BLOCK_TEXELS];
+    for (uint32_t i = 0; i < BLOCK_TEXELS; i++) {
+        texelWeights[i] = pWeights[pSteps[i]];
+    }
+    return kernels.error(block, channelCount, pEndpoint0, pEndpoint1, texelWeights);
+}
+
+//------------------------------------------------------------------------------------------
+// The endpoints minimizing the squared error for the chosen steps, a 2x2 linear system per
+// channel sharing one matrix. Returns false when every texel has the same weight.
+//------------------------------------------------------------------------------------------
+static bool refit_endpoints(const BlockKernels& kernels, const Block& block, uint32_t channelCount, const uint8_t* pSteps,
+                            const float* pWeights, float* pEndpoint0, float* pEndpoint1) {
+    alignas(32) float texelWeights[BLOCK_TEXELS];
+    for (uint32_t i = 0; i < BLOCK_TEXELS; i++) {
+        texelWeights[i] = pWeights[pSteps[i]];
+    }
+    float sums[11];
+    kernels.refit_sums(block, texelWeights, sums);
+    const float aa = sums[0];
+    const float ab = sums[1];
+    const float bb = sums[2];
+    const float* ap = sums + 3;
+    const float* bp = sums + 7;
+
+    const float determinant = aa * bb - ab * ab;
+    if (std::abs(determinant) < 1e-6f) {
+        return false;
+    }
+    for (uint32_t c = 0; c < channelCount; c++) {
+        pEndpoint0[c] = std::min(std::max((ap[c] * bb - bp[c] * ab) / determinant, 0.0f), 255.0f);
+        pEndpoint1[c] = std::min(std::max((bp[c] * aa - ap[c] * ab) / determinant, 0.0f), 255.0f);
+    }
+    return true;
+}
+
+//------------------------------------------------------------------------------------------
+//------------------------------------------------------------------------------------------
+static uint16_t quantize_565(const float* pColor) {
+    const uint32_t r = static_cast<uint32_t>(pColor[0] * 31.0f / 255.0f + 0.5f);
+    const uint32_t g = static_cast<uint32_t>(pColor[1] * 63.0f / 255.0f + 0.5f);
+    const uint32_t b = static_cast<uint32_t>(pColor[2] * 31.0f / 255.0f + 0.5f);
+    return static_cast<uint16_t>((r << 11) | (g << 5) | b);
+}
+
+//------------------------------------------------------------------------------------------
+//------------------------------------------------------------------------------------------
+static void expand_565(uint16_t color, float* pColor) {
+    const uint32_t r = (color >> 11) & 31;
+    const uint32_t g = (color >> 5) & 63;
+    const uint32_t b = color & 31;
+    pColor[0] = static_cast<float>((r << 3) | (r >> 2));
+    pColor[1] = static_cast<float>((g << 2) | (g >> 4));
+    pColor[2] = static_cast<float>((b << 3) | (b >> 2));
+    pColor[3] = 0.0f;
+}
+
+//------------------------------------------------------------------------------------------
+// Quantizes the endpoints and picks the steps for them, returning the error
+//------------------------------------------------------------------------------------------
+static float evaluate_bc1(const BlockKernels& kernels, const Block& block, const float* pEndpoint0, const float* pEndpoint1,
+                          uint16_t* pColors, uint8_t* pSteps) {
+    float expanded0[4];
+    float expanded1[4];
+    pColors[0] = quantize_565(pEndpoint0);
+    pColors[1] = quantize_565(pEndpoint1);
+    expand_565(pColors[0], expanded0);
+    expand_565(pColors[1], expanded1);
+    project_onto_endpoints(kernels, block, 3, expanded0, expanded1, 3, pSteps);
+    return measure_error(kernels, block, 3, expanded0, expanded1, pSteps, BC1_STEP_WEIGHTS);
+}
+
+//------------------------------------------------------------------------------------------
+// Always in four color mode, the first color is the larger unless both are equal
+//------------------------------------------------------------------------------------------
+static void encode_bc1(const BlockKernels& kernels, const Block& block, uint8_t* pOut) {
+    float endpoint0[4];
+    float endpoint1[4];
+    fit_endpoints(kernels, block, 3, endpoint0, endpoint1);
+
+    uint16_t colors[2];
+    uint8_t steps[BLOCK_TEXELS];
+    float error = evaluate_bc1(kernels, block, endpoint0, endpoint1, colors, steps);
+    if (error > 0.0f && refit_endpoints(kernels, block, 3, steps, BC1_STEP_WEIGHTS, endpoint0, endpoint1)) {
+        uint16_t refitColors[2];
+        uint8_t refitSteps[BLOCK_TEXELS];
+        if (evaluate_bc1(kernels, block, endpoint0, endpoint1, refitColors, refitSteps) < error) {
+            memcpy(colors, refitColors, sizeof(colors));
+            memcpy(steps, refitSteps, sizeof(steps));
+        }
+    }
+
+    if (colors[0] < colors[1]) {
+        std::swap(colors[0], colors[1]);
+        for (uint32_t i = 0; i < BLOCK_TEXELS; i++) {
+            steps[i] = static_cast<uint8_t>(3 - steps[i]);
+        }
+    }
+    uint32_t indices = 0;
+    if (colors[0] != colors[1]) {
+        for (uint32_t i = 0; i < BLOCK_TEXELS; i++) {
+            indices |= static_cast<uint32_t>(BC1_INDEX_OF_STEP[steps[i]]) << (2 * i);
+        }
+    }
+    memcpy(pOut, colors, sizeof(colors));
+    memcpy(pOut + 4, &indices, sizeof(indices));
+}
+
+//------------------------------------------------------------------------------------------
+// Eight value mode between the channel's extremes
+//------------------------------------------------------------------------------------------
+static void encode_bc4(const BlockKernels& kernels, const Block& block, uint32_t channel, uint8_t* pOut) {
+    float origin[4] = {};
+    float axis[4] = {};
+    axis[channel] = 1.0f;
+    float minimum = 0.0f;
+    float maximum = 0.0f;
+    kernels.extent(block, origin, axis, &minimum, &maximum);
+
+    const uint8_t value0 = static_cast<uint8_t>(maximum + 0.5f);
+    const uint8_t value1 = static_cast<uint8_t>(minimum + 0.5f);
+    uint8_t steps[BLOCK_TEXELS] = {};
+    if (value0 != value1) {
+        origin[channel] = value0;
+        axis[channel] = 7.0f / (static_cast<float>(value1) - value0);
+        kernels.project(block, origin, axis, 7.0f, steps);
+    }
+
+    uint64_t indices = 0;
+    if (value0 != value1) {
+        for (uint32_t i = 0; i < BLOCK_TEXELS; i++) {
+            indices |= static_cast<uint64_t>(BC4_INDEX_OF_STEP[steps[i]]) << (3 * i);
+        }
+    }
+    pOut[0] = value0;
+    pOut[1] = value1;
+    for (uint32_t i = 0; i < 6; i++) {
+        pOut[2 + i] = static_cast<uint8_t>(indices >> (8 * i));
+    }
+}
+
+//------------------------------------------------------------------------------------------
+// 7 bit endpoints share their lowest bit across channels, each endpoint takes whichever
+// parity lands closer
+//------------------------------------------------------------------------------------------
+static void quantize_bc7_endpoint(const float* pEndpoint, uint32_t* pValues, uint32_t* pParity) {
+    float bestError = 0.0f;
+    for (uint32_t parity = 0; parity < 2; parity++) {
+        uint32_t values[4];
+        float error = 0.0f;
+        for (uint32_t c = 0; c < 4; c++) {
+            const float quantized = std::min(std::max(std::nearbyint((pEndpoint[c] - parity) * 0.5f), 0.0f), 127.0f);
+            values[c] = static_cast<uint32_t>(quantized);
+            const float difference = pEndpoint[c] - (2.0f * quantized + parity);
+            error += difference * difference;
+        }
+        if (parity == 0 || error < bestError) {
+            bestError = error;
+            memcpy(pValues, values, sizeof(values));
+            *pParity = parity;
+        }
+    }
+}
+
+//------------------------------------------------------------------------------------------
+//------------------------------------------------------------------------------------------
+static float evaluate_bc7(const BlockKernels& kernels, const Block& block, const float* pEndpoint0, const float* pEndpoint1,
+                          uint32_t* pValues, uint32_t* pParities, uint8_t* pSteps) {
+    quantize_bc7_endpoint(pEndpoint0, pValues, &pParities[0]);
+    quantize_bc7_endpoint(pEndpoint1, pValues + 4, &pParities[1]);
+
+    float expanded0[4];
+    float expanded1[4];
+    for (uint32_t c = 0; c < 4; c++) {
+        expanded0[c] = static_cast<float>(2 * pValues[c] + pParities[0]);
+        expanded1[c] = static_cast<float>(2 * pValues[4 + c] + pParities[1]);
+    }
+    project_onto_endpoints(kernels, block, 4, expanded0, expanded1, 15, pSteps);
+    return measure_error(kernels, block, 4, expanded0, expanded1, pSteps, BC7_STEP_WEIGHTS);
+}
+
+//------------------------------------------------------------------------------------------
+// Mode 6: the mode bit, 7 bit RGBA endpoints, one parity bit each and 4 bit indices, the
+// first index one bit short with its top bit implied zero
+//------------------------------------------------------------------------------------------
+static void encode_bc7(const BlockKernels& kernels, const Block& block, uint8_t* pOut) {
+    float endpoint0[4];
+    float endpoint1[4];
+    fit_endpoints(kernels, block, 4, endpoint0, endpoint1);
+
+    uint32_t values[8];
+    uint32_t parities[2];
+    uint8_t steps[BLOCK_TEXELS];
+    float error = evaluate_bc7(kernels, block, endpoint0, endpoint1, values, parities, steps);
+    if (error > 0.0f && refit_endpoints(kernels, block, 4, steps, BC7_STEP_WEIGHTS, endpoint0, endpoint1)) {
+        uint32_t refitValues[8];
+        uint32_t refitParities[2];
+        uint8_t refitSteps[BLOCK_TEXELS];
+        if (evaluate_bc7(kernels, block, endpoint0, endpoint1, refitValues, refitParities, refitSteps) < error) {
+            memcpy(values, refitValues, sizeof(values));
+            memcpy(parities, refitParities, sizeof(parities));
+            memcpy(steps, refitSteps, sizeof(steps));
+        }
+    }
+
+    if (steps[0] >= 8) {
+        for (uint32_t c = 0; c < 4; c++) {
+            std::swap(values[c], values[4 + c]);
+        }
+        std::swap(parities[0], parities[1]);
+        for (uint32_t i = 0; i < BLOCK_TEXELS; i++) {
+            steps[i] = static_cast<uint8_t>(15 - steps[i]);
+        }
+    }
+
+    BitWriter writer;
+    writer.write(1 << 6, 7);
+    for (uint32_t c = 0; c < 4; c++) {
+        writer.write(values[c], 7);
+        writer.write(values[4 + c], 7);
+    }
+    writer.write(parities[0], 1);
+    writer.write(parities[1], 1);
+    for (uint32_t i = 0; i < BLOCK_TEXELS; i++) {
+        writer.write(steps[i], i == 0 ? 3 : 4);
+    }
+    memcpy(pOut, writer.words, sizeof(writer.words));
+}
+
+//------------------------------------------------------------------------------------------
+//------------------------------------------------------------------------------------------
+static void encode_block(const BlockKernels& kernels, TextureFormat format, const Block& block, uint8_t* pOut) {
+    switch (format) {
+        case TEXTURE_FORMAT_BC1:
+            encode_bc1(kernels, block, pOut);
+            break;
+        case TEXTURE_FORMAT_BC3:
+            encode_bc4(kernels, block, 3, pOut);
+            encode_bc1(kernels, block, pOut + 8);
+            break;
+        case TEXTURE_FORMAT_BC5:
+            encode_bc4(kernels, block, 0, pOut);
+            encode_bc4(kernels, block, 1, pOut + 8);
+            break;
+        default:
+            encode_bc7(kernels, block, pOut);
+            break;
+    }
+}
+
+//------------------------------------------------------------------------------------------
+//------------------------------------------------------------------------------------------
+void compress_texture(SimdLevel level, TextureFormat format, const TextureData& image, JobSystem* pJobSystem,
+                      uint8_t* pBlocks) {
+    if (image.width == 0 || image.height == 0 || image.texels.size() != static_cast<size_t>(image.width) * image.height * 4) {
+        throw std::runtime_error("Failed to compress texture, the image is empty or its size doesn't match!");
+    }
+    if (!is_block_compressed(format)) {
+        memcpy(pBlocks, image.texels.data(), image.texels.size());
+        return;
+    }
+
+    const BlockKernels kernels = get_block_kernels(level);
+    const uint32_t blockBytes = get_texture_block_bytes(format);
+    const uint32_t blocksX = (image.width + TEXTURE_BLOCK_SIZE - 1) / TEXTURE_BLOCK_SIZE;
+    const uint32_t blocksY = (image.height + TEXTURE_BLOCK_SIZE - 1) / TEXTURE_BLOCK_SIZE;
+    auto compress_rows = [&](uint32_t begin, uint32_t end) {
+        Block block;
+        for (uint32_t y = begin; y < end; y++) {
+            for (uint32_t x = 0; x < blocksX; x++) {
+                load_block(image, x, y, block);
+                encode_block(kernels, format, block, pBlocks + (static_cast<size_t>(y) * blocksX + x) * blockBytes);
+            }
+        }
+    };
+
+    if (pJobSystem) {
+        pJobSystem->parallel_for(blocksY, ROWS_PER_JOB, compress_rows);
+    }
+    else {
+        compress_rows(0, blocksY);
+    }
+}
+
+//------------------------------------------------------------------------------------------
+// Two color blocks in four color mode, or in three color mode with black when the first
+// color isn't the larger. BC3 color blocks are always four color.
+//------------------------------------------------------------------------------------------
+static void decode_bc1(const uint8_t* pBlock, bool alwaysFourColor, uint8_t pTexels[BLOCK_TEXELS][4]) {
+    uint16_t colors[2];
+    uint32_t indices;
+    memcpy(colors, pBlock, sizeof(colors));
+    memcpy(&indices, pBlock + 4, sizeof(indices));
+
+    float palette[4][4];
+    expand_565(colors[0], palette[0]);
+    expand_565(colors[1], palette[1]);
+    const bool fourColor = alwaysFourColor || colors[0] > colors[1];
+    for (uint32_t c = 0; c < 3; c++) {
+        if (fourColor) {
+            palette[2][c] = (2.0f * palette[0][c] + palette[1][c]) / 3.0f;
+            palette[3][c] = (palette[0][c] + 2.0f * palette[1][c]) / 3.0f;
+        }
+        else {
+            palette[2][c] = 0.5f * (palette[0][c] + palette[1][c]);
+            palette[3][c] = 0.0f;
+        }
+    }
+
+    for (uint32_t i = 0; i < BLOCK_TEXELS; i++) {
+        const uint32_t index = (indices >> (2 * i)) & 3;
+        for (uint32_t c = 0; c < 3; c++) {
+            pTexels[i][c] = static_cast<uint8_t>(palette[index][c] + 0.5f);
+        }
+        pTexels[i][3] = (!fourColor && index == 3) ? 0 : 255;
+    }
+}
+
+//------------------------------------------------------------------------------------------
+//------------------------------------------------------------------------------------------
+static void decode_bc4(const uint8_t* pBlock, uint32_t channel, uint8_t pTexels[BLOCK_TEXELS][4]) {
+    float values[8];
+    values[0] = pBlock[0];
+    values[1] = pBlock[1];
+    if (pBlock[0] > pBlock[1]) {
+        for (uint32_t i = 2; i < 8; i++) {
+            values[i] = ((8 - i) * values[0] + (i - 1) * values[1]) / 7.0f;
+        }
+    }
+    else {
+        for (uint32_t i = 2; i < 6; i++) {
+            values[i] = ((6 - i) * values[0] + (i - 1) * values[1]) / 5.0f;
+        }
+        values[6] = 0.0f;
+        values[7] = 255.0f;
+    }
+
+    uint64_t indices = 0;
+    for (uint32_t i = 0; i < 6; i++) {
+        indices |= static_cast<uint64_t>(pBlock[2 + i]) << (8 * i);
+    }
+    for (uint32_t i = 0; i < BLOCK_TEXELS; i++) {
+        pTexels[i][channel] = static_cast<uint8_t>(values[(indices >> (3 * i)) & 7] + 0.5f);
+    }
+}
+
+//------------------------------------------------------------------------------------------
+//------------------------------------------------------------------------------------------
+static void decode_bc7(const uint8_t* pBlock, uint8_t pTexels[BLOCK_TEXELS][4]) {
+    uint64_t words[2];
+    memcpy(words, pBlock, sizeof(words));
+    if ((words[0] & 0x7F) != (1 << 6)) {
+        throw std::runtime_error("Failed to decode BC7 block, only mode 6 is supported!");
+    }
+
+    uint32_t endpoints[2][4];
+    uint32_t position = 7;
+    for (uint32_t c = 0; c < 4; c++) {
+        endpoints[0][c] = read_bits(words, position, 7) << 1;
+        endpoints[1][c] = read_bits(words, position + 7, 7) << 1;
+        position += 14;
+    }
+    const uint32_t parity0 = read_bits(words, position, 1);
+    const uint32_t parity1 = read_bits(words, position + 1, 1);
+    position += 2;
+    for (uint32_t c = 0; c < 4; c++) {
+        endpoints[0][c] |= parity0;
+        endpoints[1][c] |= parity1;
+    }
+
+    for (uint32_t i = 0; i < BLOCK_TEXELS; i++) {
+        const uint32_t bits = i == 0 ? 3 : 4;
+        const uint32_t weight = BC7_WEIGHTS[read_bits(words, position, bits)];
+        position += bits;
+        for (uint32_t c = 0; c < 4; c++) {
+            pTexels[i][c] = static_cast<uint8_t>(((64 - weight) * endpoints[0][c] + weight * endpoints[1][c] + 32) >> 6);
+        }
+    }
+}
+
+//------------------------------------------------------------------------------------------
+//------------------------------------------------------------------------------------------
+TextureData decompress_texture(TextureFormat format, const uint8_t* pBlocks, uint32_t width, uint32_t height) {
+    TextureData image;
+    image.width = width;
+    image.height = height;
+    image.texels.resize(static_cast<size_t>(width) * height * 4);
+    if (!is_block_compressed(format)) {
+        memcpy(image.texels.data(), pBlocks, image.texels.size());
+        return image;
+    }
+
+    const uint32_t blockBytes = get_texture_block_bytes(format);
+    const uint32_t blocksX = (width + TEXTURE_BLOCK_SIZE - 1) / TEXTURE_BLOCK_SIZE;
+    const uint32_t blocksY = (height + TEXTURE_BLOCK_SIZE - 1) / TEXTURE_BLOCK_SIZE;
+    uint8_t texels[BLOCK_TEXELS][4];
+    for (uint32_t blockY = 0; blockY < blocksY; blockY++) {
+        for (uint32_t blockX = 0; blockX < blocksX; blockX++) {
+            const uint8_t* pBlock = pBlocks + (static_cast<size_t>(blockY) * blocksX + blockX) * blockBytes;
+            switch (format) {
+                case TEXTURE_FORMAT_BC1:
+                    decode_bc1(pBlock, false, texels);
+                    break;
+                case TEXTURE_FORMAT_BC3:
+                    decode_bc1(pBlock + 8, true, texels);
+                    decode_bc4(pBlock, 3, texels);
+                    break;
+                case TEXTURE_FORMAT_BC5:
+                    memset(texels, 0, sizeof(texels));
+                    decode_bc4(pBlock, 0, texels);
+                    decode_bc4(pBlock + 8, 1, texels);
+                    for (uint32_t i = 0; i < BLOCK_TEXELS; i++) {
+                        texels[i][3] = 255;
+                    }
+                    break;
+                default:
+                    decode_bc7(pBlock, texels);
+                    break;
+            }
+
+            for (uint32_t y = 0; y < TEXTURE_BLOCK_SIZE; y++) {
+                for (uint32_t x = 0; x < TEXTURE_BLOCK_SIZE; x++) {
+                    const uint32_t imageX = blockX * TEXTURE_BLOCK_SIZE + x;
+                    const uint32_t imageY = blockY * TEXTURE_BLOCK_SIZE + y;
+                    if (imageX < width && imageY < height) {
+                        memcpy(&image.texels[(static_cast<size_t>(imageY) * width + imageX) * 4], texels[y * TEXTURE_BLOCK_SIZE + x], 4);
+                    }
+                }
+            }
+        }
+    }
+    return image;
+}
@@ -0,0 +1,89 @@
+//======================================================================
+// Component.cpp
+//
+// Keegan Kochis
+// Created: 2026/10/18
+// The registry of component types.
+//======================================================================
+
+#include "Component.h"
+
+#include <cstdint>
+#include <cstdlib>
+
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#ifdef __GNUG__
+#include <cxxabi.h>
+#endif
+
+static std::mutex& registry_mutex() {
+    static std::mutex mutex;
+    return mutex;
+}
+
+// Reserved up front so references handed out by get_component_info stay valid
+static std::vector<ComponentInfo>& registry() {
+    static std::vector<ComponentInfo> components = []() {
+        std::vector<ComponentInfo> reserved;
+        reserved.reserve(MAX_COMPONENTS);
+        return reserved;
+    }();
+    return components;
+}
+
+// Reserved as well, so the names' storage never moves
+static std::vector<std::string>& registry_names() {
+    static std::vector<std::string> names = []() {
+        std::vector<std::string> reserved;
+        reserved.reserve(MAX_COMPONENTS);
+        return reserved;
+    }();
+    return names;
+}
+
+// typeid names are mangled with GCC and Clang, e.g. "6Spin_t"
+static std::string demangle(const char* name) {
+#ifdef __GNUG__
+    int status = 0;
+    char* pDemangled = abi::__cxa_demangle(name, nullptr, nullptr, &status);
+    if (status == 0 && pDemangled) {
+        std::string result = pDemangled;
+        std::free(pDemangled);
+        return result;
+    }
+    std::free(pDemangled);
+#endif
+    return name;
+}
+
+//------------------------------------------------------------------------------------------
+//------------------------------------------------------------------------------------------
+uint32_t register_component(uint32_t size, uint32_t alignment, const char* name) {
+    std::lock_guard<std::mutex> lock(registry_mutex());
+
+    std::vector<ComponentInfo>& components = registry();
+    if (components.size() == MAX_COMPONENTS) {
+        throw std::runtime_error("Failed to register component, too many component types!");
+    }
+    registry_names().push_back(demangle(name));
+    components.push_back({ size, alignment, registry_names().back().c_str() });
+    return static_cast<uint32_t>(components.size() - 1);
+}
+
+//------------------------------------------------------------------------------------------
+//------------------------------------------------------------------------------------------
+const ComponentInfo& get_component_info(uint32_t id) {
+    std::lock_guard<std::mutex> lock(registry_mutex());
+    return registry()[id];
+}
+
+//------------------------------------------------------------------------------------------
+//------------------------------------------------------------------------------------------
+uint32_t get_component_count() {
+    std::lock_guard<std::mutex> lock(registry_mutex());
+    return static_cast<uint32_t>(registry().size());
+}
@@ -0,0 +1,85 @@
+//======================================================================
+// ContentHash.cpp
+//
+// Keegan Kochis
+// Created: 2026/10/18
+// Content hashing built from the rounds of xxHash64, one lane at a
+// time, which keeps up with reading the data from memory.
+//======================================================================
+
+#include "ContentHash.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+#include <string>
+
+static const uint64_t PRIME_1 = 0x9E3779B185EBCA87ull;
+static const uint64_t PRIME_2 = 0xC2B2AE3D27D4EB4Full;
+static const uint64_t PRIME_3 = 0x165667B19E3779F9ull;
+static const uint64_t PRIME_4 = 0x85EBCA77C2B2AE63ull;
+
+static uint64_t rotate_left(uint64_t value, uint32_t bits) {
+    return (value << bits) | (value >> (64 - bits));
+}
+
+static uint64_t mix_word(uint64_t hash, uint64_t word) {
+    hash ^= rotate_left(word * PRIME_2, 31) * PRIME_1;
+    return rotate_left(hash, 27) * PRIME_1 + PRIME_4;
+}
+
+// Every input bit affects every output bit
+static uint64_t avalanche(uint64_t hash) {
+    hash ^= hash >> 33;
+    hash *= PRIME_2;
+    hash ^= hash >> 29;
+    hash *= PRIME_3;
+    hash ^= hash >> 32;
+    return hash;
+}
+
+//------------------------------------------------------------------------------------------
+// The length goes into the seed so inputs differing only in trailing zeros differ
+//------------------------------------------------------------------------------------------
+uint64_t hash_bytes(const void* pData, size_t bytes, uint64_t seed) {
+    const uint8_t* pBytes = static_cast<const uint8_t*>(pData);
+    uint64_t hash = seed + PRIME_3 + static_cast<uint64_t>(bytes) * PRIME_1;
+
+    size_t offset = 0;
+    for (; offset + 8 <= bytes; offset += 8) {
+        uint64_t word;
+        memcpy(&word, pBytes + offset, 8);
+        hash = mix_word(hash, word);
+    }
+    if (offset < bytes) {
+        uint64_t word = 0;
+        memcpy(&word, pBytes + offset, bytes - offset);
+        hash = mix_word(hash, word);
+    }
+
+    return avalanche(hash);
+}
+
+//------------------------------------------------------------------------------------------
+//------------------------------------------------------------------------------------------
+uint64_t hash_string(const std::string& text, uint64_t seed) {
+    return hash_bytes(text.data(), text.size(), seed);
+}
+
+//------------------------------------------------------------------------------------------
+//------------------------------------------------------------------------------------------
+uint64_t hash_combine(uint64_t hash, uint64_t value) {
+    return avalanche(mix_word(hash, value));
+}
+
+//------------------------------------------------------------------------------------------
+//------------------------------------------------------------------------------------------
+std::string hash_to_string(uint64_t hash) {
+    static const char DIGITS[] = "0123456789abcdef";
+    std::string text(16, '0');
+    for (uint32_t i = 0; i < 16; i++) {
+        text[15 - i] = DIGITS[(hash >> (4 * i)) & 0xF];
+    }
+    return text;
+}
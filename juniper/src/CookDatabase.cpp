@@ -0,0 +1,306 @@
+//======================================================================
+// CookDatabase.cpp
+//
+// Keegan Kochis
+// Created: 2026/10/19
+// The definition of the CookDatabase class.
+//======================================================================
+
+#include "CookDatabase.h"
+#include "ContentHash.h"
+#include "MappedFile.h"
+
+#include <sys/stat.h>
+
+#include <cstdint>
+#include <cstdlib>
+
+#include <algorithm>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+static const uint64_t FILE_SEED = 0x4A434F4F4B46494Cull;
+static const char* HEADER = "JCOOKDB";
+// Within this of when it's read, a file could be written again without its modification
+// time changing, file system times only advance with the kernel's clock tick. Covers the
+// ticks of Linux and macOS, not the two seconds of FAT.
+static const int64_t RACY_NS = 100000000;
+
+//------------------------------------------------------------------------------------------
+// The next space separated token, an empty one at the end of the line
+//------------------------------------------------------------------------------------------
+static std::string read_token(const char*& pText, const char* pEnd) {
+    const char* pStart = pText;
+    while (pText < pEnd && *pText != ' ' && *pText != '\n') {
+        pText++;
+    }
+    std::string token(pStart, pText);
+    if (pText < pEnd && *pText == ' ') {
+        pText++;
+    }
+    return token;
+}
+
+//------------------------------------------------------------------------------------------
+// The rest of the line, paths and names may contain spaces
+//------------------------------------------------------------------------------------------
+static std::string read_line(const char*& pText, const char* pEnd) {
+    const char* pStart = pText;
+    while (pText < pEnd && *pText != '\n') {
+        pText++;
+    }
+    std::string line(pStart, pText);
+    if (pText < pEnd) {
+        pText++;
+    }
+    return line;
+}
+
+//------------------------------------------------------------------------------------------
+// False if the token isn't a number in the base
+//------------------------------------------------------------------------------------------
+static bool read_number(const char*& pText, const char* pEnd, int base, uint64_t* pValue) {
+    const std::string token = read_token(pText, pEnd);
+    char* pTokenEnd = nullptr;
+    *pValue = token[0] == '-' ? static_cast<uint64_t>(std::strtoll(token.c_str(), &pTokenEnd, base))
+                              : std::strtoull(token.c_str(), &pTokenEnd, base);
+    return !token.empty() && *pTokenEnd == '\0';
+}
+
+//------------------------------------------------------------------------------------------
+//------------------------------------------------------------------------------------------
+static bool read_file_line(const char*& pText, const char* pEnd, CookedFile* pFile) {
+    uint64_t modifiedNs = 0;
+    if (!read_number(pText, pEnd, 16, &pFile->hash) || !read_number(pText, pEnd, 10, &pFile->bytes) ||
+        !read_number(pText, pEnd, 10, &modifiedNs)) {
+        return false;
+    }
+    pFile->modifiedNs = static_cast<int64_t>(modifiedNs);
+    pFile->path = read_line(pText, pEnd);
+    return !pFile->path.empty();
+}
+
+//------------------------------------------------------------------------------------------
+//------------------------------------------------------------------------------------------
+static void write_file_line(const CookedFile& file, std::string& text) {
+    text += hash_to_string(file.hash);
+    text += ' ';
+    text += std::to_string(file.bytes);
+    text += ' ';
+    text += std::to_string(file.modifiedNs);
+    text += ' ';
+    text += file.path;
+    text += '\n';
+}
+
+CookDatabase::CookDatabase() {
+}
+
+//------------------------------------------------------------------------------------------
+// A "JCOOKDB <version>" line, then per step a "<input count> <output count> <tool version>
+// <input list hash> <tool> <step>" line followed by a "<hash> <bytes> <modified ns> <path>"
+// line per input and output. Anything malformed drops every record, which just means
+// everything gets cooked.
+//------------------------------------------------------------------------------------------
+void CookDatabase::open(const std::string& path) {
+    mPath = path;
+    mRecords.clear();
+    mChanged = false;
+
+    std::ifstream file(path, std::ios::binary);
+    const std::string text((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    const char* pText = text.c_str();
+    const char* pEnd = pText + text.size();
+
+    uint64_t version = 0;
+    if (read_token(pText, pEnd) != HEADER || !read_number(pText, pEnd, 10, &version) || version != VERSION) {
+        return;
+    }
+    read_line(pText, pEnd);
+
+    while (pText < pEnd) {
+        uint64_t inputCount = 0;
+        uint64_t outputCount = 0;
+        CookRecord record;
+        bool valid = read_number(pText, pEnd, 10, &inputCount) && read_number(pText, pEnd, 10, &outputCount) &&
+                     read_number(pText, pEnd, 16, &record.toolVersion) &&
+                     read_number(pText, pEnd, 16, &record.inputListHash);
+        record.tool = read_token(pText, pEnd);
+        const std::string step = read_line(pText, pEnd);
+        valid = valid && !record.tool.empty() && !step.empty();
+
+        record.inputs.resize(valid ? inputCount : 0);
+        record.outputs.resize(valid ? outputCount : 0);
+        for (CookedFile& input : record.inputs) {
+            valid = valid && read_file_line(pText, pEnd, &input);
+        }
+        for (CookedFile& output : record.outputs) {
+            valid = valid && read_file_line(pText, pEnd, &output);
+        }
+        if (!valid) {
+            mRecords.clear();
+            return;
+        }
+        mRecords[step] = std::move(record);
+    }
+}
+
+//------------------------------------------------------------------------------------------
+// Written next to the database and renamed over it, so a crash never leaves half a
+// database behind
+//------------------------------------------------------------------------------------------
+void CookDatabase::save() {
+    if (!mChanged) {
+        return;
+    }
+
+    std::string text = std::string(HEADER) + ' ' + std::to_string(VERSION) + '\n';
+    for (const std::string& step : get_steps()) {
+        const CookRecord& record = mRecords.at(step);
+        text += std::to_string(record.inputs.size());
+        text += ' ';
+        text += std::to_string(record.outputs.size());
+        text += ' ';
+        text += hash_to_string(record.toolVersion);
+        text += ' ';
+        text += hash_to_string(record.inputListHash);
+        text += ' ';
+        text += record.tool;
+        text += ' ';
+        text += step;
+        text += '\n';
+        for (const CookedFile& input : record.inputs) {
+            write_file_line(input, text);
+        }
+        for (const CookedFile& output : record.outputs) {
+            write_file_line(output, text);
+        }
+    }
+
+    const std::string temporaryPath = mPath + ".tmp";
+    {
+        std::ofstream file(temporaryPath, std::ios::binary | std::ios::trunc);
+        file.write(text.data(), static_cast<std::streamsize>(text.size()));
+        if (!file) {
+            throw std::runtime_error("Failed to write cook database " + temporaryPath + "!");
+        }
+    }
+    std::filesystem::rename(temporaryPath, mPath);
+    mChanged = false;
+}
+
+//------------------------------------------------------------------------------------------
+//------------------------------------------------------------------------------------------
+CookRecord* CookDatabase::find(const std::string& step) {
+    auto found = mRecords.find(step);
+    return found != mRecords.end() ? &found->second : nullptr;
+}
+
+//------------------------------------------------------------------------------------------
+//------------------------------------------------------------------------------------------
+void CookDatabase::set(const std::string& step, CookRecord record) {
+    mRecords[step] = std::move(record);
+    mChanged = true;
+}
+
+//------------------------------------------------------------------------------------------
+//------------------------------------------------------------------------------------------
+void CookDatabase::remove(const std::string& step) {
+    if (mRecords.erase(step) > 0) {
+        mChanged = true;
+    }
+}
+
+//------------------------------------------------------------------------------------------
+// Sorted, so the database reads the same for the same records
+//------------------------------------------------------------------------------------------
+std::vector<std::string> CookDatabase::get_steps() const {
+    std::vector<std::string> steps;
+    steps.reserve(mRecords.size());
+    for (const auto& record : mRecords) {
+        steps.push_back(record.first);
+    }
+    std::sort(steps.begin(), steps.end());
+    return steps;
+}
+
+//------------------------------------------------------------------------------------------
+// The hash is left alone
+//------------------------------------------------------------------------------------------
+bool CookDatabase::stat_file(const std::string& path, CookedFile* pFile) {
+    struct stat status;
+    if (stat(path.c_str(), &status) != 0 || !S_ISREG(status.st_mode)) {
+        return false;
+    }
+#ifdef __APPLE__
+    const struct timespec& modified = status.st_mtimespec;
+#else
+    const struct timespec& modified = status.st_mtim;
+#endif
+    pFile->path = path;
+    pFile->bytes = static_cast<uint64_t>(status.st_size);
+    pFile->modifiedNs = static_cast<int64_t>(modified.tv_sec) * 1000000000 + modified.tv_nsec;
+    return true;
+}
+
+//------------------------------------------------------------------------------------------
+// Stats before reading, so a write while it's hashed leaves a time that won't match
+//------------------------------------------------------------------------------------------
+CookedFile CookDatabase::hash_file(const std::string& path) {
+    CookedFile file;
+    if (!stat_file(path, &file)) {
+        throw std::runtime_error("Failed to hash file " + path + ", it doesn't exist!");
+    }
+
+    if (file.bytes == 0) {
+        file.hash = hash_bytes(nullptr, 0, FILE_SEED);
+        return file;
+    }
+    MappedFile mapped;
+    mapped.open(path);
+    file.bytes = mapped.get_size();
+    file.hash = hash_bytes(mapped.get_data(), mapped.get_size(), FILE_SEED);
+    return file;
+}
+
+//------------------------------------------------------------------------------------------
+// A different size is a different content without reading it
+//------------------------------------------------------------------------------------------
+FileCheck CookDatabase::check_file(CookedFile& file) {
+    CookedFile current;
+    if (!stat_file(file.path, &current)) {
+        return FILE_CHECK_MISSING;
+    }
+    if (current.bytes == file.bytes && current.modifiedNs == file.modifiedNs) {
+        return FILE_CHECK_UNCHANGED;
+    }
+    if (current.bytes != file.bytes) {
+        return FILE_CHECK_CHANGED;
+    }
+
+    current = hash_file(file.path);
+    if (current.hash != file.hash) {
+        return FILE_CHECK_CHANGED;
+    }
+    forget_racy_time(current);
+    file.modifiedNs = current.modifiedNs;
+    return FILE_CHECK_TOUCHED;
+}
+
+//------------------------------------------------------------------------------------------
+// Without a time the next check hashes the file again, which is the only way to see a write
+// that left both the size and the time as they were
+//------------------------------------------------------------------------------------------
+void CookDatabase::forget_racy_time(CookedFile& file) {
+    const int64_t nowNs = std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+    if (file.modifiedNs > nowNs - RACY_NS) {
+        file.modifiedNs = 0;
+    }
+}
@@ -0,0 +1,446 @@
+//======================================================================
+// CookGraph.cpp
+//
+// Keegan Kochis
+// Created: 2026/10/19
+// The definition of the CookGraph class.
+//======================================================================
+
+#include "CookGraph.h"
+#include "ContentHash.h"
+#include "Profiler.h"
+
+#include <cstddef>
+#include <cstdint>
+
+#include <algorithm>
+#include <exception>
+#include <filesystem>
+#include <ostream>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+static const uint64_t INPUT_LIST_SEED = 0x4A494E5055545321ull;
+// Steps without dependencies checked per job, checking one only takes a few stats
+static const uint32_t CHECK_BATCH_SIZE = 64;
+
+CookGraph::CookGraph() {
+}
+
+//------------------------------------------------------------------------------------------
+//------------------------------------------------------------------------------------------
+void CookGraph::init(JobSystem* pJobSystem, CookDatabase* pDatabase) {
+    mpJobSystem = pJobSystem;
+    mpDatabase = pDatabase;
+    mStats = Stats();
+}
+
+//------------------------------------------------------------------------------------------
+//------------------------------------------------------------------------------------------
+void CookGraph::clean_up() {
+    mSteps.clear();
+    mStepIds.clear();
+    mRoots.clear();
+    mReaders.clear();
+    mReadersBuilt = false;
+    mStats = Stats();
+}
+
+//------------------------------------------------------------------------------------------
+//------------------------------------------------------------------------------------------
+CookStepId CookGraph::add_step(const std::string& name, const std::string& tool, uint64_t toolVersion,
+                               const std::vector<std::string>& inputs, const std::vector<CookStepId>& dependencies,
+                               CookFunction cook) {
+    const CookStepId id = static_cast<CookStepId>(mSteps.size());
+    if (!mStepIds.emplace(name, id).second) {
+        throw std::runtime_error("Failed to add cook step " + name + ", there already is a step of that name!");
+    }
+    for (CookStepId dependency : dependencies) {
+        if (dependency >= id) {
+            mStepIds.erase(name);
+            throw std::runtime_error("Failed to add cook step " + name + ", it depends on a step added after it!");
+        }
+    }
+
+    std::unique_ptr<Step> pStep = std::make_unique<Step>();
+    pStep->name = name;
+    pStep->tool = tool;
+    pStep->toolVersion = toolVersion;
+    pStep->inputs = inputs;
+    pStep->dependencies = dependencies;
+    pStep->cook = std::move(cook);
+    for (CookStepId dependency : dependencies) {
+        mSteps[dependency]->successors.push_back(id);
+    }
+    if (dependencies.empty()) {
+        mRoots.push_back(id);
+    }
+    mSteps.push_back(std::move(pStep));
+    mReadersBuilt = false;
+    return id;
+}
+
+//------------------------------------------------------------------------------------------
+//------------------------------------------------------------------------------------------
+std::vector<std::string> CookGraph::get_outputs(CookStepId step) const {
+    std::vector<std::string> outputs;
+    const CookRecord* pRecord = mpDatabase->find(mSteps[step]->name);
+    if (pRecord) {
+        for (const CookedFile& output : pRecord->outputs) {
+            outputs.push_back(output.path);
+        }
+    }
+    return outputs;
+}
+
+//------------------------------------------------------------------------------------------
+//------------------------------------------------------------------------------------------
+void CookGraph::run() {
+    run_steps(true);
+    commit();
+}
+
+//------------------------------------------------------------------------------------------
+// The readers are indexed on the first call and kept up to date with every cook after
+//------------------------------------------------------------------------------------------
+void CookGraph::run_changed(const std::vector<std::string>& changedPaths) {
+    if (!mReadersBuilt) {
+        mReaders.clear();
+        for (CookStepId i = 0; i < mSteps.size(); i++) {
+            for (const std::string& input : mSteps[i]->inputs) {
+                add_reader(input, i);
+            }
+            const CookRecord* pRecord = mpDatabase->find(mSteps[i]->name);
+            if (pRecord) {
+                for (const CookedFile& input : pRecord->inputs) {
+                    add_reader(input.path, i);
+                }
+            }
+        }
+        mReadersBuilt = true;
+    }
+
+    for (const std::string& path : changedPaths) {
+        auto readers = mReaders.find(path);
+        if (readers == mReaders.end()) {
+            continue;
+        }
+        for (CookStepId step : readers->second) {
+            mSteps[step]->mustCheck = true;
+        }
+    }
+    run_steps(false);
+    commit();
+}
+
+//------------------------------------------------------------------------------------------
+//------------------------------------------------------------------------------------------
+void CookGraph::print_stats(std::ostream& out) const {
+    out << "Cook graph stats:\n";
+    out << "\tSteps: " << mStats.steps << ", " << mStats.checkedSteps << " checked, " << mStats.cookedSteps
+        << " cooked, " << mStats.failedSteps << " failed\n";
+    if (mStats.removedSteps > 0) {
+        out << "\tRemoved: " << mStats.removedSteps << " steps no longer in the graph\n";
+    }
+    out << "\tFiles checked: " << mStats.filesChecked << ", " << mStats.filesChanged << " with a new size or time\n";
+    out << "\tChecks: " << mStats.checkMs << " ms\n";
+    out << "\tCooks: " << mStats.cookMs << " ms\n";
+    out << "\tRun: " << mStats.runMs << " ms on " << (mpJobSystem ? mpJobSystem->get_thread_count() : 1) << " threads\n";
+}
+
+//------------------------------------------------------------------------------------------
+//------------------------------------------------------------------------------------------
+void CookGraph::run_steps(bool checkAll) {
+    const uint64_t runStart = Profiler::now_ns();
+    mFilesChecked.store(0, std::memory_order_relaxed);
+    mFilesChanged.store(0, std::memory_order_relaxed);
+    mRecordsTouched.store(false, std::memory_order_relaxed);
+    mCheckNs.store(0, std::memory_order_relaxed);
+    mCookNs.store(0, std::memory_order_relaxed);
+
+    for (std::unique_ptr<Step>& pStep : mSteps) {
+        Step& step = *pStep;
+        step.pRecord = mpDatabase->find(step.name);
+        step.mustCheck = step.mustCheck || checkAll || !mIncremental || !step.pRecord;
+        step.state = STEP_STATE_UNAFFECTED;
+        step.remainingDependencies.store(static_cast<uint32_t>(step.dependencies.size()), std::memory_order_relaxed);
+        step.cookedRecord = CookRecord();
+        step.error.clear();
+    }
+
+    // Only the cooks get jobs of their own
+    JobSystem::JobCounter counter;
+    JobSystem::JobCounter* pCounter = mpJobSystem ? &counter : nullptr;
+    auto check_roots = [this, pCounter](uint32_t begin, uint32_t end) {
+        for (uint32_t i = begin; i < end; i++) {
+            check(mRoots[i], pCounter);
+        }
+    };
+    if (mpJobSystem) {
+        mpJobSystem->parallel_for(static_cast<uint32_t>(mRoots.size()), CHECK_BATCH_SIZE, check_roots);
+        mpJobSystem->wait(counter);
+    }
+    else {
+        check_roots(0, static_cast<uint32_t>(mRoots.size()));
+    }
+
+    mStats = Stats();
+    mStats.steps = static_cast<uint32_t>(mSteps.size());
+    for (std::unique_ptr<Step>& pStep : mSteps) {
+        const Step& step = *pStep;
+        if (step.state != STEP_STATE_UNAFFECTED && (step.state != STEP_STATE_FAILED || !step.error.empty())) {
+            mStats.checkedSteps++;
+        }
+        mStats.cookedSteps += step.state == STEP_STATE_COOKED ? 1 : 0;
+        mStats.failedSteps += step.state == STEP_STATE_FAILED ? 1 : 0;
+        pStep->mustCheck = false;
+    }
+    mStats.filesChecked = mFilesChecked.load(std::memory_order_relaxed);
+    mStats.filesChanged = mFilesChanged.load(std::memory_order_relaxed);
+    mStats.checkMs = mCheckNs.load(std::memory_order_relaxed) / 1e6;
+    mStats.cookMs = mCookNs.load(std::memory_order_relaxed) / 1e6;
+    mStats.runMs = (Profiler::now_ns() - runStart) / 1e6;
+}
+
+//------------------------------------------------------------------------------------------
+// Cooked records go into the database on the calling thread. A step that failed itself
+// loses its record, so it's cooked again next run, while the steps after it keep theirs.
+//------------------------------------------------------------------------------------------
+void CookGraph::commit() {
+    const std::string* pError = nullptr;
+    uint32_t recordedSteps = 0;
+    for (CookStepId i = 0; i < mSteps.size(); i++) {
+        Step& step = *mSteps[i];
+        if (step.state == STEP_STATE_COOKED) {
+            if (mReadersBuilt) {
+                for (const CookedFile& input : step.cookedRecord.inputs) {
+                    add_reader(input.path, i);
+                }
+            }
+            mpDatabase->set(step.name, std::move(step.cookedRecord));
+            step.cookedRecord = CookRecord();
+        }
+        else if (step.state == STEP_STATE_FAILED && !step.error.empty()) {
+            mpDatabase->remove(step.name);
+            pError = pError ? pError : &step.error;
+        }
+        step.pRecord = nullptr;
+        recordedSteps += mpDatabase->find(step.name) ? 1 : 0;
+    }
+    if (mRecordsTouched.load(std::memory_order_relaxed)) {
+        mpDatabase->mark_changed();
+    }
+
+    if (recordedSteps != mpDatabase->get_record_count()) {
+        remove_stale_records();
+    }
+    mpDatabase->save();
+
+    if (pError) {
+        throw std::runtime_error(*pError);
+    }
+}
+
+//------------------------------------------------------------------------------------------
+// Runs in jobs, so failures are kept for after the run rather than thrown. A step out of
+// date is cooked in a job of its own, or right away without a counter.
+//------------------------------------------------------------------------------------------
+void CookGraph::check(CookStepId stepId, JobSystem::JobCounter* pCounter) {
+    Step& step = *mSteps[stepId];
+
+    for (CookStepId dependencyId : step.dependencies) {
+        const StepState dependencyState = mSteps[dependencyId]->state;
+        if (dependencyState == STEP_STATE_FAILED) {
+            step.state = STEP_STATE_FAILED;
+            finish(stepId, pCounter);
+            return;
+        }
+        step.mustCheck = step.mustCheck || dependencyState == STEP_STATE_COOKED;
+    }
+    if (!step.mustCheck) {
+        finish(stepId, pCounter);
+        return;
+    }
+
+    // Outputs of the dependencies as they are after this run
+    std::vector<std::string> inputs = step.inputs;
+    for (CookStepId dependencyId : step.dependencies) {
+        const Step& dependency = *mSteps[dependencyId];
+        const CookRecord& record = dependency.state == STEP_STATE_COOKED ? dependency.cookedRecord : *dependency.pRecord;
+        for (const CookedFile& output : record.outputs) {
+            inputs.push_back(output.path);
+        }
+    }
+
+    try {
+        const uint64_t checkStart = Profiler::now_ns();
+        const bool upToDate = mIncremental && is_up_to_date(step, inputs);
+        mCheckNs.fetch_add(Profiler::now_ns() - checkStart, std::memory_order_relaxed);
+        if (upToDate) {
+            step.state = STEP_STATE_UP_TO_DATE;
+            finish(stepId, pCounter);
+            return;
+        }
+    }
+    catch (const std::exception& e) {
+        step.state = STEP_STATE_FAILED;
+        step.error = e.what();
+        finish(stepId, pCounter);
+        return;
+    }
+
+    if (!pCounter) {
+        cook(step, inputs);
+        finish(stepId, pCounter);
+        return;
+    }
+    mpJobSystem->submit(*pCounter, [this, stepId, pCounter, inputs]() {
+        cook(*mSteps[stepId], inputs);
+        finish(stepId, pCounter);
+    });
+}
+
+//------------------------------------------------------------------------------------------
+// The last dependency to finish checks the step. Cooks are submitted before the finishing
+// job returns, so the counter can't reach zero while part of the graph is still to run.
+//------------------------------------------------------------------------------------------
+void CookGraph::finish(CookStepId stepId, JobSystem::JobCounter* pCounter) {
+    for (CookStepId successor : mSteps[stepId]->successors) {
+        if (mSteps[successor]->remainingDependencies.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+            check(successor, pCounter);
+        }
+    }
+}
+
+//------------------------------------------------------------------------------------------
+// Only the step's own record is touched, each step is checked on one thread
+//------------------------------------------------------------------------------------------
+bool CookGraph::is_up_to_date(Step& step, const std::vector<std::string>& inputs) {
+    CookRecord* pRecord = step.pRecord;
+    if (!pRecord || pRecord->tool != step.tool || pRecord->toolVersion != step.toolVersion ||
+        pRecord->inputListHash != hash_input_list(inputs)) {
+        return false;
+    }
+
+    for (std::vector<CookedFile>* pFiles : { &pRecord->inputs, &pRecord->outputs }) {
+        for (CookedFile& file : *pFiles) {
+            mFilesChecked.fetch_add(1, std::memory_order_relaxed);
+            const FileCheck check = CookDatabase::check_file(file);
+            if (check == FILE_CHECK_UNCHANGED) {
+                continue;
+            }
+            if (check == FILE_CHECK_MISSING) {
+                return false;
+            }
+            mFilesChanged.fetch_add(1, std::memory_order_relaxed);
+            if (check == FILE_CHECK_CHANGED) {
+                return false;
+            }
+            mRecordsTouched.store(true, std::memory_order_relaxed);
+        }
+    }
+    return true;
+}
+
+//------------------------------------------------------------------------------------------
+// The given inputs are hashed before cooking, so an edit made while it cooks is seen as a
+// change next run. An input still at the size and time of the last cook keeps its hash,
+// so a step reading many files, like a pack, doesn't read them all again to recook for
+// one. What the tool found and wrote can only be hashed after.
+//------------------------------------------------------------------------------------------
+void CookGraph::cook(Step& step, const std::vector<std::string>& inputs) {
+    const uint64_t cookStart = Profiler::now_ns();
+    try {
+        CookRecord record;
+        record.tool = step.tool;
+        record.toolVersion = step.toolVersion;
+        record.inputListHash = hash_input_list(inputs);
+        const std::vector<CookedFile>* pPreviousInputs = step.pRecord ? &step.pRecord->inputs : nullptr;
+        for (size_t i = 0; i < inputs.size(); i++) {
+            CookedFile file;
+            const CookedFile* pPrevious = pPreviousInputs && i < pPreviousInputs->size() ? &(*pPreviousInputs)[i] : nullptr;
+            if (pPrevious && pPrevious->path == inputs[i] && pPrevious->modifiedNs != 0 &&
+                CookDatabase::stat_file(inputs[i], &file) && file.bytes == pPrevious->bytes &&
+                file.modifiedNs == pPrevious->modifiedNs) {
+                file.hash = pPrevious->hash;
+            }
+            else {
+                file = CookDatabase::hash_file(inputs[i]);
+                CookDatabase::forget_racy_time(file);
+            }
+            record.inputs.push_back(file);
+        }
+
+        CookResult result;
+        step.cook(inputs, &result);
+
+        for (const std::string& input : result.inputs) {
+            if (std::find(inputs.begin(), inputs.end(), input) == inputs.end()) {
+                record.inputs.push_back(CookDatabase::hash_file(input));
+                CookDatabase::forget_racy_time(record.inputs.back());
+            }
+        }
+        // Written by the step itself, only deletions and edits by others have to be seen
+        for (const std::string& output : result.outputs) {
+            record.outputs.push_back(CookDatabase::hash_file(output));
+        }
+        step.cookedRecord = std::move(record);
+        step.state = STEP_STATE_COOKED;
+    }
+    catch (const std::exception& e) {
+        step.state = STEP_STATE_FAILED;
+        step.error = e.what();
+    }
+    mCookNs.fetch_add(Profiler::now_ns() - cookStart, std::memory_order_relaxed);
+}
+
+//------------------------------------------------------------------------------------------
+//------------------------------------------------------------------------------------------
+void CookGraph::add_reader(const std::string& path, CookStepId step) {
+    std::vector<CookStepId>& readers = mReaders[path];
+    if (std::find(readers.begin(), readers.end(), step) == readers.end()) {
+        readers.push_back(step);
+    }
+}
+
+//------------------------------------------------------------------------------------------
+// Outputs another step also wrote are kept
+//------------------------------------------------------------------------------------------
+void CookGraph::remove_stale_records() {
+    std::vector<std::string> staleSteps;
+    std::unordered_set<std::string> liveOutputs;
+    for (const std::string& name : mpDatabase->get_steps()) {
+        if (mStepIds.count(name) == 0) {
+            staleSteps.push_back(name);
+            continue;
+        }
+        for (const CookedFile& output : mpDatabase->find(name)->outputs) {
+            liveOutputs.insert(output.path);
+        }
+    }
+
+    for (const std::string& name : staleSteps) {
+        for (const CookedFile& output : mpDatabase->find(name)->outputs) {
+            if (liveOutputs.count(output.path) == 0) {
+                std::error_code error;
+                std::filesystem::remove(output.path, error);
+            }
+        }
+        mpDatabase->remove(name);
+        mStats.removedSteps++;
+    }
+}
+
+//------------------------------------------------------------------------------------------
+//------------------------------------------------------------------------------------------
+uint64_t CookGraph::hash_input_list(const std::vector<std::string>& inputs) {
+    uint64_t hash = INPUT_LIST_SEED;
+    for (const std::string& input : inputs) {
+        hash = hash_combine(hash, hash_string(input, INPUT_LIST_SEED));
+    }
+    return hash;
+}
@@ -0,0 +1,145 @@
+//======================================================================
+// DeletionQueue.cpp
+//
+// Keegan Kochis
+// Created: 2026/10/18
+// The definition of the DeletionQueue class.
+//======================================================================
+
+#include "DeletionQueue.h"
+
+#include <cstdint>
+
+#include <stdexcept>
+#include <vector>
+
+#define GLFW_INCLUDE_VULKAN
+#include <GLFW/glfw3.h>
+
+DeletionQueue::DeletionQueue() {}
+
+//------------------------------------------------------------------------------------------
+//------------------------------------------------------------------------------------------
+void DeletionQueue::init(VkDevice device, TimelineSync* pTimelineSync) {
+    mDevice = device;
+    mpTimelineSync = pTimelineSync;
+}
+
+//------------------------------------------------------------------------------------------
+//------------------------------------------------------------------------------------------
+void DeletionQueue::clean_up() {
+    for (const PendingDeletion& deletion : mPending) {
+        destroy(deletion);
+    }
+    mPending.clear();
+}
+
+//------------------------------------------------------------------------------------------
+//------------------------------------------------------------------------------------------
+DeletionQueue::RetirePoint DeletionQueue::retire_point_now() const {
+    RetirePoint retirePoint;
+    for (uint32_t queue = 0; queue < TimelineSync::QUEUE_COUNT; queue++) {
+        retirePoint.values[queue] = mpTimelineSync->last_submitted(static_cast<TimelineSync::QueueType>(queue));
+    }
+    return retirePoint;
+}
+
+//------------------------------------------------------------------------------------------
+//------------------------------------------------------------------------------------------
+DeletionQueue::RetirePoint DeletionQueue::retire_point(TimelineSync::QueueType queue, uint64_t value) {
+    RetirePoint retirePoint;
+    retirePoint.values[queue] = value;
+    return retirePoint;
+}
+
+//------------------------------------------------------------------------------------------
+// Entries are not ordered by retire point since callers may pass precise values, so the
+// whole list is scanned. Retired entries are destroyed in the order they were queued and
+// the rest keep theirs, so views go before their images and objects before their pools.
+//------------------------------------------------------------------------------------------
+uint32_t DeletionQueue::collect() {
+    if (mPending.empty()) {
+        return 0;
+    }
+
+    size_t kept = 0;
+    for (size_t i = 0; i < mPending.size(); i++) {
+        if (is_retired(mPending[i].retirePoint)) {
+            destroy(mPending[i]);
+        }
+        else {
+            mPending[kept++] = mPending[i];
+        }
+    }
+    const uint32_t destroyed = static_cast<uint32_t>(mPending.size() - kept);
+    mPending.resize(kept);
+
+    return destroyed;
+}
+
+//------------------------------------------------------------------------------------------
+//------------------------------------------------------------------------------------------
+void DeletionQueue::push(ResourceType type, uint64_t handle, const RetirePoint& retirePoint) {
+    if (handle == 0) {
+        return;
+    }
+
+    PendingDeletion deletion;
+    deletion.type = type;
+    deletion.handle = handle;
+    deletion.retirePoint = retirePoint;
+    mPending.push_back(deletion);
+}
+
+//------------------------------------------------------------------------------------------
+//------------------------------------------------------------------------------------------
+bool DeletionQueue::is_retired(const RetirePoint& retirePoint) {
+    for (uint32_t queue = 0; queue < TimelineSync::QUEUE_COUNT; queue++) {
+        if (!mpTimelineSync->is_complete(static_cast<TimelineSync::QueueType>(queue), retirePoint.values[queue])) {
+            return false;
+        }
+    }
+    return true;
+}
+
+//------------------------------------------------------------------------------------------
+// Handles are stored as integers, the casts turn them back into pointers on 64 bit platforms
+//------------------------------------------------------------------------------------------
+void DeletionQueue::destroy(const PendingDeletion& deletion) {
+    switch (deletion.type) {
+        case RESOURCE_BUFFER:
+            vkDestroyBuffer(mDevice, (VkBuffer) deletion.handle, nullptr);
+            break;
+        case RESOURCE_IMAGE:
+            vkDestroyImage(mDevice, (VkImage) deletion.handle, nullptr);
+            break;
+        case RESOURCE_IMAGE_VIEW:
+            vkDestroyImageView(mDevice, (VkImageView) deletion.handle, nullptr);
+            break;
+        case RESOURCE_SAMPLER:
+            vkDestroySampler(mDevice, (VkSampler) deletion.handle, nullptr);
+            break;
+        case RESOURCE_DEVICE_MEMORY:
+            vkFreeMemory(mDevice, (VkDeviceMemory) deletion.handle, nullptr);
+            break;
+        case RESOURCE_PIPELINE:
+            vkDestroyPipeline(mDevice, (VkPipeline) deletion.handle, nullptr);
+            break;
+        case RESOURCE_PIPELINE_LAYOUT:
+            vkDestroyPipelineLayout(mDevice, (VkPipelineLayout) deletion.handle, nullptr);
+            break;
+        case RESOURCE_DESCRIPTOR_POOL:
+            vkDestroyDescriptorPool(mDevice, (VkDescriptorPool) deletion.handle, nullptr);
+            break;
+        case RESOURCE_FRAMEBUFFER:
+            vkDestroyFramebuffer(mDevice, (VkFramebuffer) deletion.handle, nullptr);
+            break;
+        case RESOURCE_SWAPCHAIN:
+            vkDestroySwapchainKHR(mDevice, (VkSwapchainKHR) deletion.handle, nullptr);
+            break;
+        default:
+            throw std::runtime_error("Unknown resource type in deletion queue!");
+    }
+
+    mDestroyedCount++;
+}
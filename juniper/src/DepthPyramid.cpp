@@ -0,0 +1,272 @@
+//======================================================================
+// DepthPyramid.cpp
+//
+// Keegan Kochis
+// Created: 2026/10/18
+// The definition of the DepthPyramid class.
+//======================================================================
+
+#include "DepthPyramid.h"
+#include "Shader.h"
+
+#include <cstdint>
+
+#include <algorithm>
+#include <stdexcept>
+#include <vector>
+
+#define GLFW_INCLUDE_VULKAN
+#include <GLFW/glfw3.h>
+
+// Must match local_size_x and local_size_y of depth_pyramid.comp
+static const uint32_t DOWNSAMPLE_GROUP_SIZE = 8;
+
+//------------------------------------------------------------------------------------------
+//------------------------------------------------------------------------------------------
+static uint32_t previous_power_of_two(uint32_t value) {
+    uint32_t result = 1;
+    while (result * 2 <= value) {
+        result *= 2;
+    }
+    return result;
+}
+
+DepthPyramid::DepthPyramid() {}
+
+//------------------------------------------------------------------------------------------
+// Level 0 is the largest power of two that fits in the depth buffer, which keeps every
+// later level exactly half the size of the one before
+//------------------------------------------------------------------------------------------
+void DepthPyramid::init(VkDevice device, GpuResources* pGpuResources, DeletionQueue* pDeletionQueue,
+                        DescriptorAllocator* pDescriptorAllocator, ImageHandle depthImage, VkExtent2D depthExtent) {
+    mDevice = device;
+    mpGpuResources = pGpuResources;
+    mpDeletionQueue = pDeletionQueue;
+    mpDescriptorAllocator = pDescriptorAllocator;
+    mDepthImage = depthImage;
+    mDepthExtent = depthExtent;
+
+    mExtent.width = previous_power_of_two(depthExtent.width);
+    mExtent.height = previous_power_of_two(depthExtent.height);
+    mLevelCount = 1;
+    while ((std::max(mExtent.width, mExtent.height) >> mLevelCount) > 0) {
+        mLevelCount++;
+    }
+
+    VkExtent3D extent = { mExtent.width, mExtent.height, 1 };
+    mPyramid = mpGpuResources->create_image(extent, VK_FORMAT_R32_SFLOAT,
+                                            VK_IMAGE_USAGE_SAMPLED_BIT | VK_IMAGE_USAGE_STORAGE_BIT,
+                                            VK_IMAGE_ASPECT_COLOR_BIT, mLevelCount);
+
+    mLevelViews.resize(mLevelCount);
+    for (uint32_t level = 0; level < mLevelCount; level++) {
+        VkImageViewCreateInfo createInfo{};
+        createInfo.sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO;
+        createInfo.image = mpGpuResources->get_image(mPyramid);
+        createInfo.viewType = VK_IMAGE_VIEW_TYPE_2D;
+        createInfo.format = VK_FORMAT_R32_SFLOAT;
+        createInfo.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+        createInfo.subresourceRange.baseMipLevel = level;
+        createInfo.subresourceRange.levelCount = 1;
+        createInfo.subresourceRange.baseArrayLayer = 0;
+        createInfo.subresourceRange.layerCount = 1;
+
+        if (vkCreateImageView(mDevice, &createInfo, nullptr, &mLevelViews[level]) != VK_SUCCESS) {
+            throw std::runtime_error("Failed to create depth pyramid level view!");
+        }
+    }
+
+    // Texels are always fetched, never filtered
+    VkSamplerCreateInfo samplerInfo{};
+    samplerInfo.sType = VK_STRUCTURE_TYPE_SAMPLER_CREATE_INFO;
+    samplerInfo.magFilter = VK_FILTER_NEAREST;
+    samplerInfo.minFilter = VK_FILTER_NEAREST;
+    samplerInfo.mipmapMode = VK_SAMPLER_MIPMAP_MODE_NEAREST;
+    samplerInfo.addressModeU = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+    samplerInfo.addressModeV = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+    samplerInfo.addressModeW = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+    samplerInfo.minLod = 0.0f;
+    samplerInfo.maxLod = static_cast<float>(mLevelCount);
+
+    VkSampler sampler;
+    if (vkCreateSampler(mDevice, &samplerInfo, nullptr, &sampler) != VK_SUCCESS) {
+        throw std::runtime_error("Failed to create depth pyramid sampler!");
+    }
+    mSampler = mpGpuResources->add_sampler(sampler);
+
+    VkDescriptorSetLayoutBinding bindings[2]{};
+    bindings[0].binding = 0;
+    bindings[0].descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+    bindings[0].descriptorCount = 1;
+    bindings[0].stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
+    bindings[1].binding = 1;
+    bindings[1].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_IMAGE;
+    bindings[1].descriptorCount = 1;
+    bindings[1].stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
+    mSetLayout = mpDescriptorAllocator->get_layout({ bindings[0], bindings[1] });
+
+    VkPushConstantRange pushConstantRange{};
+    pushConstantRange.stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
+    pushConstantRange.offset = 0;
+    pushConstantRange.size = sizeof(PushConstants);
+
+    VkPipelineLayoutCreateInfo layoutCreateInfo{};
+    layoutCreateInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
+    layoutCreateInfo.setLayoutCount = 1;
+    layoutCreateInfo.pSetLayouts = &mSetLayout;
+    layoutCreateInfo.pushConstantRangeCount = 1;
+    layoutCreateInfo.pPushConstantRanges = &pushConstantRange;
+
+    if (vkCreatePipelineLayout(mDevice, &layoutCreateInfo, nullptr, &mPipelineLayout) != VK_SUCCESS) {
+        throw std::runtime_error("Failed to create depth pyramid pipeline layout!");
+    }
+
+    VkShaderModule shaderModule = load_shader_module(mDevice, "depth_pyramid.comp.spv");
+
+    VkComputePipelineCreateInfo createInfo{};
+    createInfo.sType = VK_STRUCTURE_TYPE_COMPUTE_PIPELINE_CREATE_INFO;
+    createInfo.stage.sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
+    createInfo.stage.stage = VK_SHADER_STAGE_COMPUTE_BIT;
+    createInfo.stage.module = shaderModule;
+    createInfo.stage.pName = "main";
+    createInfo.layout = mPipelineLayout;
+
+    VkPipeline pipeline;
+    VkResult result = vkCreateComputePipelines(mDevice, VK_NULL_HANDLE, 1, &createInfo, nullptr, &pipeline);
+    vkDestroyShaderModule(mDevice, shaderModule, nullptr);
+    if (result != VK_SUCCESS) {
+        throw std::runtime_error("Failed to create depth pyramid pipeline!");
+    }
+    mPipeline = mpGpuResources->add_pipeline(pipeline, mPipelineLayout, VK_PIPELINE_BIND_POINT_COMPUTE, true);
+
+    mLayoutInitialized = false;
+}
+
+//------------------------------------------------------------------------------------------
+// The pipeline owns its layout, the set layout is owned by the descriptor allocator's cache
+//------------------------------------------------------------------------------------------
+void DepthPyramid::clean_up() {
+    for (VkImageView view : mLevelViews) {
+        mpDeletionQueue->enqueue(DeletionQueue::RESOURCE_IMAGE_VIEW, view);
+    }
+    mLevelViews.clear();
+
+    mpGpuResources->destroy_image(mPyramid);
+    mpGpuResources->destroy_sampler(mSampler);
+    mpGpuResources->destroy_pipeline(mPipeline);
+    mPipelineLayout = VK_NULL_HANDLE;
+}
+
+//------------------------------------------------------------------------------------------
+//------------------------------------------------------------------------------------------
+void DepthPyramid::ensure_layout(VkCommandBuffer commandBuffer) {
+    if (mLayoutInitialized) {
+        return;
+    }
+
+    VkImageMemoryBarrier barrier{};
+    barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+    barrier.srcAccessMask = 0;
+    barrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT;
+    barrier.oldLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+    barrier.newLayout = VK_IMAGE_LAYOUT_GENERAL;
+    barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    barrier.image = mpGpuResources->get_image(mPyramid);
+    barrier.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+    barrier.subresourceRange.baseMipLevel = 0;
+    barrier.subresourceRange.levelCount = mLevelCount;
+    barrier.subresourceRange.baseArrayLayer = 0;
+    barrier.subresourceRange.layerCount = 1;
+
+    vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+                         0, 0, nullptr, 0, nullptr, 1, &barrier);
+    mLayoutInitialized = true;
+}
+
+//------------------------------------------------------------------------------------------
+// One dispatch per level, each reading the level before it (the depth buffer for level 0).
+// The pyramid stays in the general layout so it can be written and sampled without
+// transitions.
+//------------------------------------------------------------------------------------------
+void DepthPyramid::build(VkCommandBuffer commandBuffer) {
+    ensure_layout(commandBuffer);
+
+    // Earlier readers of the pyramid, e.g. the previous frame's culling, must be done
+    vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+                         0, 0, nullptr, 0, nullptr, 0, nullptr);
+
+    vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, mpGpuResources->get_pipeline(mPipeline));
+
+    VkImageMemoryBarrier barrier{};
+    barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+    barrier.srcAccessMask = VK_ACCESS_SHADER_WRITE_BIT;
+    barrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
+    barrier.oldLayout = VK_IMAGE_LAYOUT_GENERAL;
+    barrier.newLayout = VK_IMAGE_LAYOUT_GENERAL;
+    barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    barrier.image = mpGpuResources->get_image(mPyramid);
+    barrier.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+    barrier.subresourceRange.levelCount = 1;
+    barrier.subresourceRange.baseArrayLayer = 0;
+    barrier.subresourceRange.layerCount = 1;
+
+    uint32_t sourceWidth = mDepthExtent.width;
+    uint32_t sourceHeight = mDepthExtent.height;
+
+    for (uint32_t level = 0; level < mLevelCount; level++) {
+        const uint32_t width = std::max(mExtent.width >> level, 1u);
+        const uint32_t height = std::max(mExtent.height >> level, 1u);
+
+        VkDescriptorImageInfo sourceInfo{};
+        sourceInfo.sampler = mpGpuResources->get_sampler(mSampler);
+        if (level == 0) {
+            sourceInfo.imageView = mpGpuResources->get_image_view(mDepthImage);
+            sourceInfo.imageLayout = VK_IMAGE_LAYOUT_DEPTH_STENCIL_READ_ONLY_OPTIMAL;
+        }
+        else {
+            sourceInfo.imageView = mLevelViews[level - 1];
+            sourceInfo.imageLayout = VK_IMAGE_LAYOUT_GENERAL;
+        }
+
+        VkDescriptorImageInfo destinationInfo{};
+        destinationInfo.imageView = mLevelViews[level];
+        destinationInfo.imageLayout = VK_IMAGE_LAYOUT_GENERAL;
+
+        VkDescriptorSet descriptorSet = mpDescriptorAllocator->allocate_transient(mSetLayout);
+
+        VkWriteDescriptorSet descriptorWrites[2]{};
+        descriptorWrites[0].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+        descriptorWrites[0].dstSet = descriptorSet;
+        descriptorWrites[0].dstBinding = 0;
+        descriptorWrites[0].descriptorCount = 1;
+        descriptorWrites[0].descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+        descriptorWrites[0].pImageInfo = &sourceInfo;
+        descriptorWrites[1].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+        descriptorWrites[1].dstSet = descriptorSet;
+        descriptorWrites[1].dstBinding = 1;
+        descriptorWrites[1].descriptorCount = 1;
+        descriptorWrites[1].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_IMAGE;
+        descriptorWrites[1].pImageInfo = &destinationInfo;
+        vkUpdateDescriptorSets(mDevice, 2, descriptorWrites, 0, nullptr);
+
+        PushConstants pushConstants;
+        pushConstants.sourceWidth = static_cast<int32_t>(sourceWidth);
+        pushConstants.sourceHeight = static_cast<int32_t>(sourceHeight);
+        pushConstants.destinationWidth = static_cast<int32_t>(width);
+        pushConstants.destinationHeight = static_cast<int32_t>(height);
+
+        vkCmdBindDescriptorSets(commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, mPipelineLayout, 0, 1, &descriptorSet, 0, nullptr);
+        vkCmdPushConstants(commandBuffer, mPipelineLayout, VK_SHADER_STAGE_COMPUTE_BIT, 0, sizeof(PushConstants), &pushConstants);
+        vkCmdDispatch(commandBuffer, (width + DOWNSAMPLE_GROUP_SIZE - 1) / DOWNSAMPLE_GROUP_SIZE,
+                      (height + DOWNSAMPLE_GROUP_SIZE - 1) / DOWNSAMPLE_GROUP_SIZE, 1);
+
+        barrier.subresourceRange.baseMipLevel = level;
+        vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+                             0, 0, nullptr, 0, nullptr, 1, &barrier);
+
+        sourceWidth = width;
+        sourceHeight = height;
+    }
+}
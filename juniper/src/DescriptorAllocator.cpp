@@ -0,0 +1,392 @@
+//======================================================================
+// DescriptorAllocator.cpp
+//
+// Keegan Kochis
+// Created: 2026/10/18
+// The definition of the DescriptorAllocator class.
+//======================================================================
+
+#include "DescriptorAllocator.h"
+
+#include <cstdint>
+#include <cstring>
+
+#include <algorithm>
+#include <functional>
+#include <ostream>
+#include <stdexcept>
+#include <vector>
+
+#define GLFW_INCLUDE_VULKAN
+#include <GLFW/glfw3.h>
+
+//------------------------------------------------------------------------------------------
+// Relative amount of each descriptor type in a pool, multiplied by the pool's set count
+//------------------------------------------------------------------------------------------
+static const std::vector<std::pair<VkDescriptorType, float>> poolSizeRatios = {
+    { VK_DESCRIPTOR_TYPE_SAMPLER, 0.5f },
+    { VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, 4.0f },
+    { VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE, 4.0f },
+    { VK_DESCRIPTOR_TYPE_STORAGE_IMAGE, 1.0f },
+    { VK_DESCRIPTOR_TYPE_UNIFORM_TEXEL_BUFFER, 1.0f },
+    { VK_DESCRIPTOR_TYPE_STORAGE_TEXEL_BUFFER, 1.0f },
+    { VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, 2.0f },
+    { VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 2.0f },
+    { VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC, 1.0f },
+    { VK_DESCRIPTOR_TYPE_STORAGE_BUFFER_DYNAMIC, 1.0f },
+    { VK_DESCRIPTOR_TYPE_INPUT_ATTACHMENT, 0.5f }
+};
+
+//------------------------------------------------------------------------------------------
+// Boost style hash combining
+//------------------------------------------------------------------------------------------
+static void hash_combine(size_t& seed, uint64_t value) {
+    seed ^= std::hash<uint64_t>()(value) + 0x9e3779b9 + (seed << 6) + (seed >> 2);
+}
+
+//------------------------------------------------------------------------------------------
+// Non-dispatchable handles are pointers on 64 bit platforms and integers on 32 bit ones
+//------------------------------------------------------------------------------------------
+template <typename T>
+static uint64_t handle_bits(T handle) {
+    return (uint64_t) handle;
+}
+
+static bool is_image_descriptor(VkDescriptorType type) {
+    return type == VK_DESCRIPTOR_TYPE_SAMPLER ||
+           type == VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER ||
+           type == VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE ||
+           type == VK_DESCRIPTOR_TYPE_STORAGE_IMAGE ||
+           type == VK_DESCRIPTOR_TYPE_INPUT_ATTACHMENT;
+}
+
+//------------------------------------------------------------------------------------------
+//------------------------------------------------------------------------------------------
+bool DescriptorAllocator::LayoutKey_t::operator==(const LayoutKey_t& other) const {
+    if (hash != other.hash || bindings.size() != other.bindings.size()) {
+        return false;
+    }
+
+    for (size_t i = 0; i < bindings.size(); i++) {
+        const VkDescriptorSetLayoutBinding& a = bindings[i];
+        const VkDescriptorSetLayoutBinding& b = other.bindings[i];
+        if (a.binding != b.binding || a.descriptorType != b.descriptorType ||
+            a.descriptorCount != b.descriptorCount || a.stageFlags != b.stageFlags ||
+            a.pImmutableSamplers != b.pImmutableSamplers) {
+            return false;
+        }
+    }
+    return true;
+}
+
+//------------------------------------------------------------------------------------------
+//------------------------------------------------------------------------------------------
+bool DescriptorAllocator::SetKey_t::operator==(const SetKey_t& other) const {
+    if (hash != other.hash || layout != other.layout || writes.size() != other.writes.size()) {
+        return false;
+    }
+
+    for (size_t i = 0; i < writes.size(); i++) {
+        const DescriptorWrite& a = writes[i];
+        const DescriptorWrite& b = other.writes[i];
+        if (a.binding != b.binding || a.type != b.type) {
+            return false;
+        }
+        if (is_image_descriptor(a.type)) {
+            if (a.imageInfo.sampler != b.imageInfo.sampler ||
+                a.imageInfo.imageView != b.imageInfo.imageView ||
+                a.imageInfo.imageLayout != b.imageInfo.imageLayout) {
+                return false;
+            }
+        }
+        else if (a.bufferInfo.buffer != b.bufferInfo.buffer ||
+                 a.bufferInfo.offset != b.bufferInfo.offset ||
+                 a.bufferInfo.range != b.bufferInfo.range) {
+            return false;
+        }
+    }
+    return true;
+}
+
+const uint32_t DescriptorAllocator::INITIAL_SETS_PER_POOL;
+const uint32_t DescriptorAllocator::MAX_SETS_PER_POOL;
+
+DescriptorAllocator::DescriptorAllocator() {}
+
+//------------------------------------------------------------------------------------------
+//------------------------------------------------------------------------------------------
+void DescriptorAllocator::init(VkDevice device, uint32_t framesInFlight) {
+    if (framesInFlight == 0) {
+        throw std::runtime_error("Descriptor allocator needs at least one frame in flight!");
+    }
+
+    mDevice = device;
+    mCurrentFrame = 0;
+    mFramePools.resize(framesInFlight);
+}
+
+//------------------------------------------------------------------------------------------
+// Destroy every pool and cached layout. Sets are freed along with their pools.
+//------------------------------------------------------------------------------------------
+void DescriptorAllocator::clean_up() {
+    for (PoolChain& chain : mFramePools) {
+        for (VkDescriptorPool pool : chain.usedPools) {
+            vkDestroyDescriptorPool(mDevice, pool, nullptr);
+        }
+    }
+    mFramePools.clear();
+
+    for (VkDescriptorPool pool : mImmutablePools.usedPools) {
+        vkDestroyDescriptorPool(mDevice, pool, nullptr);
+    }
+    mImmutablePools = PoolChain();
+    mImmutableSetCache.clear();
+
+    for (VkDescriptorPool pool : mFreePools) {
+        vkDestroyDescriptorPool(mDevice, pool, nullptr);
+    }
+    mFreePools.clear();
+
+    for (const auto& entry : mLayoutCache) {
+        vkDestroyDescriptorSetLayout(mDevice, entry.second, nullptr);
+    }
+    mLayoutCache.clear();
+}
+
+//------------------------------------------------------------------------------------------
+// Reset the whole pool chain of a retired frame in one go instead of freeing its sets
+//------------------------------------------------------------------------------------------
+void DescriptorAllocator::begin_frame(uint32_t frameIndex) {
+    mCurrentFrame = frameIndex % static_cast<uint32_t>(mFramePools.size());
+    reset_chain(mFramePools[mCurrentFrame]);
+    mStats.transientSetsThisFrame = 0;
+}
+
+//------------------------------------------------------------------------------------------
+// Return a layout matching the bindings, creating it only the first time it is requested
+//------------------------------------------------------------------------------------------
+VkDescriptorSetLayout DescriptorAllocator::get_layout(const std::vector<VkDescriptorSetLayoutBinding>& bindings) {
+    LayoutKey key;
+    key.bindings = bindings;
+    // Binding order in the create info does not matter to Vulkan so don't let it split the cache
+    std::sort(key.bindings.begin(), key.bindings.end(),
+              [](const VkDescriptorSetLayoutBinding& a, const VkDescriptorSetLayoutBinding& b) {
+                  return a.binding < b.binding;
+              });
+
+    for (const VkDescriptorSetLayoutBinding& binding : key.bindings) {
+        hash_combine(key.hash, binding.binding);
+        hash_combine(key.hash, binding.descriptorType);
+        hash_combine(key.hash, binding.descriptorCount);
+        hash_combine(key.hash, binding.stageFlags);
+        hash_combine(key.hash, handle_bits(binding.pImmutableSamplers));
+    }
+
+    auto cached = mLayoutCache.find(key);
+    if (cached != mLayoutCache.end()) {
+        mStats.layoutCacheHits++;
+        return cached->second;
+    }
+
+    VkDescriptorSetLayoutCreateInfo createInfo{};
+    createInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
+    createInfo.bindingCount = static_cast<uint32_t>(key.bindings.size());
+    createInfo.pBindings = key.bindings.data();
+
+    VkDescriptorSetLayout layout;
+    if (vkCreateDescriptorSetLayout(mDevice, &createInfo, nullptr, &layout) != VK_SUCCESS) {
+        throw std::runtime_error("Failed to create descriptor set layout!");
+    }
+
+    mStats.layoutsCreated++;
+    mLayoutCache.emplace(std::move(key), layout);
+    return layout;
+}
+
+//------------------------------------------------------------------------------------------
+// Allocate a set which is only valid until the current frame slot is begun again
+//------------------------------------------------------------------------------------------
+VkDescriptorSet DescriptorAllocator::allocate_transient(VkDescriptorSetLayout layout) {
+    VkDescriptorSet set = allocate_from_chain(mFramePools[mCurrentFrame], layout);
+    mStats.transientSetsAllocated++;
+    mStats.transientSetsThisFrame++;
+    return set;
+}
+
+//------------------------------------------------------------------------------------------
+// Return a set with the given contents, reusing an identical one from an earlier frame
+//------------------------------------------------------------------------------------------
+VkDescriptorSet DescriptorAllocator::get_immutable_set(VkDescriptorSetLayout layout, const std::vector<DescriptorWrite>& writes) {
+    SetKey key;
+    key.layout = layout;
+    key.writes = writes;
+    std::sort(key.writes.begin(), key.writes.end(),
+              [](const DescriptorWrite& a, const DescriptorWrite& b) {
+                  return a.binding < b.binding;
+              });
+
+    hash_combine(key.hash, handle_bits(layout));
+    for (const DescriptorWrite& write : key.writes) {
+        hash_combine(key.hash, write.binding);
+        hash_combine(key.hash, write.type);
+        if (is_image_descriptor(write.type)) {
+            hash_combine(key.hash, handle_bits(write.imageInfo.sampler));
+            hash_combine(key.hash, handle_bits(write.imageInfo.imageView));
+            hash_combine(key.hash, write.imageInfo.imageLayout);
+        }
+        else {
+            hash_combine(key.hash, handle_bits(write.bufferInfo.buffer));
+            hash_combine(key.hash, write.bufferInfo.offset);
+            hash_combine(key.hash, write.bufferInfo.range);
+        }
+    }
+
+    auto cached = mImmutableSetCache.find(key);
+    if (cached != mImmutableSetCache.end()) {
+        mStats.immutableSetCacheHits++;
+        return cached->second;
+    }
+
+    VkDescriptorSet set = allocate_from_chain(mImmutablePools, layout);
+
+    std::vector<VkWriteDescriptorSet> descriptorWrites(key.writes.size());
+    for (size_t i = 0; i < key.writes.size(); i++) {
+        const DescriptorWrite& write = key.writes[i];
+        descriptorWrites[i].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+        descriptorWrites[i].dstSet = set;
+        descriptorWrites[i].dstBinding = write.binding;
+        descriptorWrites[i].dstArrayElement = 0;
+        descriptorWrites[i].descriptorCount = 1;
+        descriptorWrites[i].descriptorType = write.type;
+        if (is_image_descriptor(write.type)) {
+            descriptorWrites[i].pImageInfo = &write.imageInfo;
+        }
+        else {
+            descriptorWrites[i].pBufferInfo = &write.bufferInfo;
+        }
+    }
+    vkUpdateDescriptorSets(mDevice, static_cast<uint32_t>(descriptorWrites.size()), descriptorWrites.data(), 0, nullptr);
+
+    mStats.immutableSetsAllocated++;
+    mImmutableSetCache.emplace(std::move(key), set);
+    return set;
+}
+
+//------------------------------------------------------------------------------------------
+//------------------------------------------------------------------------------------------
+void DescriptorAllocator::release_immutable_sets() {
+    reset_chain(mImmutablePools);
+    mImmutableSetCache.clear();
+}
+
+//------------------------------------------------------------------------------------------
+//------------------------------------------------------------------------------------------
+void DescriptorAllocator::print_stats(std::ostream& out) const {
+    out << "Descriptor allocator stats:\n";
+    out << "\tTransient sets allocated: " << mStats.transientSetsAllocated << '\n';
+    out << "\tTransient sets this frame: " << mStats.transientSetsThisFrame << '\n';
+    out << "\tImmutable sets allocated: " << mStats.immutableSetsAllocated << '\n';
+    out << "\tImmutable set cache hits: " << mStats.immutableSetCacheHits << '\n';
+    out << "\tLayouts created: " << mStats.layoutsCreated << '\n';
+    out << "\tLayout cache hits: " << mStats.layoutCacheHits << '\n';
+    out << "\tPools created: " << mStats.poolsCreated << '\n';
+    out << "\tPool resets: " << mStats.poolResets << '\n';
+    out << "\tPool exhaustions: " << mStats.poolExhaustions << '\n';
+    out << "\tPools in use / free: " << mStats.poolsInUse << " / " << mStats.poolsFree << '\n';
+}
+
+//------------------------------------------------------------------------------------------
+// Reuse a reset pool if there is one, otherwise grow by creating a bigger pool
+//------------------------------------------------------------------------------------------
+VkDescriptorPool DescriptorAllocator::grab_pool() {
+    VkDescriptorPool pool;
+    if (!mFreePools.empty()) {
+        pool = mFreePools.back();
+        mFreePools.pop_back();
+        mStats.poolsFree--;
+    }
+    else {
+        pool = create_pool(mNextPoolSize);
+        mNextPoolSize = std::min(mNextPoolSize * 2, MAX_SETS_PER_POOL);
+    }
+
+    mStats.poolsInUse++;
+    return pool;
+}
+
+//------------------------------------------------------------------------------------------
+//------------------------------------------------------------------------------------------
+VkDescriptorPool DescriptorAllocator::create_pool(uint32_t maxSets) {
+    std::vector<VkDescriptorPoolSize> poolSizes;
+    poolSizes.reserve(poolSizeRatios.size());
+    for (const auto& ratio : poolSizeRatios) {
+        VkDescriptorPoolSize poolSize{};
+        poolSize.type = ratio.first;
+        poolSize.descriptorCount = std::max(1u, static_cast<uint32_t>(ratio.second * maxSets));
+        poolSizes.push_back(poolSize);
+    }
+
+    // No VK_DESCRIPTOR_POOL_CREATE_FREE_DESCRIPTOR_SET_BIT, sets are only ever released by a pool reset
+    VkDescriptorPoolCreateInfo createInfo{};
+    createInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
+    createInfo.flags = 0;
+    createInfo.maxSets = maxSets;
+    createInfo.poolSizeCount = static_cast<uint32_t>(poolSizes.size());
+    createInfo.pPoolSizes = poolSizes.data();
+
+    VkDescriptorPool pool;
+    if (vkCreateDescriptorPool(mDevice, &createInfo, nullptr, &pool) != VK_SUCCESS) {
+        throw std::runtime_error("Failed to create descriptor pool!");
+    }
+
+    mStats.poolsCreated++;
+    return pool;
+}
+
+//------------------------------------------------------------------------------------------
+// Allocate from the chain's current pool, moving on to a fresh pool when it runs out
+//------------------------------------------------------------------------------------------
+VkDescriptorSet DescriptorAllocator::allocate_from_chain(PoolChain& chain, VkDescriptorSetLayout layout) {
+    if (chain.currentPool == VK_NULL_HANDLE) {
+        chain.currentPool = grab_pool();
+        chain.usedPools.push_back(chain.currentPool);
+    }
+
+    VkDescriptorSetAllocateInfo allocateInfo{};
+    allocateInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
+    allocateInfo.descriptorPool = chain.currentPool;
+    allocateInfo.descriptorSetCount = 1;
+    allocateInfo.pSetLayouts = &layout;
+
+    VkDescriptorSet set;
+    VkResult result = vkAllocateDescriptorSets(mDevice, &allocateInfo, &set);
+    if (result == VK_ERROR_OUT_OF_POOL_MEMORY || result == VK_ERROR_FRAGMENTED_POOL) {
+        mStats.poolExhaustions++;
+
+        chain.currentPool = grab_pool();
+        chain.usedPools.push_back(chain.currentPool);
+        allocateInfo.descriptorPool = chain.currentPool;
+        result = vkAllocateDescriptorSets(mDevice, &allocateInfo, &set);
+    }
+
+    if (result != VK_SUCCESS) {
+        throw std::runtime_error("Failed to allocate descriptor set!");
+    }
+
+    return set;
+}
+
+//------------------------------------------------------------------------------------------
+//------------------------------------------------------------------------------------------
+void DescriptorAllocator::reset_chain(PoolChain& chain) {
+    for (VkDescriptorPool pool : chain.usedPools) {
+        vkResetDescriptorPool(mDevice, pool, 0);
+        mFreePools.push_back(pool);
+        mStats.poolResets++;
+        mStats.poolsInUse--;
+        mStats.poolsFree++;
+    }
+
+    chain.usedPools.clear();
+    chain.currentPool = VK_NULL_HANDLE;
+}
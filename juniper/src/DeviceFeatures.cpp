@@ -0,0 +1,436 @@
+//======================================================================
+// DeviceFeatures.cpp
+//
+// Keegan Kochis
+// Created: 2026/10/18
+// The definition of the DeviceFeatures class.
+//======================================================================
+
+#include "DeviceFeatures.h"
+
+#include <cstdint>
+#include <cstring>
+
+#include <algorithm>
+#include <ostream>
+#include <string>
+#include <vector>
+
+#define GLFW_INCLUDE_VULKAN
+#include <GLFW/glfw3.h>
+
+// Lives in vulkan_beta.h, which is not included. Must be enabled whenever a device (MoltenVK) exposes it.
+static const char* PORTABILITY_SUBSET_EXTENSION_NAME = "VK_KHR_portability_subset";
+
+DeviceFeatures::DeviceFeatures() {}
+
+//------------------------------------------------------------------------------------------
+// vkEnumerateInstanceVersion does not exist on 1.0 loaders so it has to be looked up
+//------------------------------------------------------------------------------------------
+uint32_t DeviceFeatures::query_instance_version() {
+    auto func = (PFN_vkEnumerateInstanceVersion) vkGetInstanceProcAddr(nullptr, "vkEnumerateInstanceVersion");
+
+    uint32_t loaderVersion = VK_API_VERSION_1_0;
+    if (func != nullptr && func(&loaderVersion) != VK_SUCCESS) {
+        loaderVersion = VK_API_VERSION_1_0;
+    }
+
+#ifdef VK_API_VERSION_1_3
+    const uint32_t highestKnownVersion = VK_API_VERSION_1_3;
+#else
+    const uint32_t highestKnownVersion = VK_API_VERSION_1_2;
+#endif
+
+    // Drop the patch version, it is meaningless in VkApplicationInfo::apiVersion
+    loaderVersion = VK_MAKE_VERSION(VK_VERSION_MAJOR(loaderVersion), VK_VERSION_MINOR(loaderVersion), 0);
+    return std::min(loaderVersion, highestKnownVersion);
+}
+
+//------------------------------------------------------------------------------------------
+// Query what the device supports and enable the curated subset of it.
+// Promoted features are read through the VulkanXXFeatures structs on devices that have the
+// core version, and through the original extension structs otherwise.
+//------------------------------------------------------------------------------------------
+void DeviceFeatures::negotiate(VkInstance instance, VkPhysicalDevice device, uint32_t instanceVersion,
+                               const std::vector<const char*>& requiredExtensions) {
+    mCapabilities = Capabilities();
+    mExtensionNames.assign(requiredExtensions.begin(), requiredExtensions.end());
+    mFeatures2 = VkPhysicalDeviceFeatures2{};
+    mVulkan11Features = VkPhysicalDeviceVulkan11Features{};
+    mVulkan12Features = VkPhysicalDeviceVulkan12Features{};
+#ifdef VK_API_VERSION_1_3
+    mVulkan13Features = VkPhysicalDeviceVulkan13Features{};
+#endif
+    mTimelineSemaphoreFeatures = VkPhysicalDeviceTimelineSemaphoreFeatures{};
+    mBufferDeviceAddressFeatures = VkPhysicalDeviceBufferDeviceAddressFeatures{};
+    mShaderDrawParametersFeatures = VkPhysicalDeviceShaderDrawParametersFeatures{};
+#ifdef VK_KHR_dynamic_rendering
+    mDynamicRenderingFeatures = VkPhysicalDeviceDynamicRenderingFeaturesKHR{};
+#endif
+#ifdef VK_KHR_synchronization2
+    mSynchronization2Features = VkPhysicalDeviceSynchronization2FeaturesKHR{};
+#endif
+    mMeshShaderFeatures = VkPhysicalDeviceMeshShaderFeaturesNV{};
+
+    VkPhysicalDeviceProperties properties;
+    vkGetPhysicalDeviceProperties(device, &properties);
+    mCapabilities.apiVersion = std::min(instanceVersion, properties.apiVersion);
+    const uint32_t minorVersion = VK_VERSION_MINOR(mCapabilities.apiVersion);
+
+    uint32_t extensionCount = 0;
+    vkEnumerateDeviceExtensionProperties(device, nullptr, &extensionCount, nullptr);
+    std::vector<VkExtensionProperties> availableExtensions(extensionCount);
+    vkEnumerateDeviceExtensionProperties(device, nullptr, &extensionCount, availableExtensions.data());
+
+    enable_extension(availableExtensions, PORTABILITY_SUBSET_EXTENSION_NAME);
+
+    auto getFeatures2 = (PFN_vkGetPhysicalDeviceFeatures2) vkGetInstanceProcAddr(instance, "vkGetPhysicalDeviceFeatures2");
+    mUseFeatures2 = minorVersion >= 1 && getFeatures2 != nullptr;
+
+    // Structs filled in by the query, kept apart from the ones handed to vkCreateDevice
+    VkPhysicalDeviceFeatures2 supported{};
+    supported.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2;
+    VkPhysicalDeviceVulkan11Features supported11{};
+    supported11.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_1_FEATURES;
+    VkPhysicalDeviceVulkan12Features supported12{};
+    supported12.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_2_FEATURES;
+#ifdef VK_API_VERSION_1_3
+    VkPhysicalDeviceVulkan13Features supported13{};
+    supported13.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_3_FEATURES;
+#endif
+    VkPhysicalDeviceTimelineSemaphoreFeatures supportedTimeline{};
+    supportedTimeline.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_TIMELINE_SEMAPHORE_FEATURES;
+    VkPhysicalDeviceBufferDeviceAddressFeatures supportedDeviceAddress{};
+    supportedDeviceAddress.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_BUFFER_DEVICE_ADDRESS_FEATURES;
+    VkPhysicalDeviceShaderDrawParametersFeatures supportedDrawParameters{};
+    supportedDrawParameters.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_SHADER_DRAW_PARAMETERS_FEATURES;
+#ifdef VK_KHR_dynamic_rendering
+    VkPhysicalDeviceDynamicRenderingFeaturesKHR supportedDynamicRendering{};
+    supportedDynamicRendering.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DYNAMIC_RENDERING_FEATURES_KHR;
+#endif
+#ifdef VK_KHR_synchronization2
+    VkPhysicalDeviceSynchronization2FeaturesKHR supportedSynchronization2{};
+    supportedSynchronization2.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_SYNCHRONIZATION_2_FEATURES_KHR;
+#endif
+    VkPhysicalDeviceMeshShaderFeaturesNV supportedMeshShader{};
+    supportedMeshShader.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_MESH_SHADER_FEATURES_NV;
+
+    // Without features2 the feature structs of these extensions can't be queried or chained,
+    // so they stay off rather than be enabled with their features unknown
+    const bool hasTimelineExtension = mUseFeatures2 && enable_extension(availableExtensions, VK_KHR_TIMELINE_SEMAPHORE_EXTENSION_NAME);
+    const bool hasDrawCountExtension = mUseFeatures2 && enable_extension(availableExtensions, VK_KHR_DRAW_INDIRECT_COUNT_EXTENSION_NAME);
+    const bool hasDeviceAddressExtension = mUseFeatures2 && enable_extension(availableExtensions, VK_KHR_BUFFER_DEVICE_ADDRESS_EXTENSION_NAME);
+#ifdef VK_KHR_dynamic_rendering
+    const bool hasDynamicRenderingExtension = mUseFeatures2 && enable_extension(availableExtensions, VK_KHR_DYNAMIC_RENDERING_EXTENSION_NAME);
+#endif
+#ifdef VK_KHR_synchronization2
+    const bool hasSynchronization2Extension = mUseFeatures2 && enable_extension(availableExtensions, VK_KHR_SYNCHRONIZATION_2_EXTENSION_NAME);
+#endif
+    const bool hasMeshShaderExtension = mUseFeatures2 && enable_extension(availableExtensions, VK_NV_MESH_SHADER_EXTENSION_NAME);
+    // The budget is read through vkGetPhysicalDeviceMemoryProperties2, core in 1.1
+    mCapabilities.memoryBudget = mUseFeatures2 && enable_extension(availableExtensions, VK_EXT_MEMORY_BUDGET_EXTENSION_NAME);
+
+    if (mUseFeatures2) {
+        void** ppNext = &supported.pNext;
+        auto chain = [&ppNext](void* pStruct, void** ppStructNext) {
+            *ppNext = pStruct;
+            ppNext = ppStructNext;
+        };
+
+        if (minorVersion >= 2) {
+            chain(&supported11, &supported11.pNext);
+            chain(&supported12, &supported12.pNext);
+        }
+        else {
+            chain(&supportedDrawParameters, &supportedDrawParameters.pNext);
+            if (hasTimelineExtension) chain(&supportedTimeline, &supportedTimeline.pNext);
+            if (hasDeviceAddressExtension) chain(&supportedDeviceAddress, &supportedDeviceAddress.pNext);
+        }
+#ifdef VK_API_VERSION_1_3
+        if (minorVersion >= 3) {
+            chain(&supported13, &supported13.pNext);
+        }
+        else
+#endif
+        {
+#ifdef VK_KHR_dynamic_rendering
+            if (hasDynamicRenderingExtension) chain(&supportedDynamicRendering, &supportedDynamicRendering.pNext);
+#endif
+#ifdef VK_KHR_synchronization2
+            if (hasSynchronization2Extension) chain(&supportedSynchronization2, &supportedSynchronization2.pNext);
+#endif
+        }
+        if (hasMeshShaderExtension) chain(&supportedMeshShader, &supportedMeshShader.pNext);
+
+        getFeatures2(device, &supported);
+    }
+    else {
+        vkGetPhysicalDeviceFeatures(device, &supported.features);
+    }
+
+    // Core features
+    VkPhysicalDeviceFeatures& enabled = mFeatures2.features;
+    enabled.multiDrawIndirect = supported.features.multiDrawIndirect;
+    enabled.drawIndirectFirstInstance = supported.features.drawIndirectFirstInstance;
+    enabled.samplerAnisotropy = supported.features.samplerAnisotropy;
+    enabled.textureCompressionBC = supported.features.textureCompressionBC;
+    enabled.shaderInt16 = supported.features.shaderInt16;
+    mCapabilities.multiDrawIndirect = enabled.multiDrawIndirect;
+    mCapabilities.drawIndirectFirstInstance = enabled.drawIndirectFirstInstance;
+    mCapabilities.samplerAnisotropy = enabled.samplerAnisotropy;
+    mCapabilities.textureCompressionBC = enabled.textureCompressionBC;
+    mCapabilities.shaderInt16 = enabled.shaderInt16;
+
+    // Promoted to 1.1 / 1.2
+    if (minorVersion >= 2) {
+        mVulkan11Features.shaderDrawParameters = supported11.shaderDrawParameters;
+        mVulkan11Features.storageBuffer16BitAccess = supported11.storageBuffer16BitAccess;
+        mVulkan12Features.timelineSemaphore = supported12.timelineSemaphore;
+        mVulkan12Features.drawIndirectCount = supported12.drawIndirectCount;
+        mVulkan12Features.bufferDeviceAddress = supported12.bufferDeviceAddress;
+        mVulkan12Features.samplerFilterMinmax = supported12.samplerFilterMinmax;
+        mVulkan12Features.hostQueryReset = supported12.hostQueryReset;
+        mVulkan12Features.descriptorIndexing = supported12.descriptorIndexing;
+        mVulkan12Features.runtimeDescriptorArray = supported12.runtimeDescriptorArray;
+        mVulkan12Features.descriptorBindingPartiallyBound = supported12.descriptorBindingPartiallyBound;
+        mVulkan12Features.shaderSampledImageArrayNonUniformIndexing = supported12.shaderSampledImageArrayNonUniformIndexing;
+
+        mCapabilities.shaderDrawParameters = mVulkan11Features.shaderDrawParameters;
+        mCapabilities.storageBuffer16BitAccess = mVulkan11Features.storageBuffer16BitAccess;
+        mCapabilities.timelineSemaphore = mVulkan12Features.timelineSemaphore;
+        mCapabilities.drawIndirectCount = mVulkan12Features.drawIndirectCount;
+        mCapabilities.bufferDeviceAddress = mVulkan12Features.bufferDeviceAddress;
+        mCapabilities.samplerFilterMinmax = mVulkan12Features.samplerFilterMinmax;
+        mCapabilities.hostQueryReset = mVulkan12Features.hostQueryReset;
+        mCapabilities.descriptorIndexing = mVulkan12Features.descriptorIndexing &&
+                                           mVulkan12Features.runtimeDescriptorArray &&
+                                           mVulkan12Features.descriptorBindingPartiallyBound;
+    }
+    else if (mUseFeatures2) {
+        mShaderDrawParametersFeatures.shaderDrawParameters = supportedDrawParameters.shaderDrawParameters;
+        mTimelineSemaphoreFeatures.timelineSemaphore = hasTimelineExtension && supportedTimeline.timelineSemaphore;
+        mBufferDeviceAddressFeatures.bufferDeviceAddress = hasDeviceAddressExtension && supportedDeviceAddress.bufferDeviceAddress;
+
+        mCapabilities.shaderDrawParameters = mShaderDrawParametersFeatures.shaderDrawParameters;
+        mCapabilities.timelineSemaphore = mTimelineSemaphoreFeatures.timelineSemaphore;
+        mCapabilities.bufferDeviceAddress = mBufferDeviceAddressFeatures.bufferDeviceAddress;
+        // The extension has no feature bit, exposing it is enough
+        mCapabilities.drawIndirectCount = hasDrawCountExtension;
+    }
+
+    // Promoted to 1.3
+#ifdef VK_API_VERSION_1_3
+    if (minorVersion >= 3) {
+        mVulkan13Features.dynamicRendering = supported13.dynamicRendering;
+        mVulkan13Features.synchronization2 = supported13.synchronization2;
+        mCapabilities.dynamicRendering = mVulkan13Features.dynamicRendering;
+        mCapabilities.synchronization2 = mVulkan13Features.synchronization2;
+    }
+    else
+#endif
+    if (mUseFeatures2) {
+#ifdef VK_KHR_dynamic_rendering
+        mDynamicRenderingFeatures.dynamicRendering = hasDynamicRenderingExtension && supportedDynamicRendering.dynamicRendering;
+        mCapabilities.dynamicRendering = mDynamicRenderingFeatures.dynamicRendering;
+#endif
+#ifdef VK_KHR_synchronization2
+        mSynchronization2Features.synchronization2 = hasSynchronization2Extension && supportedSynchronization2.synchronization2;
+        mCapabilities.synchronization2 = mSynchronization2Features.synchronization2;
+#endif
+    }
+
+    if (hasMeshShaderExtension) {
+        mMeshShaderFeatures.taskShader = supportedMeshShader.taskShader;
+        mMeshShaderFeatures.meshShader = supportedMeshShader.meshShader;
+        mCapabilities.meshShader = mMeshShaderFeatures.taskShader && mMeshShaderFeatures.meshShader;
+    }
+
+    build_feature_chain();
+    choose_tier();
+}
+
+//------------------------------------------------------------------------------------------
+//------------------------------------------------------------------------------------------
+void DeviceFeatures::populate_device_create_info(VkDeviceCreateInfo& createInfo) {
+    mEnabledExtensions.clear();
+    for (const std::string& name : mExtensionNames) {
+        mEnabledExtensions.push_back(name.c_str());
+    }
+
+    createInfo.enabledExtensionCount = static_cast<uint32_t>(mEnabledExtensions.size());
+    createInfo.ppEnabledExtensionNames = mEnabledExtensions.data();
+
+    // pEnabledFeatures must be null when VkPhysicalDeviceFeatures2 is chained
+    if (mUseFeatures2) {
+        createInfo.pNext = &mFeatures2;
+        createInfo.pEnabledFeatures = nullptr;
+    }
+    else {
+        createInfo.pNext = nullptr;
+        createInfo.pEnabledFeatures = &mFeatures2.features;
+    }
+}
+
+//------------------------------------------------------------------------------------------
+//------------------------------------------------------------------------------------------
+void DeviceFeatures::print(std::ostream& out) const {
+    out << "Vulkan device capabilities:\n";
+    out << "\tAPI version: " << VK_VERSION_MAJOR(mCapabilities.apiVersion) << '.'
+        << VK_VERSION_MINOR(mCapabilities.apiVersion) << '.'
+        << VK_VERSION_PATCH(mCapabilities.apiVersion) << '\n';
+    out << "\tCapability tier: " << tier_name(mCapabilities.tier) << '\n';
+
+    out << "\tEnabled extensions:\n";
+    for (const std::string& name : mExtensionNames) {
+        out << "\t\t" << name << '\n';
+    }
+
+    const std::pair<const char*, bool> features[] = {
+        { "multiDrawIndirect", mCapabilities.multiDrawIndirect },
+        { "drawIndirectFirstInstance", mCapabilities.drawIndirectFirstInstance },
+        { "samplerAnisotropy", mCapabilities.samplerAnisotropy },
+        { "textureCompressionBC", mCapabilities.textureCompressionBC },
+        { "shaderInt16", mCapabilities.shaderInt16 },
+        { "timelineSemaphore", mCapabilities.timelineSemaphore },
+        { "drawIndirectCount", mCapabilities.drawIndirectCount },
+        { "bufferDeviceAddress", mCapabilities.bufferDeviceAddress },
+        { "descriptorIndexing", mCapabilities.descriptorIndexing },
+        { "samplerFilterMinmax", mCapabilities.samplerFilterMinmax },
+        { "hostQueryReset", mCapabilities.hostQueryReset },
+        { "shaderDrawParameters", mCapabilities.shaderDrawParameters },
+        { "storageBuffer16BitAccess", mCapabilities.storageBuffer16BitAccess },
+        { "dynamicRendering", mCapabilities.dynamicRendering },
+        { "synchronization2", mCapabilities.synchronization2 },
+        { "memoryBudget", mCapabilities.memoryBudget },
+        { "meshShader", mCapabilities.meshShader }
+    };
+
+    out << "\tEnabled features:\n";
+    for (const auto& feature : features) {
+        if (feature.second) {
+            out << "\t\t" << feature.first << '\n';
+        }
+    }
+}
+
+//------------------------------------------------------------------------------------------
+//------------------------------------------------------------------------------------------
+const char* DeviceFeatures::tier_name(CapabilityTier tier) {
+    switch (tier) {
+        case CAPABILITY_TIER_LEGACY: return "Legacy";
+        case CAPABILITY_TIER_GPU_DRIVEN: return "GPU driven";
+        case CAPABILITY_TIER_INDIRECT_COUNT: return "GPU driven, indirect count";
+    }
+    return "Unknown";
+}
+
+//------------------------------------------------------------------------------------------
+// Add the extension to the enabled list if the device has it
+//------------------------------------------------------------------------------------------
+bool DeviceFeatures::enable_extension(const std::vector<VkExtensionProperties>& available, const char* name) {
+    if (std::find(mExtensionNames.begin(), mExtensionNames.end(), name) != mExtensionNames.end()) {
+        return true;
+    }
+
+    for (const VkExtensionProperties& extension : available) {
+        if (strcmp(extension.extensionName, name) == 0) {
+            mExtensionNames.push_back(name);
+            return true;
+        }
+    }
+    return false;
+}
+
+//------------------------------------------------------------------------------------------
+// Link the structs that hold enabled features behind mFeatures2
+//------------------------------------------------------------------------------------------
+void DeviceFeatures::build_feature_chain() {
+    mFeatures2.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2;
+    mVulkan11Features.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_1_FEATURES;
+    mVulkan12Features.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_2_FEATURES;
+#ifdef VK_API_VERSION_1_3
+    mVulkan13Features.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_3_FEATURES;
+#endif
+    mTimelineSemaphoreFeatures.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_TIMELINE_SEMAPHORE_FEATURES;
+    mBufferDeviceAddressFeatures.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_BUFFER_DEVICE_ADDRESS_FEATURES;
+    mShaderDrawParametersFeatures.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_SHADER_DRAW_PARAMETERS_FEATURES;
+#ifdef VK_KHR_dynamic_rendering
+    mDynamicRenderingFeatures.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DYNAMIC_RENDERING_FEATURES_KHR;
+#endif
+#ifdef VK_KHR_synchronization2
+    mSynchronization2Features.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_SYNCHRONIZATION_2_FEATURES_KHR;
+#endif
+    mMeshShaderFeatures.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_MESH_SHADER_FEATURES_NV;
+
+    if (!mUseFeatures2) {
+        mFeatures2.pNext = nullptr;
+        return;
+    }
+
+    const uint32_t minorVersion = VK_VERSION_MINOR(mCapabilities.apiVersion);
+
+    void** ppNext = &mFeatures2.pNext;
+    auto chain = [&ppNext](void* pStruct, void** ppStructNext) {
+        *ppNext = pStruct;
+        ppNext = ppStructNext;
+    };
+
+    if (minorVersion >= 2) {
+        chain(&mVulkan11Features, &mVulkan11Features.pNext);
+        chain(&mVulkan12Features, &mVulkan12Features.pNext);
+    }
+    else {
+        chain(&mShaderDrawParametersFeatures, &mShaderDrawParametersFeatures.pNext);
+        if (mTimelineSemaphoreFeatures.timelineSemaphore) {
+            chain(&mTimelineSemaphoreFeatures, &mTimelineSemaphoreFeatures.pNext);
+        }
+        if (mBufferDeviceAddressFeatures.bufferDeviceAddress) {
+            chain(&mBufferDeviceAddressFeatures, &mBufferDeviceAddressFeatures.pNext);
+        }
+    }
+
+#ifdef VK_API_VERSION_1_3
+    if (minorVersion >= 3) {
+        chain(&mVulkan13Features, &mVulkan13Features.pNext);
+    }
+    else
+#endif
+    {
+#ifdef VK_KHR_dynamic_rendering
+        if (mDynamicRenderingFeatures.dynamicRendering) {
+            chain(&mDynamicRenderingFeatures, &mDynamicRenderingFeatures.pNext);
+        }
+#endif
+#ifdef VK_KHR_synchronization2
+        if (mSynchronization2Features.synchronization2) {
+            chain(&mSynchronization2Features, &mSynchronization2Features.pNext);
+        }
+#endif
+    }
+
+    if (mCapabilities.meshShader) {
+        chain(&mMeshShaderFeatures, &mMeshShaderFeatures.pNext);
+    }
+
+    *ppNext = nullptr;
+}
+
+//------------------------------------------------------------------------------------------
+//------------------------------------------------------------------------------------------
+void DeviceFeatures::choose_tier() {
+    const Capabilities& c = mCapabilities;
+
+    // What the renderers' paths use, timeline semaphores and mesh shaders are picked on their own
+    bool gpuDriven = c.multiDrawIndirect && c.drawIndirectFirstInstance;
+    bool indirectCount = gpuDriven && c.drawIndirectCount;
+
+    if (indirectCount) {
+        mCapabilities.tier = CAPABILITY_TIER_INDIRECT_COUNT;
+    }
+    else if (gpuDriven) {
+        mCapabilities.tier = CAPABILITY_TIER_GPU_DRIVEN;
+    }
+    else {
+        mCapabilities.tier = CAPABILITY_TIER_LEGACY;
+    }
+}
@@ -0,0 +1,92 @@
+//======================================================================
+// EntityCommandBuffer.cpp
+//
+// Keegan Kochis
+// Created: 2026/10/18
+// The definition of the EntityCommandBuffer class.
+//======================================================================
+
+#include "EntityCommandBuffer.h"
+
+#include <cstdint>
+#include <cstring>
+
+#include <vector>
+
+//------------------------------------------------------------------------------------------
+//------------------------------------------------------------------------------------------
+EntityCommandBuffer::PendingEntity EntityCommandBuffer::create_entity() {
+    PendingEntity entity;
+    entity.index = mPendingCount++;
+    record(COMMAND_CREATE, entity.index, true, 0, nullptr, 0);
+    return entity;
+}
+
+//------------------------------------------------------------------------------------------
+//------------------------------------------------------------------------------------------
+void EntityCommandBuffer::destroy_entity(Entity entity) {
+    record(COMMAND_DESTROY, entity.value(), false, 0, nullptr, 0);
+}
+
+//------------------------------------------------------------------------------------------
+// Component values are copied into mData unaligned, they are only ever read with memcpy
+//------------------------------------------------------------------------------------------
+void EntityCommandBuffer::record(CommandType type, uint32_t target, bool pending, uint32_t componentId,
+                                 const void* pData, uint32_t size) {
+    Command command;
+    command.type = type;
+    command.target = target;
+    command.pending = pending;
+    command.componentId = componentId;
+    command.dataOffset = static_cast<uint32_t>(mData.size());
+
+    if (size > 0) {
+        mData.resize(mData.size() + size);
+        std::memcpy(mData.data() + command.dataOffset, pData, size);
+    }
+    mCommands.push_back(command);
+}
+
+//------------------------------------------------------------------------------------------
+//------------------------------------------------------------------------------------------
+std::vector<Entity> EntityCommandBuffer::playback(EntityWorld& world) {
+    std::vector<Entity> created;
+    created.reserve(mPendingCount);
+
+    for (const Command& command : mCommands) {
+        if (command.type == COMMAND_CREATE) {
+            created.push_back(world.create_entity());
+            continue;
+        }
+
+        const Entity entity = command.pending ? created[command.target] : Entity::from_value(command.target);
+        if (!world.is_alive(entity)) {
+            continue;
+        }
+
+        switch (command.type) {
+            case COMMAND_DESTROY:
+                world.destroy_entity(entity);
+                break;
+            case COMMAND_ADD:
+                world.add_component_data(entity, command.componentId, mData.data() + command.dataOffset);
+                break;
+            case COMMAND_REMOVE:
+                world.remove_component_data(entity, command.componentId);
+                break;
+            default:
+                break;
+        }
+    }
+
+    clear();
+    return created;
+}
+
+//------------------------------------------------------------------------------------------
+//------------------------------------------------------------------------------------------
+void EntityCommandBuffer::clear() {
+    mCommands.clear();
+    mData.clear();
+    mPendingCount = 0;
+}
@@ -0,0 +1,425 @@
+//======================================================================
+// EntityWorld.cpp
+//
+// Keegan Kochis
+// Created: 2026/10/18
+// The definition of the EntityWorld class.
+//======================================================================
+
+#include "EntityWorld.h"
+
+#include <cstdint>
+#include <cstring>
+
+#include <algorithm>
+#include <new>
+#include <ostream>
+#include <stdexcept>
+#include <vector>
+
+static uint32_t align_up(uint32_t value, uint32_t alignment) {
+    return (value + alignment - 1) / alignment * alignment;
+}
+
+//------------------------------------------------------------------------------------------
+// Index 0 is the empty archetype, the home of entities without components
+//------------------------------------------------------------------------------------------
+EntityWorld::EntityWorld() {
+    find_archetype(0);
+}
+
+EntityWorld::~EntityWorld() {
+    clean_up();
+}
+
+//------------------------------------------------------------------------------------------
+//------------------------------------------------------------------------------------------
+void EntityWorld::clean_up() {
+    for (Archetype& archetype : mArchetypes) {
+        for (Chunk& chunk : archetype.chunks) {
+            mFreeChunks.push_back(chunk.pData);
+        }
+    }
+    for (uint8_t* pChunk : mFreeChunks) {
+        ::operator delete(pChunk, std::align_val_t(CHUNK_ALIGNMENT));
+    }
+
+    mArchetypes.clear();
+    mArchetypeLookup.clear();
+    mEntities.clear();
+    mFreeEntities.clear();
+    mQueries.clear();
+    mFreeChunks.clear();
+    mChunkCount = 0;
+    mEntityCount = 0;
+    mStructuralChanges = 0;
+    mIterationDepth = 0;
+
+    find_archetype(0);
+}
+
+//------------------------------------------------------------------------------------------
+// Components of the new row are left uninitialized for the caller to write
+//------------------------------------------------------------------------------------------
+Entity EntityWorld::create_entity_with(ComponentMask mask) {
+    check_structural_change();
+
+    uint32_t index;
+    if (!mFreeEntities.empty()) {
+        index = mFreeEntities.back();
+        mFreeEntities.pop_back();
+    }
+    else {
+        if (mEntities.size() > Entity::MAX_INDEX) {
+            throw std::runtime_error("Failed to create entity, the world is full!");
+        }
+        index = static_cast<uint32_t>(mEntities.size());
+        mEntities.push_back(EntityRecord());
+    }
+
+    const uint32_t archetypeIndex = find_archetype(mask);
+    Entity entity(index, mEntities[index].generation);
+
+    uint32_t chunkIndex;
+    uint32_t row;
+    allocate_row(archetypeIndex, chunkIndex, row);
+    reinterpret_cast<Entity*>(mArchetypes[archetypeIndex].chunks[chunkIndex].pData)[row] = entity;
+
+    EntityRecord& record = mEntities[index];
+    record.archetype = archetypeIndex;
+    record.chunk = chunkIndex;
+    record.row = row;
+
+    mEntityCount++;
+    mStructuralChanges++;
+    return entity;
+}
+
+//------------------------------------------------------------------------------------------
+//------------------------------------------------------------------------------------------
+void EntityWorld::destroy_entity(Entity entity) {
+    check_structural_change();
+    const EntityRecord& record = checked_record(entity);
+    remove_row(record.archetype, record.chunk, record.row);
+
+    EntityRecord& freed = mEntities[entity.index()];
+    freed.archetype = INVALID_INDEX;
+    freed.generation = (freed.generation + 1) & Entity::GENERATION_MASK;
+    if (freed.generation == 0) {
+        freed.generation = 1;
+    }
+    mFreeEntities.push_back(entity.index());
+
+    mEntityCount--;
+    mStructuralChanges++;
+}
+
+//------------------------------------------------------------------------------------------
+//------------------------------------------------------------------------------------------
+bool EntityWorld::is_alive(Entity entity) const {
+    if (entity.is_null() || entity.index() >= mEntities.size()) {
+        return false;
+    }
+    const EntityRecord& record = mEntities[entity.index()];
+    return record.generation == entity.generation() && record.archetype != INVALID_INDEX;
+}
+
+//------------------------------------------------------------------------------------------
+//------------------------------------------------------------------------------------------
+void EntityWorld::add_component_data(Entity entity, uint32_t componentId, const void* pData) {
+    const EntityRecord& record = checked_record(entity);
+    const ComponentMask bit = ComponentMask(1) << componentId;
+
+    if ((mArchetypes[record.archetype].mask & bit) == 0) {
+        check_structural_change();
+
+        uint32_t target = mArchetypes[record.archetype].addEdges[componentId];
+        if (target == INVALID_INDEX) {
+            // May grow the archetype list, so the source is looked up again
+            target = find_archetype(mArchetypes[record.archetype].mask | bit);
+            mArchetypes[record.archetype].addEdges[componentId] = target;
+        }
+        move_entity(entity, target);
+    }
+
+    std::memcpy(get_component_data(entity, componentId), pData, get_component_info(componentId).size);
+}
+
+//------------------------------------------------------------------------------------------
+//------------------------------------------------------------------------------------------
+void EntityWorld::remove_component_data(Entity entity, uint32_t componentId) {
+    const EntityRecord& record = checked_record(entity);
+    const ComponentMask bit = ComponentMask(1) << componentId;
+
+    if ((mArchetypes[record.archetype].mask & bit) == 0) {
+        return;
+    }
+    check_structural_change();
+
+    uint32_t target = mArchetypes[record.archetype].removeEdges[componentId];
+    if (target == INVALID_INDEX) {
+        target = find_archetype(mArchetypes[record.archetype].mask & ~bit);
+        mArchetypes[record.archetype].removeEdges[componentId] = target;
+    }
+    move_entity(entity, target);
+}
+
+//------------------------------------------------------------------------------------------
+//------------------------------------------------------------------------------------------
+void* EntityWorld::get_component_data(Entity entity, uint32_t componentId) {
+    const EntityRecord& record = checked_record(entity);
+    Archetype& archetype = mArchetypes[record.archetype];
+
+    const uint8_t column = archetype.columns[componentId];
+    if (column == 0xFF) {
+        return nullptr;
+    }
+    uint8_t* pColumn = archetype.chunks[record.chunk].pData + archetype.offsets[column];
+    return pColumn + static_cast<size_t>(record.row) * archetype.sizes[column];
+}
+
+//------------------------------------------------------------------------------------------
+//------------------------------------------------------------------------------------------
+ComponentMask EntityWorld::get_mask(Entity entity) const {
+    return mArchetypes[checked_record(entity).archetype].mask;
+}
+
+//------------------------------------------------------------------------------------------
+// Archetypes created later are matched against every query as they appear
+//------------------------------------------------------------------------------------------
+QueryId EntityWorld::create_query(ComponentMask all, ComponentMask none) {
+    Query query;
+    query.all = all;
+    query.none = none;
+    for (uint32_t i = 0; i < mArchetypes.size(); i++) {
+        const ComponentMask mask = mArchetypes[i].mask;
+        if ((mask & all) == all && (mask & none) == 0) {
+            query.archetypes.push_back(i);
+        }
+    }
+
+    mQueries.push_back(query);
+    return static_cast<QueryId>(mQueries.size() - 1);
+}
+
+//------------------------------------------------------------------------------------------
+//------------------------------------------------------------------------------------------
+uint32_t EntityWorld::count(QueryId queryId) const {
+    uint32_t entityCount = 0;
+    for (uint32_t archetypeIndex : mQueries[queryId].archetypes) {
+        entityCount += mArchetypes[archetypeIndex].entityCount;
+    }
+    return entityCount;
+}
+
+//------------------------------------------------------------------------------------------
+//------------------------------------------------------------------------------------------
+void EntityWorld::get_chunks(QueryId queryId, std::vector<QueryChunk>& chunks) const {
+    chunks.clear();
+    for (uint32_t archetypeIndex : mQueries[queryId].archetypes) {
+        const Archetype& archetype = mArchetypes[archetypeIndex];
+        for (uint32_t i = 0; i < archetype.chunks.size(); i++) {
+            chunks.push_back({ archetypeIndex, i, archetype.chunks[i].count });
+        }
+    }
+}
+
+//------------------------------------------------------------------------------------------
+//------------------------------------------------------------------------------------------
+EntityWorld::Stats EntityWorld::get_stats() const {
+    Stats stats;
+    stats.entities = mEntityCount;
+    stats.archetypes = static_cast<uint32_t>(mArchetypes.size());
+    stats.chunks = mChunkCount;
+    stats.queries = static_cast<uint32_t>(mQueries.size());
+    stats.structuralChanges = mStructuralChanges;
+    return stats;
+}
+
+//------------------------------------------------------------------------------------------
+//------------------------------------------------------------------------------------------
+void EntityWorld::print_stats(std::ostream& out) const {
+    const Stats stats = get_stats();
+    out << "Entity world stats:\n";
+    out << "\tEntities: " << stats.entities << '\n';
+    out << "\tArchetypes: " << stats.archetypes << '\n';
+    out << "\tChunks: " << stats.chunks << " (" << stats.chunks * (CHUNK_SIZE / 1024) << " KiB)\n";
+    out << "\tQueries: " << stats.queries << '\n';
+    out << "\tStructural changes: " << stats.structuralChanges << '\n';
+}
+
+//------------------------------------------------------------------------------------------
+//------------------------------------------------------------------------------------------
+const EntityWorld::EntityRecord& EntityWorld::checked_record(Entity entity) const {
+    if (!is_alive(entity)) {
+        throw std::runtime_error("Stale or invalid entity!");
+    }
+    return mEntities[entity.index()];
+}
+
+//------------------------------------------------------------------------------------------
+// Moving entities between chunks would invalidate the columns a query is iterating
+//------------------------------------------------------------------------------------------
+void EntityWorld::check_structural_change() const {
+    if (mIterationDepth > 0) {
+        throw std::runtime_error("Failed to change entity structure during a query, use an EntityCommandBuffer!");
+    }
+}
+
+//------------------------------------------------------------------------------------------
+//------------------------------------------------------------------------------------------
+void EntityWorld::check_query_access(const Query& query, ComponentMask accessed) const {
+    if ((accessed & ~query.all) != 0) {
+        throw std::runtime_error("Failed to iterate query, it doesn't require every accessed component!");
+    }
+}
+
+//------------------------------------------------------------------------------------------
+// Columns are laid out back to back after the entities column, so the capacity is the
+// largest count whose aligned columns still fit in a chunk
+//------------------------------------------------------------------------------------------
+uint32_t EntityWorld::find_archetype(ComponentMask mask) {
+    auto found = mArchetypeLookup.find(mask);
+    if (found != mArchetypeLookup.end()) {
+        return found->second;
+    }
+
+    Archetype archetype;
+    archetype.mask = mask;
+    std::fill(std::begin(archetype.columns), std::end(archetype.columns), static_cast<uint8_t>(0xFF));
+    std::fill(std::begin(archetype.addEdges), std::end(archetype.addEdges), INVALID_INDEX);
+    std::fill(std::begin(archetype.removeEdges), std::end(archetype.removeEdges), INVALID_INDEX);
+    archetype.capacity = 0;
+    archetype.entityCount = 0;
+
+    uint32_t rowSize = sizeof(Entity);
+    for (uint32_t id = 0; id < MAX_COMPONENTS; id++) {
+        if ((mask & (ComponentMask(1) << id)) == 0) {
+            continue;
+        }
+        const ComponentInfo& info = get_component_info(id);
+        if (info.alignment > CHUNK_ALIGNMENT) {
+            throw std::runtime_error("Failed to create archetype, a component is over aligned!");
+        }
+        archetype.columns[id] = static_cast<uint8_t>(archetype.components.size());
+        archetype.components.push_back(id);
+        archetype.sizes.push_back(info.size);
+        rowSize += info.size;
+    }
+
+    for (uint32_t capacity = CHUNK_SIZE / rowSize; capacity > 0; capacity--) {
+        uint32_t offset = capacity * static_cast<uint32_t>(sizeof(Entity));
+        archetype.offsets.clear();
+        for (uint32_t column = 0; column < archetype.components.size(); column++) {
+            offset = align_up(offset, get_component_info(archetype.components[column]).alignment);
+            archetype.offsets.push_back(offset);
+            offset += capacity * archetype.sizes[column];
+        }
+        if (offset <= CHUNK_SIZE) {
+            archetype.capacity = capacity;
+            break;
+        }
+    }
+    if (archetype.capacity == 0) {
+        throw std::runtime_error("Failed to create archetype, the components don't fit in a chunk!");
+    }
+
+    const uint32_t archetypeIndex = static_cast<uint32_t>(mArchetypes.size());
+    mArchetypes.push_back(std::move(archetype));
+    mArchetypeLookup[mask] = archetypeIndex;
+
+    for (Query& query : mQueries) {
+        if ((mask & query.all) == query.all && (mask & query.none) == 0) {
+            query.archetypes.push_back(archetypeIndex);
+        }
+    }
+    return archetypeIndex;
+}
+
+//------------------------------------------------------------------------------------------
+// Appends to the last chunk, which is the only one that may have space
+//------------------------------------------------------------------------------------------
+void EntityWorld::allocate_row(uint32_t archetypeIndex, uint32_t& chunkIndex, uint32_t& row) {
+    Archetype& archetype = mArchetypes[archetypeIndex];
+    if (archetype.chunks.empty() || archetype.chunks.back().count == archetype.capacity) {
+        Chunk chunk;
+        if (!mFreeChunks.empty()) {
+            chunk.pData = mFreeChunks.back();
+            mFreeChunks.pop_back();
+        }
+        else {
+            chunk.pData = static_cast<uint8_t*>(::operator new(CHUNK_SIZE, std::align_val_t(CHUNK_ALIGNMENT)));
+        }
+        chunk.count = 0;
+        archetype.chunks.push_back(chunk);
+        mChunkCount++;
+    }
+
+    chunkIndex = static_cast<uint32_t>(archetype.chunks.size() - 1);
+    row = archetype.chunks.back().count++;
+    archetype.entityCount++;
+}
+
+//------------------------------------------------------------------------------------------
+// The archetype's last entity fills the hole, so chunks stay packed
+//------------------------------------------------------------------------------------------
+void EntityWorld::remove_row(uint32_t archetypeIndex, uint32_t chunkIndex, uint32_t row) {
+    Archetype& archetype = mArchetypes[archetypeIndex];
+    Chunk& chunk = archetype.chunks[chunkIndex];
+    Chunk& last = archetype.chunks.back();
+    const uint32_t lastRow = last.count - 1;
+
+    if (&chunk != &last || row != lastRow) {
+        for (uint32_t column = 0; column < archetype.components.size(); column++) {
+            const uint32_t size = archetype.sizes[column];
+            std::memcpy(chunk.pData + archetype.offsets[column] + static_cast<size_t>(row) * size,
+                        last.pData + archetype.offsets[column] + static_cast<size_t>(lastRow) * size, size);
+        }
+
+        const Entity moved = reinterpret_cast<const Entity*>(last.pData)[lastRow];
+        reinterpret_cast<Entity*>(chunk.pData)[row] = moved;
+        mEntities[moved.index()].chunk = chunkIndex;
+        mEntities[moved.index()].row = row;
+    }
+
+    last.count--;
+    archetype.entityCount--;
+    if (last.count == 0) {
+        mFreeChunks.push_back(last.pData);
+        archetype.chunks.pop_back();
+        mChunkCount--;
+    }
+}
+
+//------------------------------------------------------------------------------------------
+// Copies the components both archetypes share, the rest of the new row is left for the
+// caller to write
+//------------------------------------------------------------------------------------------
+void EntityWorld::move_entity(Entity entity, uint32_t targetArchetype) {
+    uint32_t chunkIndex;
+    uint32_t row;
+    allocate_row(targetArchetype, chunkIndex, row);
+
+    EntityRecord& record = mEntities[entity.index()];
+    const Archetype& source = mArchetypes[record.archetype];
+    Archetype& target = mArchetypes[targetArchetype];
+    const uint8_t* pSource = source.chunks[record.chunk].pData;
+    uint8_t* pTarget = target.chunks[chunkIndex].pData;
+
+    for (uint32_t column = 0; column < target.components.size(); column++) {
+        const uint8_t sourceColumn = source.columns[target.components[column]];
+        if (sourceColumn == 0xFF) {
+            continue;
+        }
+        const uint32_t size = target.sizes[column];
+        std::memcpy(pTarget + target.offsets[column] + static_cast<size_t>(row) * size,
+                    pSource + source.offsets[sourceColumn] + static_cast<size_t>(record.row) * size, size);
+    }
+    reinterpret_cast<Entity*>(pTarget)[row] = entity;
+
+    remove_row(record.archetype, record.chunk, record.row);
+    record.archetype = targetArchetype;
+    record.chunk = chunkIndex;
+    record.row = row;
+    mStructuralChanges++;
+}
@@ -0,0 +1,317 @@
+//======================================================================
+// FileWatcher.cpp
+//
+// Keegan Kochis
+// Created: 2026/10/19
+// The definition of the FileWatcher class.
+//======================================================================
+
+#include "FileWatcher.h"
+
+#ifdef __linux__
+#include <poll.h>
+#include <sys/inotify.h>
+#include <unistd.h>
+
+#define J_INOTIFY 1
+#endif
+
+#include <errno.h>
+#include <sys/stat.h>
+
+#include <cstddef>
+#include <cstdint>
+
+#include <algorithm>
+#include <chrono>
+#include <filesystem>
+#include <ostream>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <thread>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#ifdef J_INOTIFY
+// Writes are reported when the file is closed and also as they happen, for writers that
+// keep their files open
+static const uint32_t WATCH_MASK = IN_CLOSE_WRITE | IN_MODIFY | IN_CREATE | IN_DELETE | IN_MOVED_FROM | IN_MOVED_TO |
+                                   IN_EXCL_UNLINK | IN_ONLYDIR;
+#endif
+
+FileWatcher::FileWatcher() {
+}
+
+FileWatcher::~FileWatcher() {
+    clean_up();
+}
+
+//------------------------------------------------------------------------------------------
+//------------------------------------------------------------------------------------------
+void FileWatcher::init(WatchBackend backend, const std::string& directory) {
+    clean_up();
+    if (!std::filesystem::is_directory(directory)) {
+        throw std::runtime_error("Failed to watch " + directory + ", it's not a directory!");
+    }
+    mDirectory = directory;
+    while (mDirectory.size() > 1 && mDirectory.back() == '/') {
+        mDirectory.pop_back();
+    }
+    mStats = Stats();
+
+#ifdef J_INOTIFY
+    if (backend == WATCH_BACKEND_INOTIFY) {
+        mFd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+        mBackend = WATCH_BACKEND_INOTIFY;
+        if (mFd >= 0 && watch_tree(mDirectory, nullptr)) {
+            return;
+        }
+        clean_up();
+    }
+#endif
+    mBackend = WATCH_BACKEND_POLLING;
+    mFiles = scan();
+    mStats.scans++;
+}
+
+//------------------------------------------------------------------------------------------
+//------------------------------------------------------------------------------------------
+void FileWatcher::clean_up() {
+#ifdef J_INOTIFY
+    if (mFd >= 0) {
+        close(mFd);
+    }
+#endif
+    mFd = -1;
+    mWatchedDirectories.clear();
+    mFiles.clear();
+    mStats.watches = 0;
+}
+
+//------------------------------------------------------------------------------------------
+// The changes of a burst can end up in different reads, so reading goes on until the
+// tree was quiet for SETTLE_MS
+//------------------------------------------------------------------------------------------
+bool FileWatcher::wait_for_changes(uint32_t timeoutMs, std::vector<std::string>* pPaths) {
+    const size_t firstPath = pPaths->size();
+    bool lost = false;
+    if (mBackend == WATCH_BACKEND_INOTIFY) {
+        if (read_events(timeoutMs, pPaths, &lost)) {
+            while (mBackend == WATCH_BACKEND_INOTIFY && read_events(SETTLE_MS, pPaths, &lost)) {
+            }
+        }
+    }
+    else {
+        poll_changes(timeoutMs, pPaths);
+    }
+
+    std::sort(pPaths->begin() + firstPath, pPaths->end());
+    pPaths->erase(std::unique(pPaths->begin() + firstPath, pPaths->end()), pPaths->end());
+    return !lost;
+}
+
+//------------------------------------------------------------------------------------------
+//------------------------------------------------------------------------------------------
+void FileWatcher::print_stats(std::ostream& out) const {
+    out << "File watcher stats:\n";
+    out << "\tBackend: " << (mBackend == WATCH_BACKEND_INOTIFY ? "inotify" : "polling") << '\n';
+    if (mBackend == WATCH_BACKEND_INOTIFY) {
+        out << "\tWatches: " << mStats.watches << '\n';
+    }
+    else {
+        out << "\tFiles: " << mFiles.size() << ", " << mStats.scans << " scans\n";
+    }
+    out << "\tEvents: " << mStats.events << '\n';
+    out << "\tOverflows: " << mStats.overflows << '\n';
+}
+
+//------------------------------------------------------------------------------------------
+// The directory is watched before it's listed, so whatever is created in between shows up
+// as an event. The files found go into pFiles, for directories created or moved in while
+// watching. False once the kernel is out of watches.
+//------------------------------------------------------------------------------------------
+bool FileWatcher::watch_tree(const std::string& directory, std::vector<std::string>* pFiles) {
+#ifdef J_INOTIFY
+    const int wd = inotify_add_watch(mFd, directory.c_str(), WATCH_MASK);
+    if (wd < 0) {
+        // Gone again already, which its parent's events report
+        return errno != ENOSPC && errno != ENOMEM;
+    }
+    if (mWatchedDirectories.emplace(wd, directory).second) {
+        mStats.watches++;
+    }
+
+    std::error_code error;
+    for (std::filesystem::directory_iterator it(directory, error), end; !error && it != end; it.increment(error)) {
+        const std::string path = directory + "/" + it->path().filename().string();
+        if (it->is_directory(error) && !it->is_symlink(error)) {
+            if (!watch_tree(path, pFiles)) {
+                return false;
+            }
+        }
+        else if (pFiles && it->is_regular_file(error)) {
+            pFiles->push_back(path);
+        }
+    }
+    return true;
+#else
+    (void)directory;
+    (void)pFiles;
+    return false;
+#endif
+}
+
+//------------------------------------------------------------------------------------------
+// Returns whether any event arrived within the timeout. A directory moved out keeps its
+// watches, which would go on reporting it under its old path, so they are removed.
+//------------------------------------------------------------------------------------------
+bool FileWatcher::read_events(uint32_t timeoutMs, std::vector<std::string>* pPaths, bool* pLost) {
+#ifdef J_INOTIFY
+    pollfd waitFd = { mFd, POLLIN, 0 };
+    if (poll(&waitFd, 1, static_cast<int>(timeoutMs)) <= 0) {
+        return false;
+    }
+
+    alignas(inotify_event) char buffer[16 * 1024];
+    bool anyEvents = false;
+    while (mBackend == WATCH_BACKEND_INOTIFY) {
+        const ssize_t bytes = read(mFd, buffer, sizeof(buffer));
+        if (bytes <= 0) {
+            break;
+        }
+
+        for (ssize_t offset = 0; offset < bytes;) {
+            const inotify_event* pEvent = reinterpret_cast<const inotify_event*>(buffer + offset);
+            offset += static_cast<ssize_t>(sizeof(inotify_event) + pEvent->len);
+            mStats.events++;
+            anyEvents = true;
+
+            if (pEvent->mask & IN_Q_OVERFLOW) {
+                mStats.overflows++;
+                *pLost = true;
+                continue;
+            }
+            auto watched = mWatchedDirectories.find(pEvent->wd);
+            if (pEvent->mask & IN_IGNORED) {
+                if (watched != mWatchedDirectories.end()) {
+                    mWatchedDirectories.erase(watched);
+                    mStats.watches--;
+                }
+                continue;
+            }
+            if (watched == mWatchedDirectories.end() || pEvent->len == 0) {
+                continue;
+            }
+
+            const std::string path = watched->second + "/" + pEvent->name;
+            if (!(pEvent->mask & IN_ISDIR)) {
+                pPaths->push_back(path);
+            }
+            else if (pEvent->mask & (IN_CREATE | IN_MOVED_TO)) {
+                if (!watch_tree(path, pPaths)) {
+                    // Out of watches, from here on the tree is scanned instead
+                    clean_up();
+                    mBackend = WATCH_BACKEND_POLLING;
+                    mFiles = scan();
+                    mStats.scans++;
+                    *pLost = true;
+                    break;
+                }
+            }
+            else if (pEvent->mask & (IN_MOVED_FROM | IN_DELETE)) {
+                pPaths->push_back(path);
+                const std::string prefix = path + "/";
+                for (auto it = mWatchedDirectories.begin(); it != mWatchedDirectories.end();) {
+                    if (it->second == path || it->second.compare(0, prefix.size(), prefix) == 0) {
+                        inotify_rm_watch(mFd, it->first);
+                        it = mWatchedDirectories.erase(it);
+                        mStats.watches--;
+                    }
+                    else {
+                        ++it;
+                    }
+                }
+            }
+        }
+    }
+    return anyEvents;
+#else
+    (void)timeoutMs;
+    (void)pPaths;
+    (void)pLost;
+    return false;
+#endif
+}
+
+//------------------------------------------------------------------------------------------
+// Scans at the poll interval until the timeout or a change, then goes on until a scan
+// finds nothing new. Returns whether anything changed.
+//------------------------------------------------------------------------------------------
+bool FileWatcher::poll_changes(uint32_t timeoutMs, std::vector<std::string>* pPaths) {
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(timeoutMs);
+    bool anyChanges = false;
+    while (true) {
+        const auto remaining = std::chrono::duration_cast<std::chrono::milliseconds>(
+            deadline - std::chrono::steady_clock::now());
+        const uint32_t waitMs = anyChanges ? POLL_INTERVAL_MS
+                                           : static_cast<uint32_t>(std::clamp<int64_t>(remaining.count(), 0,
+                                                                                       POLL_INTERVAL_MS));
+        std::this_thread::sleep_for(std::chrono::milliseconds(waitMs));
+
+        std::unordered_map<std::string, FileState> files = scan();
+        mStats.scans++;
+        bool changed = false;
+        for (const auto& file : files) {
+            auto previous = mFiles.find(file.first);
+            if (previous == mFiles.end() || previous->second.bytes != file.second.bytes ||
+                previous->second.modifiedNs != file.second.modifiedNs) {
+                pPaths->push_back(file.first);
+                changed = true;
+                mStats.events++;
+            }
+        }
+        for (const auto& file : mFiles) {
+            if (files.count(file.first) == 0) {
+                pPaths->push_back(file.first);
+                changed = true;
+                mStats.events++;
+            }
+        }
+        mFiles = std::move(files);
+
+        if (anyChanges && !changed) {
+            return true;
+        }
+        anyChanges = anyChanges || changed;
+        if (!anyChanges && std::chrono::steady_clock::now() >= deadline) {
+            return false;
+        }
+    }
+}
+
+//------------------------------------------------------------------------------------------
+// Files that vanish while it runs are left out
+//------------------------------------------------------------------------------------------
+std::unordered_map<std::string, FileWatcher::FileState> FileWatcher::scan() const {
+    std::unordered_map<std::string, FileState> files;
+    std::error_code error;
+    std::filesystem::recursive_directory_iterator it(mDirectory, std::filesystem::directory_options::skip_permission_denied,
+                                                     error);
+    for (std::filesystem::recursive_directory_iterator end; !error && it != end; it.increment(error)) {
+        struct stat status;
+        const std::string path = it->path().string();
+        if (stat(path.c_str(), &status) != 0 || !S_ISREG(status.st_mode)) {
+            continue;
+        }
+#ifdef __APPLE__
+        const struct timespec& modified = status.st_mtimespec;
+#else
+        const struct timespec& modified = status.st_mtim;
+#endif
+        files[path] = { static_cast<uint64_t>(status.st_size),
+                        static_cast<int64_t>(modified.tv_sec) * 1000000000 + modified.tv_nsec };
+    }
+    return files;
+}
@@ -0,0 +1,169 @@
+//======================================================================
+// FixedTimestep.cpp
+//
+// Keegan Kochis
+// Created: 2026/10/18
+// The definition of the FixedTimestep class.
+//======================================================================
+
+#include "FixedTimestep.h"
+
+#include <cmath>
+#include <cstdint>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <mutex>
+#include <ostream>
+#include <thread>
+#include <utility>
+
+FixedTimestep::FixedTimestep() {
+}
+
+FixedTimestep::~FixedTimestep() {
+    clean_up();
+}
+
+//------------------------------------------------------------------------------------------
+//------------------------------------------------------------------------------------------
+void FixedTimestep::init(const Settings& settings, StepFunction step) {
+    mSettings = settings;
+    mStep = std::move(step);
+    mLastFrameSeconds = now_seconds();
+    mStateSeconds = mLastFrameSeconds;
+    mAccumulator = 0.0;
+
+    if (mSettings.threaded) {
+        mStopping = false;
+        mThread = std::thread(&FixedTimestep::thread_main, this);
+    }
+}
+
+//------------------------------------------------------------------------------------------
+//------------------------------------------------------------------------------------------
+void FixedTimestep::clean_up() {
+    mStopping = true;
+    if (mThread.joinable()) {
+        mThread.join();
+    }
+}
+
+//------------------------------------------------------------------------------------------
+// The accumulator carries what's left of the frame into the next one, so the steps
+// average out to real time
+//------------------------------------------------------------------------------------------
+void FixedTimestep::advance() {
+    if (mSettings.threaded) {
+        return;
+    }
+
+    const double now = now_seconds();
+    double frameSeconds = now - mLastFrameSeconds;
+    mLastFrameSeconds = now;
+    if (frameSeconds > mSettings.maxFrameSeconds) {
+        frameSeconds = mSettings.maxFrameSeconds;
+        mClampedFrames++;
+    }
+    mAccumulator += frameSeconds;
+
+    uint32_t steps = 0;
+    while (mAccumulator >= mSettings.stepSeconds && steps < mSettings.maxStepsPerFrame) {
+        run_step(now);
+        mAccumulator -= mSettings.stepSeconds;
+        steps++;
+    }
+
+    // Catching up would take even longer next frame, give up on the whole steps left
+    if (mAccumulator >= mSettings.stepSeconds) {
+        const double dropped = std::floor(mAccumulator / mSettings.stepSeconds);
+        mAccumulator -= dropped * mSettings.stepSeconds;
+        mDroppedSteps += static_cast<uint64_t>(dropped);
+    }
+    mLastFrameSteps = steps;
+}
+
+//------------------------------------------------------------------------------------------
+//------------------------------------------------------------------------------------------
+float FixedTimestep::get_alpha() const {
+    if (!mSettings.threaded) {
+        return static_cast<float>(mAccumulator / mSettings.stepSeconds);
+    }
+    const double alpha = (now_seconds() - mStateSeconds) / mSettings.stepSeconds;
+    return static_cast<float>(std::min(std::max(alpha, 0.0), 1.0));
+}
+
+//------------------------------------------------------------------------------------------
+//------------------------------------------------------------------------------------------
+FixedTimestep::Stats FixedTimestep::get_stats() const {
+    Stats stats;
+    stats.steps = mSteps;
+    stats.droppedSteps = mDroppedSteps;
+    stats.clampedFrames = mClampedFrames;
+    stats.lastFrameSteps = mLastFrameSteps;
+    stats.simulationTime = mSimulationTime;
+    return stats;
+}
+
+//------------------------------------------------------------------------------------------
+//------------------------------------------------------------------------------------------
+void FixedTimestep::print_stats(std::ostream& out) const {
+    const Stats stats = get_stats();
+    out << "Fixed timestep stats:\n";
+    out << "\tStep: " << 1000.0 * mSettings.stepSeconds << " ms" << (mSettings.threaded ? ", threaded\n" : ", inline\n");
+    out << "\tSteps: " << stats.steps << '\n';
+    out << "\tDropped steps: " << stats.droppedSteps << '\n';
+    out << "\tClamped frames: " << stats.clampedFrames << '\n';
+    out << "\tSteps last frame: " << stats.lastFrameSteps << '\n';
+    out << "\tSimulation time: " << stats.simulationTime << " s\n";
+}
+
+//------------------------------------------------------------------------------------------
+//------------------------------------------------------------------------------------------
+void FixedTimestep::run_step(double stateSeconds) {
+    std::lock_guard<std::mutex> lock(mStateMutex);
+    const double time = mSimulationTime;
+    mStep(time, static_cast<float>(mSettings.stepSeconds));
+    mSimulationTime = time + mSettings.stepSeconds;
+    mStateSeconds = stateSeconds;
+    mSteps++;
+}
+
+//------------------------------------------------------------------------------------------
+// Each step is due one step length after the previous one. The state is stamped with
+// the time it was due rather than when it finished, so oversleeping doesn't show as
+// stutter, the renderer just blends further ahead.
+//------------------------------------------------------------------------------------------
+void FixedTimestep::thread_main() {
+    double nextStepSeconds = mStateSeconds + mSettings.stepSeconds;
+
+    while (!mStopping) {
+        const double now = now_seconds();
+        if (now < nextStepSeconds) {
+            std::this_thread::sleep_for(std::chrono::duration<double>(nextStepSeconds - now));
+            continue;
+        }
+
+        uint32_t steps = 0;
+        while (nextStepSeconds <= now && steps < mSettings.maxStepsPerFrame) {
+            run_step(nextStepSeconds);
+            nextStepSeconds += mSettings.stepSeconds;
+            steps++;
+        }
+
+        if (nextStepSeconds <= now) {
+            const double dropped = std::floor((now - nextStepSeconds) / mSettings.stepSeconds) + 1.0;
+            nextStepSeconds += dropped * mSettings.stepSeconds;
+            mDroppedSteps += static_cast<uint64_t>(dropped);
+        }
+        mLastFrameSteps = steps;
+    }
+}
+
+//------------------------------------------------------------------------------------------
+//------------------------------------------------------------------------------------------
+double FixedTimestep::now_seconds() {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
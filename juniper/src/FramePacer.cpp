@@ -0,0 +1,182 @@
+//======================================================================
+// FramePacer.cpp
+//
+// Keegan Kochis
+// Created: 2026/10/18
+// The definition of the FramePacer class.
+//======================================================================
+
+#include "FramePacer.h"
+
+#include <cmath>
+#include <cstdint>
+
+#include <algorithm>
+#include <chrono>
+#include <ostream>
+#include <thread>
+#include <vector>
+
+// Caps the sleep statistics' sample count, past it they turn into moving averages that
+// keep adapting to the system
+static const uint64_t MAX_SLEEP_SAMPLES = 1000;
+
+FramePacer::FramePacer() {
+}
+
+//------------------------------------------------------------------------------------------
+//------------------------------------------------------------------------------------------
+void FramePacer::init(Profiler* pProfiler) {
+    mpProfiler = pProfiler;
+    mIntervals.reserve(INTERVAL_HISTORY);
+    mLastReturnSeconds = now_seconds();
+    mDeadlineSeconds = mLastReturnSeconds;
+}
+
+//------------------------------------------------------------------------------------------
+//------------------------------------------------------------------------------------------
+void FramePacer::set_target_rate(double framesPerSecond) {
+    mTargetRate = std::max(framesPerSecond, 0.0);
+    mDeadlineSeconds = now_seconds();
+}
+
+//------------------------------------------------------------------------------------------
+// A frame that overran its deadline restarts the schedule from now instead of rushing
+// the following frames to catch up
+//------------------------------------------------------------------------------------------
+void FramePacer::wait() {
+    const uint64_t startNs = Profiler::now_ns();
+
+    if (mTargetRate > 0.0) {
+        const double now = now_seconds();
+        mDeadlineSeconds += 1.0 / mTargetRate;
+        if (now >= mDeadlineSeconds) {
+            mDeadlineSeconds = now;
+            mMissedDeadlines++;
+        }
+        else {
+            sleep_until(mDeadlineSeconds);
+        }
+    }
+
+    const double now = now_seconds();
+    record_interval(now - mLastReturnSeconds);
+    mLastReturnSeconds = now;
+
+    if (mpProfiler) {
+        mpProfiler->record("FramePacer::wait", 0, startNs, Profiler::now_ns());
+    }
+}
+
+//------------------------------------------------------------------------------------------
+//------------------------------------------------------------------------------------------
+FramePacer::Stats FramePacer::get_stats() const {
+    Stats stats;
+    stats.targetMs = mTargetRate > 0.0 ? 1000.0 / mTargetRate : 0.0;
+    stats.sleepOvershootMs = 1000.0 * (mSleepEstimate - SLEEP_QUANTUM_SECONDS);
+    stats.frames = mFrames;
+    stats.missedDeadlines = mMissedDeadlines;
+    if (mIntervals.empty()) {
+        return stats;
+    }
+
+    std::vector<double> sorted = mIntervals;
+    std::sort(sorted.begin(), sorted.end());
+
+    double sum = 0.0;
+    for (double interval : sorted) {
+        sum += interval;
+    }
+    const double mean = sum / sorted.size();
+    double variance = 0.0;
+    for (double interval : sorted) {
+        variance += (interval - mean) * (interval - mean);
+    }
+    variance /= sorted.size();
+
+    stats.meanMs = 1000.0 * mean;
+    stats.jitterMs = 1000.0 * std::sqrt(variance);
+    stats.minMs = 1000.0 * sorted.front();
+    stats.maxMs = 1000.0 * sorted.back();
+    stats.p99Ms = 1000.0 * sorted[std::min(sorted.size() - 1, sorted.size() * 99 / 100)];
+    return stats;
+}
+
+//------------------------------------------------------------------------------------------
+//------------------------------------------------------------------------------------------
+void FramePacer::print_stats(std::ostream& out) const {
+    const Stats stats = get_stats();
+    out << "Frame pacer stats:\n";
+    if (stats.targetMs > 0.0) {
+        out << "\tTarget interval: " << stats.targetMs << " ms\n";
+    }
+    else {
+        out << "\tTarget interval: unpaced\n";
+    }
+    out << "\tMean interval: " << stats.meanMs << " ms\n";
+    out << "\tJitter: " << stats.jitterMs << " ms\n";
+    out << "\tMin / p99 / max interval: " << stats.minMs << " / " << stats.p99Ms << " / " << stats.maxMs << " ms\n";
+    out << "\tSleep overshoot estimate: " << stats.sleepOvershootMs << " ms\n";
+    out << "\tMissed deadlines: " << stats.missedDeadlines << " of " << stats.frames << " frames\n";
+}
+
+//------------------------------------------------------------------------------------------
+// Each quantum slept updates the estimate of how long one really takes, the mean plus a
+// standard deviation. Once less than that remains, spinning finishes on time.
+//------------------------------------------------------------------------------------------
+void FramePacer::sleep_until(double deadlineSeconds) {
+    double now = now_seconds();
+    while (deadlineSeconds - now > mSleepEstimate) {
+        std::this_thread::sleep_for(std::chrono::duration<double>(SLEEP_QUANTUM_SECONDS));
+        const double woke = now_seconds();
+        const double slept = woke - now;
+        now = woke;
+
+        mSleepCount = std::min(mSleepCount + 1, MAX_SLEEP_SAMPLES);
+        const double delta = slept - mSleepMean;
+        mSleepMean += delta / mSleepCount;
+        mSleepVariance += (delta * (slept - mSleepMean) - mSleepVariance) / mSleepCount;
+        mSleepEstimate = mSleepMean + std::sqrt(mSleepVariance);
+    }
+
+    while (now_seconds() < deadlineSeconds) {
+        std::this_thread::yield();
+    }
+}
+
+//------------------------------------------------------------------------------------------
+//------------------------------------------------------------------------------------------
+void FramePacer::record_interval(double seconds) {
+    mFrames++;
+    if (mIntervals.size() < INTERVAL_HISTORY) {
+        mIntervals.push_back(seconds);
+    }
+    else {
+        mIntervals[mNextInterval] = seconds;
+    }
+    mNextInterval = (mNextInterval + 1) % INTERVAL_HISTORY;
+
+    if (mNextInterval == 0) {
+        export_counters();
+    }
+}
+
+//------------------------------------------------------------------------------------------
+//------------------------------------------------------------------------------------------
+void FramePacer::export_counters() const {
+    if (!mpProfiler) {
+        return;
+    }
+    const Stats stats = get_stats();
+    mpProfiler->set_counter("Frame interval mean ms", stats.meanMs);
+    mpProfiler->set_counter("Frame interval jitter ms", stats.jitterMs);
+    mpProfiler->set_counter("Frame interval p99 ms", stats.p99Ms);
+    mpProfiler->set_counter("Frame interval max ms", stats.maxMs);
+    mpProfiler->set_counter("Frame pacer missed deadlines", static_cast<double>(stats.missedDeadlines));
+}
+
+//------------------------------------------------------------------------------------------
+//------------------------------------------------------------------------------------------
+double FramePacer::now_seconds() {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
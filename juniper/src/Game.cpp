@@ -7,25 +7,43 @@
 //======================================================================
 
 #include "Game.h"
+#include "MeshOptimize.h"
+#include "MeshQuantize.h"
+#include "MeshSimplify.h"
+#include "Shader.h"
 
 #include <cstdint>
 #include <cstring>
 
 #include <algorithm>
+#include <cmath>
+#include <fstream>
 #include <iostream>
 #include <map>
+#include <mutex>
 #include <optional>
 #include <set>
 #include <stdexcept>
+#include <string>
 #include <vector>
 
 #define GLFW_INCLUDE_VULKAN
 #include <GLFW/glfw3.h>
 
+#define GLM_FORCE_RADIANS
+#define GLM_FORCE_DEPTH_ZERO_TO_ONE
+#include <glm/mat4x4.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+#include <glm/gtc/quaternion.hpp>
+
 const std::vector<const char*> deviceExtensions = {
     VK_KHR_SWAPCHAIN_EXTENSION_NAME
 };
 
+const uint32_t Game::MAX_FRAMES_IN_FLIGHT;
+// Holds a frame's worth of streamed texture levels with room to spare
+static const VkDeviceSize STAGING_RING_SIZE = 64ull << 20;
+
 Game::Game() {}
 
 void Game::run() {
@@ -44,6 +62,7 @@ void Game::init_window() {
     glfwWindowHint(GLFW_RESIZABLE, GLFW_FALSE);
 
     mpWindow = glfwCreateWindow(mWindowWidth, mWindowHeight, "Juniper Game", nullptr, nullptr);
+    mFramePacer.init(&mProfiler);
 }
 
 //------------------------------------------------------------------------------------------
@@ -54,8 +73,22 @@ void Game::init_vulkan() {
     create_surface();
     pick_physical_device();
     create_logical_device();
+    create_timeline_sync();
+    create_gpu_resources();
+    create_texture_streamer();
     create_swap_chain();
     create_image_views();
+    create_descriptor_allocator();
+    create_instanced_renderer();
+    create_meshlet_renderer();
+    create_depth_resources();
+    create_depth_pyramid();
+    create_render_pass();
+    create_graphics_pipeline();
+    create_framebuffers();
+    create_command_pools();
+    create_sync_objects();
+    create_scene();
 }
 
 //------------------------------------------------------------------------------------------
@@ -73,7 +106,9 @@ void Game::create_vulkan_instance() {
     applicationInfo.applicationVersion = VK_MAKE_VERSION(0, 0, 1);
     applicationInfo.pEngineName = "Juniper";
     applicationInfo.engineVersion = VK_MAKE_VERSION(0, 0, 1);
-    applicationInfo.apiVersion = VK_API_VERSION_1_0;
+    // Ask for the highest version the loader supports, the device may still report a lower one
+    mInstanceApiVersion = DeviceFeatures::query_instance_version();
+    applicationInfo.apiVersion = mInstanceApiVersion;
     applicationInfo.pNext = nullptr;
     
     std::vector<const char*> extensions = get_required_glfw_extensions();
@@ -296,15 +331,33 @@ VkSurfaceFormatKHR Game::choose_swap_surface_format(const std::vector<VkSurfaceF
 //------------------------------------------------------------------------------------------
 //------------------------------------------------------------------------------------------
 VkPresentModeKHR Game::choose_swap_present_mode(const std::vector<VkPresentModeKHR>& availablePresentModes) {
-    for (const VkPresentModeKHR& availablePresentMode : availablePresentModes) {
-        if (availablePresentMode == VK_PRESENT_MODE_MAILBOX_KHR) {
-            return availablePresentMode;
-        }
+    auto is_available = [&availablePresentModes](VkPresentModeKHR presentMode) {
+        return std::find(availablePresentModes.begin(), availablePresentModes.end(), presentMode) != availablePresentModes.end();
+    };
+    
+    if (mPresentPolicy != PRESENT_POLICY_VSYNC && is_available(VK_PRESENT_MODE_MAILBOX_KHR)) {
+        return VK_PRESENT_MODE_MAILBOX_KHR;
+    }
+    if (mPresentPolicy == PRESENT_POLICY_UNCAPPED && is_available(VK_PRESENT_MODE_IMMEDIATE_KHR)) {
+        return VK_PRESENT_MODE_IMMEDIATE_KHR;
     }
     
+    // Always supported
     return VK_PRESENT_MODE_FIFO_KHR;
 }
 
+//------------------------------------------------------------------------------------------
+// The target frame rate, or the primary monitor's refresh rate when none was set
+//------------------------------------------------------------------------------------------
+double Game::get_target_frame_rate() {
+    if (mTargetFrameRate > 0.0) {
+        return mTargetFrameRate;
+    }
+    
+    const GLFWvidmode* pVideoMode = glfwGetVideoMode(glfwGetPrimaryMonitor());
+    return pVideoMode && pVideoMode->refreshRate > 0 ? static_cast<double>(pVideoMode->refreshRate) : 60.0;
+}
+
 //------------------------------------------------------------------------------------------
 //------------------------------------------------------------------------------------------
 VkExtent2D Game::choose_swap_extent(const VkSurfaceCapabilitiesKHR& capabilities) {
@@ -336,6 +389,11 @@ void Game::create_swap_chain() {
     VkPresentModeKHR presentMode = choose_swap_present_mode(swapChainSupport.presentModes);
     VkExtent2D extent = choose_swap_extent(swapChainSupport.capabilities);
     
+    // FIFO blocks in present once the queue is full, pacing the loop to the display. MAILBOX
+    // and IMMEDIATE never block, so the frame pacer caps the rate unless asked not to.
+    const bool presentPaces = presentMode == VK_PRESENT_MODE_FIFO_KHR;
+    mFramePacer.set_target_rate(presentPaces || mPresentPolicy == PRESENT_POLICY_UNCAPPED ? 0.0 : get_target_frame_rate());
+    
     // Use 1 more than the required minimum if possible
     // Be sure to less than maximum
     uint32_t imageCount = swapChainSupport.capabilities.minImageCount + 1;
@@ -384,11 +442,19 @@ void Game::create_swap_chain() {
     }
     
     vkGetSwapchainImagesKHR(mDevice, mSwapchain, &imageCount, nullptr);
-    mSwapchainImages.resize(imageCount);
-    vkGetSwapchainImagesKHR(mDevice, mSwapchain, &imageCount, mSwapchainImages.data());
+    std::vector<VkImage> swapchainImages(imageCount);
+    vkGetSwapchainImagesKHR(mDevice, mSwapchain, &imageCount, swapchainImages.data());
     
     mSwapchainImageFormat = surfaceFormat.format;
     mSwapchainExtent = extent;
+    
+    // The swapchain owns its images, only the views created later are destroyed by us
+    mSwapchainImages.clear();
+    for (VkImage image : swapchainImages) {
+        VkExtent3D imageExtent = { extent.width, extent.height, 1 };
+        mSwapchainImages.push_back(mGpuResources.add_image(image, VK_NULL_HANDLE, VK_NULL_HANDLE,
+                                                           mSwapchainImageFormat, imageExtent, false));
+    }
 }
 
 //------------------------------------------------------------------------------------------
@@ -475,7 +541,9 @@ Game::QueueFamilyIndices Game::find_queue_families(VkPhysicalDevice device) {
     vkGetPhysicalDeviceQueueFamilyProperties(device, &queueFamilyCount, queueFamilies.data());
     
     for (uint32_t i = 0; i < queueFamilyCount; i++) {
-        if (queueFamilies[i].queueFlags & VK_QUEUE_GRAPHICS_BIT) {
+        VkQueueFlags flags = queueFamilies[i].queueFlags;
+        
+        if (!indices.foundGraphicsFamily && (flags & VK_QUEUE_GRAPHICS_BIT)) {
             indices.foundGraphicsFamily = true;
             indices.graphicsFamily = i;
         }
@@ -483,13 +551,33 @@ Game::QueueFamilyIndices Game::find_queue_families(VkPhysicalDevice device) {
         VkBool32 presentSupport = false;
         vkGetPhysicalDeviceSurfaceSupportKHR(device, i, mWindowSurface, &presentSupport);
         
-        if (presentSupport) {
+        if (!indices.foundPresentFamily && presentSupport) {
             indices.foundPresentFamily = true;
             indices.presentFamily = i;
         }
         
-        if (indices.is_complete()) {
-            break;
+        // Async compute and copy engines run alongside the graphics queue
+        if (!indices.foundComputeFamily && (flags & VK_QUEUE_COMPUTE_BIT) && !(flags & VK_QUEUE_GRAPHICS_BIT)) {
+            indices.foundComputeFamily = true;
+            indices.computeFamily = i;
+        }
+        
+        if (!indices.foundTransferFamily && (flags & VK_QUEUE_TRANSFER_BIT) &&
+            !(flags & (VK_QUEUE_GRAPHICS_BIT | VK_QUEUE_COMPUTE_BIT))) {
+            indices.foundTransferFamily = true;
+            indices.transferFamily = i;
+        }
+    }
+    
+    // Graphics queues always support compute and transfer
+    if (indices.foundGraphicsFamily) {
+        if (!indices.foundComputeFamily) {
+            indices.foundComputeFamily = true;
+            indices.computeFamily = indices.graphicsFamily;
+        }
+        if (!indices.foundTransferFamily) {
+            indices.foundTransferFamily = true;
+            indices.transferFamily = indices.graphicsFamily;
         }
     }
     
@@ -536,7 +624,9 @@ void Game::create_logical_device() {
     QueueFamilyIndices indices = find_queue_families(mPhysicalDevice);
     
     std::vector<VkDeviceQueueCreateInfo> queueCreateInfos;
-    std::set<uint32_t> uniqueQueueFamilies = {indices.graphicsFamily, indices.presentFamily};
+    std::set<uint32_t> uniqueQueueFamilies = {
+        indices.graphicsFamily, indices.presentFamily, indices.computeFamily, indices.transferFamily
+    };
     
     float queuePriority = 1.0f;
     for (uint32_t queueFamily : uniqueQueueFamilies) {
@@ -548,15 +638,15 @@ void Game::create_logical_device() {
         queueCreateInfos.push_back(queueCreateInfo);
     }
     
-    VkPhysicalDeviceFeatures deviceFeatures{};
+    // Enable the highest supported version and the curated performance features/extensions
+    mDeviceFeatures.negotiate(mVulkanInstance, mPhysicalDevice, mInstanceApiVersion, deviceExtensions);
+    mDeviceFeatures.print(std::cout);
     
     VkDeviceCreateInfo createInfo{};
     createInfo.sType = VK_STRUCTURE_TYPE_DEVICE_CREATE_INFO;
     createInfo.queueCreateInfoCount = static_cast<uint32_t>(queueCreateInfos.size());
     createInfo.pQueueCreateInfos = queueCreateInfos.data();
-    createInfo.pEnabledFeatures = &deviceFeatures;
-    createInfo.enabledExtensionCount = static_cast<uint32_t>(deviceExtensions.size());
-    createInfo.ppEnabledExtensionNames = deviceExtensions.data();
+    mDeviceFeatures.populate_device_create_info(createInfo);
     
     if (mEnableValidationLayers) {
         createInfo.enabledLayerCount = static_cast<uint32_t>(mValidationLayers.size());
@@ -572,17 +662,17 @@ void Game::create_logical_device() {
     
     vkGetDeviceQueue(mDevice, indices.graphicsFamily, 0, &mGraphicsQueue);
     vkGetDeviceQueue(mDevice, indices.presentFamily, 0, &mPresentQueue);
+    vkGetDeviceQueue(mDevice, indices.computeFamily, 0, &mComputeQueue);
+    vkGetDeviceQueue(mDevice, indices.transferFamily, 0, &mTransferQueue);
 }
 
 //------------------------------------------------------------------------------------------
 //------------------------------------------------------------------------------------------
 void Game::create_image_views() {
-    mSwapchainImageViews.resize(mSwapchainImages.size());
-    
-    for (size_t i = 0; i < mSwapchainImages.size(); i++) {
+    for (ImageHandle image : mSwapchainImages) {
         VkImageViewCreateInfo createInfo{};
         createInfo.sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO;
-        createInfo.image = mSwapchainImages[i];
+        createInfo.image = mGpuResources.get_image(image);
         createInfo.viewType = VK_IMAGE_VIEW_TYPE_2D;
         createInfo.format = mSwapchainImageFormat;
         createInfo.components.r = VK_COMPONENT_SWIZZLE_IDENTITY;
@@ -595,28 +685,852 @@ void Game::create_image_views() {
         createInfo.subresourceRange.baseArrayLayer = 0;
         createInfo.subresourceRange.layerCount = 1;
         
-        if (vkCreateImageView(mDevice, &createInfo, nullptr, &mSwapchainImageViews[i]) != VK_SUCCESS) {
+        VkImageView& imageView = mGpuResources.images().get<GpuResources::IMAGE_VIEW>(image);
+        if (vkCreateImageView(mDevice, &createInfo, nullptr, &imageView) != VK_SUCCESS) {
             throw std::runtime_error("Failed to create image views!");
         }
     }
 }
 
+//------------------------------------------------------------------------------------------
+// Every queue gets a timeline, submissions and resource retirement are tracked by its values
+//------------------------------------------------------------------------------------------
+void Game::create_timeline_sync() {
+    mTimelineSync.init(mDevice, mDeviceFeatures.get_capabilities(), mGraphicsQueue, mComputeQueue, mTransferQueue);
+}
+
+//------------------------------------------------------------------------------------------
+// Resources are referred to by generational handles and destroyed once their work retires
+//------------------------------------------------------------------------------------------
+void Game::create_gpu_resources() {
+    mDeletionQueue.init(mDevice, &mTimelineSync);
+    mGpuResources.init(mPhysicalDevice, mDevice, &mDeletionQueue);
+}
+
+//------------------------------------------------------------------------------------------
+// Streamed levels are staged through the ring and copied on the graphics queue each frame
+//------------------------------------------------------------------------------------------
+void Game::create_texture_streamer() {
+    mStagingRing.init(&mGpuResources, &mTimelineSync, STAGING_RING_SIZE);
+    mTextureStreamer.init(mVulkanInstance, mPhysicalDevice, mDeviceFeatures.get_capabilities(), &mGpuResources,
+                          &mStagingRing, mTextureBudgetBytes, &mProfiler);
+    for (const std::string& path : mStreamedTexturePaths) {
+        mStreamedTextures.push_back(mTextureStreamer.add_texture(path));
+    }
+}
+
+//------------------------------------------------------------------------------------------
+// Descriptor sets come from per-frame pool chains so a frame's sets can be reset together
+//------------------------------------------------------------------------------------------
+void Game::create_descriptor_allocator() {
+    mDescriptorAllocator.init(mDevice, MAX_FRAMES_IN_FLIGHT);
+}
+
+//------------------------------------------------------------------------------------------
+//------------------------------------------------------------------------------------------
+void Game::create_instanced_renderer() {
+    mInstancedRenderer.init(mDevice, mDeviceFeatures.get_capabilities(), MAX_FRAMES_IN_FLIGHT,
+                            &mGpuResources, &mDescriptorAllocator);
+}
+
+//------------------------------------------------------------------------------------------
+//------------------------------------------------------------------------------------------
+void Game::create_meshlet_renderer() {
+    mMeshletRenderer.init(mDevice, mDeviceFeatures.get_capabilities(), MAX_FRAMES_IN_FLIGHT,
+                          &mGpuResources, &mDescriptorAllocator);
+}
+
+//------------------------------------------------------------------------------------------
+// Pick the first depth format usable as an optimally tiled depth attachment that can also be
+// sampled by the depth pyramid
+//------------------------------------------------------------------------------------------
+VkFormat Game::find_depth_format() {
+    const std::vector<VkFormat> candidates = {
+        VK_FORMAT_D32_SFLOAT, VK_FORMAT_D32_SFLOAT_S8_UINT, VK_FORMAT_D24_UNORM_S8_UINT
+    };
+    
+    for (VkFormat format : candidates) {
+        VkFormatProperties properties;
+        vkGetPhysicalDeviceFormatProperties(mPhysicalDevice, format, &properties);
+        
+        const VkFormatFeatureFlags features = VK_FORMAT_FEATURE_DEPTH_STENCIL_ATTACHMENT_BIT | VK_FORMAT_FEATURE_SAMPLED_IMAGE_BIT;
+        if ((properties.optimalTilingFeatures & features) == features) {
+            return format;
+        }
+    }
+    
+    throw std::runtime_error("Failed to find a supported depth format!");
+}
+
+//------------------------------------------------------------------------------------------
+//------------------------------------------------------------------------------------------
+void Game::create_depth_resources() {
+    mDepthFormat = find_depth_format();
+    
+    VkExtent3D extent = { mSwapchainExtent.width, mSwapchainExtent.height, 1 };
+    mDepthImage = mGpuResources.create_image(extent, mDepthFormat,
+                                             VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT | VK_IMAGE_USAGE_SAMPLED_BIT,
+                                             VK_IMAGE_ASPECT_DEPTH_BIT, 1);
+}
+
+//------------------------------------------------------------------------------------------
+// Occlusion culling needs the GPU driven path, the CPU path keeps frustum culling only
+//------------------------------------------------------------------------------------------
+void Game::create_depth_pyramid() {
+    if (!mInstancedRenderer.is_gpu_driven()) {
+        return;
+    }
+    
+    mDepthPyramid.init(mDevice, &mGpuResources, &mDeletionQueue, &mDescriptorAllocator, mDepthImage, mSwapchainExtent);
+    mInstancedRenderer.set_depth_pyramid(&mDepthPyramid);
+}
+
+//------------------------------------------------------------------------------------------
+// Two compatible render passes share the framebuffers. The early pass clears and draws what
+// was visible last frame, then leaves its depth readable by the depth pyramid. The late pass
+// loads both attachments, draws what just became visible and presents.
+//------------------------------------------------------------------------------------------
+void Game::create_render_pass() {
+    VkAttachmentDescription colorAttachment{};
+    colorAttachment.format = mSwapchainImageFormat;
+    colorAttachment.samples = VK_SAMPLE_COUNT_1_BIT;
+    colorAttachment.loadOp = VK_ATTACHMENT_LOAD_OP_CLEAR;
+    colorAttachment.storeOp = VK_ATTACHMENT_STORE_OP_STORE;
+    colorAttachment.stencilLoadOp = VK_ATTACHMENT_LOAD_OP_DONT_CARE;
+    colorAttachment.stencilStoreOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
+    colorAttachment.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+    colorAttachment.finalLayout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
+    
+    VkAttachmentDescription depthAttachment{};
+    depthAttachment.format = mDepthFormat;
+    depthAttachment.samples = VK_SAMPLE_COUNT_1_BIT;
+    depthAttachment.loadOp = VK_ATTACHMENT_LOAD_OP_CLEAR;
+    depthAttachment.storeOp = VK_ATTACHMENT_STORE_OP_STORE;
+    depthAttachment.stencilLoadOp = VK_ATTACHMENT_LOAD_OP_DONT_CARE;
+    depthAttachment.stencilStoreOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
+    depthAttachment.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+    depthAttachment.finalLayout = VK_IMAGE_LAYOUT_DEPTH_STENCIL_READ_ONLY_OPTIMAL;
+    
+    VkAttachmentReference colorAttachmentRef{};
+    colorAttachmentRef.attachment = 0;
+    colorAttachmentRef.layout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
+    
+    VkAttachmentReference depthAttachmentRef{};
+    depthAttachmentRef.attachment = 1;
+    depthAttachmentRef.layout = VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL;
+    
+    VkSubpassDescription subpass{};
+    subpass.pipelineBindPoint = VK_PIPELINE_BIND_POINT_GRAPHICS;
+    subpass.colorAttachmentCount = 1;
+    subpass.pColorAttachments = &colorAttachmentRef;
+    subpass.pDepthStencilAttachment = &depthAttachmentRef;
+    
+    // Wait for the swapchain image to be released, for the previous frame's depth writes and
+    // for its depth pyramid reads
+    VkSubpassDependency dependencies[2]{};
+    dependencies[0].srcSubpass = VK_SUBPASS_EXTERNAL;
+    dependencies[0].dstSubpass = 0;
+    dependencies[0].srcStageMask = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT | VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT |
+                                   VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT;
+    dependencies[0].srcAccessMask = VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT;
+    dependencies[0].dstStageMask = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT | VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT;
+    dependencies[0].dstAccessMask = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT | VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT;
+    
+    // Make the early depth visible to the pyramid and the attachments to the late pass
+    dependencies[1].srcSubpass = 0;
+    dependencies[1].dstSubpass = VK_SUBPASS_EXTERNAL;
+    dependencies[1].srcStageMask = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT | VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT;
+    dependencies[1].srcAccessMask = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT | VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT;
+    dependencies[1].dstStageMask = VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT | VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT |
+                                   VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT;
+    dependencies[1].dstAccessMask = VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_COLOR_ATTACHMENT_READ_BIT |
+                                    VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT | VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_READ_BIT |
+                                    VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT;
+    
+    VkAttachmentDescription attachments[] = { colorAttachment, depthAttachment };
+    
+    VkRenderPassCreateInfo createInfo{};
+    createInfo.sType = VK_STRUCTURE_TYPE_RENDER_PASS_CREATE_INFO;
+    createInfo.attachmentCount = 2;
+    createInfo.pAttachments = attachments;
+    createInfo.subpassCount = 1;
+    createInfo.pSubpasses = &subpass;
+    createInfo.dependencyCount = 2;
+    createInfo.pDependencies = dependencies;
+    
+    if (vkCreateRenderPass(mDevice, &createInfo, nullptr, &mRenderPass) != VK_SUCCESS) {
+        throw std::runtime_error("Failed to create render pass!");
+    }
+    
+    attachments[0].loadOp = VK_ATTACHMENT_LOAD_OP_LOAD;
+    attachments[0].initialLayout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
+    attachments[0].finalLayout = VK_IMAGE_LAYOUT_PRESENT_SRC_KHR;
+    attachments[1].loadOp = VK_ATTACHMENT_LOAD_OP_LOAD;
+    attachments[1].storeOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
+    attachments[1].initialLayout = VK_IMAGE_LAYOUT_DEPTH_STENCIL_READ_ONLY_OPTIMAL;
+    attachments[1].finalLayout = VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL;
+    
+    // Wait for the pyramid's depth reads before the depth goes back to being written
+    VkSubpassDependency lateDependency{};
+    lateDependency.srcSubpass = VK_SUBPASS_EXTERNAL;
+    lateDependency.dstSubpass = 0;
+    lateDependency.srcStageMask = VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT;
+    lateDependency.srcAccessMask = 0;
+    lateDependency.dstStageMask = VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT;
+    lateDependency.dstAccessMask = VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_READ_BIT | VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT;
+    
+    createInfo.dependencyCount = 1;
+    createInfo.pDependencies = &lateDependency;
+    
+    if (vkCreateRenderPass(mDevice, &createInfo, nullptr, &mLateRenderPass) != VK_SUCCESS) {
+        throw std::runtime_error("Failed to create late render pass!");
+    }
+}
+
+//------------------------------------------------------------------------------------------
+// The pipelines use their renderer's layout, so the layouts are not owned by the entries
+//------------------------------------------------------------------------------------------
+void Game::create_graphics_pipeline() {
+    mInstancedPipeline = create_scene_pipeline("instanced_quantized.vert.spv", VK_SHADER_STAGE_VERTEX_BIT,
+                                               mInstancedRenderer.get_pipeline_layout(), VERTEX_FORMAT_QUANTIZED);
+    
+    if (mMeshletRenderer.uses_mesh_shaders()) {
+        mMeshletPipeline = create_scene_pipeline("meshlet.mesh.spv", VK_SHADER_STAGE_MESH_BIT_NV,
+                                                 mMeshletRenderer.get_pipeline_layout(), VERTEX_FORMAT_FLOAT);
+    }
+    else if (mMeshletRenderer.is_supported()) {
+        mMeshletPipeline = create_scene_pipeline("meshlet.vert.spv", VK_SHADER_STAGE_VERTEX_BIT,
+                                                 mMeshletRenderer.get_pipeline_layout(), VERTEX_FORMAT_FLOAT);
+    }
+    mMeshletRenderer.set_pipeline(mMeshletPipeline);
+}
+
+//------------------------------------------------------------------------------------------
+// Scene pipelines share all fixed function state and the fragment shader. A mesh shader
+// stage replaces the vertex input and input assembly.
+//------------------------------------------------------------------------------------------
+PipelineHandle Game::create_scene_pipeline(const char* shaderName, VkShaderStageFlagBits stage, VkPipelineLayout layout,
+                                           VertexFormat vertexFormat) {
+    VkShaderModule vertShaderModule = load_shader_module(mDevice, shaderName);
+    VkShaderModule fragShaderModule = load_shader_module(mDevice, "instanced.frag.spv");
+    
+    VkPipelineShaderStageCreateInfo shaderStages[2]{};
+    shaderStages[0].sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
+    shaderStages[0].stage = stage;
+    shaderStages[0].module = vertShaderModule;
+    shaderStages[0].pName = "main";
+    shaderStages[1].sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
+    shaderStages[1].stage = VK_SHADER_STAGE_FRAGMENT_BIT;
+    shaderStages[1].module = fragShaderModule;
+    shaderStages[1].pName = "main";
+    
+    VertexInputDescription vertexInput = get_vertex_input_description(vertexFormat);
+    
+    VkPipelineVertexInputStateCreateInfo vertexInputInfo{};
+    vertexInputInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_VERTEX_INPUT_STATE_CREATE_INFO;
+    vertexInputInfo.vertexBindingDescriptionCount = 1;
+    vertexInputInfo.pVertexBindingDescriptions = &vertexInput.binding;
+    vertexInputInfo.vertexAttributeDescriptionCount = static_cast<uint32_t>(vertexInput.attributes.size());
+    vertexInputInfo.pVertexAttributeDescriptions = vertexInput.attributes.data();
+    
+    VkPipelineInputAssemblyStateCreateInfo inputAssembly{};
+    inputAssembly.sType = VK_STRUCTURE_TYPE_PIPELINE_INPUT_ASSEMBLY_STATE_CREATE_INFO;
+    inputAssembly.topology = VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST;
+    inputAssembly.primitiveRestartEnable = VK_FALSE;
+    
+    VkViewport viewport{};
+    viewport.x = 0.0f;
+    viewport.y = 0.0f;
+    viewport.width = static_cast<float>(mSwapchainExtent.width);
+    viewport.height = static_cast<float>(mSwapchainExtent.height);
+    viewport.minDepth = 0.0f;
+    viewport.maxDepth = 1.0f;
+    
+    VkRect2D scissor{};
+    scissor.offset = {0, 0};
+    scissor.extent = mSwapchainExtent;
+    
+    VkPipelineViewportStateCreateInfo viewportState{};
+    viewportState.sType = VK_STRUCTURE_TYPE_PIPELINE_VIEWPORT_STATE_CREATE_INFO;
+    viewportState.viewportCount = 1;
+    viewportState.pViewports = &viewport;
+    viewportState.scissorCount = 1;
+    viewportState.pScissors = &scissor;
+    
+    VkPipelineRasterizationStateCreateInfo rasterizer{};
+    rasterizer.sType = VK_STRUCTURE_TYPE_PIPELINE_RASTERIZATION_STATE_CREATE_INFO;
+    rasterizer.depthClampEnable = VK_FALSE;
+    rasterizer.rasterizerDiscardEnable = VK_FALSE;
+    rasterizer.polygonMode = VK_POLYGON_MODE_FILL;
+    rasterizer.lineWidth = 1.0f;
+    rasterizer.cullMode = VK_CULL_MODE_BACK_BIT;
+    // The projection flips Y, so the mesh's counter clockwise faces stay counter clockwise on screen
+    rasterizer.frontFace = VK_FRONT_FACE_COUNTER_CLOCKWISE;
+    rasterizer.depthBiasEnable = VK_FALSE;
+    
+    VkPipelineMultisampleStateCreateInfo multisampling{};
+    multisampling.sType = VK_STRUCTURE_TYPE_PIPELINE_MULTISAMPLE_STATE_CREATE_INFO;
+    multisampling.sampleShadingEnable = VK_FALSE;
+    multisampling.rasterizationSamples = VK_SAMPLE_COUNT_1_BIT;
+    
+    VkPipelineDepthStencilStateCreateInfo depthStencil{};
+    depthStencil.sType = VK_STRUCTURE_TYPE_PIPELINE_DEPTH_STENCIL_STATE_CREATE_INFO;
+    depthStencil.depthTestEnable = VK_TRUE;
+    depthStencil.depthWriteEnable = VK_TRUE;
+    depthStencil.depthCompareOp = VK_COMPARE_OP_LESS;
+    depthStencil.depthBoundsTestEnable = VK_FALSE;
+    depthStencil.stencilTestEnable = VK_FALSE;
+    
+    VkPipelineColorBlendAttachmentState colorBlendAttachment{};
+    colorBlendAttachment.colorWriteMask = VK_COLOR_COMPONENT_R_BIT | VK_COLOR_COMPONENT_G_BIT |
+                                          VK_COLOR_COMPONENT_B_BIT | VK_COLOR_COMPONENT_A_BIT;
+    colorBlendAttachment.blendEnable = VK_FALSE;
+    
+    VkPipelineColorBlendStateCreateInfo colorBlending{};
+    colorBlending.sType = VK_STRUCTURE_TYPE_PIPELINE_COLOR_BLEND_STATE_CREATE_INFO;
+    colorBlending.logicOpEnable = VK_FALSE;
+    colorBlending.attachmentCount = 1;
+    colorBlending.pAttachments = &colorBlendAttachment;
+    
+    VkGraphicsPipelineCreateInfo pipelineInfo{};
+    pipelineInfo.sType = VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_CREATE_INFO;
+    pipelineInfo.stageCount = 2;
+    pipelineInfo.pStages = shaderStages;
+    if (stage == VK_SHADER_STAGE_VERTEX_BIT) {
+        pipelineInfo.pVertexInputState = &vertexInputInfo;
+        pipelineInfo.pInputAssemblyState = &inputAssembly;
+    }
+    pipelineInfo.pViewportState = &viewportState;
+    pipelineInfo.pRasterizationState = &rasterizer;
+    pipelineInfo.pMultisampleState = &multisampling;
+    pipelineInfo.pDepthStencilState = &depthStencil;
+    pipelineInfo.pColorBlendState = &colorBlending;
+    pipelineInfo.layout = layout;
+    pipelineInfo.renderPass = mRenderPass;
+    pipelineInfo.subpass = 0;
+    
+    VkPipeline pipeline;
+    if (vkCreateGraphicsPipelines(mDevice, VK_NULL_HANDLE, 1, &pipelineInfo, nullptr, &pipeline) != VK_SUCCESS) {
+        throw std::runtime_error("Failed to create graphics pipeline!");
+    }
+    
+    vkDestroyShaderModule(mDevice, fragShaderModule, nullptr);
+    vkDestroyShaderModule(mDevice, vertShaderModule, nullptr);
+    
+    return mGpuResources.add_pipeline(pipeline, layout, VK_PIPELINE_BIND_POINT_GRAPHICS, false);
+}
+
+//------------------------------------------------------------------------------------------
+//------------------------------------------------------------------------------------------
+void Game::create_framebuffers() {
+    mSwapchainFramebuffers.resize(mSwapchainImages.size());
+    
+    for (size_t i = 0; i < mSwapchainImages.size(); i++) {
+        VkImageView attachments[] = {
+            mGpuResources.get_image_view(mSwapchainImages[i]),
+            mGpuResources.get_image_view(mDepthImage)
+        };
+        
+        VkFramebufferCreateInfo createInfo{};
+        createInfo.sType = VK_STRUCTURE_TYPE_FRAMEBUFFER_CREATE_INFO;
+        createInfo.renderPass = mRenderPass;
+        createInfo.attachmentCount = 2;
+        createInfo.pAttachments = attachments;
+        createInfo.width = mSwapchainExtent.width;
+        createInfo.height = mSwapchainExtent.height;
+        createInfo.layers = 1;
+        
+        if (vkCreateFramebuffer(mDevice, &createInfo, nullptr, &mSwapchainFramebuffers[i]) != VK_SUCCESS) {
+            throw std::runtime_error("Failed to create framebuffer!");
+        }
+    }
+}
+
+//------------------------------------------------------------------------------------------
+// One pool per frame slot, reset as a whole once the slot retires
+//------------------------------------------------------------------------------------------
+void Game::create_command_pools() {
+    QueueFamilyIndices indices = find_queue_families(mPhysicalDevice);
+    
+    mCommandPools.resize(MAX_FRAMES_IN_FLIGHT);
+    mCommandBuffers.resize(MAX_FRAMES_IN_FLIGHT);
+    
+    for (uint32_t i = 0; i < MAX_FRAMES_IN_FLIGHT; i++) {
+        VkCommandPoolCreateInfo createInfo{};
+        createInfo.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
+        createInfo.flags = VK_COMMAND_POOL_CREATE_TRANSIENT_BIT;
+        createInfo.queueFamilyIndex = indices.graphicsFamily;
+        
+        if (vkCreateCommandPool(mDevice, &createInfo, nullptr, &mCommandPools[i]) != VK_SUCCESS) {
+            throw std::runtime_error("Failed to create command pool!");
+        }
+        
+        VkCommandBufferAllocateInfo allocateInfo{};
+        allocateInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+        allocateInfo.commandPool = mCommandPools[i];
+        allocateInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+        allocateInfo.commandBufferCount = 1;
+        
+        if (vkAllocateCommandBuffers(mDevice, &allocateInfo, &mCommandBuffers[i]) != VK_SUCCESS) {
+            throw std::runtime_error("Failed to allocate command buffers!");
+        }
+    }
+}
+
+//------------------------------------------------------------------------------------------
+// Frame slots retire through the graphics timeline, only the swapchain needs binary semaphores
+//------------------------------------------------------------------------------------------
+void Game::create_sync_objects() {
+    VkSemaphoreCreateInfo createInfo{};
+    createInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO;
+    
+    mImageAvailableSemaphores.resize(MAX_FRAMES_IN_FLIGHT);
+    for (VkSemaphore& semaphore : mImageAvailableSemaphores) {
+        if (vkCreateSemaphore(mDevice, &createInfo, nullptr, &semaphore) != VK_SUCCESS) {
+            throw std::runtime_error("Failed to create semaphore!");
+        }
+    }
+    
+    mRenderFinishedSemaphores.resize(mSwapchainImages.size());
+    for (VkSemaphore& semaphore : mRenderFinishedSemaphores) {
+        if (vkCreateSemaphore(mDevice, &createInfo, nullptr, &semaphore) != VK_SUCCESS) {
+            throw std::runtime_error("Failed to create semaphore!");
+        }
+    }
+    
+    mFrameTimelineValues.assign(MAX_FRAMES_IN_FLIGHT, 0);
+}
+
+//------------------------------------------------------------------------------------------
+// A square grid of spinning cubes and spheres with levels of detail, dense spheres hover
+// above them on a coarser grid
+//------------------------------------------------------------------------------------------
+void Game::create_scene() {
+    mJobSystem.init(0);
+    mHierarchy.init(&mJobSystem);
+    
+    // The cubes are drawn from quantized vertices, half the size of float ones
+    const QuantizedMeshData cube = quantize_mesh(MeshData::make_cube());
+    mCubeMesh = mInstancedRenderer.add_mesh(cube.get_view());
+    mCubeMaterial = mInstancedRenderer.add_material(mInstancedPipeline);
+    
+    // The levels only index the sphere's vertices, so they share its quantized ones
+    MeshData lodSphere = MeshData::make_sphere(64, 32);
+    optimize_mesh(lodSphere);
+    const std::vector<MeshLodData> sphereLods = generate_lods(lodSphere);
+    const QuantizedMeshData quantizedSphere = quantize_mesh(lodSphere);
+    std::vector<MeshView> sphereViews(1, quantizedSphere.get_view());
+    for (const MeshLodData& lod : sphereLods) {
+        sphereViews.push_back(get_lod_view(sphereViews[0], lod));
+    }
+    mLodSphereMesh = mInstancedRenderer.add_mesh(sphereViews);
+    
+    const uint32_t side = static_cast<uint32_t>(std::ceil(std::sqrt(static_cast<float>(mDemoInstanceCount))));
+    const float spacing = 2.0f;
+    const float halfExtent = 0.5f * spacing * (side - 1);
+    
+    for (uint32_t i = 0; i < mDemoInstanceCount; i++) {
+        Transform transform;
+        transform.position = glm::vec3(spacing * (i % side) - halfExtent, 0.0f, spacing * (i / side) - halfExtent);
+        transform.rotation = glm::quat(1.0f, 0.0f, 0.0f, 0.0f);
+        transform.scale = glm::vec3(1.0f);
+        
+        mWorld.create_entity(transform, PreviousTransform{ transform }, Spin{ glm::vec3(0.0f, 1.0f, 0.0f), 1.0f, 0.01f * i },
+                             InstancedMesh{ (i + i / side) % 2 == 0 ? mCubeMesh : mLodSphereMesh, mCubeMaterial });
+    }
+    
+    if (mMeshletRenderer.is_supported()) {
+        MeshData sphere = MeshData::make_sphere(128, 64);
+        mSphereMesh = mMeshletRenderer.add_mesh(sphere, MeshletData::build(sphere, MESHLET_MAX_VERTICES, MESHLET_MAX_TRIANGLES));
+        
+        const uint32_t sphereSide = static_cast<uint32_t>(std::ceil(std::sqrt(static_cast<float>(mDemoMeshletObjectCount))));
+        const float sphereSpacing = 16.0f;
+        const float sphereHalfExtent = 0.5f * sphereSpacing * (sphereSide - 1);
+        
+        // The spheres hang off a field node that slowly turns, moving all of them at once
+        Transform field;
+        field.position = glm::vec3(0.0f, 6.0f, 0.0f);
+        field.rotation = glm::quat(1.0f, 0.0f, 0.0f, 0.0f);
+        field.scale = glm::vec3(1.0f);
+        mSphereFieldNode = mHierarchy.create_node(TransformNode(), field);
+        
+        for (uint32_t i = 0; i < mDemoMeshletObjectCount; i++) {
+            Transform transform;
+            transform.position = glm::vec3(sphereSpacing * (i % sphereSide) - sphereHalfExtent, 0.0f,
+                                           sphereSpacing * (i / sphereSide) - sphereHalfExtent);
+            transform.rotation = glm::quat(1.0f, 0.0f, 0.0f, 0.0f);
+            transform.scale = glm::vec3(4.0f);
+            
+            mWorld.create_entity(SceneNode{ mHierarchy.create_node(mSphereFieldNode, transform) }, MeshletMesh{ mSphereMesh });
+        }
+    }
+    
+    create_systems();
+}
+
+//------------------------------------------------------------------------------------------
+// The simulation steps at a fixed rate and keeps the previous state around, the frame
+// systems draw a blend of the two. Spinning writes the transforms the instanced systems
+// read, the sphere field's hierarchy update and submission overlap with those.
+//------------------------------------------------------------------------------------------
+void Game::create_systems() {
+    mSimulationScheduler.init(&mWorld, &mJobSystem, &mProfiler);
+    mScheduler.init(&mWorld, &mJobSystem, &mProfiler);
+    // The gather's components, so sizing and submission see the entities it wrote, in its order
+    mInstancedQuery = mWorld.create_query<Transform, PreviousTransform, InstancedMesh>();
+    
+    mSimulationScheduler.add_system<const Transform, PreviousTransform>("SavePreviousTransforms",
+        [](const SystemScheduler::SystemContext&, Entity, const Transform& transform, PreviousTransform& previous) {
+            previous.value = transform;
+        });
+    mSimulationScheduler.add_system<const Spin, Transform>("Spin",
+        [](const SystemScheduler::SystemContext& context, Entity, const Spin& spin, Transform& transform) {
+            transform.rotation = glm::angleAxis(spin.phase + spin.speed * static_cast<float>(context.time), spin.axis);
+        });
+    
+    // Chunks write disjoint ranges of mCubeTransforms, sized before the run. Normalizing the
+    // blended quaternion is close enough to a slerp between two steps and much cheaper.
+    const SystemId gather = mScheduler.add_chunk_system<const Transform, const PreviousTransform, const InstancedMesh>(
+        "GatherInstanced",
+        [this](const SystemScheduler::SystemContext& context, uint32_t count, const Entity*,
+               const Transform* pTransforms, const PreviousTransform* pPrevious, const InstancedMesh*) {
+            const float alpha = mInterpolationAlpha;
+            for (uint32_t i = 0; i < count; i++) {
+                const Transform& previous = pPrevious[i].value;
+                const Transform& current = pTransforms[i];
+                const glm::vec3 position = glm::mix(previous.position, current.position, alpha);
+                const glm::vec3 scale = glm::mix(previous.scale, current.scale, alpha);
+                const float sign = glm::dot(previous.rotation, current.rotation) < 0.0f ? -1.0f : 1.0f;
+                const glm::quat rotation = glm::normalize(previous.rotation * (1.0f - alpha) + current.rotation * (sign * alpha));
+                
+                const uint32_t index = context.firstEntity + i;
+                mCubeTransforms.positionX[index] = position.x;
+                mCubeTransforms.positionY[index] = position.y;
+                mCubeTransforms.positionZ[index] = position.z;
+                mCubeTransforms.rotationX[index] = rotation.x;
+                mCubeTransforms.rotationY[index] = rotation.y;
+                mCubeTransforms.rotationZ[index] = rotation.z;
+                mCubeTransforms.rotationW[index] = rotation.w;
+                mCubeTransforms.scaleX[index] = scale.x;
+                mCubeTransforms.scaleY[index] = scale.y;
+                mCubeTransforms.scaleZ[index] = scale.z;
+            }
+        });
+    
+    const SystemId compose = mScheduler.add_task("ComposeInstanced", 0, 0, { gather },
+        [this](const SystemScheduler::SystemContext&) {
+            compose_matrices(get_simd_level(), mCubeTransforms, mCubeMatrices.data(), sizeof(glm::mat4));
+        });
+    
+    // Queries over the same components match the same archetypes in the same order, so the
+    // index into the matrices is the query order index the gather wrote them at
+    mScheduler.add_task("SubmitInstanced", component_mask<Transform, PreviousTransform, InstancedMesh>(), 0, { compose },
+        [this](const SystemScheduler::SystemContext& context) {
+            uint32_t firstEntity = 0;
+            context.pWorld->for_each_chunk<const Transform, const PreviousTransform, const InstancedMesh>(mInstancedQuery,
+                [this, &firstEntity](uint32_t count, const Entity*, const Transform*, const PreviousTransform*,
+                                     const InstancedMesh* pInstances) {
+                    for (uint32_t i = 0; i < count; i++) {
+                        mInstancedRenderer.submit(pInstances[i].mesh, pInstances[i].material, mCubeMatrices[firstEntity + i]);
+                    }
+                    firstEntity += count;
+                });
+        });
+    
+    if (mMeshletRenderer.is_supported()) {
+        mSimulationScheduler.add_task("AdvanceSphereField", 0, 0, {},
+            [this](const SystemScheduler::SystemContext& context) {
+                mPreviousSphereFieldAngle = mSphereFieldAngle;
+                mSphereFieldAngle += 0.05f * context.deltaTime;
+            });
+        
+        const SystemId animate = mScheduler.add_task("AnimateSphereField", 0, 0, {},
+            [this](const SystemScheduler::SystemContext&) {
+                Transform field = mHierarchy.get_local(mSphereFieldNode);
+                const float angle = glm::mix(mPreviousSphereFieldAngle, mSphereFieldAngle, mInterpolationAlpha);
+                field.rotation = glm::angleAxis(angle, glm::vec3(0.0f, 1.0f, 0.0f));
+                mHierarchy.set_local(mSphereFieldNode, field);
+            });
+        const SystemId hierarchy = mScheduler.add_task("UpdateHierarchy", 0, 0, { animate },
+            [this](const SystemScheduler::SystemContext&) {
+                mHierarchy.update();
+            });
+        
+        mMeshletQuery = mWorld.create_query<SceneNode, MeshletMesh>();
+        mScheduler.add_task("SubmitMeshlets", component_mask<SceneNode, MeshletMesh>(), 0, { hierarchy },
+            [this](const SystemScheduler::SystemContext& context) {
+                context.pWorld->for_each<const SceneNode, const MeshletMesh>(mMeshletQuery,
+                    [this](Entity, const SceneNode& sceneNode, const MeshletMesh& meshlet) {
+                        mMeshletRenderer.submit(meshlet.mesh, mHierarchy.get_world(sceneNode.node));
+                    });
+            });
+    }
+    
+    mSimulationScheduler.print_schedule(std::cout);
+    mScheduler.print_schedule(std::cout);
+    if (mWriteScheduleGraphs) {
+        std::ofstream simulationGraph("juniper_simulation_schedule.dot");
+        mSimulationScheduler.write_graphviz(simulationGraph);
+        std::ofstream graph("juniper_schedule.dot");
+        mScheduler.write_graphviz(graph);
+    }
+    
+    FixedTimestep::Settings settings;
+    settings.stepSeconds = mSimulationStepSeconds;
+    settings.maxStepsPerFrame = 4;
+    settings.maxFrameSeconds = 0.25;
+    settings.threaded = mThreadedSimulation;
+    mTimestep.init(settings, [this](double time, float deltaTime) { mSimulationScheduler.run(time, deltaTime); });
+}
+
+//------------------------------------------------------------------------------------------
+// Runs the simulation steps due, inline or on the simulation thread, then submits every
+// drawn entity blended between the last two steps. The state mutex keeps the simulation
+// thread from stepping while the frame systems read the world.
+//------------------------------------------------------------------------------------------
+void Game::update_scene() {
+    const double time = glfwGetTime();
+    const float deltaTime = mFrameCount == 0 ? 0.0f : static_cast<float>(time - mSceneTime);
+    mSceneTime = time;
+    
+    mTimestep.advance();
+    
+    std::lock_guard<std::mutex> lock(mTimestep.get_state_mutex());
+    mInterpolationAlpha = mTimestep.get_alpha();
+    
+    const uint32_t instancedCount = mWorld.count(mInstancedQuery);
+    mCubeTransforms.resize(instancedCount);
+    mCubeMatrices.resize(instancedCount);
+    
+    mScheduler.run(time, deltaTime);
+}
+
+//------------------------------------------------------------------------------------------
+//------------------------------------------------------------------------------------------
+void Game::draw_frame() {
+    // Block until the GPU retired the last frame that used this slot
+    mTimelineSync.wait(TimelineSync::QUEUE_GRAPHICS, mFrameTimelineValues[mCurrentFrame]);
+    mDescriptorAllocator.begin_frame(mCurrentFrame);
+    
+    uint32_t imageIndex;
+    VkResult result = vkAcquireNextImageKHR(mDevice, mSwapchain, UINT64_MAX, mImageAvailableSemaphores[mCurrentFrame],
+                                            VK_NULL_HANDLE, &imageIndex);
+    if (result != VK_SUCCESS && result != VK_SUBOPTIMAL_KHR) {
+        throw std::runtime_error("Failed to acquire swap chain image!");
+    }
+    
+    // Slowly turn a camera standing in the middle of the grid, so most cubes are outside the frustum
+    const float time = static_cast<float>(glfwGetTime());
+    const float side = std::ceil(std::sqrt(static_cast<float>(mDemoInstanceCount)));
+    glm::vec3 eye(0.0f, 12.0f, 0.0f);
+    glm::vec3 target(side * std::cos(0.1f * time), 0.0f, side * std::sin(0.1f * time));
+    glm::mat4 view = glm::lookAt(eye, target, glm::vec3(0.0f, 1.0f, 0.0f));
+    glm::mat4 projection = glm::perspective(glm::radians(45.0f),
+                                            mSwapchainExtent.width / static_cast<float>(mSwapchainExtent.height),
+                                            0.1f, 2.0f * side);
+    // GLM targets OpenGL clip space where Y points up
+    projection[1][1] *= -1;
+    
+    mInstancedRenderer.begin_frame(mCurrentFrame);
+    mMeshletRenderer.begin_frame(mCurrentFrame);
+    update_scene();
+    // Levels of detail may be off by a pixel at most
+    mInstancedRenderer.set_lod_selection(0.5f * std::abs(projection[1][1]) * mSwapchainExtent.height, 1.0f);
+    mInstancedRenderer.prepare(projection * view);
+    mMeshletRenderer.prepare(projection * view, eye);
+    
+    vkResetCommandPool(mDevice, mCommandPools[mCurrentFrame], 0);
+    VkCommandBuffer commandBuffer = mCommandBuffers[mCurrentFrame];
+    
+    VkCommandBufferBeginInfo beginInfo{};
+    beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+    beginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+    
+    if (vkBeginCommandBuffer(commandBuffer, &beginInfo) != VK_SUCCESS) {
+        throw std::runtime_error("Failed to begin recording command buffer!");
+    }
+    
+    // Nothing samples the streamed textures yet, so they are asked for at the screen's size
+    const float screenPixels = static_cast<float>(std::max(mSwapchainExtent.width, mSwapchainExtent.height));
+    for (StreamedTextureHandle texture : mStreamedTextures) {
+        mTextureStreamer.request_level(texture, mTextureStreamer.estimate_level(texture, screenPixels));
+    }
+    mTextureStreamer.update(commandBuffer);
+    
+    mInstancedRenderer.dispatch_culling(commandBuffer, InstancedRenderer::CULL_PHASE_EARLY);
+    mMeshletRenderer.dispatch_culling(commandBuffer);
+    
+    VkClearValue clearValues[2]{};
+    clearValues[0].color = {{0.05f, 0.05f, 0.08f, 1.0f}};
+    clearValues[1].depthStencil = {1.0f, 0};
+    
+    VkRenderPassBeginInfo renderPassInfo{};
+    renderPassInfo.sType = VK_STRUCTURE_TYPE_RENDER_PASS_BEGIN_INFO;
+    renderPassInfo.renderPass = mRenderPass;
+    renderPassInfo.framebuffer = mSwapchainFramebuffers[imageIndex];
+    renderPassInfo.renderArea.offset = {0, 0};
+    renderPassInfo.renderArea.extent = mSwapchainExtent;
+    renderPassInfo.clearValueCount = 2;
+    renderPassInfo.pClearValues = clearValues;
+    
+    vkCmdBeginRenderPass(commandBuffer, &renderPassInfo, VK_SUBPASS_CONTENTS_INLINE);
+    mInstancedRenderer.record(commandBuffer, InstancedRenderer::CULL_PHASE_EARLY);
+    mMeshletRenderer.record(commandBuffer);
+    vkCmdEndRenderPass(commandBuffer);
+    
+    if (mInstancedRenderer.uses_occlusion_culling()) {
+        mDepthPyramid.build(commandBuffer);
+        mInstancedRenderer.dispatch_culling(commandBuffer, InstancedRenderer::CULL_PHASE_LATE);
+    }
+    
+    // Always runs, it moves the color attachment to the present layout
+    renderPassInfo.renderPass = mLateRenderPass;
+    renderPassInfo.clearValueCount = 0;
+    renderPassInfo.pClearValues = nullptr;
+    
+    vkCmdBeginRenderPass(commandBuffer, &renderPassInfo, VK_SUBPASS_CONTENTS_INLINE);
+    mInstancedRenderer.record(commandBuffer, InstancedRenderer::CULL_PHASE_LATE);
+    vkCmdEndRenderPass(commandBuffer);
+    
+    if (vkEndCommandBuffer(commandBuffer) != VK_SUCCESS) {
+        throw std::runtime_error("Failed to record command buffer!");
+    }
+    
+    TimelineSync::Submission submission;
+    submission.commandBuffers = { commandBuffer };
+    submission.binaryWaitSemaphores = { mImageAvailableSemaphores[mCurrentFrame] };
+    submission.binaryWaitStages = { VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT };
+    submission.binarySignalSemaphores = { mRenderFinishedSemaphores[imageIndex] };
+    mFrameTimelineValues[mCurrentFrame] = mTimelineSync.submit(TimelineSync::QUEUE_GRAPHICS, submission);
+    mStagingRing.submit(TimelineSync::QUEUE_GRAPHICS, mFrameTimelineValues[mCurrentFrame]);
+    
+    VkPresentInfoKHR presentInfo{};
+    presentInfo.sType = VK_STRUCTURE_TYPE_PRESENT_INFO_KHR;
+    presentInfo.waitSemaphoreCount = 1;
+    presentInfo.pWaitSemaphores = &mRenderFinishedSemaphores[imageIndex];
+    presentInfo.swapchainCount = 1;
+    presentInfo.pSwapchains = &mSwapchain;
+    presentInfo.pImageIndices = &imageIndex;
+    
+    result = vkQueuePresentKHR(mPresentQueue, &presentInfo);
+    if (result != VK_SUCCESS && result != VK_SUBOPTIMAL_KHR) {
+        throw std::runtime_error("Failed to present swap chain image!");
+    }
+    
+    mCurrentFrame = (mCurrentFrame + 1) % MAX_FRAMES_IN_FLIGHT;
+    mFrameCount++;
+}
+
 //------------------------------------------------------------------------------------------
 //------------------------------------------------------------------------------------------
 void Game::main_loop() {
     while (!glfwWindowShouldClose(mpWindow)) {
+        // Polling right after the wait keeps input as fresh as possible for the frame
+        mFramePacer.wait();
         glfwPollEvents();
+        draw_frame();
+        
+        // Destroy resources whose last GPU use has retired
+        mDeletionQueue.collect();
+        
+        // A few frames once the scene settled, open the trace in chrome://tracing or Perfetto
+        if (mWriteTrace && mFrameCount == 1000) {
+            mProfiler.begin_capture();
+        }
+        else if (mWriteTrace && mFrameCount == 1010) {
+            mProfiler.end_capture();
+            std::ofstream trace("juniper_trace.json");
+            mProfiler.write_chrome_trace(trace);
+        }
+        
+        if (mFrameCount % 1000 == 0) {
+            std::lock_guard<std::mutex> lock(mTimestep.get_state_mutex());
+            mTimestep.print_stats(std::cout);
+            mSimulationScheduler.print_stats(std::cout);
+            mScheduler.print_stats(std::cout);
+            mFramePacer.print_stats(std::cout);
+            mProfiler.print_counters(std::cout);
+            mWorld.print_stats(std::cout);
+            mHierarchy.print_stats(std::cout);
+            mInstancedRenderer.print_stats(std::cout);
+            mMeshletRenderer.print_stats(std::cout);
+            mTextureStreamer.print_stats(std::cout);
+        }
     }
 }
 
 //------------------------------------------------------------------------------------------
 //------------------------------------------------------------------------------------------
 void Game::clean_up() {
-    for (VkImageView imageView : mSwapchainImageViews) {
-        vkDestroyImageView(mDevice, imageView, nullptr);
+    // Let all submitted work retire before anything it may reference is destroyed
+    mTimelineSync.wait_all();
+    mTimestep.clean_up();
+    
+    mTimestep.print_stats(std::cout);
+    mSimulationScheduler.print_stats(std::cout);
+    mScheduler.print_stats(std::cout);
+    mFramePacer.print_stats(std::cout);
+    mProfiler.print_counters(std::cout);
+    mWorld.print_stats(std::cout);
+    mHierarchy.print_stats(std::cout);
+    mInstancedRenderer.print_stats(std::cout);
+    mMeshletRenderer.print_stats(std::cout);
+    mTextureStreamer.print_stats(std::cout);
+    
+    for (VkSemaphore semaphore : mImageAvailableSemaphores) {
+        vkDestroySemaphore(mDevice, semaphore, nullptr);
     }
+    for (VkSemaphore semaphore : mRenderFinishedSemaphores) {
+        vkDestroySemaphore(mDevice, semaphore, nullptr);
+    }
+    
+    for (VkCommandPool commandPool : mCommandPools) {
+        vkDestroyCommandPool(mDevice, commandPool, nullptr);
+    }
+    
+    for (VkFramebuffer framebuffer : mSwapchainFramebuffers) {
+        mDeletionQueue.enqueue(DeletionQueue::RESOURCE_FRAMEBUFFER, framebuffer);
+    }
+    mSwapchainFramebuffers.clear();
+    
+    mGpuResources.destroy_pipeline(mInstancedPipeline);
+    if (!mMeshletPipeline.is_null()) {
+        mGpuResources.destroy_pipeline(mMeshletPipeline);
+    }
+    if (mInstancedRenderer.uses_occlusion_culling()) {
+        mDepthPyramid.clean_up();
+    }
+    mGpuResources.destroy_image(mDepthImage);
+    mInstancedRenderer.clean_up();
+    mMeshletRenderer.clean_up();
+    mTextureStreamer.clean_up();
+    mStreamedTextures.clear();
+    mStagingRing.clean_up();
+    mSimulationScheduler.clean_up();
+    mScheduler.clean_up();
+    mHierarchy.clean_up();
+    mJobSystem.clean_up();
+    mWorld.clean_up();
+    
+    vkDestroyRenderPass(mDevice, mRenderPass, nullptr);
+    vkDestroyRenderPass(mDevice, mLateRenderPass, nullptr);
+    
+    mDescriptorAllocator.print_stats(std::cout);
+    mDescriptorAllocator.clean_up();
+    
+    for (ImageHandle image : mSwapchainImages) {
+        mGpuResources.destroy_image(image);
+    }
+    mSwapchainImages.clear();
+    mDeletionQueue.enqueue(DeletionQueue::RESOURCE_SWAPCHAIN, mSwapchain);
     
-    vkDestroySwapchainKHR(mDevice, mSwapchain, nullptr);
+    mGpuResources.clean_up();
+    
+    // Everything has retired at this point, so this empties the queue
+    mDeletionQueue.collect();
+    mDeletionQueue.clean_up();
+    
+    mTimelineSync.clean_up();
     
     vkDestroyDevice(mDevice, nullptr);
     
@@ -633,3 +1547,4 @@ void Game::clean_up() {
 
     glfwTerminate();
 }
+
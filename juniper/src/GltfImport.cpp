@@ -0,0 +1,798 @@
+//======================================================================
+// GltfImport.cpp
+//
+// Keegan Kochis
+// Created: 2026/10/18
+// The definition of the GltfImporter class.
+//======================================================================
+
+#include "GltfImport.h"
+#include "ContentHash.h"
+
+#include <cstdint>
+#include <cstring>
+
+#include <algorithm>
+#include <filesystem>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#define GLM_FORCE_RADIANS
+#define GLM_FORCE_DEPTH_ZERO_TO_ONE
+#include <glm/geometric.hpp>
+#include <glm/mat3x3.hpp>
+#include <glm/mat4x4.hpp>
+#include <glm/matrix.hpp>
+#include <glm/vec3.hpp>
+#include <glm/vec4.hpp>
+#include <glm/gtc/quaternion.hpp>
+
+static const uint32_t GLB_MAGIC = 0x46546C67;           // "glTF"
+static const uint32_t GLB_CHUNK_JSON = 0x4E4F534A;
+static const uint32_t GLB_CHUNK_BIN = 0x004E4942;
+
+static const uint32_t COMPONENT_BYTE = 5120;
+static const uint32_t COMPONENT_UNSIGNED_BYTE = 5121;
+static const uint32_t COMPONENT_SHORT = 5122;
+static const uint32_t COMPONENT_UNSIGNED_SHORT = 5123;
+static const uint32_t COMPONENT_UNSIGNED_INT = 5125;
+static const uint32_t COMPONENT_FLOAT = 5126;
+
+static const uint32_t MODE_TRIANGLES = 4;
+static const uint32_t MODE_TRIANGLE_STRIP = 5;
+static const uint32_t MODE_TRIANGLE_FAN = 6;
+
+static const uint32_t INVALID_INDEX = SceneFile::INVALID_INDEX;
+
+static uint32_t read_u32(const uint8_t* pData) {
+    uint32_t value;
+    memcpy(&value, pData, sizeof(value));
+    return value;
+}
+
+static uint32_t get_component_bytes(uint32_t componentType) {
+    switch (componentType) {
+        case COMPONENT_BYTE:
+        case COMPONENT_UNSIGNED_BYTE: return 1;
+        case COMPONENT_SHORT:
+        case COMPONENT_UNSIGNED_SHORT: return 2;
+        case COMPONENT_UNSIGNED_INT:
+        case COMPONENT_FLOAT: return 4;
+    }
+    return 0;
+}
+
+static uint32_t get_component_count(const std::string& type) {
+    const char* names[] = { "SCALAR", "VEC2", "VEC3", "VEC4", "MAT2", "MAT3", "MAT4" };
+    const uint32_t counts[] = { 1, 2, 3, 4, 4, 9, 16 };
+    for (uint32_t i = 0; i < 7; i++) {
+        if (type == names[i]) {
+            return counts[i];
+        }
+    }
+    return 0;
+}
+
+// Sizes and offsets in the document, negative values read as 0
+static uint64_t get_size(const JsonValue& value) {
+    return static_cast<uint64_t>(std::max(value.as_number(0.0), 0.0));
+}
+
+static std::string decode_uri(const std::string& uri) {
+    std::string decoded;
+    for (size_t i = 0; i < uri.size(); i++) {
+        if (uri[i] == '%' && i + 2 < uri.size()) {
+            decoded += static_cast<char>(std::stoi(uri.substr(i + 1, 2), nullptr, 16));
+            i += 2;
+        }
+        else {
+            decoded += uri[i];
+        }
+    }
+    return decoded;
+}
+
+static std::vector<uint8_t> decode_base64(const std::string& text, size_t start) {
+    std::vector<uint8_t> bytes;
+    bytes.reserve((text.size() - start) * 3 / 4);
+    uint32_t bits = 0;
+    uint32_t bitCount = 0;
+    for (size_t i = start; i < text.size(); i++) {
+        const char c = text[i];
+        uint32_t value;
+        if (c >= 'A' && c <= 'Z') {
+            value = c - 'A';
+        }
+        else if (c >= 'a' && c <= 'z') {
+            value = c - 'a' + 26;
+        }
+        else if (c >= '0' && c <= '9') {
+            value = c - '0' + 52;
+        }
+        else if (c == '+') {
+            value = 62;
+        }
+        else if (c == '/') {
+            value = 63;
+        }
+        else {
+            break;
+        }
+        bits = (bits << 6) | value;
+        bitCount += 6;
+        if (bitCount >= 8) {
+            bitCount -= 8;
+            bytes.push_back(static_cast<uint8_t>(bits >> bitCount));
+        }
+    }
+    return bytes;
+}
+
+GltfImporter::GltfImporter() {
+}
+
+GltfImporter::~GltfImporter() {
+    close();
+}
+
+//------------------------------------------------------------------------------------------
+// A .glb holds the document and the first buffer as chunks of one file, a .gltf is the
+// document itself
+//------------------------------------------------------------------------------------------
+void GltfImporter::open(const std::string& path) {
+    close();
+    mPath = path;
+    mDirectory = std::filesystem::path(path).parent_path().string();
+    if (!mDirectory.empty()) {
+        mDirectory += '/';
+    }
+    mFile.open(path);
+
+    const uint8_t* pData = mFile.get_data();
+    const uint64_t fileBytes = mFile.get_size();
+    const uint8_t* pJson = pData;
+    uint64_t jsonBytes = fileBytes;
+    const uint8_t* pBinaryChunk = nullptr;
+    uint64_t binaryChunkBytes = 0;
+
+    if (fileBytes >= 12 && read_u32(pData) == GLB_MAGIC) {
+        if (read_u32(pData + 4) != 2) {
+            fail("only version 2 binaries are supported");
+        }
+        const uint64_t length = std::min<uint64_t>(read_u32(pData + 8), fileBytes);
+        pJson = nullptr;
+        for (uint64_t offset = 12; offset + 8 <= length;) {
+            const uint64_t chunkBytes = read_u32(pData + offset);
+            const uint32_t chunkType = read_u32(pData + offset + 4);
+            if (offset + 8 + chunkBytes > length) {
+                fail("a chunk is truncated");
+            }
+            if (chunkType == GLB_CHUNK_JSON && !pJson) {
+                pJson = pData + offset + 8;
+                jsonBytes = chunkBytes;
+            }
+            else if (chunkType == GLB_CHUNK_BIN && !pBinaryChunk) {
+                pBinaryChunk = pData + offset + 8;
+                binaryChunkBytes = chunkBytes;
+            }
+            offset += 8 + chunkBytes;
+        }
+        if (!pJson) {
+            fail("the binary has no JSON chunk");
+        }
+    }
+
+    try {
+        mDocument = JsonValue::parse(reinterpret_cast<const char*>(pJson), jsonBytes);
+    }
+    catch (const std::exception& e) {
+        throw std::runtime_error(mPath + ": " + e.what());
+    }
+    mDocumentHash = hash_bytes(pJson, jsonBytes, VERSION);
+
+    if (mDocument["asset"]["version"].as_string().compare(0, 2, "2.") != 0) {
+        fail("only glTF 2.0 is supported");
+    }
+    const JsonValue& extensionsRequired = mDocument["extensionsRequired"];
+    if (extensionsRequired.size() > 0) {
+        fail("it requires the extension " + extensionsRequired[0].as_string());
+    }
+
+    load_buffers(pBinaryChunk, binaryChunkBytes);
+
+    const JsonValue& meshes = mDocument["meshes"];
+    for (uint32_t i = 0; i < meshes.size(); i++) {
+        const JsonValue& primitives = meshes[i]["primitives"];
+        for (uint32_t j = 0; j < primitives.size(); j++) {
+            const uint32_t mode = primitives[j]["mode"].as_uint(MODE_TRIANGLES);
+            const bool triangles = mode == MODE_TRIANGLES || mode == MODE_TRIANGLE_STRIP || mode == MODE_TRIANGLE_FAN;
+            if (triangles && primitives[j]["attributes"].has("POSITION")) {
+                mPrimitives.push_back({ i, j });
+            }
+        }
+    }
+}
+
+//------------------------------------------------------------------------------------------
+//------------------------------------------------------------------------------------------
+void GltfImporter::close() {
+    mDocument = JsonValue();
+    mDocumentHash = 0;
+    mFile.close();
+    mBufferFiles.clear();
+    mDecodedBuffers.clear();
+    mBuffers.clear();
+    mBufferBytes.clear();
+    mPrimitives.clear();
+}
+
+//------------------------------------------------------------------------------------------
+//------------------------------------------------------------------------------------------
+std::vector<std::string> GltfImporter::get_buffer_paths() const {
+    std::vector<std::string> paths;
+    for (const std::unique_ptr<MappedFile>& pBufferFile : mBufferFiles) {
+        paths.push_back(pBufferFile->get_path());
+    }
+    return paths;
+}
+
+//------------------------------------------------------------------------------------------
+//------------------------------------------------------------------------------------------
+uint64_t GltfImporter::hash_primitive(uint32_t index) const {
+    const JsonValue& primitive = mDocument["meshes"][mPrimitives[index].mesh]["primitives"][mPrimitives[index].primitive];
+    const JsonValue& attributes = primitive["attributes"];
+
+    uint64_t hash = hash_combine(VERSION, primitive["mode"].as_uint(MODE_TRIANGLES));
+    hash = hash_accessor(attributes["POSITION"].as_uint(INVALID_INDEX), hash);
+    if (attributes.has("NORMAL")) {
+        hash = hash_accessor(attributes["NORMAL"].as_uint(INVALID_INDEX), hash);
+    }
+    if (primitive.has("indices")) {
+        hash = hash_accessor(primitive["indices"].as_uint(INVALID_INDEX), hash);
+    }
+    return hash;
+}
+
+//------------------------------------------------------------------------------------------
+// Without normals every triangle gets its own vertices with the face normal, the flat
+// shading glTF asks for
+//------------------------------------------------------------------------------------------
+MeshData GltfImporter::import_primitive(uint32_t index) const {
+    const JsonValue& primitive = mDocument["meshes"][mPrimitives[index].mesh]["primitives"][mPrimitives[index].primitive];
+    const JsonValue& attributes = primitive["attributes"];
+
+    const Accessor positionAccessor = get_accessor(attributes["POSITION"].as_uint(INVALID_INDEX));
+    if (positionAccessor.componentCount != 3) {
+        fail("positions must be three component vectors");
+    }
+    const std::vector<float> positions = read_floats(positionAccessor);
+    const uint32_t vertexCount = positionAccessor.count;
+
+    std::vector<float> normals;
+    if (attributes.has("NORMAL")) {
+        const Accessor normalAccessor = get_accessor(attributes["NORMAL"].as_uint(INVALID_INDEX));
+        if (normalAccessor.componentCount != 3 || normalAccessor.count != vertexCount) {
+            fail("normals must be three component vectors, one per position");
+        }
+        normals = read_floats(normalAccessor);
+    }
+
+    std::vector<uint32_t> elements;
+    if (primitive.has("indices")) {
+        elements = read_indices(get_accessor(primitive["indices"].as_uint(INVALID_INDEX)));
+    }
+    else {
+        elements.resize(vertexCount);
+        for (uint32_t i = 0; i < vertexCount; i++) {
+            elements[i] = i;
+        }
+    }
+    for (uint32_t element : elements) {
+        if (element >= vertexCount) {
+            fail("an index is out of range");
+        }
+    }
+
+    std::vector<uint32_t> triangles;
+    const uint32_t mode = primitive["mode"].as_uint(MODE_TRIANGLES);
+    if (mode == MODE_TRIANGLES) {
+        triangles = std::move(elements);
+        triangles.resize(triangles.size() - triangles.size() % 3);
+    }
+    else {
+        for (size_t i = 2; i < elements.size(); i++) {
+            if (mode == MODE_TRIANGLE_FAN) {
+                triangles.insert(triangles.end(), { elements[i - 1], elements[i], elements[0] });
+            }
+            else if (i % 2 == 0) {
+                triangles.insert(triangles.end(), { elements[i - 2], elements[i - 1], elements[i] });
+            }
+            else {
+                triangles.insert(triangles.end(), { elements[i - 1], elements[i - 2], elements[i] });
+            }
+        }
+    }
+
+    MeshData mesh;
+    if (!normals.empty()) {
+        mesh.vertices.resize(vertexCount);
+        for (uint32_t i = 0; i < vertexCount; i++) {
+            mesh.vertices[i].position = glm::vec3(positions[3 * i], positions[3 * i + 1], positions[3 * i + 2]);
+            mesh.vertices[i].normal = glm::vec3(normals[3 * i], normals[3 * i + 1], normals[3 * i + 2]);
+        }
+        mesh.indices = std::move(triangles);
+        return mesh;
+    }
+
+    mesh.vertices.resize(triangles.size());
+    mesh.indices.resize(triangles.size());
+    for (size_t i = 0; i < triangles.size(); i += 3) {
+        glm::vec3 corners[3];
+        for (size_t j = 0; j < 3; j++) {
+            const uint32_t vertex = triangles[i + j];
+            corners[j] = glm::vec3(positions[3 * vertex], positions[3 * vertex + 1], positions[3 * vertex + 2]);
+        }
+        const glm::vec3 cross = glm::cross(corners[1] - corners[0], corners[2] - corners[0]);
+        const glm::vec3 normal = glm::dot(cross, cross) > 0.0f ? glm::normalize(cross) : glm::vec3(0.0f);
+        for (size_t j = 0; j < 3; j++) {
+            mesh.vertices[i + j].position = corners[j];
+            mesh.vertices[i + j].normal = normal;
+            mesh.indices[i + j] = static_cast<uint32_t>(i + j);
+        }
+    }
+    return mesh;
+}
+
+//------------------------------------------------------------------------------------------
+//------------------------------------------------------------------------------------------
+uint64_t GltfImporter::hash_scene() const {
+    uint64_t hash = mDocumentHash;
+
+    const JsonValue& skins = mDocument["skins"];
+    for (uint32_t i = 0; i < skins.size(); i++) {
+        if (skins[i].has("inverseBindMatrices")) {
+            hash = hash_accessor(skins[i]["inverseBindMatrices"].as_uint(INVALID_INDEX), hash);
+        }
+    }
+
+    const JsonValue& animations = mDocument["animations"];
+    for (uint32_t i = 0; i < animations.size(); i++) {
+        const JsonValue& samplers = animations[i]["samplers"];
+        for (uint32_t j = 0; j < samplers.size(); j++) {
+            hash = hash_accessor(samplers[j]["input"].as_uint(INVALID_INDEX), hash);
+            hash = hash_accessor(samplers[j]["output"].as_uint(INVALID_INDEX), hash);
+        }
+    }
+    return hash;
+}
+
+//------------------------------------------------------------------------------------------
+// Meshes, materials and skins keep their glTF indices. Nodes are renumbered breadth first
+// from the default scene's roots, nodes outside of it are dropped along with the animation
+// channels targeting them.
+//------------------------------------------------------------------------------------------
+SceneData GltfImporter::import_scene(const std::vector<std::string>& meshFiles) const {
+    SceneData scene;
+    scene.add_string("");
+
+    const JsonValue& nodes = mDocument["nodes"];
+    const uint32_t nodeCount = static_cast<uint32_t>(nodes.size());
+    std::vector<uint32_t> nodeMap(nodeCount, INVALID_INDEX);
+    std::vector<uint32_t> parents(nodeCount, INVALID_INDEX);
+    std::vector<uint32_t> queue;
+
+    const JsonValue& defaultScene = mDocument["scenes"][mDocument["scene"].as_uint(0)];
+    if (defaultScene.is_object()) {
+        for (uint32_t i = 0; i < defaultScene["nodes"].size(); i++) {
+            queue.push_back(defaultScene["nodes"][i].as_uint(INVALID_INDEX));
+        }
+    }
+    else {
+        std::vector<bool> isChild(nodeCount, false);
+        for (uint32_t i = 0; i < nodeCount; i++) {
+            for (uint32_t j = 0; j < nodes[i]["children"].size(); j++) {
+                const uint32_t child = nodes[i]["children"][j].as_uint(INVALID_INDEX);
+                if (child < nodeCount) {
+                    isChild[child] = true;
+                }
+            }
+        }
+        for (uint32_t i = 0; i < nodeCount; i++) {
+            if (!isChild[i]) {
+                queue.push_back(i);
+            }
+        }
+    }
+
+    for (size_t head = 0; head < queue.size(); head++) {
+        const uint32_t index = queue[head];
+        if (index >= nodeCount) {
+            fail("a node index is out of range");
+        }
+        if (nodeMap[index] != INVALID_INDEX) {
+            fail("node " + std::to_string(index) + " appears in the hierarchy twice");
+        }
+        nodeMap[index] = static_cast<uint32_t>(scene.nodes.size());
+
+        const JsonValue& source = nodes[index];
+        SceneFileNode node;
+        node.parent = parents[index];
+        node.mesh = source["mesh"].as_uint(INVALID_INDEX);
+        node.skin = source["skin"].as_uint(INVALID_INDEX);
+        node.name = scene.add_string(source["name"].as_string());
+        if (node.mesh != INVALID_INDEX && node.mesh >= mDocument["meshes"].size()) {
+            fail("node " + std::to_string(index) + " has no valid mesh");
+        }
+        if (node.skin != INVALID_INDEX && node.skin >= mDocument["skins"].size()) {
+            fail("node " + std::to_string(index) + " has no valid skin");
+        }
+
+        const JsonValue& matrix = source["matrix"];
+        if (matrix.size() == 16) {
+            glm::mat4 transform;
+            for (uint32_t i = 0; i < 16; i++) {
+                transform[i / 4][i % 4] = matrix[i].as_float(0.0f);
+            }
+            glm::vec3 scale(glm::length(glm::vec3(transform[0])), glm::length(glm::vec3(transform[1])),
+                            glm::length(glm::vec3(transform[2])));
+            if (glm::determinant(glm::mat3(transform)) < 0.0f) {
+                scale.x = -scale.x;
+            }
+            glm::mat3 rotation(glm::vec3(transform[0]) / scale.x, glm::vec3(transform[1]) / scale.y,
+                               glm::vec3(transform[2]) / scale.z);
+            const glm::quat quaternion = glm::quat_cast(rotation);
+            node.translation = glm::vec4(glm::vec3(transform[3]), 0.0f);
+            node.rotation = glm::vec4(quaternion.x, quaternion.y, quaternion.z, quaternion.w);
+            node.scale = glm::vec4(scale, 0.0f);
+        }
+        else {
+            const JsonValue& translation = source["translation"];
+            const JsonValue& rotation = source["rotation"];
+            const JsonValue& scale = source["scale"];
+            node.translation = glm::vec4(translation[0].as_float(0.0f), translation[1].as_float(0.0f), translation[2].as_float(0.0f), 0.0f);
+            node.rotation = glm::vec4(rotation[0].as_float(0.0f), rotation[1].as_float(0.0f), rotation[2].as_float(0.0f), rotation[3].as_float(1.0f));
+            node.scale = glm::vec4(scale[0].as_float(1.0f), scale[1].as_float(1.0f), scale[2].as_float(1.0f), 0.0f);
+        }
+        scene.nodes.push_back(node);
+
+        const JsonValue& children = source["children"];
+        for (uint32_t i = 0; i < children.size(); i++) {
+            const uint32_t child = children[i].as_uint(INVALID_INDEX);
+            if (child >= nodeCount) {
+                fail("a node index is out of range");
+            }
+            parents[child] = nodeMap[index];
+            queue.push_back(child);
+        }
+    }
+
+    const JsonValue& materials = mDocument["materials"];
+    for (uint32_t i = 0; i < materials.size(); i++) {
+        const JsonValue& source = materials[i];
+        const JsonValue& pbr = source["pbrMetallicRoughness"];
+        const JsonValue& baseColor = pbr["baseColorFactor"];
+        const JsonValue& emissive = source["emissiveFactor"];
+        const std::string& alphaMode = source["alphaMode"].as_string();
+
+        SceneFileMaterial material;
+        material.baseColorFactor = glm::vec4(baseColor[0].as_float(1.0f), baseColor[1].as_float(1.0f),
+                                             baseColor[2].as_float(1.0f), baseColor[3].as_float(1.0f));
+        material.emissiveFactor = glm::vec4(emissive[0].as_float(0.0f), emissive[1].as_float(0.0f), emissive[2].as_float(0.0f), 0.0f);
+        material.metallicFactor = pbr["metallicFactor"].as_float(1.0f);
+        material.roughnessFactor = pbr["roughnessFactor"].as_float(1.0f);
+        material.alphaCutoff = source["alphaCutoff"].as_float(0.5f);
+        material.alphaMode = alphaMode == "MASK" ? ALPHA_MODE_MASK : alphaMode == "BLEND" ? ALPHA_MODE_BLEND : ALPHA_MODE_OPAQUE;
+        material.doubleSided = source["doubleSided"].as_bool(false) ? 1 : 0;
+        material.baseColorTexture = add_texture(scene, pbr["baseColorTexture"]);
+        material.metallicRoughnessTexture = add_texture(scene, pbr["metallicRoughnessTexture"]);
+        material.normalTexture = add_texture(scene, source["normalTexture"]);
+        material.occlusionTexture = add_texture(scene, source["occlusionTexture"]);
+        material.emissiveTexture = add_texture(scene, source["emissiveTexture"]);
+        material.name = scene.add_string(source["name"].as_string());
+        material.padding = 0;
+        scene.materials.push_back(material);
+    }
+
+    // The primitives are in mesh order, so each mesh's are consecutive
+    const JsonValue& meshes = mDocument["meshes"];
+    size_t nextPrimitive = 0;
+    for (uint32_t i = 0; i < meshes.size(); i++) {
+        SceneFileMesh mesh;
+        mesh.firstPrimitive = static_cast<uint32_t>(scene.primitives.size());
+        mesh.name = scene.add_string(meshes[i]["name"].as_string());
+        mesh.padding = 0;
+        for (; nextPrimitive < mPrimitives.size() && mPrimitives[nextPrimitive].mesh == i; nextPrimitive++) {
+            const Primitive& source = mPrimitives[nextPrimitive];
+            SceneFilePrimitive primitive = {};
+            primitive.material = meshes[i]["primitives"][source.primitive]["material"].as_uint(INVALID_INDEX);
+            if (primitive.material != INVALID_INDEX && primitive.material >= scene.materials.size()) {
+                fail("a primitive has no valid material");
+            }
+            primitive.meshFile = scene.add_string(meshFiles[nextPrimitive]);
+            scene.primitives.push_back(primitive);
+        }
+        mesh.primitiveCount = static_cast<uint32_t>(scene.primitives.size()) - mesh.firstPrimitive;
+        scene.meshes.push_back(mesh);
+    }
+
+    const JsonValue& skins = mDocument["skins"];
+    for (uint32_t i = 0; i < skins.size(); i++) {
+        const JsonValue& source = skins[i];
+        const JsonValue& joints = source["joints"];
+
+        SceneFileSkin skin = {};
+        skin.firstJoint = static_cast<uint32_t>(scene.joints.size());
+        skin.jointCount = static_cast<uint32_t>(joints.size());
+        for (uint32_t j = 0; j < joints.size(); j++) {
+            const uint32_t joint = joints[j].as_uint(INVALID_INDEX);
+            if (joint >= nodeCount || nodeMap[joint] == INVALID_INDEX) {
+                fail("skin " + std::to_string(i) + " has a joint outside of the scene");
+            }
+            scene.joints.push_back(nodeMap[joint]);
+        }
+
+        skin.inverseBindMatrices = INVALID_INDEX;
+        if (source.has("inverseBindMatrices")) {
+            const Accessor accessor = get_accessor(source["inverseBindMatrices"].as_uint(INVALID_INDEX));
+            if (accessor.componentCount != 16 || accessor.count < skin.jointCount) {
+                fail("skin " + std::to_string(i) + " needs a matrix per joint");
+            }
+            const std::vector<float> matrices = read_floats(accessor);
+            skin.inverseBindMatrices = scene.add_floats(matrices.data(), 16 * skin.jointCount);
+        }
+
+        const uint32_t skeleton = source["skeleton"].as_uint(INVALID_INDEX);
+        skin.skeleton = skeleton < nodeCount ? nodeMap[skeleton] : INVALID_INDEX;
+        skin.name = scene.add_string(source["name"].as_string());
+        scene.skins.push_back(skin);
+    }
+
+    const JsonValue& animations = mDocument["animations"];
+    for (uint32_t i = 0; i < animations.size(); i++) {
+        const JsonValue& source = animations[i];
+        const JsonValue& channels = source["channels"];
+        const JsonValue& samplers = source["samplers"];
+
+        SceneFileAnimation animation;
+        animation.firstChannel = static_cast<uint32_t>(scene.channels.size());
+        animation.duration = 0.0f;
+        animation.name = scene.add_string(source["name"].as_string());
+
+        for (uint32_t j = 0; j < channels.size(); j++) {
+            const JsonValue& target = channels[j]["target"];
+            const uint32_t node = target["node"].as_uint(INVALID_INDEX);
+            if (node >= nodeCount || nodeMap[node] == INVALID_INDEX) {
+                continue;
+            }
+
+            const std::string& path = target["path"].as_string();
+            const JsonValue& sampler = samplers[channels[j]["sampler"].as_uint(INVALID_INDEX)];
+            const std::string& interpolation = sampler["interpolation"].as_string();
+
+            SceneFileChannel channel = {};
+            channel.node = nodeMap[node];
+            channel.path = path == "rotation" ? ANIMATION_PATH_ROTATION : path == "scale" ? ANIMATION_PATH_SCALE :
+                           path == "weights" ? ANIMATION_PATH_WEIGHTS : ANIMATION_PATH_TRANSLATION;
+            channel.interpolation = interpolation == "STEP" ? ANIMATION_INTERPOLATION_STEP :
+                                    interpolation == "CUBICSPLINE" ? ANIMATION_INTERPOLATION_CUBIC_SPLINE :
+                                    ANIMATION_INTERPOLATION_LINEAR;
+            if (path != "translation" && path != "rotation" && path != "scale" && path != "weights") {
+                fail("animation " + std::to_string(i) + " targets the unknown path " + path);
+            }
+
+            const Accessor input = get_accessor(sampler["input"].as_uint(INVALID_INDEX));
+            const Accessor output = get_accessor(sampler["output"].as_uint(INVALID_INDEX));
+            const uint32_t valuesPerKey = channel.interpolation == ANIMATION_INTERPOLATION_CUBIC_SPLINE ? 3 : 1;
+            if (input.componentCount != 1 || input.count == 0) {
+                fail("animation " + std::to_string(i) + " has a sampler without times");
+            }
+            channel.keyCount = input.count;
+            // Weights are scalars, one per morph target each key
+            channel.componentCount = channel.path == ANIMATION_PATH_WEIGHTS
+                                         ? output.count / (valuesPerKey * channel.keyCount) : output.componentCount;
+            if (static_cast<uint64_t>(output.count) * output.componentCount !=
+                static_cast<uint64_t>(valuesPerKey) * channel.keyCount * channel.componentCount) {
+                fail("animation " + std::to_string(i) + " has a sampler with the wrong number of values");
+            }
+
+            const std::vector<float> times = read_floats(input);
+            const std::vector<float> values = read_floats(output);
+            channel.times = scene.add_floats(times.data(), times.size());
+            channel.values = scene.add_floats(values.data(), values.size());
+            animation.duration = std::max(animation.duration, times.back());
+            scene.channels.push_back(channel);
+        }
+
+        animation.channelCount = static_cast<uint32_t>(scene.channels.size()) - animation.firstChannel;
+        scene.animations.push_back(animation);
+    }
+
+    return scene;
+}
+
+//------------------------------------------------------------------------------------------
+// Buffers without a URI are the .glb's binary chunk, data URIs are decoded up front and
+// files are mapped
+//------------------------------------------------------------------------------------------
+void GltfImporter::load_buffers(const uint8_t* pBinaryChunk, uint64_t binaryChunkBytes) {
+    const JsonValue& buffers = mDocument["buffers"];
+    for (uint32_t i = 0; i < buffers.size(); i++) {
+        const std::string& uri = buffers[i]["uri"].as_string();
+        const uint64_t bytes = get_size(buffers[i]["byteLength"]);
+
+        const uint8_t* pData = nullptr;
+        uint64_t availableBytes = 0;
+        if (uri.empty()) {
+            if (i != 0 || !pBinaryChunk) {
+                fail("buffer " + std::to_string(i) + " has no data");
+            }
+            pData = pBinaryChunk;
+            availableBytes = binaryChunkBytes;
+        }
+        else if (uri.compare(0, 5, "data:") == 0) {
+            const size_t comma = uri.find(',');
+            if (comma == std::string::npos || uri.rfind(";base64", comma) == std::string::npos) {
+                fail("buffer " + std::to_string(i) + " isn't base64 encoded");
+            }
+            mDecodedBuffers.push_back(decode_base64(uri, comma + 1));
+            pData = mDecodedBuffers.back().data();
+            availableBytes = mDecodedBuffers.back().size();
+        }
+        else {
+            mBufferFiles.push_back(std::make_unique<MappedFile>());
+            mBufferFiles.back()->open(mDirectory + decode_uri(uri));
+            pData = mBufferFiles.back()->get_data();
+            availableBytes = mBufferFiles.back()->get_size();
+        }
+
+        if (availableBytes < bytes) {
+            fail("buffer " + std::to_string(i) + " is shorter than its byteLength");
+        }
+        mBuffers.push_back(pData);
+        mBufferBytes.push_back(bytes);
+    }
+}
+
+//------------------------------------------------------------------------------------------
+// Every element has to lie within the buffer view and the view within its buffer
+//------------------------------------------------------------------------------------------
+GltfImporter::Accessor GltfImporter::get_accessor(uint32_t index) const {
+    const JsonValue& source = mDocument["accessors"][index];
+    if (!source.is_object()) {
+        fail("accessor " + std::to_string(index) + " doesn't exist");
+    }
+    if (source.has("sparse")) {
+        fail("sparse accessors aren't supported");
+    }
+
+    Accessor accessor;
+    accessor.pData = nullptr;
+    accessor.count = source["count"].as_uint(0);
+    accessor.componentType = source["componentType"].as_uint(0);
+    accessor.componentCount = get_component_count(source["type"].as_string());
+    accessor.elementBytes = accessor.componentCount * get_component_bytes(accessor.componentType);
+    accessor.stride = accessor.elementBytes;
+    accessor.normalized = source["normalized"].as_bool(false);
+    if (accessor.elementBytes == 0) {
+        fail("accessor " + std::to_string(index) + " has an unknown type");
+    }
+    if (!source.has("bufferView")) {
+        return accessor;
+    }
+
+    const JsonValue& view = mDocument["bufferViews"][source["bufferView"].as_uint(INVALID_INDEX)];
+    const uint32_t buffer = view["buffer"].as_uint(INVALID_INDEX);
+    if (!view.is_object() || buffer >= mBuffers.size()) {
+        fail("accessor " + std::to_string(index) + " has no valid buffer view");
+    }
+
+    const uint64_t viewOffset = get_size(view["byteOffset"]);
+    const uint64_t viewBytes = get_size(view["byteLength"]);
+    const uint64_t offset = get_size(source["byteOffset"]);
+    accessor.stride = view["byteStride"].as_uint(accessor.elementBytes);
+    if (accessor.stride < accessor.elementBytes || viewOffset + viewBytes > mBufferBytes[buffer] ||
+        (accessor.count > 0 && offset + static_cast<uint64_t>(accessor.count - 1) * accessor.stride + accessor.elementBytes > viewBytes)) {
+        fail("accessor " + std::to_string(index) + " is out of bounds");
+    }
+
+    accessor.pData = mBuffers[buffer] + viewOffset + offset;
+    return accessor;
+}
+
+//------------------------------------------------------------------------------------------
+// Interleaved attributes hash the whole strided range, so a change to any attribute of the
+// vertices counts. That recooks more than needed but never less.
+//------------------------------------------------------------------------------------------
+uint64_t GltfImporter::hash_accessor(uint32_t index, uint64_t hash) const {
+    const Accessor accessor = get_accessor(index);
+    hash = hash_combine(hash, (static_cast<uint64_t>(accessor.componentType) << 32) | accessor.count);
+    hash = hash_combine(hash, (static_cast<uint64_t>(accessor.componentCount) << 32) | (accessor.stride << 1) | accessor.normalized);
+    if (accessor.pData && accessor.count > 0) {
+        const uint64_t bytes = static_cast<uint64_t>(accessor.count - 1) * accessor.stride + accessor.elementBytes;
+        hash = hash_bytes(accessor.pData, bytes, hash);
+    }
+    return hash;
+}
+
+//------------------------------------------------------------------------------------------
+//------------------------------------------------------------------------------------------
+std::vector<float> GltfImporter::read_floats(const Accessor& accessor) const {
+    std::vector<float> values(static_cast<size_t>(accessor.count) * accessor.componentCount, 0.0f);
+    if (!accessor.pData) {
+        return values;
+    }
+
+    const uint32_t componentBytes = get_component_bytes(accessor.componentType);
+    for (uint32_t i = 0; i < accessor.count; i++) {
+        const uint8_t* pElement = accessor.pData + static_cast<size_t>(i) * accessor.stride;
+        float* pValues = values.data() + static_cast<size_t>(i) * accessor.componentCount;
+        for (uint32_t j = 0; j < accessor.componentCount; j++) {
+            const uint8_t* pComponent = pElement + j * componentBytes;
+            float value = 0.0f;
+            float scale = 1.0f;
+            switch (accessor.componentType) {
+                case COMPONENT_FLOAT: memcpy(&value, pComponent, 4); break;
+                case COMPONENT_BYTE: value = static_cast<int8_t>(*pComponent); scale = 127.0f; break;
+                case COMPONENT_UNSIGNED_BYTE: value = *pComponent; scale = 255.0f; break;
+                case COMPONENT_SHORT: { int16_t v; memcpy(&v, pComponent, 2); value = v; scale = 32767.0f; break; }
+                case COMPONENT_UNSIGNED_SHORT: { uint16_t v; memcpy(&v, pComponent, 2); value = v; scale = 65535.0f; break; }
+                case COMPONENT_UNSIGNED_INT: { uint32_t v; memcpy(&v, pComponent, 4); value = static_cast<float>(v); break; }
+            }
+            pValues[j] = accessor.normalized ? std::max(value / scale, -1.0f) : value;
+        }
+    }
+    return values;
+}
+
+//------------------------------------------------------------------------------------------
+//------------------------------------------------------------------------------------------
+std::vector<uint32_t> GltfImporter::read_indices(const Accessor& accessor) const {
+    if (accessor.componentCount != 1 || accessor.componentType == COMPONENT_FLOAT ||
+        accessor.componentType == COMPONENT_BYTE || accessor.componentType == COMPONENT_SHORT) {
+        fail("indices must be unsigned integer scalars");
+    }
+
+    std::vector<uint32_t> indices(accessor.count, 0);
+    if (!accessor.pData) {
+        return indices;
+    }
+    for (uint32_t i = 0; i < accessor.count; i++) {
+        const uint8_t* pElement = accessor.pData + static_cast<size_t>(i) * accessor.stride;
+        if (accessor.componentType == COMPONENT_UNSIGNED_BYTE) {
+            indices[i] = *pElement;
+        }
+        else if (accessor.componentType == COMPONENT_UNSIGNED_SHORT) {
+            uint16_t index;
+            memcpy(&index, pElement, 2);
+            indices[i] = index;
+        }
+        else {
+            memcpy(&indices[i], pElement, 4);
+        }
+    }
+    return indices;
+}
+
+//------------------------------------------------------------------------------------------
+// Images embedded in buffers or data URIs have no path to refer to and are left out
+//------------------------------------------------------------------------------------------
+uint32_t GltfImporter::add_texture(SceneData& scene, const JsonValue& textureInfo) const {
+    if (!textureInfo.is_object()) {
+        return INVALID_INDEX;
+    }
+    const JsonValue& texture = mDocument["textures"][textureInfo["index"].as_uint(INVALID_INDEX)];
+    const JsonValue& image = mDocument["images"][texture["source"].as_uint(INVALID_INDEX)];
+    const std::string& uri = image["uri"].as_string();
+    if (uri.empty() || uri.compare(0, 5, "data:") == 0) {
+        return INVALID_INDEX;
+    }
+    return scene.add_string(mDirectory + decode_uri(uri));
+}
+
+//------------------------------------------------------------------------------------------
+//------------------------------------------------------------------------------------------
+void GltfImporter::fail(const std::string& reason) const {
+    throw std::runtime_error("Failed to import " + mPath + ", " + reason + "!");
+}
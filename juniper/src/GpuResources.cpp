@@ -0,0 +1,208 @@
+//======================================================================
+// GpuResources.cpp
+//
+// Keegan Kochis
+// Created: 2026/10/18
+// The definition of the GpuResources class.
+//======================================================================
+
+#include "GpuResources.h"
+
+#include <cstdint>
+
+#include <stdexcept>
+
+#define GLFW_INCLUDE_VULKAN
+#include <GLFW/glfw3.h>
+
+GpuResources::GpuResources() {}
+
+//------------------------------------------------------------------------------------------
+//------------------------------------------------------------------------------------------
+void GpuResources::init(VkPhysicalDevice physicalDevice, VkDevice device, DeletionQueue* pDeletionQueue) {
+    mPhysicalDevice = physicalDevice;
+    mDevice = device;
+    mpDeletionQueue = pDeletionQueue;
+    vkGetPhysicalDeviceMemoryProperties(mPhysicalDevice, &mMemoryProperties);
+}
+
+//------------------------------------------------------------------------------------------
+// Destroy from the back so the swap-remove never has to move anything
+//------------------------------------------------------------------------------------------
+void GpuResources::clean_up() {
+    while (!mBuffers.empty()) {
+        destroy_buffer(mBuffers.handle_at(mBuffers.size() - 1));
+    }
+    while (!mImages.empty()) {
+        destroy_image(mImages.handle_at(mImages.size() - 1));
+    }
+    while (!mSamplers.empty()) {
+        destroy_sampler(mSamplers.handle_at(mSamplers.size() - 1));
+    }
+    while (!mPipelines.empty()) {
+        destroy_pipeline(mPipelines.handle_at(mPipelines.size() - 1));
+    }
+}
+
+//------------------------------------------------------------------------------------------
+// One allocation per buffer for now
+//------------------------------------------------------------------------------------------
+BufferHandle GpuResources::create_buffer(VkDeviceSize size, VkBufferUsageFlags usage, VkMemoryPropertyFlags properties) {
+    VkBufferCreateInfo createInfo{};
+    createInfo.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
+    createInfo.size = size;
+    createInfo.usage = usage;
+    createInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+
+    VkBuffer buffer;
+    if (vkCreateBuffer(mDevice, &createInfo, nullptr, &buffer) != VK_SUCCESS) {
+        throw std::runtime_error("Failed to create buffer!");
+    }
+
+    VkMemoryRequirements requirements;
+    vkGetBufferMemoryRequirements(mDevice, buffer, &requirements);
+    VkDeviceMemory memory = allocate_memory(requirements, properties);
+    vkBindBufferMemory(mDevice, buffer, memory, 0);
+
+    void* pMapped = nullptr;
+    if (properties & VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT) {
+        if (vkMapMemory(mDevice, memory, 0, size, 0, &pMapped) != VK_SUCCESS) {
+            throw std::runtime_error("Failed to map buffer memory!");
+        }
+    }
+
+    return add_buffer(buffer, memory, size, usage, pMapped);
+}
+
+//------------------------------------------------------------------------------------------
+//------------------------------------------------------------------------------------------
+ImageHandle GpuResources::create_image(VkExtent3D extent, VkFormat format, VkImageUsageFlags usage, VkImageAspectFlags aspect,
+                                       uint32_t mipLevels) {
+    VkImageCreateInfo createInfo{};
+    createInfo.sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
+    createInfo.imageType = extent.depth > 1 ? VK_IMAGE_TYPE_3D : VK_IMAGE_TYPE_2D;
+    createInfo.extent = extent;
+    createInfo.mipLevels = mipLevels;
+    createInfo.arrayLayers = 1;
+    createInfo.format = format;
+    createInfo.tiling = VK_IMAGE_TILING_OPTIMAL;
+    createInfo.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+    createInfo.usage = usage;
+    createInfo.samples = VK_SAMPLE_COUNT_1_BIT;
+    createInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+
+    VkImage image;
+    if (vkCreateImage(mDevice, &createInfo, nullptr, &image) != VK_SUCCESS) {
+        throw std::runtime_error("Failed to create image!");
+    }
+
+    VkMemoryRequirements requirements;
+    vkGetImageMemoryRequirements(mDevice, image, &requirements);
+    VkDeviceMemory memory = allocate_memory(requirements, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
+    vkBindImageMemory(mDevice, image, memory, 0);
+
+    VkImageViewCreateInfo viewCreateInfo{};
+    viewCreateInfo.sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO;
+    viewCreateInfo.image = image;
+    viewCreateInfo.viewType = extent.depth > 1 ? VK_IMAGE_VIEW_TYPE_3D : VK_IMAGE_VIEW_TYPE_2D;
+    viewCreateInfo.format = format;
+    viewCreateInfo.subresourceRange.aspectMask = aspect;
+    viewCreateInfo.subresourceRange.baseMipLevel = 0;
+    viewCreateInfo.subresourceRange.levelCount = mipLevels;
+    viewCreateInfo.subresourceRange.baseArrayLayer = 0;
+    viewCreateInfo.subresourceRange.layerCount = 1;
+
+    VkImageView view;
+    if (vkCreateImageView(mDevice, &viewCreateInfo, nullptr, &view) != VK_SUCCESS) {
+        throw std::runtime_error("Failed to create image view!");
+    }
+
+    return add_image(image, view, memory, format, extent, true);
+}
+
+//------------------------------------------------------------------------------------------
+//------------------------------------------------------------------------------------------
+BufferHandle GpuResources::add_buffer(VkBuffer buffer, VkDeviceMemory memory, VkDeviceSize size, VkBufferUsageFlags usage, void* pMapped) {
+    return mBuffers.add(buffer, memory, size, usage, pMapped);
+}
+
+//------------------------------------------------------------------------------------------
+//------------------------------------------------------------------------------------------
+ImageHandle GpuResources::add_image(VkImage image, VkImageView view, VkDeviceMemory memory, VkFormat format, VkExtent3D extent, bool owned) {
+    return mImages.add(image, view, memory, format, extent, owned ? 1 : 0);
+}
+
+//------------------------------------------------------------------------------------------
+//------------------------------------------------------------------------------------------
+SamplerHandle GpuResources::add_sampler(VkSampler sampler) {
+    return mSamplers.add(sampler);
+}
+
+//------------------------------------------------------------------------------------------
+//------------------------------------------------------------------------------------------
+PipelineHandle GpuResources::add_pipeline(VkPipeline pipeline, VkPipelineLayout layout, VkPipelineBindPoint bindPoint, bool ownsLayout) {
+    return mPipelines.add(pipeline, layout, bindPoint, ownsLayout ? 1 : 0);
+}
+
+//------------------------------------------------------------------------------------------
+//------------------------------------------------------------------------------------------
+void GpuResources::destroy_buffer(BufferHandle handle) {
+    mpDeletionQueue->enqueue(DeletionQueue::RESOURCE_BUFFER, mBuffers.get<BUFFER_BUFFER>(handle));
+    mpDeletionQueue->enqueue(DeletionQueue::RESOURCE_DEVICE_MEMORY, mBuffers.get<BUFFER_MEMORY>(handle));
+    mBuffers.remove(handle);
+}
+
+//------------------------------------------------------------------------------------------
+//------------------------------------------------------------------------------------------
+void GpuResources::destroy_image(ImageHandle handle) {
+    mpDeletionQueue->enqueue(DeletionQueue::RESOURCE_IMAGE_VIEW, mImages.get<IMAGE_VIEW>(handle));
+    if (mImages.get<IMAGE_OWNED>(handle)) {
+        mpDeletionQueue->enqueue(DeletionQueue::RESOURCE_IMAGE, mImages.get<IMAGE_IMAGE>(handle));
+        mpDeletionQueue->enqueue(DeletionQueue::RESOURCE_DEVICE_MEMORY, mImages.get<IMAGE_MEMORY>(handle));
+    }
+    mImages.remove(handle);
+}
+
+//------------------------------------------------------------------------------------------
+//------------------------------------------------------------------------------------------
+void GpuResources::destroy_sampler(SamplerHandle handle) {
+    mpDeletionQueue->enqueue(DeletionQueue::RESOURCE_SAMPLER, mSamplers.get<SAMPLER_SAMPLER>(handle));
+    mSamplers.remove(handle);
+}
+
+//------------------------------------------------------------------------------------------
+//------------------------------------------------------------------------------------------
+void GpuResources::destroy_pipeline(PipelineHandle handle) {
+    mpDeletionQueue->enqueue(DeletionQueue::RESOURCE_PIPELINE, mPipelines.get<PIPELINE_PIPELINE>(handle));
+    if (mPipelines.get<PIPELINE_OWNS_LAYOUT>(handle)) {
+        mpDeletionQueue->enqueue(DeletionQueue::RESOURCE_PIPELINE_LAYOUT, mPipelines.get<PIPELINE_LAYOUT>(handle));
+    }
+    mPipelines.remove(handle);
+}
+
+//------------------------------------------------------------------------------------------
+//------------------------------------------------------------------------------------------
+uint32_t GpuResources::find_memory_type(uint32_t typeFilter, VkMemoryPropertyFlags properties) {
+    for (uint32_t i = 0; i < mMemoryProperties.memoryTypeCount; i++) {
+        if ((typeFilter & (1 << i)) && (mMemoryProperties.memoryTypes[i].propertyFlags & properties) == properties) {
+            return i;
+        }
+    }
+
+    throw std::runtime_error("Failed to find suitable memory type!");
+}
+
+//------------------------------------------------------------------------------------------
+//------------------------------------------------------------------------------------------
+VkDeviceMemory GpuResources::allocate_memory(const VkMemoryRequirements& requirements, VkMemoryPropertyFlags properties) {
+    VkMemoryAllocateInfo allocateInfo{};
+    allocateInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
+    allocateInfo.allocationSize = requirements.size;
+    allocateInfo.memoryTypeIndex = find_memory_type(requirements.memoryTypeBits, properties);
+
+    VkDeviceMemory memory;
+    if (vkAllocateMemory(mDevice, &allocateInfo, nullptr, &memory) != VK_SUCCESS) {
+        throw std::runtime_error("Failed to allocate device memory!");
+    }
+    return memory;
+}
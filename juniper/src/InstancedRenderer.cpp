@@ -0,0 +1,883 @@
+//======================================================================
+// InstancedRenderer.cpp
+//
+// Keegan Kochis
+// Created: 2026/10/18
+// The definition of the InstancedRenderer class.
+//======================================================================
+
+#include "InstancedRenderer.h"
+#include "Shader.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+#include <algorithm>
+#include <chrono>
+#include <ostream>
+#include <stdexcept>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#define GLFW_INCLUDE_VULKAN
+#include <GLFW/glfw3.h>
+
+#define GLM_FORCE_RADIANS
+#define GLM_FORCE_DEPTH_ZERO_TO_ONE
+#include <glm/geometric.hpp>
+#include <glm/mat4x4.hpp>
+#include <glm/vec3.hpp>
+#include <glm/vec4.hpp>
+
+static const uint32_t INITIAL_OBJECT_CAPACITY = 1024;
+static const uint32_t INITIAL_BATCH_CAPACITY = 64;
+static const uint32_t INITIAL_VERTEX_BYTES = 1 << 20;
+static const uint32_t INITIAL_INDEX_BYTES = 1 << 20;
+// Must match local_size_x of the culling shaders
+static const uint32_t CULL_GROUP_SIZE = 64;
+
+static const VkMemoryPropertyFlags HOST_MEMORY = VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT;
+static const VkBufferUsageFlags GPU_WRITTEN_USAGE = VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT;
+
+// Offsets the culling shaders read, std430 for the buffers in scene_data.glsl and std140 for
+// CullUniforms in culling.glsl
+static_assert(sizeof(InstancedRenderer::ObjectData) == 80 && offsetof(InstancedRenderer::ObjectData, batchIndex) == 64,
+              "ObjectData no longer matches scene_data.glsl");
+static_assert(sizeof(InstancedRenderer::BatchData) == 64 && offsetof(InstancedRenderer::BatchData, lodCount) == 44 &&
+              offsetof(InstancedRenderer::BatchData, lodError) == 48, "BatchData no longer matches scene_data.glsl");
+static_assert(sizeof(InstancedRenderer::CullUniforms) == 208 &&
+              offsetof(InstancedRenderer::CullUniforms, pyramidSize) == 176 &&
+              offsetof(InstancedRenderer::CullUniforms, objectCount) == 184 &&
+              offsetof(InstancedRenderer::CullUniforms, lodProjectionScale) == 200 &&
+              offsetof(InstancedRenderer::CullUniforms, lodThreshold) == 204,
+              "CullUniforms no longer matches culling.glsl");
+static_assert(sizeof(InstancedRenderer::CullCounters) == 16 + 4 * InstancedRenderer::MAX_LOD_COUNT,
+              "CullCounters no longer matches culling.glsl");
+
+InstancedRenderer::InstancedRenderer() {}
+
+//------------------------------------------------------------------------------------------
+// Set 0 binding 0 holds the objects and binding 1 the visible instances, which map
+// gl_InstanceIndex to an object. The view projection goes in a push constant.
+//------------------------------------------------------------------------------------------
+void InstancedRenderer::init(VkDevice device, const DeviceFeatures::Capabilities& capabilities, uint32_t framesInFlight,
+                             GpuResources* pGpuResources, DescriptorAllocator* pDescriptorAllocator) {
+    mDevice = device;
+    mpGpuResources = pGpuResources;
+    mpDescriptorAllocator = pDescriptorAllocator;
+
+    // Without a non-zero firstInstance the batches can't share the visible instance buffer
+    mGpuDriven = capabilities.has_tier(DeviceFeatures::CAPABILITY_TIER_GPU_DRIVEN);
+    if (capabilities.has_tier(DeviceFeatures::CAPABILITY_TIER_INDIRECT_COUNT)) {
+        mCmdDrawIndexedIndirectCount = reinterpret_cast<PFN_vkCmdDrawIndexedIndirectCountKHR>(
+            vkGetDeviceProcAddr(mDevice, "vkCmdDrawIndexedIndirectCount"));
+        if (mCmdDrawIndexedIndirectCount == nullptr) {
+            mCmdDrawIndexedIndirectCount = reinterpret_cast<PFN_vkCmdDrawIndexedIndirectCountKHR>(
+                vkGetDeviceProcAddr(mDevice, "vkCmdDrawIndexedIndirectCountKHR"));
+        }
+        mUseDrawCount = mCmdDrawIndexedIndirectCount != nullptr;
+    }
+    mStats.gpuDriven = mGpuDriven;
+    mSimdLevel = get_simd_level();
+    mStats.simdLevel = mSimdLevel;
+
+    VkDescriptorSetLayoutBinding bindings[2]{};
+    for (uint32_t i = 0; i < 2; i++) {
+        bindings[i].binding = i;
+        bindings[i].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+        bindings[i].descriptorCount = 1;
+        bindings[i].stageFlags = VK_SHADER_STAGE_VERTEX_BIT;
+    }
+    mDescriptorSetLayout = mpDescriptorAllocator->get_layout({ bindings[0], bindings[1] });
+
+    VkPushConstantRange pushConstantRange{};
+    pushConstantRange.stageFlags = VK_SHADER_STAGE_VERTEX_BIT;
+    pushConstantRange.offset = 0;
+    pushConstantRange.size = sizeof(PushConstants);
+
+    VkPipelineLayoutCreateInfo layoutCreateInfo{};
+    layoutCreateInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
+    layoutCreateInfo.setLayoutCount = 1;
+    layoutCreateInfo.pSetLayouts = &mDescriptorSetLayout;
+    layoutCreateInfo.pushConstantRangeCount = 1;
+    layoutCreateInfo.pPushConstantRanges = &pushConstantRange;
+
+    if (vkCreatePipelineLayout(mDevice, &layoutCreateInfo, nullptr, &mPipelineLayout) != VK_SUCCESS) {
+        throw std::runtime_error("Failed to create instanced pipeline layout!");
+    }
+
+    if (mGpuDriven) {
+        create_culling_pipelines();
+    }
+
+    mVertexBuffer = mpGpuResources->create_buffer(INITIAL_VERTEX_BYTES, VK_BUFFER_USAGE_VERTEX_BUFFER_BIT, HOST_MEMORY);
+    mIndexBuffer = mpGpuResources->create_buffer(INITIAL_INDEX_BYTES, VK_BUFFER_USAGE_INDEX_BUFFER_BIT, HOST_MEMORY);
+
+    const VkDeviceSize objectBytes = INITIAL_OBJECT_CAPACITY * sizeof(ObjectData);
+    const VkDeviceSize instanceBytes = INITIAL_OBJECT_CAPACITY * sizeof(uint32_t);
+    const VkDeviceSize batchBytes = INITIAL_BATCH_CAPACITY * sizeof(BatchData);
+    const VkDeviceSize countBytes = INITIAL_BATCH_CAPACITY * sizeof(uint32_t);
+    const VkDeviceSize commandBytes = INITIAL_BATCH_CAPACITY * sizeof(VkDrawIndexedIndirectCommand);
+
+    mFrames.resize(framesInFlight);
+    for (FrameBuffers& frame : mFrames) {
+        frame.objects = mpGpuResources->create_buffer(objectBytes, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT, HOST_MEMORY);
+        if (!mGpuDriven) {
+            frame.phases[CULL_PHASE_EARLY].visibleInstances = mpGpuResources->create_buffer(instanceBytes,
+                                                                                            VK_BUFFER_USAGE_STORAGE_BUFFER_BIT,
+                                                                                            HOST_MEMORY);
+            continue;
+        }
+
+        frame.batches = mpGpuResources->create_buffer(batchBytes, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT, HOST_MEMORY);
+        frame.cullUniforms = mpGpuResources->create_buffer(sizeof(CullUniforms), VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT, HOST_MEMORY);
+        frame.cullCounters = mpGpuResources->create_buffer(sizeof(CullCounters), VK_BUFFER_USAGE_STORAGE_BUFFER_BIT, HOST_MEMORY);
+        memset(mpGpuResources->get_mapped(frame.cullCounters), 0, sizeof(CullCounters));
+
+        for (PhaseBuffers& phase : frame.phases) {
+            phase.visibleInstances = mpGpuResources->create_buffer(instanceBytes, GPU_WRITTEN_USAGE,
+                                                                   VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
+            phase.batchCounts = mpGpuResources->create_buffer(countBytes, GPU_WRITTEN_USAGE,
+                                                              VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
+            phase.drawCommands = mpGpuResources->create_buffer(commandBytes, GPU_WRITTEN_USAGE | VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT,
+                                                               VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
+            phase.drawCounts = mpGpuResources->create_buffer(countBytes, GPU_WRITTEN_USAGE | VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT,
+                                                             VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
+        }
+    }
+
+    if (mGpuDriven) {
+        mObjectVisibility = mpGpuResources->create_buffer(instanceBytes, GPU_WRITTEN_USAGE, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
+        mClearObjectVisibility = true;
+    }
+}
+
+//------------------------------------------------------------------------------------------
+// The descriptor set layouts are owned by the descriptor allocator's cache
+//------------------------------------------------------------------------------------------
+void InstancedRenderer::clean_up() {
+    for (FrameBuffers& frame : mFrames) {
+        std::vector<BufferHandle> buffers = { frame.objects, frame.batches, frame.cullUniforms, frame.cullCounters };
+        for (const PhaseBuffers& phase : frame.phases) {
+            buffers.insert(buffers.end(), { phase.visibleInstances, phase.batchCounts, phase.drawCommands, phase.drawCounts });
+        }
+
+        for (BufferHandle buffer : buffers) {
+            if (!buffer.is_null()) {
+                mpGpuResources->destroy_buffer(buffer);
+            }
+        }
+    }
+    mFrames.clear();
+
+    if (!mObjectVisibility.is_null()) {
+        mpGpuResources->destroy_buffer(mObjectVisibility);
+        mObjectVisibility = BufferHandle();
+    }
+
+    mpGpuResources->destroy_buffer(mVertexBuffer);
+    mpGpuResources->destroy_buffer(mIndexBuffer);
+    mVertexBytes = 0;
+    mIndexCount = 0;
+    mMeshes = ResourcePool<MeshTag, Mesh>();
+    mMaterials = ResourcePool<MaterialTag, Material>();
+
+    if (mGpuDriven) {
+        mpGpuResources->destroy_pipeline(mCullPipeline);
+        mpGpuResources->destroy_pipeline(mCullLatePipeline);
+        mpGpuResources->destroy_pipeline(mBuildDrawsPipeline);
+        vkDestroyPipelineLayout(mDevice, mCullPipelineLayout, nullptr);
+        mCullPipelineLayout = VK_NULL_HANDLE;
+    }
+
+    vkDestroyPipelineLayout(mDevice, mPipelineLayout, nullptr);
+    mPipelineLayout = VK_NULL_HANDLE;
+}
+
+//------------------------------------------------------------------------------------------
+//------------------------------------------------------------------------------------------
+MeshHandle InstancedRenderer::add_mesh(const MeshData& meshData) {
+    return add_mesh(meshData.get_view());
+}
+
+//------------------------------------------------------------------------------------------
+//------------------------------------------------------------------------------------------
+MeshHandle InstancedRenderer::add_mesh(const MeshView& meshView) {
+    return add_mesh(std::vector<MeshView>(1, meshView));
+}
+
+//------------------------------------------------------------------------------------------
+// The geometry buffers are host visible, so the one copy is all the upload there is.
+// Quantized meshes are drawn in the space of their grid, their transforms are multiplied by
+// the dequantization on submission. The scale is uniform, so the bounds convert exactly and
+// the normals only change length.
+//------------------------------------------------------------------------------------------
+MeshHandle InstancedRenderer::add_mesh(const std::vector<MeshView>& lods) {
+    if (lods.empty() || lods.size() > MAX_LOD_COUNT) {
+        throw std::runtime_error("Failed to add mesh, it needs 1 to " + std::to_string(MAX_LOD_COUNT) + " levels of detail!");
+    }
+    const MeshView& meshView = lods[0];
+
+    // The vertex buffer is bound at offset zero with the pipeline's stride, so a mesh has to
+    // start on a multiple of its own stride
+    const uint32_t stride = get_vertex_stride(meshView.vertexFormat);
+    const uint32_t firstVertexByte = (mVertexBytes + stride - 1) / stride * stride;
+    append_geometry(mVertexBuffer, firstVertexByte, meshView.pVertices, meshView.vertexCount * stride,
+                    VK_BUFFER_USAGE_VERTEX_BUFFER_BIT);
+
+    Mesh mesh;
+    mesh.lodCount = static_cast<uint32_t>(lods.size());
+    for (uint32_t i = 0; i < mesh.lodCount; i++) {
+        append_geometry(mIndexBuffer, mIndexCount * sizeof(uint32_t), lods[i].pIndices,
+                        lods[i].indexCount * static_cast<uint32_t>(sizeof(uint32_t)), VK_BUFFER_USAGE_INDEX_BUFFER_BIT);
+        mesh.lods[i].firstIndex = mIndexCount;
+        mesh.lods[i].indexCount = lods[i].indexCount;
+        mesh.lods[i].error = meshView.boundingSphere.w > 0.0f ? lods[i].lodError / meshView.boundingSphere.w : 0.0f;
+        mIndexCount += lods[i].indexCount;
+    }
+    mesh.vertexOffset = static_cast<int32_t>(firstVertexByte / stride);
+    mesh.quantized = meshView.vertexFormat == VERTEX_FORMAT_QUANTIZED;
+    mesh.dequantization = glm::mat4(1.0f);
+    mesh.boundingSphere = meshView.boundingSphere;
+    if (mesh.quantized) {
+        const float scale = meshView.dequantization.w;
+        mesh.dequantization[0][0] = mesh.dequantization[1][1] = mesh.dequantization[2][2] = scale;
+        mesh.dequantization[3] = glm::vec4(glm::vec3(meshView.dequantization), 1.0f);
+        mesh.boundingSphere = glm::vec4((glm::vec3(meshView.boundingSphere) - glm::vec3(meshView.dequantization)) / scale,
+                                        meshView.boundingSphere.w / scale);
+    }
+
+    mVertexBytes = firstVertexByte + meshView.vertexCount * stride;
+    mMaxLodCount = std::max(mMaxLodCount, mesh.lodCount);
+
+    return mMeshes.add(mesh);
+}
+
+//------------------------------------------------------------------------------------------
+//------------------------------------------------------------------------------------------
+MaterialHandle InstancedRenderer::add_material(PipelineHandle pipeline) {
+    Material material;
+    material.pipeline = pipeline;
+    return mMaterials.add(material);
+}
+
+//------------------------------------------------------------------------------------------
+//------------------------------------------------------------------------------------------
+void InstancedRenderer::set_lod_selection(float projectionScale, float maxPixelError) {
+    mLodProjectionScale = projectionScale;
+    mLodThreshold = maxPixelError;
+}
+
+//------------------------------------------------------------------------------------------
+// The frame's buffers are only rewritten once the GPU retired their previous use, which
+// the caller guarantees by waiting on the frame slot before calling this. That also makes
+// the culling counters of the slot's previous frame readable.
+//------------------------------------------------------------------------------------------
+void InstancedRenderer::begin_frame(uint32_t frameIndex) {
+    mCurrentFrame = frameIndex % static_cast<uint32_t>(mFrames.size());
+    mObjects.clear();
+    mBatches.clear();
+    mBatchLookup.clear();
+    mMaterialRanges.clear();
+    mStats.drawCalls = 0;
+    mStats.pipelineBinds = 0;
+    mStats.recordMs = 0.0;
+
+    if (mGpuDriven) {
+        CullCounters* pCounters = static_cast<CullCounters*>(mpGpuResources->get_mapped(mFrames[mCurrentFrame].cullCounters));
+        mStats.frustumCulled = pCounters->frustumCulled;
+        mStats.occlusionCulled = pCounters->occlusionCulled;
+        mStats.drawnEarly = pCounters->drawnEarly;
+        mStats.drawnLate = pCounters->drawnLate;
+        mStats.visibleInstances = pCounters->drawnEarly + pCounters->drawnLate;
+        for (uint32_t i = 0; i < MAX_LOD_COUNT; i++) {
+            mStats.lodDrawn[i] = pCounters->lodDrawn[i];
+        }
+        memset(pCounters, 0, sizeof(CullCounters));
+    }
+}
+
+//------------------------------------------------------------------------------------------
+//------------------------------------------------------------------------------------------
+void InstancedRenderer::submit(MeshHandle mesh, MaterialHandle material, const glm::mat4& transform) {
+    const Mesh& meshData = mMeshes.get<0>(mesh);
+
+    ObjectData object;
+    object.transform = meshData.quantized ? transform * meshData.dequantization : transform;
+    object.batchIndex = find_batch(mesh, material);
+    object.padding[0] = object.padding[1] = object.padding[2] = 0;
+
+    mObjects.push_back(object);
+    mBatches[object.batchIndex].objectCount++;
+}
+
+//------------------------------------------------------------------------------------------
+// The CPU path culls and compacts here. The GPU driven path gives every batch room for all
+// of its objects and leaves culling to dispatch_culling.
+//------------------------------------------------------------------------------------------
+void InstancedRenderer::prepare(const glm::mat4& viewProjection) {
+    auto start = std::chrono::high_resolution_clock::now();
+
+    mViewProjection = viewProjection;
+    extract_frustum_planes(viewProjection, mFrustumPlanes);
+
+    const uint32_t objectCount = static_cast<uint32_t>(mObjects.size());
+    const uint32_t batchCount = static_cast<uint32_t>(mBatches.size());
+    FrameBuffers& frame = mFrames[mCurrentFrame];
+
+    ensure_buffer(frame.objects, objectCount * sizeof(ObjectData), VK_BUFFER_USAGE_STORAGE_BUFFER_BIT, HOST_MEMORY);
+    if (objectCount > 0) {
+        memcpy(mpGpuResources->get_mapped(frame.objects), mObjects.data(), objectCount * sizeof(ObjectData));
+    }
+
+    if (mGpuDriven) {
+        // Every level of a batch has room for all of its objects
+        const uint32_t instanceCount = assign_batch_ranges(false);
+
+        ensure_buffer(frame.batches, batchCount * sizeof(BatchData), VK_BUFFER_USAGE_STORAGE_BUFFER_BIT, HOST_MEMORY);
+        for (PhaseBuffers& phase : frame.phases) {
+            ensure_buffer(phase.visibleInstances, instanceCount * sizeof(uint32_t), GPU_WRITTEN_USAGE,
+                          VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
+            ensure_buffer(phase.batchCounts, batchCount * sizeof(uint32_t), GPU_WRITTEN_USAGE,
+                          VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
+            ensure_buffer(phase.drawCommands, batchCount * sizeof(VkDrawIndexedIndirectCommand),
+                          GPU_WRITTEN_USAGE | VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
+            ensure_buffer(phase.drawCounts, mMaterialRanges.size() * sizeof(uint32_t),
+                          GPU_WRITTEN_USAGE | VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
+        }
+        if (ensure_buffer(mObjectVisibility, objectCount * sizeof(uint32_t), GPU_WRITTEN_USAGE,
+                          VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT)) {
+            mClearObjectVisibility = true;
+        }
+
+        CullUniforms* pUniforms = static_cast<CullUniforms*>(mpGpuResources->get_mapped(frame.cullUniforms));
+        pUniforms->viewProjection = viewProjection;
+        for (uint32_t i = 0; i < 6; i++) {
+            pUniforms->frustumPlanes[i] = mFrustumPlanes[i];
+        }
+        pUniforms->depthPlane = glm::vec4(viewProjection[0][3], viewProjection[1][3], viewProjection[2][3], viewProjection[3][3]);
+        pUniforms->pyramidSize = glm::vec2(0.0f);
+        if (mpDepthPyramid != nullptr) {
+            pUniforms->pyramidSize = glm::vec2(mpDepthPyramid->get_extent().width, mpDepthPyramid->get_extent().height);
+        }
+        pUniforms->objectCount = objectCount;
+        pUniforms->batchCount = batchCount;
+        pUniforms->useDrawCount = mUseDrawCount ? 1 : 0;
+        pUniforms->occlusionCulling = uses_occlusion_culling() ? 1 : 0;
+        pUniforms->lodProjectionScale = mLodProjectionScale;
+        pUniforms->lodThreshold = mLodThreshold;
+
+        BatchData* pBatchData = static_cast<BatchData*>(mpGpuResources->get_mapped(frame.batches));
+        for (uint32_t rangeIndex = 0; rangeIndex < mMaterialRanges.size(); rangeIndex++) {
+            const MaterialRange& range = mMaterialRanges[rangeIndex];
+            for (uint32_t slot = range.firstDraw; slot < range.firstDraw + range.drawCount; slot++) {
+                const Batch& batch = mBatches[mBatchOrder[slot]];
+                const Mesh& mesh = mMeshes.get<0>(batch.mesh);
+
+                BatchData& data = pBatchData[mBatchOrder[slot]];
+                data.boundingSphere = mesh.boundingSphere;
+                data.indexCount = mesh.lods[batch.lod].indexCount;
+                data.firstIndex = mesh.lods[batch.lod].firstIndex;
+                data.vertexOffset = mesh.vertexOffset;
+                data.firstInstance = batch.firstInstance;
+                data.drawSlot = slot;
+                data.materialSlot = rangeIndex;
+                data.materialFirstDraw = range.firstDraw;
+                data.lodCount = batch.lodCount;
+                data.lodError = batch.lodError;
+                data.padding[0] = data.padding[1] = data.padding[2] = 0;
+            }
+        }
+    }
+    else {
+        cull_on_cpu();
+    }
+
+    auto end = std::chrono::high_resolution_clock::now();
+    mStats.instances = objectCount;
+    mStats.batches = batchCount;
+    mStats.prepareMs = std::chrono::duration<double, std::milli>(end - start).count();
+}
+
+//------------------------------------------------------------------------------------------
+// Pass one culls every object and appends the survivors to their batch's range of visible
+// instances. Pass two turns the per-batch counts into indexed indirect commands.
+// The early phase keeps the objects visible last frame, the late phase tests every object
+// against the depth pyramid, records the result for the next frame and keeps the objects
+// which were not drawn early.
+//------------------------------------------------------------------------------------------
+void InstancedRenderer::dispatch_culling(VkCommandBuffer commandBuffer, CullPhase phase) {
+    if (!mGpuDriven || mObjects.empty() || (phase == CULL_PHASE_LATE && !uses_occlusion_culling())) {
+        return;
+    }
+
+    auto start = std::chrono::high_resolution_clock::now();
+
+    const FrameBuffers& frame = mFrames[mCurrentFrame];
+    const PhaseBuffers& phaseBuffers = frame.phases[phase];
+    const uint32_t objectCount = static_cast<uint32_t>(mObjects.size());
+    const uint32_t batchCount = static_cast<uint32_t>(mBatches.size());
+
+    if (phase == CULL_PHASE_EARLY) {
+        if (mpDepthPyramid != nullptr) {
+            mpDepthPyramid->ensure_layout(commandBuffer);
+        }
+        if (mClearObjectVisibility) {
+            vkCmdFillBuffer(commandBuffer, mpGpuResources->get_buffer(mObjectVisibility), 0, VK_WHOLE_SIZE, 0);
+            mClearObjectVisibility = false;
+        }
+    }
+
+    vkCmdFillBuffer(commandBuffer, mpGpuResources->get_buffer(phaseBuffers.batchCounts), 0, batchCount * sizeof(uint32_t), 0);
+    vkCmdFillBuffer(commandBuffer, mpGpuResources->get_buffer(phaseBuffers.drawCounts), 0,
+                    mMaterialRanges.size() * sizeof(uint32_t), 0);
+
+    // Also orders the previous frame's visibility writes before this frame's reads
+    VkMemoryBarrier barrier{};
+    barrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+    barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT | VK_ACCESS_SHADER_WRITE_BIT;
+    barrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT;
+    vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT | VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+                         VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, 0, 1, &barrier, 0, nullptr, 0, nullptr);
+
+    VkDescriptorSet descriptorSet = mpDescriptorAllocator->allocate_transient(mCullSetLayout);
+
+    const BufferHandle buffers[] = { frame.objects, frame.batches, phaseBuffers.batchCounts, phaseBuffers.visibleInstances,
+                                     phaseBuffers.drawCommands, phaseBuffers.drawCounts, mObjectVisibility, frame.cullCounters };
+    write_storage_descriptors(descriptorSet, buffers, 8);
+
+    VkDescriptorBufferInfo uniformInfo{};
+    uniformInfo.buffer = mpGpuResources->get_buffer(frame.cullUniforms);
+    uniformInfo.offset = 0;
+    uniformInfo.range = sizeof(CullUniforms);
+
+    VkDescriptorImageInfo pyramidInfo{};
+    if (phase == CULL_PHASE_LATE) {
+        pyramidInfo.sampler = mpDepthPyramid->get_sampler();
+        pyramidInfo.imageView = mpDepthPyramid->get_view();
+        pyramidInfo.imageLayout = VK_IMAGE_LAYOUT_GENERAL;
+    }
+
+    // The early shader never reads the pyramid, so binding 9 is left unwritten for it
+    VkWriteDescriptorSet descriptorWrites[2]{};
+    descriptorWrites[0].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+    descriptorWrites[0].dstSet = descriptorSet;
+    descriptorWrites[0].dstBinding = 8;
+    descriptorWrites[0].descriptorCount = 1;
+    descriptorWrites[0].descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
+    descriptorWrites[0].pBufferInfo = &uniformInfo;
+    descriptorWrites[1].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+    descriptorWrites[1].dstSet = descriptorSet;
+    descriptorWrites[1].dstBinding = 9;
+    descriptorWrites[1].descriptorCount = 1;
+    descriptorWrites[1].descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+    descriptorWrites[1].pImageInfo = &pyramidInfo;
+    vkUpdateDescriptorSets(mDevice, phase == CULL_PHASE_LATE ? 2 : 1, descriptorWrites, 0, nullptr);
+
+    vkCmdBindDescriptorSets(commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, mCullPipelineLayout, 0, 1, &descriptorSet, 0, nullptr);
+
+    PipelineHandle cullPipeline = phase == CULL_PHASE_LATE ? mCullLatePipeline : mCullPipeline;
+    vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, mpGpuResources->get_pipeline(cullPipeline));
+    vkCmdDispatch(commandBuffer, (objectCount + CULL_GROUP_SIZE - 1) / CULL_GROUP_SIZE, 1, 1);
+
+    barrier.srcAccessMask = VK_ACCESS_SHADER_WRITE_BIT;
+    barrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT;
+    vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+                         0, 1, &barrier, 0, nullptr, 0, nullptr);
+
+    vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, mpGpuResources->get_pipeline(mBuildDrawsPipeline));
+    vkCmdDispatch(commandBuffer, (batchCount + CULL_GROUP_SIZE - 1) / CULL_GROUP_SIZE, 1, 1);
+
+    // The counters are read on the host once the frame retired
+    barrier.srcAccessMask = VK_ACCESS_SHADER_WRITE_BIT;
+    barrier.dstAccessMask = VK_ACCESS_INDIRECT_COMMAND_READ_BIT | VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_HOST_READ_BIT;
+    vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+                         VK_PIPELINE_STAGE_DRAW_INDIRECT_BIT | VK_PIPELINE_STAGE_VERTEX_SHADER_BIT | VK_PIPELINE_STAGE_HOST_BIT,
+                         0, 1, &barrier, 0, nullptr, 0, nullptr);
+
+    auto end = std::chrono::high_resolution_clock::now();
+    mStats.recordMs += std::chrono::duration<double, std::milli>(end - start).count();
+}
+
+//------------------------------------------------------------------------------------------
+// The geometry buffers are bound once. The GPU driven path issues one indirect draw per
+// material, the CPU path one vkCmdDrawIndexed per batch.
+//------------------------------------------------------------------------------------------
+void InstancedRenderer::record(VkCommandBuffer commandBuffer, CullPhase phase) {
+    if (mObjects.empty() || (phase == CULL_PHASE_LATE && !uses_occlusion_culling())) {
+        return;
+    }
+
+    auto start = std::chrono::high_resolution_clock::now();
+
+    const FrameBuffers& frame = mFrames[mCurrentFrame];
+    const PhaseBuffers& phaseBuffers = frame.phases[phase];
+    VkDescriptorSet descriptorSet = mpDescriptorAllocator->allocate_transient(mDescriptorSetLayout);
+
+    const BufferHandle buffers[] = { frame.objects, phaseBuffers.visibleInstances };
+    write_storage_descriptors(descriptorSet, buffers, 2);
+
+    PushConstants pushConstants;
+    pushConstants.viewProjection = mViewProjection;
+
+    vkCmdBindDescriptorSets(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, mPipelineLayout, 0, 1, &descriptorSet, 0, nullptr);
+    vkCmdPushConstants(commandBuffer, mPipelineLayout, VK_SHADER_STAGE_VERTEX_BIT, 0, sizeof(PushConstants), &pushConstants);
+
+    VkBuffer vertexBuffer = mpGpuResources->get_buffer(mVertexBuffer);
+    VkDeviceSize offset = 0;
+    vkCmdBindVertexBuffers(commandBuffer, 0, 1, &vertexBuffer, &offset);
+    vkCmdBindIndexBuffer(commandBuffer, mpGpuResources->get_buffer(mIndexBuffer), 0, VK_INDEX_TYPE_UINT32);
+
+    const VkBuffer drawCommands = mGpuDriven ? mpGpuResources->get_buffer(phaseBuffers.drawCommands) : VK_NULL_HANDLE;
+    const uint32_t stride = sizeof(VkDrawIndexedIndirectCommand);
+
+    for (uint32_t rangeIndex = 0; rangeIndex < mMaterialRanges.size(); rangeIndex++) {
+        const MaterialRange& range = mMaterialRanges[rangeIndex];
+
+        PipelineHandle pipeline = mMaterials.get<0>(range.material).pipeline;
+        vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, mpGpuResources->get_pipeline(pipeline));
+        mStats.pipelineBinds++;
+
+        if (mUseDrawCount) {
+            mCmdDrawIndexedIndirectCount(commandBuffer, drawCommands, range.firstDraw * stride,
+                                         mpGpuResources->get_buffer(phaseBuffers.drawCounts), rangeIndex * sizeof(uint32_t),
+                                         range.drawCount, stride);
+            mStats.drawCalls++;
+        }
+        else if (mGpuDriven) {
+            // Batches culled entirely still get a command, with an instance count of zero
+            vkCmdDrawIndexedIndirect(commandBuffer, drawCommands, range.firstDraw * stride, range.drawCount, stride);
+            mStats.drawCalls++;
+        }
+        else {
+            for (uint32_t slot = range.firstDraw; slot < range.firstDraw + range.drawCount; slot++) {
+                const Batch& batch = mBatches[mBatchOrder[slot]];
+                if (batch.visibleCount == 0) {
+                    continue;
+                }
+
+                const Mesh& mesh = mMeshes.get<0>(batch.mesh);
+                vkCmdDrawIndexed(commandBuffer, mesh.lods[batch.lod].indexCount, batch.visibleCount, mesh.lods[batch.lod].firstIndex,
+                                 mesh.vertexOffset, batch.firstInstance);
+                mStats.drawCalls++;
+            }
+        }
+    }
+
+    auto end = std::chrono::high_resolution_clock::now();
+    mStats.recordMs += std::chrono::duration<double, std::milli>(end - start).count();
+}
+
+//------------------------------------------------------------------------------------------
+//------------------------------------------------------------------------------------------
+void InstancedRenderer::print_stats(std::ostream& out) const {
+    out << "Instanced renderer stats:\n";
+    out << "\tPath: " << (mGpuDriven ? (mUseDrawCount ? "GPU driven, indirect count" : "GPU driven") : "CPU") << '\n';
+    if (!mGpuDriven) {
+        out << "\tCulling kernels: " << simd_level_name(mStats.simdLevel) << '\n';
+    }
+    out << "\tInstances: " << mStats.instances << '\n';
+    out << "\tVisible instances: " << mStats.visibleInstances << '\n';
+    if (mGpuDriven) {
+        out << "\tFrustum culled: " << mStats.frustumCulled << '\n';
+        out << "\tOcclusion culled: " << mStats.occlusionCulled << '\n';
+        out << "\tDrawn early: " << mStats.drawnEarly << '\n';
+        out << "\tDrawn late: " << mStats.drawnLate << '\n';
+    }
+    if (mMaxLodCount > 1) {
+        out << "\tInstances per level of detail:";
+        for (uint32_t i = 0; i < mMaxLodCount; i++) {
+            out << ' ' << mStats.lodDrawn[i];
+        }
+        out << '\n';
+    }
+    out << "\tBatches: " << mStats.batches << '\n';
+    out << "\tDraw calls: " << mStats.drawCalls << '\n';
+    out << "\tPipeline binds: " << mStats.pipelineBinds << '\n';
+    out << "\tCPU prepare: " << mStats.prepareMs << " ms\n";
+    out << "\tCPU record: " << mStats.recordMs << " ms\n";
+}
+
+//------------------------------------------------------------------------------------------
+// Scenes submit long runs of the same mesh and material, so the last batch is checked
+// before the hash map. New batches get an entry per level of detail.
+//------------------------------------------------------------------------------------------
+uint32_t InstancedRenderer::find_batch(MeshHandle mesh, MaterialHandle material) {
+    const uint64_t key = (static_cast<uint64_t>(material.value()) << 32) | mesh.value();
+    if (!mBatches.empty() && key == mLastBatchKey) {
+        return mLastBatch;
+    }
+
+    auto it = mBatchLookup.find(key);
+    if (it == mBatchLookup.end()) {
+        const Mesh& meshData = mMeshes.get<0>(mesh);
+        it = mBatchLookup.emplace(key, static_cast<uint32_t>(mBatches.size())).first;
+        for (uint32_t lod = 0; lod < meshData.lodCount; lod++) {
+            Batch batch;
+            batch.mesh = mesh;
+            batch.material = material;
+            batch.lod = lod;
+            batch.lodCount = meshData.lodCount;
+            batch.lodError = meshData.lods[lod].error;
+            batch.objectCount = 0;
+            batch.visibleCount = 0;
+            batch.firstInstance = 0;
+            mBatches.push_back(batch);
+        }
+    }
+
+    mLastBatchKey = key;
+    mLastBatch = it->second;
+    return mLastBatch;
+}
+
+//------------------------------------------------------------------------------------------
+// Order the batches by material and hand each a contiguous range of instances, sized by
+// its visible count when compacting and by its level 0's object count otherwise
+//------------------------------------------------------------------------------------------
+uint32_t InstancedRenderer::assign_batch_ranges(bool compactRanges) {
+    mBatchOrder.resize(mBatches.size());
+    for (uint32_t i = 0; i < mBatchOrder.size(); i++) {
+        mBatchOrder[i] = i;
+    }
+    std::sort(mBatchOrder.begin(), mBatchOrder.end(), [this](uint32_t a, uint32_t b) {
+        return mBatches[a].material.value() < mBatches[b].material.value();
+    });
+
+    mMaterialRanges.clear();
+    uint32_t firstInstance = 0;
+    for (uint32_t slot = 0; slot < mBatchOrder.size(); slot++) {
+        Batch& batch = mBatches[mBatchOrder[slot]];
+        batch.firstInstance = firstInstance;
+        firstInstance += compactRanges ? batch.visibleCount : mBatches[mBatchOrder[slot] - batch.lod].objectCount;
+
+        if (mMaterialRanges.empty() || mMaterialRanges.back().material != batch.material) {
+            MaterialRange range;
+            range.material = batch.material;
+            range.firstDraw = slot;
+            range.drawCount = 0;
+            mMaterialRanges.push_back(range);
+        }
+        mMaterialRanges.back().drawCount++;
+    }
+    return firstInstance;
+}
+
+//------------------------------------------------------------------------------------------
+// Steps from the previous level towards the coarsest level within the threshold, the same
+// as the culling shaders. pLevels are the entries of a batch's levels.
+//------------------------------------------------------------------------------------------
+template <typename Level>
+static uint32_t select_lod(const Level* pLevels, uint32_t lodCount, uint32_t previous, float projectedRadius, float threshold) {
+    uint32_t lod = std::min(previous, lodCount - 1);
+    while (lod > 0 && pLevels[lod].lodError * projectedRadius > threshold) {
+        lod--;
+    }
+    while (lod + 1 < lodCount && pLevels[lod + 1].lodError * projectedRadius <= threshold * (1.0f - InstancedRenderer::LOD_HYSTERESIS)) {
+        lod++;
+    }
+    return lod;
+}
+
+//------------------------------------------------------------------------------------------
+// Gather every object's bounding sphere, transform and test them against the frustum with
+// the batch kernels, project them for the levels of detail, then scatter the survivors
+// into their level's range of the visible instance buffer
+//------------------------------------------------------------------------------------------
+void InstancedRenderer::cull_on_cpu() {
+    const uint32_t objectCount = static_cast<uint32_t>(mObjects.size());
+    mVisibility.resize(objectCount);
+
+    mLocalSpheres.resize(objectCount);
+    for (uint32_t i = 0; i < objectCount; i++) {
+        const glm::vec4& sphere = mMeshes.get<0>(mBatches[mObjects[i].batchIndex].mesh).boundingSphere;
+        mLocalSpheres.centerX[i] = sphere.x;
+        mLocalSpheres.centerY[i] = sphere.y;
+        mLocalSpheres.centerZ[i] = sphere.z;
+        mLocalSpheres.radius[i] = sphere.w;
+    }
+
+    uint32_t visibleCount = 0;
+    const bool selectLods = mMaxLodCount > 1 && mLodProjectionScale > 0.0f;
+    mObjectLods.resize(objectCount, 0);
+    mProjectedRadii.resize(objectCount);
+    if (objectCount > 0) {
+        transform_spheres(mSimdLevel, &mObjects[0].transform, sizeof(ObjectData), mLocalSpheres, mWorldSpheres);
+        visibleCount = cull_spheres(mSimdLevel, mFrustumPlanes, mWorldSpheres, mVisibility.data());
+        if (selectLods) {
+            const glm::vec4 depthPlane(mViewProjection[0][3], mViewProjection[1][3], mViewProjection[2][3], mViewProjection[3][3]);
+            project_sphere_radii(mSimdLevel, depthPlane, mLodProjectionScale, mWorldSpheres, mProjectedRadii.data());
+        }
+    }
+
+    for (uint32_t i = 0; i < MAX_LOD_COUNT; i++) {
+        mStats.lodDrawn[i] = 0;
+    }
+    for (uint32_t i = 0; i < objectCount; i++) {
+        if (!mVisibility[i]) {
+            continue;
+        }
+        const Batch* pLevels = &mBatches[mObjects[i].batchIndex];
+        if (selectLods) {
+            mObjectLods[i] = static_cast<uint8_t>(select_lod(pLevels, pLevels->lodCount, mObjectLods[i], mProjectedRadii[i],
+                                                             mLodThreshold));
+        }
+        else {
+            mObjectLods[i] = 0;
+        }
+        mBatches[mObjects[i].batchIndex + mObjectLods[i]].visibleCount++;
+        mStats.lodDrawn[mObjectLods[i]]++;
+    }
+
+    assign_batch_ranges(true);
+
+    FrameBuffers& frame = mFrames[mCurrentFrame];
+    BufferHandle& visibleInstances = frame.phases[CULL_PHASE_EARLY].visibleInstances;
+    ensure_buffer(visibleInstances, visibleCount * sizeof(uint32_t), VK_BUFFER_USAGE_STORAGE_BUFFER_BIT, HOST_MEMORY);
+    uint32_t* pVisible = static_cast<uint32_t*>(mpGpuResources->get_mapped(visibleInstances));
+
+    // firstInstance doubles as the write cursor and is restored afterwards
+    for (uint32_t i = 0; i < objectCount; i++) {
+        if (mVisibility[i]) {
+            pVisible[mBatches[mObjects[i].batchIndex + mObjectLods[i]].firstInstance++] = i;
+        }
+    }
+    for (Batch& batch : mBatches) {
+        batch.firstInstance -= batch.visibleCount;
+    }
+
+    mStats.visibleInstances = visibleCount;
+    mStats.frustumCulled = objectCount - visibleCount;
+}
+
+//------------------------------------------------------------------------------------------
+// Grow geometrically. The old buffer may still be read by an earlier frame so it goes
+// through the deletion queue.
+//------------------------------------------------------------------------------------------
+bool InstancedRenderer::ensure_buffer(BufferHandle& buffer, VkDeviceSize size, VkBufferUsageFlags usage,
+                                      VkMemoryPropertyFlags properties) {
+    const VkDeviceSize currentSize = mpGpuResources->get_buffer_size(buffer);
+    if (size <= currentSize) {
+        return false;
+    }
+
+    mpGpuResources->destroy_buffer(buffer);
+    buffer = mpGpuResources->create_buffer(std::max(size, currentSize * 2), usage, properties);
+    return true;
+}
+
+//------------------------------------------------------------------------------------------
+// Bind whole buffers to bindings 0 to count - 1
+//------------------------------------------------------------------------------------------
+void InstancedRenderer::write_storage_descriptors(VkDescriptorSet descriptorSet, const BufferHandle* pBuffers, uint32_t count) {
+    std::vector<VkDescriptorBufferInfo> bufferInfos(count);
+    std::vector<VkWriteDescriptorSet> descriptorWrites(count);
+    for (uint32_t i = 0; i < count; i++) {
+        bufferInfos[i] = {};
+        bufferInfos[i].buffer = mpGpuResources->get_buffer(pBuffers[i]);
+        bufferInfos[i].offset = 0;
+        bufferInfos[i].range = VK_WHOLE_SIZE;
+
+        descriptorWrites[i] = {};
+        descriptorWrites[i].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+        descriptorWrites[i].dstSet = descriptorSet;
+        descriptorWrites[i].dstBinding = i;
+        descriptorWrites[i].descriptorCount = 1;
+        descriptorWrites[i].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+        descriptorWrites[i].pBufferInfo = &bufferInfos[i];
+    }
+    vkUpdateDescriptorSets(mDevice, count, descriptorWrites.data(), 0, nullptr);
+}
+
+//------------------------------------------------------------------------------------------
+// Geometry is kept host visible for now, growing copies the old contents over
+//------------------------------------------------------------------------------------------
+void InstancedRenderer::append_geometry(BufferHandle& buffer, uint32_t usedBytes, const void* pData, uint32_t dataBytes,
+                                        VkBufferUsageFlags usage) {
+    const VkDeviceSize currentSize = mpGpuResources->get_buffer_size(buffer);
+    if (usedBytes + dataBytes > currentSize) {
+        BufferHandle grown = mpGpuResources->create_buffer(std::max<VkDeviceSize>(usedBytes + dataBytes, currentSize * 2),
+                                                           usage, HOST_MEMORY);
+        memcpy(mpGpuResources->get_mapped(grown), mpGpuResources->get_mapped(buffer), usedBytes);
+        mpGpuResources->destroy_buffer(buffer);
+        buffer = grown;
+    }
+
+    memcpy(static_cast<char*>(mpGpuResources->get_mapped(buffer)) + usedBytes, pData, dataBytes);
+}
+
+//------------------------------------------------------------------------------------------
+// Every pass shares one layout: objects, batches, batch counts, visible instances, draw
+// commands, draw counts, object visibility and counters in bindings 0 to 7, the uniforms
+// in 8 and the depth pyramid in 9
+//------------------------------------------------------------------------------------------
+void InstancedRenderer::create_culling_pipelines() {
+    std::vector<VkDescriptorSetLayoutBinding> bindings(10);
+    for (uint32_t i = 0; i < bindings.size(); i++) {
+        bindings[i] = {};
+        bindings[i].binding = i;
+        bindings[i].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+        bindings[i].descriptorCount = 1;
+        bindings[i].stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
+    }
+    bindings[8].descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
+    bindings[9].descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+    mCullSetLayout = mpDescriptorAllocator->get_layout(bindings);
+
+    VkPipelineLayoutCreateInfo layoutCreateInfo{};
+    layoutCreateInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
+    layoutCreateInfo.setLayoutCount = 1;
+    layoutCreateInfo.pSetLayouts = &mCullSetLayout;
+
+    if (vkCreatePipelineLayout(mDevice, &layoutCreateInfo, nullptr, &mCullPipelineLayout) != VK_SUCCESS) {
+        throw std::runtime_error("Failed to create culling pipeline layout!");
+    }
+
+    const char* shaderNames[3] = { "cull_instances.comp.spv", "cull_instances_late.comp.spv", "build_draws.comp.spv" };
+    PipelineHandle* pipelines[3] = { &mCullPipeline, &mCullLatePipeline, &mBuildDrawsPipeline };
+
+    for (uint32_t i = 0; i < 3; i++) {
+        VkShaderModule shaderModule = load_shader_module(mDevice, shaderNames[i]);
+
+        VkComputePipelineCreateInfo createInfo{};
+        createInfo.sType = VK_STRUCTURE_TYPE_COMPUTE_PIPELINE_CREATE_INFO;
+        createInfo.stage.sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
+        createInfo.stage.stage = VK_SHADER_STAGE_COMPUTE_BIT;
+        createInfo.stage.module = shaderModule;
+        createInfo.stage.pName = "main";
+        createInfo.layout = mCullPipelineLayout;
+
+        VkPipeline pipeline;
+        VkResult result = vkCreateComputePipelines(mDevice, VK_NULL_HANDLE, 1, &createInfo, nullptr, &pipeline);
+        vkDestroyShaderModule(mDevice, shaderModule, nullptr);
+        if (result != VK_SUCCESS) {
+            throw std::runtime_error("Failed to create culling pipeline!");
+        }
+
+        *pipelines[i] = mpGpuResources->add_pipeline(pipeline, mCullPipelineLayout, VK_PIPELINE_BIND_POINT_COMPUTE, false);
+    }
+}
+
+//------------------------------------------------------------------------------------------
+// Gribb-Hartmann plane extraction for a [0, 1] depth range, normalized so the plane
+// equation gives the signed distance
+//------------------------------------------------------------------------------------------
+void InstancedRenderer::extract_frustum_planes(const glm::mat4& viewProjection, glm::vec4 planes[6]) {
+    const glm::vec4 row0(viewProjection[0][0], viewProjection[1][0], viewProjection[2][0], viewProjection[3][0]);
+    const glm::vec4 row1(viewProjection[0][1], viewProjection[1][1], viewProjection[2][1], viewProjection[3][1]);
+    const glm::vec4 row2(viewProjection[0][2], viewProjection[1][2], viewProjection[2][2], viewProjection[3][2]);
+    const glm::vec4 row3(viewProjection[0][3], viewProjection[1][3], viewProjection[2][3], viewProjection[3][3]);
+
+    planes[0] = row3 + row0;    // Left
+    planes[1] = row3 - row0;    // Right
+    planes[2] = row3 + row1;    // Bottom
+    planes[3] = row3 - row1;    // Top
+    planes[4] = row2;           // Near
+    planes[5] = row3 - row2;    // Far
+
+    for (uint32_t i = 0; i < 6; i++) {
+        planes[i] /= glm::length(glm::vec3(planes[i]));
+    }
+}
@@ -0,0 +1,157 @@
+//======================================================================
+// JobSystem.cpp
+//
+// Keegan Kochis
+// Created: 2026/10/18
+// The definition of the JobSystem class.
+//======================================================================
+
+#include "JobSystem.h"
+
+#include <cstdint>
+
+#include <algorithm>
+#include <atomic>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <utility>
+
+static thread_local uint32_t tThreadIndex = 0;
+
+JobSystem::JobSystem() {
+}
+
+JobSystem::~JobSystem() {
+    clean_up();
+}
+
+//------------------------------------------------------------------------------------------
+//------------------------------------------------------------------------------------------
+void JobSystem::init(uint32_t workerCount) {
+    if (workerCount == 0) {
+        const uint32_t hardwareThreads = std::thread::hardware_concurrency();
+        workerCount = hardwareThreads > 1 ? hardwareThreads - 1 : 1;
+    }
+
+    mStopping = false;
+    for (uint32_t i = 0; i < workerCount; i++) {
+        mWorkers.emplace_back(&JobSystem::worker_main, this, i + 1);
+    }
+}
+
+//------------------------------------------------------------------------------------------
+//------------------------------------------------------------------------------------------
+void JobSystem::clean_up() {
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        mStopping = true;
+    }
+    mJobAvailable.notify_all();
+
+    for (std::thread& worker : mWorkers) {
+        worker.join();
+    }
+    mWorkers.clear();
+}
+
+//------------------------------------------------------------------------------------------
+//------------------------------------------------------------------------------------------
+void JobSystem::submit(JobCounter& counter, Job job) {
+    counter.pending.fetch_add(1, std::memory_order_relaxed);
+
+    // Without workers the job runs right away, so nothing waits on a queue nobody drains
+    if (mWorkers.empty()) {
+        QueuedJob queuedJob = { std::move(job), &counter };
+        run(queuedJob);
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        mQueue.push_back({ std::move(job), &counter });
+    }
+    mJobAvailable.notify_one();
+}
+
+//------------------------------------------------------------------------------------------
+// The counter's jobs may sit behind unrelated ones, so any queued job is run. Once the
+// queue is empty the remaining jobs are running on workers and only need a yield.
+//------------------------------------------------------------------------------------------
+void JobSystem::wait(JobCounter& counter) {
+    while (counter.pending.load(std::memory_order_acquire) > 0) {
+        if (!try_run_one()) {
+            std::this_thread::yield();
+        }
+    }
+}
+
+//------------------------------------------------------------------------------------------
+//------------------------------------------------------------------------------------------
+void JobSystem::parallel_for(uint32_t count, uint32_t batchSize, const std::function<void(uint32_t, uint32_t)>& function) {
+    batchSize = std::max(batchSize, 1u);
+    if (count <= batchSize) {
+        if (count > 0) {
+            function(0, count);
+        }
+        return;
+    }
+
+    JobCounter counter;
+    // The calling thread takes the first range itself
+    for (uint32_t begin = batchSize; begin < count; begin += batchSize) {
+        const uint32_t end = std::min(begin + batchSize, count);
+        submit(counter, [&function, begin, end]() { function(begin, end); });
+    }
+    function(0, batchSize);
+    wait(counter);
+}
+
+//------------------------------------------------------------------------------------------
+//------------------------------------------------------------------------------------------
+uint32_t JobSystem::get_thread_index() {
+    return tThreadIndex;
+}
+
+//------------------------------------------------------------------------------------------
+//------------------------------------------------------------------------------------------
+void JobSystem::worker_main(uint32_t threadIndex) {
+    tThreadIndex = threadIndex;
+
+    while (true) {
+        QueuedJob queuedJob;
+        {
+            std::unique_lock<std::mutex> lock(mMutex);
+            mJobAvailable.wait(lock, [this]() { return mStopping || !mQueue.empty(); });
+            if (mQueue.empty()) {
+                return;
+            }
+            queuedJob = std::move(mQueue.front());
+            mQueue.pop_front();
+        }
+        run(queuedJob);
+    }
+}
+
+//------------------------------------------------------------------------------------------
+//------------------------------------------------------------------------------------------
+bool JobSystem::try_run_one() {
+    QueuedJob queuedJob;
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        if (mQueue.empty()) {
+            return false;
+        }
+        queuedJob = std::move(mQueue.front());
+        mQueue.pop_front();
+    }
+    run(queuedJob);
+    return true;
+}
+
+//------------------------------------------------------------------------------------------
+//------------------------------------------------------------------------------------------
+void JobSystem::run(QueuedJob& queuedJob) {
+    queuedJob.job();
+    queuedJob.pCounter->pending.fetch_sub(1, std::memory_order_release);
+}
@@ -0,0 +1,286 @@
+//======================================================================
+// Json.cpp
+//
+// Keegan Kochis
+// Created: 2026/10/18
+// The definition of the JsonValue class and its recursive descent
+// parser.
+//======================================================================
+
+#include "Json.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+// Deeper documents are rejected rather than risking the stack
+static const uint32_t MAX_DEPTH = 256;
+
+static const JsonValue NULL_VALUE;
+
+class JsonParser {
+public:
+    JsonParser(const char* pText, size_t length) : mpCursor(pText), mpStart(pText), mpEnd(pText + length) {}
+
+    JsonValue parse_document() {
+        JsonValue value = parse_value(0);
+        skip_whitespace();
+        if (mpCursor != mpEnd) {
+            fail("unexpected characters after the document");
+        }
+        return value;
+    }
+
+private:
+    const char* mpCursor;
+    const char* mpStart;
+    const char* mpEnd;
+
+    void fail(const char* pReason) const {
+        uint32_t line = 1;
+        for (const char* p = mpStart; p < mpCursor && p < mpEnd; p++) {
+            line += *p == '\n';
+        }
+        throw std::runtime_error("Failed to parse JSON on line " + std::to_string(line) + ", " + pReason + "!");
+    }
+
+    void skip_whitespace() {
+        while (mpCursor < mpEnd && (*mpCursor == ' ' || *mpCursor == '\t' || *mpCursor == '\n' || *mpCursor == '\r')) {
+            mpCursor++;
+        }
+    }
+
+    bool consume(char c) {
+        skip_whitespace();
+        if (mpCursor < mpEnd && *mpCursor == c) {
+            mpCursor++;
+            return true;
+        }
+        return false;
+    }
+
+    void expect(char c) {
+        if (!consume(c)) {
+            fail((std::string("expected '") + c + "'").c_str());
+        }
+    }
+
+    bool consume_literal(const char* pLiteral) {
+        const size_t length = strlen(pLiteral);
+        if (static_cast<size_t>(mpEnd - mpCursor) >= length && memcmp(mpCursor, pLiteral, length) == 0) {
+            mpCursor += length;
+            return true;
+        }
+        return false;
+    }
+
+    JsonValue parse_value(uint32_t depth) {
+        if (depth > MAX_DEPTH) {
+            fail("the document is nested too deeply");
+        }
+        skip_whitespace();
+        if (mpCursor == mpEnd) {
+            fail("unexpected end of the document");
+        }
+
+        JsonValue value;
+        const char c = *mpCursor;
+        if (c == '{') {
+            mpCursor++;
+            value.mType = JsonValue::TYPE_OBJECT;
+            if (consume('}')) {
+                return value;
+            }
+            do {
+                skip_whitespace();
+                if (mpCursor == mpEnd || *mpCursor != '"') {
+                    fail("expected a member name");
+                }
+                std::string key = parse_string();
+                expect(':');
+                value.mMembers.emplace_back(std::move(key), parse_value(depth + 1));
+            } while (consume(','));
+            expect('}');
+        }
+        else if (c == '[') {
+            mpCursor++;
+            value.mType = JsonValue::TYPE_ARRAY;
+            if (consume(']')) {
+                return value;
+            }
+            do {
+                value.mElements.push_back(parse_value(depth + 1));
+            } while (consume(','));
+            expect(']');
+        }
+        else if (c == '"') {
+            value.mType = JsonValue::TYPE_STRING;
+            value.mString = parse_string();
+        }
+        else if (consume_literal("true") || consume_literal("false")) {
+            value.mType = JsonValue::TYPE_BOOL;
+            value.mBool = c == 't';
+        }
+        else if (consume_literal("null")) {
+            value.mType = JsonValue::TYPE_NULL;
+        }
+        else {
+            // strtod could read past the end of an unterminated buffer, so the number is
+            // copied out first
+            const char* pNumberEnd = mpCursor;
+            while (pNumberEnd < mpEnd && strchr("+-0123456789.eE", *pNumberEnd)) {
+                pNumberEnd++;
+            }
+            const std::string number(mpCursor, pNumberEnd);
+            char* pParsedEnd = nullptr;
+            value.mType = JsonValue::TYPE_NUMBER;
+            value.mNumber = strtod(number.c_str(), &pParsedEnd);
+            if (number.empty() || pParsedEnd != number.c_str() + number.size()) {
+                fail("expected a value");
+            }
+            mpCursor = pNumberEnd;
+        }
+        return value;
+    }
+
+    uint32_t parse_hex4() {
+        if (mpEnd - mpCursor < 4) {
+            fail("truncated escape sequence");
+        }
+        uint32_t codePoint = 0;
+        for (uint32_t i = 0; i < 4; i++) {
+            const char c = *mpCursor++;
+            codePoint <<= 4;
+            if (c >= '0' && c <= '9') {
+                codePoint |= c - '0';
+            }
+            else if (c >= 'a' && c <= 'f') {
+                codePoint |= c - 'a' + 10;
+            }
+            else if (c >= 'A' && c <= 'F') {
+                codePoint |= c - 'A' + 10;
+            }
+            else {
+                fail("invalid escape sequence");
+            }
+        }
+        return codePoint;
+    }
+
+    static void append_utf8(std::string& out, uint32_t codePoint) {
+        if (codePoint < 0x80) {
+            out += static_cast<char>(codePoint);
+        }
+        else if (codePoint < 0x800) {
+            out += static_cast<char>(0xC0 | (codePoint >> 6));
+            out += static_cast<char>(0x80 | (codePoint & 0x3F));
+        }
+        else if (codePoint < 0x10000) {
+            out += static_cast<char>(0xE0 | (codePoint >> 12));
+            out += static_cast<char>(0x80 | ((codePoint >> 6) & 0x3F));
+            out += static_cast<char>(0x80 | (codePoint & 0x3F));
+        }
+        else {
+            out += static_cast<char>(0xF0 | (codePoint >> 18));
+            out += static_cast<char>(0x80 | ((codePoint >> 12) & 0x3F));
+            out += static_cast<char>(0x80 | ((codePoint >> 6) & 0x3F));
+            out += static_cast<char>(0x80 | (codePoint & 0x3F));
+        }
+    }
+
+    std::string parse_string() {
+        mpCursor++;
+        std::string out;
+        while (true) {
+            if (mpCursor == mpEnd) {
+                fail("unterminated string");
+            }
+            const char c = *mpCursor++;
+            if (c == '"') {
+                return out;
+            }
+            if (c != '\\') {
+                out += c;
+                continue;
+            }
+            if (mpCursor == mpEnd) {
+                fail("unterminated string");
+            }
+            const char escape = *mpCursor++;
+            switch (escape) {
+                case '"': out += '"'; break;
+                case '\\': out += '\\'; break;
+                case '/': out += '/'; break;
+                case 'b': out += '\b'; break;
+                case 'f': out += '\f'; break;
+                case 'n': out += '\n'; break;
+                case 'r': out += '\r'; break;
+                case 't': out += '\t'; break;
+                case 'u': {
+                    uint32_t codePoint = parse_hex4();
+                    // A high surrogate pairs with the low surrogate escaped right after it
+                    if (codePoint >= 0xD800 && codePoint < 0xDC00 && consume_literal("\\u")) {
+                        const uint32_t low = parse_hex4();
+                        if (low < 0xDC00 || low >= 0xE000) {
+                            fail("invalid surrogate pair");
+                        }
+                        codePoint = 0x10000 + ((codePoint - 0xD800) << 10) + (low - 0xDC00);
+                    }
+                    append_utf8(out, codePoint);
+                    break;
+                }
+                default:
+                    fail("invalid escape sequence");
+            }
+        }
+    }
+};
+
+JsonValue::JsonValue() {
+}
+
+//------------------------------------------------------------------------------------------
+//------------------------------------------------------------------------------------------
+JsonValue JsonValue::parse(const char* pText, size_t length) {
+    JsonParser parser(pText, length);
+    return parser.parse_document();
+}
+
+//------------------------------------------------------------------------------------------
+//------------------------------------------------------------------------------------------
+const JsonValue& JsonValue::operator[](const char* pKey) const {
+    for (const Member& member : mMembers) {
+        if (member.first == pKey) {
+            return member.second;
+        }
+    }
+    return NULL_VALUE;
+}
+
+//------------------------------------------------------------------------------------------
+//------------------------------------------------------------------------------------------
+const JsonValue& JsonValue::operator[](uint32_t index) const {
+    return index < mElements.size() ? mElements[index] : NULL_VALUE;
+}
+
+//------------------------------------------------------------------------------------------
+//------------------------------------------------------------------------------------------
+size_t JsonValue::size() const {
+    return mType == TYPE_ARRAY ? mElements.size() : mMembers.size();
+}
+
+//------------------------------------------------------------------------------------------
+// Negative or fractional numbers aren't valid indices or counts, they read as the fallback
+//------------------------------------------------------------------------------------------
+uint32_t JsonValue::as_uint(uint32_t fallback) const {
+    if (mType != TYPE_NUMBER || mNumber < 0.0 || mNumber > 4294967295.0 || mNumber != static_cast<double>(static_cast<uint64_t>(mNumber))) {
+        return fallback;
+    }
+    return static_cast<uint32_t>(mNumber);
+}
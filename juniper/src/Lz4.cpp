@@ -0,0 +1,258 @@
+//======================================================================
+// Lz4.cpp
+//
+// Keegan Kochis
+// Created: 2026/10/19
+// The LZ4 block format compressor and decompressor. A block is a list
+// of sequences, each a token with the literal and match lengths, the
+// literals, and the match offset and length, ending with literals only.
+//======================================================================
+
+#include "Lz4.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+#include <stdexcept>
+
+static const size_t MIN_MATCH = 4;
+// The format ends on at least this many literals, and no match starts in the last MATCH_LIMIT bytes
+static const size_t LAST_LITERALS = 5;
+static const size_t MATCH_LIMIT = 12;
+static const size_t MAX_OFFSET = 65535;
+static const uint32_t HASH_BITS = 14;
+// Misses before the search starts skipping ahead, so incompressible data passes quickly
+static const uint32_t SKIP_TRIGGER = 6;
+// Wild copies write up to this many bytes at once where both buffers have room
+static const size_t COPY_BYTES = 16;
+
+static uint32_t read32(const uint8_t* pData) {
+    uint32_t value;
+    memcpy(&value, pData, sizeof(value));
+    return value;
+}
+
+static uint32_t hash4(uint32_t value) {
+    return (value * 2654435761u) >> (32 - HASH_BITS);
+}
+
+// Bytes that match from the two positions, stopping at the limit of the first. Compares
+// eight bytes at a time, the lowest differing bit of a mismatch gives its byte.
+static size_t count_matching(const uint8_t* pIn, const uint8_t* pMatch, const uint8_t* pLimit) {
+    const uint8_t* pStart = pIn;
+    while (pIn + sizeof(uint64_t) <= pLimit) {
+        uint64_t a;
+        uint64_t b;
+        memcpy(&a, pIn, sizeof(a));
+        memcpy(&b, pMatch, sizeof(b));
+        if (a != b) {
+            return static_cast<size_t>(pIn - pStart) + static_cast<size_t>(__builtin_ctzll(a ^ b) / 8);
+        }
+        pIn += sizeof(uint64_t);
+        pMatch += sizeof(uint64_t);
+    }
+    while (pIn < pLimit && *pIn == *pMatch) {
+        pIn++;
+        pMatch++;
+    }
+    return static_cast<size_t>(pIn - pStart);
+}
+
+// Lengths of 15 and over continue in bytes of 255 and a final byte below that
+static uint8_t* write_length(uint8_t* pOut, size_t length) {
+    for (; length >= 255; length -= 255) {
+        *pOut++ = 255;
+    }
+    *pOut++ = static_cast<uint8_t>(length);
+    return pOut;
+}
+
+//------------------------------------------------------------------------------------------
+//------------------------------------------------------------------------------------------
+size_t lz4_compress_bound(size_t bytes) {
+    return bytes + bytes / 255 + 16;
+}
+
+//------------------------------------------------------------------------------------------
+// Every position that is searched from goes into the table, whose entries are only hints,
+// a candidate is used once its four bytes match. Matches are extended backward over the
+// pending literals and forward as far as the format allows.
+//------------------------------------------------------------------------------------------
+size_t lz4_compress(const uint8_t* pSource, size_t bytes, uint8_t* pDestination, size_t capacity) {
+    if (bytes > 0x7E000000) {
+        throw std::runtime_error("Failed to compress, the input is over the LZ4 limit!");
+    }
+    const uint8_t* pIn = pSource;
+    const uint8_t* pAnchor = pSource;
+    const uint8_t* pEnd = pSource + bytes;
+    uint8_t* pOut = pDestination;
+    uint8_t* pOutEnd = pDestination + capacity;
+
+    if (bytes > MATCH_LIMIT) {
+        const uint8_t* pMatchStartLimit = pEnd - MATCH_LIMIT;
+        const uint8_t* pMatchEndLimit = pEnd - LAST_LITERALS;
+        uint32_t table[1 << HASH_BITS] = {};
+        pIn++;
+
+        while (true) {
+            const uint8_t* pMatch;
+            uint32_t searches = 1 << SKIP_TRIGGER;
+            while (true) {
+                if (pIn > pMatchStartLimit) {
+                    goto last_literals;
+                }
+                const uint32_t hash = hash4(read32(pIn));
+                pMatch = pSource + table[hash];
+                table[hash] = static_cast<uint32_t>(pIn - pSource);
+                if (pMatch < pIn && static_cast<size_t>(pIn - pMatch) <= MAX_OFFSET && read32(pMatch) == read32(pIn)) {
+                    break;
+                }
+                pIn += searches++ >> SKIP_TRIGGER;
+            }
+            while (pIn > pAnchor && pMatch > pSource && pIn[-1] == pMatch[-1]) {
+                pIn--;
+                pMatch--;
+            }
+            const size_t matchLength = MIN_MATCH + count_matching(pIn + MIN_MATCH, pMatch + MIN_MATCH, pMatchEndLimit);
+
+            const size_t literalCount = static_cast<size_t>(pIn - pAnchor);
+            const size_t sequenceBytes = 1 + literalCount / 255 + 1 + literalCount + 2 + (matchLength - MIN_MATCH) / 255 + 1;
+            if (static_cast<size_t>(pOutEnd - pOut) < sequenceBytes) {
+                return 0;
+            }
+            uint8_t* pToken = pOut++;
+            if (literalCount >= 15) {
+                *pToken = 15 << 4;
+                pOut = write_length(pOut, literalCount - 15);
+            }
+            else {
+                *pToken = static_cast<uint8_t>(literalCount << 4);
+            }
+            memcpy(pOut, pAnchor, literalCount);
+            pOut += literalCount;
+            const size_t offset = static_cast<size_t>(pIn - pMatch);
+            *pOut++ = static_cast<uint8_t>(offset);
+            *pOut++ = static_cast<uint8_t>(offset >> 8);
+            if (matchLength - MIN_MATCH >= 15) {
+                *pToken |= 15;
+                pOut = write_length(pOut, matchLength - MIN_MATCH - 15);
+            }
+            else {
+                *pToken |= static_cast<uint8_t>(matchLength - MIN_MATCH);
+            }
+
+            pIn += matchLength;
+            pAnchor = pIn;
+            if (pIn > pMatchStartLimit) {
+                break;
+            }
+            // The position just inside the match is a likely start for the next one
+            table[hash4(read32(pIn - 2))] = static_cast<uint32_t>(pIn - 2 - pSource);
+        }
+    }
+
+last_literals:
+    const size_t literalCount = static_cast<size_t>(pEnd - pAnchor);
+    if (static_cast<size_t>(pOutEnd - pOut) < 1 + literalCount / 255 + 1 + literalCount) {
+        return 0;
+    }
+    uint8_t* pToken = pOut++;
+    if (literalCount >= 15) {
+        *pToken = 15 << 4;
+        pOut = write_length(pOut, literalCount - 15);
+    }
+    else {
+        *pToken = static_cast<uint8_t>(literalCount << 4);
+    }
+    if (literalCount > 0) {
+        memcpy(pOut, pAnchor, literalCount);
+    }
+    pOut += literalCount;
+    return static_cast<size_t>(pOut - pDestination);
+}
+
+//------------------------------------------------------------------------------------------
+// Short literal runs and matches far enough back are copied 16 bytes at a time, which may
+// write past their end but never past the output, the next sequence overwrites the excess
+//------------------------------------------------------------------------------------------
+bool lz4_decompress(const uint8_t* pSource, size_t bytes, uint8_t* pDestination, size_t decompressedBytes) {
+    const uint8_t* pIn = pSource;
+    const uint8_t* pInEnd = pSource + bytes;
+    uint8_t* pOut = pDestination;
+    uint8_t* pOutEnd = pDestination + decompressedBytes;
+
+    while (pIn < pInEnd) {
+        const uint8_t token = *pIn++;
+        size_t literalCount = token >> 4;
+        if (literalCount == 15) {
+            uint8_t value;
+            do {
+                if (pIn >= pInEnd) {
+                    return false;
+                }
+                value = *pIn++;
+                literalCount += value;
+            } while (value == 255);
+        }
+        const size_t inLeft = static_cast<size_t>(pInEnd - pIn);
+        const size_t outLeft = static_cast<size_t>(pOutEnd - pOut);
+        if (literalCount > inLeft || literalCount > outLeft) {
+            return false;
+        }
+        if (literalCount <= COPY_BYTES && inLeft >= COPY_BYTES && outLeft >= COPY_BYTES) {
+            memcpy(pOut, pIn, COPY_BYTES);
+        }
+        else if (literalCount > 0) {
+            memcpy(pOut, pIn, literalCount);
+        }
+        pIn += literalCount;
+        pOut += literalCount;
+
+        // The last sequence has no match
+        if (pIn == pInEnd) {
+            break;
+        }
+        if (pInEnd - pIn < 2) {
+            return false;
+        }
+        const size_t offset = static_cast<size_t>(pIn[0]) | static_cast<size_t>(pIn[1]) << 8;
+        pIn += 2;
+        if (offset == 0 || offset > static_cast<size_t>(pOut - pDestination)) {
+            return false;
+        }
+        size_t matchLength = token & 15;
+        if (matchLength == 15) {
+            uint8_t value;
+            do {
+                if (pIn >= pInEnd) {
+                    return false;
+                }
+                value = *pIn++;
+                matchLength += value;
+            } while (value == 255);
+        }
+        matchLength += MIN_MATCH;
+        if (matchLength > static_cast<size_t>(pOutEnd - pOut)) {
+            return false;
+        }
+
+        const uint8_t* pMatch = pOut - offset;
+        if (offset >= COPY_BYTES && matchLength + COPY_BYTES <= static_cast<size_t>(pOutEnd - pOut)) {
+            for (size_t i = 0; i < matchLength; i += COPY_BYTES) {
+                memcpy(pOut + i, pMatch + i, COPY_BYTES);
+            }
+        }
+        else if (offset >= matchLength) {
+            memcpy(pOut, pMatch, matchLength);
+        }
+        else {
+            // Overlapping, the match repeats bytes it is writing
+            for (size_t i = 0; i < matchLength; i++) {
+                pOut[i] = pMatch[i];
+            }
+        }
+        pOut += matchLength;
+    }
+    return pOut == pOutEnd;
+}
@@ -0,0 +1,75 @@
+//======================================================================
+// MappedFile.cpp
+//
+// Keegan Kochis
+// Created: 2026/10/18
+// The definition of the MappedFile class.
+//======================================================================
+
+#include "MappedFile.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <cstddef>
+#include <cstdint>
+
+#include <stdexcept>
+#include <string>
+
+MappedFile::MappedFile() {
+}
+
+MappedFile::~MappedFile() {
+    close();
+}
+
+//------------------------------------------------------------------------------------------
+// The mapping stays valid after the descriptor is closed. The whole file is about to be
+// read front to back, so the kernel is asked to start reading it ahead right away.
+//------------------------------------------------------------------------------------------
+void MappedFile::open(const std::string& path) {
+    close();
+
+    const int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        throw std::runtime_error("Failed to open file " + path + "!");
+    }
+
+    struct stat status;
+    if (fstat(fd, &status) != 0 || status.st_size <= 0) {
+        ::close(fd);
+        throw std::runtime_error("Failed to map empty file " + path + "!");
+    }
+
+    const size_t size = static_cast<size_t>(status.st_size);
+    void* pData = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if (pData == MAP_FAILED) {
+        throw std::runtime_error("Failed to map file " + path + "!");
+    }
+    madvise(pData, size, MADV_WILLNEED);
+
+    mpData = static_cast<const uint8_t*>(pData);
+    mSize = size;
+    mPath = path;
+}
+
+//------------------------------------------------------------------------------------------
+//------------------------------------------------------------------------------------------
+void MappedFile::close() {
+    if (mpData) {
+        munmap(const_cast<uint8_t*>(mpData), mSize);
+    }
+    mpData = nullptr;
+    mSize = 0;
+    mPath.clear();
+}
+
+//------------------------------------------------------------------------------------------
+//------------------------------------------------------------------------------------------
+bool MappedFile::contains(const FileRange& range, uint64_t alignment) const {
+    return range.offset % alignment == 0 && range.offset <= mSize && range.bytes <= mSize - range.offset;
+}
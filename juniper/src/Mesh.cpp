@@ -0,0 +1,224 @@
+//======================================================================
+// Mesh.cpp
+//
+// Keegan Kochis
+// Created: 2026/10/18
+// Vertex layout descriptions and CPU side mesh generation.
+//======================================================================
+
+#include "Mesh.h"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#define GLFW_INCLUDE_VULKAN
+#include <GLFW/glfw3.h>
+
+#define GLM_FORCE_RADIANS
+#define GLM_FORCE_DEPTH_ZERO_TO_ONE
+#include <glm/common.hpp>
+#include <glm/geometric.hpp>
+#include <glm/vec3.hpp>
+#include <glm/vec4.hpp>
+
+// instanced_quantized.vert reads a vec4 at location 0 and a vec2 at location 1
+static_assert(sizeof(QuantizedVertex) == 12 && offsetof(QuantizedVertex, position) == 0 &&
+              offsetof(QuantizedVertex, normal) == 8, "The quantized vertex layout changed, update its vertex shader");
+
+//------------------------------------------------------------------------------------------
+//------------------------------------------------------------------------------------------
+VkVertexInputBindingDescription Vertex_t::get_binding_description() {
+    VkVertexInputBindingDescription bindingDescription{};
+    bindingDescription.binding = 0;
+    bindingDescription.stride = sizeof(Vertex);
+    bindingDescription.inputRate = VK_VERTEX_INPUT_RATE_VERTEX;
+
+    return bindingDescription;
+}
+
+//------------------------------------------------------------------------------------------
+//------------------------------------------------------------------------------------------
+std::array<VkVertexInputAttributeDescription, 2> Vertex_t::get_attribute_descriptions() {
+    std::array<VkVertexInputAttributeDescription, 2> attributeDescriptions{};
+
+    attributeDescriptions[0].binding = 0;
+    attributeDescriptions[0].location = 0;
+    attributeDescriptions[0].format = VK_FORMAT_R32G32B32_SFLOAT;
+    attributeDescriptions[0].offset = offsetof(Vertex, position);
+
+    attributeDescriptions[1].binding = 0;
+    attributeDescriptions[1].location = 1;
+    attributeDescriptions[1].format = VK_FORMAT_R32G32B32_SFLOAT;
+    attributeDescriptions[1].offset = offsetof(Vertex, normal);
+
+    return attributeDescriptions;
+}
+
+//------------------------------------------------------------------------------------------
+//------------------------------------------------------------------------------------------
+VkVertexInputBindingDescription QuantizedVertex_t::get_binding_description() {
+    VkVertexInputBindingDescription bindingDescription{};
+    bindingDescription.binding = 0;
+    bindingDescription.stride = sizeof(QuantizedVertex);
+    bindingDescription.inputRate = VK_VERTEX_INPUT_RATE_VERTEX;
+
+    return bindingDescription;
+}
+
+//------------------------------------------------------------------------------------------
+// The same locations as Vertex, the shader decodes the normal
+//------------------------------------------------------------------------------------------
+std::array<VkVertexInputAttributeDescription, 2> QuantizedVertex_t::get_attribute_descriptions() {
+    std::array<VkVertexInputAttributeDescription, 2> attributeDescriptions{};
+
+    attributeDescriptions[0].binding = 0;
+    attributeDescriptions[0].location = 0;
+    attributeDescriptions[0].format = VK_FORMAT_R16G16B16A16_UNORM;
+    attributeDescriptions[0].offset = offsetof(QuantizedVertex, position);
+
+    attributeDescriptions[1].binding = 0;
+    attributeDescriptions[1].location = 1;
+    attributeDescriptions[1].format = VK_FORMAT_R16G16_SNORM;
+    attributeDescriptions[1].offset = offsetof(QuantizedVertex, normal);
+
+    return attributeDescriptions;
+}
+
+//------------------------------------------------------------------------------------------
+//------------------------------------------------------------------------------------------
+VertexInputDescription get_vertex_input_description(VertexFormat format) {
+    VertexInputDescription description;
+    if (format == VERTEX_FORMAT_QUANTIZED) {
+        description.binding = QuantizedVertex::get_binding_description();
+        description.attributes = QuantizedVertex::get_attribute_descriptions();
+    }
+    else {
+        description.binding = Vertex::get_binding_description();
+        description.attributes = Vertex::get_attribute_descriptions();
+    }
+    return description;
+}
+
+//------------------------------------------------------------------------------------------
+//------------------------------------------------------------------------------------------
+uint32_t get_vertex_stride(VertexFormat format) {
+    return format == VERTEX_FORMAT_QUANTIZED ? sizeof(QuantizedVertex) : sizeof(Vertex);
+}
+
+//------------------------------------------------------------------------------------------
+// Each face gets its own four vertices so the normals stay flat
+//------------------------------------------------------------------------------------------
+MeshData_t MeshData_t::make_cube() {
+    const glm::vec3 normals[6] = {
+        { 1.0f, 0.0f, 0.0f }, { -1.0f, 0.0f, 0.0f },
+        { 0.0f, 1.0f, 0.0f }, { 0.0f, -1.0f, 0.0f },
+        { 0.0f, 0.0f, 1.0f }, { 0.0f, 0.0f, -1.0f }
+    };
+
+    MeshData mesh;
+    for (const glm::vec3& normal : normals) {
+        // Two axes spanning the face, ordered so the winding is counter clockwise seen from outside
+        glm::vec3 u = glm::vec3(normal.y, normal.z, normal.x);
+        glm::vec3 v = glm::cross(normal, u);
+
+        uint32_t base = static_cast<uint32_t>(mesh.vertices.size());
+        mesh.vertices.push_back({ 0.5f * (normal - u - v), normal });
+        mesh.vertices.push_back({ 0.5f * (normal + u - v), normal });
+        mesh.vertices.push_back({ 0.5f * (normal + u + v), normal });
+        mesh.vertices.push_back({ 0.5f * (normal - u + v), normal });
+
+        const uint32_t faceIndices[6] = { 0, 1, 2, 2, 3, 0 };
+        for (uint32_t index : faceIndices) {
+            mesh.indices.push_back(base + index);
+        }
+    }
+
+    return mesh;
+}
+
+//------------------------------------------------------------------------------------------
+// Rings run from the top pole to the bottom one. Each ring repeats its first vertex so the
+// seam needs no wrap around, and the degenerate triangles at the poles are skipped.
+//------------------------------------------------------------------------------------------
+MeshData_t MeshData_t::make_sphere(uint32_t segments, uint32_t rings) {
+    const float pi = 3.14159265358979f;
+
+    MeshData mesh;
+    for (uint32_t ring = 0; ring <= rings; ring++) {
+        const float phi = pi * ring / rings;
+        for (uint32_t segment = 0; segment <= segments; segment++) {
+            const float theta = 2.0f * pi * segment / segments;
+            glm::vec3 normal(std::sin(phi) * std::cos(theta), std::cos(phi), std::sin(phi) * std::sin(theta));
+            mesh.vertices.push_back({ 0.5f * normal, normal });
+        }
+    }
+
+    for (uint32_t ring = 0; ring < rings; ring++) {
+        for (uint32_t segment = 0; segment < segments; segment++) {
+            const uint32_t upper = ring * (segments + 1) + segment;
+            const uint32_t lower = upper + segments + 1;
+
+            if (ring != 0) {
+                mesh.indices.insert(mesh.indices.end(), { upper, upper + 1, lower });
+            }
+            if (ring != rings - 1) {
+                mesh.indices.insert(mesh.indices.end(), { upper + 1, lower + 1, lower });
+            }
+        }
+    }
+
+    return mesh;
+}
+
+//------------------------------------------------------------------------------------------
+// Centered on the bounding box, not minimal but good enough for culling
+//------------------------------------------------------------------------------------------
+glm::vec4 MeshData_t::compute_bounding_sphere() const {
+    if (vertices.empty()) {
+        return glm::vec4(0.0f);
+    }
+
+    glm::vec3 minimum = vertices[0].position;
+    glm::vec3 maximum = vertices[0].position;
+    for (const Vertex& vertex : vertices) {
+        minimum = glm::min(minimum, vertex.position);
+        maximum = glm::max(maximum, vertex.position);
+    }
+
+    glm::vec3 center = 0.5f * (minimum + maximum);
+    float radius = 0.0f;
+    for (const Vertex& vertex : vertices) {
+        radius = std::max(radius, glm::length(vertex.position - center));
+    }
+
+    return glm::vec4(center, radius);
+}
+
+//------------------------------------------------------------------------------------------
+//------------------------------------------------------------------------------------------
+MeshView MeshData_t::get_view() const {
+    MeshView view;
+    view.pVertices = vertices.data();
+    view.vertexCount = static_cast<uint32_t>(vertices.size());
+    view.vertexFormat = VERTEX_FORMAT_FLOAT;
+    view.dequantization = glm::vec4(0.0f, 0.0f, 0.0f, 1.0f);
+    view.pIndices = indices.data();
+    view.indexCount = static_cast<uint32_t>(indices.size());
+    view.boundingSphere = compute_bounding_sphere();
+    view.lodError = 0.0f;
+    return view;
+}
+
+//------------------------------------------------------------------------------------------
+//------------------------------------------------------------------------------------------
+MeshView get_lod_view(const MeshView& view, const MeshLodData& lod) {
+    MeshView lodView = view;
+    lodView.pIndices = lod.indices.data();
+    lodView.indexCount = static_cast<uint32_t>(lod.indices.size());
+    lodView.lodError = lod.error;
+    return lodView;
+}
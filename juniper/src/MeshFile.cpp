@@ -0,0 +1,279 @@
+//======================================================================
+// MeshFile.cpp
+//
+// Keegan Kochis
+// Created: 2026/10/18
+// The definition of the MeshFile class.
+//======================================================================
+
+#include "MeshFile.h"
+#include "MeshQuantize.h"
+
+#include <cstdint>
+#include <cstring>
+
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#define GLM_FORCE_RADIANS
+#define GLM_FORCE_DEPTH_ZERO_TO_ONE
+#include <glm/common.hpp>
+#include <glm/vec3.hpp>
+#include <glm/vec4.hpp>
+
+static_assert(sizeof(MeshFileHeader) == 208, "The mesh file header layout changed, bump MeshFile::VERSION");
+static_assert(sizeof(MeshFileLod) == 48, "The mesh file level layout changed, bump MeshFile::VERSION");
+static_assert(sizeof(Meshlet) == 48, "The meshlet layout changed, bump MeshFile::VERSION");
+
+static uint64_t align_offset(uint64_t offset) {
+    return (offset + MeshFile::ALIGNMENT - 1) & ~(MeshFile::ALIGNMENT - 1);
+}
+
+MeshFile::MeshFile() {
+}
+
+MeshFile::~MeshFile() {
+    close();
+}
+
+//------------------------------------------------------------------------------------------
+// The header, levels and meshlet ranges are checked, the streams are used as they are
+//------------------------------------------------------------------------------------------
+void MeshFile::open(const std::string& path) {
+    close();
+    mFile.open(path);
+    try {
+        validate();
+    }
+    catch (...) {
+        mFile.close();
+        throw;
+    }
+
+    mpHeader = reinterpret_cast<const MeshFileHeader*>(mFile.get_data());
+    mpLods = static_cast<const MeshFileLod*>(get_section(MESH_FILE_SECTION_LODS));
+    mpVertices = get_section(MESH_FILE_SECTION_VERTICES);
+    mpIndices = static_cast<const uint32_t*>(get_section(MESH_FILE_SECTION_INDICES));
+    mpMeshlets = static_cast<const Meshlet*>(get_section(MESH_FILE_SECTION_MESHLETS));
+    mpMeshletVertices = static_cast<const uint32_t*>(get_section(MESH_FILE_SECTION_MESHLET_VERTICES));
+    mpMeshletTriangles = static_cast<const uint8_t*>(get_section(MESH_FILE_SECTION_MESHLET_TRIANGLES));
+}
+
+//------------------------------------------------------------------------------------------
+//------------------------------------------------------------------------------------------
+void MeshFile::close() {
+    mFile.close();
+    mpHeader = nullptr;
+    mpLods = nullptr;
+    mpVertices = nullptr;
+    mpIndices = nullptr;
+    mpMeshlets = nullptr;
+    mpMeshletVertices = nullptr;
+    mpMeshletTriangles = nullptr;
+}
+
+//------------------------------------------------------------------------------------------
+//------------------------------------------------------------------------------------------
+MeshView MeshFile::get_view(uint32_t lod) const {
+    const MeshFileLod& level = mpLods[lod];
+
+    MeshView view;
+    view.pVertices = mpVertices;
+    view.vertexCount = mpHeader->vertexCount;
+    view.vertexFormat = static_cast<VertexFormat>(mpHeader->vertexFormat);
+    view.dequantization = mpHeader->dequantization;
+    view.pIndices = mpIndices + level.firstIndex;
+    view.indexCount = level.indexCount;
+    view.boundingSphere = mpHeader->boundingSphere;
+    view.lodError = level.error;
+    return view;
+}
+
+//------------------------------------------------------------------------------------------
+//------------------------------------------------------------------------------------------
+MeshletView MeshFile::get_meshlet_view(uint32_t lod) const {
+    const MeshFileLod& level = mpLods[lod];
+
+    MeshletView view;
+    view.pMeshlets = mpMeshlets + level.firstMeshlet;
+    view.meshletCount = level.meshletCount;
+    view.pVertices = mpMeshletVertices + level.firstMeshletVertex;
+    view.vertexCount = level.meshletVertexCount;
+    view.pTriangles = mpMeshletTriangles + level.firstMeshletTriangle;
+    view.triangleBytes = level.meshletTriangleBytes;
+    return view;
+}
+
+//------------------------------------------------------------------------------------------
+// The sections are written in the order of MeshFileSection, each padded to the alignment
+//------------------------------------------------------------------------------------------
+void MeshFile::write(const std::string& path, const MeshData& mesh, const std::vector<MeshLodData>& coarserLods,
+                     VertexFormat vertexFormat) {
+    std::vector<MeshFileLod> lods;
+    std::vector<uint32_t> indices;
+    MeshletData meshlets;
+
+    MeshData levelMesh;
+    levelMesh.vertices = mesh.vertices;
+    for (size_t i = 0; i <= coarserLods.size(); i++) {
+        levelMesh.indices = i == 0 ? mesh.indices : coarserLods[i - 1].indices;
+        const MeshletData levelMeshlets = MeshletData::build(levelMesh, MESHLET_MAX_VERTICES, MESHLET_MAX_TRIANGLES);
+
+        MeshFileLod lod = {};
+        lod.firstIndex = static_cast<uint32_t>(indices.size());
+        lod.indexCount = static_cast<uint32_t>(levelMesh.indices.size());
+        lod.firstMeshlet = static_cast<uint32_t>(meshlets.meshlets.size());
+        lod.meshletCount = static_cast<uint32_t>(levelMeshlets.meshlets.size());
+        lod.firstMeshletVertex = static_cast<uint32_t>(meshlets.vertices.size());
+        lod.meshletVertexCount = static_cast<uint32_t>(levelMeshlets.vertices.size());
+        lod.firstMeshletTriangle = static_cast<uint32_t>(meshlets.triangles.size());
+        lod.meshletTriangleBytes = static_cast<uint32_t>(levelMeshlets.triangles.size());
+        lod.error = i == 0 ? 0.0f : coarserLods[i - 1].error;
+        lods.push_back(lod);
+
+        indices.insert(indices.end(), levelMesh.indices.begin(), levelMesh.indices.end());
+        meshlets.meshlets.insert(meshlets.meshlets.end(), levelMeshlets.meshlets.begin(), levelMeshlets.meshlets.end());
+        meshlets.vertices.insert(meshlets.vertices.end(), levelMeshlets.vertices.begin(), levelMeshlets.vertices.end());
+        meshlets.triangles.insert(meshlets.triangles.end(), levelMeshlets.triangles.begin(), levelMeshlets.triangles.end());
+    }
+
+    MeshFileHeader header;
+    memset(&header, 0, sizeof(header));
+    header.magic = MAGIC;
+    header.version = VERSION;
+    header.vertexStride = get_vertex_stride(vertexFormat);
+    header.vertexFormat = vertexFormat;
+    header.lodCount = static_cast<uint32_t>(lods.size());
+    header.vertexCount = static_cast<uint32_t>(mesh.vertices.size());
+    header.indexCount = static_cast<uint32_t>(indices.size());
+    header.meshletCount = static_cast<uint32_t>(meshlets.meshlets.size());
+    header.meshletVertexCount = static_cast<uint32_t>(meshlets.vertices.size());
+    header.meshletTriangleBytes = static_cast<uint32_t>(meshlets.triangles.size());
+    header.boundingSphere = mesh.compute_bounding_sphere();
+    if (!mesh.vertices.empty()) {
+        glm::vec3 minimum = mesh.vertices[0].position;
+        glm::vec3 maximum = minimum;
+        for (const Vertex& vertex : mesh.vertices) {
+            minimum = glm::min(minimum, vertex.position);
+            maximum = glm::max(maximum, vertex.position);
+        }
+        header.boundsMin = glm::vec4(minimum, 0.0f);
+        header.boundsMax = glm::vec4(maximum, 0.0f);
+    }
+
+    const void* pVertices = mesh.vertices.data();
+    std::vector<QuantizedVertex> quantizedVertices;
+    header.dequantization = glm::vec4(0.0f, 0.0f, 0.0f, 1.0f);
+    if (vertexFormat == VERTEX_FORMAT_QUANTIZED) {
+        header.dequantization = compute_dequantization(mesh.vertices);
+        quantizedVertices.reserve(mesh.vertices.size());
+        for (const Vertex& vertex : mesh.vertices) {
+            quantizedVertices.push_back(quantize_vertex(vertex, header.dequantization));
+        }
+        pVertices = quantizedVertices.data();
+    }
+
+    const void* sectionData[MESH_FILE_SECTION_COUNT] = {
+        lods.data(), pVertices, indices.data(),
+        meshlets.meshlets.data(), meshlets.vertices.data(), meshlets.triangles.data()
+    };
+    const uint64_t sectionBytes[MESH_FILE_SECTION_COUNT] = {
+        lods.size() * sizeof(MeshFileLod), mesh.vertices.size() * header.vertexStride, indices.size() * sizeof(uint32_t),
+        meshlets.meshlets.size() * sizeof(Meshlet), meshlets.vertices.size() * sizeof(uint32_t), meshlets.triangles.size()
+    };
+
+    uint64_t offset = align_offset(sizeof(MeshFileHeader));
+    for (uint32_t i = 0; i < MESH_FILE_SECTION_COUNT; i++) {
+        header.sections[i].offset = offset;
+        header.sections[i].bytes = sectionBytes[i];
+        offset = align_offset(offset + sectionBytes[i]);
+    }
+
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    if (!file.is_open()) {
+        throw std::runtime_error("Failed to create mesh file " + path + "!");
+    }
+
+    const char zeros[ALIGNMENT] = {};
+    file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    uint64_t written = sizeof(header);
+    for (uint32_t i = 0; i < MESH_FILE_SECTION_COUNT; i++) {
+        file.write(zeros, static_cast<std::streamsize>(header.sections[i].offset - written));
+        file.write(static_cast<const char*>(sectionData[i]), static_cast<std::streamsize>(sectionBytes[i]));
+        written = header.sections[i].offset + sectionBytes[i];
+    }
+    file.write(zeros, static_cast<std::streamsize>(offset - written));
+
+    if (!file.good()) {
+        throw std::runtime_error("Failed to write mesh file " + path + "!");
+    }
+}
+
+//------------------------------------------------------------------------------------------
+// Every range the views hand out has to stay inside the file, so a truncated or corrupt
+// file is rejected here instead of faulting in the renderer. The index values themselves
+// aren't checked, the GPU only reads vertices through them.
+//------------------------------------------------------------------------------------------
+void MeshFile::validate() const {
+    const std::string& path = mFile.get_path();
+    const uint64_t fileBytes = mFile.get_size();
+    if (fileBytes < sizeof(MeshFileHeader)) {
+        throw std::runtime_error("Failed to load mesh file " + path + ", it's truncated!");
+    }
+
+    const MeshFileHeader& header = *reinterpret_cast<const MeshFileHeader*>(mFile.get_data());
+    if (header.magic != MAGIC) {
+        throw std::runtime_error("Failed to load mesh file " + path + ", it's not a mesh file!");
+    }
+    if (header.version != VERSION || header.vertexFormat >= VERTEX_FORMAT_COUNT ||
+        header.vertexStride != get_vertex_stride(static_cast<VertexFormat>(header.vertexFormat))) {
+        throw std::runtime_error("Failed to load mesh file " + path + ", it needs recooking!");
+    }
+
+    const uint64_t elementBytes[MESH_FILE_SECTION_COUNT] = {
+        sizeof(MeshFileLod), header.vertexStride, sizeof(uint32_t), sizeof(Meshlet), sizeof(uint32_t), 1
+    };
+    const uint64_t elementCounts[MESH_FILE_SECTION_COUNT] = {
+        header.lodCount, header.vertexCount, header.indexCount,
+        header.meshletCount, header.meshletVertexCount, header.meshletTriangleBytes
+    };
+    for (uint32_t i = 0; i < MESH_FILE_SECTION_COUNT; i++) {
+        const FileRange& range = header.sections[i];
+        if (!mFile.contains(range, ALIGNMENT) || range.bytes != elementBytes[i] * elementCounts[i]) {
+            throw std::runtime_error("Failed to load mesh file " + path + ", a section is out of bounds!");
+        }
+    }
+    if (header.lodCount == 0) {
+        throw std::runtime_error("Failed to load mesh file " + path + ", it has no levels!");
+    }
+
+    const MeshFileLod* pLods = reinterpret_cast<const MeshFileLod*>(mFile.get_range(header.sections[MESH_FILE_SECTION_LODS]));
+    for (uint32_t i = 0; i < header.lodCount; i++) {
+        const MeshFileLod& lod = pLods[i];
+        if (static_cast<uint64_t>(lod.firstIndex) + lod.indexCount > header.indexCount ||
+            static_cast<uint64_t>(lod.firstMeshlet) + lod.meshletCount > header.meshletCount ||
+            static_cast<uint64_t>(lod.firstMeshletVertex) + lod.meshletVertexCount > header.meshletVertexCount ||
+            static_cast<uint64_t>(lod.firstMeshletTriangle) + lod.meshletTriangleBytes > header.meshletTriangleBytes ||
+            lod.firstMeshletTriangle % 4 != 0) {
+            throw std::runtime_error("Failed to load mesh file " + path + ", a level is out of bounds!");
+        }
+
+        // The vertex path expands the meshlets on the CPU, reading through their offsets
+        const Meshlet* pMeshlets = reinterpret_cast<const Meshlet*>(mFile.get_range(header.sections[MESH_FILE_SECTION_MESHLETS]));
+        for (uint32_t j = lod.firstMeshlet; j < lod.firstMeshlet + lod.meshletCount; j++) {
+            const Meshlet& meshlet = pMeshlets[j];
+            if (static_cast<uint64_t>(meshlet.vertexOffset) + meshlet.vertexCount > lod.meshletVertexCount ||
+                static_cast<uint64_t>(meshlet.triangleOffset) + 3ull * meshlet.triangleCount > lod.meshletTriangleBytes) {
+                throw std::runtime_error("Failed to load mesh file " + path + ", a meshlet is out of bounds!");
+            }
+        }
+    }
+}
+
+//------------------------------------------------------------------------------------------
+//------------------------------------------------------------------------------------------
+const void* MeshFile::get_section(MeshFileSection section) const {
+    return mFile.get_range(mpHeader->sections[section]);
+}
@@ -0,0 +1,146 @@
+//======================================================================
+// MeshImport.cpp
+//
+// Keegan Kochis
+// Created: 2026/10/18
+// Importers of source mesh formats.
+//======================================================================
+
+#include "MeshImport.h"
+
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#define GLM_FORCE_RADIANS
+#define GLM_FORCE_DEPTH_ZERO_TO_ONE
+#include <glm/geometric.hpp>
+#include <glm/vec3.hpp>
+
+static const uint32_t NO_NORMAL = 0xFFFFFFFF;
+
+//------------------------------------------------------------------------------------------
+// OBJ indices are one based, negative ones count back from the latest element
+//------------------------------------------------------------------------------------------
+static uint32_t resolve_obj_index(long index, size_t count, const std::string& path) {
+    const long resolved = index < 0 ? static_cast<long>(count) + index : index - 1;
+    if (resolved < 0 || resolved >= static_cast<long>(count)) {
+        throw std::runtime_error("Failed to import " + path + ", a face index is out of range!");
+    }
+    return static_cast<uint32_t>(resolved);
+}
+
+//------------------------------------------------------------------------------------------
+// Texture coordinates, groups and materials are skipped, the vertex layout has no use
+// for them yet
+//------------------------------------------------------------------------------------------
+MeshData import_obj(const std::string& path) {
+    std::ifstream file(path);
+    if (!file.is_open()) {
+        throw std::runtime_error("Failed to open file " + path + "!");
+    }
+
+    std::vector<glm::vec3> positions;
+    std::vector<glm::vec3> normals;
+    std::unordered_map<uint64_t, uint32_t> vertexLookup;
+    std::vector<uint32_t> face;
+    bool missingNormals = false;
+    MeshData mesh;
+
+    std::string line;
+    while (std::getline(file, line)) {
+        const char* pCursor = line.c_str();
+        char* pEnd = nullptr;
+
+        if (strncmp(pCursor, "v ", 2) == 0 || strncmp(pCursor, "vn ", 3) == 0) {
+            const bool normal = pCursor[1] == 'n';
+            pCursor += normal ? 3 : 2;
+            glm::vec3 value;
+            for (uint32_t i = 0; i < 3; i++) {
+                value[i] = strtof(pCursor, &pEnd);
+                pCursor = pEnd;
+            }
+            (normal ? normals : positions).push_back(value);
+        }
+        else if (strncmp(pCursor, "f ", 2) == 0) {
+            pCursor += 2;
+            face.clear();
+            while (true) {
+                const long positionIndex = strtol(pCursor, &pEnd, 10);
+                if (pEnd == pCursor) {
+                    break;
+                }
+                pCursor = pEnd;
+
+                uint32_t normal = NO_NORMAL;
+                if (*pCursor == '/') {
+                    pCursor++;
+                    strtol(pCursor, &pEnd, 10);
+                    pCursor = pEnd;
+                    if (*pCursor == '/') {
+                        pCursor++;
+                        normal = resolve_obj_index(strtol(pCursor, &pEnd, 10), normals.size(), path);
+                        pCursor = pEnd;
+                    }
+                }
+                const uint32_t position = resolve_obj_index(positionIndex, positions.size(), path);
+                missingNormals |= normal == NO_NORMAL;
+
+                const uint64_t key = (static_cast<uint64_t>(position) << 32) | normal;
+                auto it = vertexLookup.find(key);
+                if (it == vertexLookup.end()) {
+                    Vertex vertex;
+                    vertex.position = positions[position];
+                    vertex.normal = normal == NO_NORMAL ? glm::vec3(0.0f) : normals[normal];
+                    it = vertexLookup.emplace(key, static_cast<uint32_t>(mesh.vertices.size())).first;
+                    mesh.vertices.push_back(vertex);
+                }
+                face.push_back(it->second);
+            }
+
+            for (size_t i = 2; i < face.size(); i++) {
+                mesh.indices.push_back(face[0]);
+                mesh.indices.push_back(face[i - 1]);
+                mesh.indices.push_back(face[i]);
+            }
+        }
+    }
+
+    if (mesh.indices.empty()) {
+        throw std::runtime_error("Failed to import " + path + ", it has no faces!");
+    }
+
+    // Area weighted face normals summed per position, so vertices split by other
+    // attributes still end up with the same normal
+    if (missingNormals) {
+        std::vector<glm::vec3> positionNormals(positions.size(), glm::vec3(0.0f));
+        std::vector<uint32_t> vertexPositions(mesh.vertices.size());
+        for (const auto& entry : vertexLookup) {
+            vertexPositions[entry.second] = static_cast<uint32_t>(entry.first >> 32);
+        }
+        for (size_t i = 0; i < mesh.indices.size(); i += 3) {
+            const glm::vec3& a = mesh.vertices[mesh.indices[i]].position;
+            const glm::vec3& b = mesh.vertices[mesh.indices[i + 1]].position;
+            const glm::vec3& c = mesh.vertices[mesh.indices[i + 2]].position;
+            const glm::vec3 faceNormal = glm::cross(b - a, c - a);
+            for (size_t j = 0; j < 3; j++) {
+                positionNormals[vertexPositions[mesh.indices[i + j]]] += faceNormal;
+            }
+        }
+        for (size_t i = 0; i < mesh.vertices.size(); i++) {
+            Vertex& vertex = mesh.vertices[i];
+            const glm::vec3& normal = positionNormals[vertexPositions[i]];
+            if (vertex.normal == glm::vec3(0.0f) && glm::dot(normal, normal) > 0.0f) {
+                vertex.normal = glm::normalize(normal);
+            }
+        }
+    }
+
+    return mesh;
+}
@@ -0,0 +1,477 @@
+//======================================================================
+// MeshOptimize.cpp
+//
+// Keegan Kochis
+// Created: 2026/10/18
+// Vertex cache, overdraw and vertex fetch optimization and analysis.
+//======================================================================
+
+#include "MeshOptimize.h"
+
+#include <cmath>
+#include <cstdint>
+
+#include <algorithm>
+#include <limits>
+#include <vector>
+
+#define GLM_FORCE_RADIANS
+#define GLM_FORCE_DEPTH_ZERO_TO_ONE
+#include <glm/common.hpp>
+#include <glm/geometric.hpp>
+#include <glm/vec2.hpp>
+#include <glm/vec3.hpp>
+
+static const uint32_t UNUSED_VERTEX = 0xFFFFFFFF;
+
+// Forsyth's scoring, the cache is larger than the hardware's since it only ranks vertices
+static const uint32_t SCORE_CACHE_SIZE = 32;
+static const uint32_t SCORE_MAX_VALENCE = 32;
+static const float CACHE_DECAY_POWER = 1.5f;
+static const float LAST_TRIANGLE_SCORE = 0.75f;
+static const float VALENCE_BOOST_SCALE = 2.0f;
+static const float VALENCE_BOOST_POWER = 0.5f;
+
+static const uint32_t FETCH_LINE_BYTES = 64;
+static const uint32_t FETCH_LINE_COUNT = 256;
+
+static const uint32_t OVERDRAW_RESOLUTION = 256;
+
+//------------------------------------------------------------------------------------------
+// A FIFO of vertices stamped with when they entered it, so resetting it is one addition
+//------------------------------------------------------------------------------------------
+struct FifoCache_t {
+    std::vector<uint32_t> timestamps;
+    uint32_t timestamp;
+    uint32_t size;
+
+    FifoCache_t(uint32_t vertexCount, uint32_t cacheSize) : timestamps(vertexCount, 0), timestamp(cacheSize + 1), size(cacheSize) {}
+
+    void reset() { timestamp += size + 1; }
+
+    // Returns the number of vertices that missed
+    uint32_t access(uint32_t vertex) {
+        if (timestamp - timestamps[vertex] > size) {
+            timestamps[vertex] = timestamp++;
+            return 1;
+        }
+        return 0;
+    }
+
+    uint32_t access_triangle(const uint32_t* pTriangle) {
+        return access(pTriangle[0]) + access(pTriangle[1]) + access(pTriangle[2]);
+    }
+}; typedef FifoCache_t FifoCache;
+
+//------------------------------------------------------------------------------------------
+//------------------------------------------------------------------------------------------
+static uint32_t count_referenced_vertices(const std::vector<uint32_t>& indices, uint32_t vertexCount) {
+    std::vector<uint8_t> referenced(vertexCount, 0);
+    uint32_t count = 0;
+    for (uint32_t index : indices) {
+        count += referenced[index] == 0;
+        referenced[index] = 1;
+    }
+    return count;
+}
+
+//------------------------------------------------------------------------------------------
+//------------------------------------------------------------------------------------------
+VertexCacheStats analyze_vertex_cache(const std::vector<uint32_t>& indices, uint32_t vertexCount, uint32_t cacheSize) {
+    VertexCacheStats stats = {};
+    FifoCache cache(vertexCount, cacheSize);
+    const uint32_t triangleCount = static_cast<uint32_t>(indices.size() / 3);
+    for (uint32_t i = 0; i < triangleCount; i++) {
+        stats.transformedVertices += cache.access_triangle(&indices[3 * i]);
+    }
+
+    const uint32_t referencedVertices = count_referenced_vertices(indices, vertexCount);
+    stats.acmr = triangleCount > 0 ? static_cast<float>(stats.transformedVertices) / triangleCount : 0.0f;
+    stats.atvr = referencedVertices > 0 ? static_cast<float>(stats.transformedVertices) / referencedVertices : 0.0f;
+    return stats;
+}
+
+//------------------------------------------------------------------------------------------
+// The line cache is direct mapped, close enough to the set associative caches of GPUs for
+// comparing vertex orders
+//------------------------------------------------------------------------------------------
+VertexFetchStats analyze_vertex_fetch(const std::vector<uint32_t>& indices, uint32_t vertexCount, uint32_t vertexBytes) {
+    VertexFetchStats stats = {};
+    FifoCache cache(vertexCount, VERTEX_CACHE_SIZE);
+    // Line tags plus one, so the zeroed lines start out empty
+    std::vector<uint64_t> lines(FETCH_LINE_COUNT, 0);
+    for (uint32_t index : indices) {
+        if (!cache.access(index)) {
+            continue;
+        }
+        const uint64_t firstLine = static_cast<uint64_t>(index) * vertexBytes / FETCH_LINE_BYTES;
+        const uint64_t lastLine = (static_cast<uint64_t>(index + 1) * vertexBytes - 1) / FETCH_LINE_BYTES;
+        for (uint64_t line = firstLine; line <= lastLine; line++) {
+            uint64_t& slot = lines[line % FETCH_LINE_COUNT];
+            if (slot != line + 1) {
+                slot = line + 1;
+                stats.bytesFetched += FETCH_LINE_BYTES;
+            }
+        }
+    }
+
+    const uint64_t referencedBytes = static_cast<uint64_t>(count_referenced_vertices(indices, vertexCount)) * vertexBytes;
+    stats.overfetch = referencedBytes > 0 ? static_cast<float>(stats.bytesFetched) / referencedBytes : 0.0f;
+    return stats;
+}
+
+//------------------------------------------------------------------------------------------
+// Whether an edge of a counterclockwise triangle is a top or left edge, which own the pixel
+// centers exactly on them so shared edges aren't drawn twice
+//------------------------------------------------------------------------------------------
+static bool is_top_left(const glm::vec2& from, const glm::vec2& to) {
+    return (from.y == to.y && to.x < from.x) || to.y < from.y;
+}
+
+//------------------------------------------------------------------------------------------
+// Orthographic views fitted to the mesh's bounds. Looking along an axis, the faces whose
+// normals point back at the viewer are drawn and the rest culled like the pipeline does.
+//------------------------------------------------------------------------------------------
+OverdrawStats analyze_overdraw(const std::vector<uint32_t>& indices, const std::vector<Vertex>& vertices) {
+    OverdrawStats stats = {};
+    if (indices.empty()) {
+        return stats;
+    }
+
+    glm::vec3 minimum = vertices[indices[0]].position;
+    glm::vec3 maximum = minimum;
+    for (uint32_t index : indices) {
+        minimum = glm::min(minimum, vertices[index].position);
+        maximum = glm::max(maximum, vertices[index].position);
+    }
+    const glm::vec3 extent = maximum - minimum;
+    const float scale = static_cast<float>(OVERDRAW_RESOLUTION) / std::max(std::max(extent.x, extent.y), std::max(extent.z, 1e-20f));
+
+    const float FAR_DEPTH = std::numeric_limits<float>::max();
+    std::vector<float> depths(OVERDRAW_RESOLUTION * OVERDRAW_RESOLUTION);
+    for (uint32_t view = 0; view < 6; view++) {
+        const uint32_t axis = view / 2;
+        const float direction = view % 2 == 0 ? 1.0f : -1.0f;
+        std::fill(depths.begin(), depths.end(), FAR_DEPTH);
+
+        for (size_t i = 0; i + 2 < indices.size(); i += 3) {
+            glm::vec2 points[3];
+            float depth[3];
+            for (uint32_t j = 0; j < 3; j++) {
+                const glm::vec3 position = (vertices[indices[i + j]].position - minimum) * scale;
+                points[j] = glm::vec2(position[(axis + 1) % 3], position[(axis + 2) % 3]);
+                // Viewed from the positive side the largest coordinate is the closest
+                depth[j] = -direction * position[axis];
+            }
+            const float area = (points[1].x - points[0].x) * (points[2].y - points[0].y) -
+                               (points[1].y - points[0].y) * (points[2].x - points[0].x);
+            // The two view axes are flipped when looking from the negative side
+            if (direction * area <= 0.0f) {
+                continue;
+            }
+            if (area < 0.0f) {
+                std::swap(points[1], points[2]);
+                std::swap(depth[1], depth[2]);
+            }
+            const float inverseArea = 1.0f / std::abs(area);
+
+            const glm::vec2 low = glm::min(points[0], glm::min(points[1], points[2]));
+            const glm::vec2 high = glm::max(points[0], glm::max(points[1], points[2]));
+            const int32_t maxPixel = static_cast<int32_t>(OVERDRAW_RESOLUTION) - 1;
+            const int32_t x0 = std::max(static_cast<int32_t>(std::floor(low.x)), 0);
+            const int32_t y0 = std::max(static_cast<int32_t>(std::floor(low.y)), 0);
+            const int32_t x1 = std::min(static_cast<int32_t>(std::ceil(high.x)), maxPixel);
+            const int32_t y1 = std::min(static_cast<int32_t>(std::ceil(high.y)), maxPixel);
+            for (int32_t y = y0; y <= y1; y++) {
+                for (int32_t x = x0; x <= x1; x++) {
+                    const glm::vec2 center(x + 0.5f, y + 0.5f);
+                    float weights[3];
+                    bool inside = true;
+                    for (uint32_t j = 0; j < 3 && inside; j++) {
+                        const glm::vec2& from = points[(j + 1) % 3];
+                        const glm::vec2& to = points[(j + 2) % 3];
+                        weights[j] = (to.x - from.x) * (center.y - from.y) - (to.y - from.y) * (center.x - from.x);
+                        inside = weights[j] > 0.0f || (weights[j] == 0.0f && is_top_left(from, to));
+                    }
+                    if (!inside) {
+                        continue;
+                    }
+
+                    const float z = (weights[0] * depth[0] + weights[1] * depth[1] + weights[2] * depth[2]) * inverseArea;
+                    float& stored = depths[y * OVERDRAW_RESOLUTION + x];
+                    if (z < stored) {
+                        stored = z;
+                        stats.pixelsShaded++;
+                    }
+                }
+            }
+        }
+
+        for (float depth : depths) {
+            stats.pixelsCovered += depth != FAR_DEPTH;
+        }
+    }
+
+    stats.overdraw = stats.pixelsCovered > 0 ? static_cast<float>(stats.pixelsShaded) / stats.pixelsCovered : 0.0f;
+    return stats;
+}
+
+//------------------------------------------------------------------------------------------
+// Higher for vertices near the front of the cache and for vertices with few triangles left,
+// which finishes them off before they're evicted. Vertices without triangles score nothing.
+//------------------------------------------------------------------------------------------
+struct VertexScoreTable_t {
+    float cache[SCORE_CACHE_SIZE];
+    float valence[SCORE_MAX_VALENCE + 1];
+
+    VertexScoreTable_t() {
+        for (uint32_t i = 0; i < SCORE_CACHE_SIZE; i++) {
+            // The last triangle's vertices are scored lower so it's not simply repeated
+            const float scaler = 1.0f / (SCORE_CACHE_SIZE - 3);
+            cache[i] = i < 3 ? LAST_TRIANGLE_SCORE : std::pow(1.0f - (i - 3) * scaler, CACHE_DECAY_POWER);
+        }
+        valence[0] = 0.0f;
+        for (uint32_t i = 1; i <= SCORE_MAX_VALENCE; i++) {
+            valence[i] = VALENCE_BOOST_SCALE * std::pow(static_cast<float>(i), -VALENCE_BOOST_POWER);
+        }
+    }
+
+    float score(int32_t cachePosition, uint32_t remainingTriangles) const {
+        if (remainingTriangles == 0) {
+            return -1.0f;
+        }
+        return (cachePosition >= 0 ? cache[cachePosition] : 0.0f) + valence[std::min(remainingTriangles, SCORE_MAX_VALENCE)];
+    }
+}; typedef VertexScoreTable_t VertexScoreTable;
+
+//------------------------------------------------------------------------------------------
+// Each step emits the best scoring triangle touching the cache. When none is left the next
+// unemitted triangle in the old order continues.
+//------------------------------------------------------------------------------------------
+void optimize_vertex_cache(std::vector<uint32_t>& indices, uint32_t vertexCount) {
+    const uint32_t triangleCount = static_cast<uint32_t>(indices.size() / 3);
+    if (triangleCount == 0) {
+        return;
+    }
+
+    // The triangles of every vertex, the first remainingTriangles of its range not yet emitted
+    std::vector<uint32_t> remainingTriangles(vertexCount, 0);
+    for (uint32_t index : indices) {
+        remainingTriangles[index]++;
+    }
+    std::vector<uint32_t> firstTriangle(vertexCount + 1, 0);
+    for (uint32_t i = 0; i < vertexCount; i++) {
+        firstTriangle[i + 1] = firstTriangle[i] + remainingTriangles[i];
+    }
+    std::vector<uint32_t> vertexTriangles(indices.size());
+    std::vector<uint32_t> filled(vertexCount, 0);
+    for (uint32_t i = 0; i < triangleCount * 3; i++) {
+        const uint32_t vertex = indices[i];
+        vertexTriangles[firstTriangle[vertex] + filled[vertex]++] = i / 3;
+    }
+
+    static const VertexScoreTable scoreTable;
+    std::vector<float> vertexScores(vertexCount);
+    for (uint32_t i = 0; i < vertexCount; i++) {
+        vertexScores[i] = scoreTable.score(-1, remainingTriangles[i]);
+    }
+
+    std::vector<uint8_t> emitted(triangleCount, 0);
+    std::vector<uint32_t> result;
+    result.reserve(indices.size());
+    // The three vertices of the emitted triangle go in front of the cache, pushing up to three out
+    std::vector<uint32_t> cache;
+    std::vector<uint32_t> nextCache;
+    cache.reserve(SCORE_CACHE_SIZE + 3);
+    nextCache.reserve(SCORE_CACHE_SIZE + 3);
+    // The step a vertex was last added to the next cache in, to add it only once
+    std::vector<uint32_t> addedInStep(vertexCount, UNUSED_VERTEX);
+    uint32_t step = 0;
+    uint32_t nextInOrder = 0;
+    uint32_t bestTriangle = UNUSED_VERTEX;
+
+    while (result.size() < indices.size()) {
+        if (bestTriangle == UNUSED_VERTEX) {
+            while (emitted[nextInOrder]) {
+                nextInOrder++;
+            }
+            bestTriangle = nextInOrder;
+        }
+
+        const uint32_t* pTriangle = &indices[3 * bestTriangle];
+        emitted[bestTriangle] = 1;
+        nextCache.clear();
+        for (uint32_t i = 0; i < 3; i++) {
+            const uint32_t vertex = pTriangle[i];
+            result.push_back(vertex);
+
+            // Swap the triangle out of the vertex's remaining range
+            uint32_t* pTriangles = &vertexTriangles[firstTriangle[vertex]];
+            uint32_t& remaining = remainingTriangles[vertex];
+            for (uint32_t j = 0; j < remaining; j++) {
+                if (pTriangles[j] == bestTriangle) {
+                    std::swap(pTriangles[j], pTriangles[remaining - 1]);
+                    remaining--;
+                    break;
+                }
+            }
+
+            if (addedInStep[vertex] != step) {
+                addedInStep[vertex] = step;
+                nextCache.push_back(vertex);
+            }
+        }
+        for (uint32_t vertex : cache) {
+            if (addedInStep[vertex] != step) {
+                addedInStep[vertex] = step;
+                nextCache.push_back(vertex);
+            }
+        }
+        step++;
+
+        // Rescore the cache and the vertices it pushed out, then the triangles of the cache
+        for (uint32_t i = 0; i < nextCache.size(); i++) {
+            const uint32_t vertex = nextCache[i];
+            const int32_t position = i < SCORE_CACHE_SIZE ? static_cast<int32_t>(i) : -1;
+            vertexScores[vertex] = scoreTable.score(position, remainingTriangles[vertex]);
+        }
+        nextCache.resize(std::min<size_t>(nextCache.size(), SCORE_CACHE_SIZE));
+        bestTriangle = UNUSED_VERTEX;
+        float bestScore = -1.0f;
+        for (uint32_t vertex : nextCache) {
+            const uint32_t* pTriangles = &vertexTriangles[firstTriangle[vertex]];
+            for (uint32_t j = 0; j < remainingTriangles[vertex]; j++) {
+                const uint32_t triangle = pTriangles[j];
+                const uint32_t* pCorners = &indices[3 * triangle];
+                const float score = vertexScores[pCorners[0]] + vertexScores[pCorners[1]] + vertexScores[pCorners[2]];
+                if (score > bestScore) {
+                    bestScore = score;
+                    bestTriangle = triangle;
+                }
+            }
+        }
+        std::swap(cache, nextCache);
+    }
+
+    indices.swap(result);
+}
+
+//------------------------------------------------------------------------------------------
+// The clustering and sort of Sander et al., "Fast Triangle Reordering for Vertex Locality
+// and Reduced Overdraw". Clusters whose triangles face away from the center are likely on
+// the outside and drawn first so they occlude the rest.
+//------------------------------------------------------------------------------------------
+void optimize_overdraw(std::vector<uint32_t>& indices, const std::vector<Vertex>& vertices, float threshold) {
+    const uint32_t triangleCount = static_cast<uint32_t>(indices.size() / 3);
+    if (triangleCount == 0) {
+        return;
+    }
+    FifoCache cache(static_cast<uint32_t>(vertices.size()), VERTEX_CACHE_SIZE);
+
+    // Hard boundaries where all three vertices miss, usually a new patch of the mesh
+    std::vector<uint32_t> hardBoundaries;
+    for (uint32_t i = 0; i < triangleCount; i++) {
+        if (cache.access_triangle(&indices[3 * i]) == 3 || i == 0) {
+            hardBoundaries.push_back(i);
+        }
+    }
+    hardBoundaries.push_back(triangleCount);
+
+    // Soft boundaries wherever the triangles since the last one already reach the cluster's
+    // ACMR times the threshold, so cutting there costs little cache efficiency
+    std::vector<uint32_t> clusterStarts;
+    for (uint32_t i = 0; i + 1 < hardBoundaries.size(); i++) {
+        const uint32_t start = hardBoundaries[i];
+        const uint32_t end = hardBoundaries[i + 1];
+
+        cache.reset();
+        uint32_t clusterMisses = 0;
+        for (uint32_t j = start; j < end; j++) {
+            clusterMisses += cache.access_triangle(&indices[3 * j]);
+        }
+        const float targetAcmr = threshold * clusterMisses / (end - start);
+
+        clusterStarts.push_back(start);
+        cache.reset();
+        uint32_t runningMisses = 0;
+        uint32_t runningTriangles = 0;
+        for (uint32_t j = start; j + 1 < end; j++) {
+            runningMisses += cache.access_triangle(&indices[3 * j]);
+            runningTriangles++;
+            if (static_cast<float>(runningMisses) / runningTriangles <= targetAcmr) {
+                clusterStarts.push_back(j + 1);
+                cache.reset();
+                runningMisses = 0;
+                runningTriangles = 0;
+            }
+        }
+    }
+    const uint32_t clusterCount = static_cast<uint32_t>(clusterStarts.size());
+    clusterStarts.push_back(triangleCount);
+
+    // Area weighted centroids and normals
+    std::vector<glm::vec3> centroids(clusterCount, glm::vec3(0.0f));
+    std::vector<glm::vec3> normals(clusterCount, glm::vec3(0.0f));
+    glm::vec3 meshCentroid(0.0f);
+    float meshArea = 0.0f;
+    for (uint32_t i = 0; i < clusterCount; i++) {
+        float clusterArea = 0.0f;
+        for (uint32_t j = clusterStarts[i]; j < clusterStarts[i + 1]; j++) {
+            const glm::vec3& a = vertices[indices[3 * j]].position;
+            const glm::vec3& b = vertices[indices[3 * j + 1]].position;
+            const glm::vec3& c = vertices[indices[3 * j + 2]].position;
+            const glm::vec3 normal = glm::cross(b - a, c - a);
+            const float area = glm::length(normal);
+            centroids[i] += (a + b + c) * (area / 3.0f);
+            normals[i] += normal;
+            clusterArea += area;
+        }
+        meshCentroid += centroids[i];
+        meshArea += clusterArea;
+        centroids[i] = clusterArea > 0.0f ? centroids[i] / clusterArea : vertices[indices[3 * clusterStarts[i]]].position;
+    }
+    meshCentroid = meshArea > 0.0f ? meshCentroid / meshArea : glm::vec3(0.0f);
+
+    std::vector<float> sortKeys(clusterCount);
+    for (uint32_t i = 0; i < clusterCount; i++) {
+        const float length = glm::length(normals[i]);
+        sortKeys[i] = length > 0.0f ? glm::dot(centroids[i] - meshCentroid, normals[i] / length) : 0.0f;
+    }
+    std::vector<uint32_t> order(clusterCount);
+    for (uint32_t i = 0; i < clusterCount; i++) {
+        order[i] = i;
+    }
+    std::stable_sort(order.begin(), order.end(), [&sortKeys](uint32_t a, uint32_t b) { return sortKeys[a] > sortKeys[b]; });
+
+    std::vector<uint32_t> result;
+    result.reserve(indices.size());
+    for (uint32_t cluster : order) {
+        result.insert(result.end(), indices.begin() + 3 * clusterStarts[cluster], indices.begin() + 3 * clusterStarts[cluster + 1]);
+    }
+    indices.swap(result);
+}
+
+//------------------------------------------------------------------------------------------
+//------------------------------------------------------------------------------------------
+std::vector<uint32_t> optimize_vertex_fetch(MeshData& mesh) {
+    std::vector<uint32_t> remap(mesh.vertices.size(), UNUSED_VERTEX);
+    std::vector<Vertex> vertices;
+    vertices.reserve(mesh.vertices.size());
+    for (uint32_t& index : mesh.indices) {
+        if (remap[index] == UNUSED_VERTEX) {
+            remap[index] = static_cast<uint32_t>(vertices.size());
+            vertices.push_back(mesh.vertices[index]);
+        }
+        index = remap[index];
+    }
+    mesh.vertices.swap(vertices);
+    return remap;
+}
+
+//------------------------------------------------------------------------------------------
+//------------------------------------------------------------------------------------------
+void optimize_mesh(MeshData& mesh) {
+    optimize_vertex_cache(mesh.indices, static_cast<uint32_t>(mesh.vertices.size()));
+    optimize_overdraw(mesh.indices, mesh.vertices, OVERDRAW_THRESHOLD);
+    optimize_vertex_fetch(mesh);
+}
@@ -0,0 +1,180 @@
+//======================================================================
+// MeshQuantize.cpp
+//
+// Keegan Kochis
+// Created: 2026/10/18
+// Vertex quantization and its error metrics.
+//======================================================================
+
+#include "MeshQuantize.h"
+
+#include <cmath>
+#include <cstdint>
+
+#include <algorithm>
+#include <vector>
+
+#define GLM_FORCE_RADIANS
+#define GLM_FORCE_DEPTH_ZERO_TO_ONE
+#include <glm/common.hpp>
+#include <glm/geometric.hpp>
+#include <glm/vec2.hpp>
+#include <glm/vec3.hpp>
+#include <glm/vec4.hpp>
+
+static const float UNORM16_MAX = 65535.0f;
+static const float SNORM16_MAX = 32767.0f;
+
+//------------------------------------------------------------------------------------------
+// The inverse of the vertex shader's decode, the snorm values as the hardware converts them
+//------------------------------------------------------------------------------------------
+static glm::vec3 decode_octahedral(int16_t x, int16_t y) {
+    glm::vec2 code(std::max(x / SNORM16_MAX, -1.0f), std::max(y / SNORM16_MAX, -1.0f));
+    glm::vec3 normal(code.x, code.y, 1.0f - std::abs(code.x) - std::abs(code.y));
+    const float fold = std::max(-normal.z, 0.0f);
+    normal.x += normal.x >= 0.0f ? -fold : fold;
+    normal.y += normal.y >= 0.0f ? -fold : fold;
+    return glm::normalize(normal);
+}
+
+//------------------------------------------------------------------------------------------
+// The normal is projected onto the octahedron and its lower hemisphere folded over the
+// upper one
+//------------------------------------------------------------------------------------------
+static glm::vec2 encode_octahedral(const glm::vec3& normal) {
+    const float length = std::abs(normal.x) + std::abs(normal.y) + std::abs(normal.z);
+    if (length == 0.0f) {
+        return glm::vec2(0.0f);
+    }
+
+    glm::vec2 code = glm::vec2(normal.x, normal.y) / length;
+    if (normal.z < 0.0f) {
+        const glm::vec2 folded(1.0f - std::abs(code.y), 1.0f - std::abs(code.x));
+        code.x = code.x >= 0.0f ? folded.x : -folded.x;
+        code.y = code.y >= 0.0f ? folded.y : -folded.y;
+    }
+    return code;
+}
+
+//------------------------------------------------------------------------------------------
+// Uniform over the largest extent, so a flat mesh doesn't divide by zero
+//------------------------------------------------------------------------------------------
+glm::vec4 compute_dequantization(const std::vector<Vertex>& vertices) {
+    if (vertices.empty()) {
+        return glm::vec4(0.0f, 0.0f, 0.0f, 1.0f);
+    }
+
+    glm::vec3 minimum = vertices[0].position;
+    glm::vec3 maximum = minimum;
+    for (const Vertex& vertex : vertices) {
+        minimum = glm::min(minimum, vertex.position);
+        maximum = glm::max(maximum, vertex.position);
+    }
+    const glm::vec3 extent = maximum - minimum;
+    const float scale = std::max(std::max(extent.x, extent.y), extent.z);
+    return glm::vec4(minimum, scale > 0.0f ? scale : 1.0f);
+}
+
+//------------------------------------------------------------------------------------------
+// Rounding each coordinate on its own isn't always the closest code, so all four around the
+// exact one are tried
+//------------------------------------------------------------------------------------------
+QuantizedVertex quantize_vertex(const Vertex& vertex, const glm::vec4& dequantization) {
+    QuantizedVertex quantized;
+    const glm::vec3 offset(dequantization);
+    for (uint32_t i = 0; i < 3; i++) {
+        const float grid = (vertex.position[i] - offset[i]) / dequantization.w * UNORM16_MAX;
+        quantized.position[i] = static_cast<uint16_t>(std::min(std::max(std::round(grid), 0.0f), UNORM16_MAX));
+    }
+    quantized.position[3] = 0;
+
+    const glm::vec3 normal = glm::length(vertex.normal) > 0.0f ? glm::normalize(vertex.normal) : glm::vec3(0.0f, 0.0f, 1.0f);
+    const glm::vec2 code = encode_octahedral(normal) * SNORM16_MAX;
+    float bestDot = -2.0f;
+    for (uint32_t i = 0; i < 4; i++) {
+        const float x = (i & 1) ? std::ceil(code.x) : std::floor(code.x);
+        const float y = (i & 2) ? std::ceil(code.y) : std::floor(code.y);
+        const int16_t codeX = static_cast<int16_t>(std::min(std::max(x, -SNORM16_MAX), SNORM16_MAX));
+        const int16_t codeY = static_cast<int16_t>(std::min(std::max(y, -SNORM16_MAX), SNORM16_MAX));
+        const float dot = glm::dot(decode_octahedral(codeX, codeY), normal);
+        if (dot > bestDot) {
+            bestDot = dot;
+            quantized.normal[0] = codeX;
+            quantized.normal[1] = codeY;
+        }
+    }
+    return quantized;
+}
+
+//------------------------------------------------------------------------------------------
+//------------------------------------------------------------------------------------------
+Vertex dequantize_vertex(const QuantizedVertex& vertex, const glm::vec4& dequantization) {
+    Vertex result;
+    const glm::vec3 grid(vertex.position[0], vertex.position[1], vertex.position[2]);
+    result.position = glm::vec3(dequantization) + dequantization.w * (grid / UNORM16_MAX);
+    result.normal = decode_octahedral(vertex.normal[0], vertex.normal[1]);
+    return result;
+}
+
+//------------------------------------------------------------------------------------------
+//------------------------------------------------------------------------------------------
+QuantizedMeshData quantize_mesh(const MeshData& mesh) {
+    QuantizedMeshData quantized;
+    quantized.dequantization = compute_dequantization(mesh.vertices);
+    quantized.boundingSphere = mesh.compute_bounding_sphere();
+    quantized.indices = mesh.indices;
+    quantized.vertices.reserve(mesh.vertices.size());
+    for (const Vertex& vertex : mesh.vertices) {
+        quantized.vertices.push_back(quantize_vertex(vertex, quantized.dequantization));
+    }
+    return quantized;
+}
+
+//------------------------------------------------------------------------------------------
+// Normals are compared after normalizing the source ones, which the shaders do as well. The
+// angle is taken from the cross product, acos of a float can't resolve under 0.02 degrees.
+//------------------------------------------------------------------------------------------
+QuantizationError measure_quantization_error(const MeshData& mesh, const QuantizedMeshData& quantized) {
+    QuantizationError error = {};
+    if (mesh.vertices.empty()) {
+        return error;
+    }
+
+    double positionSum = 0.0;
+    double normalSum = 0.0;
+    for (size_t i = 0; i < mesh.vertices.size(); i++) {
+        const Vertex& source = mesh.vertices[i];
+        const Vertex decoded = dequantize_vertex(quantized.vertices[i], quantized.dequantization);
+
+        const float positionError = glm::length(decoded.position - source.position);
+        error.maxPositionError = std::max(error.maxPositionError, positionError);
+        positionSum += positionError;
+
+        if (glm::length(source.normal) > 0.0f) {
+            const glm::vec3 normal = glm::normalize(source.normal);
+            const float sine = glm::length(glm::cross(normal, decoded.normal));
+            const float degrees = std::atan2(sine, glm::dot(normal, decoded.normal)) * 57.2957795f;
+            error.maxNormalDegrees = std::max(error.maxNormalDegrees, degrees);
+            normalSum += degrees;
+        }
+    }
+    error.meanPositionError = static_cast<float>(positionSum / mesh.vertices.size());
+    error.meanNormalDegrees = static_cast<float>(normalSum / mesh.vertices.size());
+    error.relativePositionError = error.maxPositionError / quantized.dequantization.w;
+    return error;
+}
+
+//------------------------------------------------------------------------------------------
+//------------------------------------------------------------------------------------------
+MeshView QuantizedMeshData_t::get_view() const {
+    MeshView view;
+    view.pVertices = vertices.data();
+    view.vertexCount = static_cast<uint32_t>(vertices.size());
+    view.vertexFormat = VERTEX_FORMAT_QUANTIZED;
+    view.dequantization = dequantization;
+    view.pIndices = indices.data();
+    view.indexCount = static_cast<uint32_t>(indices.size());
+    view.boundingSphere = boundingSphere;
+    view.lodError = 0.0f;
+    return view;
+}
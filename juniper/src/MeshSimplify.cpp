@@ -0,0 +1,513 @@
+//======================================================================
+// MeshSimplify.cpp
+//
+// Keegan Kochis
+// Created: 2026/10/18
+// Quadric error edge collapse simplification and LOD generation.
+//======================================================================
+
+#include "MeshSimplify.h"
+#include "MeshOptimize.h"
+
+#include <cmath>
+#include <cstdint>
+
+#include <algorithm>
+#include <vector>
+
+#define GLM_FORCE_RADIANS
+#define GLM_FORCE_DEPTH_ZERO_TO_ONE
+#include <glm/geometric.hpp>
+#include <glm/vec3.hpp>
+
+static const uint32_t INVALID_VERTEX = 0xFFFFFFFF;
+// Planes through the borders weigh more than the triangles' so outlines resist moving
+static const float BORDER_WEIGHT = 10.0f;
+// A collapse may not turn a triangle further than this, as the cosine between its normals
+static const float MIN_NORMAL_COSINE = 0.25f;
+// Once the error limit leaves a pass fewer collapses than this fraction of the triangles,
+// the next passes would crawl along one collapse at a time
+static const float MIN_PASS_REDUCTION = 0.01f;
+
+enum VertexKind_t {
+    VERTEX_KIND_MANIFOLD = 0,       // Surrounded by triangles, collapses onto any neighbour
+    VERTEX_KIND_BORDER,             // On an open edge, collapses along it
+    VERTEX_KIND_SEAM,               // One of two vertices splitting attributes, both collapse along the seam
+    VERTEX_KIND_LOCKED              // Corners, non-manifold and more than two way splits
+}; typedef VertexKind_t VertexKind;
+
+//------------------------------------------------------------------------------------------
+// Sum of squared distances to planes, weighted by the area they came from
+//------------------------------------------------------------------------------------------
+struct Quadric_t {
+    double a00 = 0.0, a11 = 0.0, a22 = 0.0, a01 = 0.0, a02 = 0.0, a12 = 0.0;
+    double b0 = 0.0, b1 = 0.0, b2 = 0.0;
+    double c = 0.0;
+    double weight = 0.0;
+
+    void add_plane(const glm::vec3& normal, float distance, float planeWeight) {
+        a00 += planeWeight * normal.x * normal.x;
+        a11 += planeWeight * normal.y * normal.y;
+        a22 += planeWeight * normal.z * normal.z;
+        a01 += planeWeight * normal.x * normal.y;
+        a02 += planeWeight * normal.x * normal.z;
+        a12 += planeWeight * normal.y * normal.z;
+        b0 += planeWeight * normal.x * distance;
+        b1 += planeWeight * normal.y * distance;
+        b2 += planeWeight * normal.z * distance;
+        c += planeWeight * distance * distance;
+        weight += planeWeight;
+    }
+
+    void add(const Quadric_t& other) {
+        a00 += other.a00; a11 += other.a11; a22 += other.a22;
+        a01 += other.a01; a02 += other.a02; a12 += other.a12;
+        b0 += other.b0; b1 += other.b1; b2 += other.b2;
+        c += other.c;
+        weight += other.weight;
+    }
+
+    // Mean squared distance of the point to the planes
+    double evaluate(const glm::vec3& point) const {
+        if (weight <= 0.0) {
+            return 0.0;
+        }
+        const double x = point.x, y = point.y, z = point.z;
+        const double error = x * x * a00 + y * y * a11 + z * z * a22 + 2.0 * (x * y * a01 + x * z * a02 + y * z * a12) +
+                             2.0 * (x * b0 + y * b1 + z * b2) + c;
+        return std::max(error / weight, 0.0);
+    }
+}; typedef Quadric_t Quadric;
+
+// Moves vertex onto target and, for seams, partner onto partnerTarget
+struct Collapse_t {
+    uint32_t vertex;
+    uint32_t target;
+    uint32_t partner;
+    uint32_t partnerTarget;
+    float cost;                     // Squared distance
+}; typedef Collapse_t Collapse;
+
+// Open edges of every vertex of the current indices, and their kinds
+struct Topology_t {
+    std::vector<VertexKind> kinds;
+    std::vector<uint32_t> openOut;  // End of the vertex's open edge, for borders and seams
+    std::vector<uint32_t> openIn;   // Start of the open edge ending at the vertex
+    std::vector<uint32_t> wedges;   // Next referenced vertex at the same position, circular
+}; typedef Topology_t Topology;
+
+// The directed edges of some indices, grouped by the vertex they start at
+struct EdgeAdjacency_t {
+    std::vector<uint32_t> offsets;  // Vertex count + 1
+    std::vector<uint32_t> ends;
+}; typedef EdgeAdjacency_t EdgeAdjacency;
+
+//------------------------------------------------------------------------------------------
+//------------------------------------------------------------------------------------------
+static bool has_edge(const EdgeAdjacency& adjacency, uint32_t from, uint32_t to) {
+    for (uint32_t i = adjacency.offsets[from]; i < adjacency.offsets[from + 1]; i++) {
+        if (adjacency.ends[i] == to) {
+            return true;
+        }
+    }
+    return false;
+}
+
+//------------------------------------------------------------------------------------------
+// Every vertex maps to the first vertex at its position, so splits of normals don't read as
+// holes in the surface
+//------------------------------------------------------------------------------------------
+static std::vector<uint32_t> build_position_remap(const std::vector<Vertex>& vertices) {
+    const uint32_t vertexCount = static_cast<uint32_t>(vertices.size());
+    std::vector<uint32_t> order(vertexCount);
+    for (uint32_t i = 0; i < vertexCount; i++) {
+        order[i] = i;
+    }
+    auto less = [&vertices](uint32_t a, uint32_t b) {
+        const glm::vec3& p = vertices[a].position;
+        const glm::vec3& q = vertices[b].position;
+        if (p.x != q.x) {
+            return p.x < q.x;
+        }
+        if (p.y != q.y) {
+            return p.y < q.y;
+        }
+        return p.z != q.z ? p.z < q.z : a < b;
+    };
+    std::sort(order.begin(), order.end(), less);
+
+    std::vector<uint32_t> remap(vertexCount);
+    for (uint32_t i = 0; i < vertexCount; i++) {
+        const bool same = i > 0 && vertices[order[i]].position == vertices[order[i - 1]].position;
+        remap[order[i]] = same ? remap[order[i - 1]] : order[i];
+    }
+    return remap;
+}
+
+//------------------------------------------------------------------------------------------
+//------------------------------------------------------------------------------------------
+static EdgeAdjacency build_edge_adjacency(const std::vector<uint32_t>& indices, const std::vector<uint32_t>& remap,
+                                          bool positions) {
+    const uint32_t vertexCount = static_cast<uint32_t>(remap.size());
+    EdgeAdjacency adjacency;
+    adjacency.offsets.assign(vertexCount + 1, 0);
+    for (uint32_t index : indices) {
+        adjacency.offsets[(positions ? remap[index] : index) + 1]++;
+    }
+    for (uint32_t v = 0; v < vertexCount; v++) {
+        adjacency.offsets[v + 1] += adjacency.offsets[v];
+    }
+
+    adjacency.ends.resize(indices.size());
+    std::vector<uint32_t> cursors(adjacency.offsets.begin(), adjacency.offsets.end() - 1);
+    for (size_t i = 0; i < indices.size(); i += 3) {
+        for (uint32_t e = 0; e < 3; e++) {
+            const uint32_t from = indices[i + e];
+            const uint32_t to = indices[i + (e + 1) % 3];
+            if (positions) {
+                adjacency.ends[cursors[remap[from]]++] = remap[to];
+            }
+            else {
+                adjacency.ends[cursors[from]++] = to;
+            }
+        }
+    }
+    return adjacency;
+}
+
+//------------------------------------------------------------------------------------------
+// An open edge has no reverse edge between the same vertices. A vertex with one open edge in
+// and one out is a border, two such vertices at one position whose open edges run along
+// each other are a seam, anything more complex is locked.
+//------------------------------------------------------------------------------------------
+static Topology classify_vertices(const std::vector<uint32_t>& indices, const std::vector<uint32_t>& remap) {
+    const uint32_t vertexCount = static_cast<uint32_t>(remap.size());
+    Topology topology;
+    topology.kinds.assign(vertexCount, VERTEX_KIND_LOCKED);
+    topology.openOut.assign(vertexCount, INVALID_VERTEX);
+    topology.openIn.assign(vertexCount, INVALID_VERTEX);
+    topology.wedges.assign(vertexCount, INVALID_VERTEX);
+
+    std::vector<uint32_t> heads(vertexCount, INVALID_VERTEX);
+    for (uint32_t index : indices) {
+        if (topology.wedges[index] != INVALID_VERTEX) {
+            continue;
+        }
+        uint32_t& head = heads[remap[index]];
+        if (head == INVALID_VERTEX) {
+            head = index;
+            topology.wedges[index] = index;
+        }
+        else {
+            topology.wedges[index] = topology.wedges[head];
+            topology.wedges[head] = index;
+        }
+    }
+
+    const EdgeAdjacency edges = build_edge_adjacency(indices, remap, false);
+    std::vector<uint8_t> openOutCount(vertexCount, 0);
+    std::vector<uint8_t> openInCount(vertexCount, 0);
+    for (size_t i = 0; i < indices.size(); i += 3) {
+        for (uint32_t e = 0; e < 3; e++) {
+            const uint32_t from = indices[i + e];
+            const uint32_t to = indices[i + (e + 1) % 3];
+            if (!has_edge(edges, to, from)) {
+                openOutCount[from] = static_cast<uint8_t>(std::min(openOutCount[from] + 1, 2));
+                openInCount[to] = static_cast<uint8_t>(std::min(openInCount[to] + 1, 2));
+                topology.openOut[from] = to;
+                topology.openIn[to] = from;
+            }
+        }
+    }
+
+    for (uint32_t v = 0; v < vertexCount; v++) {
+        const uint32_t wedge = topology.wedges[v];
+        if (wedge == INVALID_VERTEX) {
+            continue;
+        }
+
+        const bool simpleOpen = openOutCount[v] == 1 && openInCount[v] == 1;
+        if (wedge == v) {
+            if (openOutCount[v] == 0 && openInCount[v] == 0) {
+                topology.kinds[v] = VERTEX_KIND_MANIFOLD;
+            }
+            else if (simpleOpen) {
+                topology.kinds[v] = VERTEX_KIND_BORDER;
+            }
+        }
+        else if (topology.wedges[wedge] == v && simpleOpen && openOutCount[wedge] == 1 && openInCount[wedge] == 1 &&
+                   remap[topology.openOut[v]] == remap[topology.openIn[wedge]] &&
+                   remap[topology.openIn[v]] == remap[topology.openOut[wedge]]) {
+            topology.kinds[v] = VERTEX_KIND_SEAM;
+        }
+    }
+    return topology;
+}
+
+//------------------------------------------------------------------------------------------
+// Planes of the triangles weighted by their area, plus planes standing on the borders so
+// moving along a border costs nothing but moving off it does
+//------------------------------------------------------------------------------------------
+static std::vector<Quadric> build_quadrics(const std::vector<uint32_t>& indices, const std::vector<Vertex>& vertices,
+                                           const std::vector<uint32_t>& remap) {
+    std::vector<Quadric> quadrics(vertices.size());
+    const EdgeAdjacency positionEdges = build_edge_adjacency(indices, remap, true);
+
+    for (size_t i = 0; i < indices.size(); i += 3) {
+        const uint32_t corners[3] = { remap[indices[i]], remap[indices[i + 1]], remap[indices[i + 2]] };
+        const glm::vec3 p0 = vertices[corners[0]].position;
+        const glm::vec3 cross = glm::cross(vertices[corners[1]].position - p0, vertices[corners[2]].position - p0);
+        const float length = glm::length(cross);
+        if (length == 0.0f) {
+            continue;
+        }
+
+        const glm::vec3 normal = cross / length;
+        for (uint32_t corner : corners) {
+            quadrics[corner].add_plane(normal, -glm::dot(normal, p0), 0.5f * length);
+        }
+
+        for (uint32_t e = 0; e < 3; e++) {
+            const uint32_t from = corners[e];
+            const uint32_t to = corners[(e + 1) % 3];
+            if (has_edge(positionEdges, to, from)) {
+                continue;
+            }
+            const glm::vec3 edge = vertices[to].position - vertices[from].position;
+            const float edgeLength = glm::length(edge);
+            if (edgeLength == 0.0f) {
+                continue;
+            }
+            const glm::vec3 borderNormal = glm::normalize(glm::cross(edge, normal));
+            const float distance = -glm::dot(borderNormal, vertices[from].position);
+            quadrics[from].add_plane(borderNormal, distance, BORDER_WEIGHT * edgeLength * edgeLength);
+            quadrics[to].add_plane(borderNormal, distance, BORDER_WEIGHT * edgeLength * edgeLength);
+        }
+    }
+    return quadrics;
+}
+
+//------------------------------------------------------------------------------------------
+// The vertex collapse onto target is allowed for, filling in the seam partner's
+//------------------------------------------------------------------------------------------
+static bool can_collapse(const Topology& topology, const std::vector<uint32_t>& remap, uint32_t vertex, uint32_t target,
+                         Collapse& collapse) {
+    collapse.vertex = vertex;
+    collapse.target = target;
+    collapse.partner = INVALID_VERTEX;
+    collapse.partnerTarget = INVALID_VERTEX;
+
+    const VertexKind targetKind = topology.kinds[target];
+    const bool alongOpenEdge = topology.openOut[vertex] == target || topology.openIn[vertex] == target;
+    switch (topology.kinds[vertex]) {
+        case VERTEX_KIND_MANIFOLD:
+            return true;
+        case VERTEX_KIND_BORDER:
+            return alongOpenEdge && targetKind != VERTEX_KIND_MANIFOLD;
+        case VERTEX_KIND_SEAM: {
+            if (!alongOpenEdge || (targetKind != VERTEX_KIND_SEAM && targetKind != VERTEX_KIND_LOCKED)) {
+                return false;
+            }
+            // The partner's open edge runs the other way
+            const uint32_t partner = topology.wedges[vertex];
+            const uint32_t partnerTarget = topology.openOut[vertex] == target ? topology.openIn[partner] : topology.openOut[partner];
+            if (partnerTarget == INVALID_VERTEX || remap[partnerTarget] != remap[target]) {
+                return false;
+            }
+            collapse.partner = partner;
+            collapse.partnerTarget = partnerTarget;
+            return true;
+        }
+        default:
+            return false;
+    }
+}
+
+//------------------------------------------------------------------------------------------
+// Moving the position must not fold any remaining triangle around it over
+//------------------------------------------------------------------------------------------
+static bool flips_triangles(const std::vector<uint32_t>& indices, const std::vector<Vertex>& vertices,
+                            const std::vector<uint32_t>& remap, const std::vector<uint32_t>& adjacencyOffsets,
+                            const std::vector<uint32_t>& adjacency, uint32_t position, uint32_t targetPosition) {
+    const glm::vec3 moved = vertices[targetPosition].position;
+    for (uint32_t a = adjacencyOffsets[position]; a < adjacencyOffsets[position + 1]; a++) {
+        const uint32_t* pTriangle = &indices[3 * adjacency[a]];
+        const uint32_t corners[3] = { remap[pTriangle[0]], remap[pTriangle[1]], remap[pTriangle[2]] };
+        if (corners[0] == targetPosition || corners[1] == targetPosition || corners[2] == targetPosition) {
+            continue;
+        }
+
+        glm::vec3 points[3];
+        for (uint32_t c = 0; c < 3; c++) {
+            points[c] = vertices[corners[c]].position;
+        }
+        const glm::vec3 before = glm::cross(points[1] - points[0], points[2] - points[0]);
+        for (uint32_t c = 0; c < 3; c++) {
+            if (corners[c] == position) {
+                points[c] = moved;
+            }
+        }
+        const glm::vec3 after = glm::cross(points[1] - points[0], points[2] - points[0]);
+        if (glm::dot(before, after) < MIN_NORMAL_COSINE * glm::length(before) * glm::length(after)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+//------------------------------------------------------------------------------------------
+// Collapses run in passes. Each pass sorts every allowed collapse by cost and takes them in
+// order, skipping any whose neighbourhood another collapse of the pass already changed, so
+// the costs and flip tests stay exact. The quadrics of collapsed positions add up.
+//------------------------------------------------------------------------------------------
+std::vector<uint32_t> simplify_mesh(const std::vector<uint32_t>& indices, const std::vector<Vertex>& vertices,
+                                    uint32_t targetIndexCount, float targetError, float* pError) {
+    const uint32_t vertexCount = static_cast<uint32_t>(vertices.size());
+    const std::vector<uint32_t> remap = build_position_remap(vertices);
+    std::vector<Quadric> quadrics = build_quadrics(indices, vertices, remap);
+    const float errorLimit = targetError * targetError;
+    float maxCost = 0.0f;
+
+    std::vector<uint32_t> result = indices;
+    std::vector<Collapse> collapses;
+    std::vector<uint32_t> adjacencyOffsets(vertexCount + 1);
+    std::vector<uint32_t> adjacency;
+    std::vector<uint8_t> touched(vertexCount);
+    std::vector<uint32_t> targets(vertexCount);
+
+    while (result.size() > targetIndexCount) {
+        const uint32_t triangleCount = static_cast<uint32_t>(result.size() / 3);
+        const Topology topology = classify_vertices(result, remap);
+
+        // Triangles around each position
+        std::fill(adjacencyOffsets.begin(), adjacencyOffsets.end(), 0);
+        for (uint32_t index : result) {
+            adjacencyOffsets[remap[index] + 1]++;
+        }
+        for (uint32_t v = 0; v < vertexCount; v++) {
+            adjacencyOffsets[v + 1] += adjacencyOffsets[v];
+        }
+        adjacency.resize(result.size());
+        std::vector<uint32_t> cursors(adjacencyOffsets.begin(), adjacencyOffsets.end() - 1);
+        for (uint32_t i = 0; i < result.size(); i++) {
+            adjacency[cursors[remap[result[i]]]++] = i / 3;
+        }
+
+        collapses.clear();
+        for (uint32_t i = 0; i < result.size(); i += 3) {
+            for (uint32_t e = 0; e < 3; e++) {
+                const uint32_t a = result[i + e];
+                const uint32_t b = result[i + (e + 1) % 3];
+                // Interior edges show up in both of their triangles, one is enough
+                if (topology.kinds[a] == VERTEX_KIND_MANIFOLD && topology.kinds[b] == VERTEX_KIND_MANIFOLD && a > b) {
+                    continue;
+                }
+                Collapse collapse;
+                if (can_collapse(topology, remap, a, b, collapse)) {
+                    collapse.cost = static_cast<float>(quadrics[remap[a]].evaluate(vertices[b].position));
+                    collapses.push_back(collapse);
+                }
+                if (can_collapse(topology, remap, b, a, collapse)) {
+                    collapse.cost = static_cast<float>(quadrics[remap[b]].evaluate(vertices[a].position));
+                    collapses.push_back(collapse);
+                }
+            }
+        }
+        std::sort(collapses.begin(), collapses.end(), [](const Collapse& a, const Collapse& b) { return a.cost < b.cost; });
+
+        std::fill(touched.begin(), touched.end(), 0);
+        for (uint32_t v = 0; v < vertexCount; v++) {
+            targets[v] = v;
+        }
+        const uint32_t targetTriangles = targetIndexCount / 3;
+        uint32_t removedTriangles = 0;
+        uint32_t collapseCount = 0;
+        for (const Collapse& collapse : collapses) {
+            if (collapse.cost > errorLimit || triangleCount - removedTriangles <= targetTriangles) {
+                break;
+            }
+
+            const uint32_t position = remap[collapse.vertex];
+            const uint32_t targetPosition = remap[collapse.target];
+            if (touched[position] || touched[targetPosition] ||
+                flips_triangles(result, vertices, remap, adjacencyOffsets, adjacency, position, targetPosition)) {
+                continue;
+            }
+
+            targets[collapse.vertex] = collapse.target;
+            if (collapse.partner != INVALID_VERTEX) {
+                targets[collapse.partner] = collapse.partnerTarget;
+            }
+            quadrics[targetPosition].add(quadrics[position]);
+            maxCost = std::max(maxCost, collapse.cost);
+            collapseCount++;
+
+            for (uint32_t a = adjacencyOffsets[position]; a < adjacencyOffsets[position + 1]; a++) {
+                const uint32_t* pTriangle = &result[3 * adjacency[a]];
+                bool degenerate = false;
+                for (uint32_t c = 0; c < 3; c++) {
+                    touched[remap[pTriangle[c]]] = 1;
+                    degenerate = degenerate || remap[pTriangle[c]] == targetPosition;
+                }
+                removedTriangles += degenerate ? 1 : 0;
+            }
+        }
+
+        if (collapseCount == 0) {
+            break;
+        }
+
+        // Triangles with two corners at one position are gone
+        uint32_t writeIndex = 0;
+        for (uint32_t i = 0; i < result.size(); i += 3) {
+            const uint32_t a = targets[result[i]];
+            const uint32_t b = targets[result[i + 1]];
+            const uint32_t c = targets[result[i + 2]];
+            if (remap[a] == remap[b] || remap[b] == remap[c] || remap[a] == remap[c]) {
+                continue;
+            }
+            result[writeIndex++] = a;
+            result[writeIndex++] = b;
+            result[writeIndex++] = c;
+        }
+        result.resize(writeIndex);
+        if (result.size() / 3 > triangleCount * (1.0f - MIN_PASS_REDUCTION)) {
+            break;
+        }
+    }
+
+    if (pError != nullptr) {
+        *pError = std::sqrt(maxCost);
+    }
+    return result;
+}
+
+//------------------------------------------------------------------------------------------
+// Simplifying from the previous level is much cheaper than from level 0 each time, and the
+// summed errors still bound the distance to level 0
+//------------------------------------------------------------------------------------------
+std::vector<MeshLodData> generate_lods(const MeshData& mesh) {
+    std::vector<MeshLodData> lods;
+    const float maxError = LOD_MAX_ERROR * mesh.compute_bounding_sphere().w;
+    const uint32_t vertexCount = static_cast<uint32_t>(mesh.vertices.size());
+
+    const std::vector<uint32_t>* pPrevious = &mesh.indices;
+    float error = 0.0f;
+    lods.reserve(LOD_MAX_COUNT - 1);
+    while (lods.size() + 1 < LOD_MAX_COUNT && error < maxError) {
+        const uint32_t targetIndexCount = static_cast<uint32_t>(pPrevious->size() / 3 * LOD_REDUCTION) * 3;
+        float levelError = 0.0f;
+        MeshLodData lod;
+        lod.indices = simplify_mesh(*pPrevious, mesh.vertices, targetIndexCount, maxError - error, &levelError);
+        if (lod.indices.empty() || lod.indices.size() > pPrevious->size() * LOD_MIN_REDUCTION) {
+            break;
+        }
+
+        error += levelError;
+        lod.error = error;
+        optimize_vertex_cache(lod.indices, vertexCount);
+        lods.push_back(std::move(lod));
+        pPrevious = &lods.back().indices;
+    }
+    return lods;
+}
@@ -0,0 +1,172 @@
+//======================================================================
+// Meshlet.cpp
+//
+// Keegan Kochis
+// Created: 2026/10/18
+// Splitting meshes into meshlets and computing their bounds.
+//======================================================================
+
+#include "Meshlet.h"
+
+#include <cmath>
+#include <cstdint>
+
+#include <algorithm>
+#include <stdexcept>
+#include <vector>
+
+#define GLM_FORCE_RADIANS
+#define GLM_FORCE_DEPTH_ZERO_TO_ONE
+#include <glm/common.hpp>
+#include <glm/geometric.hpp>
+#include <glm/vec3.hpp>
+#include <glm/vec4.hpp>
+
+// Normal cones with a smaller minimum dot product are too wide to ever cull reliably
+static const float MIN_CONE_DOT = 0.1f;
+
+static const uint32_t UNUSED_VERTEX = 0xFFFFFFFF;
+
+//------------------------------------------------------------------------------------------
+// The bounding sphere is centered on the bounding box like MeshData::compute_bounding_sphere.
+// The cone axis is the average of the triangle normals and the cutoff is derived from the
+// normal furthest away from it.
+//------------------------------------------------------------------------------------------
+static void compute_meshlet_bounds(const MeshData& mesh, const MeshletData& data, Meshlet& meshlet) {
+    glm::vec3 minimum = mesh.vertices[data.vertices[meshlet.vertexOffset]].position;
+    glm::vec3 maximum = minimum;
+    for (uint32_t i = 0; i < meshlet.vertexCount; i++) {
+        const glm::vec3& position = mesh.vertices[data.vertices[meshlet.vertexOffset + i]].position;
+        minimum = glm::min(minimum, position);
+        maximum = glm::max(maximum, position);
+    }
+
+    glm::vec3 center = 0.5f * (minimum + maximum);
+    float radius = 0.0f;
+    for (uint32_t i = 0; i < meshlet.vertexCount; i++) {
+        const glm::vec3& position = mesh.vertices[data.vertices[meshlet.vertexOffset + i]].position;
+        radius = std::max(radius, glm::length(position - center));
+    }
+    meshlet.boundingSphere = glm::vec4(center, radius);
+
+    std::vector<glm::vec3> normals;
+    normals.reserve(meshlet.triangleCount);
+    glm::vec3 axis(0.0f);
+    for (uint32_t i = 0; i < meshlet.triangleCount; i++) {
+        const uint8_t* pTriangle = &data.triangles[meshlet.triangleOffset + 3 * i];
+        const glm::vec3& a = mesh.vertices[data.vertices[meshlet.vertexOffset + pTriangle[0]]].position;
+        const glm::vec3& b = mesh.vertices[data.vertices[meshlet.vertexOffset + pTriangle[1]]].position;
+        const glm::vec3& c = mesh.vertices[data.vertices[meshlet.vertexOffset + pTriangle[2]]].position;
+
+        glm::vec3 normal = glm::cross(b - a, c - a);
+        float length = glm::length(normal);
+        // Degenerate triangles are invisible whichever way they face
+        if (length > 0.0f) {
+            normals.push_back(normal / length);
+            axis += normals.back();
+        }
+    }
+
+    meshlet.cone = glm::vec4(0.0f, 0.0f, 1.0f, 1.0f);
+    float axisLength = glm::length(axis);
+    if (normals.empty() || axisLength == 0.0f) {
+        return;
+    }
+    axis /= axisLength;
+
+    float minimumDot = 1.0f;
+    for (const glm::vec3& normal : normals) {
+        minimumDot = std::min(minimumDot, glm::dot(axis, normal));
+    }
+    if (minimumDot <= MIN_CONE_DOT) {
+        meshlet.cone = glm::vec4(axis, 1.0f);
+        return;
+    }
+
+    // Sine of the cone's half angle. A direction is behind every triangle once its angle to
+    // the axis is below 90 degrees minus that half angle.
+    meshlet.cone = glm::vec4(axis, std::sqrt(1.0f - minimumDot * minimumDot));
+}
+
+//------------------------------------------------------------------------------------------
+// Finish the meshlet under construction and start the next one
+//------------------------------------------------------------------------------------------
+static void flush_meshlet(const MeshData& mesh, MeshletData& data, Meshlet& meshlet, std::vector<uint32_t>& localIndices) {
+    if (meshlet.triangleCount == 0) {
+        return;
+    }
+
+    for (uint32_t i = 0; i < meshlet.vertexCount; i++) {
+        localIndices[data.vertices[meshlet.vertexOffset + i]] = UNUSED_VERTEX;
+    }
+    while (data.triangles.size() % 4 != 0) {
+        data.triangles.push_back(0);
+    }
+
+    compute_meshlet_bounds(mesh, data, meshlet);
+    data.meshlets.push_back(meshlet);
+
+    meshlet = Meshlet();
+    meshlet.vertexOffset = static_cast<uint32_t>(data.vertices.size());
+    meshlet.triangleOffset = static_cast<uint32_t>(data.triangles.size());
+}
+
+//------------------------------------------------------------------------------------------
+// Greedy scan over the triangles. A triangle whose new vertices don't fit starts the next
+// meshlet, so meshlets stay connected as long as the index order is.
+//------------------------------------------------------------------------------------------
+MeshletData_t MeshletData_t::build(const MeshData& mesh, uint32_t maxVertices, uint32_t maxTriangles) {
+    if (maxVertices < 3 || maxVertices > 256 || maxTriangles == 0) {
+        throw std::runtime_error("Failed to build meshlets, the limits are out of range!");
+    }
+
+    MeshletData data;
+    std::vector<uint32_t> localIndices(mesh.vertices.size(), UNUSED_VERTEX);
+
+    Meshlet meshlet = Meshlet();
+    meshlet.vertexOffset = 0;
+    meshlet.triangleOffset = 0;
+
+    for (size_t index = 0; index + 2 < mesh.indices.size(); index += 3) {
+        const uint32_t* pTriangle = &mesh.indices[index];
+
+        uint32_t newVertices = 0;
+        for (uint32_t i = 0; i < 3; i++) {
+            // Repeated indices within the triangle only count once
+            bool repeated = (i > 0 && pTriangle[i] == pTriangle[0]) || (i > 1 && pTriangle[i] == pTriangle[1]);
+            if (localIndices[pTriangle[i]] == UNUSED_VERTEX && !repeated) {
+                newVertices++;
+            }
+        }
+
+        if (meshlet.vertexCount + newVertices > maxVertices || meshlet.triangleCount == maxTriangles) {
+            flush_meshlet(mesh, data, meshlet, localIndices);
+        }
+
+        for (uint32_t i = 0; i < 3; i++) {
+            uint32_t& localIndex = localIndices[pTriangle[i]];
+            if (localIndex == UNUSED_VERTEX) {
+                localIndex = meshlet.vertexCount++;
+                data.vertices.push_back(pTriangle[i]);
+            }
+            data.triangles.push_back(static_cast<uint8_t>(localIndex));
+        }
+        meshlet.triangleCount++;
+    }
+    flush_meshlet(mesh, data, meshlet, localIndices);
+
+    return data;
+}
+
+//------------------------------------------------------------------------------------------
+//------------------------------------------------------------------------------------------
+MeshletView MeshletData_t::get_view() const {
+    MeshletView view;
+    view.pMeshlets = meshlets.data();
+    view.meshletCount = static_cast<uint32_t>(meshlets.size());
+    view.pVertices = vertices.data();
+    view.vertexCount = static_cast<uint32_t>(vertices.size());
+    view.pTriangles = triangles.data();
+    view.triangleBytes = static_cast<uint32_t>(triangles.size());
+    return view;
+}
@@ -0,0 +1,562 @@
+//======================================================================
+// MeshletRenderer.cpp
+//
+// Keegan Kochis
+// Created: 2026/10/18
+// The definition of the MeshletRenderer class.
+//======================================================================
+
+#include "MeshletRenderer.h"
+#include "InstancedRenderer.h"
+#include "Shader.h"
+
+#include <cstdint>
+#include <cstring>
+
+#include <algorithm>
+#include <chrono>
+#include <ostream>
+#include <stdexcept>
+#include <vector>
+
+#define GLFW_INCLUDE_VULKAN
+#include <GLFW/glfw3.h>
+
+#define GLM_FORCE_RADIANS
+#define GLM_FORCE_DEPTH_ZERO_TO_ONE
+#include <glm/mat4x4.hpp>
+#include <glm/vec3.hpp>
+#include <glm/vec4.hpp>
+
+static const uint32_t INITIAL_OBJECT_CAPACITY = 256;
+static const uint32_t INITIAL_CLUSTER_CAPACITY = 4096;
+static const uint32_t INITIAL_VERTEX_BYTES = 1 << 20;
+static const uint32_t INITIAL_INDEX_BYTES = 1 << 20;
+static const uint32_t INITIAL_MESHLET_BYTES = 1 << 16;
+// Must match local_size_x of build_meshlet_tasks.comp
+static const uint32_t BUILD_TASKS_GROUP_SIZE = 64;
+// Every mesh task command draws at most this many clusters, the smallest maxDrawMeshTasksCount
+// the extension allows. Must match build_meshlet_tasks.comp.
+static const uint32_t MESH_TASK_CHUNK = 65535;
+// Objects past the first row of workgroups go into further rows
+static const uint32_t MAX_WORKGROUPS_PER_ROW = 65535;
+
+static const VkMemoryPropertyFlags HOST_MEMORY = VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT;
+static const VkBufferUsageFlags GPU_WRITTEN_USAGE = VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT;
+static const VkBufferUsageFlags INDIRECT_USAGE = GPU_WRITTEN_USAGE | VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT;
+
+MeshletRenderer::MeshletRenderer() {}
+
+//------------------------------------------------------------------------------------------
+// With mesh shaders set 0 holds the objects, meshlets, visible clusters, meshlet vertices,
+// meshlet triangles and vertices, all read by the mesh shader. The vertex path only needs
+// the objects, since the draws index them through firstInstance.
+//------------------------------------------------------------------------------------------
+void MeshletRenderer::init(VkDevice device, const DeviceFeatures::Capabilities& capabilities, uint32_t framesInFlight,
+                           GpuResources* pGpuResources, DescriptorAllocator* pDescriptorAllocator) {
+    mDevice = device;
+    mpGpuResources = pGpuResources;
+    mpDescriptorAllocator = pDescriptorAllocator;
+
+    mSupported = capabilities.has_tier(DeviceFeatures::CAPABILITY_TIER_GPU_DRIVEN);
+    if (!mSupported) {
+        return;
+    }
+
+    if (capabilities.meshShader) {
+        mCmdDrawMeshTasksIndirect = reinterpret_cast<PFN_vkCmdDrawMeshTasksIndirectNV>(
+            vkGetDeviceProcAddr(mDevice, "vkCmdDrawMeshTasksIndirectNV"));
+        mMeshShaders = mCmdDrawMeshTasksIndirect != nullptr;
+    }
+    if (!mMeshShaders && capabilities.has_tier(DeviceFeatures::CAPABILITY_TIER_INDIRECT_COUNT)) {
+        mCmdDrawIndexedIndirectCount = reinterpret_cast<PFN_vkCmdDrawIndexedIndirectCountKHR>(
+            vkGetDeviceProcAddr(mDevice, "vkCmdDrawIndexedIndirectCount"));
+        if (mCmdDrawIndexedIndirectCount == nullptr) {
+            mCmdDrawIndexedIndirectCount = reinterpret_cast<PFN_vkCmdDrawIndexedIndirectCountKHR>(
+                vkGetDeviceProcAddr(mDevice, "vkCmdDrawIndexedIndirectCountKHR"));
+        }
+        mUseDrawCount = mCmdDrawIndexedIndirectCount != nullptr;
+    }
+    mStats.meshShaders = mMeshShaders;
+
+    const VkShaderStageFlags stage = mMeshShaders ? VK_SHADER_STAGE_MESH_BIT_NV : VK_SHADER_STAGE_VERTEX_BIT;
+    std::vector<VkDescriptorSetLayoutBinding> bindings(mMeshShaders ? 6 : 1);
+    for (uint32_t i = 0; i < bindings.size(); i++) {
+        bindings[i] = {};
+        bindings[i].binding = i;
+        bindings[i].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+        bindings[i].descriptorCount = 1;
+        bindings[i].stageFlags = stage;
+    }
+    mDescriptorSetLayout = mpDescriptorAllocator->get_layout(bindings);
+
+    VkPushConstantRange pushConstantRange{};
+    pushConstantRange.stageFlags = stage;
+    pushConstantRange.offset = 0;
+    pushConstantRange.size = sizeof(PushConstants);
+
+    VkPipelineLayoutCreateInfo layoutCreateInfo{};
+    layoutCreateInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
+    layoutCreateInfo.setLayoutCount = 1;
+    layoutCreateInfo.pSetLayouts = &mDescriptorSetLayout;
+    layoutCreateInfo.pushConstantRangeCount = 1;
+    layoutCreateInfo.pPushConstantRanges = &pushConstantRange;
+
+    if (vkCreatePipelineLayout(mDevice, &layoutCreateInfo, nullptr, &mPipelineLayout) != VK_SUCCESS) {
+        throw std::runtime_error("Failed to create meshlet pipeline layout!");
+    }
+
+    create_culling_pipelines();
+
+    mVertexBuffer = mpGpuResources->create_buffer(INITIAL_VERTEX_BYTES,
+                                                  VK_BUFFER_USAGE_VERTEX_BUFFER_BIT | VK_BUFFER_USAGE_STORAGE_BUFFER_BIT,
+                                                  HOST_MEMORY);
+    mMeshletBuffer = mpGpuResources->create_buffer(INITIAL_MESHLET_BYTES, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT, HOST_MEMORY);
+    if (mMeshShaders) {
+        mMeshletVertexBuffer = mpGpuResources->create_buffer(INITIAL_VERTEX_BYTES, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT, HOST_MEMORY);
+        mMeshletTriangleBuffer = mpGpuResources->create_buffer(INITIAL_INDEX_BYTES, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT, HOST_MEMORY);
+    }
+    else {
+        mIndexBuffer = mpGpuResources->create_buffer(INITIAL_INDEX_BYTES, VK_BUFFER_USAGE_INDEX_BUFFER_BIT, HOST_MEMORY);
+    }
+
+    // The culling shader always declares the draw commands, so the mesh shader path keeps a
+    // small buffer bound there
+    mFrames.resize(framesInFlight);
+    for (FrameBuffers& frame : mFrames) {
+        frame.objects = mpGpuResources->create_buffer(INITIAL_OBJECT_CAPACITY * sizeof(ObjectData),
+                                                      VK_BUFFER_USAGE_STORAGE_BUFFER_BIT, HOST_MEMORY);
+        frame.visibleClusters = mpGpuResources->create_buffer(INITIAL_CLUSTER_CAPACITY * 2 * sizeof(uint32_t),
+                                                              GPU_WRITTEN_USAGE, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
+        frame.drawCommands = mpGpuResources->create_buffer(INITIAL_CLUSTER_CAPACITY * sizeof(VkDrawIndexedIndirectCommand),
+                                                           INDIRECT_USAGE, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
+        frame.counters = mpGpuResources->create_buffer(sizeof(ClusterCounters), INDIRECT_USAGE, HOST_MEMORY);
+        memset(mpGpuResources->get_mapped(frame.counters), 0, sizeof(ClusterCounters));
+        if (mMeshShaders) {
+            frame.taskCommands = mpGpuResources->create_buffer(sizeof(VkDrawMeshTasksIndirectCommandNV), INDIRECT_USAGE,
+                                                               VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
+        }
+    }
+}
+
+//------------------------------------------------------------------------------------------
+// The descriptor set layouts are owned by the descriptor allocator's cache
+//------------------------------------------------------------------------------------------
+void MeshletRenderer::clean_up() {
+    if (!mSupported) {
+        return;
+    }
+
+    for (FrameBuffers& frame : mFrames) {
+        BufferHandle buffers[] = { frame.objects, frame.visibleClusters, frame.drawCommands, frame.taskCommands, frame.counters };
+        for (BufferHandle buffer : buffers) {
+            if (!buffer.is_null()) {
+                mpGpuResources->destroy_buffer(buffer);
+            }
+        }
+    }
+    mFrames.clear();
+
+    BufferHandle geometry[] = { mVertexBuffer, mIndexBuffer, mMeshletBuffer, mMeshletVertexBuffer, mMeshletTriangleBuffer };
+    for (BufferHandle buffer : geometry) {
+        if (!buffer.is_null()) {
+            mpGpuResources->destroy_buffer(buffer);
+        }
+    }
+    mMeshes = ResourcePool<MeshletMeshTag, Mesh>();
+    mVertexCount = mIndexCount = mMeshletCount = mMeshletVertexCount = mMeshletTriangleWords = 0;
+
+    mpGpuResources->destroy_pipeline(mCullPipeline);
+    if (mMeshShaders) {
+        mpGpuResources->destroy_pipeline(mBuildTasksPipeline);
+    }
+    vkDestroyPipelineLayout(mDevice, mCullPipelineLayout, nullptr);
+    mCullPipelineLayout = VK_NULL_HANDLE;
+    vkDestroyPipelineLayout(mDevice, mPipelineLayout, nullptr);
+    mPipelineLayout = VK_NULL_HANDLE;
+}
+
+//------------------------------------------------------------------------------------------
+//------------------------------------------------------------------------------------------
+MeshletMeshHandle MeshletRenderer::add_mesh(const MeshData& meshData, const MeshletData& meshletData) {
+    return add_mesh(meshData.get_view(), meshletData.get_view());
+}
+
+//------------------------------------------------------------------------------------------
+// The vertex path expands every meshlet into its own range of the index buffer, the mesh
+// shader path uploads the meshlet vertices and packed triangles as they are
+//------------------------------------------------------------------------------------------
+MeshletMeshHandle MeshletRenderer::add_mesh(const MeshView& meshView, const MeshletView& meshletView) {
+    if (meshView.vertexFormat != VERTEX_FORMAT_FLOAT) {
+        throw std::runtime_error("Failed to add meshlet mesh, its vertices are quantized!");
+    }
+
+    std::vector<MeshletGpuData> meshlets(meshletView.meshletCount);
+    std::vector<uint32_t> indices;
+
+    for (uint32_t i = 0; i < meshletView.meshletCount; i++) {
+        const Meshlet& meshlet = meshletView.pMeshlets[i];
+
+        MeshletGpuData& data = meshlets[i];
+        data.boundingSphere = meshlet.boundingSphere;
+        data.cone = meshlet.cone;
+        data.vertexOffset = mMeshletVertexCount + meshlet.vertexOffset;
+        data.triangleOffset = mMeshletTriangleWords + meshlet.triangleOffset / 4;
+        data.vertexCount = meshlet.vertexCount;
+        data.triangleCount = meshlet.triangleCount;
+        data.firstIndex = mIndexCount + static_cast<uint32_t>(indices.size());
+        data.padding[0] = data.padding[1] = data.padding[2] = 0;
+
+        if (!mMeshShaders) {
+            for (uint32_t j = 0; j < 3 * meshlet.triangleCount; j++) {
+                indices.push_back(meshletView.pVertices[meshlet.vertexOffset + meshletView.pTriangles[meshlet.triangleOffset + j]]);
+            }
+        }
+    }
+
+    append_geometry(mVertexBuffer, mVertexCount * sizeof(Vertex), meshView.pVertices,
+                    meshView.vertexCount * static_cast<uint32_t>(sizeof(Vertex)),
+                    VK_BUFFER_USAGE_VERTEX_BUFFER_BIT | VK_BUFFER_USAGE_STORAGE_BUFFER_BIT);
+    append_geometry(mMeshletBuffer, mMeshletCount * sizeof(MeshletGpuData), meshlets.data(),
+                    static_cast<uint32_t>(meshlets.size() * sizeof(MeshletGpuData)), VK_BUFFER_USAGE_STORAGE_BUFFER_BIT);
+
+    if (mMeshShaders) {
+        append_geometry(mMeshletVertexBuffer, mMeshletVertexCount * sizeof(uint32_t), meshletView.pVertices,
+                        meshletView.vertexCount * static_cast<uint32_t>(sizeof(uint32_t)), VK_BUFFER_USAGE_STORAGE_BUFFER_BIT);
+        append_geometry(mMeshletTriangleBuffer, mMeshletTriangleWords * sizeof(uint32_t), meshletView.pTriangles,
+                        meshletView.triangleBytes, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT);
+        mMeshletVertexCount += meshletView.vertexCount;
+        mMeshletTriangleWords += meshletView.triangleBytes / 4;
+    }
+    else {
+        append_geometry(mIndexBuffer, mIndexCount * sizeof(uint32_t), indices.data(),
+                        static_cast<uint32_t>(indices.size() * sizeof(uint32_t)), VK_BUFFER_USAGE_INDEX_BUFFER_BIT);
+        mIndexCount += static_cast<uint32_t>(indices.size());
+    }
+
+    Mesh mesh;
+    mesh.firstMeshlet = mMeshletCount;
+    mesh.meshletCount = static_cast<uint32_t>(meshlets.size());
+    mesh.vertexOffset = static_cast<int32_t>(mVertexCount);
+    mesh.boundingSphere = meshView.boundingSphere;
+
+    mVertexCount += meshView.vertexCount;
+    mMeshletCount += mesh.meshletCount;
+
+    return mMeshes.add(mesh);
+}
+
+//------------------------------------------------------------------------------------------
+// The caller waits on the frame slot before calling this, so the slot's counters are final
+//------------------------------------------------------------------------------------------
+void MeshletRenderer::begin_frame(uint32_t frameIndex) {
+    if (!mSupported) {
+        return;
+    }
+
+    mCurrentFrame = frameIndex % static_cast<uint32_t>(mFrames.size());
+    mObjects.clear();
+    mClusterCapacity = 0;
+
+    const ClusterCounters* pCounters = static_cast<const ClusterCounters*>(mpGpuResources->get_mapped(mFrames[mCurrentFrame].counters));
+    mStats.visibleMeshlets = pCounters->drawCount;
+    mStats.frustumCulled = pCounters->frustumCulled;
+    mStats.backfaceCulled = pCounters->backfaceCulled;
+}
+
+//------------------------------------------------------------------------------------------
+//------------------------------------------------------------------------------------------
+void MeshletRenderer::submit(MeshletMeshHandle mesh, const glm::mat4& transform) {
+    const Mesh& meshData = mMeshes.get<0>(mesh);
+
+    ObjectData object;
+    object.transform = transform;
+    object.boundingSphere = meshData.boundingSphere;
+    object.firstMeshlet = meshData.firstMeshlet;
+    object.meshletCount = meshData.meshletCount;
+    object.vertexOffset = meshData.vertexOffset;
+    object.padding = 0;
+
+    mObjects.push_back(object);
+    mClusterCapacity += meshData.meshletCount;
+}
+
+//------------------------------------------------------------------------------------------
+// Every submitted meshlet gets room in the frame's cluster buffers, culling fills them
+//------------------------------------------------------------------------------------------
+void MeshletRenderer::prepare(const glm::mat4& viewProjection, const glm::vec3& cameraPosition) {
+    if (!mSupported) {
+        return;
+    }
+
+    auto start = std::chrono::high_resolution_clock::now();
+
+    const uint32_t objectCount = static_cast<uint32_t>(mObjects.size());
+    FrameBuffers& frame = mFrames[mCurrentFrame];
+
+    mViewProjection = viewProjection;
+    InstancedRenderer::extract_frustum_planes(viewProjection, mCullPushConstants.frustumPlanes);
+    mCullPushConstants.cameraPosition = cameraPosition;
+    mCullPushConstants.objectCount = objectCount;
+    mCullPushConstants.useMeshShaders = mMeshShaders ? 1 : 0;
+    mCullPushConstants.taskCommandCount = (mClusterCapacity + MESH_TASK_CHUNK - 1) / MESH_TASK_CHUNK;
+
+    ensure_buffer(frame.objects, objectCount * sizeof(ObjectData), VK_BUFFER_USAGE_STORAGE_BUFFER_BIT, HOST_MEMORY);
+    if (objectCount > 0) {
+        memcpy(mpGpuResources->get_mapped(frame.objects), mObjects.data(), objectCount * sizeof(ObjectData));
+    }
+
+    ensure_buffer(frame.visibleClusters, mClusterCapacity * 2 * sizeof(uint32_t), GPU_WRITTEN_USAGE,
+                  VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
+    if (mMeshShaders) {
+        ensure_buffer(frame.taskCommands, mCullPushConstants.taskCommandCount * sizeof(VkDrawMeshTasksIndirectCommandNV),
+                      INDIRECT_USAGE, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
+    }
+    else {
+        ensure_buffer(frame.drawCommands, mClusterCapacity * sizeof(VkDrawIndexedIndirectCommand), INDIRECT_USAGE,
+                      VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
+    }
+
+    auto end = std::chrono::high_resolution_clock::now();
+    mStats.objects = objectCount;
+    mStats.meshlets = mClusterCapacity;
+    mStats.prepareMs = std::chrono::duration<double, std::milli>(end - start).count();
+}
+
+//------------------------------------------------------------------------------------------
+// One workgroup per object tests the object's bounds and then each of its meshlets. The
+// survivors are appended to the visible clusters, and on the vertex path also get their
+// indexed indirect command in the same slot. The mesh shader path then splits the cluster
+// count into mesh task commands.
+//------------------------------------------------------------------------------------------
+void MeshletRenderer::dispatch_culling(VkCommandBuffer commandBuffer) {
+    if (!mSupported || mObjects.empty()) {
+        return;
+    }
+
+    const FrameBuffers& frame = mFrames[mCurrentFrame];
+    const uint32_t objectCount = static_cast<uint32_t>(mObjects.size());
+
+    vkCmdFillBuffer(commandBuffer, mpGpuResources->get_buffer(frame.counters), 0, sizeof(ClusterCounters), 0);
+    if (!mMeshShaders && !mUseDrawCount) {
+        // Without a draw count every slot is drawn, the unused ones with zero instances
+        vkCmdFillBuffer(commandBuffer, mpGpuResources->get_buffer(frame.drawCommands), 0,
+                        mClusterCapacity * sizeof(VkDrawIndexedIndirectCommand), 0);
+    }
+
+    VkMemoryBarrier barrier{};
+    barrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+    barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+    barrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT;
+    vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+                         0, 1, &barrier, 0, nullptr, 0, nullptr);
+
+    VkDescriptorSet descriptorSet = mpDescriptorAllocator->allocate_transient(mCullSetLayout);
+    std::vector<BufferHandle> buffers = { mMeshletBuffer, frame.objects, frame.visibleClusters, frame.drawCommands, frame.counters };
+    if (mMeshShaders) {
+        buffers.push_back(frame.taskCommands);
+    }
+    write_storage_descriptors(descriptorSet, buffers);
+
+    vkCmdBindDescriptorSets(commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, mCullPipelineLayout, 0, 1, &descriptorSet, 0, nullptr);
+    vkCmdPushConstants(commandBuffer, mCullPipelineLayout, VK_SHADER_STAGE_COMPUTE_BIT, 0, sizeof(CullPushConstants),
+                       &mCullPushConstants);
+
+    vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, mpGpuResources->get_pipeline(mCullPipeline));
+    vkCmdDispatch(commandBuffer, std::min(objectCount, MAX_WORKGROUPS_PER_ROW),
+                  (objectCount + MAX_WORKGROUPS_PER_ROW - 1) / MAX_WORKGROUPS_PER_ROW, 1);
+
+    VkPipelineStageFlags drawStages = VK_PIPELINE_STAGE_DRAW_INDIRECT_BIT | VK_PIPELINE_STAGE_HOST_BIT;
+    if (mMeshShaders) {
+        barrier.srcAccessMask = VK_ACCESS_SHADER_WRITE_BIT;
+        barrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT;
+        vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+                             0, 1, &barrier, 0, nullptr, 0, nullptr);
+
+        vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, mpGpuResources->get_pipeline(mBuildTasksPipeline));
+        vkCmdDispatch(commandBuffer, (mCullPushConstants.taskCommandCount + BUILD_TASKS_GROUP_SIZE - 1) / BUILD_TASKS_GROUP_SIZE, 1, 1);
+        drawStages |= VK_PIPELINE_STAGE_MESH_SHADER_BIT_NV;
+    }
+
+    // The counters are read on the host once the frame retired
+    barrier.srcAccessMask = VK_ACCESS_SHADER_WRITE_BIT;
+    barrier.dstAccessMask = VK_ACCESS_INDIRECT_COMMAND_READ_BIT | VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_HOST_READ_BIT;
+    vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, drawStages, 0, 1, &barrier, 0, nullptr, 0, nullptr);
+}
+
+//------------------------------------------------------------------------------------------
+// A single indirect call either way, sized for every submitted meshlet
+//------------------------------------------------------------------------------------------
+void MeshletRenderer::record(VkCommandBuffer commandBuffer) {
+    if (!mSupported || mObjects.empty() || mPipeline.is_null()) {
+        return;
+    }
+
+    const FrameBuffers& frame = mFrames[mCurrentFrame];
+    VkDescriptorSet descriptorSet = mpDescriptorAllocator->allocate_transient(mDescriptorSetLayout);
+    if (mMeshShaders) {
+        write_storage_descriptors(descriptorSet, { frame.objects, mMeshletBuffer, frame.visibleClusters, mMeshletVertexBuffer,
+                                                   mMeshletTriangleBuffer, mVertexBuffer });
+    }
+    else {
+        write_storage_descriptors(descriptorSet, { frame.objects });
+    }
+
+    PushConstants pushConstants;
+    pushConstants.viewProjection = mViewProjection;
+
+    const VkShaderStageFlags stage = mMeshShaders ? VK_SHADER_STAGE_MESH_BIT_NV : VK_SHADER_STAGE_VERTEX_BIT;
+    vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, mpGpuResources->get_pipeline(mPipeline));
+    vkCmdBindDescriptorSets(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, mPipelineLayout, 0, 1, &descriptorSet, 0, nullptr);
+    vkCmdPushConstants(commandBuffer, mPipelineLayout, stage, 0, sizeof(PushConstants), &pushConstants);
+
+    if (mMeshShaders) {
+        mCmdDrawMeshTasksIndirect(commandBuffer, mpGpuResources->get_buffer(frame.taskCommands), 0,
+                                  mCullPushConstants.taskCommandCount, sizeof(VkDrawMeshTasksIndirectCommandNV));
+        return;
+    }
+
+    VkBuffer vertexBuffer = mpGpuResources->get_buffer(mVertexBuffer);
+    VkDeviceSize offset = 0;
+    vkCmdBindVertexBuffers(commandBuffer, 0, 1, &vertexBuffer, &offset);
+    vkCmdBindIndexBuffer(commandBuffer, mpGpuResources->get_buffer(mIndexBuffer), 0, VK_INDEX_TYPE_UINT32);
+
+    const VkBuffer drawCommands = mpGpuResources->get_buffer(frame.drawCommands);
+    const uint32_t stride = sizeof(VkDrawIndexedIndirectCommand);
+    if (mUseDrawCount) {
+        mCmdDrawIndexedIndirectCount(commandBuffer, drawCommands, 0, mpGpuResources->get_buffer(frame.counters), 0,
+                                     mClusterCapacity, stride);
+    }
+    else {
+        vkCmdDrawIndexedIndirect(commandBuffer, drawCommands, 0, mClusterCapacity, stride);
+    }
+}
+
+//------------------------------------------------------------------------------------------
+//------------------------------------------------------------------------------------------
+void MeshletRenderer::print_stats(std::ostream& out) const {
+    out << "Meshlet renderer stats:\n";
+    if (!mSupported) {
+        out << "\tUnsupported, needs multi draw indirect with firstInstance\n";
+        return;
+    }
+    out << "\tPath: " << (mMeshShaders ? "mesh shaders" : (mUseDrawCount ? "vertex, indirect count" : "vertex")) << '\n';
+    out << "\tObjects: " << mStats.objects << '\n';
+    out << "\tMeshlets: " << mStats.meshlets << '\n';
+    out << "\tVisible meshlets: " << mStats.visibleMeshlets << '\n';
+    out << "\tFrustum culled: " << mStats.frustumCulled << '\n';
+    out << "\tBackface culled: " << mStats.backfaceCulled << '\n';
+    out << "\tCPU prepare: " << mStats.prepareMs << " ms\n";
+}
+
+//------------------------------------------------------------------------------------------
+// Grow a buffer whose contents are rewritten every frame
+//------------------------------------------------------------------------------------------
+void MeshletRenderer::ensure_buffer(BufferHandle& buffer, VkDeviceSize size, VkBufferUsageFlags usage,
+                                    VkMemoryPropertyFlags properties) {
+    const VkDeviceSize currentSize = mpGpuResources->get_buffer_size(buffer);
+    if (size <= currentSize) {
+        return;
+    }
+
+    mpGpuResources->destroy_buffer(buffer);
+    buffer = mpGpuResources->create_buffer(std::max(size, currentSize * 2), usage, properties);
+}
+
+//------------------------------------------------------------------------------------------
+// Grow a host visible geometry buffer, keeping what it already holds
+//------------------------------------------------------------------------------------------
+void MeshletRenderer::append_geometry(BufferHandle& buffer, uint32_t usedBytes, const void* pData, uint32_t dataBytes,
+                                      VkBufferUsageFlags usage) {
+    const VkDeviceSize currentSize = mpGpuResources->get_buffer_size(buffer);
+    if (usedBytes + dataBytes > currentSize) {
+        BufferHandle grown = mpGpuResources->create_buffer(std::max<VkDeviceSize>(usedBytes + dataBytes, currentSize * 2),
+                                                           usage, HOST_MEMORY);
+        memcpy(mpGpuResources->get_mapped(grown), mpGpuResources->get_mapped(buffer), usedBytes);
+        mpGpuResources->destroy_buffer(buffer);
+        buffer = grown;
+    }
+
+    memcpy(static_cast<char*>(mpGpuResources->get_mapped(buffer)) + usedBytes, pData, dataBytes);
+}
+
+//------------------------------------------------------------------------------------------
+// Bind whole buffers to bindings 0 to size - 1
+//------------------------------------------------------------------------------------------
+void MeshletRenderer::write_storage_descriptors(VkDescriptorSet descriptorSet, const std::vector<BufferHandle>& buffers) {
+    const uint32_t count = static_cast<uint32_t>(buffers.size());
+    std::vector<VkDescriptorBufferInfo> bufferInfos(count);
+    std::vector<VkWriteDescriptorSet> descriptorWrites(count);
+    for (uint32_t i = 0; i < count; i++) {
+        bufferInfos[i] = {};
+        bufferInfos[i].buffer = mpGpuResources->get_buffer(buffers[i]);
+        bufferInfos[i].offset = 0;
+        bufferInfos[i].range = VK_WHOLE_SIZE;
+
+        descriptorWrites[i] = {};
+        descriptorWrites[i].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+        descriptorWrites[i].dstSet = descriptorSet;
+        descriptorWrites[i].dstBinding = i;
+        descriptorWrites[i].descriptorCount = 1;
+        descriptorWrites[i].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+        descriptorWrites[i].pBufferInfo = &bufferInfos[i];
+    }
+    vkUpdateDescriptorSets(mDevice, count, descriptorWrites.data(), 0, nullptr);
+}
+
+//------------------------------------------------------------------------------------------
+// Both passes share one layout: meshlets, objects, visible clusters, draw commands, counters
+// and task commands in bindings 0 to 5, with the culling inputs in a push constant
+//------------------------------------------------------------------------------------------
+void MeshletRenderer::create_culling_pipelines() {
+    std::vector<VkDescriptorSetLayoutBinding> bindings(6);
+    for (uint32_t i = 0; i < bindings.size(); i++) {
+        bindings[i] = {};
+        bindings[i].binding = i;
+        bindings[i].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+        bindings[i].descriptorCount = 1;
+        bindings[i].stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
+    }
+    mCullSetLayout = mpDescriptorAllocator->get_layout(bindings);
+
+    VkPushConstantRange pushConstantRange{};
+    pushConstantRange.stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
+    pushConstantRange.offset = 0;
+    pushConstantRange.size = sizeof(CullPushConstants);
+
+    VkPipelineLayoutCreateInfo layoutCreateInfo{};
+    layoutCreateInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
+    layoutCreateInfo.setLayoutCount = 1;
+    layoutCreateInfo.pSetLayouts = &mCullSetLayout;
+    layoutCreateInfo.pushConstantRangeCount = 1;
+    layoutCreateInfo.pPushConstantRanges = &pushConstantRange;
+
+    if (vkCreatePipelineLayout(mDevice, &layoutCreateInfo, nullptr, &mCullPipelineLayout) != VK_SUCCESS) {
+        throw std::runtime_error("Failed to create meshlet culling pipeline layout!");
+    }
+
+    const char* shaderNames[2] = { "cull_meshlets.comp.spv", "build_meshlet_tasks.comp.spv" };
+    PipelineHandle* pipelines[2] = { &mCullPipeline, &mBuildTasksPipeline };
+    const uint32_t pipelineCount = mMeshShaders ? 2 : 1;
+
+    for (uint32_t i = 0; i < pipelineCount; i++) {
+        VkShaderModule shaderModule = load_shader_module(mDevice, shaderNames[i]);
+
+        VkComputePipelineCreateInfo createInfo{};
+        createInfo.sType = VK_STRUCTURE_TYPE_COMPUTE_PIPELINE_CREATE_INFO;
+        createInfo.stage.sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
+        createInfo.stage.stage = VK_SHADER_STAGE_COMPUTE_BIT;
+        createInfo.stage.module = shaderModule;
+        createInfo.stage.pName = "main";
+        createInfo.layout = mCullPipelineLayout;
+
+        VkPipeline pipeline;
+        VkResult result = vkCreateComputePipelines(mDevice, VK_NULL_HANDLE, 1, &createInfo, nullptr, &pipeline);
+        vkDestroyShaderModule(mDevice, shaderModule, nullptr);
+        if (result != VK_SUCCESS) {
+            throw std::runtime_error("Failed to create meshlet culling pipeline!");
+        }
+
+        *pipelines[i] = mpGpuResources->add_pipeline(pipeline, mCullPipelineLayout, VK_PIPELINE_BIND_POINT_COMPUTE, false);
+    }
+}
@@ -0,0 +1,429 @@
+//======================================================================
+// PackFile.cpp
+//
+// Keegan Kochis
+// Created: 2026/10/19
+// The definition of the PackFile class.
+//======================================================================
+
+#include "PackFile.h"
+#include "ContentHash.h"
+#include "Lz4.h"
+
+#include <cstdint>
+#include <cstring>
+
+#include <algorithm>
+#include <atomic>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <numeric>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+static_assert(sizeof(PackFileHeader) == 80, "The pack file header layout changed, bump PackFile::VERSION");
+static_assert(sizeof(PackFileEntry) == 40, "The pack file entry layout changed, bump PackFile::VERSION");
+static_assert(sizeof(PackFileChunk) == 16, "The pack file chunk layout changed, bump PackFile::VERSION");
+
+static const uint64_t PATH_SEED = 0x4A50414B50415448ull;
+
+static uint64_t align_offset(uint64_t offset) {
+    return (offset + PackFile::ALIGNMENT - 1) & ~(PackFile::ALIGNMENT - 1);
+}
+
+static uint32_t get_chunk_count(uint64_t bytes, uint32_t chunkSize) {
+    return static_cast<uint32_t>((bytes + chunkSize - 1) / chunkSize);
+}
+
+PackFile::PackFile() {
+}
+
+//------------------------------------------------------------------------------------------
+//------------------------------------------------------------------------------------------
+void PackFile::open(const std::string& path) {
+    close();
+    mFile.open(path);
+    try {
+        validate();
+    }
+    catch (...) {
+        mFile.close();
+        throw;
+    }
+
+    mpHeader = reinterpret_cast<const PackFileHeader*>(mFile.get_data());
+    mpEntries = reinterpret_cast<const PackFileEntry*>(mFile.get_range(mpHeader->sections[PACK_FILE_SECTION_ENTRIES]));
+    mpChunks = reinterpret_cast<const PackFileChunk*>(mFile.get_range(mpHeader->sections[PACK_FILE_SECTION_CHUNKS]));
+    mpPaths = reinterpret_cast<const char*>(mFile.get_range(mpHeader->sections[PACK_FILE_SECTION_PATHS]));
+}
+
+//------------------------------------------------------------------------------------------
+//------------------------------------------------------------------------------------------
+void PackFile::close() {
+    mFile.close();
+    mpHeader = nullptr;
+    mpEntries = nullptr;
+    mpChunks = nullptr;
+    mpPaths = nullptr;
+}
+
+//------------------------------------------------------------------------------------------
+// The path is compared as well, so a path that isn't packed but shares a hash isn't found
+//------------------------------------------------------------------------------------------
+uint32_t PackFile::find(const std::string& path) const {
+    const std::string normalizedPath = normalize_path(path);
+    const uint64_t hash = hash_path(normalizedPath);
+    const PackFileEntry* pEnd = mpEntries + mpHeader->entryCount;
+    const PackFileEntry* pEntry = std::lower_bound(mpEntries, pEnd, hash, [](const PackFileEntry& entry, uint64_t value) {
+        return entry.pathHash < value;
+    });
+    if (pEntry == pEnd || pEntry->pathHash != hash || normalizedPath != mpPaths + pEntry->pathOffset) {
+        return INVALID_ENTRY;
+    }
+    return static_cast<uint32_t>(pEntry - mpEntries);
+}
+
+//------------------------------------------------------------------------------------------
+//------------------------------------------------------------------------------------------
+const uint8_t* PackFile::get_mapped(uint32_t entry) const {
+    const PackFileEntry& packEntry = mpEntries[entry];
+    if (packEntry.compression != PACK_COMPRESSION_NONE) {
+        return nullptr;
+    }
+    return mFile.get_data() + packEntry.offset;
+}
+
+//------------------------------------------------------------------------------------------
+//------------------------------------------------------------------------------------------
+bool PackFile::read_chunk(uint32_t entry, uint32_t chunk, uint8_t* pDestination) const {
+    const PackFileEntry& packEntry = mpEntries[entry];
+    const PackFileChunk& packChunk = mpChunks[packEntry.firstChunk + chunk];
+    const uint64_t start = static_cast<uint64_t>(chunk) * mpHeader->chunkSize;
+    const uint32_t bytes = static_cast<uint32_t>(std::min<uint64_t>(mpHeader->chunkSize, packEntry.bytes - start));
+    const uint8_t* pStored = mFile.get_data() + packChunk.offset;
+    if (packChunk.storedBytes == bytes) {
+        memcpy(pDestination + start, pStored, bytes);
+        return true;
+    }
+    return lz4_decompress(pStored, packChunk.storedBytes, pDestination + start, bytes);
+}
+
+//------------------------------------------------------------------------------------------
+//------------------------------------------------------------------------------------------
+void PackFile::read(uint32_t entry, uint8_t* pDestination, JobSystem* pJobSystem) const {
+    const PackFileEntry& packEntry = mpEntries[entry];
+    if (packEntry.compression == PACK_COMPRESSION_NONE) {
+        if (packEntry.bytes > 0) {
+            memcpy(pDestination, get_mapped(entry), packEntry.bytes);
+        }
+        return;
+    }
+
+    std::atomic<bool> corrupt{false};
+    auto readChunks = [&](uint32_t begin, uint32_t end) {
+        for (uint32_t i = begin; i < end; i++) {
+            if (!read_chunk(entry, i, pDestination)) {
+                corrupt.store(true, std::memory_order_relaxed);
+            }
+        }
+    };
+    if (pJobSystem) {
+        pJobSystem->parallel_for(packEntry.chunkCount, 1, readChunks);
+    }
+    else {
+        readChunks(0, packEntry.chunkCount);
+    }
+    if (corrupt.load()) {
+        throw std::runtime_error("Failed to read " + std::string(get_entry_path(entry)) + " from pack file " +
+                                 get_path() + ", it's corrupt!");
+    }
+}
+
+//------------------------------------------------------------------------------------------
+// Packs are shared between platforms, so paths match regardless of case and separators
+//------------------------------------------------------------------------------------------
+std::string PackFile::normalize_path(const std::string& path) {
+    std::string normalizedPath;
+    normalizedPath.reserve(path.size());
+    for (char c : path) {
+        if (c == '\\') {
+            c = '/';
+        }
+        else if (c >= 'A' && c <= 'Z') {
+            c = static_cast<char>(c - 'A' + 'a');
+        }
+        if (c == '/' && (normalizedPath.empty() || normalizedPath.back() == '/')) {
+            continue;
+        }
+        if (c == '/' && normalizedPath == ".") {
+            normalizedPath.clear();
+            continue;
+        }
+        normalizedPath.push_back(c);
+    }
+    return normalizedPath;
+}
+
+//------------------------------------------------------------------------------------------
+//------------------------------------------------------------------------------------------
+uint64_t PackFile::hash_path(const std::string& normalizedPath) {
+    return hash_string(normalizedPath, PATH_SEED);
+}
+
+//------------------------------------------------------------------------------------------
+// Every chunk of every input is compressed as its own job into its own buffer, then the
+// archive is written front to back. Entries are laid out in hash order, so a directory's
+// files end up wherever their hashes put them rather than next to each other.
+//------------------------------------------------------------------------------------------
+void PackFile::write(const std::string& path, const std::vector<PackInput>& inputs, PackCompression compression,
+                     JobSystem* pJobSystem) {
+    const uint32_t inputCount = static_cast<uint32_t>(inputs.size());
+    std::vector<std::string> packPaths(inputCount);
+    std::vector<uint64_t> hashes(inputCount);
+    for (uint32_t i = 0; i < inputCount; i++) {
+        packPaths[i] = normalize_path(inputs[i].packPath);
+        hashes[i] = hash_path(packPaths[i]);
+    }
+    std::vector<uint32_t> order(inputCount);
+    std::iota(order.begin(), order.end(), 0);
+    std::sort(order.begin(), order.end(), [&hashes](uint32_t a, uint32_t b) { return hashes[a] < hashes[b]; });
+    for (uint32_t i = 1; i < inputCount; i++) {
+        if (hashes[order[i]] == hashes[order[i - 1]]) {
+            throw std::runtime_error("Failed to create pack file " + path + ", " + packPaths[order[i]] + " and " +
+                                     packPaths[order[i - 1]] + " have the same path hash!");
+        }
+    }
+
+    // Empty files can't be mapped, they are entries without data
+    std::vector<std::unique_ptr<MappedFile>> sources(inputCount);
+    std::vector<uint64_t> sizes(inputCount, 0);
+    for (uint32_t i = 0; i < inputCount; i++) {
+        sizes[i] = std::filesystem::file_size(inputs[i].sourcePath);
+        if (sizes[i] > 0) {
+            sources[i] = std::make_unique<MappedFile>();
+            sources[i]->open(inputs[i].sourcePath);
+        }
+    }
+
+    // Chunk lists of the inputs that are compressed, a chunk without stored data didn't shrink
+    std::vector<uint32_t> firstChunks(inputCount, 0);
+    uint32_t chunkCount = 0;
+    for (uint32_t i = 0; i < inputCount; i++) {
+        firstChunks[i] = chunkCount;
+        if (compression == PACK_COMPRESSION_LZ4) {
+            chunkCount += get_chunk_count(sizes[i], CHUNK_SIZE);
+        }
+    }
+    std::vector<uint32_t> chunkInputs(chunkCount);
+    for (uint32_t i = 0; i < inputCount; i++) {
+        const uint32_t end = i + 1 < inputCount ? firstChunks[i + 1] : chunkCount;
+        std::fill(chunkInputs.begin() + firstChunks[i], chunkInputs.begin() + end, i);
+    }
+    std::vector<std::vector<uint8_t>> compressedChunks(chunkCount);
+    auto compressChunks = [&](uint32_t begin, uint32_t end) {
+        for (uint32_t i = begin; i < end; i++) {
+            const uint32_t input = chunkInputs[i];
+            const uint64_t start = static_cast<uint64_t>(i - firstChunks[input]) * CHUNK_SIZE;
+            const size_t bytes = static_cast<size_t>(std::min<uint64_t>(CHUNK_SIZE, sizes[input] - start));
+            std::vector<uint8_t>& compressed = compressedChunks[i];
+            compressed.resize(lz4_compress_bound(bytes));
+            const size_t compressedBytes = lz4_compress(sources[input]->get_data() + start, bytes, compressed.data(),
+                                                        bytes - 1);
+            compressed.resize(compressedBytes);
+            compressed.shrink_to_fit();
+        }
+    };
+    if (pJobSystem) {
+        pJobSystem->parallel_for(chunkCount, 4, compressChunks);
+    }
+    else {
+        compressChunks(0, chunkCount);
+    }
+
+    // Stored chunks keep their uncompressed size, so an entry is only worth decompressing
+    // when it saved at least an eighth
+    std::vector<uint32_t> entryCompressions(inputCount, PACK_COMPRESSION_NONE);
+    for (uint32_t i = 0; i < inputCount; i++) {
+        if (compression != PACK_COMPRESSION_LZ4 || sizes[i] == 0) {
+            continue;
+        }
+        uint64_t storedBytes = 0;
+        const uint32_t count = get_chunk_count(sizes[i], CHUNK_SIZE);
+        for (uint32_t j = 0; j < count; j++) {
+            const uint64_t start = static_cast<uint64_t>(j) * CHUNK_SIZE;
+            const size_t compressedBytes = compressedChunks[firstChunks[i] + j].size();
+            storedBytes += compressedBytes > 0 ? compressedBytes : std::min<uint64_t>(CHUNK_SIZE, sizes[i] - start);
+        }
+        if (storedBytes <= sizes[i] - sizes[i] / 8) {
+            entryCompressions[i] = PACK_COMPRESSION_LZ4;
+        }
+    }
+
+    std::vector<PackFileEntry> entries(inputCount);
+    std::vector<PackFileChunk> chunks;
+    std::string paths;
+    for (uint32_t i = 0; i < inputCount; i++) {
+        const uint32_t input = order[i];
+        PackFileEntry& entry = entries[i];
+        entry = {};
+        entry.pathHash = hashes[input];
+        entry.bytes = sizes[input];
+        entry.pathOffset = static_cast<uint32_t>(paths.size());
+        entry.compression = entryCompressions[input];
+        paths += packPaths[input];
+        paths.push_back('\0');
+        if (entry.compression == PACK_COMPRESSION_LZ4) {
+            entry.firstChunk = static_cast<uint32_t>(chunks.size());
+            entry.chunkCount = get_chunk_count(sizes[input], CHUNK_SIZE);
+            for (uint32_t j = 0; j < entry.chunkCount; j++) {
+                const uint64_t start = static_cast<uint64_t>(j) * CHUNK_SIZE;
+                const size_t compressedBytes = compressedChunks[firstChunks[input] + j].size();
+                PackFileChunk chunk = {};
+                chunk.storedBytes = static_cast<uint32_t>(compressedBytes > 0 ? compressedBytes
+                                                                              : std::min<uint64_t>(CHUNK_SIZE, sizes[input] - start));
+                chunks.push_back(chunk);
+            }
+        }
+    }
+
+    PackFileHeader header = {};
+    header.magic = MAGIC;
+    header.version = VERSION;
+    header.entryCount = inputCount;
+    header.chunkCount = static_cast<uint32_t>(chunks.size());
+    header.chunkSize = CHUNK_SIZE;
+    const uint64_t sectionBytes[PACK_FILE_SECTION_COUNT] = {
+        entries.size() * sizeof(PackFileEntry), chunks.size() * sizeof(PackFileChunk), paths.size()
+    };
+    uint64_t offset = align_offset(sizeof(PackFileHeader));
+    for (uint32_t i = 0; i < PACK_FILE_SECTION_COUNT; i++) {
+        header.sections[i].offset = offset;
+        header.sections[i].bytes = sectionBytes[i];
+        offset = align_offset(offset + sectionBytes[i]);
+    }
+
+    // Stored entries start on the alignment, compressed chunks follow each other
+    for (PackFileEntry& entry : entries) {
+        if (entry.compression == PACK_COMPRESSION_NONE) {
+            offset = align_offset(offset);
+            entry.offset = offset;
+            offset += entry.bytes;
+            continue;
+        }
+        entry.offset = offset;
+        for (uint32_t j = 0; j < entry.chunkCount; j++) {
+            chunks[entry.firstChunk + j].offset = offset;
+            offset += chunks[entry.firstChunk + j].storedBytes;
+        }
+    }
+
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    if (!file.is_open()) {
+        throw std::runtime_error("Failed to create pack file " + path + "!");
+    }
+
+    const char zeros[ALIGNMENT] = {};
+    const void* sectionData[PACK_FILE_SECTION_COUNT] = { entries.data(), chunks.data(), paths.data() };
+    file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    uint64_t written = sizeof(header);
+    for (uint32_t i = 0; i < PACK_FILE_SECTION_COUNT; i++) {
+        file.write(zeros, static_cast<std::streamsize>(header.sections[i].offset - written));
+        file.write(static_cast<const char*>(sectionData[i]), static_cast<std::streamsize>(sectionBytes[i]));
+        written = header.sections[i].offset + sectionBytes[i];
+    }
+    for (uint32_t i = 0; i < inputCount; i++) {
+        const uint32_t input = order[i];
+        const PackFileEntry& entry = entries[i];
+        file.write(zeros, static_cast<std::streamsize>(entry.offset - written));
+        written = entry.offset;
+        if (entry.compression == PACK_COMPRESSION_NONE) {
+            if (entry.bytes > 0) {
+                file.write(reinterpret_cast<const char*>(sources[input]->get_data()), static_cast<std::streamsize>(entry.bytes));
+            }
+            written += entry.bytes;
+            continue;
+        }
+        for (uint32_t j = 0; j < entry.chunkCount; j++) {
+            const std::vector<uint8_t>& compressed = compressedChunks[firstChunks[input] + j];
+            const PackFileChunk& chunk = chunks[entry.firstChunk + j];
+            const uint8_t* pStored = compressed.empty() ? sources[input]->get_data() + static_cast<uint64_t>(j) * CHUNK_SIZE
+                                                        : compressed.data();
+            file.write(reinterpret_cast<const char*>(pStored), chunk.storedBytes);
+            written += chunk.storedBytes;
+        }
+    }
+
+    if (!file.good()) {
+        throw std::runtime_error("Failed to write pack file " + path + "!");
+    }
+}
+
+//------------------------------------------------------------------------------------------
+// Every range reads go through is checked once here, as are the sorted hashes find()
+// depends on. The chunks themselves are checked as they decompress.
+//------------------------------------------------------------------------------------------
+void PackFile::validate() const {
+    const std::string& path = mFile.get_path();
+    const uint64_t fileBytes = mFile.get_size();
+    if (fileBytes < sizeof(PackFileHeader)) {
+        throw std::runtime_error("Failed to load pack file " + path + ", it's truncated!");
+    }
+
+    const PackFileHeader& header = *reinterpret_cast<const PackFileHeader*>(mFile.get_data());
+    if (header.magic != MAGIC) {
+        throw std::runtime_error("Failed to load pack file " + path + ", it's not a pack file!");
+    }
+    if (header.version != VERSION || header.chunkSize == 0) {
+        throw std::runtime_error("Failed to load pack file " + path + ", it needs repacking!");
+    }
+
+    const PackFileSection sections[PACK_FILE_SECTION_COUNT] = {
+        PACK_FILE_SECTION_ENTRIES, PACK_FILE_SECTION_CHUNKS, PACK_FILE_SECTION_PATHS
+    };
+    const uint64_t expectedBytes[PACK_FILE_SECTION_COUNT] = {
+        static_cast<uint64_t>(header.entryCount) * sizeof(PackFileEntry),
+        static_cast<uint64_t>(header.chunkCount) * sizeof(PackFileChunk),
+        header.sections[PACK_FILE_SECTION_PATHS].bytes
+    };
+    for (PackFileSection section : sections) {
+        const FileRange& range = header.sections[section];
+        if (!mFile.contains(range, ALIGNMENT) || range.bytes != expectedBytes[section]) {
+            throw std::runtime_error("Failed to load pack file " + path + ", a section is out of bounds!");
+        }
+    }
+    const FileRange& pathRange = header.sections[PACK_FILE_SECTION_PATHS];
+    const char* pPaths = reinterpret_cast<const char*>(mFile.get_range(pathRange));
+    if (header.entryCount > 0 && (pathRange.bytes == 0 || pPaths[pathRange.bytes - 1] != '\0')) {
+        throw std::runtime_error("Failed to load pack file " + path + ", a path is out of bounds!");
+    }
+
+    const PackFileEntry* pEntries = reinterpret_cast<const PackFileEntry*>(mFile.get_range(header.sections[PACK_FILE_SECTION_ENTRIES]));
+    const PackFileChunk* pChunks = reinterpret_cast<const PackFileChunk*>(mFile.get_range(header.sections[PACK_FILE_SECTION_CHUNKS]));
+    for (uint32_t i = 0; i < header.entryCount; i++) {
+        const PackFileEntry& entry = pEntries[i];
+        if (i > 0 && entry.pathHash <= pEntries[i - 1].pathHash) {
+            throw std::runtime_error("Failed to load pack file " + path + ", its index isn't sorted!");
+        }
+        if (entry.pathOffset >= pathRange.bytes || entry.compression >= PACK_COMPRESSION_COUNT) {
+            throw std::runtime_error("Failed to load pack file " + path + ", an entry is malformed!");
+        }
+        if (entry.compression == PACK_COMPRESSION_NONE) {
+            if (!mFile.contains({ entry.offset, entry.bytes }, ALIGNMENT)) {
+                throw std::runtime_error("Failed to load pack file " + path + ", an entry is out of bounds!");
+            }
+            continue;
+        }
+        if (entry.chunkCount != get_chunk_count(entry.bytes, header.chunkSize) ||
+            static_cast<uint64_t>(entry.firstChunk) + entry.chunkCount > header.chunkCount) {
+            throw std::runtime_error("Failed to load pack file " + path + ", an entry is out of bounds!");
+        }
+        for (uint32_t j = 0; j < entry.chunkCount; j++) {
+            const PackFileChunk& chunk = pChunks[entry.firstChunk + j];
+            if (!mFile.contains({ chunk.offset, chunk.storedBytes }, 1) || chunk.storedBytes > header.chunkSize) {
+                throw std::runtime_error("Failed to load pack file " + path + ", a chunk is out of bounds!");
+            }
+        }
+    }
+}
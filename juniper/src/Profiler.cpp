@@ -0,0 +1,97 @@
+//======================================================================
+// Profiler.cpp
+//
+// Keegan Kochis
+// Created: 2026/10/18
+// The definition of the Profiler class.
+//======================================================================
+
+#include "Profiler.h"
+
+#include <cstdint>
+
+#include <algorithm>
+#include <chrono>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <vector>
+
+Profiler::Profiler() {
+}
+
+//------------------------------------------------------------------------------------------
+//------------------------------------------------------------------------------------------
+void Profiler::begin_capture() {
+    std::lock_guard<std::mutex> lock(mMutex);
+    mEvents.clear();
+    mCapturing.store(true, std::memory_order_relaxed);
+}
+
+//------------------------------------------------------------------------------------------
+//------------------------------------------------------------------------------------------
+void Profiler::end_capture() {
+    mCapturing.store(false, std::memory_order_relaxed);
+}
+
+//------------------------------------------------------------------------------------------
+//------------------------------------------------------------------------------------------
+void Profiler::record(const char* name, uint32_t threadIndex, uint64_t startNs, uint64_t endNs) {
+    if (!is_capturing()) {
+        return;
+    }
+    std::lock_guard<std::mutex> lock(mMutex);
+    mEvents.push_back({ name, threadIndex, startNs, endNs });
+}
+
+//------------------------------------------------------------------------------------------
+// Few counters, a linear search keeps them in the order they were first set
+//------------------------------------------------------------------------------------------
+void Profiler::set_counter(const char* name, double value) {
+    std::lock_guard<std::mutex> lock(mMutex);
+    for (auto& counter : mCounters) {
+        if (counter.first == name) {
+            counter.second = value;
+            return;
+        }
+    }
+    mCounters.emplace_back(name, value);
+}
+
+//------------------------------------------------------------------------------------------
+// Complete events ("ph":"X") with microsecond timestamps relative to the first event
+//------------------------------------------------------------------------------------------
+void Profiler::write_chrome_trace(std::ostream& out) const {
+    std::lock_guard<std::mutex> lock(mMutex);
+
+    uint64_t origin = UINT64_MAX;
+    for (const Event& event : mEvents) {
+        origin = std::min(origin, event.startNs);
+    }
+
+    out << "{\"traceEvents\":[\n";
+    for (size_t i = 0; i < mEvents.size(); i++) {
+        const Event& event = mEvents[i];
+        out << "{\"name\":\"" << event.name << "\",\"ph\":\"X\",\"pid\":0,\"tid\":" << event.threadIndex
+            << ",\"ts\":" << (event.startNs - origin) / 1000.0 << ",\"dur\":" << (event.endNs - event.startNs) / 1000.0 << '}'
+            << (i + 1 < mEvents.size() ? ",\n" : "\n");
+    }
+    out << "]}\n";
+}
+
+//------------------------------------------------------------------------------------------
+//------------------------------------------------------------------------------------------
+void Profiler::print_counters(std::ostream& out) const {
+    std::lock_guard<std::mutex> lock(mMutex);
+    out << "Profiler counters:\n";
+    for (const auto& counter : mCounters) {
+        out << '\t' << counter.first << ": " << counter.second << '\n';
+    }
+}
+
+//------------------------------------------------------------------------------------------
+//------------------------------------------------------------------------------------------
+uint64_t Profiler::now_ns() {
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count());
+}
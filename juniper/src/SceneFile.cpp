@@ -0,0 +1,241 @@
+//======================================================================
+// SceneFile.cpp
+//
+// Keegan Kochis
+// Created: 2026/10/18
+// The definition of the SceneFile class.
+//======================================================================
+
+#include "SceneFile.h"
+
+#include <cstdint>
+#include <cstring>
+
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+static_assert(sizeof(SceneFileHeader) == 208, "The scene file header layout changed, bump SceneFile::VERSION");
+static_assert(sizeof(SceneFileNode) == 64, "The scene file node layout changed, bump SceneFile::VERSION");
+static_assert(sizeof(SceneFileMaterial) == 80, "The scene file material layout changed, bump SceneFile::VERSION");
+static_assert(sizeof(SceneFileChannel) == 32, "The scene file channel layout changed, bump SceneFile::VERSION");
+
+static uint64_t align_offset(uint64_t offset) {
+    return (offset + SceneFile::ALIGNMENT - 1) & ~(SceneFile::ALIGNMENT - 1);
+}
+
+//------------------------------------------------------------------------------------------
+//------------------------------------------------------------------------------------------
+uint32_t SceneData_t::add_string(const std::string& text) {
+    if (strings.empty()) {
+        strings.push_back('\0');
+    }
+    if (text.empty()) {
+        return 0;
+    }
+    const uint32_t offset = static_cast<uint32_t>(strings.size());
+    strings.append(text);
+    strings.push_back('\0');
+    return offset;
+}
+
+//------------------------------------------------------------------------------------------
+//------------------------------------------------------------------------------------------
+uint32_t SceneData_t::add_floats(const float* pValues, size_t count) {
+    const uint32_t offset = static_cast<uint32_t>(floats.size());
+    floats.insert(floats.end(), pValues, pValues + count);
+    return offset;
+}
+
+SceneFile::SceneFile() {
+}
+
+SceneFile::~SceneFile() {
+    close();
+}
+
+//------------------------------------------------------------------------------------------
+//------------------------------------------------------------------------------------------
+void SceneFile::open(const std::string& path) {
+    close();
+    mFile.open(path);
+    try {
+        validate();
+    }
+    catch (...) {
+        mFile.close();
+        throw;
+    }
+    mpHeader = reinterpret_cast<const SceneFileHeader*>(mFile.get_data());
+}
+
+//------------------------------------------------------------------------------------------
+//------------------------------------------------------------------------------------------
+void SceneFile::close() {
+    mFile.close();
+    mpHeader = nullptr;
+}
+
+//------------------------------------------------------------------------------------------
+// The sections are written in the order of SceneFileSection, each padded to the alignment
+//------------------------------------------------------------------------------------------
+void SceneFile::write(const std::string& path, const SceneData& scene) {
+    const std::string strings = scene.strings.empty() ? std::string(1, '\0') : scene.strings;
+
+    SceneFileHeader header;
+    memset(&header, 0, sizeof(header));
+    header.magic = MAGIC;
+    header.version = VERSION;
+    header.nodeCount = static_cast<uint32_t>(scene.nodes.size());
+    header.meshCount = static_cast<uint32_t>(scene.meshes.size());
+    header.primitiveCount = static_cast<uint32_t>(scene.primitives.size());
+    header.materialCount = static_cast<uint32_t>(scene.materials.size());
+    header.skinCount = static_cast<uint32_t>(scene.skins.size());
+    header.jointCount = static_cast<uint32_t>(scene.joints.size());
+    header.animationCount = static_cast<uint32_t>(scene.animations.size());
+    header.channelCount = static_cast<uint32_t>(scene.channels.size());
+    header.floatCount = static_cast<uint32_t>(scene.floats.size());
+    header.stringBytes = static_cast<uint32_t>(strings.size());
+
+    const void* sectionData[SCENE_FILE_SECTION_COUNT] = {
+        scene.nodes.data(), scene.meshes.data(), scene.primitives.data(), scene.materials.data(), scene.skins.data(),
+        scene.joints.data(), scene.animations.data(), scene.channels.data(), scene.floats.data(), strings.data()
+    };
+    const uint64_t sectionBytes[SCENE_FILE_SECTION_COUNT] = {
+        scene.nodes.size() * sizeof(SceneFileNode), scene.meshes.size() * sizeof(SceneFileMesh),
+        scene.primitives.size() * sizeof(SceneFilePrimitive), scene.materials.size() * sizeof(SceneFileMaterial),
+        scene.skins.size() * sizeof(SceneFileSkin), scene.joints.size() * sizeof(uint32_t),
+        scene.animations.size() * sizeof(SceneFileAnimation), scene.channels.size() * sizeof(SceneFileChannel),
+        scene.floats.size() * sizeof(float), strings.size()
+    };
+
+    uint64_t offset = align_offset(sizeof(SceneFileHeader));
+    for (uint32_t i = 0; i < SCENE_FILE_SECTION_COUNT; i++) {
+        header.sections[i].offset = offset;
+        header.sections[i].bytes = sectionBytes[i];
+        offset = align_offset(offset + sectionBytes[i]);
+    }
+
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    if (!file.is_open()) {
+        throw std::runtime_error("Failed to create scene file " + path + "!");
+    }
+
+    const char zeros[ALIGNMENT] = {};
+    file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    uint64_t written = sizeof(header);
+    for (uint32_t i = 0; i < SCENE_FILE_SECTION_COUNT; i++) {
+        file.write(zeros, static_cast<std::streamsize>(header.sections[i].offset - written));
+        file.write(static_cast<const char*>(sectionData[i]), static_cast<std::streamsize>(sectionBytes[i]));
+        written = header.sections[i].offset + sectionBytes[i];
+    }
+    file.write(zeros, static_cast<std::streamsize>(offset - written));
+
+    if (!file.good()) {
+        throw std::runtime_error("Failed to write scene file " + path + "!");
+    }
+}
+
+//------------------------------------------------------------------------------------------
+// Every reference between the tables is checked once here, so reading them needs no checks
+//------------------------------------------------------------------------------------------
+void SceneFile::validate() const {
+    const std::string& path = mFile.get_path();
+    if (mFile.get_size() < sizeof(SceneFileHeader)) {
+        throw std::runtime_error("Failed to load scene file " + path + ", it's truncated!");
+    }
+
+    const SceneFileHeader& header = *reinterpret_cast<const SceneFileHeader*>(mFile.get_data());
+    if (header.magic != MAGIC) {
+        throw std::runtime_error("Failed to load scene file " + path + ", it's not a scene file!");
+    }
+    if (header.version != VERSION) {
+        throw std::runtime_error("Failed to load scene file " + path + ", it needs recooking!");
+    }
+
+    const uint64_t elementBytes[SCENE_FILE_SECTION_COUNT] = {
+        sizeof(SceneFileNode), sizeof(SceneFileMesh), sizeof(SceneFilePrimitive), sizeof(SceneFileMaterial),
+        sizeof(SceneFileSkin), sizeof(uint32_t), sizeof(SceneFileAnimation), sizeof(SceneFileChannel), sizeof(float), 1
+    };
+    const uint64_t elementCounts[SCENE_FILE_SECTION_COUNT] = {
+        header.nodeCount, header.meshCount, header.primitiveCount, header.materialCount, header.skinCount,
+        header.jointCount, header.animationCount, header.channelCount, header.floatCount, header.stringBytes
+    };
+    for (uint32_t i = 0; i < SCENE_FILE_SECTION_COUNT; i++) {
+        if (!mFile.contains(header.sections[i], ALIGNMENT) || header.sections[i].bytes != elementBytes[i] * elementCounts[i]) {
+            throw std::runtime_error("Failed to load scene file " + path + ", a section is out of bounds!");
+        }
+    }
+
+    const char* pStrings = reinterpret_cast<const char*>(mFile.get_range(header.sections[SCENE_FILE_SECTION_STRINGS]));
+    if (header.stringBytes == 0 || pStrings[header.stringBytes - 1] != '\0') {
+        throw std::runtime_error("Failed to load scene file " + path + ", the string table is unterminated!");
+    }
+
+    // An unset reference passes any count check against INVALID_INDEX
+    auto valid = [](uint32_t index, uint64_t count) { return index == INVALID_INDEX || index < count; };
+    auto in_range = [](uint64_t first, uint64_t count, uint64_t total) { return first + count <= total; };
+    bool ok = true;
+
+    const SceneFileNode* pNodes = reinterpret_cast<const SceneFileNode*>(mFile.get_range(header.sections[SCENE_FILE_SECTION_NODES]));
+    for (uint32_t i = 0; i < header.nodeCount; i++) {
+        const SceneFileNode& node = pNodes[i];
+        ok &= valid(node.parent, i) && valid(node.mesh, header.meshCount) && valid(node.skin, header.skinCount) &&
+              node.name < header.stringBytes;
+    }
+
+    const SceneFileMesh* pMeshes = reinterpret_cast<const SceneFileMesh*>(mFile.get_range(header.sections[SCENE_FILE_SECTION_MESHES]));
+    for (uint32_t i = 0; i < header.meshCount; i++) {
+        ok &= in_range(pMeshes[i].firstPrimitive, pMeshes[i].primitiveCount, header.primitiveCount) && pMeshes[i].name < header.stringBytes;
+    }
+
+    const SceneFilePrimitive* pPrimitives = reinterpret_cast<const SceneFilePrimitive*>(mFile.get_range(header.sections[SCENE_FILE_SECTION_PRIMITIVES]));
+    for (uint32_t i = 0; i < header.primitiveCount; i++) {
+        ok &= valid(pPrimitives[i].material, header.materialCount) && pPrimitives[i].meshFile < header.stringBytes;
+    }
+
+    const SceneFileMaterial* pMaterials = reinterpret_cast<const SceneFileMaterial*>(mFile.get_range(header.sections[SCENE_FILE_SECTION_MATERIALS]));
+    for (uint32_t i = 0; i < header.materialCount; i++) {
+        const SceneFileMaterial& material = pMaterials[i];
+        const uint32_t strings[6] = {
+            material.baseColorTexture, material.metallicRoughnessTexture, material.normalTexture,
+            material.occlusionTexture, material.emissiveTexture, material.name
+        };
+        for (uint32_t string : strings) {
+            ok &= valid(string, header.stringBytes);
+        }
+    }
+
+    const uint32_t* pJoints = reinterpret_cast<const uint32_t*>(mFile.get_range(header.sections[SCENE_FILE_SECTION_JOINTS]));
+    for (uint32_t i = 0; i < header.jointCount; i++) {
+        ok &= pJoints[i] < header.nodeCount;
+    }
+
+    const SceneFileSkin* pSkins = reinterpret_cast<const SceneFileSkin*>(mFile.get_range(header.sections[SCENE_FILE_SECTION_SKINS]));
+    for (uint32_t i = 0; i < header.skinCount; i++) {
+        const SceneFileSkin& skin = pSkins[i];
+        ok &= in_range(skin.firstJoint, skin.jointCount, header.jointCount) && valid(skin.skeleton, header.nodeCount) &&
+              skin.name < header.stringBytes &&
+              (skin.inverseBindMatrices == INVALID_INDEX || in_range(skin.inverseBindMatrices, 16ull * skin.jointCount, header.floatCount));
+    }
+
+    const SceneFileAnimation* pAnimations = reinterpret_cast<const SceneFileAnimation*>(mFile.get_range(header.sections[SCENE_FILE_SECTION_ANIMATIONS]));
+    for (uint32_t i = 0; i < header.animationCount; i++) {
+        ok &= in_range(pAnimations[i].firstChannel, pAnimations[i].channelCount, header.channelCount) && pAnimations[i].name < header.stringBytes;
+    }
+
+    const SceneFileChannel* pChannels = reinterpret_cast<const SceneFileChannel*>(mFile.get_range(header.sections[SCENE_FILE_SECTION_CHANNELS]));
+    for (uint32_t i = 0; i < header.channelCount; i++) {
+        const SceneFileChannel& channel = pChannels[i];
+        const uint64_t valuesPerKey = channel.interpolation == ANIMATION_INTERPOLATION_CUBIC_SPLINE ? 3 : 1;
+        ok &= channel.node < header.nodeCount && channel.path <= ANIMATION_PATH_WEIGHTS &&
+              channel.interpolation <= ANIMATION_INTERPOLATION_CUBIC_SPLINE &&
+              in_range(channel.times, channel.keyCount, header.floatCount) &&
+              in_range(channel.values, valuesPerKey * channel.keyCount * channel.componentCount, header.floatCount);
+    }
+
+    if (!ok) {
+        throw std::runtime_error("Failed to load scene file " + path + ", a reference is out of bounds!");
+    }
+}
@@ -0,0 +1,59 @@
+//======================================================================
+// Shader.cpp
+//
+// Keegan Kochis
+// Created: 2026/10/18
+// Loading of compiled shaders.
+//======================================================================
+
+#include "Shader.h"
+
+#include <cstdint>
+
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#define GLFW_INCLUDE_VULKAN
+#include <GLFW/glfw3.h>
+
+#ifndef J_SHADER_OUTPUT_DIR
+#define J_SHADER_OUTPUT_DIR "shaders"
+#endif
+
+//------------------------------------------------------------------------------------------
+//------------------------------------------------------------------------------------------
+std::vector<char> read_binary_file(const std::string& filename) {
+    std::ifstream file(filename, std::ios::ate | std::ios::binary);
+
+    if (!file.is_open()) {
+        throw std::runtime_error("Failed to open file " + filename + "!");
+    }
+
+    size_t fileSize = static_cast<size_t>(file.tellg());
+    std::vector<char> buffer(fileSize);
+
+    file.seekg(0);
+    file.read(buffer.data(), fileSize);
+
+    return buffer;
+}
+
+//------------------------------------------------------------------------------------------
+//------------------------------------------------------------------------------------------
+VkShaderModule load_shader_module(VkDevice device, const std::string& name) {
+    std::vector<char> code = read_binary_file(std::string(J_SHADER_OUTPUT_DIR) + "/" + name);
+
+    VkShaderModuleCreateInfo createInfo{};
+    createInfo.sType = VK_STRUCTURE_TYPE_SHADER_MODULE_CREATE_INFO;
+    createInfo.codeSize = code.size();
+    createInfo.pCode = reinterpret_cast<const uint32_t*>(code.data());
+
+    VkShaderModule shaderModule;
+    if (vkCreateShaderModule(device, &createInfo, nullptr, &shaderModule) != VK_SUCCESS) {
+        throw std::runtime_error("Failed to create shader module " + name + "!");
+    }
+
+    return shaderModule;
+}
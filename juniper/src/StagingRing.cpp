@@ -0,0 +1,99 @@
+//======================================================================
+// StagingRing.cpp
+//
+// Keegan Kochis
+// Created: 2026/10/18
+// The definition of the StagingRing class.
+//======================================================================
+
+#include "StagingRing.h"
+
+#include <cstdint>
+
+#include <stdexcept>
+#include <string>
+
+// The ring size is a multiple of this, so allocations aligned within a lap stay aligned
+static const VkDeviceSize RING_ALIGNMENT = 256;
+
+//------------------------------------------------------------------------------------------
+//------------------------------------------------------------------------------------------
+static uint64_t align_position(uint64_t position, uint64_t alignment) {
+    return (position + alignment - 1) / alignment * alignment;
+}
+
+StagingRing::StagingRing() {
+}
+
+//------------------------------------------------------------------------------------------
+//------------------------------------------------------------------------------------------
+void StagingRing::init(GpuResources* pGpuResources, TimelineSync* pTimelineSync, VkDeviceSize size) {
+    mpGpuResources = pGpuResources;
+    mpTimelineSync = pTimelineSync;
+    mSize = align_position(size, RING_ALIGNMENT);
+    mBuffer = mpGpuResources->create_buffer(mSize, VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
+                                            VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT);
+    mpMapped = static_cast<uint8_t*>(mpGpuResources->get_mapped(mBuffer));
+    mHead = 0;
+    mTail = 0;
+    mSubmitted = 0;
+}
+
+//------------------------------------------------------------------------------------------
+//------------------------------------------------------------------------------------------
+void StagingRing::clean_up() {
+    if (!mBuffer.is_null()) {
+        mpGpuResources->destroy_buffer(mBuffer);
+        mBuffer = BufferHandle();
+    }
+    mpMapped = nullptr;
+    mRetirements.clear();
+}
+
+//------------------------------------------------------------------------------------------
+// An allocation that would straddle the end of the buffer starts the next lap instead,
+// the skipped bytes are freed together with the allocation before them
+//------------------------------------------------------------------------------------------
+StagingRing::Allocation StagingRing::allocate(VkDeviceSize bytes, VkDeviceSize alignment) {
+    if (bytes > mSize || alignment == 0 || RING_ALIGNMENT % alignment != 0) {
+        throw std::runtime_error("Failed to stage " + std::to_string(bytes) + " bytes, the staging ring is " +
+                                 std::to_string(mSize) + " bytes!");
+    }
+    reclaim();
+
+    uint64_t start = align_position(mHead, alignment);
+    if (start % mSize + bytes > mSize) {
+        start = align_position(start, mSize);
+    }
+    Allocation allocation;
+    if (start + bytes - mTail > mSize) {
+        return allocation;
+    }
+
+    mHead = start + bytes;
+    allocation.buffer = mpGpuResources->get_buffer(mBuffer);
+    allocation.offset = start % mSize;
+    allocation.pData = mpMapped + allocation.offset;
+    return allocation;
+}
+
+//------------------------------------------------------------------------------------------
+//------------------------------------------------------------------------------------------
+void StagingRing::submit(TimelineSync::QueueType queue, uint64_t value) {
+    if (mHead == mSubmitted) {
+        return;
+    }
+    mRetirements.push_back({ queue, value, mHead });
+    mSubmitted = mHead;
+}
+
+//------------------------------------------------------------------------------------------
+// Submissions retire in order on one queue, across queues the oldest one has to finish
+// first, which only delays reuse and never frees space that is still read
+//------------------------------------------------------------------------------------------
+void StagingRing::reclaim() {
+    while (!mRetirements.empty() && mpTimelineSync->is_complete(mRetirements.front().queue, mRetirements.front().value)) {
+        mTail = mRetirements.front().end;
+        mRetirements.pop_front();
+    }
+}
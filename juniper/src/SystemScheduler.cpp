@@ -0,0 +1,375 @@
+//======================================================================
+// SystemScheduler.cpp
+//
+// Keegan Kochis
+// Created: 2026/10/18
+// The definition of the SystemScheduler class.
+//======================================================================
+
+#include "SystemScheduler.h"
+
+#include <cstdint>
+
+#include <algorithm>
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <ostream>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+SystemScheduler::SystemScheduler() {
+}
+
+//------------------------------------------------------------------------------------------
+// The job system must be initialized first, there is a command buffer per thread
+//------------------------------------------------------------------------------------------
+void SystemScheduler::init(EntityWorld* pWorld, JobSystem* pJobSystem, Profiler* pProfiler) {
+    mpWorld = pWorld;
+    mpJobSystem = pJobSystem;
+    mpProfiler = pProfiler;
+    mCommandBuffers.resize(pJobSystem->get_thread_count());
+}
+
+//------------------------------------------------------------------------------------------
+//------------------------------------------------------------------------------------------
+void SystemScheduler::clean_up() {
+    mSystems.clear();
+    mCommandBuffers.clear();
+    mScheduleDirty = true;
+}
+
+//------------------------------------------------------------------------------------------
+//------------------------------------------------------------------------------------------
+SystemId SystemScheduler::add_task(const char* name, ComponentMask reads, ComponentMask writes,
+                                   const std::vector<SystemId>& after, std::function<void(const SystemContext&)> function) {
+    ChunkFunction run = [function](SystemContext& context, const EntityWorld::QueryChunk*, const uint32_t*, uint32_t) {
+        function(context);
+    };
+    return add(name, reads & ~writes, writes, after, false, 0, run);
+}
+
+//------------------------------------------------------------------------------------------
+//------------------------------------------------------------------------------------------
+SystemId SystemScheduler::add(const char* name, ComponentMask reads, ComponentMask writes, const std::vector<SystemId>& after,
+                              bool iteratesQuery, QueryId query, ChunkFunction run) {
+    const SystemId id = static_cast<SystemId>(mSystems.size());
+    for (SystemId predecessor : after) {
+        if (predecessor >= id) {
+            throw std::runtime_error("Failed to add system, it can only run after systems added before it!");
+        }
+    }
+
+    std::unique_ptr<System> pSystem = std::make_unique<System>();
+    pSystem->name = name;
+    pSystem->reads = reads;
+    pSystem->writes = writes;
+    pSystem->after = after;
+    pSystem->iteratesQuery = iteratesQuery;
+    pSystem->query = query;
+    pSystem->run = std::move(run);
+    pSystem->level = 0;
+    mSystems.push_back(std::move(pSystem));
+
+    mScheduleDirty = true;
+    return id;
+}
+
+//------------------------------------------------------------------------------------------
+// Registration order is a topological order, so a single pass builds the DAG. Edges
+// implied by a longer path are dropped, they would only add synchronization.
+//------------------------------------------------------------------------------------------
+void SystemScheduler::build_schedule() {
+    const uint32_t systemCount = static_cast<uint32_t>(mSystems.size());
+    std::vector<std::vector<bool>> ancestors(systemCount, std::vector<bool>(systemCount, false));
+
+    for (uint32_t j = 0; j < systemCount; j++) {
+        System& system = *mSystems[j];
+        system.predecessors.clear();
+        system.successors.clear();
+
+        std::vector<SystemId> direct;
+        for (uint32_t i = 0; i < j; i++) {
+            const System& earlier = *mSystems[i];
+            const bool conflicts = (earlier.writes & (system.reads | system.writes)) != 0 ||
+                                   (earlier.reads & system.writes) != 0;
+            const bool ordered = std::find(system.after.begin(), system.after.end(), i) != system.after.end();
+            if (conflicts || ordered) {
+                direct.push_back(i);
+            }
+        }
+
+        for (SystemId i : direct) {
+            ancestors[j][i] = true;
+            for (uint32_t k = 0; k < i; k++) {
+                if (ancestors[i][k]) {
+                    ancestors[j][k] = true;
+                }
+            }
+        }
+
+        system.level = 0;
+        for (SystemId i : direct) {
+            bool implied = false;
+            for (SystemId k : direct) {
+                if (k != i && ancestors[k][i]) {
+                    implied = true;
+                    break;
+                }
+            }
+            if (!implied) {
+                system.predecessors.push_back(i);
+                mSystems[i]->successors.push_back(j);
+                system.level = std::max(system.level, mSystems[i]->level + 1);
+            }
+        }
+    }
+
+    mScheduleDirty = false;
+}
+
+//------------------------------------------------------------------------------------------
+// Chunk lists are gathered before anything runs, so systems see the same chunks no
+// matter which of them run first. Structural changes wait for playback at the end.
+//------------------------------------------------------------------------------------------
+void SystemScheduler::run(double time, float deltaTime) {
+    if (mScheduleDirty) {
+        build_schedule();
+    }
+    const uint64_t runStart = Profiler::now_ns();
+    mTime = time;
+    mDeltaTime = deltaTime;
+
+    for (std::unique_ptr<System>& pSystem : mSystems) {
+        System& system = *pSystem;
+        system.remainingPredecessors.store(static_cast<uint32_t>(system.predecessors.size()), std::memory_order_relaxed);
+        system.startNs.store(UINT64_MAX, std::memory_order_relaxed);
+        system.endNs.store(0, std::memory_order_relaxed);
+        system.cpuNs.store(0, std::memory_order_relaxed);
+        system.stats.jobs = 0;
+        system.stats.entities = 0;
+
+        if (system.iteratesQuery) {
+            mpWorld->get_chunks(system.query, system.chunks);
+            system.firstEntities.resize(system.chunks.size());
+            uint32_t entities = 0;
+            for (size_t i = 0; i < system.chunks.size(); i++) {
+                system.firstEntities[i] = entities;
+                entities += system.chunks[i].count;
+            }
+            system.stats.entities = entities;
+        }
+    }
+
+    JobSystem::JobCounter counter;
+    for (SystemId i = 0; i < mSystems.size(); i++) {
+        if (mSystems[i]->predecessors.empty()) {
+            launch(i, counter);
+        }
+    }
+    mpJobSystem->wait(counter);
+
+    // Thread order keeps playback deterministic for a given split of the work
+    for (EntityCommandBuffer& commands : mCommandBuffers) {
+        if (!commands.empty()) {
+            commands.playback(*mpWorld);
+        }
+    }
+
+    for (std::unique_ptr<System>& pSystem : mSystems) {
+        SystemStats& stats = pSystem->stats;
+        const uint64_t startNs = pSystem->startNs.load(std::memory_order_relaxed);
+        const uint64_t endNs = pSystem->endNs.load(std::memory_order_relaxed);
+        stats.wallMs = endNs > startNs ? (endNs - startNs) / 1e6 : 0.0;
+        stats.cpuMs = pSystem->cpuNs.load(std::memory_order_relaxed) / 1e6;
+        stats.averageWallMs = stats.averageWallMs == 0.0 ? stats.wallMs : stats.averageWallMs * 0.95 + stats.wallMs * 0.05;
+    }
+
+    const uint64_t runEnd = Profiler::now_ns();
+    mRunMs = (runEnd - runStart) / 1e6;
+    if (mpProfiler) {
+        mpProfiler->record("SystemScheduler::run", JobSystem::get_thread_index(), runStart, runEnd);
+    }
+}
+
+//------------------------------------------------------------------------------------------
+// Splits a query system into chunk ranges, about JOBS_PER_THREAD per thread. The last
+// job to finish hands over to the successors.
+//------------------------------------------------------------------------------------------
+void SystemScheduler::launch(SystemId systemId, JobSystem::JobCounter& counter) {
+    System& system = *mSystems[systemId];
+
+    if (!system.iteratesQuery) {
+        system.stats.jobs = 1;
+        system.remainingJobs.store(1, std::memory_order_relaxed);
+        mpJobSystem->submit(counter, [this, systemId, &counter]() {
+            run_job(systemId, 0, 0);
+            finish(systemId, counter);
+        });
+        return;
+    }
+
+    const uint32_t chunkCount = static_cast<uint32_t>(system.chunks.size());
+    if (chunkCount == 0) {
+        finish(systemId, counter);
+        return;
+    }
+
+    const uint32_t targetJobs = mpJobSystem->get_thread_count() * JOBS_PER_THREAD;
+    const uint32_t chunksPerJob = std::max(1u, (chunkCount + targetJobs - 1) / targetJobs);
+    const uint32_t jobCount = (chunkCount + chunksPerJob - 1) / chunksPerJob;
+    system.stats.jobs = jobCount;
+    system.remainingJobs.store(jobCount, std::memory_order_relaxed);
+
+    for (uint32_t firstChunk = 0; firstChunk < chunkCount; firstChunk += chunksPerJob) {
+        const uint32_t jobChunks = std::min(chunksPerJob, chunkCount - firstChunk);
+        mpJobSystem->submit(counter, [this, systemId, firstChunk, jobChunks, &counter]() {
+            run_job(systemId, firstChunk, jobChunks);
+            if (mSystems[systemId]->remainingJobs.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+                finish(systemId, counter);
+            }
+        });
+    }
+}
+
+//------------------------------------------------------------------------------------------
+//------------------------------------------------------------------------------------------
+void SystemScheduler::run_job(SystemId systemId, uint32_t firstChunk, uint32_t chunkCount) {
+    System& system = *mSystems[systemId];
+    const uint32_t threadIndex = JobSystem::get_thread_index();
+
+    SystemContext context = {};
+    context.pWorld = mpWorld;
+    context.pCommands = &mCommandBuffers[threadIndex];
+    context.time = mTime;
+    context.deltaTime = mDeltaTime;
+    context.threadIndex = threadIndex;
+    context.firstEntity = 0;
+
+    const uint64_t startNs = Profiler::now_ns();
+    system.run(context, system.chunks.data() + firstChunk, system.firstEntities.data() + firstChunk, chunkCount);
+    const uint64_t endNs = Profiler::now_ns();
+
+    system.cpuNs.fetch_add(endNs - startNs, std::memory_order_relaxed);
+    uint64_t earliest = system.startNs.load(std::memory_order_relaxed);
+    while (startNs < earliest && !system.startNs.compare_exchange_weak(earliest, startNs, std::memory_order_relaxed)) {
+    }
+    uint64_t latest = system.endNs.load(std::memory_order_relaxed);
+    while (endNs > latest && !system.endNs.compare_exchange_weak(latest, endNs, std::memory_order_relaxed)) {
+    }
+
+    if (mpProfiler) {
+        mpProfiler->record(system.name.c_str(), threadIndex, startNs, endNs);
+    }
+}
+
+//------------------------------------------------------------------------------------------
+// Successors are submitted before the finishing job returns, so the counter can't reach
+// zero while part of the graph is still to run
+//------------------------------------------------------------------------------------------
+void SystemScheduler::finish(SystemId systemId, JobSystem::JobCounter& counter) {
+    for (SystemId successor : mSystems[systemId]->successors) {
+        if (mSystems[successor]->remainingPredecessors.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+            launch(successor, counter);
+        }
+    }
+}
+
+//------------------------------------------------------------------------------------------
+//------------------------------------------------------------------------------------------
+void SystemScheduler::print_schedule(std::ostream& out) const {
+    uint32_t levelCount = 0;
+    for (const std::unique_ptr<System>& pSystem : mSystems) {
+        levelCount = std::max(levelCount, pSystem->level + 1);
+    }
+
+    out << "System schedule:\n";
+    for (uint32_t level = 0; level < levelCount; level++) {
+        out << "\tLevel " << level << ":\n";
+        for (const std::unique_ptr<System>& pSystem : mSystems) {
+            if (pSystem->level != level) {
+                continue;
+            }
+            out << "\t\t" << pSystem->name << (pSystem->iteratesQuery ? " (query)" : " (task)")
+                << "\treads: " << mask_names(pSystem->reads) << "\twrites: " << mask_names(pSystem->writes) << "\tafter:";
+            if (pSystem->predecessors.empty()) {
+                out << " -";
+            }
+            for (SystemId predecessor : pSystem->predecessors) {
+                out << ' ' << mSystems[predecessor]->name;
+            }
+            out << '\n';
+        }
+    }
+}
+
+//------------------------------------------------------------------------------------------
+//------------------------------------------------------------------------------------------
+void SystemScheduler::write_graphviz(std::ostream& out) const {
+    uint32_t levelCount = 0;
+    for (const std::unique_ptr<System>& pSystem : mSystems) {
+        levelCount = std::max(levelCount, pSystem->level + 1);
+    }
+
+    out << "digraph schedule {\n";
+    out << "\trankdir=LR;\n";
+    out << "\tnode [shape=box];\n";
+    for (SystemId i = 0; i < mSystems.size(); i++) {
+        const System& system = *mSystems[i];
+        out << "\ts" << i << " [label=\"" << system.name << "\\nR: " << mask_names(system.reads)
+            << "\\nW: " << mask_names(system.writes) << "\"];\n";
+    }
+    for (uint32_t level = 0; level < levelCount; level++) {
+        out << "\t{ rank=same;";
+        for (SystemId i = 0; i < mSystems.size(); i++) {
+            if (mSystems[i]->level == level) {
+                out << " s" << i << ';';
+            }
+        }
+        out << " }\n";
+    }
+    for (SystemId i = 0; i < mSystems.size(); i++) {
+        for (SystemId successor : mSystems[i]->successors) {
+            out << "\ts" << i << " -> s" << successor << ";\n";
+        }
+    }
+    out << "}\n";
+}
+
+//------------------------------------------------------------------------------------------
+//------------------------------------------------------------------------------------------
+void SystemScheduler::print_stats(std::ostream& out) const {
+    out << "System scheduler stats:\n";
+    out << "\tThreads: " << mpJobSystem->get_thread_count() << '\n';
+    out << "\tLast run: " << mRunMs << " ms\n";
+    for (const std::unique_ptr<System>& pSystem : mSystems) {
+        const SystemStats& stats = pSystem->stats;
+        out << '\t' << pSystem->name << ": " << stats.wallMs << " ms wall (" << stats.averageWallMs << " ms average), "
+            << stats.cpuMs << " ms cpu, " << stats.jobs << " jobs";
+        if (pSystem->iteratesQuery) {
+            out << ", " << stats.entities << " entities";
+        }
+        out << '\n';
+    }
+}
+
+//------------------------------------------------------------------------------------------
+//------------------------------------------------------------------------------------------
+std::string SystemScheduler::mask_names(ComponentMask mask) {
+    if (mask == 0) {
+        return "-";
+    }
+
+    std::string names;
+    for (uint32_t id = 0; id < MAX_COMPONENTS; id++) {
+        if (mask & (ComponentMask(1) << id)) {
+            if (!names.empty()) {
+                names += ", ";
+            }
+            names += get_component_info(id).name;
+        }
+    }
+    return names;
+}
@@ -0,0 +1,402 @@
+//======================================================================
+// Texture.cpp
+//
+// Keegan Kochis
+// Created: 2026/10/18
+// Texture format queries and the mip chain filter. The filter averages
+// 2x2 texels of the previous level, the SIMD versions handle a texel's
+// four channels per SSE register and two texels per AVX2 register.
+//======================================================================
+
+#include "Texture.h"
+
+#include <cmath>
+#include <cstdint>
+
+#include <algorithm>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__SSE2__) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define J_SIMD_X86 1
+#include <immintrin.h>
+#else
+#define J_SIMD_X86 0
+#endif
+
+// The AVX2 kernels are built regardless of the compiler flags and only picked when the CPU has them
+#if defined(__GNUC__) || defined(__clang__)
+#define J_TARGET_AVX2 __attribute__((target("avx2,fma")))
+#else
+#define J_TARGET_AVX2
+#endif
+
+// Entries of the linear to sRGB table, fine enough that the steepest part near black still
+// rounds correctly
+static const uint32_t LINEAR_TO_SRGB_ENTRIES = 65536;
+
+//------------------------------------------------------------------------------------------
+//------------------------------------------------------------------------------------------
+TextureData TextureData::make_checker(uint32_t size, uint32_t squares) {
+    TextureData texture;
+    texture.width = size;
+    texture.height = size;
+    texture.texels.resize(static_cast<size_t>(size) * size * 4);
+
+    const uint32_t squareSize = std::max(size / std::max(squares, 1u), 1u);
+    for (uint32_t y = 0; y < size; y++) {
+        for (uint32_t x = 0; x < size; x++) {
+            const uint8_t value = ((x / squareSize + y / squareSize) % 2 == 0) ? 224 : 32;
+            uint8_t* pTexel = &texture.texels[(static_cast<size_t>(y) * size + x) * 4];
+            pTexel[0] = value;
+            pTexel[1] = value;
+            pTexel[2] = value;
+            pTexel[3] = 255;
+        }
+    }
+    return texture;
+}
+
+//------------------------------------------------------------------------------------------
+//------------------------------------------------------------------------------------------
+TextureData TextureData::make_gradient(uint32_t size) {
+    TextureData texture;
+    texture.width = size;
+    texture.height = size;
+    texture.texels.resize(static_cast<size_t>(size) * size * 4);
+
+    const float scale = size > 1 ? 1.0f / (size - 1) : 0.0f;
+    for (uint32_t y = 0; y < size; y++) {
+        for (uint32_t x = 0; x < size; x++) {
+            const float u = x * scale;
+            const float v = y * scale;
+            const float brightness = 1.0f - 0.75f * v;
+            uint8_t* pTexel = &texture.texels[(static_cast<size_t>(y) * size + x) * 4];
+            pTexel[0] = static_cast<uint8_t>(std::lround(255.0f * brightness * (0.5f + 0.5f * std::cos(6.2831853f * u))));
+            pTexel[1] = static_cast<uint8_t>(std::lround(255.0f * brightness * (0.5f + 0.5f * std::cos(6.2831853f * (u - 0.333f)))));
+            pTexel[2] = static_cast<uint8_t>(std::lround(255.0f * brightness * (0.5f + 0.5f * std::cos(6.2831853f * (u - 0.667f)))));
+            pTexel[3] = static_cast<uint8_t>(std::lround(255.0f * (0.25f + 0.75f * u)));
+        }
+    }
+    return texture;
+}
+
+//------------------------------------------------------------------------------------------
+//------------------------------------------------------------------------------------------
+uint32_t get_texture_block_bytes(TextureFormat format) {
+    switch (format) {
+        case TEXTURE_FORMAT_BC1:
+            return 8;
+        case TEXTURE_FORMAT_BC3:
+        case TEXTURE_FORMAT_BC5:
+        case TEXTURE_FORMAT_BC7:
+            return 16;
+        default:
+            return 4;
+    }
+}
+
+//------------------------------------------------------------------------------------------
+//------------------------------------------------------------------------------------------
+bool is_block_compressed(TextureFormat format) {
+    return format != TEXTURE_FORMAT_RGBA8;
+}
+
+//------------------------------------------------------------------------------------------
+// Compressed levels round up to whole blocks, so the 2x2 and 1x1 levels take a full block
+//------------------------------------------------------------------------------------------
+uint64_t get_texture_level_bytes(TextureFormat format, uint32_t width, uint32_t height) {
+    if (!is_block_compressed(format)) {
+        return static_cast<uint64_t>(width) * height * 4;
+    }
+    const uint64_t blocksX = (width + TEXTURE_BLOCK_SIZE - 1) / TEXTURE_BLOCK_SIZE;
+    const uint64_t blocksY = (height + TEXTURE_BLOCK_SIZE - 1) / TEXTURE_BLOCK_SIZE;
+    return blocksX * blocksY * get_texture_block_bytes(format);
+}
+
+//------------------------------------------------------------------------------------------
+//------------------------------------------------------------------------------------------
+uint32_t get_texture_mip_count(uint32_t width, uint32_t height) {
+    uint32_t count = 1;
+    for (uint32_t size = std::max(width, height); size > 1; size /= 2) {
+        count++;
+    }
+    return count;
+}
+
+//------------------------------------------------------------------------------------------
+// BC5 has no sRGB variant, it only ever holds linear data
+//------------------------------------------------------------------------------------------
+VkFormat get_texture_vk_format(TextureFormat format, TextureUsage usage) {
+    const bool srgb = usage == TEXTURE_USAGE_COLOR;
+    switch (format) {
+        case TEXTURE_FORMAT_BC1:
+            return srgb ? VK_FORMAT_BC1_RGB_SRGB_BLOCK : VK_FORMAT_BC1_RGB_UNORM_BLOCK;
+        case TEXTURE_FORMAT_BC3:
+            return srgb ? VK_FORMAT_BC3_SRGB_BLOCK : VK_FORMAT_BC3_UNORM_BLOCK;
+        case TEXTURE_FORMAT_BC5:
+            return VK_FORMAT_BC5_UNORM_BLOCK;
+        case TEXTURE_FORMAT_BC7:
+            return srgb ? VK_FORMAT_BC7_SRGB_BLOCK : VK_FORMAT_BC7_UNORM_BLOCK;
+        default:
+            return srgb ? VK_FORMAT_R8G8B8A8_SRGB : VK_FORMAT_R8G8B8A8_UNORM;
+    }
+}
+
+//------------------------------------------------------------------------------------------
+//------------------------------------------------------------------------------------------
+const char* texture_format_name(TextureFormat format) {
+    switch (format) {
+        case TEXTURE_FORMAT_BC1:
+            return "BC1";
+        case TEXTURE_FORMAT_BC3:
+            return "BC3";
+        case TEXTURE_FORMAT_BC5:
+            return "BC5";
+        case TEXTURE_FORMAT_BC7:
+            return "BC7";
+        default:
+            return "RGBA8";
+    }
+}
+
+//------------------------------------------------------------------------------------------
+//------------------------------------------------------------------------------------------
+static float srgb_to_linear(float value) {
+    return value <= 0.04045f ? value / 12.92f : std::pow((value + 0.055f) / 1.055f, 2.4f);
+}
+
+//------------------------------------------------------------------------------------------
+//------------------------------------------------------------------------------------------
+static float linear_to_srgb(float value) {
+    return value <= 0.0031308f ? value * 12.92f : 1.055f * std::pow(value, 1.0f / 2.4f) - 0.055f;
+}
+
+//------------------------------------------------------------------------------------------
+//------------------------------------------------------------------------------------------
+static const std::vector<float>& get_srgb_to_linear_table() {
+    static const std::vector<float> table = []() {
+        std::vector<float> values(256);
+        for (uint32_t i = 0; i < 256; i++) {
+            values[i] = srgb_to_linear(i / 255.0f);
+        }
+        return values;
+    }();
+    return table;
+}
+
+//------------------------------------------------------------------------------------------
+//------------------------------------------------------------------------------------------
+static const std::vector<uint8_t>& get_linear_to_srgb_table() {
+    static const std::vector<uint8_t> table = []() {
+        std::vector<uint8_t> values(LINEAR_TO_SRGB_ENTRIES);
+        for (uint32_t i = 0; i < LINEAR_TO_SRGB_ENTRIES; i++) {
+            values[i] = static_cast<uint8_t>(std::lround(255.0f * linear_to_srgb(i / float(LINEAR_TO_SRGB_ENTRIES - 1))));
+        }
+        return values;
+    }();
+    return table;
+}
+
+//------------------------------------------------------------------------------------------
+// Normals are unpacked to [-1, 1] so averaging them shortens rather than skews them
+//------------------------------------------------------------------------------------------
+static void unpack_texels(const TextureData& image, TextureUsage usage, std::vector<float>& texels) {
+    const std::vector<float>& srgbToLinear = get_srgb_to_linear_table();
+    texels.resize(image.texels.size());
+    for (size_t i = 0; i < image.texels.size(); i += 4) {
+        for (uint32_t c = 0; c < 3; c++) {
+            const uint8_t value = image.texels[i + c];
+            switch (usage) {
+                case TEXTURE_USAGE_COLOR:
+                    texels[i + c] = srgbToLinear[value];
+                    break;
+                case TEXTURE_USAGE_NORMAL:
+                    texels[i + c] = value / 127.5f - 1.0f;
+                    break;
+                default:
+                    texels[i + c] = value / 255.0f;
+                    break;
+            }
+        }
+        texels[i + 3] = image.texels[i + 3] / 255.0f;
+    }
+}
+
+//------------------------------------------------------------------------------------------
+//------------------------------------------------------------------------------------------
+static uint8_t to_unorm8(float value) {
+    return static_cast<uint8_t>(std::lround(255.0f * std::min(std::max(value, 0.0f), 1.0f)));
+}
+
+//------------------------------------------------------------------------------------------
+//------------------------------------------------------------------------------------------
+static void pack_texels(const std::vector<float>& texels, TextureUsage usage, TextureData& image) {
+    const std::vector<uint8_t>& linearToSrgb = get_linear_to_srgb_table();
+    image.texels.resize(texels.size());
+    for (size_t i = 0; i < texels.size(); i += 4) {
+        if (usage == TEXTURE_USAGE_COLOR) {
+            for (uint32_t c = 0; c < 3; c++) {
+                const float value = std::min(std::max(texels[i + c], 0.0f), 1.0f);
+                image.texels[i + c] = linearToSrgb[static_cast<uint32_t>(value * (LINEAR_TO_SRGB_ENTRIES - 1) + 0.5f)];
+            }
+        }
+        else if (usage == TEXTURE_USAGE_NORMAL) {
+            const float length = std::sqrt(texels[i] * texels[i] + texels[i + 1] * texels[i + 1] + texels[i + 2] * texels[i + 2]);
+            const float scale = length > 0.0f ? 0.5f / length : 0.0f;
+            for (uint32_t c = 0; c < 3; c++) {
+                image.texels[i + c] = to_unorm8(texels[i + c] * scale + 0.5f);
+            }
+        }
+        else {
+            for (uint32_t c = 0; c < 3; c++) {
+                image.texels[i + c] = to_unorm8(texels[i + c]);
+            }
+        }
+        image.texels[i + 3] = to_unorm8(texels[i + 3]);
+    }
+}
+
+//------------------------------------------------------------------------------------------
+// Downsampling kernels. Odd sizes drop their last row or column, 1 texel wide levels repeat
+// the texel.
+//------------------------------------------------------------------------------------------
+static void downsample_scalar(const float* pSource, uint32_t sourceWidth, uint32_t sourceHeight, float* pDest) {
+    const uint32_t width = std::max(sourceWidth / 2, 1u);
+    const uint32_t height = std::max(sourceHeight / 2, 1u);
+    for (uint32_t y = 0; y < height; y++) {
+        const float* pRow0 = pSource + static_cast<size_t>(std::min(2 * y, sourceHeight - 1)) * sourceWidth * 4;
+        const float* pRow1 = pSource + static_cast<size_t>(std::min(2 * y + 1, sourceHeight - 1)) * sourceWidth * 4;
+        for (uint32_t x = 0; x < width; x++) {
+            const uint32_t x0 = std::min(2 * x, sourceWidth - 1) * 4;
+            const uint32_t x1 = std::min(2 * x + 1, sourceWidth - 1) * 4;
+            float* pTexel = pDest + (static_cast<size_t>(y) * width + x) * 4;
+            for (uint32_t c = 0; c < 4; c++) {
+                pTexel[c] = 0.25f * (pRow0[x0 + c] + pRow0[x1 + c] + pRow1[x0 + c] + pRow1[x1 + c]);
+            }
+        }
+    }
+}
+
+#if J_SIMD_X86
+//------------------------------------------------------------------------------------------
+// One texel's four channels per register
+//------------------------------------------------------------------------------------------
+static void downsample_sse(const float* pSource, uint32_t sourceWidth, uint32_t sourceHeight, float* pDest) {
+    const uint32_t width = std::max(sourceWidth / 2, 1u);
+    const uint32_t height = std::max(sourceHeight / 2, 1u);
+    const __m128 quarter = _mm_set1_ps(0.25f);
+    for (uint32_t y = 0; y < height; y++) {
+        const float* pRow0 = pSource + static_cast<size_t>(std::min(2 * y, sourceHeight - 1)) * sourceWidth * 4;
+        const float* pRow1 = pSource + static_cast<size_t>(std::min(2 * y + 1, sourceHeight - 1)) * sourceWidth * 4;
+        float* pRow = pDest + static_cast<size_t>(y) * width * 4;
+        for (uint32_t x = 0; x < width; x++) {
+            const uint32_t x0 = std::min(2 * x, sourceWidth - 1) * 4;
+            const uint32_t x1 = std::min(2 * x + 1, sourceWidth - 1) * 4;
+            const __m128 sum = _mm_add_ps(_mm_add_ps(_mm_loadu_ps(pRow0 + x0), _mm_loadu_ps(pRow0 + x1)),
+                                          _mm_add_ps(_mm_loadu_ps(pRow1 + x0), _mm_loadu_ps(pRow1 + x1)));
+            _mm_storeu_ps(pRow + x * 4, _mm_mul_ps(sum, quarter));
+        }
+    }
+}
+
+//------------------------------------------------------------------------------------------
+// Two destination texels per iteration, their four source texels per row are two loads.
+// The columns are summed across the 128 bit lanes.
+//------------------------------------------------------------------------------------------
+J_TARGET_AVX2 static void downsample_avx2(const float* pSource, uint32_t sourceWidth, uint32_t sourceHeight, float* pDest) {
+    const uint32_t width = std::max(sourceWidth / 2, 1u);
+    const uint32_t height = std::max(sourceHeight / 2, 1u);
+    const __m256 quarter = _mm256_set1_ps(0.25f);
+    for (uint32_t y = 0; y < height; y++) {
+        const float* pRow0 = pSource + static_cast<size_t>(std::min(2 * y, sourceHeight - 1)) * sourceWidth * 4;
+        const float* pRow1 = pSource + static_cast<size_t>(std::min(2 * y + 1, sourceHeight - 1)) * sourceWidth * 4;
+        float* pRow = pDest + static_cast<size_t>(y) * width * 4;
+
+        uint32_t x = 0;
+        for (; x + 1 < width && 2 * x + 3 < sourceWidth; x += 2) {
+            const __m256 first = _mm256_add_ps(_mm256_loadu_ps(pRow0 + x * 8), _mm256_loadu_ps(pRow1 + x * 8));
+            const __m256 second = _mm256_add_ps(_mm256_loadu_ps(pRow0 + x * 8 + 8), _mm256_loadu_ps(pRow1 + x * 8 + 8));
+            const __m256 left = _mm256_permute2f128_ps(first, second, 0x20);
+            const __m256 right = _mm256_permute2f128_ps(first, second, 0x31);
+            _mm256_storeu_ps(pRow + x * 4, _mm256_mul_ps(_mm256_add_ps(left, right), quarter));
+        }
+        for (; x < width; x++) {
+            const uint32_t x0 = std::min(2 * x, sourceWidth - 1) * 4;
+            const uint32_t x1 = std::min(2 * x + 1, sourceWidth - 1) * 4;
+            const __m128 sum = _mm_add_ps(_mm_add_ps(_mm_loadu_ps(pRow0 + x0), _mm_loadu_ps(pRow0 + x1)),
+                                          _mm_add_ps(_mm_loadu_ps(pRow1 + x0), _mm_loadu_ps(pRow1 + x1)));
+            _mm_storeu_ps(pRow + x * 4, _mm_mul_ps(sum, _mm256_castps256_ps128(quarter)));
+        }
+    }
+}
+#endif
+
+//------------------------------------------------------------------------------------------
+//------------------------------------------------------------------------------------------
+std::vector<TextureData> generate_mips(SimdLevel level, const TextureData& image, TextureUsage usage) {
+    if (image.width == 0 || image.height == 0 || image.texels.size() != static_cast<size_t>(image.width) * image.height * 4) {
+        throw std::runtime_error("Failed to generate mips, the image is empty or its size doesn't match!");
+    }
+    if (level > get_simd_level()) {
+        level = get_simd_level();
+    }
+
+    const uint32_t mipCount = get_texture_mip_count(image.width, image.height);
+    std::vector<TextureData> mips;
+    mips.reserve(mipCount);
+    mips.push_back(image);
+
+    std::vector<float> source;
+    std::vector<float> dest;
+    unpack_texels(image, usage, source);
+    for (uint32_t mip = 1; mip < mipCount; mip++) {
+        const TextureData& previous = mips.back();
+        TextureData next;
+        next.width = std::max(previous.width / 2, 1u);
+        next.height = std::max(previous.height / 2, 1u);
+        dest.resize(static_cast<size_t>(next.width) * next.height * 4);
+
+        switch (level) {
+#if J_SIMD_X86
+            case SIMD_LEVEL_AVX2:
+                downsample_avx2(source.data(), previous.width, previous.height, dest.data());
+                break;
+            case SIMD_LEVEL_SSE:
+                downsample_sse(source.data(), previous.width, previous.height, dest.data());
+                break;
+#endif
+            default:
+                downsample_scalar(source.data(), previous.width, previous.height, dest.data());
+                break;
+        }
+
+        pack_texels(dest, usage, next);
+        mips.push_back(std::move(next));
+        source.swap(dest);
+    }
+    return mips;
+}
+
+//------------------------------------------------------------------------------------------
+//------------------------------------------------------------------------------------------
+double compute_psnr(const TextureData& reference, const TextureData& image, uint32_t channelCount) {
+    if (reference.width != image.width || reference.height != image.height || reference.texels.size() != image.texels.size()) {
+        throw std::runtime_error("Failed to compare textures, their sizes differ!");
+    }
+
+    uint64_t squaredError = 0;
+    for (size_t i = 0; i < reference.texels.size(); i += 4) {
+        for (uint32_t c = 0; c < channelCount; c++) {
+            const int32_t difference = static_cast<int32_t>(reference.texels[i + c]) - image.texels[i + c];
+            squaredError += static_cast<uint64_t>(difference * difference);
+        }
+    }
+    if (squaredError == 0) {
+        return std::numeric_limits<double>::infinity();
+    }
+    const double meanSquaredError = static_cast<double>(squaredError) / (reference.texels.size() / 4 * channelCount);
+    return 10.0 * std::log10(255.0 * 255.0 / meanSquaredError);
+}
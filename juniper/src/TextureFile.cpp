@@ -0,0 +1,286 @@
+//======================================================================
+// TextureFile.cpp
+//
+// Keegan Kochis
+// Created: 2026/10/18
+// The definition of the TextureFile class.
+//======================================================================
+
+#include "TextureFile.h"
+
+#include <cstdint>
+#include <cstring>
+
+#include <algorithm>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+static_assert(sizeof(TextureFileHeader) == 80, "The KTX2 header layout is fixed by the format");
+static_assert(sizeof(TextureFileLevel) == 24, "The KTX2 level index layout is fixed by the format");
+
+// Values of the Khronos data format descriptor the files are described with
+static const uint8_t DFD_MODEL_RGBSDA = 1;
+static const uint8_t DFD_MODEL_BC1A = 128;
+static const uint8_t DFD_MODEL_BC3 = 130;
+static const uint8_t DFD_MODEL_BC5 = 132;
+static const uint8_t DFD_MODEL_BC7 = 134;
+static const uint8_t DFD_PRIMARIES_BT709 = 1;
+static const uint8_t DFD_TRANSFER_LINEAR = 1;
+static const uint8_t DFD_TRANSFER_SRGB = 2;
+static const uint8_t DFD_CHANNEL_ALPHA = 15;
+// Qualifier of samples that stay linear under an sRGB transfer, i.e. alpha
+static const uint8_t DFD_SAMPLE_LINEAR = 0x10;
+static const uint32_t DFD_VERSION = 2;
+
+const uint8_t TextureFile::IDENTIFIER[12] = { 0xAB, 0x4B, 0x54, 0x58, 0x20, 0x32, 0x30, 0xBB, 0x0D, 0x0A, 0x1A, 0x0A };
+
+struct DfdSample_t {
+    uint16_t bitOffset;
+    uint8_t bitLength;              // Minus one
+    uint8_t channelType;            // Channel id and qualifiers
+    uint8_t samplePosition[4];
+    uint32_t sampleLower;
+    uint32_t sampleUpper;
+}; typedef DfdSample_t DfdSample;
+
+static_assert(sizeof(DfdSample) == 16, "The DFD sample layout is fixed by the format");
+
+//------------------------------------------------------------------------------------------
+//------------------------------------------------------------------------------------------
+static uint64_t align_offset(uint64_t offset, uint64_t alignment) {
+    return (offset + alignment - 1) / alignment * alignment;
+}
+
+//------------------------------------------------------------------------------------------
+// A basic descriptor block with one sample per channel, or per 64 bit half of the block for
+// the compressed formats, preceded by the total size
+//------------------------------------------------------------------------------------------
+static std::vector<uint8_t> build_dfd(TextureFormat format, TextureUsage usage) {
+    const bool srgb = get_texture_vk_format(format, usage) != get_texture_vk_format(format, TEXTURE_USAGE_DATA);
+    const uint8_t alphaType = DFD_CHANNEL_ALPHA | (srgb ? DFD_SAMPLE_LINEAR : 0);
+    const uint32_t blockBits = get_texture_block_bytes(format) * 8;
+
+    uint8_t model = DFD_MODEL_RGBSDA;
+    std::vector<DfdSample> samples;
+    switch (format) {
+        case TEXTURE_FORMAT_BC1:
+            model = DFD_MODEL_BC1A;
+            samples.push_back({ 0, 63, 0, {}, 0, UINT32_MAX });
+            break;
+        case TEXTURE_FORMAT_BC3:
+            model = DFD_MODEL_BC3;
+            samples.push_back({ 0, 63, alphaType, {}, 0, UINT32_MAX });
+            samples.push_back({ 64, 63, 0, {}, 0, UINT32_MAX });
+            break;
+        case TEXTURE_FORMAT_BC5:
+            model = DFD_MODEL_BC5;
+            samples.push_back({ 0, 63, 0, {}, 0, UINT32_MAX });
+            samples.push_back({ 64, 63, 1, {}, 0, UINT32_MAX });
+            break;
+        case TEXTURE_FORMAT_BC7:
+            model = DFD_MODEL_BC7;
+            samples.push_back({ 0, 127, 0, {}, 0, UINT32_MAX });
+            break;
+        default:
+            for (uint8_t channel = 0; channel < 4; channel++) {
+                const uint8_t channelType = channel == 3 ? alphaType : channel;
+                samples.push_back({ static_cast<uint16_t>(channel * 8), 7, channelType, {}, 0, 255 });
+            }
+            break;
+    }
+
+    const uint32_t blockSize = 24 + static_cast<uint32_t>(samples.size() * sizeof(DfdSample));
+    const uint32_t totalSize = 4 + blockSize;
+    const uint32_t words[3] = { totalSize, 0, DFD_VERSION | (blockSize << 16) };
+    const uint8_t blockDimension = is_block_compressed(format) ? TEXTURE_BLOCK_SIZE - 1 : 0;
+    const uint8_t fields[16] = {
+        model, DFD_PRIMARIES_BT709, srgb ? DFD_TRANSFER_SRGB : DFD_TRANSFER_LINEAR, 0,
+        blockDimension, blockDimension, 0, 0,
+        static_cast<uint8_t>(blockBits / 8), 0, 0, 0, 0, 0, 0, 0
+    };
+
+    std::vector<uint8_t> dfd(totalSize);
+    memcpy(dfd.data(), words, sizeof(words));
+    memcpy(dfd.data() + sizeof(words), fields, sizeof(fields));
+    memcpy(dfd.data() + sizeof(words) + sizeof(fields), samples.data(), samples.size() * sizeof(DfdSample));
+    return dfd;
+}
+
+TextureFile::TextureFile() {
+}
+
+TextureFile::~TextureFile() {
+    close();
+}
+
+//------------------------------------------------------------------------------------------
+//------------------------------------------------------------------------------------------
+void TextureFile::open(const std::string& path) {
+    close();
+    mFile.open(path);
+    try {
+        validate(&mFormat);
+    }
+    catch (...) {
+        mFile.close();
+        throw;
+    }
+
+    mpHeader = reinterpret_cast<const TextureFileHeader*>(mFile.get_data());
+    mpLevels = reinterpret_cast<const TextureFileLevel*>(mFile.get_data() + sizeof(TextureFileHeader));
+}
+
+//------------------------------------------------------------------------------------------
+//------------------------------------------------------------------------------------------
+void TextureFile::close() {
+    mFile.close();
+    mpHeader = nullptr;
+    mpLevels = nullptr;
+    mFormat = TEXTURE_FORMAT_RGBA8;
+}
+
+//------------------------------------------------------------------------------------------
+//------------------------------------------------------------------------------------------
+TextureLevelView TextureFile::get_level(uint32_t level) const {
+    TextureLevelView view;
+    view.pData = mFile.get_data() + mpLevels[level].byteOffset;
+    view.bytes = mpLevels[level].byteLength;
+    view.width = std::max(mpHeader->width >> level, 1u);
+    view.height = std::max(mpHeader->height >> level, 1u);
+    return view;
+}
+
+//------------------------------------------------------------------------------------------
+//------------------------------------------------------------------------------------------
+FileRange TextureFile::get_data_range() const {
+    const TextureFileLevel& smallest = mpLevels[mpHeader->levelCount - 1];
+    FileRange range;
+    range.offset = smallest.byteOffset;
+    range.bytes = mpLevels[0].byteOffset + mpLevels[0].byteLength - smallest.byteOffset;
+    return range;
+}
+
+//------------------------------------------------------------------------------------------
+// The least common multiple of the block size and 4, which the block sizes already are
+//------------------------------------------------------------------------------------------
+uint64_t TextureFile::get_level_alignment() const {
+    return get_texture_block_bytes(mFormat);
+}
+
+//------------------------------------------------------------------------------------------
+// The header and level index are followed by the data format descriptor, then the levels
+// from the smallest up, each aligned to its block size
+//------------------------------------------------------------------------------------------
+void TextureFile::write(const std::string& path, TextureFormat format, TextureUsage usage, uint32_t width, uint32_t height,
+                        const std::vector<std::vector<uint8_t>>& levels) {
+    const uint32_t levelCount = static_cast<uint32_t>(levels.size());
+    if (width == 0 || height == 0 || levelCount == 0 || levelCount > get_texture_mip_count(width, height)) {
+        throw std::runtime_error("Failed to write texture file " + path + ", the level chain doesn't fit the size!");
+    }
+
+    const std::vector<uint8_t> dfd = build_dfd(format, usage);
+    const uint64_t alignment = get_texture_block_bytes(format);
+
+    TextureFileHeader header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.identifier, IDENTIFIER, sizeof(IDENTIFIER));
+    header.vkFormat = get_texture_vk_format(format, usage);
+    header.typeSize = 1;
+    header.width = width;
+    header.height = height;
+    header.faceCount = 1;
+    header.levelCount = levelCount;
+    header.dfdByteOffset = static_cast<uint32_t>(sizeof(TextureFileHeader) + levelCount * sizeof(TextureFileLevel));
+    header.dfdByteLength = static_cast<uint32_t>(dfd.size());
+
+    std::vector<TextureFileLevel> levelIndex(levelCount);
+    uint64_t offset = header.dfdByteOffset + header.dfdByteLength;
+    for (uint32_t i = levelCount; i-- > 0;) {
+        const uint64_t levelBytes = get_texture_level_bytes(format, std::max(width >> i, 1u), std::max(height >> i, 1u));
+        if (levels[i].size() != levelBytes) {
+            throw std::runtime_error("Failed to write texture file " + path + ", level " + std::to_string(i) +
+                                     " has the wrong size!");
+        }
+        offset = align_offset(offset, alignment);
+        levelIndex[i].byteOffset = offset;
+        levelIndex[i].byteLength = levelBytes;
+        levelIndex[i].uncompressedByteLength = levelBytes;
+        offset += levelBytes;
+    }
+
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    if (!file.is_open()) {
+        throw std::runtime_error("Failed to create texture file " + path + "!");
+    }
+
+    const char zeros[16] = {};
+    file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    file.write(reinterpret_cast<const char*>(levelIndex.data()), static_cast<std::streamsize>(levelCount * sizeof(TextureFileLevel)));
+    file.write(reinterpret_cast<const char*>(dfd.data()), static_cast<std::streamsize>(dfd.size()));
+    uint64_t written = header.dfdByteOffset + header.dfdByteLength;
+    for (uint32_t i = levelCount; i-- > 0;) {
+        file.write(zeros, static_cast<std::streamsize>(levelIndex[i].byteOffset - written));
+        file.write(reinterpret_cast<const char*>(levels[i].data()), static_cast<std::streamsize>(levels[i].size()));
+        written = levelIndex[i].byteOffset + levelIndex[i].byteLength;
+    }
+
+    if (!file.good()) {
+        throw std::runtime_error("Failed to write texture file " + path + "!");
+    }
+}
+
+//------------------------------------------------------------------------------------------
+// Everything the upload reads has to lie inside the file and match the size the format
+// implies. The data format descriptor is only bounds checked, the format is taken from
+// vkFormat.
+//------------------------------------------------------------------------------------------
+void TextureFile::validate(TextureFormat* pFormat) const {
+    const std::string& path = mFile.get_path();
+    const uint64_t fileBytes = mFile.get_size();
+    if (fileBytes < sizeof(TextureFileHeader)) {
+        throw std::runtime_error("Failed to load texture file " + path + ", it's truncated!");
+    }
+
+    const TextureFileHeader& header = *reinterpret_cast<const TextureFileHeader*>(mFile.get_data());
+    if (memcmp(header.identifier, IDENTIFIER, sizeof(IDENTIFIER)) != 0) {
+        throw std::runtime_error("Failed to load texture file " + path + ", it's not a KTX2 file!");
+    }
+
+    bool known = false;
+    for (uint32_t format = 0; format < TEXTURE_FORMAT_COUNT && !known; format++) {
+        for (uint32_t usage = 0; usage < TEXTURE_USAGE_COUNT && !known; usage++) {
+            known = header.vkFormat == static_cast<uint32_t>(get_texture_vk_format(static_cast<TextureFormat>(format),
+                                                                                   static_cast<TextureUsage>(usage)));
+            *pFormat = static_cast<TextureFormat>(format);
+        }
+    }
+    if (!known || header.typeSize != 1 || header.supercompressionScheme != 0) {
+        throw std::runtime_error("Failed to load texture file " + path + ", its format isn't supported!");
+    }
+    if (header.width == 0 || header.height == 0 || header.depth != 0 || header.layerCount != 0 || header.faceCount != 1 ||
+        header.levelCount == 0 || header.levelCount > get_texture_mip_count(header.width, header.height)) {
+        throw std::runtime_error("Failed to load texture file " + path + ", it's not a 2D texture with a mip chain!");
+    }
+
+    const uint64_t levelIndexEnd = sizeof(TextureFileHeader) + static_cast<uint64_t>(header.levelCount) * sizeof(TextureFileLevel);
+    if (levelIndexEnd > fileBytes || static_cast<uint64_t>(header.dfdByteOffset) + header.dfdByteLength > fileBytes) {
+        throw std::runtime_error("Failed to load texture file " + path + ", it's truncated!");
+    }
+
+    const TextureFileLevel* pLevels = reinterpret_cast<const TextureFileLevel*>(mFile.get_data() + sizeof(TextureFileHeader));
+    const uint64_t alignment = get_texture_block_bytes(*pFormat);
+    for (uint32_t i = 0; i < header.levelCount; i++) {
+        const TextureFileLevel& level = pLevels[i];
+        const uint64_t levelBytes = get_texture_level_bytes(*pFormat, std::max(header.width >> i, 1u), std::max(header.height >> i, 1u));
+        if (!mFile.contains({ level.byteOffset, level.byteLength }, alignment) || level.byteLength != levelBytes ||
+            level.uncompressedByteLength != levelBytes) {
+            throw std::runtime_error("Failed to load texture file " + path + ", a level is out of bounds!");
+        }
+        // The upload copies the chain as one range
+        if (i > 0 && level.byteOffset + level.byteLength > pLevels[i - 1].byteOffset) {
+            throw std::runtime_error("Failed to load texture file " + path + ", its levels aren't stored smallest first!");
+        }
+    }
+}
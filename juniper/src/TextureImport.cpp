@@ -0,0 +1,122 @@
+//======================================================================
+// TextureImport.cpp
+//
+// Keegan Kochis
+// Created: 2026/10/18
+// Importers of source image formats.
+//======================================================================
+
+#include "TextureImport.h"
+
+#include <cstdint>
+
+#include <algorithm>
+#include <fstream>
+#include <iterator>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+static const uint32_t TGA_HEADER_BYTES = 18;
+
+enum TgaImageType_t {
+    TGA_IMAGE_TYPE_COLOR = 2,
+    TGA_IMAGE_TYPE_GRAY = 3,
+    TGA_IMAGE_TYPE_COLOR_RLE = 10,
+    TGA_IMAGE_TYPE_GRAY_RLE = 11
+}; typedef TgaImageType_t TgaImageType;
+
+//------------------------------------------------------------------------------------------
+// Pixels are stored BGR(A) with the origin in the bottom left unless the descriptor says
+// otherwise. Run length packets may cross rows, so the pixels are decoded in file order
+// first and placed afterwards.
+//------------------------------------------------------------------------------------------
+TextureData import_tga(const std::string& path) {
+    std::ifstream file(path, std::ios::binary);
+    if (!file.is_open()) {
+        throw std::runtime_error("Failed to open file " + path + "!");
+    }
+    const std::vector<uint8_t> bytes((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    if (bytes.size() < TGA_HEADER_BYTES) {
+        throw std::runtime_error("Failed to import " + path + ", it's truncated!");
+    }
+
+    const uint8_t idBytes = bytes[0];
+    const uint8_t colorMapType = bytes[1];
+    const uint8_t imageType = bytes[2];
+    const uint32_t width = bytes[12] | (bytes[13] << 8);
+    const uint32_t height = bytes[14] | (bytes[15] << 8);
+    const uint32_t pixelBits = bytes[16];
+    const uint8_t descriptor = bytes[17];
+
+    const bool gray = imageType == TGA_IMAGE_TYPE_GRAY || imageType == TGA_IMAGE_TYPE_GRAY_RLE;
+    const bool rle = imageType == TGA_IMAGE_TYPE_COLOR_RLE || imageType == TGA_IMAGE_TYPE_GRAY_RLE;
+    if (colorMapType != 0 || (!gray && imageType != TGA_IMAGE_TYPE_COLOR && imageType != TGA_IMAGE_TYPE_COLOR_RLE)) {
+        throw std::runtime_error("Failed to import " + path + ", only true color and grayscale TGA files are supported!");
+    }
+    if ((gray && pixelBits != 8) || (!gray && pixelBits != 24 && pixelBits != 32) || width == 0 || height == 0) {
+        throw std::runtime_error("Failed to import " + path + ", its pixel size isn't supported!");
+    }
+
+    const uint32_t pixelBytes = pixelBits / 8;
+    const size_t pixelCount = static_cast<size_t>(width) * height;
+    std::vector<uint8_t> pixels(pixelCount * pixelBytes);
+    size_t cursor = TGA_HEADER_BYTES + idBytes;
+    if (!rle) {
+        if (bytes.size() < cursor + pixels.size()) {
+            throw std::runtime_error("Failed to import " + path + ", it's truncated!");
+        }
+        std::copy(bytes.begin() + cursor, bytes.begin() + cursor + pixels.size(), pixels.begin());
+    }
+    else {
+        size_t written = 0;
+        while (written < pixels.size()) {
+            if (cursor >= bytes.size()) {
+                throw std::runtime_error("Failed to import " + path + ", it's truncated!");
+            }
+            const uint8_t packet = bytes[cursor++];
+            const size_t count = std::min<size_t>((packet & 0x7F) + 1, (pixels.size() - written) / pixelBytes);
+            const size_t literalBytes = (packet & 0x80) ? pixelBytes : count * pixelBytes;
+            if (cursor + literalBytes > bytes.size()) {
+                throw std::runtime_error("Failed to import " + path + ", it's truncated!");
+            }
+            if (packet & 0x80) {
+                for (size_t i = 0; i < count; i++) {
+                    std::copy(bytes.begin() + cursor, bytes.begin() + cursor + pixelBytes, pixels.begin() + written);
+                    written += pixelBytes;
+                }
+            }
+            else {
+                std::copy(bytes.begin() + cursor, bytes.begin() + cursor + literalBytes, pixels.begin() + written);
+                written += literalBytes;
+            }
+            cursor += literalBytes;
+        }
+    }
+
+    TextureData texture;
+    texture.width = width;
+    texture.height = height;
+    texture.texels.resize(pixelCount * 4);
+    const bool topOrigin = (descriptor & 0x20) != 0;
+    const bool rightOrigin = (descriptor & 0x10) != 0;
+    for (uint32_t y = 0; y < height; y++) {
+        const uint32_t sourceY = topOrigin ? y : height - 1 - y;
+        for (uint32_t x = 0; x < width; x++) {
+            const uint32_t sourceX = rightOrigin ? width - 1 - x : x;
+            const uint8_t* pSource = &pixels[(static_cast<size_t>(sourceY) * width + sourceX) * pixelBytes];
+            uint8_t* pTexel = &texture.texels[(static_cast<size_t>(y) * width + x) * 4];
+            if (gray) {
+                pTexel[0] = pTexel[1] = pTexel[2] = pSource[0];
+                pTexel[3] = 255;
+            }
+            else {
+                pTexel[0] = pSource[2];
+                pTexel[1] = pSource[1];
+                pTexel[2] = pSource[0];
+                pTexel[3] = pixelBytes == 4 ? pSource[3] : 255;
+            }
+        }
+    }
+    return texture;
+}
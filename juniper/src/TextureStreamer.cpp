@@ -0,0 +1,476 @@
+//======================================================================
+// TextureStreamer.cpp
+//
+// Keegan Kochis
+// Created: 2026/10/19
+// The definition of the TextureStreamer class.
+//======================================================================
+
+#include "TextureStreamer.h"
+
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+
+#include <algorithm>
+#include <queue>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+//------------------------------------------------------------------------------------------
+//------------------------------------------------------------------------------------------
+static VkImageMemoryBarrier make_barrier(VkImage image, uint32_t levelCount, VkImageLayout oldLayout,
+                                         VkImageLayout newLayout, VkAccessFlags srcAccess, VkAccessFlags dstAccess) {
+    VkImageMemoryBarrier barrier{};
+    barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+    barrier.srcAccessMask = srcAccess;
+    barrier.dstAccessMask = dstAccess;
+    barrier.oldLayout = oldLayout;
+    barrier.newLayout = newLayout;
+    barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    barrier.image = image;
+    barrier.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+    barrier.subresourceRange.baseMipLevel = 0;
+    barrier.subresourceRange.levelCount = levelCount;
+    barrier.subresourceRange.baseArrayLayer = 0;
+    barrier.subresourceRange.layerCount = 1;
+    return barrier;
+}
+
+TextureStreamer::TextureStreamer() {
+}
+
+//------------------------------------------------------------------------------------------
+//------------------------------------------------------------------------------------------
+void TextureStreamer::init(VkInstance instance, VkPhysicalDevice physicalDevice,
+                           const DeviceFeatures::Capabilities& capabilities, GpuResources* pGpuResources,
+                           StagingRing* pStagingRing, uint64_t budgetBytes, Profiler* pProfiler) {
+    mPhysicalDevice = physicalDevice;
+    mpGpuResources = pGpuResources;
+    mpStagingRing = pStagingRing;
+    mpProfiler = pProfiler;
+    mTextureCompressionBC = capabilities.textureCompressionBC;
+    mBudgetBytes = budgetBytes;
+    mFrame = 0;
+    mStats = Stats();
+
+    mpGetMemoryProperties2 = nullptr;
+    if (capabilities.memoryBudget) {
+        mpGetMemoryProperties2 = reinterpret_cast<PFN_vkGetPhysicalDeviceMemoryProperties2>(
+            vkGetInstanceProcAddr(instance, "vkGetPhysicalDeviceMemoryProperties2"));
+    }
+}
+
+//------------------------------------------------------------------------------------------
+// The caller must have waited for the device first
+//------------------------------------------------------------------------------------------
+void TextureStreamer::clean_up() {
+    while (!mTextures.empty()) {
+        remove_texture(mTextures.handle_at(mTextures.size() - 1));
+    }
+    for (ImageHandle image : mRetiredImages) {
+        mpGpuResources->destroy_image(image);
+    }
+    mRetiredImages.clear();
+}
+
+//------------------------------------------------------------------------------------------
+//------------------------------------------------------------------------------------------
+StreamedTextureHandle TextureStreamer::add_texture(const std::string& path) {
+    StreamedTexture texture;
+    texture.pFile = std::make_unique<TextureFile>();
+    texture.pFile->open(path);
+    const TextureFile& file = *texture.pFile;
+    if (is_block_compressed(file.get_format()) && !mTextureCompressionBC) {
+        throw std::runtime_error("Failed to stream texture " + path + ", the device can't sample " +
+                                 texture_format_name(file.get_format()) + "!");
+    }
+
+    texture.levelCount = file.get_level_count();
+    texture.chainBytes.assign(texture.levelCount + 1, 0);
+    for (uint32_t i = texture.levelCount; i-- > 0;) {
+        texture.chainBytes[i] = texture.chainBytes[i + 1] + file.get_level(i).bytes;
+    }
+    texture.tailLevel = texture.levelCount - 1;
+    for (uint32_t i = 0; i < texture.levelCount; i++) {
+        const TextureLevelView level = file.get_level(i);
+        if (std::max(level.width, level.height) <= TAIL_SIZE) {
+            texture.tailLevel = i;
+            break;
+        }
+    }
+    texture.residentLevel = texture.levelCount;
+    texture.wantedLevel = texture.tailLevel;
+    texture.targetLevel = texture.tailLevel;
+    texture.lastRequestFrame = mFrame;
+    return mTextures.add(std::move(texture));
+}
+
+//------------------------------------------------------------------------------------------
+// The image may still be read by commands recorded this frame, so it is destroyed on the
+// next update
+//------------------------------------------------------------------------------------------
+void TextureStreamer::remove_texture(StreamedTextureHandle handle) {
+    StreamedTexture& texture = mTextures.get<0>(handle);
+    if (!texture.image.is_null()) {
+        mRetiredImages.push_back(texture.image);
+    }
+    mStats.residentBytes -= texture.chainBytes[texture.residentLevel];
+    texture.pFile->close();
+    mTextures.remove(handle);
+}
+
+//------------------------------------------------------------------------------------------
+//------------------------------------------------------------------------------------------
+void TextureStreamer::request_level(StreamedTextureHandle handle, uint32_t level) {
+    StreamedTexture& texture = mTextures.get<0>(handle);
+    texture.requestedLevel = std::min(texture.requestedLevel, level);
+}
+
+//------------------------------------------------------------------------------------------
+// Each level halves the texels, so the level is log2 of the texels per pixel
+//------------------------------------------------------------------------------------------
+uint32_t TextureStreamer::estimate_level(StreamedTextureHandle handle, float screenPixels) const {
+    const StreamedTexture& texture = mTextures.get<0>(handle);
+    if (screenPixels <= 0.0f) {
+        return texture.levelCount - 1;
+    }
+    const TextureFile& file = *texture.pFile;
+    const float texelsPerPixel = static_cast<float>(std::max(file.get_width(), file.get_height())) / screenPixels;
+    if (texelsPerPixel <= 1.0f) {
+        return 0;
+    }
+    const uint32_t level = static_cast<uint32_t>(std::floor(std::log2(texelsPerPixel)));
+    return std::min(level, texture.levelCount - 1);
+}
+
+//------------------------------------------------------------------------------------------
+//------------------------------------------------------------------------------------------
+void TextureStreamer::apply_feedback(const uint32_t* pLevels, uint32_t count) {
+    for (size_t i = 0; i < mTextures.size(); i++) {
+        const StreamedTextureHandle handle = mTextures.handle_at(i);
+        const uint32_t slot = get_feedback_slot(handle);
+        if (slot < count && pLevels[slot] != UINT32_MAX) {
+            request_level(handle, pLevels[slot]);
+        }
+    }
+}
+
+//------------------------------------------------------------------------------------------
+// Downgrades go first since they only copy on the GPU and free memory for the upgrades.
+// Upgrades go to the textures that look worst first, a texture without any levels before
+// all others, and stop at the upload limit or when the staging ring is full.
+//------------------------------------------------------------------------------------------
+void TextureStreamer::update(VkCommandBuffer commandBuffer) {
+    // The copies out of these were recorded last frame, which has been submitted since
+    for (ImageHandle image : mRetiredImages) {
+        mpGpuResources->destroy_image(image);
+    }
+    mRetiredImages.clear();
+
+    mFrame++;
+    mStats.rebuilds = 0;
+    const uint64_t budgetBytes = query_budget();
+    mStats.budgetBytes = budgetBytes;
+    plan_levels(budgetBytes);
+
+    // Levels finer than the target stay cached while everything fits, once it doesn't the
+    // least recently requested textures give theirs up first
+    std::vector<StreamedTexture>& textures = mTextures.column<0>();
+    std::vector<uint32_t> finalLevels(textures.size());
+    std::vector<uint32_t> cached;
+    uint64_t finalBytes = 0;
+    for (size_t i = 0; i < textures.size(); i++) {
+        const StreamedTexture& texture = textures[i];
+        finalLevels[i] = std::min(texture.residentLevel, texture.targetLevel);
+        finalBytes += texture.chainBytes[finalLevels[i]];
+        if (finalLevels[i] < texture.targetLevel) {
+            cached.push_back(static_cast<uint32_t>(i));
+        }
+    }
+    if (finalBytes > budgetBytes) {
+        std::sort(cached.begin(), cached.end(), [&textures](uint32_t a, uint32_t b) {
+            return textures[a].lastRequestFrame < textures[b].lastRequestFrame;
+        });
+        for (size_t i = 0; i < cached.size() && finalBytes > budgetBytes; i++) {
+            const StreamedTexture& texture = textures[cached[i]];
+            finalBytes -= texture.chainBytes[finalLevels[cached[i]]] - texture.chainBytes[texture.targetLevel];
+            finalLevels[cached[i]] = texture.targetLevel;
+        }
+    }
+
+    std::vector<uint32_t> upgrades;
+    for (size_t i = 0; i < textures.size(); i++) {
+        StreamedTexture& texture = textures[i];
+        if (finalLevels[i] > texture.residentLevel) {
+            mStats.evictedBytes += texture.chainBytes[texture.residentLevel] - texture.chainBytes[finalLevels[i]];
+            rebuild(texture, finalLevels[i], commandBuffer);
+        }
+        else if (finalLevels[i] < texture.residentLevel) {
+            upgrades.push_back(static_cast<uint32_t>(i));
+        }
+    }
+
+    // The resolution of the finest resident level, zero without any
+    auto residentSize = [&textures](uint32_t index) {
+        const StreamedTexture& texture = textures[index];
+        if (texture.residentLevel == texture.levelCount) {
+            return 0u;
+        }
+        const TextureLevelView level = texture.pFile->get_level(texture.residentLevel);
+        return std::max(level.width, level.height);
+    };
+    std::sort(upgrades.begin(), upgrades.end(), [&residentSize](uint32_t a, uint32_t b) {
+        return residentSize(a) < residentSize(b);
+    });
+
+    uint64_t uploadBytes = 0;
+    for (uint32_t index : upgrades) {
+        StreamedTexture& texture = textures[index];
+        const uint64_t residentBytes = texture.chainBytes[texture.residentLevel];
+        // The finest level that still fits the upload limit, at least one level per update
+        // so a level larger than the limit streams in on its own
+        uint32_t level = finalLevels[index];
+        while (level + 1 < texture.residentLevel &&
+               uploadBytes + texture.chainBytes[level] - residentBytes > MAX_UPLOAD_BYTES) {
+            level++;
+        }
+        if (uploadBytes > 0 && uploadBytes + texture.chainBytes[level] - residentBytes > MAX_UPLOAD_BYTES) {
+            break;
+        }
+        if (!rebuild(texture, level, commandBuffer)) {
+            break;
+        }
+        uploadBytes += texture.chainBytes[level] - residentBytes;
+        if (uploadBytes >= MAX_UPLOAD_BYTES) {
+            break;
+        }
+    }
+    mStats.textureCount = static_cast<uint32_t>(textures.size());
+    export_counters();
+}
+
+//------------------------------------------------------------------------------------------
+//------------------------------------------------------------------------------------------
+ImageHandle TextureStreamer::get_image(StreamedTextureHandle handle) const {
+    return mTextures.get<0>(handle).image;
+}
+
+//------------------------------------------------------------------------------------------
+//------------------------------------------------------------------------------------------
+uint32_t TextureStreamer::get_resident_level(StreamedTextureHandle handle) const {
+    return mTextures.get<0>(handle).residentLevel;
+}
+
+//------------------------------------------------------------------------------------------
+//------------------------------------------------------------------------------------------
+void TextureStreamer::print_stats(std::ostream& out) const {
+    out << "Texture streamer stats:\n";
+    out << "\tTextures: " << mStats.textureCount << '\n';
+    out << "\tBudget: " << mStats.budgetBytes / 1024 << " KB" << (mStats.deviceBudget ? " (device)" : "") << '\n';
+    out << "\tResident: " << mStats.residentBytes / 1024 << " KB\n";
+    out << "\tRequested: " << mStats.requestedBytes / 1024 << " KB\n";
+    out << "\tBudget limited: " << mStats.budgetLimited << '\n';
+    out << "\tUploaded: " << mStats.uploadedBytes / 1024 << " KB\n";
+    out << "\tEvicted: " << mStats.evictedBytes / 1024 << " KB\n";
+    out << "\tRebuilds: " << mStats.rebuilds << '\n';
+}
+
+//------------------------------------------------------------------------------------------
+//------------------------------------------------------------------------------------------
+void TextureStreamer::export_counters() const {
+    if (!mpProfiler) {
+        return;
+    }
+    mpProfiler->set_counter("Texture budget MB", mStats.budgetBytes / (1024.0 * 1024.0));
+    mpProfiler->set_counter("Texture resident MB", mStats.residentBytes / (1024.0 * 1024.0));
+    mpProfiler->set_counter("Texture requested MB", mStats.requestedBytes / (1024.0 * 1024.0));
+    mpProfiler->set_counter("Texture budget limited", static_cast<double>(mStats.budgetLimited));
+}
+
+//------------------------------------------------------------------------------------------
+// The driver's budget covers everything in the device local heaps, of which only our own
+// resident levels are ours to stream, the rest of the usage stays where it is
+//------------------------------------------------------------------------------------------
+uint64_t TextureStreamer::query_budget() {
+    mStats.deviceBudget = false;
+    if (mpGetMemoryProperties2 == nullptr) {
+        return mBudgetBytes;
+    }
+
+    VkPhysicalDeviceMemoryBudgetPropertiesEXT budgetProperties{};
+    budgetProperties.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_MEMORY_BUDGET_PROPERTIES_EXT;
+    VkPhysicalDeviceMemoryProperties2 properties{};
+    properties.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_MEMORY_PROPERTIES_2;
+    properties.pNext = &budgetProperties;
+    mpGetMemoryProperties2(mPhysicalDevice, &properties);
+
+    uint64_t heapBudget = 0;
+    uint64_t heapUsage = 0;
+    for (uint32_t i = 0; i < properties.memoryProperties.memoryHeapCount; i++) {
+        if (properties.memoryProperties.memoryHeaps[i].flags & VK_MEMORY_HEAP_DEVICE_LOCAL_BIT) {
+            heapBudget += budgetProperties.heapBudget[i];
+            heapUsage += budgetProperties.heapUsage[i];
+        }
+    }
+    const uint64_t otherUsage = heapUsage > mStats.residentBytes ? heapUsage - mStats.residentBytes : 0;
+    const uint64_t available = heapBudget > otherUsage ? heapBudget - otherUsage : 0;
+    if (available < mBudgetBytes) {
+        mStats.deviceBudget = true;
+        return available;
+    }
+    return mBudgetBytes;
+}
+
+//------------------------------------------------------------------------------------------
+// A request holds for REQUEST_FRAMES, after which the texture falls back to its tail. While
+// the wanted levels exceed the budget, the largest finest level of any texture is dropped,
+// so large textures give up resolution before small ones do.
+//------------------------------------------------------------------------------------------
+void TextureStreamer::plan_levels(uint64_t budgetBytes) {
+    std::vector<StreamedTexture>& textures = mTextures.column<0>();
+    // Bytes of the finest target level and the texture's dense index
+    typedef std::pair<uint64_t, uint32_t> Candidate;
+    std::priority_queue<Candidate> candidates;
+    uint64_t requestedBytes = 0;
+    for (size_t i = 0; i < textures.size(); i++) {
+        StreamedTexture& texture = textures[i];
+        if (texture.requestedLevel != UINT32_MAX) {
+            texture.wantedLevel = std::min(texture.requestedLevel, texture.tailLevel);
+            texture.lastRequestFrame = mFrame;
+        }
+        else if (mFrame - texture.lastRequestFrame > REQUEST_FRAMES) {
+            texture.wantedLevel = texture.tailLevel;
+        }
+        texture.requestedLevel = UINT32_MAX;
+        texture.targetLevel = texture.wantedLevel;
+        requestedBytes += texture.chainBytes[texture.wantedLevel];
+        if (texture.targetLevel < texture.tailLevel) {
+            const uint64_t levelBytes = texture.chainBytes[texture.targetLevel] - texture.chainBytes[texture.targetLevel + 1];
+            candidates.push(Candidate(levelBytes, static_cast<uint32_t>(i)));
+        }
+    }
+    mStats.requestedBytes = requestedBytes;
+
+    uint64_t targetBytes = requestedBytes;
+    while (targetBytes > budgetBytes && !candidates.empty()) {
+        const Candidate candidate = candidates.top();
+        candidates.pop();
+        StreamedTexture& texture = textures[candidate.second];
+        targetBytes -= candidate.first;
+        texture.targetLevel++;
+        if (texture.targetLevel < texture.tailLevel) {
+            const uint64_t levelBytes = texture.chainBytes[texture.targetLevel] - texture.chainBytes[texture.targetLevel + 1];
+            candidates.push(Candidate(levelBytes, candidate.second));
+        }
+    }
+
+    mStats.budgetLimited = 0;
+    for (const StreamedTexture& texture : textures) {
+        if (texture.targetLevel > texture.wantedLevel) {
+            mStats.budgetLimited++;
+        }
+    }
+}
+
+//------------------------------------------------------------------------------------------
+// The levels between finestLevel and the resident ones are contiguous in the file, smallest
+// first, so they are staged with one copy and keep their relative offsets. The levels both
+// images share are copied over on the GPU.
+//------------------------------------------------------------------------------------------
+bool TextureStreamer::rebuild(StreamedTexture& texture, uint32_t finestLevel, VkCommandBuffer commandBuffer) {
+    const TextureFile& file = *texture.pFile;
+    const uint32_t levelCount = texture.levelCount - finestLevel;
+
+    StagingRing::Allocation allocation;
+    const uint8_t* pStagedStart = nullptr;
+    if (finestLevel < texture.residentLevel) {
+        pStagedStart = file.get_level(texture.residentLevel - 1).pData;
+        const TextureLevelView finest = file.get_level(finestLevel);
+        const uint64_t stagedBytes = static_cast<uint64_t>(finest.pData + finest.bytes - pStagedStart);
+        allocation = mpStagingRing->allocate(stagedBytes, file.get_level_alignment());
+        if (allocation.pData == nullptr) {
+            return false;
+        }
+        memcpy(allocation.pData, pStagedStart, stagedBytes);
+        mStats.uploadedBytes += texture.chainBytes[finestLevel] - texture.chainBytes[texture.residentLevel];
+    }
+
+    const TextureLevelView finest = file.get_level(finestLevel);
+    const VkExtent3D extent = { finest.width, finest.height, 1 };
+    const ImageHandle handle = mpGpuResources->create_image(extent, file.get_vk_format(),
+                                                            VK_IMAGE_USAGE_TRANSFER_SRC_BIT |
+                                                            VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_SAMPLED_BIT,
+                                                            VK_IMAGE_ASPECT_COLOR_BIT, levelCount);
+    const VkImage image = mpGpuResources->get_image(handle);
+    const VkImage oldImage = texture.image.is_null() ? VK_NULL_HANDLE : mpGpuResources->get_image(texture.image);
+    const uint32_t oldLevelCount = texture.levelCount - texture.residentLevel;
+
+    std::vector<VkImageMemoryBarrier> barriers;
+    barriers.push_back(make_barrier(image, levelCount, VK_IMAGE_LAYOUT_UNDEFINED, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+                                    0, VK_ACCESS_TRANSFER_WRITE_BIT));
+    if (oldImage != VK_NULL_HANDLE) {
+        barriers.push_back(make_barrier(oldImage, oldLevelCount, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
+                                        VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, VK_ACCESS_SHADER_READ_BIT,
+                                        VK_ACCESS_TRANSFER_READ_BIT));
+    }
+    vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT | VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+                         VK_PIPELINE_STAGE_TRANSFER_BIT, 0, 0, nullptr, 0, nullptr,
+                         static_cast<uint32_t>(barriers.size()), barriers.data());
+
+    std::vector<VkImageCopy> imageCopies;
+    std::vector<VkBufferImageCopy> bufferCopies;
+    for (uint32_t i = finestLevel; i < texture.levelCount; i++) {
+        const TextureLevelView level = file.get_level(i);
+        if (i >= texture.residentLevel) {
+            VkImageCopy region{};
+            region.srcSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+            region.srcSubresource.mipLevel = i - texture.residentLevel;
+            region.srcSubresource.baseArrayLayer = 0;
+            region.srcSubresource.layerCount = 1;
+            region.dstSubresource = region.srcSubresource;
+            region.dstSubresource.mipLevel = i - finestLevel;
+            region.extent = { level.width, level.height, 1 };
+            imageCopies.push_back(region);
+        }
+        else {
+            VkBufferImageCopy region{};
+            region.bufferOffset = allocation.offset + static_cast<VkDeviceSize>(level.pData - pStagedStart);
+            region.imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+            region.imageSubresource.mipLevel = i - finestLevel;
+            region.imageSubresource.baseArrayLayer = 0;
+            region.imageSubresource.layerCount = 1;
+            region.imageExtent = { level.width, level.height, 1 };
+            bufferCopies.push_back(region);
+        }
+    }
+    if (!imageCopies.empty()) {
+        vkCmdCopyImage(commandBuffer, oldImage, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, image,
+                       VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, static_cast<uint32_t>(imageCopies.size()),
+                       imageCopies.data());
+    }
+    if (!bufferCopies.empty()) {
+        vkCmdCopyBufferToImage(commandBuffer, allocation.buffer, image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+                               static_cast<uint32_t>(bufferCopies.size()), bufferCopies.data());
+    }
+
+    const VkImageMemoryBarrier barrier = make_barrier(image, levelCount, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+                                                      VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
+                                                      VK_ACCESS_TRANSFER_WRITE_BIT, VK_ACCESS_SHADER_READ_BIT);
+    vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT,
+                         VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT | VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+                         0, 0, nullptr, 0, nullptr, 1, &barrier);
+
+    if (!texture.image.is_null()) {
+        mRetiredImages.push_back(texture.image);
+    }
+    mStats.residentBytes -= texture.chainBytes[texture.residentLevel];
+    mStats.residentBytes += texture.chainBytes[finestLevel];
+    texture.image = handle;
+    texture.residentLevel = finestLevel;
+    mStats.rebuilds++;
+    return true;
+}
@@ -0,0 +1,90 @@
+//======================================================================
+// TextureUpload.cpp
+//
+// Keegan Kochis
+// Created: 2026/10/18
+// Recording of texture uploads out of the staging ring.
+//======================================================================
+
+#include "TextureUpload.h"
+
+#include <cstdint>
+#include <cstring>
+
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+//------------------------------------------------------------------------------------------
+//------------------------------------------------------------------------------------------
+static void transition_image(VkCommandBuffer commandBuffer, VkImage image, uint32_t levelCount, VkImageLayout oldLayout,
+                             VkImageLayout newLayout, VkAccessFlags srcAccess, VkAccessFlags dstAccess,
+                             VkPipelineStageFlags srcStages, VkPipelineStageFlags dstStages) {
+    VkImageMemoryBarrier barrier{};
+    barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+    barrier.srcAccessMask = srcAccess;
+    barrier.dstAccessMask = dstAccess;
+    barrier.oldLayout = oldLayout;
+    barrier.newLayout = newLayout;
+    barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    barrier.image = image;
+    barrier.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+    barrier.subresourceRange.baseMipLevel = 0;
+    barrier.subresourceRange.levelCount = levelCount;
+    barrier.subresourceRange.baseArrayLayer = 0;
+    barrier.subresourceRange.layerCount = 1;
+
+    vkCmdPipelineBarrier(commandBuffer, srcStages, dstStages, 0, 0, nullptr, 0, nullptr, 1, &barrier);
+}
+
+//------------------------------------------------------------------------------------------
+// The chain is staged before the image is created, so a full ring doesn't leave an empty
+// image behind. Level offsets within the ring match their offsets within the file's data
+// range, which keeps every level on its block alignment.
+//------------------------------------------------------------------------------------------
+ImageHandle upload_texture(GpuResources* pGpuResources, StagingRing* pStagingRing, VkCommandBuffer commandBuffer,
+                           const DeviceFeatures::Capabilities& capabilities, const TextureFile& file) {
+    if (is_block_compressed(file.get_format()) && !capabilities.textureCompressionBC) {
+        throw std::runtime_error(std::string("Failed to upload texture, the device can't sample ") +
+                                 texture_format_name(file.get_format()) + "!");
+    }
+
+    const FileRange range = file.get_data_range();
+    const StagingRing::Allocation allocation = pStagingRing->allocate(range.bytes, file.get_level_alignment());
+    if (allocation.pData == nullptr) {
+        return ImageHandle();
+    }
+    const uint8_t* pRangeStart = file.get_level(file.get_level_count() - 1).pData;
+    memcpy(allocation.pData, pRangeStart, range.bytes);
+
+    const uint32_t levelCount = file.get_level_count();
+    const VkExtent3D extent = { file.get_width(), file.get_height(), 1 };
+    const ImageHandle handle = pGpuResources->create_image(extent, file.get_vk_format(),
+                                                           VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_SAMPLED_BIT,
+                                                           VK_IMAGE_ASPECT_COLOR_BIT, levelCount);
+    const VkImage image = pGpuResources->get_image(handle);
+
+    std::vector<VkBufferImageCopy> regions(levelCount);
+    for (uint32_t i = 0; i < levelCount; i++) {
+        const TextureLevelView level = file.get_level(i);
+        VkBufferImageCopy& region = regions[i];
+        region = {};
+        region.bufferOffset = allocation.offset + static_cast<VkDeviceSize>(level.pData - pRangeStart);
+        region.imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+        region.imageSubresource.mipLevel = i;
+        region.imageSubresource.baseArrayLayer = 0;
+        region.imageSubresource.layerCount = 1;
+        region.imageExtent = { level.width, level.height, 1 };
+    }
+
+    transition_image(commandBuffer, image, levelCount, VK_IMAGE_LAYOUT_UNDEFINED, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+                     0, VK_ACCESS_TRANSFER_WRITE_BIT, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT);
+    vkCmdCopyBufferToImage(commandBuffer, allocation.buffer, image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+                           levelCount, regions.data());
+    transition_image(commandBuffer, image, levelCount, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+                     VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, VK_ACCESS_TRANSFER_WRITE_BIT, VK_ACCESS_SHADER_READ_BIT,
+                     VK_PIPELINE_STAGE_TRANSFER_BIT,
+                     VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT | VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT);
+    return handle;
+}
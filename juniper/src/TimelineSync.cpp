@@ -0,0 +1,319 @@
+//======================================================================
+// TimelineSync.cpp
+//
+// Keegan Kochis
+// Created: 2026/10/18
+// The definition of the TimelineSync class.
+//======================================================================
+
+#include "TimelineSync.h"
+
+#include <cstdint>
+
+#include <algorithm>
+#include <stdexcept>
+#include <vector>
+
+#define GLFW_INCLUDE_VULKAN
+#include <GLFW/glfw3.h>
+
+TimelineSync::TimelineSync() {}
+
+//------------------------------------------------------------------------------------------
+// Queues may alias each other (e.g. no dedicated transfer family), each still gets its own
+// timeline so callers never need to know
+//------------------------------------------------------------------------------------------
+void TimelineSync::init(VkDevice device, const DeviceFeatures::Capabilities& capabilities,
+                        VkQueue graphicsQueue, VkQueue computeQueue, VkQueue transferQueue) {
+    mDevice = device;
+    mUseTimelineSemaphores = capabilities.timelineSemaphore;
+
+    mTimelines[QUEUE_GRAPHICS].queue = graphicsQueue;
+    mTimelines[QUEUE_COMPUTE].queue = computeQueue;
+    mTimelines[QUEUE_TRANSFER].queue = transferQueue;
+
+    if (!mUseTimelineSemaphores) {
+        return;
+    }
+
+    // Core in 1.2, only the KHR entry points exist when enabled through the extension
+    mpGetSemaphoreCounterValue = (PFN_vkGetSemaphoreCounterValue) vkGetDeviceProcAddr(mDevice, "vkGetSemaphoreCounterValue");
+    if (mpGetSemaphoreCounterValue == nullptr) {
+        mpGetSemaphoreCounterValue = (PFN_vkGetSemaphoreCounterValue) vkGetDeviceProcAddr(mDevice, "vkGetSemaphoreCounterValueKHR");
+    }
+    mpWaitSemaphores = (PFN_vkWaitSemaphores) vkGetDeviceProcAddr(mDevice, "vkWaitSemaphores");
+    if (mpWaitSemaphores == nullptr) {
+        mpWaitSemaphores = (PFN_vkWaitSemaphores) vkGetDeviceProcAddr(mDevice, "vkWaitSemaphoresKHR");
+    }
+    if (mpGetSemaphoreCounterValue == nullptr || mpWaitSemaphores == nullptr) {
+        throw std::runtime_error("Failed to load timeline semaphore functions!");
+    }
+
+    for (Timeline& timeline : mTimelines) {
+        VkSemaphoreTypeCreateInfo typeCreateInfo{};
+        typeCreateInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_TYPE_CREATE_INFO;
+        typeCreateInfo.semaphoreType = VK_SEMAPHORE_TYPE_TIMELINE;
+        typeCreateInfo.initialValue = 0;
+
+        VkSemaphoreCreateInfo createInfo{};
+        createInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO;
+        createInfo.pNext = &typeCreateInfo;
+
+        if (vkCreateSemaphore(mDevice, &createInfo, nullptr, &timeline.semaphore) != VK_SUCCESS) {
+            throw std::runtime_error("Failed to create timeline semaphore!");
+        }
+    }
+}
+
+//------------------------------------------------------------------------------------------
+//------------------------------------------------------------------------------------------
+void TimelineSync::clean_up() {
+    wait_all();
+
+    for (Timeline& timeline : mTimelines) {
+        if (timeline.semaphore != VK_NULL_HANDLE) {
+            vkDestroySemaphore(mDevice, timeline.semaphore, nullptr);
+            timeline.semaphore = VK_NULL_HANDLE;
+        }
+        for (const PendingFence& pending : timeline.pendingFences) {
+            vkDestroyFence(mDevice, pending.fence, nullptr);
+        }
+        timeline.pendingFences.clear();
+    }
+
+    for (VkFence fence : mFreeFences) {
+        vkDestroyFence(mDevice, fence, nullptr);
+    }
+    mFreeFences.clear();
+}
+
+//------------------------------------------------------------------------------------------
+//------------------------------------------------------------------------------------------
+uint64_t TimelineSync::submit(QueueType queue, const Submission& submission) {
+    if (submission.binaryWaitSemaphores.size() != submission.binaryWaitStages.size()) {
+        throw std::runtime_error("Binary wait semaphores and stages do not match!");
+    }
+
+    if (mUseTimelineSemaphores) {
+        return submit_timeline(mTimelines[queue], submission);
+    }
+    else {
+        return submit_fence(mTimelines[queue], submission);
+    }
+}
+
+//------------------------------------------------------------------------------------------
+//------------------------------------------------------------------------------------------
+uint64_t TimelineSync::poll(QueueType queue) {
+    Timeline& timeline = mTimelines[queue];
+
+    if (mUseTimelineSemaphores) {
+        uint64_t value = 0;
+        if (mpGetSemaphoreCounterValue(mDevice, timeline.semaphore, &value) != VK_SUCCESS) {
+            throw std::runtime_error("Failed to read timeline semaphore value!");
+        }
+        timeline.lastCompleted = value;
+    }
+    else {
+        retire_fences(timeline);
+    }
+
+    return timeline.lastCompleted;
+}
+
+//------------------------------------------------------------------------------------------
+// Only touches the GPU when the cached value is not already high enough
+//------------------------------------------------------------------------------------------
+bool TimelineSync::is_complete(QueueType queue, uint64_t value) {
+    if (mTimelines[queue].lastCompleted >= value) {
+        return true;
+    }
+    return poll(queue) >= value;
+}
+
+//------------------------------------------------------------------------------------------
+//------------------------------------------------------------------------------------------
+void TimelineSync::wait(QueueType queue, uint64_t value) {
+    if (!wait_for(queue, value, UINT64_MAX)) {
+        throw std::runtime_error("Failed to wait on timeline value, the wait timed out!");
+    }
+}
+
+//------------------------------------------------------------------------------------------
+//------------------------------------------------------------------------------------------
+bool TimelineSync::wait_for(QueueType queue, uint64_t value, uint64_t timeoutNs) {
+    if (is_complete(queue, value)) {
+        return true;
+    }
+
+    Timeline& timeline = mTimelines[queue];
+    if (value > timeline.lastSubmitted) {
+        throw std::runtime_error("Waiting on a timeline value that was never submitted!");
+    }
+
+    if (mUseTimelineSemaphores) {
+        VkSemaphoreWaitInfo waitInfo{};
+        waitInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_WAIT_INFO;
+        waitInfo.semaphoreCount = 1;
+        waitInfo.pSemaphores = &timeline.semaphore;
+        waitInfo.pValues = &value;
+
+        VkResult result = mpWaitSemaphores(mDevice, &waitInfo, timeoutNs);
+        if (result == VK_TIMEOUT) {
+            return false;
+        }
+        if (result != VK_SUCCESS) {
+            throw std::runtime_error("Failed to wait on timeline semaphore!");
+        }
+        timeline.lastCompleted = std::max(timeline.lastCompleted, value);
+        return true;
+    }
+
+    // Fences signal in submission order on a queue, so the first one at or past the value is enough
+    for (const PendingFence& pending : timeline.pendingFences) {
+        if (pending.value >= value) {
+            VkResult result = vkWaitForFences(mDevice, 1, &pending.fence, VK_TRUE, timeoutNs);
+            if (result != VK_SUCCESS && result != VK_TIMEOUT) {
+                throw std::runtime_error("Failed to wait on submission fence!");
+            }
+            break;
+        }
+    }
+    retire_fences(timeline);
+    return timeline.lastCompleted >= value;
+}
+
+//------------------------------------------------------------------------------------------
+//------------------------------------------------------------------------------------------
+void TimelineSync::wait_all() {
+    for (uint32_t queue = 0; queue < QUEUE_COUNT; queue++) {
+        wait(static_cast<QueueType>(queue), mTimelines[queue].lastSubmitted);
+    }
+}
+
+//------------------------------------------------------------------------------------------
+// Waits on other queues become timeline semaphore waits. The timeline value array has to
+// cover the binary semaphores too, their entries are ignored.
+//------------------------------------------------------------------------------------------
+uint64_t TimelineSync::submit_timeline(Timeline& timeline, const Submission& submission) {
+    std::vector<VkSemaphore> waitSemaphores;
+    std::vector<VkPipelineStageFlags> waitStages;
+    std::vector<uint64_t> waitValues;
+
+    for (const Wait& wait : submission.waits) {
+        // Already retired, nothing to wait for on the GPU
+        if (wait.value == 0 || mTimelines[wait.queue].lastCompleted >= wait.value) {
+            continue;
+        }
+        waitSemaphores.push_back(mTimelines[wait.queue].semaphore);
+        waitStages.push_back(wait.stages);
+        waitValues.push_back(wait.value);
+    }
+    for (size_t i = 0; i < submission.binaryWaitSemaphores.size(); i++) {
+        waitSemaphores.push_back(submission.binaryWaitSemaphores[i]);
+        waitStages.push_back(submission.binaryWaitStages[i]);
+        waitValues.push_back(0);
+    }
+
+    const uint64_t signalValue = timeline.lastSubmitted + 1;
+
+    std::vector<VkSemaphore> signalSemaphores;
+    std::vector<uint64_t> signalValues;
+    signalSemaphores.push_back(timeline.semaphore);
+    signalValues.push_back(signalValue);
+    for (VkSemaphore semaphore : submission.binarySignalSemaphores) {
+        signalSemaphores.push_back(semaphore);
+        signalValues.push_back(0);
+    }
+
+    VkTimelineSemaphoreSubmitInfo timelineInfo{};
+    timelineInfo.sType = VK_STRUCTURE_TYPE_TIMELINE_SEMAPHORE_SUBMIT_INFO;
+    timelineInfo.waitSemaphoreValueCount = static_cast<uint32_t>(waitValues.size());
+    timelineInfo.pWaitSemaphoreValues = waitValues.data();
+    timelineInfo.signalSemaphoreValueCount = static_cast<uint32_t>(signalValues.size());
+    timelineInfo.pSignalSemaphoreValues = signalValues.data();
+
+    VkSubmitInfo submitInfo{};
+    submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+    submitInfo.pNext = &timelineInfo;
+    submitInfo.waitSemaphoreCount = static_cast<uint32_t>(waitSemaphores.size());
+    submitInfo.pWaitSemaphores = waitSemaphores.data();
+    submitInfo.pWaitDstStageMask = waitStages.data();
+    submitInfo.commandBufferCount = static_cast<uint32_t>(submission.commandBuffers.size());
+    submitInfo.pCommandBuffers = submission.commandBuffers.data();
+    submitInfo.signalSemaphoreCount = static_cast<uint32_t>(signalSemaphores.size());
+    submitInfo.pSignalSemaphores = signalSemaphores.data();
+
+    if (vkQueueSubmit(timeline.queue, 1, &submitInfo, VK_NULL_HANDLE) != VK_SUCCESS) {
+        throw std::runtime_error("Failed to submit to queue!");
+    }
+
+    timeline.lastSubmitted = signalValue;
+    return signalValue;
+}
+
+//------------------------------------------------------------------------------------------
+// Without timeline semaphores a wait on another queue is resolved on the CPU before
+// submitting. Correct but serializing, the queues no longer overlap.
+//------------------------------------------------------------------------------------------
+uint64_t TimelineSync::submit_fence(Timeline& timeline, const Submission& submission) {
+    for (const Wait& wait : submission.waits) {
+        this->wait(wait.queue, wait.value);
+    }
+
+    VkSubmitInfo submitInfo{};
+    submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+    submitInfo.waitSemaphoreCount = static_cast<uint32_t>(submission.binaryWaitSemaphores.size());
+    submitInfo.pWaitSemaphores = submission.binaryWaitSemaphores.data();
+    submitInfo.pWaitDstStageMask = submission.binaryWaitStages.data();
+    submitInfo.commandBufferCount = static_cast<uint32_t>(submission.commandBuffers.size());
+    submitInfo.pCommandBuffers = submission.commandBuffers.data();
+    submitInfo.signalSemaphoreCount = static_cast<uint32_t>(submission.binarySignalSemaphores.size());
+    submitInfo.pSignalSemaphores = submission.binarySignalSemaphores.data();
+
+    VkFence fence = grab_fence();
+    if (vkQueueSubmit(timeline.queue, 1, &submitInfo, fence) != VK_SUCCESS) {
+        mFreeFences.push_back(fence);
+        throw std::runtime_error("Failed to submit to queue!");
+    }
+
+    timeline.lastSubmitted++;
+    timeline.pendingFences.push_back({ timeline.lastSubmitted, fence });
+    return timeline.lastSubmitted;
+}
+
+//------------------------------------------------------------------------------------------
+//------------------------------------------------------------------------------------------
+VkFence TimelineSync::grab_fence() {
+    if (!mFreeFences.empty()) {
+        VkFence fence = mFreeFences.back();
+        mFreeFences.pop_back();
+        vkResetFences(mDevice, 1, &fence);
+        return fence;
+    }
+
+    VkFenceCreateInfo createInfo{};
+    createInfo.sType = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO;
+
+    VkFence fence;
+    if (vkCreateFence(mDevice, &createInfo, nullptr, &fence) != VK_SUCCESS) {
+        throw std::runtime_error("Failed to create submission fence!");
+    }
+    return fence;
+}
+
+//------------------------------------------------------------------------------------------
+// Advance the completed value past every signaled fence and recycle those fences
+//------------------------------------------------------------------------------------------
+void TimelineSync::retire_fences(Timeline& timeline) {
+    while (!timeline.pendingFences.empty()) {
+        const PendingFence& pending = timeline.pendingFences.front();
+        if (vkGetFenceStatus(mDevice, pending.fence) != VK_SUCCESS) {
+            break;
+        }
+
+        timeline.lastCompleted = pending.value;
+        mFreeFences.push_back(pending.fence);
+        timeline.pendingFences.pop_front();
+    }
+}
@@ -0,0 +1,384 @@
+//======================================================================
+// TransformHierarchy.cpp
+//
+// Keegan Kochis
+// Created: 2026/10/18
+// The definition of the TransformHierarchy class.
+//======================================================================
+
+#include "TransformHierarchy.h"
+
+#include <cstdint>
+
+#include <algorithm>
+#include <ostream>
+#include <stdexcept>
+#include <vector>
+
+#define GLM_FORCE_RADIANS
+#define GLM_FORCE_DEPTH_ZERO_TO_ONE
+#include <glm/mat3x3.hpp>
+#include <glm/mat4x4.hpp>
+#include <glm/vec3.hpp>
+#include <glm/vec4.hpp>
+#include <glm/gtc/quaternion.hpp>
+
+TransformHierarchy::TransformHierarchy() {
+}
+
+//------------------------------------------------------------------------------------------
+//------------------------------------------------------------------------------------------
+void TransformHierarchy::init(JobSystem* pJobSystem) {
+    mpJobSystem = pJobSystem;
+}
+
+//------------------------------------------------------------------------------------------
+//------------------------------------------------------------------------------------------
+void TransformHierarchy::clean_up() {
+    mNodes = ResourcePool<TransformNodeTag, uint32_t>();
+    mHandles.clear();
+    mParents.clear();
+    mFirstChildren.clear();
+    mChildCounts.clear();
+    mDepths.clear();
+    mLocalPositions.clear();
+    mLocalRotations.clear();
+    mLocalScales.clear();
+    mWorld.clear();
+    mDirtyFlags.clear();
+    mLevelStarts.clear();
+    mDirtyLevels.clear();
+    mLayoutDirty = false;
+    mFullUpdate = false;
+    mDeadCount = 0;
+}
+
+//------------------------------------------------------------------------------------------
+// Appended unsorted, the next update sorts it into its level
+//------------------------------------------------------------------------------------------
+TransformNode TransformHierarchy::create_node(TransformNode parent, const Transform& local) {
+    const uint32_t parentIndex = parent.is_null() ? INVALID_INDEX : mNodes.get<0>(parent);
+    const uint32_t index = static_cast<uint32_t>(mHandles.size());
+    const TransformNode node = mNodes.add(index);
+
+    mHandles.push_back(node);
+    mParents.push_back(parentIndex);
+    mFirstChildren.push_back(INVALID_INDEX);
+    mChildCounts.push_back(0);
+    mDepths.push_back(0);
+    mLocalPositions.push_back(local.position);
+    mLocalRotations.push_back(local.rotation);
+    mLocalScales.push_back(local.scale);
+    mWorld.push_back(glm::mat4(1.0f));
+    mDirtyFlags.push_back(0);
+
+    mLayoutDirty = true;
+    return node;
+}
+
+//------------------------------------------------------------------------------------------
+// The subtree is found through the child ranges, so an outdated layout is rebuilt first.
+// Destroyed nodes keep their place until enough of them piled up, which keeps destroying
+// many nodes in a row from re-sorting every time.
+//------------------------------------------------------------------------------------------
+void TransformHierarchy::destroy_node(TransformNode node) {
+    if (mLayoutDirty) {
+        rebuild_layout();
+    }
+
+    std::vector<uint32_t> subtree = { mNodes.get<0>(node) };
+    while (!subtree.empty()) {
+        const uint32_t index = subtree.back();
+        subtree.pop_back();
+        for (uint32_t i = 0; i < mChildCounts[index]; i++) {
+            subtree.push_back(mFirstChildren[index] + i);
+        }
+        if (!mHandles[index].is_null()) {
+            mNodes.remove(mHandles[index]);
+            mHandles[index] = TransformNode();
+            mDeadCount++;
+        }
+    }
+}
+
+//------------------------------------------------------------------------------------------
+//------------------------------------------------------------------------------------------
+void TransformHierarchy::set_parent(TransformNode node, TransformNode parent) {
+    const uint32_t index = mNodes.get<0>(node);
+    const uint32_t parentIndex = parent.is_null() ? INVALID_INDEX : mNodes.get<0>(parent);
+
+    for (uint32_t ancestor = parentIndex; ancestor != INVALID_INDEX; ancestor = mParents[ancestor]) {
+        if (ancestor == index) {
+            throw std::runtime_error("Failed to set transform parent, the node would become its own ancestor!");
+        }
+    }
+
+    mParents[index] = parentIndex;
+    mLayoutDirty = true;
+}
+
+//------------------------------------------------------------------------------------------
+//------------------------------------------------------------------------------------------
+void TransformHierarchy::set_local(TransformNode node, const Transform& local) {
+    const uint32_t index = mNodes.get<0>(node);
+    mLocalPositions[index] = local.position;
+    mLocalRotations[index] = local.rotation;
+    mLocalScales[index] = local.scale;
+
+    // A pending layout rebuild updates every node anyway
+    if (!mLayoutDirty && !mFullUpdate) {
+        mark_dirty(index);
+    }
+}
+
+//------------------------------------------------------------------------------------------
+//------------------------------------------------------------------------------------------
+TransformNode TransformHierarchy::get_parent(TransformNode node) const {
+    const uint32_t parentIndex = mParents[mNodes.get<0>(node)];
+    return parentIndex == INVALID_INDEX ? TransformNode() : mHandles[parentIndex];
+}
+
+//------------------------------------------------------------------------------------------
+//------------------------------------------------------------------------------------------
+Transform TransformHierarchy::get_local(TransformNode node) const {
+    const uint32_t index = mNodes.get<0>(node);
+    Transform local;
+    local.position = mLocalPositions[index];
+    local.rotation = mLocalRotations[index];
+    local.scale = mLocalScales[index];
+    return local;
+}
+
+//------------------------------------------------------------------------------------------
+// A level is only started once the previous one is done, the dirty nodes of a level are
+// independent of each other. Their children join the next level's dirty list, so only
+// changed subtrees are visited.
+//------------------------------------------------------------------------------------------
+void TransformHierarchy::update() {
+    mUpdatedNodes = 0;
+    mParallelLevels = 0;
+
+    if (mDeadCount > 0 && mDeadCount * 2 > static_cast<uint32_t>(mNodes.size())) {
+        mLayoutDirty = true;
+    }
+    if (mLayoutDirty) {
+        rebuild_layout();
+    }
+
+    const uint32_t levelCount = static_cast<uint32_t>(mDirtyLevels.size());
+    if (mFullUpdate) {
+        for (uint32_t level = 0; level < levelCount; level++) {
+            update_range(mLevelStarts[level], mLevelStarts[level + 1]);
+        }
+        mFullUpdate = false;
+        return;
+    }
+
+    // Once a good part of a level is dirty, walking whole levels in order beats jumping
+    // between the dirty nodes. Recomputing a clean node changes nothing.
+    bool wholeLevels = false;
+    for (uint32_t level = 0; level < levelCount; level++) {
+        std::vector<uint32_t>& dirty = mDirtyLevels[level];
+        const uint32_t levelSize = mLevelStarts[level + 1] - mLevelStarts[level];
+        if (wholeLevels || dirty.size() * WHOLE_LEVEL_FRACTION > levelSize) {
+            wholeLevels = true;
+            update_range(mLevelStarts[level], mLevelStarts[level + 1]);
+            dirty.clear();
+            continue;
+        }
+        if (dirty.empty()) {
+            continue;
+        }
+        update_nodes(dirty.data(), static_cast<uint32_t>(dirty.size()));
+
+        if (level + 1 < levelCount) {
+            for (uint32_t index : dirty) {
+                for (uint32_t i = 0; i < mChildCounts[index]; i++) {
+                    mark_dirty(mFirstChildren[index] + i);
+                }
+            }
+        }
+        dirty.clear();
+    }
+}
+
+//------------------------------------------------------------------------------------------
+//------------------------------------------------------------------------------------------
+TransformHierarchy::Stats TransformHierarchy::get_stats() const {
+    Stats stats;
+    stats.nodes = static_cast<uint32_t>(mNodes.size());
+    stats.levels = static_cast<uint32_t>(mDirtyLevels.size());
+    stats.updatedNodes = mUpdatedNodes;
+    stats.parallelLevels = mParallelLevels;
+    stats.layoutRebuilds = mLayoutRebuilds;
+    return stats;
+}
+
+//------------------------------------------------------------------------------------------
+//------------------------------------------------------------------------------------------
+void TransformHierarchy::print_stats(std::ostream& out) const {
+    const Stats stats = get_stats();
+    out << "Transform hierarchy stats:\n";
+    out << "\tNodes: " << stats.nodes << '\n';
+    out << "\tLevels: " << stats.levels << '\n';
+    out << "\tNodes updated last update: " << stats.updatedNodes << '\n';
+    out << "\tLevels split across threads: " << stats.parallelLevels << '\n';
+    out << "\tLayout rebuilds: " << stats.layoutRebuilds << '\n';
+}
+
+//------------------------------------------------------------------------------------------
+// Breadth first from the roots, keeping the previous order within a level as far as
+// possible. Drops destroyed nodes and schedules a full update.
+//------------------------------------------------------------------------------------------
+void TransformHierarchy::rebuild_layout() {
+    const uint32_t oldCount = static_cast<uint32_t>(mHandles.size());
+
+    // Children of each node in the old order, live nodes only
+    std::vector<uint32_t> childOffsets(oldCount + 1, 0);
+    for (uint32_t i = 0; i < oldCount; i++) {
+        if (!mHandles[i].is_null() && mParents[i] != INVALID_INDEX) {
+            childOffsets[mParents[i] + 1]++;
+        }
+    }
+    for (uint32_t i = 0; i < oldCount; i++) {
+        childOffsets[i + 1] += childOffsets[i];
+    }
+    std::vector<uint32_t> children(childOffsets[oldCount]);
+    std::vector<uint32_t> childCursors(childOffsets.begin(), childOffsets.end() - 1);
+    for (uint32_t i = 0; i < oldCount; i++) {
+        if (!mHandles[i].is_null() && mParents[i] != INVALID_INDEX) {
+            children[childCursors[mParents[i]]++] = i;
+        }
+    }
+
+    std::vector<uint32_t> order;
+    order.reserve(mNodes.size());
+    for (uint32_t i = 0; i < oldCount; i++) {
+        if (!mHandles[i].is_null() && mParents[i] == INVALID_INDEX) {
+            order.push_back(i);
+        }
+    }
+
+    const uint32_t newCount = static_cast<uint32_t>(mNodes.size());
+    std::vector<uint32_t> newIndices(oldCount, INVALID_INDEX);
+    std::vector<TransformNode> handles(newCount);
+    std::vector<uint32_t> parents(newCount);
+    std::vector<uint32_t> firstChildren(newCount);
+    std::vector<uint32_t> childCounts(newCount);
+    std::vector<uint32_t> depths(newCount);
+    std::vector<glm::vec3> localPositions(newCount);
+    std::vector<glm::quat> localRotations(newCount);
+    std::vector<glm::vec3> localScales(newCount);
+    std::vector<glm::mat4> world(newCount);
+    mLevelStarts.clear();
+
+    // The queue is the new order, a node's children are appended right as it is visited
+    for (uint32_t newIndex = 0; newIndex < order.size(); newIndex++) {
+        const uint32_t oldIndex = order[newIndex];
+        const uint32_t oldParent = mParents[oldIndex];
+        newIndices[oldIndex] = newIndex;
+
+        const uint32_t parent = oldParent == INVALID_INDEX ? INVALID_INDEX : newIndices[oldParent];
+        const uint32_t depth = parent == INVALID_INDEX ? 0 : depths[parent] + 1;
+        if (depth == mLevelStarts.size()) {
+            mLevelStarts.push_back(newIndex);
+        }
+
+        handles[newIndex] = mHandles[oldIndex];
+        parents[newIndex] = parent;
+        depths[newIndex] = depth;
+        firstChildren[newIndex] = static_cast<uint32_t>(order.size());
+        childCounts[newIndex] = childOffsets[oldIndex + 1] - childOffsets[oldIndex];
+        localPositions[newIndex] = mLocalPositions[oldIndex];
+        localRotations[newIndex] = mLocalRotations[oldIndex];
+        localScales[newIndex] = mLocalScales[oldIndex];
+        world[newIndex] = mWorld[oldIndex];
+        order.insert(order.end(), children.begin() + childOffsets[oldIndex], children.begin() + childOffsets[oldIndex + 1]);
+
+        mNodes.get<0>(handles[newIndex]) = newIndex;
+    }
+    mLevelStarts.push_back(newCount);
+
+    mHandles.swap(handles);
+    mParents.swap(parents);
+    mFirstChildren.swap(firstChildren);
+    mChildCounts.swap(childCounts);
+    mDepths.swap(depths);
+    mLocalPositions.swap(localPositions);
+    mLocalRotations.swap(localRotations);
+    mLocalScales.swap(localScales);
+    mWorld.swap(world);
+    mDirtyFlags.assign(newCount, 0);
+    mDirtyLevels.assign(mLevelStarts.size() - 1, std::vector<uint32_t>());
+
+    mDeadCount = 0;
+    mLayoutDirty = false;
+    mFullUpdate = true;
+    mLayoutRebuilds++;
+}
+
+//------------------------------------------------------------------------------------------
+//------------------------------------------------------------------------------------------
+void TransformHierarchy::update_nodes(const uint32_t* pIndices, uint32_t count) {
+    mUpdatedNodes += count;
+    if (!mpJobSystem || count < 2 * PARALLEL_BATCH_SIZE) {
+        for (uint32_t i = 0; i < count; i++) {
+            update_node(pIndices[i]);
+        }
+        return;
+    }
+
+    mParallelLevels++;
+    mpJobSystem->parallel_for(count, PARALLEL_BATCH_SIZE, [this, pIndices](uint32_t begin, uint32_t end) {
+        for (uint32_t i = begin; i < end; i++) {
+            update_node(pIndices[i]);
+        }
+    });
+}
+
+//------------------------------------------------------------------------------------------
+//------------------------------------------------------------------------------------------
+void TransformHierarchy::update_range(uint32_t begin, uint32_t end) {
+    const uint32_t count = end - begin;
+    mUpdatedNodes += count;
+    if (!mpJobSystem || count < 2 * PARALLEL_BATCH_SIZE) {
+        for (uint32_t i = begin; i < end; i++) {
+            update_node(i);
+        }
+        return;
+    }
+
+    mParallelLevels++;
+    mpJobSystem->parallel_for(count, PARALLEL_BATCH_SIZE, [this, begin](uint32_t first, uint32_t last) {
+        for (uint32_t i = begin + first; i < begin + last; i++) {
+            update_node(i);
+        }
+    });
+}
+
+//------------------------------------------------------------------------------------------
+// Translation * rotation * scale, with the scale folded into the rotation's columns
+//------------------------------------------------------------------------------------------
+void TransformHierarchy::update_node(uint32_t index) {
+    const glm::vec3& scale = mLocalScales[index];
+    const glm::mat3 rotation = glm::mat3_cast(mLocalRotations[index]);
+
+    glm::mat4 local;
+    local[0] = glm::vec4(rotation[0] * scale.x, 0.0f);
+    local[1] = glm::vec4(rotation[1] * scale.y, 0.0f);
+    local[2] = glm::vec4(rotation[2] * scale.z, 0.0f);
+    local[3] = glm::vec4(mLocalPositions[index], 1.0f);
+
+    const uint32_t parent = mParents[index];
+    mWorld[index] = parent == INVALID_INDEX ? local : mWorld[parent] * local;
+    mDirtyFlags[index] = 0;
+}
+
+//------------------------------------------------------------------------------------------
+//------------------------------------------------------------------------------------------
+void TransformHierarchy::mark_dirty(uint32_t index) {
+    if (mDirtyFlags[index] == 0) {
+        mDirtyFlags[index] = 1;
+        mDirtyLevels[mDepths[index]].push_back(index);
+    }
+}
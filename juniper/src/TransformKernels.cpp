@@ -0,0 +1,787 @@
+//======================================================================
+// TransformKernels.cpp
+//
+// Keegan Kochis
+// Created: 2026/10/18
+// Scalar, SSE and AVX2 versions of the batch transform and culling
+// kernels. The SIMD versions load 4 or 8 objects per lane group, work
+// on the structure of arrays data directly and transpose matrices on
+// the way in and out. Leftover objects go through the scalar version.
+//======================================================================
+
+#include "TransformKernels.h"
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+
+#include <algorithm>
+#include <limits>
+
+#define GLM_FORCE_RADIANS
+#define GLM_FORCE_DEPTH_ZERO_TO_ONE
+#include <glm/geometric.hpp>
+#include <glm/mat4x4.hpp>
+#include <glm/vec3.hpp>
+#include <glm/vec4.hpp>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__SSE2__) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define J_SIMD_X86 1
+#include <immintrin.h>
+#else
+#define J_SIMD_X86 0
+#endif
+
+// The AVX2 kernels are built regardless of the compiler flags and only picked when the CPU has them
+#if defined(__GNUC__) || defined(__clang__)
+#define J_TARGET_AVX2 __attribute__((target("avx2,fma")))
+#else
+#define J_TARGET_AVX2
+#endif
+
+void TransformSoA_t::resize(size_t count) {
+    positionX.resize(count, 0.0f);
+    positionY.resize(count, 0.0f);
+    positionZ.resize(count, 0.0f);
+    rotationX.resize(count, 0.0f);
+    rotationY.resize(count, 0.0f);
+    rotationZ.resize(count, 0.0f);
+    rotationW.resize(count, 1.0f);
+    scaleX.resize(count, 1.0f);
+    scaleY.resize(count, 1.0f);
+    scaleZ.resize(count, 1.0f);
+}
+
+void SphereSoA_t::resize(size_t count) {
+    centerX.resize(count, 0.0f);
+    centerY.resize(count, 0.0f);
+    centerZ.resize(count, 0.0f);
+    radius.resize(count, 0.0f);
+}
+
+void AabbSoA_t::resize(size_t count) {
+    centerX.resize(count, 0.0f);
+    centerY.resize(count, 0.0f);
+    centerZ.resize(count, 0.0f);
+    extentX.resize(count, 0.0f);
+    extentY.resize(count, 0.0f);
+    extentZ.resize(count, 0.0f);
+}
+
+static const glm::mat4& matrix_at(const glm::mat4* pMatrices, size_t matrixStride, size_t index) {
+    return *reinterpret_cast<const glm::mat4*>(reinterpret_cast<const char*>(pMatrices) + index * matrixStride);
+}
+
+static glm::mat4& matrix_at(glm::mat4* pMatrices, size_t matrixStride, size_t index) {
+    return *reinterpret_cast<glm::mat4*>(reinterpret_cast<char*>(pMatrices) + index * matrixStride);
+}
+
+//------------------------------------------------------------------------------------------
+// Scalar kernels, also used for the objects left over after the last full lane group
+//------------------------------------------------------------------------------------------
+static void compose_matrices_scalar(const TransformSoA& transforms, glm::mat4* pMatrices, size_t matrixStride,
+                                    size_t begin, size_t end) {
+    for (size_t i = begin; i < end; i++) {
+        float x = transforms.rotationX[i];
+        float y = transforms.rotationY[i];
+        float z = transforms.rotationZ[i];
+        float w = transforms.rotationW[i];
+        float sx = transforms.scaleX[i];
+        float sy = transforms.scaleY[i];
+        float sz = transforms.scaleZ[i];
+
+        glm::mat4& matrix = matrix_at(pMatrices, matrixStride, i);
+        matrix[0] = glm::vec4((1.0f - 2.0f * (y * y + z * z)) * sx, 2.0f * (x * y + w * z) * sx, 2.0f * (x * z - w * y) * sx, 0.0f);
+        matrix[1] = glm::vec4(2.0f * (x * y - w * z) * sy, (1.0f - 2.0f * (x * x + z * z)) * sy, 2.0f * (y * z + w * x) * sy, 0.0f);
+        matrix[2] = glm::vec4(2.0f * (x * z + w * y) * sz, 2.0f * (y * z - w * x) * sz, (1.0f - 2.0f * (x * x + y * y)) * sz, 0.0f);
+        matrix[3] = glm::vec4(transforms.positionX[i], transforms.positionY[i], transforms.positionZ[i], 1.0f);
+    }
+}
+
+static void transform_spheres_scalar(const glm::mat4* pMatrices, size_t matrixStride, const SphereSoA& local, SphereSoA& world,
+                                     size_t begin, size_t end) {
+    for (size_t i = begin; i < end; i++) {
+        const glm::mat4& matrix = matrix_at(pMatrices, matrixStride, i);
+        glm::vec4 center = matrix * glm::vec4(local.centerX[i], local.centerY[i], local.centerZ[i], 1.0f);
+        float scale = std::max(glm::dot(glm::vec3(matrix[0]), glm::vec3(matrix[0])),
+                               std::max(glm::dot(glm::vec3(matrix[1]), glm::vec3(matrix[1])),
+                                        glm::dot(glm::vec3(matrix[2]), glm::vec3(matrix[2]))));
+
+        world.centerX[i] = center.x;
+        world.centerY[i] = center.y;
+        world.centerZ[i] = center.z;
+        world.radius[i] = local.radius[i] * std::sqrt(scale);
+    }
+}
+
+static void transform_aabbs_scalar(const glm::mat4* pMatrices, size_t matrixStride, const AabbSoA& local, AabbSoA& world,
+                                   size_t begin, size_t end) {
+    for (size_t i = begin; i < end; i++) {
+        const glm::mat4& matrix = matrix_at(pMatrices, matrixStride, i);
+        glm::vec4 center = matrix * glm::vec4(local.centerX[i], local.centerY[i], local.centerZ[i], 1.0f);
+        glm::vec3 extent = glm::abs(glm::vec3(matrix[0])) * local.extentX[i] +
+                           glm::abs(glm::vec3(matrix[1])) * local.extentY[i] +
+                           glm::abs(glm::vec3(matrix[2])) * local.extentZ[i];
+
+        world.centerX[i] = center.x;
+        world.centerY[i] = center.y;
+        world.centerZ[i] = center.z;
+        world.extentX[i] = extent.x;
+        world.extentY[i] = extent.y;
+        world.extentZ[i] = extent.z;
+    }
+}
+
+static uint32_t cull_spheres_scalar(const glm::vec4 planes[6], const SphereSoA& spheres, uint8_t* pVisibility,
+                                    size_t begin, size_t end) {
+    uint32_t visibleCount = 0;
+    for (size_t i = begin; i < end; i++) {
+        glm::vec3 center(spheres.centerX[i], spheres.centerY[i], spheres.centerZ[i]);
+        bool visible = true;
+        for (uint32_t p = 0; p < 6 && visible; p++) {
+            visible = glm::dot(glm::vec3(planes[p]), center) + planes[p].w >= -spheres.radius[i];
+        }
+        pVisibility[i] = visible ? 1 : 0;
+        visibleCount += visible ? 1 : 0;
+    }
+    return visibleCount;
+}
+
+static uint32_t cull_aabbs_scalar(const glm::vec4 planes[6], const AabbSoA& boxes, uint8_t* pVisibility, size_t begin, size_t end) {
+    uint32_t visibleCount = 0;
+    for (size_t i = begin; i < end; i++) {
+        glm::vec3 center(boxes.centerX[i], boxes.centerY[i], boxes.centerZ[i]);
+        glm::vec3 extent(boxes.extentX[i], boxes.extentY[i], boxes.extentZ[i]);
+        bool visible = true;
+        for (uint32_t p = 0; p < 6 && visible; p++) {
+            // Projected half size of the box onto the plane normal
+            float radius = glm::dot(glm::abs(glm::vec3(planes[p])), extent);
+            visible = glm::dot(glm::vec3(planes[p]), center) + planes[p].w >= -radius;
+        }
+        pVisibility[i] = visible ? 1 : 0;
+        visibleCount += visible ? 1 : 0;
+    }
+    return visibleCount;
+}
+
+static void project_sphere_radii_scalar(const glm::vec4& depthPlane, float projectionScale, const SphereSoA& spheres,
+                                       float* pRadii, size_t begin, size_t end) {
+    for (size_t i = begin; i < end; i++) {
+        glm::vec3 center(spheres.centerX[i], spheres.centerY[i], spheres.centerZ[i]);
+        float nearest = glm::dot(glm::vec3(depthPlane), center) + depthPlane.w - spheres.radius[i];
+        pRadii[i] = nearest > 0.0f ? projectionScale * spheres.radius[i] / nearest : std::numeric_limits<float>::max();
+    }
+}
+
+#if J_SIMD_X86
+
+//------------------------------------------------------------------------------------------
+// SSE kernels, 4 objects at a time
+//------------------------------------------------------------------------------------------
+// Turns one column of 4 matrices into its x, y, z and w across the objects
+static inline void load_column_sse(const glm::mat4* pMatrices, size_t matrixStride, size_t first, int column,
+                                   __m128& x, __m128& y, __m128& z, __m128& w) {
+    x = _mm_loadu_ps(&matrix_at(pMatrices, matrixStride, first + 0)[column][0]);
+    y = _mm_loadu_ps(&matrix_at(pMatrices, matrixStride, first + 1)[column][0]);
+    z = _mm_loadu_ps(&matrix_at(pMatrices, matrixStride, first + 2)[column][0]);
+    w = _mm_loadu_ps(&matrix_at(pMatrices, matrixStride, first + 3)[column][0]);
+    _MM_TRANSPOSE4_PS(x, y, z, w);
+}
+
+static inline void store_column_sse(glm::mat4* pMatrices, size_t matrixStride, size_t first, int column,
+                                    __m128 x, __m128 y, __m128 z, __m128 w) {
+    _MM_TRANSPOSE4_PS(x, y, z, w);
+    _mm_storeu_ps(&matrix_at(pMatrices, matrixStride, first + 0)[column][0], x);
+    _mm_storeu_ps(&matrix_at(pMatrices, matrixStride, first + 1)[column][0], y);
+    _mm_storeu_ps(&matrix_at(pMatrices, matrixStride, first + 2)[column][0], z);
+    _mm_storeu_ps(&matrix_at(pMatrices, matrixStride, first + 3)[column][0], w);
+}
+
+static void compose_matrices_sse(const TransformSoA& transforms, glm::mat4* pMatrices, size_t matrixStride, size_t count) {
+    const __m128 one = _mm_set1_ps(1.0f);
+    const __m128 zero = _mm_setzero_ps();
+
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+        __m128 x = _mm_loadu_ps(&transforms.rotationX[i]);
+        __m128 y = _mm_loadu_ps(&transforms.rotationY[i]);
+        __m128 z = _mm_loadu_ps(&transforms.rotationZ[i]);
+        __m128 w = _mm_loadu_ps(&transforms.rotationW[i]);
+        __m128 x2 = _mm_add_ps(x, x);
+        __m128 y2 = _mm_add_ps(y, y);
+        __m128 z2 = _mm_add_ps(z, z);
+
+        __m128 xx = _mm_mul_ps(x, x2);
+        __m128 yy = _mm_mul_ps(y, y2);
+        __m128 zz = _mm_mul_ps(z, z2);
+        __m128 xy = _mm_mul_ps(x, y2);
+        __m128 xz = _mm_mul_ps(x, z2);
+        __m128 yz = _mm_mul_ps(y, z2);
+        __m128 wx = _mm_mul_ps(w, x2);
+        __m128 wy = _mm_mul_ps(w, y2);
+        __m128 wz = _mm_mul_ps(w, z2);
+
+        __m128 sx = _mm_loadu_ps(&transforms.scaleX[i]);
+        __m128 sy = _mm_loadu_ps(&transforms.scaleY[i]);
+        __m128 sz = _mm_loadu_ps(&transforms.scaleZ[i]);
+
+        store_column_sse(pMatrices, matrixStride, i, 0,
+                         _mm_mul_ps(_mm_sub_ps(one, _mm_add_ps(yy, zz)), sx),
+                         _mm_mul_ps(_mm_add_ps(xy, wz), sx),
+                         _mm_mul_ps(_mm_sub_ps(xz, wy), sx),
+                         zero);
+        store_column_sse(pMatrices, matrixStride, i, 1,
+                         _mm_mul_ps(_mm_sub_ps(xy, wz), sy),
+                         _mm_mul_ps(_mm_sub_ps(one, _mm_add_ps(xx, zz)), sy),
+                         _mm_mul_ps(_mm_add_ps(yz, wx), sy),
+                         zero);
+        store_column_sse(pMatrices, matrixStride, i, 2,
+                         _mm_mul_ps(_mm_add_ps(xz, wy), sz),
+                         _mm_mul_ps(_mm_sub_ps(yz, wx), sz),
+                         _mm_mul_ps(_mm_sub_ps(one, _mm_add_ps(xx, yy)), sz),
+                         zero);
+        store_column_sse(pMatrices, matrixStride, i, 3,
+                         _mm_loadu_ps(&transforms.positionX[i]),
+                         _mm_loadu_ps(&transforms.positionY[i]),
+                         _mm_loadu_ps(&transforms.positionZ[i]),
+                         one);
+    }
+    compose_matrices_scalar(transforms, pMatrices, matrixStride, i, count);
+}
+
+static void transform_spheres_sse(const glm::mat4* pMatrices, size_t matrixStride, const SphereSoA& local, SphereSoA& world,
+                                  size_t count) {
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+        __m128 m0x, m0y, m0z, m0w, m1x, m1y, m1z, m1w, m2x, m2y, m2z, m2w, m3x, m3y, m3z, m3w;
+        load_column_sse(pMatrices, matrixStride, i, 0, m0x, m0y, m0z, m0w);
+        load_column_sse(pMatrices, matrixStride, i, 1, m1x, m1y, m1z, m1w);
+        load_column_sse(pMatrices, matrixStride, i, 2, m2x, m2y, m2z, m2w);
+        load_column_sse(pMatrices, matrixStride, i, 3, m3x, m3y, m3z, m3w);
+
+        __m128 cx = _mm_loadu_ps(&local.centerX[i]);
+        __m128 cy = _mm_loadu_ps(&local.centerY[i]);
+        __m128 cz = _mm_loadu_ps(&local.centerZ[i]);
+
+        __m128 x = _mm_add_ps(_mm_add_ps(_mm_mul_ps(m0x, cx), _mm_mul_ps(m1x, cy)), _mm_add_ps(_mm_mul_ps(m2x, cz), m3x));
+        __m128 y = _mm_add_ps(_mm_add_ps(_mm_mul_ps(m0y, cx), _mm_mul_ps(m1y, cy)), _mm_add_ps(_mm_mul_ps(m2y, cz), m3y));
+        __m128 z = _mm_add_ps(_mm_add_ps(_mm_mul_ps(m0z, cx), _mm_mul_ps(m1z, cy)), _mm_add_ps(_mm_mul_ps(m2z, cz), m3z));
+
+        __m128 scale0 = _mm_add_ps(_mm_add_ps(_mm_mul_ps(m0x, m0x), _mm_mul_ps(m0y, m0y)), _mm_mul_ps(m0z, m0z));
+        __m128 scale1 = _mm_add_ps(_mm_add_ps(_mm_mul_ps(m1x, m1x), _mm_mul_ps(m1y, m1y)), _mm_mul_ps(m1z, m1z));
+        __m128 scale2 = _mm_add_ps(_mm_add_ps(_mm_mul_ps(m2x, m2x), _mm_mul_ps(m2y, m2y)), _mm_mul_ps(m2z, m2z));
+        __m128 scale = _mm_sqrt_ps(_mm_max_ps(scale0, _mm_max_ps(scale1, scale2)));
+
+        _mm_storeu_ps(&world.centerX[i], x);
+        _mm_storeu_ps(&world.centerY[i], y);
+        _mm_storeu_ps(&world.centerZ[i], z);
+        _mm_storeu_ps(&world.radius[i], _mm_mul_ps(_mm_loadu_ps(&local.radius[i]), scale));
+    }
+    transform_spheres_scalar(pMatrices, matrixStride, local, world, i, count);
+}
+
+static void transform_aabbs_sse(const glm::mat4* pMatrices, size_t matrixStride, const AabbSoA& local, AabbSoA& world,
+                                size_t count) {
+    const __m128 signMask = _mm_set1_ps(-0.0f);
+
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+        __m128 m0x, m0y, m0z, m0w, m1x, m1y, m1z, m1w, m2x, m2y, m2z, m2w, m3x, m3y, m3z, m3w;
+        load_column_sse(pMatrices, matrixStride, i, 0, m0x, m0y, m0z, m0w);
+        load_column_sse(pMatrices, matrixStride, i, 1, m1x, m1y, m1z, m1w);
+        load_column_sse(pMatrices, matrixStride, i, 2, m2x, m2y, m2z, m2w);
+        load_column_sse(pMatrices, matrixStride, i, 3, m3x, m3y, m3z, m3w);
+
+        __m128 cx = _mm_loadu_ps(&local.centerX[i]);
+        __m128 cy = _mm_loadu_ps(&local.centerY[i]);
+        __m128 cz = _mm_loadu_ps(&local.centerZ[i]);
+        __m128 ex = _mm_loadu_ps(&local.extentX[i]);
+        __m128 ey = _mm_loadu_ps(&local.extentY[i]);
+        __m128 ez = _mm_loadu_ps(&local.extentZ[i]);
+
+        _mm_storeu_ps(&world.centerX[i], _mm_add_ps(_mm_add_ps(_mm_mul_ps(m0x, cx), _mm_mul_ps(m1x, cy)), _mm_add_ps(_mm_mul_ps(m2x, cz), m3x)));
+        _mm_storeu_ps(&world.centerY[i], _mm_add_ps(_mm_add_ps(_mm_mul_ps(m0y, cx), _mm_mul_ps(m1y, cy)), _mm_add_ps(_mm_mul_ps(m2y, cz), m3y)));
+        _mm_storeu_ps(&world.centerZ[i], _mm_add_ps(_mm_add_ps(_mm_mul_ps(m0z, cx), _mm_mul_ps(m1z, cy)), _mm_add_ps(_mm_mul_ps(m2z, cz), m3z)));
+
+        _mm_storeu_ps(&world.extentX[i], _mm_add_ps(_mm_add_ps(_mm_mul_ps(_mm_andnot_ps(signMask, m0x), ex),
+                                                               _mm_mul_ps(_mm_andnot_ps(signMask, m1x), ey)),
+                                                    _mm_mul_ps(_mm_andnot_ps(signMask, m2x), ez)));
+        _mm_storeu_ps(&world.extentY[i], _mm_add_ps(_mm_add_ps(_mm_mul_ps(_mm_andnot_ps(signMask, m0y), ex),
+                                                               _mm_mul_ps(_mm_andnot_ps(signMask, m1y), ey)),
+                                                    _mm_mul_ps(_mm_andnot_ps(signMask, m2y), ez)));
+        _mm_storeu_ps(&world.extentZ[i], _mm_add_ps(_mm_add_ps(_mm_mul_ps(_mm_andnot_ps(signMask, m0z), ex),
+                                                               _mm_mul_ps(_mm_andnot_ps(signMask, m1z), ey)),
+                                                    _mm_mul_ps(_mm_andnot_ps(signMask, m2z), ez)));
+    }
+    transform_aabbs_scalar(pMatrices, matrixStride, local, world, i, count);
+}
+
+static uint32_t write_visibility(uint8_t* pVisibility, int mask, int width) {
+    uint32_t visibleCount = 0;
+    for (int lane = 0; lane < width; lane++) {
+        uint8_t visible = static_cast<uint8_t>((mask >> lane) & 1);
+        pVisibility[lane] = visible;
+        visibleCount += visible;
+    }
+    return visibleCount;
+}
+
+static uint32_t cull_spheres_sse(const glm::vec4 planes[6], const SphereSoA& spheres, uint8_t* pVisibility, size_t count) {
+    const __m128 signMask = _mm_set1_ps(-0.0f);
+
+    uint32_t visibleCount = 0;
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+        __m128 cx = _mm_loadu_ps(&spheres.centerX[i]);
+        __m128 cy = _mm_loadu_ps(&spheres.centerY[i]);
+        __m128 cz = _mm_loadu_ps(&spheres.centerZ[i]);
+        __m128 negativeRadius = _mm_xor_ps(_mm_loadu_ps(&spheres.radius[i]), signMask);
+
+        __m128 inside = _mm_castsi128_ps(_mm_set1_epi32(-1));
+        for (uint32_t p = 0; p < 6; p++) {
+            __m128 distance = _mm_add_ps(_mm_add_ps(_mm_mul_ps(_mm_set1_ps(planes[p].x), cx), _mm_mul_ps(_mm_set1_ps(planes[p].y), cy)),
+                                         _mm_add_ps(_mm_mul_ps(_mm_set1_ps(planes[p].z), cz), _mm_set1_ps(planes[p].w)));
+            inside = _mm_and_ps(inside, _mm_cmpge_ps(distance, negativeRadius));
+        }
+        visibleCount += write_visibility(pVisibility + i, _mm_movemask_ps(inside), 4);
+    }
+    return visibleCount + cull_spheres_scalar(planes, spheres, pVisibility, i, count);
+}
+
+static uint32_t cull_aabbs_sse(const glm::vec4 planes[6], const AabbSoA& boxes, uint8_t* pVisibility, size_t count) {
+    const __m128 signMask = _mm_set1_ps(-0.0f);
+
+    uint32_t visibleCount = 0;
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+        __m128 cx = _mm_loadu_ps(&boxes.centerX[i]);
+        __m128 cy = _mm_loadu_ps(&boxes.centerY[i]);
+        __m128 cz = _mm_loadu_ps(&boxes.centerZ[i]);
+        __m128 ex = _mm_loadu_ps(&boxes.extentX[i]);
+        __m128 ey = _mm_loadu_ps(&boxes.extentY[i]);
+        __m128 ez = _mm_loadu_ps(&boxes.extentZ[i]);
+
+        __m128 inside = _mm_castsi128_ps(_mm_set1_epi32(-1));
+        for (uint32_t p = 0; p < 6; p++) {
+            __m128 distance = _mm_add_ps(_mm_add_ps(_mm_mul_ps(_mm_set1_ps(planes[p].x), cx), _mm_mul_ps(_mm_set1_ps(planes[p].y), cy)),
+                                         _mm_add_ps(_mm_mul_ps(_mm_set1_ps(planes[p].z), cz), _mm_set1_ps(planes[p].w)));
+            __m128 radius = _mm_add_ps(_mm_add_ps(_mm_mul_ps(_mm_set1_ps(std::fabs(planes[p].x)), ex),
+                                                  _mm_mul_ps(_mm_set1_ps(std::fabs(planes[p].y)), ey)),
+                                       _mm_mul_ps(_mm_set1_ps(std::fabs(planes[p].z)), ez));
+            inside = _mm_and_ps(inside, _mm_cmpge_ps(distance, _mm_xor_ps(radius, signMask)));
+        }
+        visibleCount += write_visibility(pVisibility + i, _mm_movemask_ps(inside), 4);
+    }
+    return visibleCount + cull_aabbs_scalar(planes, boxes, pVisibility, i, count);
+}
+
+static void project_sphere_radii_sse(const glm::vec4& depthPlane, float projectionScale, const SphereSoA& spheres, float* pRadii,
+                                     size_t count) {
+    const __m128 scale = _mm_set1_ps(projectionScale);
+    const __m128 maximum = _mm_set1_ps(std::numeric_limits<float>::max());
+
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+        __m128 radius = _mm_loadu_ps(&spheres.radius[i]);
+        __m128 depth = _mm_add_ps(_mm_add_ps(_mm_mul_ps(_mm_set1_ps(depthPlane.x), _mm_loadu_ps(&spheres.centerX[i])),
+                                             _mm_mul_ps(_mm_set1_ps(depthPlane.y), _mm_loadu_ps(&spheres.centerY[i]))),
+                                  _mm_add_ps(_mm_mul_ps(_mm_set1_ps(depthPlane.z), _mm_loadu_ps(&spheres.centerZ[i])),
+                                             _mm_set1_ps(depthPlane.w)));
+        __m128 nearest = _mm_sub_ps(depth, radius);
+        // Lanes at or behind the camera plane divide by zero or less and are replaced
+        __m128 inFront = _mm_cmpgt_ps(nearest, _mm_setzero_ps());
+        __m128 projected = _mm_div_ps(_mm_mul_ps(scale, radius), nearest);
+        _mm_storeu_ps(&pRadii[i], _mm_or_ps(_mm_and_ps(inFront, projected), _mm_andnot_ps(inFront, maximum)));
+    }
+    project_sphere_radii_scalar(depthPlane, projectionScale, spheres, pRadii, i, count);
+}
+
+//------------------------------------------------------------------------------------------
+// AVX2 kernels, 8 objects at a time. Lane group k of a register holds objects k * 4 to
+// k * 4 + 3, so the 4x4 transposes run within each 128 bit half.
+//------------------------------------------------------------------------------------------
+J_TARGET_AVX2 static inline void transpose_avx2(__m256& r0, __m256& r1, __m256& r2, __m256& r3) {
+    __m256 t0 = _mm256_unpacklo_ps(r0, r1);
+    __m256 t1 = _mm256_unpackhi_ps(r0, r1);
+    __m256 t2 = _mm256_unpacklo_ps(r2, r3);
+    __m256 t3 = _mm256_unpackhi_ps(r2, r3);
+    r0 = _mm256_shuffle_ps(t0, t2, _MM_SHUFFLE(1, 0, 1, 0));
+    r1 = _mm256_shuffle_ps(t0, t2, _MM_SHUFFLE(3, 2, 3, 2));
+    r2 = _mm256_shuffle_ps(t1, t3, _MM_SHUFFLE(1, 0, 1, 0));
+    r3 = _mm256_shuffle_ps(t1, t3, _MM_SHUFFLE(3, 2, 3, 2));
+}
+
+J_TARGET_AVX2 static inline __m256 load_pair_avx2(const glm::mat4* pMatrices, size_t matrixStride, size_t first, int column) {
+    __m128 low = _mm_loadu_ps(&matrix_at(pMatrices, matrixStride, first)[column][0]);
+    __m128 high = _mm_loadu_ps(&matrix_at(pMatrices, matrixStride, first + 4)[column][0]);
+    return _mm256_insertf128_ps(_mm256_castps128_ps256(low), high, 1);
+}
+
+J_TARGET_AVX2 static inline void store_pair_avx2(glm::mat4* pMatrices, size_t matrixStride, size_t first, int column, __m256 value) {
+    _mm_storeu_ps(&matrix_at(pMatrices, matrixStride, first)[column][0], _mm256_castps256_ps128(value));
+    _mm_storeu_ps(&matrix_at(pMatrices, matrixStride, first + 4)[column][0], _mm256_extractf128_ps(value, 1));
+}
+
+J_TARGET_AVX2 static inline void load_column_avx2(const glm::mat4* pMatrices, size_t matrixStride, size_t first, int column,
+                                                  __m256& x, __m256& y, __m256& z, __m256& w) {
+    x = load_pair_avx2(pMatrices, matrixStride, first + 0, column);
+    y = load_pair_avx2(pMatrices, matrixStride, first + 1, column);
+    z = load_pair_avx2(pMatrices, matrixStride, first + 2, column);
+    w = load_pair_avx2(pMatrices, matrixStride, first + 3, column);
+    transpose_avx2(x, y, z, w);
+}
+
+J_TARGET_AVX2 static inline void store_column_avx2(glm::mat4* pMatrices, size_t matrixStride, size_t first, int column,
+                                                   __m256 x, __m256 y, __m256 z, __m256 w) {
+    transpose_avx2(x, y, z, w);
+    store_pair_avx2(pMatrices, matrixStride, first + 0, column, x);
+    store_pair_avx2(pMatrices, matrixStride, first + 1, column, y);
+    store_pair_avx2(pMatrices, matrixStride, first + 2, column, z);
+    store_pair_avx2(pMatrices, matrixStride, first + 3, column, w);
+}
+
+J_TARGET_AVX2 static void compose_matrices_avx2(const TransformSoA& transforms, glm::mat4* pMatrices, size_t matrixStride,
+                                                size_t count) {
+    const __m256 one = _mm256_set1_ps(1.0f);
+    const __m256 zero = _mm256_setzero_ps();
+
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+        __m256 x = _mm256_loadu_ps(&transforms.rotationX[i]);
+        __m256 y = _mm256_loadu_ps(&transforms.rotationY[i]);
+        __m256 z = _mm256_loadu_ps(&transforms.rotationZ[i]);
+        __m256 w = _mm256_loadu_ps(&transforms.rotationW[i]);
+        __m256 x2 = _mm256_add_ps(x, x);
+        __m256 y2 = _mm256_add_ps(y, y);
+        __m256 z2 = _mm256_add_ps(z, z);
+
+        __m256 xx = _mm256_mul_ps(x, x2);
+        __m256 yy = _mm256_mul_ps(y, y2);
+        __m256 zz = _mm256_mul_ps(z, z2);
+        __m256 xy = _mm256_mul_ps(x, y2);
+        __m256 xz = _mm256_mul_ps(x, z2);
+        __m256 yz = _mm256_mul_ps(y, z2);
+        __m256 wx = _mm256_mul_ps(w, x2);
+        __m256 wy = _mm256_mul_ps(w, y2);
+        __m256 wz = _mm256_mul_ps(w, z2);
+
+        __m256 sx = _mm256_loadu_ps(&transforms.scaleX[i]);
+        __m256 sy = _mm256_loadu_ps(&transforms.scaleY[i]);
+        __m256 sz = _mm256_loadu_ps(&transforms.scaleZ[i]);
+
+        store_column_avx2(pMatrices, matrixStride, i, 0,
+                          _mm256_mul_ps(_mm256_sub_ps(one, _mm256_add_ps(yy, zz)), sx),
+                          _mm256_mul_ps(_mm256_add_ps(xy, wz), sx),
+                          _mm256_mul_ps(_mm256_sub_ps(xz, wy), sx),
+                          zero);
+        store_column_avx2(pMatrices, matrixStride, i, 1,
+                          _mm256_mul_ps(_mm256_sub_ps(xy, wz), sy),
+                          _mm256_mul_ps(_mm256_sub_ps(one, _mm256_add_ps(xx, zz)), sy),
+                          _mm256_mul_ps(_mm256_add_ps(yz, wx), sy),
+                          zero);
+        store_column_avx2(pMatrices, matrixStride, i, 2,
+                          _mm256_mul_ps(_mm256_add_ps(xz, wy), sz),
+                          _mm256_mul_ps(_mm256_sub_ps(yz, wx), sz),
+                          _mm256_mul_ps(_mm256_sub_ps(one, _mm256_add_ps(xx, yy)), sz),
+                          zero);
+        store_column_avx2(pMatrices, matrixStride, i, 3,
+                          _mm256_loadu_ps(&transforms.positionX[i]),
+                          _mm256_loadu_ps(&transforms.positionY[i]),
+                          _mm256_loadu_ps(&transforms.positionZ[i]),
+                          one);
+    }
+    compose_matrices_scalar(transforms, pMatrices, matrixStride, i, count);
+}
+
+J_TARGET_AVX2 static void transform_spheres_avx2(const glm::mat4* pMatrices, size_t matrixStride, const SphereSoA& local,
+                                                 SphereSoA& world, size_t count) {
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+        __m256 m0x, m0y, m0z, m0w, m1x, m1y, m1z, m1w, m2x, m2y, m2z, m2w, m3x, m3y, m3z, m3w;
+        load_column_avx2(pMatrices, matrixStride, i, 0, m0x, m0y, m0z, m0w);
+        load_column_avx2(pMatrices, matrixStride, i, 1, m1x, m1y, m1z, m1w);
+        load_column_avx2(pMatrices, matrixStride, i, 2, m2x, m2y, m2z, m2w);
+        load_column_avx2(pMatrices, matrixStride, i, 3, m3x, m3y, m3z, m3w);
+
+        __m256 cx = _mm256_loadu_ps(&local.centerX[i]);
+        __m256 cy = _mm256_loadu_ps(&local.centerY[i]);
+        __m256 cz = _mm256_loadu_ps(&local.centerZ[i]);
+
+        __m256 x = _mm256_fmadd_ps(m0x, cx, _mm256_fmadd_ps(m1x, cy, _mm256_fmadd_ps(m2x, cz, m3x)));
+        __m256 y = _mm256_fmadd_ps(m0y, cx, _mm256_fmadd_ps(m1y, cy, _mm256_fmadd_ps(m2y, cz, m3y)));
+        __m256 z = _mm256_fmadd_ps(m0z, cx, _mm256_fmadd_ps(m1z, cy, _mm256_fmadd_ps(m2z, cz, m3z)));
+
+        __m256 scale0 = _mm256_fmadd_ps(m0x, m0x, _mm256_fmadd_ps(m0y, m0y, _mm256_mul_ps(m0z, m0z)));
+        __m256 scale1 = _mm256_fmadd_ps(m1x, m1x, _mm256_fmadd_ps(m1y, m1y, _mm256_mul_ps(m1z, m1z)));
+        __m256 scale2 = _mm256_fmadd_ps(m2x, m2x, _mm256_fmadd_ps(m2y, m2y, _mm256_mul_ps(m2z, m2z)));
+        __m256 scale = _mm256_sqrt_ps(_mm256_max_ps(scale0, _mm256_max_ps(scale1, scale2)));
+
+        _mm256_storeu_ps(&world.centerX[i], x);
+        _mm256_storeu_ps(&world.centerY[i], y);
+        _mm256_storeu_ps(&world.centerZ[i], z);
+        _mm256_storeu_ps(&world.radius[i], _mm256_mul_ps(_mm256_loadu_ps(&local.radius[i]), scale));
+    }
+    transform_spheres_scalar(pMatrices, matrixStride, local, world, i, count);
+}
+
+J_TARGET_AVX2 static void transform_aabbs_avx2(const glm::mat4* pMatrices, size_t matrixStride, const AabbSoA& local,
+                                               AabbSoA& world, size_t count) {
+    const __m256 signMask = _mm256_set1_ps(-0.0f);
+
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+        __m256 m0x, m0y, m0z, m0w, m1x, m1y, m1z, m1w, m2x, m2y, m2z, m2w, m3x, m3y, m3z, m3w;
+        load_column_avx2(pMatrices, matrixStride, i, 0, m0x, m0y, m0z, m0w);
+        load_column_avx2(pMatrices, matrixStride, i, 1, m1x, m1y, m1z, m1w);
+        load_column_avx2(pMatrices, matrixStride, i, 2, m2x, m2y, m2z, m2w);
+        load_column_avx2(pMatrices, matrixStride, i, 3, m3x, m3y, m3z, m3w);
+
+        __m256 cx = _mm256_loadu_ps(&local.centerX[i]);
+        __m256 cy = _mm256_loadu_ps(&local.centerY[i]);
+        __m256 cz = _mm256_loadu_ps(&local.centerZ[i]);
+        __m256 ex = _mm256_loadu_ps(&local.extentX[i]);
+        __m256 ey = _mm256_loadu_ps(&local.extentY[i]);
+        __m256 ez = _mm256_loadu_ps(&local.extentZ[i]);
+
+        _mm256_storeu_ps(&world.centerX[i], _mm256_fmadd_ps(m0x, cx, _mm256_fmadd_ps(m1x, cy, _mm256_fmadd_ps(m2x, cz, m3x))));
+        _mm256_storeu_ps(&world.centerY[i], _mm256_fmadd_ps(m0y, cx, _mm256_fmadd_ps(m1y, cy, _mm256_fmadd_ps(m2y, cz, m3y))));
+        _mm256_storeu_ps(&world.centerZ[i], _mm256_fmadd_ps(m0z, cx, _mm256_fmadd_ps(m1z, cy, _mm256_fmadd_ps(m2z, cz, m3z))));
+
+        _mm256_storeu_ps(&world.extentX[i], _mm256_fmadd_ps(_mm256_andnot_ps(signMask, m0x), ex,
+                                                            _mm256_fmadd_ps(_mm256_andnot_ps(signMask, m1x), ey,
+                                                                            _mm256_mul_ps(_mm256_andnot_ps(signMask, m2x), ez))));
+        _mm256_storeu_ps(&world.extentY[i], _mm256_fmadd_ps(_mm256_andnot_ps(signMask, m0y), ex,
+                                                            _mm256_fmadd_ps(_mm256_andnot_ps(signMask, m1y), ey,
+                                                                            _mm256_mul_ps(_mm256_andnot_ps(signMask, m2y), ez))));
+        _mm256_storeu_ps(&world.extentZ[i], _mm256_fmadd_ps(_mm256_andnot_ps(signMask, m0z), ex,
+                                                            _mm256_fmadd_ps(_mm256_andnot_ps(signMask, m1z), ey,
+                                                                            _mm256_mul_ps(_mm256_andnot_ps(signMask, m2z), ez))));
+    }
+    transform_aabbs_scalar(pMatrices, matrixStride, local, world, i, count);
+}
+
+J_TARGET_AVX2 static uint32_t cull_spheres_avx2(const glm::vec4 planes[6], const SphereSoA& spheres, uint8_t* pVisibility,
+                                                size_t count) {
+    const __m256 signMask = _mm256_set1_ps(-0.0f);
+
+    uint32_t visibleCount = 0;
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+        __m256 cx = _mm256_loadu_ps(&spheres.centerX[i]);
+        __m256 cy = _mm256_loadu_ps(&spheres.centerY[i]);
+        __m256 cz = _mm256_loadu_ps(&spheres.centerZ[i]);
+        __m256 negativeRadius = _mm256_xor_ps(_mm256_loadu_ps(&spheres.radius[i]), signMask);
+
+        __m256 inside = _mm256_castsi256_ps(_mm256_set1_epi32(-1));
+        for (uint32_t p = 0; p < 6; p++) {
+            __m256 distance = _mm256_fmadd_ps(_mm256_set1_ps(planes[p].x), cx,
+                                              _mm256_fmadd_ps(_mm256_set1_ps(planes[p].y), cy,
+                                                              _mm256_fmadd_ps(_mm256_set1_ps(planes[p].z), cz, _mm256_set1_ps(planes[p].w))));
+            inside = _mm256_and_ps(inside, _mm256_cmp_ps(distance, negativeRadius, _CMP_GE_OQ));
+        }
+        visibleCount += write_visibility(pVisibility + i, _mm256_movemask_ps(inside), 8);
+    }
+    return visibleCount + cull_spheres_scalar(planes, spheres, pVisibility, i, count);
+}
+
+J_TARGET_AVX2 static uint32_t cull_aabbs_avx2(const glm::vec4 planes[6], const AabbSoA& boxes, uint8_t* pVisibility, size_t count) {
+    const __m256 signMask = _mm256_set1_ps(-0.0f);
+
+    uint32_t visibleCount = 0;
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+        __m256 cx = _mm256_loadu_ps(&boxes.centerX[i]);
+        __m256 cy = _mm256_loadu_ps(&boxes.centerY[i]);
+        __m256 cz = _mm256_loadu_ps(&boxes.centerZ[i]);
+        __m256 ex = _mm256_loadu_ps(&boxes.extentX[i]);
+        __m256 ey = _mm256_loadu_ps(&boxes.extentY[i]);
+        __m256 ez = _mm256_loadu_ps(&boxes.extentZ[i]);
+
+        __m256 inside = _mm256_castsi256_ps(_mm256_set1_epi32(-1));
+        for (uint32_t p = 0; p < 6; p++) {
+            __m256 distance = _mm256_fmadd_ps(_mm256_set1_ps(planes[p].x), cx,
+                                              _mm256_fmadd_ps(_mm256_set1_ps(planes[p].y), cy,
+                                                              _mm256_fmadd_ps(_mm256_set1_ps(planes[p].z), cz, _mm256_set1_ps(planes[p].w))));
+            __m256 radius = _mm256_fmadd_ps(_mm256_set1_ps(std::fabs(planes[p].x)), ex,
+                                            _mm256_fmadd_ps(_mm256_set1_ps(std::fabs(planes[p].y)), ey,
+                                                            _mm256_mul_ps(_mm256_set1_ps(std::fabs(planes[p].z)), ez)));
+            inside = _mm256_and_ps(inside, _mm256_cmp_ps(distance, _mm256_xor_ps(radius, signMask), _CMP_GE_OQ));
+        }
+        visibleCount += write_visibility(pVisibility + i, _mm256_movemask_ps(inside), 8);
+    }
+    return visibleCount + cull_aabbs_scalar(planes, boxes, pVisibility, i, count);
+}
+
+J_TARGET_AVX2 static void project_sphere_radii_avx2(const glm::vec4& depthPlane, float projectionScale, const SphereSoA& spheres,
+                                                   float* pRadii, size_t count) {
+    const __m256 scale = _mm256_set1_ps(projectionScale);
+    const __m256 maximum = _mm256_set1_ps(std::numeric_limits<float>::max());
+
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+        __m256 radius = _mm256_loadu_ps(&spheres.radius[i]);
+        __m256 depth = _mm256_fmadd_ps(_mm256_set1_ps(depthPlane.x), _mm256_loadu_ps(&spheres.centerX[i]),
+                                       _mm256_fmadd_ps(_mm256_set1_ps(depthPlane.y), _mm256_loadu_ps(&spheres.centerY[i]),
+                                                       _mm256_fmadd_ps(_mm256_set1_ps(depthPlane.z), _mm256_loadu_ps(&spheres.centerZ[i]),
+                                                                       _mm256_set1_ps(depthPlane.w))));
+        __m256 nearest = _mm256_sub_ps(depth, radius);
+        __m256 inFront = _mm256_cmp_ps(nearest, _mm256_setzero_ps(), _CMP_GT_OQ);
+        __m256 projected = _mm256_div_ps(_mm256_mul_ps(scale, radius), nearest);
+        _mm256_storeu_ps(&pRadii[i], _mm256_blendv_ps(maximum, projected, inFront));
+    }
+    project_sphere_radii_scalar(depthPlane, projectionScale, spheres, pRadii, i, count);
+}
+
+#endif // J_SIMD_X86
+
+//------------------------------------------------------------------------------------------
+// Checked once, the AVX2 kernels need both AVX2 and FMA
+//------------------------------------------------------------------------------------------
+static SimdLevel detect_simd_level() {
+#if J_SIMD_X86
+#if defined(__GNUC__) || defined(__clang__)
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma")) {
+        return SIMD_LEVEL_AVX2;
+    }
+#elif defined(__AVX2__)
+    return SIMD_LEVEL_AVX2;
+#endif
+    return SIMD_LEVEL_SSE;
+#else
+    return SIMD_LEVEL_SCALAR;
+#endif
+}
+
+SimdLevel get_simd_level() {
+    static const SimdLevel level = detect_simd_level();
+    return level;
+}
+
+const char* simd_level_name(SimdLevel level) {
+    switch (level) {
+        case SIMD_LEVEL_AVX2:
+            return "AVX2";
+        case SIMD_LEVEL_SSE:
+            return "SSE";
+        default:
+            return "Scalar";
+    }
+}
+
+static SimdLevel clamp_level(SimdLevel level) {
+    return level > get_simd_level() ? get_simd_level() : level;
+}
+
+//------------------------------------------------------------------------------------------
+//------------------------------------------------------------------------------------------
+void compose_matrices(SimdLevel level, const TransformSoA& transforms, glm::mat4* pMatrices, size_t matrixStride) {
+    size_t count = transforms.size();
+    switch (clamp_level(level)) {
+#if J_SIMD_X86
+        case SIMD_LEVEL_AVX2:
+            compose_matrices_avx2(transforms, pMatrices, matrixStride, count);
+            break;
+        case SIMD_LEVEL_SSE:
+            compose_matrices_sse(transforms, pMatrices, matrixStride, count);
+            break;
+#endif
+        default:
+            compose_matrices_scalar(transforms, pMatrices, matrixStride, 0, count);
+            break;
+    }
+}
+
+//------------------------------------------------------------------------------------------
+//------------------------------------------------------------------------------------------
+void transform_spheres(SimdLevel level, const glm::mat4* pMatrices, size_t matrixStride,
+                       const SphereSoA& local, SphereSoA& world) {
+    size_t count = local.size();
+    world.resize(count);
+    switch (clamp_level(level)) {
+#if J_SIMD_X86
+        case SIMD_LEVEL_AVX2:
+            transform_spheres_avx2(pMatrices, matrixStride, local, world, count);
+            break;
+        case SIMD_LEVEL_SSE:
+            transform_spheres_sse(pMatrices, matrixStride, local, world, count);
+            break;
+#endif
+        default:
+            transform_spheres_scalar(pMatrices, matrixStride, local, world, 0, count);
+            break;
+    }
+}
+
+//------------------------------------------------------------------------------------------
+//------------------------------------------------------------------------------------------
+void transform_aabbs(SimdLevel level, const glm::mat4* pMatrices, size_t matrixStride,
+                     const AabbSoA& local, AabbSoA& world) {
+    size_t count = local.size();
+    world.resize(count);
+    switch (clamp_level(level)) {
+#if J_SIMD_X86
+        case SIMD_LEVEL_AVX2:
+            transform_aabbs_avx2(pMatrices, matrixStride, local, world, count);
+            break;
+        case SIMD_LEVEL_SSE:
+            transform_aabbs_sse(pMatrices, matrixStride, local, world, count);
+            break;
+#endif
+        default:
+            transform_aabbs_scalar(pMatrices, matrixStride, local, world, 0, count);
+            break;
+    }
+}
+
+//------------------------------------------------------------------------------------------
+//------------------------------------------------------------------------------------------
+uint32_t cull_spheres(SimdLevel level, const glm::vec4 planes[6], const SphereSoA& spheres, uint8_t* pVisibility) {
+    size_t count = spheres.size();
+    switch (clamp_level(level)) {
+#if J_SIMD_X86
+        case SIMD_LEVEL_AVX2:
+            return cull_spheres_avx2(planes, spheres, pVisibility, count);
+        case SIMD_LEVEL_SSE:
+            return cull_spheres_sse(planes, spheres, pVisibility, count);
+#endif
+        default:
+            return cull_spheres_scalar(planes, spheres, pVisibility, 0, count);
+    }
+}
+
+//------------------------------------------------------------------------------------------
+//------------------------------------------------------------------------------------------
+uint32_t cull_aabbs(SimdLevel level, const glm::vec4 planes[6], const AabbSoA& boxes, uint8_t* pVisibility) {
+    size_t count = boxes.size();
+    switch (clamp_level(level)) {
+#if J_SIMD_X86
+        case SIMD_LEVEL_AVX2:
+            return cull_aabbs_avx2(planes, boxes, pVisibility, count);
+        case SIMD_LEVEL_SSE:
+            return cull_aabbs_sse(planes, boxes, pVisibility, count);
+#endif
+        default:
+            return cull_aabbs_scalar(planes, boxes, pVisibility, 0, count);
+    }
+}
+
+//------------------------------------------------------------------------------------------
+//------------------------------------------------------------------------------------------
+void project_sphere_radii(SimdLevel level, const glm::vec4& depthPlane, float projectionScale, const SphereSoA& spheres,
+                          float* pRadii) {
+    size_t count = spheres.size();
+    switch (clamp_level(level)) {
+#if J_SIMD_X86
+        case SIMD_LEVEL_AVX2:
+            project_sphere_radii_avx2(depthPlane, projectionScale, spheres, pRadii, count);
+            break;
+        case SIMD_LEVEL_SSE:
+            project_sphere_radii_sse(depthPlane, projectionScale, spheres, pRadii, count);
+            break;
+#endif
+        default:
+            project_sphere_radii_scalar(depthPlane, projectionScale, spheres, pRadii, 0, count);
+            break;
+    }
+}
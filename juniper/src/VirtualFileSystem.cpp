@@ -0,0 +1,206 @@
+//======================================================================
+// VirtualFileSystem.cpp
+//
+// Keegan Kochis
+// Created: 2026/10/19
+// The definition of the VirtualFileSystem class.
+//======================================================================
+
+#include "VirtualFileSystem.h"
+
+#include <cstdint>
+#include <cstring>
+
+#include <atomic>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// A chunk of a batch read, entries stored uncompressed are one copy
+struct ReadItem_t {
+    uint32_t location;
+    uint32_t chunk;
+}; typedef ReadItem_t ReadItem;
+
+
+static const uint32_t WHOLE_ENTRY = UINT32_MAX;
+
+VirtualFileSystem::VirtualFileSystem() {
+}
+
+//------------------------------------------------------------------------------------------
+//------------------------------------------------------------------------------------------
+void VirtualFileSystem::init(JobSystem* pJobSystem) {
+    mpJobSystem = pJobSystem;
+    mStats = Stats();
+}
+
+//------------------------------------------------------------------------------------------
+//------------------------------------------------------------------------------------------
+void VirtualFileSystem::clean_up() {
+    mLocations.clear();
+    mArchives.clear();
+    mStats = Stats();
+}
+
+//------------------------------------------------------------------------------------------
+// A hash already taken by another path would make one of the two unreachable, so that is
+// refused rather than resolved by mount order. The archive's files are checked before any
+// of them is added, so a refused mount leaves the mounted archives as they were.
+//------------------------------------------------------------------------------------------
+void VirtualFileSystem::mount(const std::string& packPath) {
+    std::unique_ptr<PackFile> pArchive = std::make_unique<PackFile>();
+    pArchive->open(packPath);
+    const uint32_t archive = static_cast<uint32_t>(mArchives.size());
+
+    std::unordered_map<uint64_t, FileLocation> locations;
+    locations.reserve(pArchive->get_entry_count());
+    for (uint32_t i = 0; i < pArchive->get_entry_count(); i++) {
+        const PackFileEntry& entry = pArchive->get_entry(i);
+        const char* pPath = pArchive->get_entry_path(i);
+        const char* pOtherPath = nullptr;
+        auto inArchive = locations.find(entry.pathHash);
+        auto mounted = mLocations.find(entry.pathHash);
+        if (inArchive != locations.end()) {
+            pOtherPath = pArchive->get_entry_path(inArchive->second.entry);
+        }
+        else if (mounted != mLocations.end()) {
+            pOtherPath = get_path(mounted->second);
+        }
+        if (pOtherPath && strcmp(pOtherPath, pPath) != 0) {
+            throw std::runtime_error("Failed to mount pack file " + packPath + ", " + pPath +
+                                     " has the same path hash as " + pOtherPath + "!");
+        }
+        locations[entry.pathHash] = { archive, i };
+    }
+
+    for (const auto& location : locations) {
+        mLocations[location.first] = location.second;
+    }
+    mStats.archives++;
+    mStats.files = static_cast<uint32_t>(mLocations.size());
+    mStats.archiveBytes += pArchive->get_file_bytes();
+    mArchives.push_back(std::move(pArchive));
+}
+
+//------------------------------------------------------------------------------------------
+//------------------------------------------------------------------------------------------
+bool VirtualFileSystem::find(const std::string& path, FileLocation* pLocation) const {
+    const std::string normalizedPath = PackFile::normalize_path(path);
+    auto found = mLocations.find(PackFile::hash_path(normalizedPath));
+    if (found == mLocations.end() || normalizedPath != get_path(found->second)) {
+        return false;
+    }
+    *pLocation = found->second;
+    return true;
+}
+
+//------------------------------------------------------------------------------------------
+//------------------------------------------------------------------------------------------
+bool VirtualFileSystem::exists(const std::string& path) const {
+    FileLocation location;
+    return find(path, &location);
+}
+
+//------------------------------------------------------------------------------------------
+//------------------------------------------------------------------------------------------
+uint64_t VirtualFileSystem::get_size(const FileLocation& location) const {
+    return mArchives[location.archive]->get_entry(location.entry).bytes;
+}
+
+//------------------------------------------------------------------------------------------
+//------------------------------------------------------------------------------------------
+const char* VirtualFileSystem::get_path(const FileLocation& location) const {
+    return mArchives[location.archive]->get_entry_path(location.entry);
+}
+
+//------------------------------------------------------------------------------------------
+//------------------------------------------------------------------------------------------
+const uint8_t* VirtualFileSystem::get_mapped(const FileLocation& location) const {
+    return mArchives[location.archive]->get_mapped(location.entry);
+}
+
+//------------------------------------------------------------------------------------------
+//------------------------------------------------------------------------------------------
+void VirtualFileSystem::read(const FileLocation& location, uint8_t* pDestination) {
+    const PackFile& archive = *mArchives[location.archive];
+    archive.read(location.entry, pDestination, mpJobSystem);
+    mStats.filesRead++;
+    mStats.bytesRead += archive.get_entry(location.entry).bytes;
+    mStats.chunksDecompressed += archive.get_entry(location.entry).chunkCount;
+}
+
+//------------------------------------------------------------------------------------------
+//------------------------------------------------------------------------------------------
+std::vector<uint8_t> VirtualFileSystem::read_file(const std::string& path) {
+    FileLocation location;
+    if (!find(path, &location)) {
+        throw std::runtime_error("Failed to read " + path + ", it's in no mounted pack file!");
+    }
+    std::vector<uint8_t> data(get_size(location));
+    read(location, data.data());
+    return data;
+}
+
+//------------------------------------------------------------------------------------------
+//------------------------------------------------------------------------------------------
+void VirtualFileSystem::read_files(const std::vector<FileLocation>& locations, const std::vector<uint8_t*>& destinations) {
+    std::vector<ReadItem> items;
+    for (uint32_t i = 0; i < locations.size(); i++) {
+        const PackFileEntry& entry = mArchives[locations[i].archive]->get_entry(locations[i].entry);
+        if (entry.compression == PACK_COMPRESSION_NONE) {
+            items.push_back({ i, WHOLE_ENTRY });
+        }
+        for (uint32_t j = 0; j < entry.chunkCount; j++) {
+            items.push_back({ i, j });
+        }
+        mStats.filesRead++;
+        mStats.bytesRead += entry.bytes;
+        mStats.chunksDecompressed += entry.chunkCount;
+    }
+
+    std::atomic<uint32_t> corruptLocation{UINT32_MAX};
+    auto readItems = [&](uint32_t begin, uint32_t end) {
+        for (uint32_t i = begin; i < end; i++) {
+            const ReadItem& item = items[i];
+            const FileLocation& location = locations[item.location];
+            const PackFile& archive = *mArchives[location.archive];
+            if (item.chunk == WHOLE_ENTRY) {
+                const uint64_t bytes = archive.get_entry(location.entry).bytes;
+                if (bytes > 0) {
+                    memcpy(destinations[item.location], archive.get_mapped(location.entry), bytes);
+                }
+            }
+            else if (!archive.read_chunk(location.entry, item.chunk, destinations[item.location])) {
+                corruptLocation.store(item.location, std::memory_order_relaxed);
+            }
+        }
+    };
+    const uint32_t itemCount = static_cast<uint32_t>(items.size());
+    if (mpJobSystem) {
+        mpJobSystem->parallel_for(itemCount, 1, readItems);
+    }
+    else {
+        readItems(0, itemCount);
+    }
+
+    const uint32_t corrupt = corruptLocation.load();
+    if (corrupt != UINT32_MAX) {
+        throw std::runtime_error("Failed to read " + std::string(get_path(locations[corrupt])) + " from pack file " +
+                                 mArchives[locations[corrupt].archive]->get_path() + ", it's corrupt!");
+    }
+}
+
+//------------------------------------------------------------------------------------------
+//------------------------------------------------------------------------------------------
+void VirtualFileSystem::print_stats(std::ostream& out) const {
+    out << "Virtual file system stats:\n";
+    out << "\tArchives: " << mStats.archives << '\n';
+    out << "\tFiles: " << mStats.files << '\n';
+    out << "\tArchive size: " << mStats.archiveBytes / 1024 << " KB\n";
+    out << "\tFiles read: " << mStats.filesRead << '\n';
+    out << "\tRead: " << mStats.bytesRead / 1024 << " KB\n";
+    out << "\tChunks decompressed: " << mStats.chunksDecompressed << '\n';
+}
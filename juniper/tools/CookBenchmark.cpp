@@ -0,0 +1,233 @@
+//======================================================================
+// CookBenchmark.cpp
+//
+// Keegan Kochis
+// Created: 2026/10/19
+// Times the cook graph and database on a generated project, so what
+// is measured is the dependency tracking rather than the cooking. Each
+// asset is a small source file copied to the output directory by its
+// own step, and one step lists every output, the way a pack depends on
+// everything. After a full cook it times a no-op cook starting from the
+// database on disk the way a fresh cooker would, a no-op with the graph
+// already built, a no-op for an empty change list, and cooks after one
+// source was touched and after one was edited. The scratch directory
+// has to be empty or not exist yet, and only what the benchmark wrote
+// there is removed afterwards.
+// Usage: CookBenchmark <scratch directory> [asset count] [thread count]
+//======================================================================
+
+#include "CookDatabase.h"
+#include "CookGraph.h"
+#include "JobSystem.h"
+
+#include <cctype>
+#include <cstdint>
+#include <cstdlib>
+
+#include <chrono>
+#include <exception>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <string>
+#include <system_error>
+#include <vector>
+
+static const uint32_t DEFAULT_ASSET_COUNT = 50000;
+static const uint32_t ASSETS_PER_DIRECTORY = 500;
+
+//------------------------------------------------------------------------------------------
+// False unless the whole argument is a number above zero
+//------------------------------------------------------------------------------------------
+static bool parse_count(const char* pArgument, uint32_t* pValue) {
+    const std::string text = pArgument;
+    if (text.empty() || !std::isdigit(static_cast<unsigned char>(text[0]))) {
+        return false;
+    }
+    size_t consumed = 0;
+    unsigned long value = 0;
+    try {
+        value = std::stoul(text, &consumed, 10);
+    }
+    catch (const std::exception&) {
+        return false;
+    }
+    if (consumed != text.size() || value == 0 || value > UINT32_MAX) {
+        return false;
+    }
+    *pValue = static_cast<uint32_t>(value);
+    return true;
+}
+
+//------------------------------------------------------------------------------------------
+// Only what the benchmark wrote, the scratch directory too if it made it
+//------------------------------------------------------------------------------------------
+static void remove_scratch(const std::filesystem::path& scratch, bool createdScratch) {
+    std::error_code error;
+    std::filesystem::remove_all(scratch / "source", error);
+    std::filesystem::remove_all(scratch / "output", error);
+    if (createdScratch) {
+        std::filesystem::remove(scratch, error);
+    }
+}
+
+static double elapsed_ms(std::chrono::high_resolution_clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - start).count();
+}
+
+//------------------------------------------------------------------------------------------
+// A few hundred bytes to a few KB, different for every asset
+//------------------------------------------------------------------------------------------
+static void write_source(const std::string& path, uint32_t asset, uint32_t edit) {
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    const uint32_t lineCount = 8 + asset % 64;
+    for (uint32_t i = 0; i < lineCount; i++) {
+        file << "asset " << asset << " line " << i << " edit " << edit << '\n';
+    }
+}
+
+//------------------------------------------------------------------------------------------
+// Opens the database and adds a step per source plus the one listing every output
+//------------------------------------------------------------------------------------------
+static void build_graph(CookGraph& graph, const std::vector<std::string>& sources, const std::string& outputDirectory) {
+    std::vector<CookStepId> steps;
+    steps.reserve(sources.size());
+    for (const std::string& source : sources) {
+        const std::string output = outputDirectory + "/" + std::filesystem::path(source).filename().string() + ".out";
+        steps.push_back(graph.add_step(source, "copy", 1, { source }, {},
+            [source, output](const std::vector<std::string>&, CookGraph::CookResult* pResult) {
+                std::filesystem::copy_file(source, output, std::filesystem::copy_options::overwrite_existing);
+                pResult->outputs.push_back(output);
+            }));
+    }
+
+    const std::string listPath = outputDirectory + "/list.txt";
+    graph.add_step("list", "list", 1, {}, steps,
+        [listPath](const std::vector<std::string>& inputs, CookGraph::CookResult* pResult) {
+            std::ofstream file(listPath, std::ios::trunc);
+            for (const std::string& input : inputs) {
+                file << input << '\n';
+            }
+            pResult->outputs.push_back(listPath);
+        });
+}
+
+//------------------------------------------------------------------------------------------
+//------------------------------------------------------------------------------------------
+static void print_run(const char* name, const CookGraph& graph, double totalMs) {
+    const CookGraph::Stats& stats = graph.get_stats();
+    std::cout << '\t' << name << ": " << totalMs << " ms, " << stats.checkedSteps << " checked, " << stats.cookedSteps
+              << " cooked, " << stats.filesChecked << " files checked, " << stats.filesChanged << " changed\n";
+}
+
+int main(int argc, char* argv[]) {
+    static const char* USAGE = "Usage: CookBenchmark <scratch directory> [asset count] [thread count]\n";
+    uint32_t assetCount = DEFAULT_ASSET_COUNT;
+    uint32_t threadCount = 0;
+    if (argc < 2 || argv[1][0] == '-' || (argc > 2 && !parse_count(argv[2], &assetCount)) ||
+        (argc > 3 && !parse_count(argv[3], &threadCount))) {
+        std::cerr << USAGE;
+        return EXIT_FAILURE;
+    }
+    // Everything in the scratch directory is the benchmark's, so it has to start out empty
+    const std::filesystem::path scratch = argv[1];
+    std::error_code error;
+    if (std::filesystem::exists(scratch, error) &&
+        (!std::filesystem::is_directory(scratch, error) || !std::filesystem::is_empty(scratch, error))) {
+        std::cerr << "Scratch directory " << scratch.string() << " has to be empty or not exist yet\n" << USAGE;
+        return EXIT_FAILURE;
+    }
+    const bool createdScratch = std::filesystem::create_directories(scratch, error);
+    if (error) {
+        std::cerr << "Failed to create scratch directory " << scratch.string() << "!\n";
+        return EXIT_FAILURE;
+    }
+
+    JobSystem jobSystem;
+    try {
+        // The calling thread takes part in parallel loops, so one fewer worker
+        if (threadCount != 1) {
+            jobSystem.init(threadCount > 0 ? threadCount - 1 : 0);
+        }
+        JobSystem* pJobSystem = threadCount != 1 ? &jobSystem : nullptr;
+
+        const std::string sourceDirectory = (scratch / "source").string();
+        const std::string outputDirectory = (scratch / "output").string();
+        const std::string databasePath = outputDirectory + "/" + CookDatabase::FILE_NAME;
+        std::vector<std::string> sources(assetCount);
+        for (uint32_t i = 0; i < assetCount; i++) {
+            const std::string directory = sourceDirectory + "/" + std::to_string(i / ASSETS_PER_DIRECTORY);
+            if (i % ASSETS_PER_DIRECTORY == 0) {
+                std::filesystem::create_directories(directory);
+            }
+            sources[i] = directory + "/asset" + std::to_string(i) + ".txt";
+            write_source(sources[i], i, 0);
+        }
+        std::filesystem::create_directories(outputDirectory);
+        std::cout << "Cook graph of " << assetCount << " assets and one step after all of them, on "
+                  << (pJobSystem ? jobSystem.get_thread_count() : 1) << " threads\n";
+
+        {
+            auto start = std::chrono::high_resolution_clock::now();
+            CookDatabase database;
+            database.open(databasePath);
+            CookGraph graph;
+            graph.init(pJobSystem, &database);
+            build_graph(graph, sources, outputDirectory);
+            graph.run();
+            print_run("Full cook", graph, elapsed_ms(start));
+        }
+
+        // What a cooker starting up pays, reading the database and building the graph included
+        auto start = std::chrono::high_resolution_clock::now();
+        CookDatabase database;
+        database.open(databasePath);
+        const double openMs = elapsed_ms(start);
+        CookGraph graph;
+        graph.init(pJobSystem, &database);
+        build_graph(graph, sources, outputDirectory);
+        const double buildMs = elapsed_ms(start) - openMs;
+        graph.run();
+        const double coldMs = elapsed_ms(start);
+        print_run("No-op cook from disk", graph, coldMs);
+        std::cout << "\t\tDatabase: " << openMs << " ms, graph: " << buildMs << " ms, run: " << graph.get_stats().runMs
+                  << " ms\n";
+
+        start = std::chrono::high_resolution_clock::now();
+        graph.run();
+        print_run("No-op cook", graph, elapsed_ms(start));
+
+        start = std::chrono::high_resolution_clock::now();
+        graph.run_changed({});
+        print_run("No-op cook of no changes", graph, elapsed_ms(start));
+
+        // Same content, new time
+        const uint32_t editedAsset = assetCount / 2;
+        write_source(sources[editedAsset], editedAsset, 0);
+        start = std::chrono::high_resolution_clock::now();
+        graph.run_changed({ sources[editedAsset] });
+        print_run("Touched one source", graph, elapsed_ms(start));
+
+        write_source(sources[editedAsset], editedAsset, 1);
+        start = std::chrono::high_resolution_clock::now();
+        graph.run_changed({ sources[editedAsset] });
+        print_run("Edited one source", graph, elapsed_ms(start));
+
+        write_source(sources[editedAsset], editedAsset, 2);
+        start = std::chrono::high_resolution_clock::now();
+        graph.run();
+        print_run("Edited one source, checking all", graph, elapsed_ms(start));
+
+        std::cout << (coldMs < 1000.0 ? "\tNo-op cook from disk is under a second\n" : "\tNo-op cook from disk takes a second or more\n");
+    } catch (const std::exception& e) {
+        jobSystem.clean_up();
+        remove_scratch(scratch, createdScratch);
+        std::cerr << e.what() << std::endl;
+        return EXIT_FAILURE;
+    }
+    jobSystem.clean_up();
+    remove_scratch(scratch, createdScratch);
+
+    return EXIT_SUCCESS;
+}
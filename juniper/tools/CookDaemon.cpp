@@ -0,0 +1,136 @@
+//======================================================================
+// CookDaemon.cpp
+//
+// Keegan Kochis
+// Created: 2026/10/19
+// Cooks every glTF, GLB and TGA asset under a source directory into an
+// output directory, skipping the assets the cook database shows are up
+// to date, and optionally packs the outputs. With --watch it then stays
+// running and recooks only what the edited files affect as they change.
+// --poll watches by scanning instead of with inotify, --force cooks
+// everything once before watching and --quantize cooks the meshes with
+// quantized vertices.
+// Usage: CookDaemon <source directory> <output directory>
+//        [--pack <output.jpak>] [--watch] [--poll] [--force]
+//        [--quantize] [thread count]
+//======================================================================
+
+#include "AssetCooker.h"
+#include "FileWatcher.h"
+#include "JobSystem.h"
+#include "Mesh.h"
+
+#include <cstdint>
+#include <cstdlib>
+
+#include <exception>
+#include <filesystem>
+#include <iostream>
+#include <string>
+#include <vector>
+
+// How long a wait for changes blocks before it's started again
+static const uint32_t WAIT_MS = 1000;
+
+int main(int argc, char* argv[]) {
+    if (argc < 3) {
+        std::cerr << "Usage: CookDaemon <source directory> <output directory> [--pack <output.jpak>] [--watch] [--poll]"
+                     " [--force] [--quantize] [thread count]\n";
+        return EXIT_FAILURE;
+    }
+    const std::string output = argv[2];
+    std::string packPath;
+    bool watch = false;
+    WatchBackend watchBackend = WATCH_BACKEND_INOTIFY;
+    bool force = false;
+    VertexFormat vertexFormat = VERTEX_FORMAT_FLOAT;
+    uint32_t threadCount = 0;
+    for (int i = 3; i < argc; i++) {
+        const std::string argument = argv[i];
+        if (argument == "--pack" && i + 1 < argc) {
+            packPath = argv[++i];
+        }
+        else if (argument == "--watch") {
+            watch = true;
+        }
+        else if (argument == "--poll") {
+            watchBackend = WATCH_BACKEND_POLLING;
+        }
+        else if (argument == "--force") {
+            force = true;
+        }
+        else if (argument == "--quantize") {
+            vertexFormat = VERTEX_FORMAT_QUANTIZED;
+        }
+        else {
+            threadCount = static_cast<uint32_t>(std::strtoul(argv[i], nullptr, 10));
+        }
+    }
+
+    JobSystem jobSystem;
+    try {
+        // The calling thread takes part in parallel loops, so one fewer worker
+        if (threadCount != 1) {
+            jobSystem.init(threadCount > 0 ? threadCount - 1 : 0);
+        }
+
+        // Watchers report paths under the directory as it's given, so it's given the same
+        // way to both
+        const std::string source = std::filesystem::canonical(argv[1]).string();
+        AssetCooker cooker;
+        cooker.init(threadCount != 1 ? &jobSystem : nullptr, output);
+        cooker.set_incremental(!force);
+        cooker.set_vertex_format(vertexFormat);
+        cooker.set_pack_path(packPath);
+
+        try {
+            cooker.cook_directory(source);
+        } catch (const std::exception& e) {
+            if (!watch) {
+                throw;
+            }
+            std::cerr << e.what() << std::endl;
+        }
+        std::cout << "Cooked " << source << " into " << output << '\n';
+        cooker.get_graph().print_stats(std::cout);
+        cooker.print_stats(std::cout);
+        if (!watch) {
+            jobSystem.clean_up();
+            return EXIT_SUCCESS;
+        }
+
+        cooker.set_incremental(true);
+        FileWatcher watcher;
+        watcher.init(watchBackend, source);
+        std::cout << "Watching " << source << " with " << (watcher.get_backend() == WATCH_BACKEND_INOTIFY ? "inotify" : "polling")
+                  << '\n';
+        while (true) {
+            std::vector<std::string> paths;
+            const bool complete = watcher.wait_for_changes(WAIT_MS, &paths);
+            if (complete && paths.empty()) {
+                continue;
+            }
+
+            // A failed asset is reported and retried with its next change, the rest of the
+            // tree keeps cooking
+            try {
+                if (complete) {
+                    cooker.cook_changes(paths);
+                }
+                else {
+                    std::cout << "Changes were lost, checking everything\n";
+                    cooker.cook_directory(source);
+                }
+            } catch (const std::exception& e) {
+                std::cerr << e.what() << std::endl;
+            }
+            const CookGraph::Stats& stats = cooker.get_graph().get_stats();
+            std::cout << paths.size() << " files changed, " << stats.checkedSteps << " steps checked, "
+                      << stats.cookedSteps << " cooked, " << stats.failedSteps << " failed in " << stats.runMs << " ms\n";
+        }
+    } catch (const std::exception& e) {
+        jobSystem.clean_up();
+        std::cerr << e.what() << std::endl;
+        return EXIT_FAILURE;
+    }
+}
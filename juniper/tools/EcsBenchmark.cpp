@@ -0,0 +1,197 @@
+//======================================================================
+// EcsBenchmark.cpp
+//
+// Keegan Kochis
+// Created: 2026/10/18
+// Microbenchmark of a three component query over the entity world
+// against the same update on arrays of structs, a lean one holding
+// only the three components and a game object sized one.
+// Usage: EcsBenchmark [entity count] [iterations]
+//======================================================================
+
+#include "EntityWorld.h"
+
+#include <cctype>
+#include <cstdint>
+#include <cstdlib>
+
+#include <algorithm>
+#include <chrono>
+#include <exception>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#define GLM_FORCE_RADIANS
+#define GLM_FORCE_DEPTH_ZERO_TO_ONE
+#include <glm/mat4x4.hpp>
+#include <glm/vec3.hpp>
+
+struct Position_t {
+    glm::vec3 value;
+}; typedef Position_t Position;
+
+
+struct Velocity_t {
+    glm::vec3 value;
+}; typedef Velocity_t Velocity;
+
+
+struct Acceleration_t {
+    glm::vec3 value;
+}; typedef Acceleration_t Acceleration;
+
+
+// Splits the entities over a second archetype
+struct Health_t {
+    float value;
+}; typedef Health_t Health;
+
+
+struct LeanObject_t {
+    glm::vec3 position;
+    glm::vec3 velocity;
+    glm::vec3 acceleration;
+}; typedef LeanObject_t LeanObject;
+
+
+// What a typical object class carries around besides the data the update touches
+struct GameObject_t {
+    glm::mat4 transform;
+    glm::vec3 position;
+    glm::vec3 velocity;
+    glm::vec3 acceleration;
+    float health;
+    char name[32];
+    uint32_t flags;
+    void* pUserData;
+}; typedef GameObject_t GameObject;
+
+
+static volatile float gSink = 0.0f;
+
+//------------------------------------------------------------------------------------------
+// False unless the whole argument is a number above zero
+//------------------------------------------------------------------------------------------
+static bool parse_count(const char* pArgument, uint32_t* pValue) {
+    const std::string text = pArgument;
+    if (text.empty() || !std::isdigit(static_cast<unsigned char>(text[0]))) {
+        return false;
+    }
+    size_t consumed = 0;
+    unsigned long value = 0;
+    try {
+        value = std::stoul(text, &consumed, 10);
+    }
+    catch (const std::exception&) {
+        return false;
+    }
+    if (consumed != text.size() || value == 0 || value > UINT32_MAX) {
+        return false;
+    }
+    *pValue = static_cast<uint32_t>(value);
+    return true;
+}
+
+//------------------------------------------------------------------------------------------
+// Best of the iterations in milliseconds, the first run warms the caches
+//------------------------------------------------------------------------------------------
+static double time_ms(uint32_t iterations, const std::function<void()>& run) {
+    run();
+    double best = 1e30;
+    for (uint32_t i = 0; i < iterations; i++) {
+        auto start = std::chrono::high_resolution_clock::now();
+        run();
+        auto end = std::chrono::high_resolution_clock::now();
+        best = std::min(best, std::chrono::duration<double, std::milli>(end - start).count());
+    }
+    return best;
+}
+
+static void print_timing(const char* name, double ms, uint32_t entityCount, double baselineMs) {
+    std::cout << '\t' << std::left << std::setw(28) << name << std::right << std::fixed
+              << std::setprecision(3) << std::setw(10) << ms << " ms"
+              << std::setprecision(2) << std::setw(8) << 1e6 * ms / entityCount << " ns/entity"
+              << std::setw(8) << baselineMs / ms << "x\n" << std::defaultfloat;
+}
+
+int main(int argc, char* argv[]) {
+    uint32_t entityCount = 1000000;
+    uint32_t iterations = 20;
+    if ((argc > 1 && !parse_count(argv[1], &entityCount)) || (argc > 2 && !parse_count(argv[2], &iterations))) {
+        std::cerr << "Usage: EcsBenchmark [entity count] [iterations]\n";
+        return EXIT_FAILURE;
+    }
+    const float dt = 1.0f / 60.0f;
+
+    std::vector<GameObject> gameObjects(entityCount);
+    std::vector<LeanObject> leanObjects(entityCount);
+    EntityWorld world;
+
+    auto start = std::chrono::high_resolution_clock::now();
+    for (uint32_t i = 0; i < entityCount; i++) {
+        const glm::vec3 position(static_cast<float>(i), 0.0f, 0.0f);
+        const glm::vec3 velocity(0.0f, 1.0f, 0.0f);
+        const glm::vec3 acceleration(0.0f, -9.8f, 0.0f);
+
+        gameObjects[i].position = position;
+        gameObjects[i].velocity = velocity;
+        gameObjects[i].acceleration = acceleration;
+        leanObjects[i] = { position, velocity, acceleration };
+
+        if (i % 4 == 0) {
+            world.create_entity(Position{ position }, Velocity{ velocity }, Acceleration{ acceleration }, Health{ 100.0f });
+        }
+        else {
+            world.create_entity(Position{ position }, Velocity{ velocity }, Acceleration{ acceleration });
+        }
+    }
+    auto end = std::chrono::high_resolution_clock::now();
+    const double createMs = std::chrono::duration<double, std::milli>(end - start).count();
+
+    const QueryId query = world.create_query<Position, Velocity, const Acceleration>();
+
+    double gameObjectMs = time_ms(iterations, [&]() {
+        for (GameObject& object : gameObjects) {
+            object.velocity += object.acceleration * dt;
+            object.position += object.velocity * dt;
+        }
+        gSink = gameObjects[entityCount / 2].position.y;
+    });
+    double leanMs = time_ms(iterations, [&]() {
+        for (LeanObject& object : leanObjects) {
+            object.velocity += object.acceleration * dt;
+            object.position += object.velocity * dt;
+        }
+        gSink = leanObjects[entityCount / 2].position.y;
+    });
+    double eachMs = time_ms(iterations, [&]() {
+        world.for_each<Position, Velocity, const Acceleration>(query,
+            [dt](Entity, Position& position, Velocity& velocity, const Acceleration& acceleration) {
+                velocity.value += acceleration.value * dt;
+                position.value += velocity.value * dt;
+            });
+    });
+    double chunkMs = time_ms(iterations, [&]() {
+        world.for_each_chunk<Position, Velocity, const Acceleration>(query,
+            [dt](uint32_t count, const Entity*, Position* pPositions, Velocity* pVelocities, const Acceleration* pAccelerations) {
+                for (uint32_t i = 0; i < count; i++) {
+                    pVelocities[i].value += pAccelerations[i].value * dt;
+                    pPositions[i].value += pVelocities[i].value * dt;
+                }
+            });
+    });
+
+    std::cout << "Entity world, " << entityCount << " entities, best of " << iterations << " runs\n";
+    std::cout << "\tCreated in " << createMs << " ms\n";
+    std::cout << "\tQuery matches " << world.count(query) << " entities\n";
+    print_timing("AoS game objects", gameObjectMs, entityCount, gameObjectMs);
+    print_timing("AoS lean objects", leanMs, entityCount, gameObjectMs);
+    print_timing("ECS for_each", eachMs, entityCount, gameObjectMs);
+    print_timing("ECS for_each_chunk", chunkMs, entityCount, gameObjectMs);
+    world.print_stats(std::cout);
+
+    return 0;
+}
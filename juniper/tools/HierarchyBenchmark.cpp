@@ -0,0 +1,199 @@
+//======================================================================
+// HierarchyBenchmark.cpp
+//
+// Keegan Kochis
+// Created: 2026/10/18
+// Microbenchmark of world matrix updates on a random tree: a pointer
+// based scene graph recomputing everything against the transform
+// hierarchy updating all of its nodes or only a changed fraction.
+// Usage: HierarchyBenchmark [node count] [iterations] [threads]
+//======================================================================
+
+#include "JobSystem.h"
+#include "TransformHierarchy.h"
+
+#include <cctype>
+#include <cstdint>
+#include <cstdlib>
+
+#include <algorithm>
+#include <chrono>
+#include <exception>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+#define GLM_FORCE_RADIANS
+#define GLM_FORCE_DEPTH_ZERO_TO_ONE
+#include <glm/mat4x4.hpp>
+#include <glm/vec3.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+#include <glm/gtc/quaternion.hpp>
+
+// The usual object graph, every node a separate allocation
+struct GraphNode_t {
+    Transform local;
+    glm::mat4 world;
+    std::vector<GraphNode_t*> children;
+}; typedef GraphNode_t GraphNode;
+
+
+static volatile float gSink = 0.0f;
+
+//------------------------------------------------------------------------------------------
+// False unless the whole argument is a number above zero
+//------------------------------------------------------------------------------------------
+static bool parse_count(const char* pArgument, uint32_t* pValue) {
+    const std::string text = pArgument;
+    if (text.empty() || !std::isdigit(static_cast<unsigned char>(text[0]))) {
+        return false;
+    }
+    size_t consumed = 0;
+    unsigned long value = 0;
+    try {
+        value = std::stoul(text, &consumed, 10);
+    }
+    catch (const std::exception&) {
+        return false;
+    }
+    if (consumed != text.size() || value == 0 || value > UINT32_MAX) {
+        return false;
+    }
+    *pValue = static_cast<uint32_t>(value);
+    return true;
+}
+
+//------------------------------------------------------------------------------------------
+// Best of the iterations in milliseconds, the first run warms the caches
+//------------------------------------------------------------------------------------------
+static double time_ms(uint32_t iterations, const std::function<void()>& run) {
+    run();
+    double best = 1e30;
+    for (uint32_t i = 0; i < iterations; i++) {
+        auto start = std::chrono::high_resolution_clock::now();
+        run();
+        auto end = std::chrono::high_resolution_clock::now();
+        best = std::min(best, std::chrono::duration<double, std::milli>(end - start).count());
+    }
+    return best;
+}
+
+static void print_timing(const char* name, double ms, uint32_t nodeCount, double baselineMs) {
+    std::cout << '\t' << std::left << std::setw(32) << name << std::right << std::fixed
+              << std::setprecision(3) << std::setw(10) << ms << " ms"
+              << std::setprecision(2) << std::setw(8) << 1e6 * ms / nodeCount << " ns/node"
+              << std::setw(9) << baselineMs / ms << "x\n" << std::defaultfloat;
+}
+
+static void update_graph(GraphNode* pNode, const glm::mat4& parentWorld) {
+    const Transform& local = pNode->local;
+    pNode->world = parentWorld * glm::translate(glm::mat4(1.0f), local.position) * glm::mat4_cast(local.rotation) *
+                   glm::scale(glm::mat4(1.0f), local.scale);
+    for (GraphNode* pChild : pNode->children) {
+        update_graph(pChild, pNode->world);
+    }
+}
+
+int main(int argc, char* argv[]) {
+    uint32_t nodeCount = 1000000;
+    uint32_t iterations = 10;
+    uint32_t threadCount = 0;
+    if ((argc > 1 && !parse_count(argv[1], &nodeCount)) || (argc > 2 && !parse_count(argv[2], &iterations)) ||
+        (argc > 3 && !parse_count(argv[3], &threadCount))) {
+        std::cerr << "Usage: HierarchyBenchmark [node count] [iterations] [threads]\n";
+        return EXIT_FAILURE;
+    }
+    const uint32_t rootCount = std::max(1u, nodeCount / 1000);
+
+    // A random recursive tree, each node's parent picked among the nodes before it
+    std::mt19937 rng(1234);
+    std::vector<uint32_t> parents(nodeCount);
+    std::vector<Transform> locals(nodeCount);
+    for (uint32_t i = 0; i < nodeCount; i++) {
+        parents[i] = i < rootCount ? UINT32_MAX : rng() % i;
+        locals[i].position = glm::vec3(0.1f * (rng() % 10), 0.1f * (rng() % 10), 0.1f * (rng() % 10));
+        locals[i].rotation = glm::angleAxis(0.01f * (rng() % 314), glm::vec3(0.0f, 1.0f, 0.0f));
+        locals[i].scale = glm::vec3(1.0f);
+    }
+
+    // Allocated in shuffled order, as a long running scene ends up
+    std::vector<uint32_t> allocationOrder(nodeCount);
+    for (uint32_t i = 0; i < nodeCount; i++) {
+        allocationOrder[i] = i;
+    }
+    std::shuffle(allocationOrder.begin(), allocationOrder.end(), rng);
+    std::vector<std::unique_ptr<GraphNode>> graphNodes(nodeCount);
+    for (uint32_t i : allocationOrder) {
+        graphNodes[i] = std::make_unique<GraphNode>();
+        graphNodes[i]->local = locals[i];
+    }
+    for (uint32_t i = rootCount; i < nodeCount; i++) {
+        graphNodes[parents[i]]->children.push_back(graphNodes[i].get());
+    }
+
+    JobSystem jobSystem;
+    jobSystem.init(threadCount);
+    TransformHierarchy serialHierarchy;
+    TransformHierarchy parallelHierarchy;
+    serialHierarchy.init(nullptr);
+    parallelHierarchy.init(&jobSystem);
+
+    std::vector<TransformNode> nodes(nodeCount);
+    for (uint32_t i = 0; i < nodeCount; i++) {
+        const TransformNode parent = parents[i] == UINT32_MAX ? TransformNode() : nodes[parents[i]];
+        nodes[i] = serialHierarchy.create_node(parent, locals[i]);
+        parallelHierarchy.create_node(parent, locals[i]);
+    }
+    serialHierarchy.update();
+    parallelHierarchy.update();
+
+    double graphMs = time_ms(iterations, [&]() {
+        for (uint32_t i = 0; i < rootCount; i++) {
+            update_graph(graphNodes[i].get(), glm::mat4(1.0f));
+        }
+        gSink = graphNodes[nodeCount / 2]->world[3].x;
+    });
+
+    // A node changing each update, the cost should follow the changed subtrees
+    auto touch = [&](TransformHierarchy& hierarchy, uint32_t changedCount) {
+        for (uint32_t i = 0; i < changedCount; i++) {
+            const uint32_t index = rng() % nodeCount;
+            hierarchy.set_local(nodes[index], locals[index]);
+        }
+        hierarchy.update();
+        gSink = hierarchy.get_world(nodes[nodeCount / 2])[3].x;
+    };
+
+    std::cout << "Transform hierarchy benchmark, " << nodeCount << " nodes, " << serialHierarchy.get_stats().levels
+              << " levels, " << jobSystem.get_thread_count() << " threads\n";
+    print_timing("Pointer graph, all nodes", graphMs, nodeCount, graphMs);
+
+    // Changing every root forces a full update
+    auto touch_roots = [&](TransformHierarchy& hierarchy) {
+        for (uint32_t i = 0; i < rootCount; i++) {
+            hierarchy.set_local(nodes[i], locals[i]);
+        }
+        hierarchy.update();
+        gSink = hierarchy.get_world(nodes[nodeCount / 2])[3].x;
+    };
+    double serialFullMs = time_ms(iterations, [&]() { touch_roots(serialHierarchy); });
+    print_timing("Hierarchy, all nodes", serialFullMs, nodeCount, graphMs);
+    double parallelFullMs = time_ms(iterations, [&]() { touch_roots(parallelHierarchy); });
+    print_timing("Hierarchy, all nodes, parallel", parallelFullMs, nodeCount, graphMs);
+
+    const uint32_t fractions[] = { 1000, 100, 10 };
+    for (uint32_t fraction : fractions) {
+        const uint32_t changedCount = std::max(1u, nodeCount / fraction);
+        double changedMs = time_ms(iterations, [&]() { touch(parallelHierarchy, changedCount); });
+        const TransformHierarchy::Stats stats = parallelHierarchy.get_stats();
+        std::cout << "\t" << changedCount << " changed nodes, " << stats.updatedNodes << " updated:\n";
+        print_timing("Hierarchy, changed subtrees", changedMs, nodeCount, graphMs);
+    }
+
+    jobSystem.clean_up();
+    return 0;
+}
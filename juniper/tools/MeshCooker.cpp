@@ -0,0 +1,97 @@
+//======================================================================
+// MeshCooker.cpp
+//
+// Keegan Kochis
+// Created: 2026/10/18
+// Offline cooker turning source meshes into mesh files. The input is
+// an OBJ file or one of the built in shapes, "cube" or "sphere". The
+// mesh is optimized for the GPU, reporting its vertex cache, fetch and
+// overdraw efficiency before and after, then simplified into levels of
+// detail. Quantized vertices are half the size, their error is reported
+// as well.
+// Usage: MeshCooker <input.obj | cube | sphere> <output mesh file> [--quantize]
+//======================================================================
+
+#include "Mesh.h"
+#include "MeshFile.h"
+#include "MeshImport.h"
+#include "MeshOptimize.h"
+#include "MeshQuantize.h"
+#include "MeshSimplify.h"
+
+#include <cstdlib>
+
+#include <chrono>
+#include <exception>
+#include <iostream>
+#include <string>
+#include <vector>
+
+//------------------------------------------------------------------------------------------
+//------------------------------------------------------------------------------------------
+static void print_analysis(const char* pLabel, const MeshData& mesh) {
+    const uint32_t vertexCount = static_cast<uint32_t>(mesh.vertices.size());
+    const VertexCacheStats cache = analyze_vertex_cache(mesh.indices, vertexCount, VERTEX_CACHE_SIZE);
+    const VertexFetchStats fetch = analyze_vertex_fetch(mesh.indices, vertexCount, sizeof(Vertex));
+    const OverdrawStats overdraw = analyze_overdraw(mesh.indices, mesh.vertices);
+    std::cout << '\t' << pLabel << ": ACMR " << cache.acmr << ", ATVR " << cache.atvr << ", overfetch " << fetch.overfetch
+              << ", overdraw " << overdraw.overdraw << '\n';
+}
+
+int main(int argc, char* argv[]) {
+    if (argc < 3 || argc > 4 || (argc == 4 && std::string(argv[3]) != "--quantize")) {
+        std::cerr << "Usage: MeshCooker <input.obj | cube | sphere> <output mesh file> [--quantize]\n";
+        return EXIT_FAILURE;
+    }
+    const std::string input = argv[1];
+    const std::string output = argv[2];
+    const VertexFormat vertexFormat = argc == 4 ? VERTEX_FORMAT_QUANTIZED : VERTEX_FORMAT_FLOAT;
+
+    try {
+        auto start = std::chrono::high_resolution_clock::now();
+
+        MeshData mesh;
+        if (input == "cube") {
+            mesh = MeshData::make_cube();
+        }
+        else if (input == "sphere") {
+            mesh = MeshData::make_sphere(32, 16);
+        }
+        else {
+            mesh = import_obj(input);
+        }
+        print_analysis("Before", mesh);
+        optimize_mesh(mesh);
+        print_analysis("After", mesh);
+        MeshFile::write(output, mesh, generate_lods(mesh), vertexFormat);
+
+        MeshFile meshFile;
+        meshFile.open(output);
+        const MeshFileHeader& header = meshFile.get_header();
+        auto end = std::chrono::high_resolution_clock::now();
+
+        std::cout << "Cooked " << input << " into " << output << " in "
+                  << std::chrono::duration<double, std::milli>(end - start).count() << " ms\n";
+        std::cout << '\t' << header.vertexCount << " vertices, " << meshFile.get_lod(0).indexCount / 3 << " triangles, "
+                  << header.meshletCount << " meshlets, " << header.lodCount << " levels, "
+                  << meshFile.get_file_bytes() << " bytes\n";
+        for (uint32_t i = 1; i < meshFile.get_lod_count(); i++) {
+            const MeshView view = meshFile.get_view(i);
+            std::cout << "\tLevel " << i << ": " << view.indexCount / 3 << " triangles, error " << view.lodError << " ("
+                      << view.lodError / view.boundingSphere.w << " of the radius)\n";
+        }
+        if (vertexFormat == VERTEX_FORMAT_QUANTIZED) {
+            const QuantizationError error = measure_quantization_error(mesh, quantize_mesh(mesh));
+            std::cout << "\tQuantized vertices: " << header.vertexCount * sizeof(QuantizedVertex) << " bytes instead of "
+                      << header.vertexCount * sizeof(Vertex) << '\n';
+            std::cout << "\tPosition error: " << error.maxPositionError << " max, " << error.meanPositionError << " mean, "
+                      << error.relativePositionError << " of the extent\n";
+            std::cout << "\tNormal error: " << error.maxNormalDegrees << " degrees max, " << error.meanNormalDegrees << " mean\n";
+        }
+    } catch (const std::exception& e) {
+        std::cerr << e.what() << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    return EXIT_SUCCESS;
+}
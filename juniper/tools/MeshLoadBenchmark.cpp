@@ -0,0 +1,199 @@
+//======================================================================
+// MeshLoadBenchmark.cpp
+//
+// Keegan Kochis
+// Created: 2026/10/18
+// Load throughput of a set of meshes into a staging area standing in
+// for the host visible geometry buffers: importing OBJ text, reading
+// mesh files into memory, and mapping mesh files and copying their
+// streams straight across. The files are written first, so they're
+// read from a warm page cache.
+// Usage: MeshLoadBenchmark [mesh count] [iterations] [directory]
+//======================================================================
+
+#include "Mesh.h"
+#include "MeshFile.h"
+#include "MeshImport.h"
+#include "Shader.h"
+
+#include <cctype>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+
+#include <algorithm>
+#include <chrono>
+#include <exception>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+static volatile uint8_t gSink = 0;
+
+//------------------------------------------------------------------------------------------
+// False unless the whole argument is a number above zero
+//------------------------------------------------------------------------------------------
+static bool parse_count(const char* pArgument, uint32_t* pValue) {
+    const std::string text = pArgument;
+    if (text.empty() || !std::isdigit(static_cast<unsigned char>(text[0]))) {
+        return false;
+    }
+    size_t consumed = 0;
+    unsigned long value = 0;
+    try {
+        value = std::stoul(text, &consumed, 10);
+    }
+    catch (const std::exception&) {
+        return false;
+    }
+    if (consumed != text.size() || value == 0 || value > UINT32_MAX) {
+        return false;
+    }
+    *pValue = static_cast<uint32_t>(value);
+    return true;
+}
+
+//------------------------------------------------------------------------------------------
+// Best of the iterations in milliseconds, the first run warms the caches
+//------------------------------------------------------------------------------------------
+static double time_ms(uint32_t iterations, const std::function<void()>& run) {
+    run();
+    double best = 1e30;
+    for (uint32_t i = 0; i < iterations; i++) {
+        auto start = std::chrono::high_resolution_clock::now();
+        run();
+        auto end = std::chrono::high_resolution_clock::now();
+        best = std::min(best, std::chrono::duration<double, std::milli>(end - start).count());
+    }
+    return best;
+}
+
+static void print_timing(const char* name, double ms, uint64_t bytes, uint32_t meshCount, double baselineMs) {
+    std::cout << '\t' << std::left << std::setw(28) << name << std::right << std::fixed
+              << std::setprecision(3) << std::setw(10) << ms << " ms"
+              << std::setprecision(1) << std::setw(10) << bytes / (1024.0 * 1024.0) / (ms / 1000.0) << " MB/s"
+              << std::setprecision(0) << std::setw(10) << meshCount / (ms / 1000.0) << " meshes/s"
+              << std::setprecision(2) << std::setw(9) << baselineMs / ms << "x\n" << std::defaultfloat;
+}
+
+static void write_obj(const std::string& path, const MeshData& mesh) {
+    std::ofstream file(path);
+    file << std::setprecision(7);
+    for (const Vertex& vertex : mesh.vertices) {
+        file << "v " << vertex.position.x << ' ' << vertex.position.y << ' ' << vertex.position.z << '\n';
+    }
+    for (const Vertex& vertex : mesh.vertices) {
+        file << "vn " << vertex.normal.x << ' ' << vertex.normal.y << ' ' << vertex.normal.z << '\n';
+    }
+    for (size_t i = 0; i < mesh.indices.size(); i += 3) {
+        file << 'f';
+        for (size_t j = 0; j < 3; j++) {
+            file << ' ' << mesh.indices[i + j] + 1 << "//" << mesh.indices[i + j] + 1;
+        }
+        file << '\n';
+    }
+}
+
+// Copies what the renderers upload into the staging area, returns the bytes copied
+static uint64_t upload(const MeshView& meshView, const MeshletView& meshletView, uint8_t* pStaging) {
+    const size_t sizes[5] = {
+        meshView.vertexCount * get_vertex_stride(meshView.vertexFormat), meshView.indexCount * sizeof(uint32_t),
+        meshletView.meshletCount * sizeof(Meshlet), meshletView.vertexCount * sizeof(uint32_t), meshletView.triangleBytes
+    };
+    const void* sources[5] = {
+        meshView.pVertices, meshView.pIndices, meshletView.pMeshlets, meshletView.pVertices, meshletView.pTriangles
+    };
+
+    uint64_t bytes = 0;
+    for (uint32_t i = 0; i < 5; i++) {
+        memcpy(pStaging + bytes, sources[i], sizes[i]);
+        bytes += sizes[i];
+    }
+    gSink = pStaging[bytes / 2];
+    return bytes;
+}
+
+int main(int argc, char* argv[]) {
+    uint32_t meshCount = 64;
+    uint32_t iterations = 5;
+    if ((argc > 1 && !parse_count(argv[1], &meshCount)) || (argc > 2 && !parse_count(argv[2], &iterations))) {
+        std::cerr << "Usage: MeshLoadBenchmark [mesh count] [iterations] [directory]\n";
+        return EXIT_FAILURE;
+    }
+    const std::filesystem::path directory = argc > 3 ? std::filesystem::path(argv[3])
+                                                     : std::filesystem::temp_directory_path() / "juniper_mesh_benchmark";
+    // Only what the benchmark wrote is removed, the directory too if it made it
+    const bool createdDirectory = std::filesystem::create_directories(directory);
+
+    // Spheres from a few thousand to a few hundred thousand triangles
+    std::mt19937 rng(1234);
+    std::vector<std::string> objPaths(meshCount);
+    std::vector<std::string> meshPaths(meshCount);
+    uint64_t objBytes = 0;
+    uint64_t fileBytes = 0;
+    uint64_t stagingBytes = 0;
+    for (uint32_t i = 0; i < meshCount; i++) {
+        const uint32_t segments = 32 + rng() % 480;
+        const MeshData mesh = MeshData::make_sphere(segments, segments / 2);
+        const std::string name = "mesh" + std::to_string(i);
+        objPaths[i] = (directory / (name + ".obj")).string();
+        meshPaths[i] = (directory / (name + ".jmesh")).string();
+        write_obj(objPaths[i], mesh);
+        MeshFile::write(meshPaths[i], mesh, std::vector<MeshLodData>(), VERTEX_FORMAT_FLOAT);
+        objBytes += std::filesystem::file_size(objPaths[i]);
+        fileBytes += std::filesystem::file_size(meshPaths[i]);
+
+        MeshFile meshFile;
+        meshFile.open(meshPaths[i]);
+        stagingBytes = std::max<uint64_t>(stagingBytes, meshFile.get_file_bytes());
+    }
+    std::vector<uint8_t> staging(stagingBytes);
+
+    // The importer has no meshlets, building them is part of what cooking saves
+    double objMs = time_ms(iterations, [&]() {
+        for (const std::string& path : objPaths) {
+            const MeshData mesh = import_obj(path);
+            const MeshletData meshlets = MeshletData::build(mesh, MESHLET_MAX_VERTICES, MESHLET_MAX_TRIANGLES);
+            upload(mesh.get_view(), meshlets.get_view(), staging.data());
+        }
+    });
+
+    // Reading into a buffer first, what loading without the mapping would look like
+    double readMs = time_ms(iterations, [&]() {
+        for (const std::string& path : meshPaths) {
+            const std::vector<char> data = read_binary_file(path);
+            memcpy(staging.data(), data.data(), data.size());
+            gSink = staging[data.size() / 2];
+        }
+    });
+
+    uint64_t uploadedBytes = 0;
+    double mappedMs = time_ms(iterations, [&]() {
+        uploadedBytes = 0;
+        MeshFile meshFile;
+        for (const std::string& path : meshPaths) {
+            meshFile.open(path);
+            uploadedBytes += upload(meshFile.get_view(0), meshFile.get_meshlet_view(0), staging.data());
+        }
+    });
+
+    std::cout << "Mesh load benchmark, " << meshCount << " meshes, " << objBytes / (1024 * 1024) << " MB of OBJ, "
+              << fileBytes / (1024 * 1024) << " MB of mesh files, " << uploadedBytes / (1024 * 1024) << " MB uploaded\n";
+    print_timing("OBJ import and meshlets", objMs, uploadedBytes, meshCount, objMs);
+    print_timing("Mesh file, read", readMs, uploadedBytes, meshCount, objMs);
+    print_timing("Mesh file, mapped", mappedMs, uploadedBytes, meshCount, objMs);
+
+    for (uint32_t i = 0; i < meshCount; i++) {
+        std::filesystem::remove(objPaths[i]);
+        std::filesystem::remove(meshPaths[i]);
+    }
+    if (createdDirectory) {
+        std::filesystem::remove(directory);
+    }
+    return 0;
+}
@@ -0,0 +1,127 @@
+//======================================================================
+// PackCooker.cpp
+//
+// Keegan Kochis
+// Created: 2026/10/19
+// Packs every file under a directory into a pack file, under its path
+// relative to the directory. The archive is then mounted and every
+// file read back and compared, and loading all files through the
+// virtual file system is timed against opening and reading each loose
+// file, both from a warm page cache.
+// Usage: PackCooker <input directory> <output.jpak> [lz4 | none]
+//        [thread count]
+//======================================================================
+
+#include "JobSystem.h"
+#include "PackFile.h"
+#include "Shader.h"
+#include "VirtualFileSystem.h"
+
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+
+#include <chrono>
+#include <exception>
+#include <filesystem>
+#include <iostream>
+#include <string>
+#include <vector>
+
+int main(int argc, char* argv[]) {
+    if (argc < 3) {
+        std::cerr << "Usage: PackCooker <input directory> <output.jpak> [lz4 | none] [thread count]\n";
+        return EXIT_FAILURE;
+    }
+    const std::filesystem::path directory = argv[1];
+    const std::string output = argv[2];
+    PackCompression compression = PACK_COMPRESSION_LZ4;
+    uint32_t threadCount = 0;
+    for (int i = 3; i < argc; i++) {
+        const std::string argument = argv[i];
+        if (argument == "lz4") {
+            compression = PACK_COMPRESSION_LZ4;
+        }
+        else if (argument == "none") {
+            compression = PACK_COMPRESSION_NONE;
+        }
+        else {
+            threadCount = static_cast<uint32_t>(std::strtoul(argv[i], nullptr, 10));
+        }
+    }
+
+    JobSystem jobSystem;
+    try {
+        // The calling thread takes part in parallel loops, so one fewer worker
+        if (threadCount != 1) {
+            jobSystem.init(threadCount > 0 ? threadCount - 1 : 0);
+        }
+        JobSystem* pJobSystem = threadCount != 1 ? &jobSystem : nullptr;
+
+        std::vector<PackInput> inputs;
+        uint64_t inputBytes = 0;
+        for (const auto& file : std::filesystem::recursive_directory_iterator(directory)) {
+            if (file.is_regular_file()) {
+                inputs.push_back({ std::filesystem::relative(file.path(), directory).generic_string(), file.path().string() });
+                inputBytes += file.file_size();
+            }
+        }
+
+        auto start = std::chrono::high_resolution_clock::now();
+        PackFile::write(output, inputs, compression, pJobSystem);
+        auto packed = std::chrono::high_resolution_clock::now();
+        const uint64_t packBytes = std::filesystem::file_size(output);
+        std::cout << "Packed " << inputs.size() << " files from " << directory.string() << " into " << output << " in "
+                  << std::chrono::duration<double, std::milli>(packed - start).count() << " ms\n";
+        std::cout << '\t' << inputBytes << " bytes into " << packBytes << ", "
+                  << (inputBytes > 0 ? 100.0 * packBytes / inputBytes : 0.0) << "%\n";
+
+        // Loose files, an open, a size query and a read each
+        std::vector<std::vector<char>> looseData(inputs.size());
+        auto looseStart = std::chrono::high_resolution_clock::now();
+        for (size_t i = 0; i < inputs.size(); i++) {
+            looseData[i] = read_binary_file(inputs[i].sourcePath);
+        }
+        auto looseEnd = std::chrono::high_resolution_clock::now();
+
+        auto mountStart = std::chrono::high_resolution_clock::now();
+        VirtualFileSystem fileSystem;
+        fileSystem.init(pJobSystem);
+        fileSystem.mount(output);
+        std::vector<VirtualFileSystem::FileLocation> locations(inputs.size());
+        std::vector<std::vector<uint8_t>> packedData(inputs.size());
+        std::vector<uint8_t*> destinations(inputs.size());
+        for (size_t i = 0; i < inputs.size(); i++) {
+            if (!fileSystem.find(inputs[i].packPath, &locations[i])) {
+                throw std::runtime_error("Failed to find " + inputs[i].packPath + " in " + output + "!");
+            }
+            packedData[i].resize(fileSystem.get_size(locations[i]));
+            destinations[i] = packedData[i].data();
+        }
+        auto found = std::chrono::high_resolution_clock::now();
+        fileSystem.read_files(locations, destinations);
+        auto read = std::chrono::high_resolution_clock::now();
+
+        for (size_t i = 0; i < inputs.size(); i++) {
+            if (packedData[i].size() != looseData[i].size() ||
+                (!looseData[i].empty() && memcmp(packedData[i].data(), looseData[i].data(), looseData[i].size()) != 0)) {
+                throw std::runtime_error("Failed to read back " + inputs[i].packPath + ", it differs from its source!");
+            }
+        }
+
+        const double looseMs = std::chrono::duration<double, std::milli>(looseEnd - looseStart).count();
+        const double packMs = std::chrono::duration<double, std::milli>(read - mountStart).count();
+        std::cout << "\tLoose files: " << looseMs << " ms\n";
+        std::cout << "\tPack file: " << packMs << " ms on " << (pJobSystem ? jobSystem.get_thread_count() : 1)
+                  << " threads, mount and lookups " << std::chrono::duration<double, std::milli>(found - mountStart).count()
+                  << " ms, " << looseMs / packMs << "x\n";
+        fileSystem.print_stats(std::cout);
+    } catch (const std::exception& e) {
+        jobSystem.clean_up();
+        std::cerr << e.what() << std::endl;
+        return EXIT_FAILURE;
+    }
+    jobSystem.clean_up();
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,243 @@
+//======================================================================
+// ReadBenchmark.cpp
+//
+// Keegan Kochis
+// Created: 2026/10/19
+// Read throughput and request latency of the AsyncReader backends
+// against synchronous fread, over a set of files read in fixed size
+// chunks. Every run starts with the files evicted from the page cache,
+// so buffered reads go to the device as the direct ones do. Async
+// latency runs from queuing a chunk to its callback, with every chunk
+// queued up front; fread latency is the time of each call.
+// Usage: ReadBenchmark [file count] [file MB] [chunk KB] [queue depth]
+//        [directory]
+//======================================================================
+
+#include "AsyncReader.h"
+#include "JobSystem.h"
+#include "Profiler.h"
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <cctype>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+static volatile uint8_t gSink = 0;
+
+//------------------------------------------------------------------------------------------
+// False unless the whole argument is a number above zero
+//------------------------------------------------------------------------------------------
+static bool parse_count(const char* pArgument, uint64_t* pValue) {
+    const std::string text = pArgument;
+    if (text.empty() || !std::isdigit(static_cast<unsigned char>(text[0]))) {
+        return false;
+    }
+    size_t consumed = 0;
+    try {
+        *pValue = std::stoull(text, &consumed, 10);
+    }
+    catch (const std::exception&) {
+        return false;
+    }
+    return consumed == text.size() && *pValue > 0;
+}
+
+struct RunResult_t {
+    double ms;
+    uint64_t bytes;
+    std::vector<uint64_t> latenciesNs;
+}; typedef RunResult_t RunResult;
+
+
+//------------------------------------------------------------------------------------------
+// Written pages have to reach the disk before the kernel drops them from the cache
+//------------------------------------------------------------------------------------------
+static void evict_files(const std::vector<std::string>& paths) {
+    for (const std::string& path : paths) {
+        const int fd = open(path.c_str(), O_RDONLY);
+        if (fd >= 0) {
+            fdatasync(fd);
+            posix_fadvise(fd, 0, 0, POSIX_FADV_DONTNEED);
+            close(fd);
+        }
+    }
+}
+
+static void print_result(const char* name, RunResult& result, double baselineMs) {
+    std::sort(result.latenciesNs.begin(), result.latenciesNs.end());
+    uint64_t totalNs = 0;
+    for (uint64_t latency : result.latenciesNs) {
+        totalNs += latency;
+    }
+    const size_t count = std::max<size_t>(result.latenciesNs.size(), 1);
+    const double p50 = result.latenciesNs.empty() ? 0.0 : result.latenciesNs[count / 2] / 1e6;
+    const double p99 = result.latenciesNs.empty() ? 0.0 : result.latenciesNs[std::min(count - 1, count * 99 / 100)] / 1e6;
+
+    std::cout << '\t' << std::left << std::setw(24) << name << std::right << std::fixed
+              << std::setprecision(1) << std::setw(9) << result.ms << " ms"
+              << std::setw(9) << result.bytes / (1024.0 * 1024.0) / (result.ms / 1000.0) << " MB/s"
+              << std::setprecision(3) << "  latency avg " << std::setw(8) << totalNs / 1e6 / count
+              << " p50 " << std::setw(8) << p50 << " p99 " << std::setw(8) << p99 << " ms"
+              << std::setprecision(2) << std::setw(8) << baselineMs / result.ms << "x\n" << std::defaultfloat;
+}
+
+//------------------------------------------------------------------------------------------
+//------------------------------------------------------------------------------------------
+static RunResult run_fread(const std::vector<std::string>& paths, uint64_t chunkBytes, uint8_t* pBuffer) {
+    evict_files(paths);
+    RunResult result = { 0.0, 0, std::vector<uint64_t>() };
+    const uint64_t start = Profiler::now_ns();
+    for (const std::string& path : paths) {
+        FILE* pFile = fopen(path.c_str(), "rb");
+        if (!pFile) {
+            continue;
+        }
+        while (true) {
+            const uint64_t readStart = Profiler::now_ns();
+            const size_t read = fread(pBuffer + result.bytes, 1, chunkBytes, pFile);
+            result.latenciesNs.push_back(Profiler::now_ns() - readStart);
+            result.bytes += read;
+            if (read < chunkBytes) {
+                break;
+            }
+        }
+        fclose(pFile);
+    }
+    result.ms = (Profiler::now_ns() - start) / 1e6;
+    gSink = pBuffer[result.bytes / 2];
+    return result;
+}
+
+//------------------------------------------------------------------------------------------
+// The callbacks run on the job system, as they would when loading assets
+//------------------------------------------------------------------------------------------
+static RunResult run_async(const std::vector<std::string>& paths, uint64_t chunkBytes, uint8_t* pBuffer,
+                           ReadBackend backend, bool direct, uint32_t queueDepth, JobSystem* pJobSystem,
+                           ReadBackend* pUsedBackend) {
+    evict_files(paths);
+    AsyncReader reader;
+    reader.init(backend, queueDepth, queueDepth, pJobSystem);
+    *pUsedBackend = reader.get_backend();
+
+    std::vector<ReadFileHandle> files;
+    uint32_t chunkCount = 0;
+    for (const std::string& path : paths) {
+        files.push_back(reader.open_file(path, direct));
+        chunkCount += static_cast<uint32_t>((reader.get_file_size(files.back()) + chunkBytes - 1) / chunkBytes);
+    }
+
+    RunResult result = { 0.0, 0, std::vector<uint64_t>(chunkCount) };
+    std::atomic<uint64_t> bytesRead{0};
+    const uint64_t start = Profiler::now_ns();
+    uint32_t chunk = 0;
+    uint64_t bufferOffset = 0;
+    for (ReadFileHandle file : files) {
+        const uint64_t size = reader.get_file_size(file);
+        for (uint64_t offset = 0; offset < size; offset += chunkBytes) {
+            const uint64_t queuedNs = Profiler::now_ns();
+            uint64_t* pLatency = &result.latenciesNs[chunk++];
+            reader.read(file, offset, chunkBytes, pBuffer + bufferOffset + offset, READ_PRIORITY_NORMAL,
+                        [pLatency, queuedNs, &bytesRead](ReadStatus status, uint64_t bytes) {
+                            *pLatency = Profiler::now_ns() - queuedNs;
+                            bytesRead.fetch_add(status == READ_STATUS_DONE ? bytes : 0);
+                        });
+        }
+        bufferOffset += (size + chunkBytes - 1) / chunkBytes * chunkBytes;
+    }
+    reader.wait_idle();
+    result.ms = (Profiler::now_ns() - start) / 1e6;
+    result.bytes = bytesRead.load();
+    gSink = pBuffer[result.bytes / 2];
+
+    reader.clean_up();
+    return result;
+}
+
+int main(int argc, char* argv[]) {
+    // File count, file MB, chunk KB and queue depth
+    uint64_t counts[4] = { 8, 16, 256, 32 };
+    for (int i = 1; i < argc && i <= 4; i++) {
+        if (!parse_count(argv[i], &counts[i - 1])) {
+            std::cerr << "Usage: ReadBenchmark [file count] [file MB] [chunk KB] [queue depth] [directory]\n";
+            return EXIT_FAILURE;
+        }
+    }
+    const uint32_t fileCount = static_cast<uint32_t>(counts[0]);
+    const uint64_t fileBytes = counts[1] << 20;
+    // Direct reads need whole blocks, so chunks are rounded up to them
+    uint64_t chunkBytes = counts[2] << 10;
+    chunkBytes = std::max<uint64_t>((chunkBytes + AsyncReader::DIRECT_ALIGNMENT - 1) / AsyncReader::DIRECT_ALIGNMENT, 1) *
+                 AsyncReader::DIRECT_ALIGNMENT;
+    const uint32_t queueDepth = static_cast<uint32_t>(counts[3]);
+    const std::filesystem::path directory = argc > 5 ? std::filesystem::path(argv[5])
+                                                     : std::filesystem::temp_directory_path() / "juniper_read_benchmark";
+    // Only what the benchmark wrote is removed, the directory too if it made it
+    const bool createdDirectory = std::filesystem::create_directories(directory);
+
+    std::mt19937_64 rng(1234);
+    std::vector<std::string> paths(fileCount);
+    std::vector<uint64_t> data(fileBytes / sizeof(uint64_t));
+    for (uint32_t i = 0; i < fileCount; i++) {
+        for (uint64_t& value : data) {
+            value = rng();
+        }
+        paths[i] = (directory / ("file" + std::to_string(i) + ".bin")).string();
+        std::ofstream file(paths[i], std::ios::binary);
+        file.write(reinterpret_cast<const char*>(data.data()), static_cast<std::streamsize>(fileBytes));
+    }
+
+    const uint64_t bufferBytes = fileCount * ((fileBytes + chunkBytes - 1) / chunkBytes * chunkBytes);
+    uint8_t* pBuffer = static_cast<uint8_t*>(std::aligned_alloc(AsyncReader::DIRECT_ALIGNMENT, bufferBytes));
+
+    JobSystem jobSystem;
+    jobSystem.init(0);
+
+    std::cout << "Read benchmark, " << fileCount << " files of " << (fileBytes >> 20) << " MB, " << (chunkBytes >> 10)
+              << " KB chunks, queue depth " << queueDepth << '\n';
+    RunResult freadResult = run_fread(paths, chunkBytes, pBuffer);
+    const double baselineMs = freadResult.ms;
+    print_result("fread", freadResult, baselineMs);
+
+    ReadBackend usedBackend;
+    RunResult threadResult = run_async(paths, chunkBytes, pBuffer, READ_BACKEND_THREADS, false, queueDepth,
+                                       &jobSystem, &usedBackend);
+    print_result("Thread pool", threadResult, baselineMs);
+    RunResult threadDirectResult = run_async(paths, chunkBytes, pBuffer, READ_BACKEND_THREADS, true, queueDepth,
+                                             &jobSystem, &usedBackend);
+    print_result("Thread pool, direct", threadDirectResult, baselineMs);
+    RunResult uringResult = run_async(paths, chunkBytes, pBuffer, READ_BACKEND_URING, false, queueDepth,
+                                      &jobSystem, &usedBackend);
+    if (usedBackend == READ_BACKEND_URING) {
+        print_result("io_uring", uringResult, baselineMs);
+        RunResult uringDirectResult = run_async(paths, chunkBytes, pBuffer, READ_BACKEND_URING, true, queueDepth,
+                                                &jobSystem, &usedBackend);
+        print_result("io_uring, direct", uringDirectResult, baselineMs);
+    }
+    else {
+        std::cout << "\tio_uring is not available, skipped\n";
+    }
+
+    jobSystem.clean_up();
+    std::free(pBuffer);
+    for (const std::string& path : paths) {
+        std::filesystem::remove(path);
+    }
+    if (createdDirectory) {
+        std::filesystem::remove(directory);
+    }
+    return 0;
+}
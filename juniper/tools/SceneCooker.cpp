@@ -0,0 +1,70 @@
+//======================================================================
+// SceneCooker.cpp
+//
+// Keegan Kochis
+// Created: 2026/10/18
+// Offline cooker turning glTF 2.0 scenes into a scene file and mesh
+// files. Primitives are cooked in parallel, and only the outputs whose
+// inputs changed since the last cook are redone unless --force is given.
+// --quantize cooks the meshes with quantized vertices.
+// Usage: SceneCooker <input.gltf | input.glb> <output directory> [threads] [--force] [--quantize]
+//======================================================================
+
+#include "AssetCooker.h"
+#include "JobSystem.h"
+#include "Mesh.h"
+
+#include <cstdint>
+#include <cstdlib>
+
+#include <exception>
+#include <iostream>
+#include <string>
+
+int main(int argc, char* argv[]) {
+    if (argc < 3 || argc > 6) {
+        std::cerr << "Usage: SceneCooker <input.gltf | input.glb> <output directory> [threads] [--force] [--quantize]\n";
+        return EXIT_FAILURE;
+    }
+    const std::string input = argv[1];
+    const std::string output = argv[2];
+    uint32_t threadCount = 0;
+    bool force = false;
+    VertexFormat vertexFormat = VERTEX_FORMAT_FLOAT;
+    for (int i = 3; i < argc; i++) {
+        if (std::string(argv[i]) == "--force") {
+            force = true;
+        }
+        else if (std::string(argv[i]) == "--quantize") {
+            vertexFormat = VERTEX_FORMAT_QUANTIZED;
+        }
+        else {
+            threadCount = static_cast<uint32_t>(std::strtoul(argv[i], nullptr, 10));
+        }
+    }
+
+    JobSystem jobSystem;
+    try {
+        // The calling thread takes part in parallel loops, so one fewer worker. A single
+        // thread cooks without the job system.
+        if (threadCount != 1) {
+            jobSystem.init(threadCount > 0 ? threadCount - 1 : 0);
+        }
+
+        AssetCooker cooker;
+        cooker.init(threadCount != 1 ? &jobSystem : nullptr, output);
+        cooker.set_incremental(!force);
+        cooker.set_vertex_format(vertexFormat);
+        cooker.cook_gltf(input);
+
+        std::cout << "Cooked " << input << " into " << output << '\n';
+        cooker.print_stats(std::cout);
+    } catch (const std::exception& e) {
+        jobSystem.clean_up();
+        std::cerr << e.what() << std::endl;
+        return EXIT_FAILURE;
+    }
+    jobSystem.clean_up();
+
+    return EXIT_SUCCESS;
+}
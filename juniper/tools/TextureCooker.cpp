@@ -0,0 +1,144 @@
+//======================================================================
+// TextureCooker.cpp
+//
+// Keegan Kochis
+// Created: 2026/10/18
+// Offline cooker turning source images into KTX2 texture files. The
+// input is a TGA file or one of the built in images, "checker" or
+// "gradient". The mip chain is filtered in linear space and every level
+// is block compressed on all threads, reporting the time of each step
+// and the PSNR of each level against its uncompressed texels.
+// Usage: TextureCooker <input.tga | checker | gradient> <output.ktx2>
+//        [bc1 | bc3 | bc5 | bc7 | rgba8] [color | data | normal]
+//        [scalar | sse | avx2] [thread count]
+//======================================================================
+
+#include "BlockCompress.h"
+#include "JobSystem.h"
+#include "Texture.h"
+#include "TextureFile.h"
+#include "TextureImport.h"
+#include "TransformKernels.h"
+
+#include <cstdlib>
+
+#include <chrono>
+#include <exception>
+#include <iostream>
+#include <string>
+#include <vector>
+
+static const char* FORMAT_NAMES[TEXTURE_FORMAT_COUNT] = { "rgba8", "bc1", "bc3", "bc5", "bc7" };
+static const char* USAGE_NAMES[TEXTURE_USAGE_COUNT] = { "color", "data", "normal" };
+static const char* SIMD_NAMES[] = { "scalar", "sse", "avx2" };
+
+//------------------------------------------------------------------------------------------
+// Index of the name in the list, or -1
+//------------------------------------------------------------------------------------------
+static int find_name(const std::string& name, const char* const* pNames, int count) {
+    for (int i = 0; i < count; i++) {
+        if (name == pNames[i]) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+int main(int argc, char* argv[]) {
+    if (argc < 3) {
+        std::cerr << "Usage: TextureCooker <input.tga | checker | gradient> <output.ktx2> [bc1 | bc3 | bc5 | bc7 | rgba8]"
+                     " [color | data | normal] [scalar | sse | avx2] [thread count]\n";
+        return EXIT_FAILURE;
+    }
+    const std::string input = argv[1];
+    const std::string output = argv[2];
+    TextureFormat format = TEXTURE_FORMAT_BC7;
+    TextureUsage usage = TEXTURE_USAGE_COLOR;
+    SimdLevel simdLevel = get_simd_level();
+    uint32_t threadCount = 0;
+    for (int i = 3; i < argc; i++) {
+        const std::string argument = argv[i];
+        if (find_name(argument, FORMAT_NAMES, TEXTURE_FORMAT_COUNT) >= 0) {
+            format = static_cast<TextureFormat>(find_name(argument, FORMAT_NAMES, TEXTURE_FORMAT_COUNT));
+        }
+        else if (find_name(argument, USAGE_NAMES, TEXTURE_USAGE_COUNT) >= 0) {
+            usage = static_cast<TextureUsage>(find_name(argument, USAGE_NAMES, TEXTURE_USAGE_COUNT));
+        }
+        else if (find_name(argument, SIMD_NAMES, 3) >= 0) {
+            simdLevel = static_cast<SimdLevel>(find_name(argument, SIMD_NAMES, 3));
+        }
+        else {
+            threadCount = static_cast<uint32_t>(std::strtoul(argv[i], nullptr, 10));
+        }
+    }
+    if (simdLevel > get_simd_level()) {
+        simdLevel = get_simd_level();
+    }
+
+    JobSystem jobSystem;
+    try {
+        // The calling thread takes part in parallel loops, so one fewer worker
+        if (threadCount != 1) {
+            jobSystem.init(threadCount > 0 ? threadCount - 1 : 0);
+        }
+        JobSystem* pJobSystem = threadCount != 1 ? &jobSystem : nullptr;
+
+        TextureData image;
+        if (input == "checker") {
+            image = TextureData::make_checker(1024, 16);
+        }
+        else if (input == "gradient") {
+            image = TextureData::make_gradient(1024);
+        }
+        else {
+            image = import_tga(input);
+        }
+
+        auto start = std::chrono::high_resolution_clock::now();
+        const std::vector<TextureData> mips = generate_mips(simdLevel, image, usage);
+        auto filtered = std::chrono::high_resolution_clock::now();
+
+        std::vector<std::vector<uint8_t>> levels(mips.size());
+        for (size_t i = 0; i < mips.size(); i++) {
+            levels[i].resize(get_texture_level_bytes(format, mips[i].width, mips[i].height));
+            compress_texture(simdLevel, format, mips[i], pJobSystem, levels[i].data());
+        }
+        auto encoded = std::chrono::high_resolution_clock::now();
+        TextureFile::write(output, format, usage, image.width, image.height, levels);
+
+        TextureFile textureFile;
+        textureFile.open(output);
+        auto end = std::chrono::high_resolution_clock::now();
+
+        uint64_t texelCount = 0;
+        for (const TextureData& mip : mips) {
+            texelCount += static_cast<uint64_t>(mip.width) * mip.height;
+        }
+        const double encodeMs = std::chrono::duration<double, std::milli>(encoded - filtered).count();
+        std::cout << "Cooked " << input << " into " << output << " in "
+                  << std::chrono::duration<double, std::milli>(end - start).count() << " ms\n";
+        std::cout << '\t' << image.width << 'x' << image.height << ' ' << texture_format_name(format) << ' '
+                  << USAGE_NAMES[usage] << ", " << textureFile.get_level_count() << " levels, "
+                  << textureFile.get_file_bytes() << " bytes instead of " << texelCount * 4 << '\n';
+        std::cout << "\tMips: " << std::chrono::duration<double, std::milli>(filtered - start).count() << " ms ("
+                  << simd_level_name(simdLevel) << ")\n";
+        std::cout << "\tEncode: " << encodeMs << " ms on " << (pJobSystem ? jobSystem.get_thread_count() : 1) << " threads, "
+                  << texelCount / 1000.0 / encodeMs << " Mtexels/s\n";
+
+        // The PSNR of BC5 is over the two channels it stores, of BC1 over the color
+        const uint32_t channelCount = format == TEXTURE_FORMAT_BC5 ? 2 : (format == TEXTURE_FORMAT_BC1 ? 3 : 4);
+        for (uint32_t i = 0; i < textureFile.get_level_count(); i++) {
+            const TextureLevelView level = textureFile.get_level(i);
+            const TextureData decoded = decompress_texture(format, level.pData, level.width, level.height);
+            std::cout << "\tLevel " << i << ": " << level.width << 'x' << level.height << ", " << level.bytes << " bytes, PSNR "
+                      << compute_psnr(mips[i], decoded, channelCount) << " dB\n";
+        }
+    } catch (const std::exception& e) {
+        jobSystem.clean_up();
+        std::cerr << e.what() << std::endl;
+        return EXIT_FAILURE;
+    }
+    jobSystem.clean_up();
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,316 @@
+//======================================================================
+// TransformBenchmark.cpp
+//
+// Keegan Kochis
+// Created: 2026/10/18
+// Microbenchmark of the batch transform kernels against naive per
+// object GLM loops over the same data in array of structs form.
+// Usage: TransformBenchmark [object count] [iterations]
+//======================================================================
+
+#include "TransformKernels.h"
+
+#include <cmath>
+#include <cctype>
+#include <cstdint>
+#include <cstdlib>
+
+#include <algorithm>
+#include <chrono>
+#include <exception>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+#define GLM_FORCE_RADIANS
+#define GLM_FORCE_DEPTH_ZERO_TO_ONE
+#include <glm/geometric.hpp>
+#include <glm/mat4x4.hpp>
+#include <glm/vec3.hpp>
+#include <glm/vec4.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+#include <glm/gtc/quaternion.hpp>
+
+struct Aabb_t {
+    glm::vec3 center;
+    glm::vec3 extent;
+}; typedef Aabb_t Aabb;
+
+// Keeps the compiler from dropping the naive loops' results
+static volatile float gSink = 0.0f;
+
+//------------------------------------------------------------------------------------------
+// False unless the whole argument is a number above zero
+//------------------------------------------------------------------------------------------
+static bool parse_count(const char* pArgument, uint32_t* pValue) {
+    const std::string text = pArgument;
+    if (text.empty() || !std::isdigit(static_cast<unsigned char>(text[0]))) {
+        return false;
+    }
+    size_t consumed = 0;
+    unsigned long value = 0;
+    try {
+        value = std::stoul(text, &consumed, 10);
+    }
+    catch (const std::exception&) {
+        return false;
+    }
+    if (consumed != text.size() || value == 0 || value > UINT32_MAX) {
+        return false;
+    }
+    *pValue = static_cast<uint32_t>(value);
+    return true;
+}
+
+//------------------------------------------------------------------------------------------
+// Best of the iterations in milliseconds, the first run warms the caches
+//------------------------------------------------------------------------------------------
+static double time_ms(uint32_t iterations, const std::function<void()>& run) {
+    run();
+    double best = 1e30;
+    for (uint32_t i = 0; i < iterations; i++) {
+        auto start = std::chrono::high_resolution_clock::now();
+        run();
+        auto end = std::chrono::high_resolution_clock::now();
+        best = std::min(best, std::chrono::duration<double, std::milli>(end - start).count());
+    }
+    return best;
+}
+
+// Speedup is relative to the naive loop of the same kernel
+static void print_timing(const char* kernel, const char* level, double ms, double naiveMs) {
+    std::cout << '\t' << std::left << std::setw(22) << kernel << std::setw(8) << level
+              << std::right << std::fixed << std::setprecision(3) << std::setw(10) << ms << " ms"
+              << std::setprecision(2) << std::setw(8) << naiveMs / ms << "x" << std::defaultfloat;
+}
+
+static float max_error(const glm::mat4& a, const glm::mat4& b) {
+    float error = 0.0f;
+    for (int column = 0; column < 4; column++) {
+        for (int row = 0; row < 4; row++) {
+            error = std::max(error, std::fabs(a[column][row] - b[column][row]));
+        }
+    }
+    return error;
+}
+
+int main(int argc, char* argv[]) {
+    uint32_t objectCount = 100000;
+    uint32_t iterations = 50;
+    if ((argc > 1 && !parse_count(argv[1], &objectCount)) || (argc > 2 && !parse_count(argv[2], &iterations))) {
+        std::cerr << "Usage: TransformBenchmark [object count] [iterations]\n";
+        return EXIT_FAILURE;
+    }
+
+    std::mt19937 random(1234);
+    std::uniform_real_distribution<float> position(-500.0f, 500.0f);
+    std::uniform_real_distribution<float> unit(-1.0f, 1.0f);
+    std::uniform_real_distribution<float> scale(0.5f, 4.0f);
+
+    TransformSoA transforms;
+    SphereSoA localSpheres;
+    AabbSoA localBoxes;
+    transforms.resize(objectCount);
+    localSpheres.resize(objectCount);
+    localBoxes.resize(objectCount);
+
+    std::vector<glm::vec3> positions(objectCount);
+    std::vector<glm::quat> rotations(objectCount);
+    std::vector<glm::vec3> scales(objectCount);
+    std::vector<glm::vec4> spheres(objectCount);
+    std::vector<Aabb> boxes(objectCount);
+
+    for (uint32_t i = 0; i < objectCount; i++) {
+        positions[i] = glm::vec3(position(random), position(random), position(random));
+        rotations[i] = glm::normalize(glm::quat(unit(random), unit(random), unit(random), unit(random)));
+        scales[i] = glm::vec3(scale(random), scale(random), scale(random));
+        spheres[i] = glm::vec4(unit(random), unit(random), unit(random), scale(random));
+        boxes[i].center = glm::vec3(unit(random), unit(random), unit(random));
+        boxes[i].extent = glm::vec3(scale(random), scale(random), scale(random));
+
+        transforms.positionX[i] = positions[i].x;
+        transforms.positionY[i] = positions[i].y;
+        transforms.positionZ[i] = positions[i].z;
+        transforms.rotationX[i] = rotations[i].x;
+        transforms.rotationY[i] = rotations[i].y;
+        transforms.rotationZ[i] = rotations[i].z;
+        transforms.rotationW[i] = rotations[i].w;
+        transforms.scaleX[i] = scales[i].x;
+        transforms.scaleY[i] = scales[i].y;
+        transforms.scaleZ[i] = scales[i].z;
+        localSpheres.centerX[i] = spheres[i].x;
+        localSpheres.centerY[i] = spheres[i].y;
+        localSpheres.centerZ[i] = spheres[i].z;
+        localSpheres.radius[i] = spheres[i].w;
+        localBoxes.centerX[i] = boxes[i].center.x;
+        localBoxes.centerY[i] = boxes[i].center.y;
+        localBoxes.centerZ[i] = boxes[i].center.z;
+        localBoxes.extentX[i] = boxes[i].extent.x;
+        localBoxes.extentY[i] = boxes[i].extent.y;
+        localBoxes.extentZ[i] = boxes[i].extent.z;
+    }
+
+    // A camera in the middle of the objects, roughly a quarter of them are inside
+    glm::mat4 projection = glm::perspective(glm::radians(90.0f), 16.0f / 9.0f, 0.1f, 400.0f);
+    glm::mat4 viewProjection = projection * glm::lookAt(glm::vec3(0.0f), glm::vec3(1.0f, 0.0f, 0.0f), glm::vec3(0.0f, 1.0f, 0.0f));
+    glm::mat4 transposed = glm::transpose(viewProjection);
+    glm::vec4 planes[6] = {
+        transposed[3] + transposed[0], transposed[3] - transposed[0],
+        transposed[3] + transposed[1], transposed[3] - transposed[1],
+        transposed[2], transposed[3] - transposed[2]
+    };
+    for (glm::vec4& plane : planes) {
+        plane /= glm::length(glm::vec3(plane));
+    }
+
+    // Naive loops, one object at a time on glm types
+    std::vector<glm::mat4> naiveMatrices(objectCount);
+    std::vector<glm::vec4> naiveSpheres(objectCount);
+    std::vector<Aabb> naiveBoxes(objectCount);
+    std::vector<uint8_t> naiveSphereVisibility(objectCount);
+    std::vector<uint8_t> naiveBoxVisibility(objectCount);
+
+    double naiveCompose = time_ms(iterations, [&]() {
+        for (uint32_t i = 0; i < objectCount; i++) {
+            naiveMatrices[i] = glm::translate(glm::mat4(1.0f), positions[i]) * glm::mat4_cast(rotations[i]) *
+                               glm::scale(glm::mat4(1.0f), scales[i]);
+        }
+        gSink = naiveMatrices[objectCount / 2][3][0];
+    });
+    double naiveSphereTransform = time_ms(iterations, [&]() {
+        for (uint32_t i = 0; i < objectCount; i++) {
+            const glm::mat4& matrix = naiveMatrices[i];
+            glm::vec3 center = glm::vec3(matrix * glm::vec4(glm::vec3(spheres[i]), 1.0f));
+            float maxScale = std::max(glm::length(glm::vec3(matrix[0])),
+                                      std::max(glm::length(glm::vec3(matrix[1])), glm::length(glm::vec3(matrix[2]))));
+            naiveSpheres[i] = glm::vec4(center, spheres[i].w * maxScale);
+        }
+        gSink = naiveSpheres[objectCount / 2].w;
+    });
+    double naiveBoxTransform = time_ms(iterations, [&]() {
+        for (uint32_t i = 0; i < objectCount; i++) {
+            const glm::mat4& matrix = naiveMatrices[i];
+            naiveBoxes[i].center = glm::vec3(matrix * glm::vec4(boxes[i].center, 1.0f));
+            naiveBoxes[i].extent = glm::abs(glm::vec3(matrix[0])) * boxes[i].extent.x +
+                                   glm::abs(glm::vec3(matrix[1])) * boxes[i].extent.y +
+                                   glm::abs(glm::vec3(matrix[2])) * boxes[i].extent.z;
+        }
+        gSink = naiveBoxes[objectCount / 2].extent.x;
+    });
+    double naiveSphereCull = time_ms(iterations, [&]() {
+        for (uint32_t i = 0; i < objectCount; i++) {
+            bool visible = true;
+            for (uint32_t p = 0; p < 6 && visible; p++) {
+                visible = glm::dot(glm::vec3(planes[p]), glm::vec3(naiveSpheres[i])) + planes[p].w >= -naiveSpheres[i].w;
+            }
+            naiveSphereVisibility[i] = visible ? 1 : 0;
+        }
+    });
+    double naiveBoxCull = time_ms(iterations, [&]() {
+        for (uint32_t i = 0; i < objectCount; i++) {
+            bool visible = true;
+            for (uint32_t p = 0; p < 6 && visible; p++) {
+                float radius = glm::dot(glm::abs(glm::vec3(planes[p])), naiveBoxes[i].extent);
+                visible = glm::dot(glm::vec3(planes[p]), naiveBoxes[i].center) + planes[p].w >= -radius;
+            }
+            naiveBoxVisibility[i] = visible ? 1 : 0;
+        }
+    });
+
+    std::cout << "Transform kernels, " << objectCount << " objects, best of " << iterations << " runs\n";
+    std::cout << "\tCPU supports: " << simd_level_name(get_simd_level()) << '\n';
+    const char* naiveNames[] = { "compose", "transform spheres", "transform aabbs", "cull spheres", "cull aabbs" };
+    const double naiveTimes[] = { naiveCompose, naiveSphereTransform, naiveBoxTransform, naiveSphereCull, naiveBoxCull };
+    for (uint32_t i = 0; i < 5; i++) {
+        print_timing(naiveNames[i], "GLM", naiveTimes[i], naiveTimes[i]);
+        std::cout << '\n';
+    }
+
+    std::vector<glm::mat4> matrices(objectCount);
+    SphereSoA worldSpheres;
+    AabbSoA worldBoxes;
+    std::vector<uint8_t> visibility(objectCount);
+
+    for (int level = SIMD_LEVEL_SCALAR; level <= get_simd_level(); level++) {
+        const SimdLevel simdLevel = static_cast<SimdLevel>(level);
+        const char* name = simd_level_name(simdLevel);
+
+        double ms = time_ms(iterations, [&]() {
+            compose_matrices(simdLevel, transforms, matrices.data(), sizeof(glm::mat4));
+        });
+        float error = 0.0f;
+        for (uint32_t i = 0; i < objectCount; i++) {
+            error = std::max(error, max_error(matrices[i], naiveMatrices[i]));
+        }
+        print_timing("compose", name, ms, naiveCompose);
+        std::cout << "   max error " << error << '\n';
+
+        ms = time_ms(iterations, [&]() {
+            transform_spheres(simdLevel, naiveMatrices.data(), sizeof(glm::mat4), localSpheres, worldSpheres);
+        });
+        error = 0.0f;
+        for (uint32_t i = 0; i < objectCount; i++) {
+            glm::vec4 sphere(worldSpheres.centerX[i], worldSpheres.centerY[i], worldSpheres.centerZ[i], worldSpheres.radius[i]);
+            glm::vec4 difference = glm::abs(sphere - naiveSpheres[i]);
+            error = std::max(error, std::max(std::max(difference.x, difference.y), std::max(difference.z, difference.w)));
+        }
+        print_timing("transform spheres", name, ms, naiveSphereTransform);
+        std::cout << "   max error " << error << '\n';
+
+        ms = time_ms(iterations, [&]() {
+            transform_aabbs(simdLevel, naiveMatrices.data(), sizeof(glm::mat4), localBoxes, worldBoxes);
+        });
+        error = 0.0f;
+        for (uint32_t i = 0; i < objectCount; i++) {
+            glm::vec3 center = glm::abs(glm::vec3(worldBoxes.centerX[i], worldBoxes.centerY[i], worldBoxes.centerZ[i]) - naiveBoxes[i].center);
+            glm::vec3 extent = glm::abs(glm::vec3(worldBoxes.extentX[i], worldBoxes.extentY[i], worldBoxes.extentZ[i]) - naiveBoxes[i].extent);
+            error = std::max(error, std::max(std::max(center.x, std::max(center.y, center.z)), std::max(extent.x, std::max(extent.y, extent.z))));
+        }
+        print_timing("transform aabbs", name, ms, naiveBoxTransform);
+        std::cout << "   max error " << error << '\n';
+
+        // Culling reads the naive results so every level tests the same bounds
+        SphereSoA cullSpheres;
+        cullSpheres.resize(objectCount);
+        AabbSoA cullBoxes;
+        cullBoxes.resize(objectCount);
+        for (uint32_t i = 0; i < objectCount; i++) {
+            cullSpheres.centerX[i] = naiveSpheres[i].x;
+            cullSpheres.centerY[i] = naiveSpheres[i].y;
+            cullSpheres.centerZ[i] = naiveSpheres[i].z;
+            cullSpheres.radius[i] = naiveSpheres[i].w;
+            cullBoxes.centerX[i] = naiveBoxes[i].center.x;
+            cullBoxes.centerY[i] = naiveBoxes[i].center.y;
+            cullBoxes.centerZ[i] = naiveBoxes[i].center.z;
+            cullBoxes.extentX[i] = naiveBoxes[i].extent.x;
+            cullBoxes.extentY[i] = naiveBoxes[i].extent.y;
+            cullBoxes.extentZ[i] = naiveBoxes[i].extent.z;
+        }
+
+        uint32_t visibleCount = 0;
+        ms = time_ms(iterations, [&]() {
+            visibleCount = cull_spheres(simdLevel, planes, cullSpheres, visibility.data());
+        });
+        uint32_t mismatches = 0;
+        for (uint32_t i = 0; i < objectCount; i++) {
+            mismatches += visibility[i] != naiveSphereVisibility[i] ? 1 : 0;
+        }
+        print_timing("cull spheres", name, ms, naiveSphereCull);
+        std::cout << "   " << visibleCount << " visible, " << mismatches << " mismatches\n";
+
+        ms = time_ms(iterations, [&]() {
+            visibleCount = cull_aabbs(simdLevel, planes, cullBoxes, visibility.data());
+        });
+        mismatches = 0;
+        for (uint32_t i = 0; i < objectCount; i++) {
+            mismatches += visibility[i] != naiveBoxVisibility[i] ? 1 : 0;
+        }
+        print_timing("cull aabbs", name, ms, naiveBoxCull);
+        std::cout << "   " << visibleCount << " visible, " << mismatches << " mismatches\n";
+    }
+
+    return 0;
+}